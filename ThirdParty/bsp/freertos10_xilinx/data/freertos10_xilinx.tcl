@@ -370,6 +370,8 @@ proc generate {os_handle} {
 		file copy -force [file join src Source portable GCC ARM_CR5 port_asm_vectors.S] ./src
 		file copy -force [file join src Source portable GCC ARM_CR5 portmacro.h] ./src
 		file copy -force [file join src Source portable GCC ARM_CR5 portZynqUltrascale.c] ./src
+		file copy -force [file join src Source portable Common portTicklessTTC.c] ./src
+		file copy -force [file join src Source portable Common portTicklessTTC.h] ./src
 	}
 	if { $proctype == "psu_cortexa53" || $proctype == "psv_cortexa72"} {
 		file copy -force [file join src Source portable GCC ARM_CA53 port.c] ./src
@@ -377,6 +379,8 @@ proc generate {os_handle} {
 		file copy -force [file join src Source portable GCC ARM_CA53 port_asm_vectors.S] ./src
 		file copy -force [file join src Source portable GCC ARM_CA53 portmacro.h] ./src
 		file copy -force [file join src Source portable GCC ARM_CA53 portZynqUltrascale.c] ./src
+		file copy -force [file join src Source portable Common portTicklessTTC.c] ./src
+		file copy -force [file join src Source portable Common portTicklessTTC.h] ./src
 	}
 
 	if { $proctype == "ps7_cortexa9" } {
@@ -813,7 +817,15 @@ proc generate {os_handle} {
 		puts $config_file "#define portGET_RUN_TIME_COUNTER_VALUE()\n"
 	}
 
-	puts $config_file "#define configUSE_TICKLESS_IDLE	0"
+	set val [common::get_property CONFIG.use_tickless_idle $os_handle]
+	if {$val == "true" && ($proctype == "psu_cortexr5" || $proctype == "psv_cortexr5" || $proctype == "psu_cortexa53" || $proctype == "psv_cortexa72")} {
+		puts $config_file "#define configUSE_TICKLESS_IDLE	1"
+	} else {
+		if {$val == "true"} {
+			puts "WARNING: tickless idle is not supported for $proctype"
+		}
+		puts $config_file "#define configUSE_TICKLESS_IDLE	0"
+	}
 	puts $config_file "#define configTASK_RETURN_ADDRESS    NULL"
 	puts $config_file "#define INCLUDE_vTaskPrioritySet             1"
 	puts $config_file "#define INCLUDE_uxTaskPriorityGet            1"
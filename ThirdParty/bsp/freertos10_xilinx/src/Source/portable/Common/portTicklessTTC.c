@@ -0,0 +1,231 @@
+/*
+ * FreeRTOS Kernel V10.3.0
+ * Copyright (C) 2020 Amazon.com, Inc. or its affiliates.  All Rights Reserved.
+ * Copyright (C) 2020 Xilinx, Inc. All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * http://www.FreeRTOS.org
+ * http://aws.amazon.com/freertos
+ *
+ * 1 tab == 4 spaces!
+ */
+
+/* FreeRTOS includes. */
+#include "FreeRTOS.h"
+#include "task.h"
+
+#if( configUSE_TICKLESS_IDLE != 0 )
+
+/* Standard includes. */
+#include <string.h>
+
+/* Xilinx includes. */
+#include "xttcps.h"
+#include "xscugic.h"
+
+#if( configGENERATE_RUN_TIME_STATS == 1 )
+	#error configUSE_TICKLESS_IDLE cannot be combined with configGENERATE_RUN_TIME_STATS, both change the tick timer interval.
+#endif
+
+#define portTICKLESS_WAIT()			__asm volatile ( "DSB SY\n\tWFI\n\tISB SY" ::: "memory" )
+
+/* Tick timer and interrupt controller, owned by the port. */
+extern XTtcPs xTimerInstance;
+extern XScuGic xInterruptController;
+
+/* Timer counts in one tick period and the longest sleep the interval register
+can hold. */
+static uint32_t ulTimerCountsForOneTick = 0;
+static TickType_t xMaximumPossibleSuppressedTicks = 0;
+
+/* Set while the interval register spans more than one tick, the tick handler
+then puts the single tick interval back. */
+static volatile BaseType_t xMultiTickInterval = pdFALSE;
+
+static TicklessStats_t xTicklessStats;
+/*-----------------------------------------------------------*/
+
+/*
+ * Returns pdTRUE if the tick timer interrupt is pending in the GIC.  The TTC
+ * status register is clear on read, so it cannot be polled here without losing
+ * the tick.
+ */
+static BaseType_t prvTickIsPending( void )
+{
+uint32_t ulPending;
+
+	ulPending = XScuGic_DistReadReg( &xInterruptController,
+					XSCUGIC_PENDING_SET_OFFSET + ( ( configTIMER_INTERRUPT_ID / 32U ) * 4U ) );
+
+	return ( ( ulPending & ( 1UL << ( configTIMER_INTERRUPT_ID % 32U ) ) ) != 0UL ) ? pdTRUE : pdFALSE;
+}
+/*-----------------------------------------------------------*/
+
+/*
+ * Moves the next match to the first tick boundary that is at least
+ * configTICKLESS_GUARD_COUNTS ahead of ulCount, the counts elapsed since the
+ * last match.  The counter is never stopped or reset, so no time is lost and
+ * the tick does not drift.  Returns the number of tick periods up to the new
+ * match.
+ */
+static uint32_t prvSetNextTickBoundary( uint32_t ulCount )
+{
+uint32_t ulTicks;
+
+	ulTicks = ulPortTicklessNextBoundary( ulCount, ulTimerCountsForOneTick );
+	XTtcPs_SetInterval( &xTimerInstance, ( XInterval ) ulPortTicklessReload( ulTicks, ulTimerCountsForOneTick ) );
+	xMultiTickInterval = ( ulTicks > 1UL ) ? pdTRUE : pdFALSE;
+
+	return ulTicks;
+}
+/*-----------------------------------------------------------*/
+
+void vPortTicklessInit( uint32_t ulCountsPerTick, uint32_t ulMaxIntervalCount )
+{
+	ulTimerCountsForOneTick = ulCountsPerTick;
+	xMaximumPossibleSuppressedTicks = ( TickType_t ) ( ulMaxIntervalCount / ulCountsPerTick );
+	xTicklessStats.ulCountsPerTick = ulCountsPerTick;
+}
+/*-----------------------------------------------------------*/
+
+void vPortTicklessTickHandled( void )
+{
+uint32_t ulCount = XTtcPs_GetCounterValue( &xTimerInstance );
+
+	/* The counter restarted at the match, so its value is the time taken to
+	get here. */
+	if( ulCount > xTicklessStats.ulMaxTickLatency )
+	{
+		xTicklessStats.ulMaxTickLatency = ulCount;
+	}
+
+	if( xMultiTickInterval != pdFALSE )
+	{
+		/* A tick that is handled more than a period late loses the ticks in
+		between, exactly as it would without tickless idle. */
+		( void ) prvSetNextTickBoundary( ulCount );
+	}
+}
+/*-----------------------------------------------------------*/
+
+void vPortSuppressTicksAndSleep( TickType_t xExpectedIdleTime )
+{
+uint32_t ulCount;
+uint32_t ulBoundaryTicks;
+uint32_t ulStepTicks;
+BaseType_t xMatched;
+TickType_t xModifiableIdleTime;
+
+	if( xExpectedIdleTime > xMaximumPossibleSuppressedTicks )
+	{
+		xExpectedIdleTime = xMaximumPossibleSuppressedTicks;
+	}
+
+	portTICKLESS_DISABLE_IRQ();
+
+	/* Give up if a task became ready, the tick is already pending, or the
+	current tick ends before the interval could safely be extended. */
+	ulCount = XTtcPs_GetCounterValue( &xTimerInstance );
+	if( ( eTaskConfirmSleepModeStatus() == eAbortSleep ) ||
+		( prvTickIsPending() != pdFALSE ) ||
+		( ulPortTicklessCanSleep( ulCount, ulTimerCountsForOneTick ) == 0UL ) )
+	{
+		xTicklessStats.ulSleepsAborted++;
+		portTICKLESS_ENABLE_IRQ();
+		return;
+	}
+
+	/* The counter keeps running from the last tick boundary, so widening the
+	interval puts the next match xExpectedIdleTime ticks after that boundary. */
+	XTtcPs_SetInterval( &xTimerInstance,
+			( XInterval ) ulPortTicklessReload( ( uint32_t ) xExpectedIdleTime, ulTimerCountsForOneTick ) );
+	xMultiTickInterval = pdTRUE;
+	xTicklessStats.ulSleeps++;
+
+	xModifiableIdleTime = xExpectedIdleTime;
+	configPRE_SLEEP_PROCESSING( xModifiableIdleTime );
+	if( xModifiableIdleTime > 0 )
+	{
+		portTICKLESS_WAIT();
+	}
+	configPOST_SLEEP_PROCESSING( xModifiableIdleTime );
+
+	/* Sample the pending state around the counter so a match between the two
+	reads is not mistaken for an early wake up. */
+	xMatched = prvTickIsPending();
+	ulCount = XTtcPs_GetCounterValue( &xTimerInstance );
+	if( ( xMatched == pdFALSE ) && ( prvTickIsPending() != pdFALSE ) )
+	{
+		xMatched = pdTRUE;
+		ulCount = XTtcPs_GetCounterValue( &xTimerInstance );
+	}
+
+	if( xMatched == pdFALSE )
+	{
+		/* Woken by another interrupt, ulCount is the time slept. */
+		xTicklessStats.ulEarlyWakes++;
+		ulBoundaryTicks = prvSetNextTickBoundary( ulCount );
+
+		if( prvTickIsPending() != pdFALSE )
+		{
+			/* The old match was reached while the interval was rewritten. */
+			xMatched = pdTRUE;
+			ulCount = XTtcPs_GetCounterValue( &xTimerInstance );
+		}
+	}
+
+	if( xMatched != pdFALSE )
+	{
+		if( ulCount > xTicklessStats.ulMaxWakeLatency )
+		{
+			xTicklessStats.ulMaxWakeLatency = ulCount;
+		}
+		ulBoundaryTicks = prvSetNextTickBoundary( ulCount );
+	}
+
+	ulStepTicks = ulPortTicklessStepTicks( ( uint32_t ) xExpectedIdleTime,
+			( xMatched != pdFALSE ) ? 1UL : 0UL, ulBoundaryTicks );
+
+	xTicklessStats.ulTicksSuppressed += ulStepTicks;
+	vTaskStepTick( ( TickType_t ) ulStepTicks );
+
+	portTICKLESS_ENABLE_IRQ();
+}
+/*-----------------------------------------------------------*/
+
+void vPortGetTicklessStats( TicklessStats_t *pxStats )
+{
+	portENTER_CRITICAL();
+	*pxStats = xTicklessStats;
+	portEXIT_CRITICAL();
+}
+/*-----------------------------------------------------------*/
+
+void vPortResetTicklessStats( void )
+{
+uint32_t ulCountsPerTick;
+
+	portENTER_CRITICAL();
+	ulCountsPerTick = xTicklessStats.ulCountsPerTick;
+	memset( &xTicklessStats, 0, sizeof( xTicklessStats ) );
+	xTicklessStats.ulCountsPerTick = ulCountsPerTick;
+	portEXIT_CRITICAL();
+}
+
+#endif /* configUSE_TICKLESS_IDLE */
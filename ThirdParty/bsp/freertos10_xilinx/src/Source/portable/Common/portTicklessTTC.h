@@ -0,0 +1,121 @@
+/*
+ * FreeRTOS Kernel V10.3.0
+ * Copyright (C) 2020 Amazon.com, Inc. or its affiliates.  All Rights Reserved.
+ * Copyright (C) 2020 Xilinx, Inc. All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * http://www.FreeRTOS.org
+ * http://aws.amazon.com/freertos
+ *
+ * 1 tab == 4 spaces!
+ */
+
+#ifndef PORT_TICKLESS_TTC_H
+#define PORT_TICKLESS_TTC_H
+
+/*
+ * Tickless idle for the ports that take the tick from a TTC interval timer.
+ * This file is included by portmacro.h when configUSE_TICKLESS_IDLE is set,
+ * the timer handling itself is in portTicklessTTC.c.
+ */
+
+/* Minimum distance, in timer counts, kept between the running counter and a
+new interval value so the counter cannot pass the match while it is written. */
+#ifndef configTICKLESS_GUARD_COUNTS
+	#define configTICKLESS_GUARD_COUNTS	64UL
+#endif
+
+/* Tickless idle counters, all latencies are in tick timer counts. */
+typedef struct xTICKLESS_STATS
+{
+	uint32_t ulSleeps;				/* Sleeps entered with the tick suppressed. */
+	uint32_t ulSleepsAborted;		/* Sleeps given up before the core stopped. */
+	uint32_t ulEarlyWakes;			/* Sleeps ended before the expected idle time. */
+	uint32_t ulTicksSuppressed;		/* Tick interrupts that were not taken. */
+	uint32_t ulMaxWakeLatency;		/* Worst delay from the wake up match to the core running. */
+	uint32_t ulMaxTickLatency;		/* Worst delay from a tick match to its handler. */
+	uint32_t ulCountsPerTick;		/* Timer counts in one tick period. */
+} TicklessStats_t;
+
+void vPortTicklessInit( uint32_t ulCountsPerTick, uint32_t ulMaxIntervalCount );
+void vPortTicklessTickHandled( void );
+void vPortSuppressTicksAndSleep( TickType_t xExpectedIdleTime );
+void vPortGetTicklessStats( TicklessStats_t *pxStats );
+void vPortResetTicklessStats( void );
+#define portSUPPRESS_TICKS_AND_SLEEP( xExpectedIdleTime ) vPortSuppressTicksAndSleep( xExpectedIdleTime )
+
+/*
+ * The timer arithmetic below only depends on its arguments.  ulCount is
+ * always the number of counts since the last match, the counter restarts
+ * from 0 at every match and runs up to the interval register value.
+ */
+
+/* Returns non zero if the current tick period still has room to widen the
+interval before the counter reaches the match. */
+static __inline uint32_t ulPortTicklessCanSleep( uint32_t ulCount, uint32_t ulCountsPerTick )
+{
+	return ( ( ulCount + configTICKLESS_GUARD_COUNTS ) < ulCountsPerTick ) ? 1UL : 0UL;
+}
+
+/* Interval register value that puts the match ulTicks tick periods after the
+last match. */
+static __inline uint32_t ulPortTicklessReload( uint32_t ulTicks, uint32_t ulCountsPerTick )
+{
+	return ( ulTicks * ulCountsPerTick ) - 1UL;
+}
+
+/* Number of tick periods from the last match to the first tick boundary that
+is at least configTICKLESS_GUARD_COUNTS ahead of ulCount. */
+static __inline uint32_t ulPortTicklessNextBoundary( uint32_t ulCount, uint32_t ulCountsPerTick )
+{
+uint32_t ulTicks;
+
+	ulTicks = ( ulCount / ulCountsPerTick ) + 1UL;
+	if( ( ( ulTicks * ulCountsPerTick ) - ulCount ) <= configTICKLESS_GUARD_COUNTS )
+	{
+		ulTicks++;
+	}
+
+	return ulTicks;
+}
+
+/* Ticks to step the kernel by after a sleep of ulExpectedIdle ticks.
+ulBoundaryTicks is ulPortTicklessNextBoundary() of the counter value on wake
+up.  When the wake up match was reached (xMatched) the pending tick interrupt
+accounts for one tick and the counter was restarted at the match.  The step
+never goes past the time the kernel expects to wake, the remaining ticks are
+lost as for any late tick. */
+static __inline uint32_t ulPortTicklessStepTicks( uint32_t ulExpectedIdle, uint32_t xMatched, uint32_t ulBoundaryTicks )
+{
+uint32_t ulStepTicks = ulBoundaryTicks - 1UL;
+
+	if( xMatched != 0UL )
+	{
+		ulStepTicks += ulExpectedIdle - 1UL;
+	}
+
+	if( ulStepTicks > ulExpectedIdle )
+	{
+		ulStepTicks = ulExpectedIdle;
+	}
+
+	return ulStepTicks;
+}
+
+#endif /* PORT_TICKLESS_TTC_H */
@@ -36,6 +36,10 @@
 
 void vApplicationAssert( const char *pcFileName, uint32_t ulLine )
 		__attribute__((weak));
+void vApplicationTickHook( void ) __attribute__((weak));
+void vApplicationIdleHook( void ) __attribute__((weak));
+void vApplicationMallocFailedHook( void ) __attribute__((weak));
+void vApplicationStackOverflowHook( TaskHandle_t xTask, char *pcTaskName ) __attribute__((weak));
 
 /* Timer used to generate the tick interrupt. */
 XTtcPs xTimerInstance;
@@ -80,6 +84,10 @@ const uint8_t ucLevelSensitive = 1;
 	/* Set the interval and prescale. */
 	XTtcPs_SetInterval( &xTimerInstance, usInterval );
 	XTtcPs_SetPrescaler( &xTimerInstance, ucPrescale );
+#if( configUSE_TICKLESS_IDLE != 0 )
+	/* In interval mode the counter runs from 0 to the interval value. */
+	vPortTicklessInit( ( uint32_t ) usInterval + 1UL, XTTCPS_MAX_INTERVAL_COUNT );
+#endif
 
 	xPortInstallInterruptHandler(configTIMER_INTERRUPT_ID,
 					( Xil_InterruptHandler ) FreeRTOS_Tick_Handler,
@@ -101,6 +109,9 @@ void FreeRTOS_ClearTickInterrupt( void )
 {
 
 	XTtcPs_ClearInterruptStatus( &xTimerInstance, XTtcPs_GetInterruptStatus( &xTimerInstance ) );
+#if( configUSE_TICKLESS_IDLE != 0 )
+	vPortTicklessTickHandled();
+#endif
 	__asm volatile( "DSB SY" );
 	__asm volatile( "ISB SY" );
 }
@@ -238,6 +238,15 @@ void vPortTaskUsesFPU( void );
 #endif /* configASSERT */
 
 #define portNOP() __asm volatile( "NOP" )
+
+#if( configUSE_TICKLESS_IDLE != 0 )
+/* Only the CPU IRQ mask is used while sleeping, a pending interrupt that is
+masked this way still wakes the core from WFI. */
+#define portTICKLESS_DISABLE_IRQ()	portDISABLE_INTERRUPTS()
+#define portTICKLESS_ENABLE_IRQ()	portENABLE_INTERRUPTS()
+
+#include "portTicklessTTC.h"
+#endif
 #define portINLINE __inline
 
 #ifdef __cplusplus
@@ -53,7 +53,7 @@ void vApplicationMallocFailedHook( void ) __attribute((weak));
 void vApplicationStackOverflowHook( TaskHandle_t xTask, char *pcTaskName ) __attribute__((weak));
 
 /* Timer used to generate the tick interrupt. */
-static XTtcPs xTimerInstance;
+XTtcPs xTimerInstance;
 XScuGic xInterruptController;
 /*-----------------------------------------------------------*/
 
@@ -113,6 +113,10 @@ XScuGic_Config *pxInterruptControllerConfig;
 #endif
 	XTtcPs_SetInterval( &xTimerInstance, usInterval );
 	XTtcPs_SetPrescaler( &xTimerInstance, ucPrescaler );
+#if( configUSE_TICKLESS_IDLE != 0 )
+	/* In interval mode the counter runs from 0 to the interval value. */
+	vPortTicklessInit( ( uint32_t ) usInterval + 1UL, XTTCPS_MAX_INTERVAL_COUNT );
+#endif
 	/* Enable the interrupt for timer. */
 	XScuGic_EnableIntr( configINTERRUPT_CONTROLLER_BASE_ADDRESS, configTIMER_INTERRUPT_ID );
 	XTtcPs_EnableInterrupts( &xTimerInstance, XTTCPS_IXR_INTERVAL_MASK );
@@ -125,6 +129,9 @@ void FreeRTOS_ClearTickInterrupt( void )
 {
 
 	XTtcPs_ClearInterruptStatus( &xTimerInstance, XTtcPs_GetInterruptStatus( &xTimerInstance ) );
+#if( configUSE_TICKLESS_IDLE != 0 )
+	vPortTicklessTickHandled();
+#endif
 }
 /*-----------------------------------------------------------*/
 
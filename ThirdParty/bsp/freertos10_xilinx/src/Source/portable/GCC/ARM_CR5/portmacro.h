@@ -203,6 +203,15 @@ void vPortTaskUsesFPU( void );
 
 #define portNOP() __asm volatile( "NOP" )
 
+#if( configUSE_TICKLESS_IDLE != 0 )
+/* Only the CPU IRQ mask is used while sleeping, a pending interrupt that is
+masked this way still wakes the core from WFI. */
+#define portTICKLESS_DISABLE_IRQ()	__asm volatile ( "CPSID i" ::: "memory" )
+#define portTICKLESS_ENABLE_IRQ()	__asm volatile ( "CPSIE i" ::: "memory" )
+
+#include "portTicklessTTC.h"
+#endif
+
 
 #ifdef __cplusplus
 	} /* extern C */
@@ -0,0 +1,185 @@
+/*
+ * FreeRTOS Kernel V10.3.0
+ * Copyright (C) 2020 Amazon.com, Inc. or its affiliates.  All Rights Reserved.
+ * Copyright (C) 2020 Xilinx, Inc. All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * http://www.FreeRTOS.org
+ * http://aws.amazon.com/freertos
+ *
+ * 1 tab == 4 spaces!
+ */
+
+/*
+ * Host test of the TTC tickless idle arithmetic in portTicklessTTC.h.
+ *
+ * A free running interval timer is modelled by absolute counts since the
+ * last tick boundary before the sleep.  For every tick period, expected idle
+ * time and wake up point the kernel tick count after the sleep, plus the
+ * tick interrupts still to come, has to match the tick boundaries the real
+ * timer passes, so the tick neither drifts nor runs ahead.
+ *
+ * Build and run on the host:
+ *   cc -Wall -I../src/Source/portable/Common test_tickless_ttc.c -o test_tickless_ttc
+ *   ./test_tickless_ttc
+ */
+
+#include <stdio.h>
+#include <stdint.h>
+#include <stdlib.h>
+
+typedef uint32_t TickType_t;
+#include "portTicklessTTC.h"
+
+static unsigned long ulFailures = 0;
+
+#define CHECK( xCond, ... )												\
+	do {																\
+		if( !( xCond ) )												\
+		{																\
+			if( ulFailures < 20UL )										\
+			{															\
+				printf( "FAIL line %d: ", __LINE__ );					\
+				printf( __VA_ARGS__ );									\
+				printf( "\n" );											\
+			}															\
+			ulFailures++;												\
+		}																\
+	} while( 0 )
+
+static void prvCheckBoundary( uint32_t ulCount, uint32_t ulCountsPerTick )
+{
+uint32_t ulTicks = ulPortTicklessNextBoundary( ulCount, ulCountsPerTick );
+uint64_t ullMatch = ( uint64_t ) ulTicks * ulCountsPerTick;
+
+	/* The new match is far enough ahead to be written safely ... */
+	CHECK( ullMatch > ( uint64_t ) ulCount + configTICKLESS_GUARD_COUNTS,
+		   "cpt %u count %u ticks %u", ulCountsPerTick, ulCount, ulTicks );
+	/* ... and it is the first boundary that is. */
+	CHECK( ( ulTicks == 1UL ) ||
+		   ( ( ullMatch - ulCountsPerTick ) <= ( uint64_t ) ulCount + configTICKLESS_GUARD_COUNTS ),
+		   "cpt %u count %u ticks %u not the first", ulCountsPerTick, ulCount, ulTicks );
+	CHECK( ulPortTicklessReload( ulTicks, ulCountsPerTick ) + 1UL == ( uint32_t ) ullMatch,
+		   "reload of %u ticks", ulTicks );
+}
+
+/*
+ * Sleep for ulExpected ticks from ulStart counts into the current tick and
+ * wake up ulWake counts after the tick boundary the sleep started from.
+ */
+static void prvCheckSleep( uint32_t ulCountsPerTick, uint32_t ulExpected, uint32_t ulStart, uint32_t ulWake )
+{
+uint64_t ullSleepMatch = ( uint64_t ) ulExpected * ulCountsPerTick;
+uint64_t ullNextMatch;
+uint32_t ulMatched;
+uint32_t ulCount;
+uint32_t ulBoundary;
+uint32_t ulStep;
+uint32_t ulKernelTicks;
+
+	if( ulPortTicklessCanSleep( ulStart, ulCountsPerTick ) == 0UL )
+	{
+		CHECK( ulStart + configTICKLESS_GUARD_COUNTS >= ulCountsPerTick, "sleep refused at %u", ulStart );
+		return;
+	}
+
+	/* The interval register is widened from the last boundary. */
+	CHECK( ulPortTicklessReload( ulExpected, ulCountsPerTick ) + 1ULL == ullSleepMatch, "sleep reload" );
+
+	ulMatched = ( ulWake >= ullSleepMatch ) ? 1UL : 0UL;
+	if( ulMatched != 0UL )
+	{
+		/* The counter restarted at the sleep match. */
+		ulCount = ( uint32_t ) ( ulWake - ullSleepMatch );
+		ulBoundary = ulPortTicklessNextBoundary( ulCount, ulCountsPerTick );
+		ullNextMatch = ullSleepMatch + ( ( uint64_t ) ulBoundary * ulCountsPerTick );
+	}
+	else
+	{
+		ulCount = ulWake;
+		ulBoundary = ulPortTicklessNextBoundary( ulCount, ulCountsPerTick );
+		ullNextMatch = ( uint64_t ) ulBoundary * ulCountsPerTick;
+	}
+
+	ulStep = ulPortTicklessStepTicks( ulExpected, ulMatched, ulBoundary );
+	CHECK( ulStep <= ulExpected, "step %u past expected %u", ulStep, ulExpected );
+
+	/* Ticks the kernel has seen once the pending tick interrupt, if any, and
+	the interrupt at the next match have been taken. */
+	ulKernelTicks = ulStep + ulMatched + 1UL;
+
+	if( ( ulMatched != 0UL ) && ( ulStep == ulExpected ) && ( ulBoundary > 2UL ) )
+	{
+		/* Woken more than a period after the match, the lost ticks are dropped
+		as for any late tick. */
+		CHECK( ( uint64_t ) ulKernelTicks * ulCountsPerTick < ullNextMatch, "late wake" );
+		return;
+	}
+
+	/* No drift: the kernel count equals the boundaries passed at the match. */
+	CHECK( ( uint64_t ) ulKernelTicks * ulCountsPerTick == ullNextMatch,
+		   "cpt %u exp %u wake %u: kernel %u match %llu", ulCountsPerTick, ulExpected, ulWake,
+		   ulKernelTicks, ( unsigned long long ) ullNextMatch );
+
+	/* Before that interrupt the kernel is never ahead of the time slept by
+	more than the guard distance. */
+	CHECK( ( uint64_t ) ( ulStep + ulMatched ) * ulCountsPerTick <= ( uint64_t ) ulWake + configTICKLESS_GUARD_COUNTS,
+		   "cpt %u exp %u wake %u: kernel ahead", ulCountsPerTick, ulExpected, ulWake );
+}
+
+int main( void )
+{
+static const uint32_t ulPeriods[] = { 100UL, 1000UL, 4999UL, 33333UL, 65536UL };
+uint32_t ulIndex;
+uint32_t ulCountsPerTick;
+uint32_t ulExpected;
+uint32_t ulMaxTicks;
+uint32_t ulCount;
+uint32_t ulStart;
+uint32_t ulWake;
+unsigned long ulCases = 0;
+
+	srand( 1 );
+
+	for( ulIndex = 0; ulIndex < ( sizeof( ulPeriods ) / sizeof( ulPeriods[ 0 ] ) ); ulIndex++ )
+	{
+		ulCountsPerTick = ulPeriods[ ulIndex ];
+		ulMaxTicks = 0xFFFFFFFFUL / ulCountsPerTick;
+
+		for( ulCount = 0; ulCount < 4UL * ulCountsPerTick; ulCount += 1UL + ( ulCountsPerTick / 997UL ) )
+		{
+			prvCheckBoundary( ulCount, ulCountsPerTick );
+			ulCases++;
+		}
+
+		for( ulExpected = 2; ulExpected < 40UL && ulExpected <= ulMaxTicks / 2UL; ulExpected++ )
+		{
+			/* Wake up points from the sleep entry to past the sleep match. */
+			ulStart = ( uint32_t ) rand() % ulCountsPerTick;
+			for( ulWake = ulStart; ulWake < ( ulExpected + 3UL ) * ulCountsPerTick; ulWake += 1UL + ( ulCountsPerTick / 251UL ) )
+			{
+				prvCheckSleep( ulCountsPerTick, ulExpected, ulStart, ulWake );
+				ulCases++;
+			}
+		}
+	}
+
+	printf( "%lu cases, %lu failures\n", ulCases, ulFailures );
+	return ( ulFailures == 0UL ) ? 0 : 1;
+}
@@ -27,6 +27,9 @@ extern "C" {
 /* Configurable parameters */
 #define RPMSG_NAME_SIZE		(32)
 #define RPMSG_ADDR_BMP_SIZE	(128)
+#ifndef RPMSG_NAME_HASH_SIZE
+#define RPMSG_NAME_HASH_SIZE	(16)
+#endif
 
 #define RPMSG_NS_EPT_ADDR	(0x35)
 #define RPMSG_ADDR_ANY		0xFFFFFFFF
@@ -62,6 +65,7 @@ typedef void (*rpmsg_ns_bind_cb)(struct rpmsg_device *rdev,
  * @ns_unbind_cb: end point service unbind callback, called when remote
  *                ept is destroyed.
  * @node: end point node.
+ * @name_node: end point node in the name hash bucket.
  * @priv: private data for the driver's use
  *
  * In essence, an rpmsg endpoint represents a listener on the rpmsg bus, as
@@ -75,22 +79,39 @@ struct rpmsg_endpoint {
 	rpmsg_ept_cb cb;
 	rpmsg_ns_unbind_cb ns_unbind_cb;
 	struct metal_list node;
+	struct metal_list name_node;
 	void *priv;
 };
 
 /**
  * struct rpmsg_device_ops - RPMsg device operations
  * @send_offchannel_raw: send RPMsg data
+ * @hold_rx_buffer: hold RPMsg RX buffer
+ * @release_rx_buffer: release RPMsg RX buffer
+ * @get_tx_payload_buffer: get RPMsg TX buffer
+ * @send_offchannel_nocopy: send RPMsg data without copy
+ * @release_tx_buffer: release an unsent RPMsg TX buffer
  */
 struct rpmsg_device_ops {
 	int (*send_offchannel_raw)(struct rpmsg_device *rdev,
 				   uint32_t src, uint32_t dst,
 				   const void *data, int size, int wait);
+	void (*hold_rx_buffer)(struct rpmsg_device *rdev, void *rxbuf);
+	void (*release_rx_buffer)(struct rpmsg_device *rdev, void *rxbuf);
+	void *(*get_tx_payload_buffer)(struct rpmsg_device *rdev,
+				       uint32_t *len, int wait);
+	int (*send_offchannel_nocopy)(struct rpmsg_device *rdev,
+				      uint32_t src, uint32_t dst,
+				      const void *data, int len);
+	int (*release_tx_buffer)(struct rpmsg_device *rdev, void *txbuf);
 };
 
 /**
  * struct rpmsg_device - representation of a RPMsg device
  * @endpoints: list of endpoints
+ * @ept_table: endpoints indexed by local address
+ * @name_table: endpoints hashed by service name
+ * @ept_any_count: number of endpoints without a local address
  * @ns_ept: name service endpoint
  * @bitmap: table endpoint address allocation.
  * @lock: mutex lock for rpmsg management
@@ -101,6 +122,9 @@ struct rpmsg_device_ops {
  */
 struct rpmsg_device {
 	struct metal_list endpoints;
+	struct rpmsg_endpoint *ept_table[RPMSG_ADDR_BMP_SIZE];
+	struct metal_list name_table[RPMSG_NAME_HASH_SIZE];
+	unsigned int ept_any_count;
 	struct rpmsg_endpoint ns_ept;
 	unsigned long bitmap[metal_bitmap_longs(RPMSG_ADDR_BMP_SIZE)];
 	metal_mutex_t lock;
@@ -267,6 +291,106 @@ static inline int rpmsg_trysend_offchannel(struct rpmsg_endpoint *ept,
 	return rpmsg_send_offchannel_raw(ept, src, dst, data, len, false);
 }
 
+/**
+ * rpmsg_hold_rx_buffer() - hold an RX buffer for later processing
+ * @ept: the rpmsg endpoint
+ * @rxbuf: RX buffer with message payload, as passed to the endpoint callback
+ *
+ * Must be called from within the endpoint callback. The buffer is then not
+ * returned to the virtqueue when the callback returns, and the application
+ * keeps access to the payload until it calls rpmsg_release_rx_buffer().
+ */
+void rpmsg_hold_rx_buffer(struct rpmsg_endpoint *ept, void *rxbuf);
+
+/**
+ * rpmsg_release_rx_buffer() - release a previously held RX buffer
+ * @ept: the rpmsg endpoint
+ * @rxbuf: RX buffer with message payload
+ *
+ * Returns the buffer to the virtqueue so that the remote side can reuse it.
+ */
+void rpmsg_release_rx_buffer(struct rpmsg_endpoint *ept, void *rxbuf);
+
+/**
+ * rpmsg_get_tx_payload_buffer() - get a TX buffer to fill in place
+ * @ept: the rpmsg endpoint
+ * @len: returns the size of the payload area of the buffer
+ * @wait: boolean, wait or not for a buffer to become available
+ *
+ * The application fills the returned payload area directly and then sends
+ * it with rpmsg_send_nocopy() or one of its variants, which avoids copying
+ * the data into the vring buffer. A buffer obtained this way must either be
+ * sent or given back with rpmsg_release_tx_buffer(), also when the send call
+ * fails.
+ *
+ * Returns pointer to the payload area, or NULL if no buffer is available.
+ */
+void *rpmsg_get_tx_payload_buffer(struct rpmsg_endpoint *ept,
+				  uint32_t *len, int wait);
+
+/**
+ * rpmsg_release_tx_buffer() - give back an unsent TX payload buffer
+ * @ept: the rpmsg endpoint
+ * @txbuf: payload buffer returned by rpmsg_get_tx_payload_buffer()
+ *
+ * Used when the application does not send a buffer it has obtained, for
+ * instance after rpmsg_send_nocopy() rejected it. The buffer is returned to
+ * the device and handed out again by the next rpmsg_get_tx_payload_buffer().
+ *
+ * Returns RPMSG_SUCCESS or negative error value on failure.
+ */
+int rpmsg_release_tx_buffer(struct rpmsg_endpoint *ept, void *txbuf);
+
+/**
+ * rpmsg_send_offchannel_nocopy() - send a TX payload buffer using explicit
+ * src/dst addresses
+ * @ept: the rpmsg endpoint
+ * @src: source address
+ * @dst: destination address
+ * @data: payload buffer returned by rpmsg_get_tx_payload_buffer()
+ * @len: length of payload
+ *
+ * On success the buffer is handed over to the remote side and must not be
+ * accessed by the application after this call. On failure the application
+ * still owns the buffer and must send or release it.
+ *
+ * Returns number of bytes it has sent or negative error value on failure.
+ */
+int rpmsg_send_offchannel_nocopy(struct rpmsg_endpoint *ept, uint32_t src,
+				 uint32_t dst, const void *data, int len);
+
+/**
+ * rpmsg_sendto_nocopy() - send a TX payload buffer, specify dst
+ * @ept: the rpmsg endpoint
+ * @data: payload buffer returned by rpmsg_get_tx_payload_buffer()
+ * @len: length of payload
+ * @dst: destination address
+ *
+ * Returns number of bytes it has sent or negative error value on failure.
+ */
+static inline int rpmsg_sendto_nocopy(struct rpmsg_endpoint *ept,
+				      const void *data, int len, uint32_t dst)
+{
+	return rpmsg_send_offchannel_nocopy(ept, ept->addr, dst, data, len);
+}
+
+/**
+ * rpmsg_send_nocopy() - send a TX payload buffer on the endpoint channel
+ * @ept: the rpmsg endpoint
+ * @data: payload buffer returned by rpmsg_get_tx_payload_buffer()
+ * @len: length of payload
+ *
+ * Returns number of bytes it has sent or negative error value on failure.
+ */
+static inline int rpmsg_send_nocopy(struct rpmsg_endpoint *ept,
+				    const void *data, int len)
+{
+	if (ept->dest_addr == RPMSG_ADDR_ANY)
+		return RPMSG_ERR_ADDR;
+	return rpmsg_send_offchannel_nocopy(ept, ept->addr, ept->dest_addr,
+					    data, len);
+}
+
 /**
  * rpmsg_init_ept - initialize rpmsg endpoint
  *
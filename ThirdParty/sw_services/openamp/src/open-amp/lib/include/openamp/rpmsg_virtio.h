@@ -49,6 +49,7 @@ struct rpmsg_virtio_shm_pool {
  * @svq: pointer to send virtqueue
  * @shbuf_io: pointer to the shared buffer I/O region
  * @shpool: pointer to the shared buffers pool
+ * @reclaimer: TX buffers released without being sent
  */
 struct rpmsg_virtio_device {
 	struct rpmsg_device rdev;
@@ -57,6 +58,7 @@ struct rpmsg_virtio_device {
 	struct virtqueue *svq;
 	struct metal_io_region *shbuf_io;
 	struct rpmsg_virtio_shm_pool *shpool;
+	struct metal_list reclaimer;
 };
 
 #define RPMSG_REMOTE	VIRTIO_DEV_SLAVE
@@ -12,6 +12,40 @@
 
 #include "rpmsg_internal.h"
 
+/**
+ * rpmsg_find_first_zero
+ *
+ * Finds the first clear bit of a bitmap, skipping fully used words.
+ *
+ * @param bitmap - bit map for addresses
+ * @param size   - size of bitmap
+ *
+ * return - index of the first clear bit, or size if all bits are set
+ */
+static unsigned int rpmsg_find_first_zero(unsigned long *bitmap,
+					  unsigned int size)
+{
+	unsigned int i;
+	unsigned int bit;
+	unsigned long word;
+
+	for (i = 0; i < metal_bitmap_longs(size); i++) {
+		word = ~bitmap[i];
+		if (!word)
+			continue;
+#ifdef __GNUC__
+		bit = (unsigned int)__builtin_ctzl(word);
+#else
+		for (bit = 0; !(word & (1UL << bit)); bit++)
+			;
+#endif
+		bit += i * METAL_BITS_PER_ULONG;
+		return bit < size ? bit : size;
+	}
+
+	return size;
+}
+
 /**
  * rpmsg_get_address
  *
@@ -27,7 +61,7 @@ static uint32_t rpmsg_get_address(unsigned long *bitmap, int size)
 	unsigned int addr = RPMSG_ADDR_ANY;
 	unsigned int nextbit;
 
-	nextbit = metal_bitmap_next_clear_bit(bitmap, 0, size);
+	nextbit = rpmsg_find_first_zero(bitmap, size);
 	if (nextbit < (uint32_t)size) {
 		addr = nextbit;
 		metal_bitmap_set_bit(bitmap, nextbit);
@@ -36,6 +70,26 @@ static uint32_t rpmsg_get_address(unsigned long *bitmap, int size)
 	return addr;
 }
 
+/**
+ * rpmsg_name_hash
+ *
+ * Computes the name hash table bucket of a service name.
+ *
+ * @param name - service name
+ *
+ * return - bucket index
+ */
+static unsigned int rpmsg_name_hash(const char *name)
+{
+	unsigned int hash = 5381;
+	unsigned int i;
+
+	for (i = 0; i < RPMSG_NAME_SIZE && name[i]; i++)
+		hash = (hash << 5) + hash + (unsigned char)name[i];
+
+	return hash % RPMSG_NAME_HASH_SIZE;
+}
+
 /**
  * rpmsg_release_address
  *
@@ -124,6 +178,80 @@ int rpmsg_send_offchannel_raw(struct rpmsg_endpoint *ept, uint32_t src,
 	return RPMSG_ERR_PARAM;
 }
 
+void rpmsg_hold_rx_buffer(struct rpmsg_endpoint *ept, void *rxbuf)
+{
+	struct rpmsg_device *rdev;
+
+	if (!ept || !ept->rdev || !rxbuf)
+		return;
+
+	rdev = ept->rdev;
+
+	if (rdev->ops.hold_rx_buffer)
+		rdev->ops.hold_rx_buffer(rdev, rxbuf);
+}
+
+void rpmsg_release_rx_buffer(struct rpmsg_endpoint *ept, void *rxbuf)
+{
+	struct rpmsg_device *rdev;
+
+	if (!ept || !ept->rdev || !rxbuf)
+		return;
+
+	rdev = ept->rdev;
+
+	if (rdev->ops.release_rx_buffer)
+		rdev->ops.release_rx_buffer(rdev, rxbuf);
+}
+
+void *rpmsg_get_tx_payload_buffer(struct rpmsg_endpoint *ept,
+				  uint32_t *len, int wait)
+{
+	struct rpmsg_device *rdev;
+
+	if (!ept || !ept->rdev || !len)
+		return NULL;
+
+	rdev = ept->rdev;
+
+	if (rdev->ops.get_tx_payload_buffer)
+		return rdev->ops.get_tx_payload_buffer(rdev, len, wait);
+
+	return NULL;
+}
+
+int rpmsg_release_tx_buffer(struct rpmsg_endpoint *ept, void *txbuf)
+{
+	struct rpmsg_device *rdev;
+
+	if (!ept || !ept->rdev || !txbuf)
+		return RPMSG_ERR_PARAM;
+
+	rdev = ept->rdev;
+
+	if (rdev->ops.release_tx_buffer)
+		return rdev->ops.release_tx_buffer(rdev, txbuf);
+
+	return RPMSG_ERR_PARAM;
+}
+
+int rpmsg_send_offchannel_nocopy(struct rpmsg_endpoint *ept, uint32_t src,
+				 uint32_t dst, const void *data, int len)
+{
+	struct rpmsg_device *rdev;
+
+	if (!ept || !ept->rdev || !data || dst == RPMSG_ADDR_ANY)
+		return RPMSG_ERR_PARAM;
+
+	rdev = ept->rdev;
+
+	if (rdev->ops.send_offchannel_nocopy)
+		return rdev->ops.send_offchannel_nocopy(rdev, src, dst,
+							data, len);
+
+	return RPMSG_ERR_PARAM;
+}
+
 int rpmsg_send_ns_message(struct rpmsg_endpoint *ept, unsigned long flags)
 {
 	struct rpmsg_ns_msg ns_msg;
@@ -141,34 +269,96 @@ int rpmsg_send_ns_message(struct rpmsg_endpoint *ept, unsigned long flags)
 		return RPMSG_SUCCESS;
 }
 
+/**
+ * rpmsg_ept_match
+ *
+ * Checks an endpoint against the rpmsg_get_endpoint() lookup rules.
+ *
+ * @param ept       - endpoint to check
+ * @param name      - service name, or NULL
+ * @param addr      - local address, or RPMSG_ADDR_ANY
+ * @param dest_addr - remote address, or RPMSG_ADDR_ANY
+ *
+ * return - true if the endpoint matches
+ */
+static bool rpmsg_ept_match(struct rpmsg_endpoint *ept, const char *name,
+			    uint32_t addr, uint32_t dest_addr)
+{
+	/* try to get by local address only */
+	if (addr != RPMSG_ADDR_ANY && ept->addr == addr)
+		return true;
+	/* try to find match on local end remote address */
+	if (addr == ept->addr && dest_addr == ept->dest_addr)
+		return true;
+	/* else use name service and destination address */
+	if (!name || strncmp(ept->name, name, sizeof(ept->name)))
+		return false;
+	/* destination address is known, equal to ept remote address */
+	if (dest_addr != RPMSG_ADDR_ANY && ept->dest_addr == dest_addr)
+		return true;
+	/* ept is registered but not associated to remote ept */
+	if (addr == RPMSG_ADDR_ANY && ept->dest_addr == RPMSG_ADDR_ANY)
+		return true;
+	return false;
+}
+
 struct rpmsg_endpoint *rpmsg_get_endpoint(struct rpmsg_device *rdev,
 					  const char *name, uint32_t addr,
 					  uint32_t dest_addr)
 {
 	struct metal_list *node;
+	struct metal_list *bucket;
 	struct rpmsg_endpoint *ept;
 
-	metal_list_for_each(&rdev->endpoints, node) {
-		int name_match = 0;
+	/* Per-message lookup, local addresses are bounded by the bitmap */
+	if (!name && addr < RPMSG_ADDR_BMP_SIZE)
+		return rdev->ept_table[addr];
+
+	/*
+	 * Name service lookup. Endpoints matching by name are all in the
+	 * bucket, in list order, and without endpoints lacking a local
+	 * address nothing else can match.
+	 */
+	if (name && addr == RPMSG_ADDR_ANY && !rdev->ept_any_count) {
+		bucket = &rdev->name_table[rpmsg_name_hash(name)];
+		metal_list_for_each(bucket, node) {
+			ept = metal_container_of(node, struct rpmsg_endpoint,
+						 name_node);
+			if (rpmsg_ept_match(ept, name, addr, dest_addr))
+				return ept;
+		}
+		return NULL;
+	}
 
+	/* Other lookups depend on the list order across several rules */
+	metal_list_for_each(&rdev->endpoints, node) {
 		ept = metal_container_of(node, struct rpmsg_endpoint, node);
-		/* try to get by local address only */
-		if (addr != RPMSG_ADDR_ANY && ept->addr == addr)
-			return ept;
-		/* try to find match on local end remote address */
-		if (addr == ept->addr && dest_addr == ept->dest_addr)
+		if (rpmsg_ept_match(ept, name, addr, dest_addr))
 			return ept;
-		/* else use name service and destination address */
-		if (name)
-			name_match = !strncmp(ept->name, name,
-					      sizeof(ept->name));
-		if (!name || !name_match)
-			continue;
-		/* destination address is known, equal to ept remote address */
-		if (dest_addr != RPMSG_ADDR_ANY && ept->dest_addr == dest_addr)
-			return ept;
-		/* ept is registered but not associated to remote ept */
-		if (addr == RPMSG_ADDR_ANY && ept->dest_addr == RPMSG_ADDR_ANY)
+	}
+	return NULL;
+}
+
+/**
+ * rpmsg_first_ept_by_addr
+ *
+ * Finds the first registered endpoint with a local address, used to refill
+ * the address table when an endpoint is unregistered.
+ *
+ * @param rdev - pointer to the rpmsg device
+ * @param addr - local address
+ *
+ * return - endpoint, or NULL if none has this address
+ */
+static struct rpmsg_endpoint *rpmsg_first_ept_by_addr(struct rpmsg_device *rdev,
+						      uint32_t addr)
+{
+	struct metal_list *node;
+	struct rpmsg_endpoint *ept;
+
+	metal_list_for_each(&rdev->endpoints, node) {
+		ept = metal_container_of(node, struct rpmsg_endpoint, node);
+		if (ept->addr == addr)
 			return ept;
 	}
 	return NULL;
@@ -186,7 +376,26 @@ static void rpmsg_unregister_endpoint(struct rpmsg_endpoint *ept)
 	if (ept->addr != RPMSG_ADDR_ANY)
 		rpmsg_release_address(rdev->bitmap, RPMSG_ADDR_BMP_SIZE,
 				      ept->addr);
+	if (ept->addr == RPMSG_ADDR_ANY)
+		rdev->ept_any_count--;
+	metal_list_del(&ept->name_node);
 	metal_list_del(&ept->node);
+	if (ept->addr < RPMSG_ADDR_BMP_SIZE &&
+	    rdev->ept_table[ept->addr] == ept)
+		rdev->ept_table[ept->addr] =
+			rpmsg_first_ept_by_addr(rdev, ept->addr);
+}
+
+void rpmsg_init_endpoints(struct rpmsg_device *rdev)
+{
+	unsigned int i;
+
+	metal_list_init(&rdev->endpoints);
+	rdev->ept_any_count = 0;
+	for (i = 0; i < RPMSG_ADDR_BMP_SIZE; i++)
+		rdev->ept_table[i] = NULL;
+	for (i = 0; i < RPMSG_NAME_HASH_SIZE; i++)
+		metal_list_init(&rdev->name_table[i]);
 }
 
 void rpmsg_register_endpoint(struct rpmsg_device *rdev,
@@ -194,6 +403,13 @@ void rpmsg_register_endpoint(struct rpmsg_device *rdev,
 {
 	ept->rdev = rdev;
 	metal_list_add_tail(&rdev->endpoints, &ept->node);
+	metal_list_add_tail(&rdev->name_table[rpmsg_name_hash(ept->name)],
+			    &ept->name_node);
+	/* Keep the first registered endpoint, as the list lookup did */
+	if (ept->addr < RPMSG_ADDR_BMP_SIZE && !rdev->ept_table[ept->addr])
+		rdev->ept_table[ept->addr] = ept;
+	if (ept->addr == RPMSG_ADDR_ANY)
+		rdev->ept_any_count++;
 }
 
 int rpmsg_create_ept(struct rpmsg_endpoint *ept, struct rpmsg_device *rdev,
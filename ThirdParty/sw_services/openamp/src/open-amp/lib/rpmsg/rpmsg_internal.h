@@ -35,7 +35,18 @@ extern "C" {
 	} while (0)
 #endif
 
+#define RPMSG_LOCATE_HDR(p) \
+	((struct rpmsg_hdr *)((unsigned char *)(p) - sizeof(struct rpmsg_hdr)))
 #define RPMSG_LOCATE_DATA(p) ((unsigned char *)(p) + sizeof(struct rpmsg_hdr))
+
+/*
+ * While a buffer is owned by the application (RX buffer held or TX payload
+ * buffer not yet sent) the reserved field of its header holds the vring
+ * buffer index, and RPMSG_BUF_HELD marks RX buffers that must not be
+ * returned to the virtqueue when the endpoint callback returns.
+ */
+#define RPMSG_BUF_HELD		(1U << 31)
+#define RPMSG_BUF_IDX_MASK	(0xFFFFU)
 /**
  * enum rpmsg_ns_flags - dynamic name service announcement flags
  *
@@ -94,6 +105,7 @@ struct rpmsg_endpoint *rpmsg_get_endpoint(struct rpmsg_device *rvdev,
 					  uint32_t dest_addr);
 void rpmsg_register_endpoint(struct rpmsg_device *rdev,
 			     struct rpmsg_endpoint *ept);
+void rpmsg_init_endpoints(struct rpmsg_device *rdev);
 
 static inline struct rpmsg_endpoint *
 rpmsg_get_ept_from_addr(struct rpmsg_device *rdev, uint32_t addr)
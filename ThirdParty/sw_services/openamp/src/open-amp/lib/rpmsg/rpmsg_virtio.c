@@ -123,10 +123,21 @@ static int rpmsg_virtio_enqueue_buffer(struct rpmsg_virtio_device *rvdev,
 	return 0;
 }
 
+/*
+ * A TX buffer released without being sent is queued on the reclaimer list,
+ * reusing the start of the buffer to store the list node and the vring
+ * buffer index.
+ */
+struct vbuff_reclaimer_t {
+	uint32_t idx;
+	struct metal_list node;
+};
+
 /**
  * rpmsg_virtio_get_tx_buffer
  *
- * Provides buffer to transmit messages.
+ * Provides buffer to transmit messages. Released TX buffers are handed out
+ * first.
  *
  * @param rvdev - pointer to rpmsg device
  * @param len  - length of returned buffer
@@ -138,8 +149,25 @@ static void *rpmsg_virtio_get_tx_buffer(struct rpmsg_virtio_device *rvdev,
 					uint32_t *len, uint16_t *idx)
 {
 	unsigned int role = rpmsg_virtio_get_role(rvdev);
+	struct vbuff_reclaimer_t *r_desc;
+	struct metal_list *node;
 	void *data = NULL;
 
+	if (!metal_list_is_empty(&rvdev->reclaimer)) {
+		node = metal_list_first(&rvdev->reclaimer);
+		metal_list_del(node);
+		r_desc = metal_container_of(node, struct vbuff_reclaimer_t,
+					    node);
+		*idx = (uint16_t)r_desc->idx;
+#ifndef VIRTIO_SLAVE_ONLY
+		if (role == RPMSG_MASTER)
+			*len = RPMSG_BUFFER_SIZE;
+		else
+#endif /*!VIRTIO_SLAVE_ONLY*/
+			*len = virtqueue_get_buffer_length(rvdev->svq, *idx);
+		return r_desc;
+	}
+
 #ifndef VIRTIO_SLAVE_ONLY
 	if (role == RPMSG_MASTER) {
 		data = virtqueue_get_buffer(rvdev->svq, len, idx);
@@ -263,41 +291,35 @@ static int _rpmsg_virtio_get_buffer_size(struct rpmsg_virtio_device *rvdev)
 }
 
 /**
- * This function sends rpmsg "message" to remote device.
+ * rpmsg_virtio_get_tx_payload_buffer
  *
- * @param rdev    - pointer to rpmsg device
- * @param src     - source address of channel
- * @param dst     - destination address of channel
- * @param data    - data to transmit
- * @param size    - size of data
- * @param wait    - boolean, wait or not for buffer to become
- *                  available
+ * Provides a TX buffer whose payload area the caller fills in place. The
+ * vring buffer index is kept in the reserved field of the message header
+ * until the buffer is sent.
  *
- * @return - size of data sent or negative value for failure.
+ * @param rdev - pointer to rpmsg device
+ * @param len  - returns the size of the payload area
+ * @param wait - boolean, wait or not for buffer to become available
  *
+ * @return - pointer to the payload area or NULL if no buffer is available.
  */
-static int rpmsg_virtio_send_offchannel_raw(struct rpmsg_device *rdev,
-					    uint32_t src, uint32_t dst,
-					    const void *data,
-					    int size, int wait)
+static void *rpmsg_virtio_get_tx_payload_buffer(struct rpmsg_device *rdev,
+						uint32_t *len, int wait)
 {
 	struct rpmsg_virtio_device *rvdev;
-	struct rpmsg_hdr rp_hdr;
-	void *buffer = NULL;
-	uint16_t idx;
+	struct rpmsg_hdr *rp_hdr = NULL;
+	uint16_t idx = 0;
 	int tick_count;
 	uint32_t buff_len;
 	int status;
-	struct metal_io_region *io;
 
 	/* Get the associated remote device for channel. */
 	rvdev = metal_container_of(rdev, struct rpmsg_virtio_device, rdev);
 
 	status = rpmsg_virtio_get_status(rvdev);
 	/* Validate device state */
-	if (!(status & VIRTIO_CONFIG_STATUS_DRIVER_OK)) {
-		return RPMSG_ERR_DEV_STATE;
-	}
+	if (!(status & VIRTIO_CONFIG_STATUS_DRIVER_OK))
+		return NULL;
 
 	if (wait)
 		tick_count = RPMSG_TICK_COUNT / RPMSG_TICKS_PER_INTERVAL;
@@ -305,53 +327,249 @@ static int rpmsg_virtio_send_offchannel_raw(struct rpmsg_device *rdev,
 		tick_count = 0;
 
 	while (1) {
-		int avail_size;
-
 		/* Lock the device to enable exclusive access to virtqueues */
 		metal_mutex_acquire(&rdev->lock);
-		avail_size = _rpmsg_virtio_get_buffer_size(rvdev);
-		if (size <= avail_size)
-			buffer = rpmsg_virtio_get_tx_buffer(rvdev, &buff_len,
-							    &idx);
+		rp_hdr = rpmsg_virtio_get_tx_buffer(rvdev, &buff_len, &idx);
 		metal_mutex_release(&rdev->lock);
-		if (buffer || !tick_count)
+		if (rp_hdr || !tick_count)
 			break;
-		if (avail_size != 0)
-			return RPMSG_ERR_BUFF_SIZE;
 		metal_sleep_usec(RPMSG_TICKS_PER_INTERVAL);
 		tick_count--;
 	}
-	if (!buffer)
-		return RPMSG_ERR_NO_BUFF;
+	if (!rp_hdr)
+		return NULL;
+
+	/* Store the index to be used when the buffer is sent */
+	rp_hdr->reserved = idx;
+
+	*len = buff_len - sizeof(struct rpmsg_hdr);
+
+	return RPMSG_LOCATE_DATA(rp_hdr);
+}
+
+/**
+ * rpmsg_virtio_send_offchannel_nocopy
+ *
+ * Sends a payload buffer obtained from rpmsg_virtio_get_tx_payload_buffer
+ * to the remote device without copying the data.
+ *
+ * @param rdev - pointer to rpmsg device
+ * @param src  - source address of channel
+ * @param dst  - destination address of channel
+ * @param data - payload buffer to transmit
+ * @param len  - size of data
+ *
+ * @return - size of data sent or negative value for failure.
+ */
+static int rpmsg_virtio_send_offchannel_nocopy(struct rpmsg_device *rdev,
+					       uint32_t src, uint32_t dst,
+					       const void *data, int len)
+{
+	struct rpmsg_virtio_device *rvdev;
+	struct metal_io_region *io;
+	struct rpmsg_hdr rp_hdr;
+	struct rpmsg_hdr *hdr;
+	uint32_t buff_len;
+	uint16_t idx;
+	int status;
+
+	/* Get the associated remote device for channel. */
+	rvdev = metal_container_of(rdev, struct rpmsg_virtio_device, rdev);
+
+	hdr = RPMSG_LOCATE_HDR(data);
+	/* The reserved field contains the buffer index */
+	idx = (uint16_t)(hdr->reserved & RPMSG_BUF_IDX_MASK);
+
+#ifndef VIRTIO_SLAVE_ONLY
+	if (rpmsg_virtio_get_role(rvdev) == RPMSG_MASTER)
+		buff_len = RPMSG_BUFFER_SIZE;
+	else
+#endif /*!VIRTIO_SLAVE_ONLY*/
+		buff_len = virtqueue_get_buffer_length(rvdev->svq, idx);
+
+	/* Check against this buffer, the caller keeps it on failure */
+	if (len < 0 || (uint32_t)len > buff_len - sizeof(struct rpmsg_hdr))
+		return RPMSG_ERR_BUFF_SIZE;
 
 	/* Initialize RPMSG header. */
 	rp_hdr.dst = dst;
 	rp_hdr.src = src;
-	rp_hdr.len = size;
+	rp_hdr.len = len;
 	rp_hdr.reserved = 0;
+	rp_hdr.flags = 0;
 
-	/* Copy data to rpmsg buffer. */
+	/* Write the header to the rpmsg buffer. */
 	io = rvdev->shbuf_io;
-	status = metal_io_block_write(io, metal_io_virt_to_offset(io, buffer),
+	status = metal_io_block_write(io, metal_io_virt_to_offset(io, hdr),
 				      &rp_hdr, sizeof(rp_hdr));
 	RPMSG_ASSERT(status == sizeof(rp_hdr), "failed to write header\r\n");
 
-	status = metal_io_block_write(io,
-				      metal_io_virt_to_offset(io,
-				      RPMSG_LOCATE_DATA(buffer)),
-				      data, size);
-	RPMSG_ASSERT(status == size, "failed to write buffer\r\n");
 	metal_mutex_acquire(&rdev->lock);
 
 	/* Enqueue buffer on virtqueue. */
-	status = rpmsg_virtio_enqueue_buffer(rvdev, buffer, buff_len, idx);
+	status = rpmsg_virtio_enqueue_buffer(rvdev, hdr, buff_len, idx);
 	RPMSG_ASSERT(status == VQUEUE_SUCCESS, "failed to enqueue buffer\r\n");
 	/* Let the other side know that there is a job to process. */
 	virtqueue_kick(rvdev->svq);
 
 	metal_mutex_release(&rdev->lock);
 
-	return size;
+	return len;
+}
+
+/**
+ * rpmsg_virtio_release_tx_buffer
+ *
+ * Gives back a TX buffer obtained with rpmsg_virtio_get_tx_payload_buffer
+ * that is not going to be sent.
+ *
+ * @param rdev  - pointer to rpmsg device
+ * @param txbuf - payload buffer to release
+ *
+ * @return - RPMSG_SUCCESS
+ */
+static int rpmsg_virtio_release_tx_buffer(struct rpmsg_device *rdev,
+					  void *txbuf)
+{
+	struct rpmsg_virtio_device *rvdev;
+	struct vbuff_reclaimer_t *r_desc;
+	struct rpmsg_hdr *rp_hdr;
+	uint32_t idx;
+	void *vbuff;
+
+	rvdev = metal_container_of(rdev, struct rpmsg_virtio_device, rdev);
+	rp_hdr = RPMSG_LOCATE_HDR(txbuf);
+	/* Read the index before the header is overwritten by the node */
+	idx = rp_hdr->reserved & RPMSG_BUF_IDX_MASK;
+	/* Buffers are at least pointer aligned, unlike the packed header */
+	vbuff = rp_hdr;
+	r_desc = vbuff;
+
+	metal_mutex_acquire(&rdev->lock);
+	r_desc->idx = idx;
+	metal_list_add_tail(&rvdev->reclaimer, &r_desc->node);
+	metal_mutex_release(&rdev->lock);
+
+	return RPMSG_SUCCESS;
+}
+
+/**
+ * This function sends rpmsg "message" to remote device.
+ *
+ * @param rdev    - pointer to rpmsg device
+ * @param src     - source address of channel
+ * @param dst     - destination address of channel
+ * @param data    - data to transmit
+ * @param size    - size of data
+ * @param wait    - boolean, wait or not for buffer to become
+ *                  available
+ *
+ * @return - size of data sent or negative value for failure.
+ *
+ */
+static int rpmsg_virtio_send_offchannel_raw(struct rpmsg_device *rdev,
+					    uint32_t src, uint32_t dst,
+					    const void *data,
+					    int size, int wait)
+{
+	struct rpmsg_virtio_device *rvdev;
+	struct metal_io_region *io;
+	uint32_t buff_len;
+	void *buffer;
+	int avail_size;
+	int status;
+
+	/* Get the associated remote device for channel. */
+	rvdev = metal_container_of(rdev, struct rpmsg_virtio_device, rdev);
+
+	status = rpmsg_virtio_get_status(rvdev);
+	/* Validate device state */
+	if (!(status & VIRTIO_CONFIG_STATUS_DRIVER_OK)) {
+		return RPMSG_ERR_DEV_STATE;
+	}
+
+	metal_mutex_acquire(&rdev->lock);
+	avail_size = _rpmsg_virtio_get_buffer_size(rvdev);
+	metal_mutex_release(&rdev->lock);
+	if (size > avail_size)
+		return avail_size ? RPMSG_ERR_BUFF_SIZE : RPMSG_ERR_NO_BUFF;
+
+	buffer = rpmsg_virtio_get_tx_payload_buffer(rdev, &buff_len, wait);
+	if (!buffer)
+		return RPMSG_ERR_NO_BUFF;
+
+	/* The buffer obtained can be smaller than the one sized above */
+	if ((uint32_t)size > buff_len) {
+		rpmsg_virtio_release_tx_buffer(rdev, buffer);
+		return RPMSG_ERR_BUFF_SIZE;
+	}
+
+	/* Copy data to rpmsg buffer. */
+	io = rvdev->shbuf_io;
+	status = metal_io_block_write(io, metal_io_virt_to_offset(io, buffer),
+				      data, size);
+	RPMSG_ASSERT(status == size, "failed to write buffer\r\n");
+
+	return rpmsg_virtio_send_offchannel_nocopy(rdev, src, dst, buffer,
+						   size);
+}
+
+/**
+ * rpmsg_virtio_hold_rx_buffer
+ *
+ * Marks a received buffer as held so that it is not returned to the
+ * virtqueue when the endpoint callback returns.
+ *
+ * @param rdev  - pointer to rpmsg device
+ * @param rxbuf - pointer to the received payload
+ */
+static void rpmsg_virtio_hold_rx_buffer(struct rpmsg_device *rdev,
+					void *rxbuf)
+{
+	struct rpmsg_hdr *rp_hdr;
+
+	(void)rdev;
+
+	rp_hdr = RPMSG_LOCATE_HDR(rxbuf);
+	/* Set held status to keep buffer */
+	rp_hdr->reserved |= RPMSG_BUF_HELD;
+}
+
+/**
+ * rpmsg_virtio_release_rx_buffer
+ *
+ * Returns a held receive buffer to the virtqueue.
+ *
+ * @param rdev  - pointer to rpmsg device
+ * @param rxbuf - pointer to the received payload
+ */
+static void rpmsg_virtio_release_rx_buffer(struct rpmsg_device *rdev,
+					   void *rxbuf)
+{
+	struct rpmsg_virtio_device *rvdev;
+	struct rpmsg_hdr *rp_hdr;
+	uint32_t len;
+	uint16_t idx;
+
+	rvdev = metal_container_of(rdev, struct rpmsg_virtio_device, rdev);
+	rp_hdr = RPMSG_LOCATE_HDR(rxbuf);
+	/* The reserved field contains the buffer index */
+	idx = (uint16_t)(rp_hdr->reserved & RPMSG_BUF_IDX_MASK);
+
+	metal_mutex_acquire(&rdev->lock);
+
+#ifndef VIRTIO_SLAVE_ONLY
+	if (rpmsg_virtio_get_role(rvdev) == RPMSG_MASTER)
+		len = RPMSG_BUFFER_SIZE;
+	else
+#endif /*!VIRTIO_SLAVE_ONLY*/
+		len = virtqueue_get_buffer_length(rvdev->rvq, idx);
+
+	/* Return the buffer and tell peer we return some rx buffer */
+	rpmsg_virtio_return_buffer(rvdev, rp_hdr, len, idx);
+	virtqueue_kick(rvdev->rvq);
+
+	metal_mutex_release(&rdev->lock);
 }
 
 /**
@@ -408,6 +626,8 @@ static void rpmsg_virtio_rx_callback(struct virtqueue *vq)
 				 */
 				ept->dest_addr = rp_hdr->src;
 			}
+			/* Keep the buffer index in case the buffer is held */
+			rp_hdr->reserved = idx;
 			status = ept->cb(ept, RPMSG_LOCATE_DATA(rp_hdr),
 					 rp_hdr->len, rp_hdr->src, ept->priv);
 
@@ -417,8 +637,9 @@ static void rpmsg_virtio_rx_callback(struct virtqueue *vq)
 
 		metal_mutex_acquire(&rdev->lock);
 
-		/* Return used buffers. */
-		rpmsg_virtio_return_buffer(rvdev, rp_hdr, len, idx);
+		/* Return used buffers unless the callback held them. */
+		if (!ept || !(rp_hdr->reserved & RPMSG_BUF_HELD))
+			rpmsg_virtio_return_buffer(rvdev, rp_hdr, len, idx);
 
 		rp_hdr = rpmsg_virtio_get_rx_buffer(rvdev, &len, &idx);
 		if (rp_hdr == NULL) {
@@ -529,6 +750,12 @@ int rpmsg_init_vdev(struct rpmsg_virtio_device *rvdev,
 	rdev->ns_bind_cb = ns_bind_cb;
 	vdev->priv = rvdev;
 	rdev->ops.send_offchannel_raw = rpmsg_virtio_send_offchannel_raw;
+	rdev->ops.hold_rx_buffer = rpmsg_virtio_hold_rx_buffer;
+	rdev->ops.release_rx_buffer = rpmsg_virtio_release_rx_buffer;
+	rdev->ops.get_tx_payload_buffer = rpmsg_virtio_get_tx_payload_buffer;
+	rdev->ops.send_offchannel_nocopy = rpmsg_virtio_send_offchannel_nocopy;
+	rdev->ops.release_tx_buffer = rpmsg_virtio_release_tx_buffer;
+	metal_list_init(&rvdev->reclaimer);
 	role = rpmsg_virtio_get_role(rvdev);
 
 #ifndef VIRTIO_MASTER_ONLY
@@ -628,7 +855,7 @@ int rpmsg_init_vdev(struct rpmsg_virtio_device *rvdev,
 #endif /*!VIRTIO_SLAVE_ONLY*/
 
 	/* Initialize channels and endpoints list */
-	metal_list_init(&rdev->endpoints);
+	rpmsg_init_endpoints(rdev);
 
 	/*
 	 * Create name service announcement endpoint if device supports name
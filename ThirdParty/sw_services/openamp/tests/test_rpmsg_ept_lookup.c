@@ -0,0 +1,267 @@
+/*
+ * Copyright (c) 2020, Xilinx Inc. and Contributors. All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+/*
+ * @file	test_rpmsg_ept_lookup.c
+ * @brief	Host test and microbenchmark of the rpmsg endpoint lookup.
+ *
+ * Endpoints are registered on a bare rpmsg device, with addresses spread
+ * over the address bitmap, endpoints without a local address and service
+ * names sharing hash buckets. rpmsg_get_endpoint() is compared with the
+ * list walk it replaced over every combination of name, local address and
+ * remote address in use, after creating and destroying endpoints and with
+ * two endpoints on one address. Both are then timed, with all endpoints
+ * created through the API, on the per-message lookup by local address and
+ * on the name service lookup.
+ *
+ * Build and run on the host, against a generic libmetal configured as in
+ * test_rpmsg_nocopy.c:
+ *   cc -Wall -O2 -I../src/open-amp/lib/include -Imetal/lib/include \
+ *      test_rpmsg_ept_lookup.c metal/lib/libmetal.a -o test_rpmsg_ept_lookup
+ *   ./test_rpmsg_ept_lookup
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+
+#include "../src/open-amp/lib/rpmsg/rpmsg.c"
+
+#include <metal/sys.h>
+
+#define NUM_EPTS	100
+#define NUM_UNBOUND	8
+#define BENCH_LOOKUPS	2000000
+
+#define CHECK(cond, msg) \
+	do { \
+		if (!(cond)) { \
+			printf("FAIL: %s (line %d)\n", msg, __LINE__); \
+			failures++; \
+		} \
+	} while (0)
+
+static unsigned int failures;
+
+static struct rpmsg_device rdev;
+static struct rpmsg_endpoint epts[NUM_EPTS];
+static struct rpmsg_endpoint unbound[NUM_UNBOUND];
+static struct rpmsg_endpoint dup;
+static char names[NUM_EPTS][RPMSG_NAME_SIZE];
+
+static int ept_cb(struct rpmsg_endpoint *ept, void *data, size_t len,
+		  uint32_t src, void *priv)
+{
+	(void)ept;
+	(void)data;
+	(void)len;
+	(void)src;
+	(void)priv;
+	return RPMSG_SUCCESS;
+}
+
+/* The endpoint list walk used before the endpoints were indexed */
+static struct rpmsg_endpoint *ref_get_endpoint(struct rpmsg_device *rdev,
+					       const char *name, uint32_t addr,
+					       uint32_t dest_addr)
+{
+	struct metal_list *node;
+	struct rpmsg_endpoint *ept;
+
+	metal_list_for_each(&rdev->endpoints, node) {
+		int name_match = 0;
+
+		ept = metal_container_of(node, struct rpmsg_endpoint, node);
+		if (addr != RPMSG_ADDR_ANY && ept->addr == addr)
+			return ept;
+		if (addr == ept->addr && dest_addr == ept->dest_addr)
+			return ept;
+		if (name)
+			name_match = !strncmp(ept->name, name,
+					      sizeof(ept->name));
+		if (!name || !name_match)
+			continue;
+		if (dest_addr != RPMSG_ADDR_ANY && ept->dest_addr == dest_addr)
+			return ept;
+		if (addr == RPMSG_ADDR_ANY && ept->dest_addr == RPMSG_ADDR_ANY)
+			return ept;
+	}
+	return NULL;
+}
+
+static void setup(void)
+{
+	unsigned int i;
+	uint32_t dest;
+	int ret;
+
+	memset(&rdev, 0, sizeof(rdev));
+	metal_mutex_init(&rdev.lock);
+	rpmsg_init_endpoints(&rdev);
+
+	for (i = 0; i < NUM_EPTS; i++) {
+		/* Shared names, and buckets holding several names */
+		snprintf(names[i], sizeof(names[i]), "rpmsg-svc-%u", i % 40);
+		/* Every third endpoint is not bound to a remote one yet */
+		dest = (i % 3) ? 0x400 + i : RPMSG_ADDR_ANY;
+		ret = rpmsg_create_ept(&epts[i], &rdev, names[i],
+				       RPMSG_ADDR_ANY, dest, ept_cb, NULL);
+		CHECK(ret == RPMSG_SUCCESS, "create endpoint");
+	}
+
+	/* Endpoints registered without a local address are only listed */
+	for (i = 0; i < NUM_UNBOUND; i++) {
+		rpmsg_init_ept(&unbound[i], names[i], RPMSG_ADDR_ANY,
+			       0x800 + i, ept_cb, NULL);
+		rpmsg_register_endpoint(&rdev, &unbound[i]);
+	}
+}
+
+static void check_all(const char *phase)
+{
+	static const char *extra[] = { NULL, "rpmsg-svc-none", "NS" };
+	const char *name;
+	uint32_t addr, dest;
+	unsigned int i, j, k;
+	unsigned int mismatches = 0;
+	unsigned int queries = 0;
+	char msg[64];
+
+	for (i = 0; i < NUM_EPTS + 3; i++) {
+		name = i < NUM_EPTS ? names[i] : extra[i - NUM_EPTS];
+		for (j = 0; j <= RPMSG_ADDR_BMP_SIZE + 1; j++) {
+			addr = j < RPMSG_ADDR_BMP_SIZE ? j :
+			       (j == RPMSG_ADDR_BMP_SIZE ? RPMSG_ADDR_ANY : 500);
+			for (k = 0; k < 4; k++) {
+				dest = k == 0 ? RPMSG_ADDR_ANY :
+				       k == 1 ? 0x400 + (i % NUM_EPTS) :
+				       k == 2 ? 0x800 + (i % NUM_UNBOUND) :
+				       0x1234;
+				queries++;
+				if (rpmsg_get_endpoint(&rdev, name, addr, dest)
+				    != ref_get_endpoint(&rdev, name, addr, dest))
+					mismatches++;
+			}
+		}
+	}
+	snprintf(msg, sizeof(msg), "%s: %u of %u lookups differ", phase,
+		 mismatches, queries);
+	CHECK(mismatches == 0, msg);
+}
+
+static void test_churn(void)
+{
+	unsigned int i;
+	int ret;
+
+	/* Destroy every fourth endpoint, then recreate them on new names */
+	for (i = 0; i < NUM_EPTS; i += 4)
+		rpmsg_destroy_ept(&epts[i]);
+	check_all("after destroy");
+	for (i = 0; i < NUM_EPTS; i += 4) {
+		snprintf(names[i], sizeof(names[i]), "rpmsg-new-%u", i);
+		ret = rpmsg_create_ept(&epts[i], &rdev, names[i],
+				       RPMSG_ADDR_ANY, RPMSG_ADDR_ANY, ept_cb,
+				       NULL);
+		CHECK(ret == RPMSG_SUCCESS, "recreate endpoint");
+	}
+	check_all("after recreate");
+	CHECK(rpmsg_get_endpoint(&rdev, NULL, epts[8].addr, RPMSG_ADDR_ANY)
+	      == &epts[8], "recreated endpoint by address");
+
+	/* A second endpoint registered on an address in use takes over */
+	rpmsg_init_ept(&dup, "rpmsg-dup", epts[5].addr, RPMSG_ADDR_ANY,
+		       ept_cb, NULL);
+	rpmsg_register_endpoint(&rdev, &dup);
+	check_all("with duplicate address");
+	rpmsg_unregister_endpoint(&epts[5]);
+	CHECK(rpmsg_get_endpoint(&rdev, NULL, dup.addr, RPMSG_ADDR_ANY)
+	      == &dup, "address table refilled");
+	check_all("after duplicate takes over");
+	rpmsg_unregister_endpoint(&dup);
+	rpmsg_set_address(rdev.bitmap, RPMSG_ADDR_BMP_SIZE, epts[5].addr);
+	rpmsg_register_endpoint(&rdev, &epts[5]);
+
+	/* Endpoints created by the API always have a local address */
+	for (i = 0; i < NUM_UNBOUND; i++)
+		rpmsg_unregister_endpoint(&unbound[i]);
+	CHECK(rdev.ept_any_count == 0, "endpoints without address counted");
+	check_all("all addressed");
+}
+
+static double now_ns(void)
+{
+	struct timespec ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return ts.tv_sec * 1e9 + ts.tv_nsec;
+}
+
+typedef struct rpmsg_endpoint *(*lookup_fn)(struct rpmsg_device *,
+					    const char *, uint32_t, uint32_t);
+
+/* Lookups by local address, as done for every received message */
+static double bench_addr(lookup_fn fn, unsigned long *sum)
+{
+	double t0 = now_ns();
+	struct rpmsg_endpoint *ept;
+	unsigned int i;
+
+	for (i = 0; i < BENCH_LOOKUPS; i++) {
+		ept = fn(&rdev, NULL, epts[(i * 37U) % NUM_EPTS].addr,
+			 RPMSG_ADDR_ANY);
+		*sum += ept ? ept->addr : 0;
+	}
+	return (now_ns() - t0) / BENCH_LOOKUPS;
+}
+
+/* Name service lookups of unbound endpoints */
+static double bench_name(lookup_fn fn, unsigned long *sum)
+{
+	double t0 = now_ns();
+	struct rpmsg_endpoint *ept;
+	unsigned int i;
+
+	for (i = 0; i < BENCH_LOOKUPS / 4; i++) {
+		ept = fn(&rdev, names[(i * 7U) % NUM_EPTS], RPMSG_ADDR_ANY,
+			 RPMSG_ADDR_ANY);
+		*sum += ept ? ept->addr : 0;
+	}
+	return (now_ns() - t0) / (BENCH_LOOKUPS / 4);
+}
+
+static void bench(void)
+{
+	unsigned long sum_idx = 0, sum_ref = 0;
+	double addr_idx, addr_ref, name_idx, name_ref;
+
+	addr_ref = bench_addr(ref_get_endpoint, &sum_ref);
+	addr_idx = bench_addr(rpmsg_get_endpoint, &sum_idx);
+	name_ref = bench_name(ref_get_endpoint, &sum_ref);
+	name_idx = bench_name(rpmsg_get_endpoint, &sum_idx);
+	CHECK(sum_idx == sum_ref, "benchmark lookups differ");
+
+	printf("%u endpoints: by address %.1f ns list walk, %.1f ns indexed; "
+	       "by name %.1f ns list walk, %.1f ns indexed\n",
+	       NUM_EPTS, addr_ref, addr_idx, name_ref, name_idx);
+	/* The indexed lookups skip a walk of ~50 endpoints */
+	CHECK(addr_idx * 2 < addr_ref, "indexed address lookup not faster");
+	CHECK(name_idx * 2 < name_ref, "indexed name lookup not faster");
+}
+
+int main(void)
+{
+	struct metal_init_params params = METAL_INIT_DEFAULTS;
+
+	metal_init(&params);
+	setup();
+	check_all("initial");
+	test_churn();
+	bench();
+
+	printf("%s (%u failures)\n", failures ? "FAILED" : "PASSED", failures);
+	return failures ? 1 : 0;
+}
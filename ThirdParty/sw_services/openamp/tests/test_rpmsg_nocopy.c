@@ -0,0 +1,371 @@
+/*
+ * Copyright (c) 2020, Xilinx Inc. and Contributors. All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+/*
+ * @file	test_rpmsg_nocopy.c
+ * @brief	Host test and benchmark of the zero-copy rpmsg TX path.
+ *
+ * A master and a remote rpmsg virtio device share two vrings and a buffer
+ * pool in host memory. Kicks are latched and delivered by Pump(), in place
+ * of the IPI. The test checks that a payload buffer reaches the peer
+ * without being copied, that unsent TX buffers given back with
+ * rpmsg_release_tx_buffer() are handed out again on both sides, including
+ * after a rejected rpmsg_send_nocopy(), and compares the throughput of
+ * rpmsg_send() against get-payload/fill/rpmsg_send_nocopy().
+ *
+ * Build and run on the host, against a generic libmetal:
+ *   cmake -S ../../libmetal/src/libmetal -B metal -DWITH_DOC=OFF \
+ *         -DCMAKE_SYSTEM_NAME=Generic -DCMAKE_SYSTEM_PROCESSOR=x86_64 \
+ *         -DMACHINE=template
+ *   cmake --build metal
+ *   cc -Wall -O2 -I../src/open-amp/lib/include -Imetal/lib/include \
+ *      test_rpmsg_nocopy.c metal/lib/libmetal.a -o test_rpmsg_nocopy
+ *   ./test_rpmsg_nocopy
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+
+#include "../src/open-amp/lib/rpmsg/rpmsg.c"
+#include "../src/open-amp/lib/rpmsg/rpmsg_virtio.c"
+#include "../src/open-amp/lib/virtio/virtio.c"
+#include "../src/open-amp/lib/virtio/virtqueue.c"
+
+#include <metal/sys.h>
+
+#define NUM_DESCS	16
+#define VRING_ALIGN	4096
+#define VRING_BYTES	0x2000
+#define POOL_BYTES	(2 * NUM_DESCS * RPMSG_BUFFER_SIZE)
+#define SHM_BYTES	(2 * VRING_BYTES + POOL_BYTES)
+#define MASTER_ADDR	0x20
+#define REMOTE_ADDR	0x21
+#define BENCH_MSGS	200000
+
+#define CHECK(cond, msg) \
+	do { \
+		if (!(cond)) { \
+			printf("FAIL: %s (line %d)\n", msg, __LINE__); \
+			failures++; \
+		} \
+	} while (0)
+
+static unsigned int failures;
+
+/* Shared memory: vring 0, vring 1, then the master buffer pool */
+static unsigned char shm[SHM_BYTES] __attribute__((aligned(VRING_ALIGN)));
+static metal_phys_addr_t shm_phys;
+static struct metal_io_region shm_io;
+
+struct side {
+	struct virtio_device vdev;
+	struct virtio_vring_info vrings[2];
+	struct rpmsg_virtio_device rvdev;
+	struct rpmsg_endpoint ept;
+	int kicked[2];
+	const void *last_data;
+	int last_len;
+	unsigned int rx_count;
+};
+
+static struct side master, remote;
+static struct rpmsg_virtio_shm_pool shpool;
+static uint8_t vdev_status;
+
+static struct side *side_of(struct virtio_device *vdev)
+{
+	return vdev == &master.vdev ? &master : &remote;
+}
+
+static uint8_t sim_get_status(struct virtio_device *vdev)
+{
+	(void)vdev;
+	return vdev_status;
+}
+
+static void sim_set_status(struct virtio_device *vdev, uint8_t status)
+{
+	(void)vdev;
+	vdev_status = status;
+}
+
+static uint32_t sim_get_features(struct virtio_device *vdev)
+{
+	(void)vdev;
+	/* No name service, endpoints are bound by address */
+	return 0;
+}
+
+/* Latch the kick for the peer, delivered later by Pump() */
+static void sim_notify(struct virtqueue *vq)
+{
+	struct side *peer = side_of(vq->vq_dev) == &master ? &remote : &master;
+
+	peer->kicked[vq->vq_queue_index] = 1;
+}
+
+static const struct virtio_dispatch sim_dispatch = {
+	.get_status = sim_get_status,
+	.set_status = sim_set_status,
+	.get_features = sim_get_features,
+	.notify = sim_notify,
+};
+
+static void pump(void)
+{
+	int busy = 1;
+	int i;
+
+	while (busy) {
+		busy = 0;
+		for (i = 0; i < 2; i++) {
+			if (master.kicked[i]) {
+				master.kicked[i] = 0;
+				virtqueue_notification(master.vrings[i].vq);
+				busy = 1;
+			}
+			if (remote.kicked[i]) {
+				remote.kicked[i] = 0;
+				virtqueue_notification(remote.vrings[i].vq);
+				busy = 1;
+			}
+		}
+	}
+}
+
+static int ept_cb(struct rpmsg_endpoint *ept, void *data, size_t len,
+		  uint32_t src, void *priv)
+{
+	struct side *s = priv;
+
+	(void)ept;
+	(void)src;
+	s->last_data = data;
+	s->last_len = (int)len;
+	s->rx_count++;
+	return RPMSG_SUCCESS;
+}
+
+static void init_side(struct side *s, unsigned int role)
+{
+	int i;
+
+	memset(s, 0, sizeof(*s));
+	s->vdev.role = role;
+	s->vdev.func = &sim_dispatch;
+	s->vdev.vrings_num = 2;
+	s->vdev.vrings_info = s->vrings;
+	for (i = 0; i < 2; i++) {
+		s->vrings[i].vq = virtqueue_allocate(NUM_DESCS);
+		s->vrings[i].info.vaddr = shm + i * VRING_BYTES;
+		s->vrings[i].info.align = VRING_ALIGN;
+		s->vrings[i].info.num_descs = NUM_DESCS;
+		s->vrings[i].io = &shm_io;
+	}
+}
+
+static void setup(void)
+{
+	struct metal_init_params params = METAL_INIT_DEFAULTS;
+	int ret;
+
+	metal_init(&params);
+	shm_phys = (metal_phys_addr_t)(uintptr_t)shm;
+	metal_io_init(&shm_io, shm, &shm_phys, sizeof(shm), -1, 0, NULL);
+	rpmsg_virtio_init_shm_pool(&shpool, shm + 2 * VRING_BYTES, POOL_BYTES);
+
+	init_side(&master, RPMSG_MASTER);
+	init_side(&remote, RPMSG_REMOTE);
+
+	ret = rpmsg_init_vdev(&master.rvdev, &master.vdev, NULL, &shm_io,
+			      &shpool);
+	CHECK(ret == RPMSG_SUCCESS, "master init");
+	ret = rpmsg_init_vdev(&remote.rvdev, &remote.vdev, NULL, &shm_io, NULL);
+	CHECK(ret == RPMSG_SUCCESS, "remote init");
+
+	ret = rpmsg_create_ept(&master.ept, &master.rvdev.rdev, "bench",
+			       MASTER_ADDR, REMOTE_ADDR, ept_cb, NULL);
+	CHECK(ret == RPMSG_SUCCESS, "master endpoint");
+	master.ept.priv = &master;
+	ret = rpmsg_create_ept(&remote.ept, &remote.rvdev.rdev, "bench",
+			       REMOTE_ADDR, MASTER_ADDR, ept_cb, NULL);
+	CHECK(ret == RPMSG_SUCCESS, "remote endpoint");
+	remote.ept.priv = &remote;
+}
+
+static void test_zero_copy(void)
+{
+	uint32_t len = 0;
+	char *buf;
+	int ret;
+
+	buf = rpmsg_get_tx_payload_buffer(&master.ept, &len, 0);
+	CHECK(buf != NULL, "get master payload buffer");
+	if (!buf)
+		return;
+	CHECK(len == RPMSG_BUFFER_SIZE - sizeof(struct rpmsg_hdr),
+	      "payload size");
+	strcpy(buf, "in place");
+	ret = rpmsg_send_nocopy(&master.ept, buf, 9);
+	CHECK(ret == 9, "send nocopy");
+	pump();
+	CHECK(remote.rx_count == 1, "remote received");
+	CHECK(remote.last_data == buf, "remote sees the sender's buffer");
+	CHECK(remote.last_len == 9 && !strcmp(remote.last_data, "in place"),
+	      "payload");
+
+	/* And back, on a buffer provided by the master */
+	buf = rpmsg_get_tx_payload_buffer(&remote.ept, &len, 0);
+	CHECK(buf != NULL, "get remote payload buffer");
+	if (!buf)
+		return;
+	strcpy(buf, "reply");
+	ret = rpmsg_send_nocopy(&remote.ept, buf, 6);
+	CHECK(ret == 6, "remote send nocopy");
+	pump();
+	CHECK(master.rx_count == 1 && master.last_data == buf,
+	      "master sees the remote's buffer");
+}
+
+/*
+ * Obtain every TX buffer the side can get without sending, give them all
+ * back and check that the same buffers are handed out again.
+ */
+static void test_release_side(struct side *s, const char *name)
+{
+	void *bufs[2 * NUM_DESCS];
+	void *again;
+	uint32_t len;
+	unsigned int n = 0;
+	unsigned int i;
+	char msg[64];
+	int ret;
+
+	while (n < 2 * NUM_DESCS) {
+		bufs[n] = rpmsg_get_tx_payload_buffer(&s->ept, &len, 0);
+		if (!bufs[n])
+			break;
+		n++;
+	}
+	snprintf(msg, sizeof(msg), "%s: TX buffers available", name);
+	CHECK(n > 0, msg);
+	snprintf(msg, sizeof(msg), "%s: TX buffers exhausted", name);
+	CHECK(rpmsg_get_tx_payload_buffer(&s->ept, &len, 0) == NULL, msg);
+
+	/* An oversized send is rejected and leaves the buffer owned */
+	ret = rpmsg_send_nocopy(&s->ept, bufs[0], RPMSG_BUFFER_SIZE);
+	snprintf(msg, sizeof(msg), "%s: oversized send rejected", name);
+	CHECK(ret == RPMSG_ERR_BUFF_SIZE, msg);
+
+	for (i = 0; i < n; i++) {
+		ret = rpmsg_release_tx_buffer(&s->ept, bufs[i]);
+		snprintf(msg, sizeof(msg), "%s: release", name);
+		CHECK(ret == RPMSG_SUCCESS, msg);
+	}
+	for (i = 0; i < n; i++) {
+		again = rpmsg_get_tx_payload_buffer(&s->ept, &len, 0);
+		snprintf(msg, sizeof(msg), "%s: released buffer reused", name);
+		CHECK(again == bufs[i], msg);
+	}
+
+	/* The reused buffers can still be sent */
+	remote.rx_count = master.rx_count = 0;
+	for (i = 0; i < n; i++) {
+		((char *)bufs[i])[0] = (char)i;
+		ret = rpmsg_send_nocopy(&s->ept, bufs[i], 1);
+		snprintf(msg, sizeof(msg), "%s: send reused buffer", name);
+		CHECK(ret == 1, msg);
+	}
+	pump();
+	snprintf(msg, sizeof(msg), "%s: all reused buffers delivered", name);
+	CHECK((s == &master ? remote.rx_count : master.rx_count) == n, msg);
+
+	/* Nothing leaked: as many buffers are available as before */
+	for (i = 0; i < n; i++) {
+		bufs[i] = rpmsg_get_tx_payload_buffer(&s->ept, &len, 0);
+		snprintf(msg, sizeof(msg), "%s: buffers back after send", name);
+		CHECK(bufs[i] != NULL, msg);
+	}
+	for (i = 0; i < n; i++)
+		rpmsg_release_tx_buffer(&s->ept, bufs[i]);
+}
+
+static void test_release_param(void)
+{
+	CHECK(rpmsg_release_tx_buffer(NULL, shm) == RPMSG_ERR_PARAM,
+	      "NULL endpoint");
+	CHECK(rpmsg_release_tx_buffer(&master.ept, NULL) == RPMSG_ERR_PARAM,
+	      "NULL buffer");
+}
+
+static double now_ns(void)
+{
+	struct timespec ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return ts.tv_sec * 1e9 + ts.tv_nsec;
+}
+
+/* The application produces its message, either in place or in a local one */
+static void produce(unsigned char *dst, int len, unsigned int seq)
+{
+	int i;
+
+	for (i = 0; i < len; i++)
+		dst[i] = (unsigned char)(seq + i);
+}
+
+static void bench(void)
+{
+	static unsigned char local[RPMSG_BUFFER_SIZE];
+	int len = RPMSG_BUFFER_SIZE - sizeof(struct rpmsg_hdr);
+	double t0, copy_ns, nocopy_ns;
+	unsigned char *buf;
+	uint32_t avail;
+	unsigned int i;
+
+	remote.rx_count = 0;
+	t0 = now_ns();
+	for (i = 0; i < BENCH_MSGS; i++) {
+		produce(local, len, i);
+		rpmsg_send(&master.ept, local, len);
+		pump();
+	}
+	copy_ns = now_ns() - t0;
+	CHECK(remote.rx_count == BENCH_MSGS, "copy path delivered");
+
+	remote.rx_count = 0;
+	t0 = now_ns();
+	for (i = 0; i < BENCH_MSGS; i++) {
+		buf = rpmsg_get_tx_payload_buffer(&master.ept, &avail, 1);
+		if (!buf)
+			break;
+		produce(buf, len, i);
+		rpmsg_send_nocopy(&master.ept, buf, len);
+		pump();
+	}
+	nocopy_ns = now_ns() - t0;
+	CHECK(remote.rx_count == BENCH_MSGS, "nocopy path delivered");
+
+	printf("%d byte messages: rpmsg_send %.0f ns/msg (%.1f MB/s), "
+	       "rpmsg_send_nocopy %.0f ns/msg (%.1f MB/s)\n", len,
+	       copy_ns / BENCH_MSGS, len * 1e3 * BENCH_MSGS / copy_ns,
+	       nocopy_ns / BENCH_MSGS, len * 1e3 * BENCH_MSGS / nocopy_ns);
+}
+
+int main(void)
+{
+	setup();
+	test_zero_copy();
+	test_release_param();
+	test_release_side(&master, "master");
+	test_release_side(&remote, "remote");
+	bench();
+
+	printf("%s (%u failures)\n", failures ? "FAILED" : "PASSED", failures);
+	return failures ? 1 : 0;
+}
@@ -142,6 +142,13 @@
     }
 
 /************************** Function Prototypes ******************************/
+static int XAxiDma_BdRingCommit(XAxiDma_BdRing * RingPtr, int NumBd,
+		XAxiDma_Bd * BdSetPtr, int Burst);
+static int XAxiDma_BdRingReap(XAxiDma_BdRing * RingPtr, int BdLimit,
+		XAxiDma_Bd ** BdSetPtr, int Burst);
+static void XAxiDma_BdRingSpanCache(XAxiDma_BdRing * RingPtr,
+		XAxiDma_Bd * BdPtr, int NumBd, int Flush);
+static int XAxiDma_BdRingPktBdCount(XAxiDma_BdRing * RingPtr);
 
 /************************** Variable Definitions *****************************/
 
@@ -997,6 +1004,56 @@ int XAxiDma_BdRingUnAlloc(XAxiDma_BdRing * RingPtr, int NumBd,
  *****************************************************************************/
 int XAxiDma_BdRingToHw(XAxiDma_BdRing * RingPtr, int NumBd,
 	XAxiDma_Bd * BdSetPtr)
+{
+	return XAxiDma_BdRingCommit(RingPtr, NumBd, BdSetPtr, 0);
+}
+
+/*****************************************************************************/
+/**
+ * Enqueue a set of BDs to hardware like XAxiDma_BdRingToHw(), but write the
+ * whole set back from the data cache with one range operation instead of one
+ * per BD. A set that wraps around the end of the ring takes two range
+ * operations. This is intended for committing many small BDs at once.
+ *
+ * @param	RingPtr is a pointer to the descriptor ring instance to be
+ *		worked on.
+ * @param	NumBd is the number of BDs in the set.
+ * @param	BdSetPtr is the first BD of the set to commit to hardware.
+ *
+ * @return	Same as XAxiDma_BdRingToHw().
+ *
+ * @note	This function should not be preempted by another XAxiDma ring
+ *		function call that modifies the BD space. It is the caller's
+ *		responsibility to provide a mutual exclusion mechanism.
+ *
+ *		This function can be used only when DMA is in SG mode
+ *
+ *****************************************************************************/
+int XAxiDma_BdRingToHwBurst(XAxiDma_BdRing * RingPtr, int NumBd,
+	XAxiDma_Bd * BdSetPtr)
+{
+	return XAxiDma_BdRingCommit(RingPtr, NumBd, BdSetPtr, 1);
+}
+
+/*****************************************************************************/
+/**
+ * Common implementation of XAxiDma_BdRingToHw() and
+ * XAxiDma_BdRingToHwBurst().
+ *
+ * @param	RingPtr is a pointer to the descriptor ring instance to be
+ *		worked on.
+ * @param	NumBd is the number of BDs in the set.
+ * @param	BdSetPtr is the first BD of the set to commit to hardware.
+ * @param	Burst selects one cache flush for the whole set when non-zero,
+ *		or one per BD when zero.
+ *
+ * @return	See XAxiDma_BdRingToHw().
+ *
+ * @note	None.
+ *
+ *****************************************************************************/
+static int XAxiDma_BdRingCommit(XAxiDma_BdRing * RingPtr, int NumBd,
+	XAxiDma_Bd * BdSetPtr, int Burst)
 {
 	XAxiDma_Bd *CurBdPtr;
 	int i;
@@ -1056,7 +1113,9 @@ int XAxiDma_BdRingToHw(XAxiDma_BdRing * RingPtr, int NumBd,
 		XAxiDma_BdWrite(CurBdPtr, XAXIDMA_BD_STS_OFFSET, BdSts);
 
 		/* Flush the current BD so DMA core could see the updates */
-		XAXIDMA_CACHE_FLUSH(CurBdPtr);
+		if (!Burst) {
+			XAXIDMA_CACHE_FLUSH(CurBdPtr);
+		}
 
 		CurBdPtr = (XAxiDma_Bd *)((void *)XAxiDma_BdRingNext(RingPtr, CurBdPtr));
 		BdCr = XAxiDma_BdRead(CurBdPtr, XAXIDMA_BD_CTRL_LEN_OFFSET);
@@ -1086,8 +1145,15 @@ int XAxiDma_BdRingToHw(XAxiDma_BdRing * RingPtr, int NumBd,
 	BdSts &= ~XAXIDMA_BD_STS_COMPLETE_MASK;
 	XAxiDma_BdWrite(CurBdPtr, XAXIDMA_BD_STS_OFFSET, BdSts);
 
-	/* Flush the last BD so DMA core could see the updates */
-	XAXIDMA_CACHE_FLUSH(CurBdPtr);
+	/* Flush the last BD, or the whole set, so DMA core could see the
+	 * updates
+	 */
+	if (Burst) {
+		XAxiDma_BdRingSpanCache(RingPtr, BdSetPtr, NumBd, 1);
+	}
+	else {
+		XAXIDMA_CACHE_FLUSH(CurBdPtr);
+	}
 	DATA_SYNC;
 
 	/* This set has completed pre-processing, adjust ring pointers and
@@ -1217,6 +1283,61 @@ int XAxiDma_BdRingToHw(XAxiDma_BdRing * RingPtr, int NumBd,
  *****************************************************************************/
 int XAxiDma_BdRingFromHw(XAxiDma_BdRing * RingPtr, int BdLimit,
 			     XAxiDma_Bd ** BdSetPtr)
+{
+	return XAxiDma_BdRingReap(RingPtr, BdLimit, BdSetPtr, 0);
+}
+
+/*****************************************************************************/
+/**
+ * Returns a set of BD(s) that have been processed by hardware like
+ * XAxiDma_BdRingFromHw(), but invalidate the BDs that are searched with one
+ * data cache range operation instead of one per BD. A search that wraps
+ * around the end of the ring takes two range operations.
+ *
+ * @param	RingPtr is a pointer to the descriptor ring instance to be
+ *		worked on.
+ * @param	BdLimit is the maximum number of BDs to return in the set. Use
+ *		XAXIDMA_ALL_BDS to return all BDs that have been processed.
+ * @param	BdSetPtr is an output parameter, it points to the first BD
+ *		available for examination.
+ *
+ * @return	Same as XAxiDma_BdRingFromHw().
+ *
+ * @note	Treat BDs returned by this function as read-only.
+ *
+ * 		This function should not be preempted by another XAxiDma ring
+ *		function call that modifies the BD space. It is the caller's
+ *		responsibility to provide a mutual exclusion mechanism.
+ *
+ *		This function can be used only when DMA is in SG mode
+ *
+ *****************************************************************************/
+int XAxiDma_BdRingFromHwBurst(XAxiDma_BdRing * RingPtr, int BdLimit,
+			     XAxiDma_Bd ** BdSetPtr)
+{
+	return XAxiDma_BdRingReap(RingPtr, BdLimit, BdSetPtr, 1);
+}
+
+/*****************************************************************************/
+/**
+ * Common implementation of XAxiDma_BdRingFromHw() and
+ * XAxiDma_BdRingFromHwBurst().
+ *
+ * @param	RingPtr is a pointer to the descriptor ring instance to be
+ *		worked on.
+ * @param	BdLimit is the maximum number of BDs to return in the set.
+ * @param	BdSetPtr is an output parameter, it points to the first BD
+ *		available for examination.
+ * @param	Burst selects one cache invalidate for all searched BDs when
+ *		non-zero, or one per BD when zero.
+ *
+ * @return	See XAxiDma_BdRingFromHw().
+ *
+ * @note	None.
+ *
+ *****************************************************************************/
+static int XAxiDma_BdRingReap(XAxiDma_BdRing * RingPtr, int BdLimit,
+			     XAxiDma_Bd ** BdSetPtr, int Burst)
 {
 	XAxiDma_Bd *CurBdPtr;
 	int BdCount;
@@ -1241,6 +1362,10 @@ int XAxiDma_BdRingFromHw(XAxiDma_BdRing * RingPtr, int BdLimit,
 		BdLimit = RingPtr->HwCnt;
 	}
 
+	if (Burst) {
+		XAxiDma_BdRingSpanCache(RingPtr, CurBdPtr, BdLimit, 0);
+	}
+
 	/* Starting at HwHead, keep moving forward in the list until:
 	 *  - A BD is encountered with its completed bit clear in the status
 	 *    word which means hardware has not completed processing of that
@@ -1251,7 +1376,9 @@ int XAxiDma_BdRingFromHw(XAxiDma_BdRing * RingPtr, int BdLimit,
 
 	while (BdCount < BdLimit) {
 		/* Read the status */
-		XAXIDMA_CACHE_INVALIDATE(CurBdPtr);
+		if (!Burst) {
+			XAXIDMA_CACHE_INVALIDATE(CurBdPtr);
+		}
 		BdSts = XAxiDma_BdRead(CurBdPtr, XAXIDMA_BD_STS_OFFSET);
 		BdCr = XAxiDma_BdRead(CurBdPtr, XAXIDMA_BD_CTRL_LEN_OFFSET);
 
@@ -1285,7 +1412,9 @@ int XAxiDma_BdRingFromHw(XAxiDma_BdRing * RingPtr, int BdLimit,
 		if (RingPtr->Cyclic) {
 			BdSts = BdSts & ~XAXIDMA_BD_STS_COMPLETE_MASK;
 			XAxiDma_BdWrite(CurBdPtr, XAXIDMA_BD_STS_OFFSET, BdSts);
-			XAXIDMA_CACHE_FLUSH(CurBdPtr);
+			if (!Burst) {
+				XAXIDMA_CACHE_FLUSH(CurBdPtr);
+			}
 		}
 
 		/* Reached the end of the work group */
@@ -1297,6 +1426,11 @@ int XAxiDma_BdRingFromHw(XAxiDma_BdRing * RingPtr, int BdLimit,
 		CurBdPtr = (XAxiDma_Bd *)((void *)XAxiDma_BdRingNext(RingPtr, CurBdPtr));
 	}
 
+	/* In cyclic mode write back the status of all completed BDs at once */
+	if (Burst && RingPtr->Cyclic && (BdCount != 0)) {
+		XAxiDma_BdRingSpanCache(RingPtr, RingPtr->HwHead, BdCount, 1);
+	}
+
 	/* Subtract off any partial packet BDs found */
 	BdCount -= BdPartialCount;
 
@@ -1379,6 +1513,173 @@ int XAxiDma_BdRingFree(XAxiDma_BdRing * RingPtr, int NumBd,
 
 	return XST_SUCCESS;
 }
+
+/*****************************************************************************/
+/**
+ * Process BDs completed by hardware, up to a budget, in the style of a NAPI
+ * poll routine. Completed BDs are retrieved with XAxiDma_BdRingFromHwBurst(),
+ * passed to the handler for examination and then freed with
+ * XAxiDma_BdRingFree(), until the budget is used or no more BDs are complete.
+ *
+ * Only whole packets are processed. When the budget ends inside a completed
+ * packet, that packet is still processed, so the return value may exceed
+ * the budget by less than the BD count of one packet.
+ *
+ * A typical interrupt driven user disables the channel interrupts in the
+ * interrupt handler and calls this function from its main loop. When it
+ * returns less than the budget, no completed packet is left in the ring and
+ * the interrupts are enabled again. Otherwise it is called again.
+ *
+ * @param	RingPtr is a pointer to the descriptor ring instance to be
+ *		worked on.
+ * @param	Budget is the number of BDs to process before returning.
+ * @param	Handler is called for each set of completed BDs, before they
+ *		are freed. It examines the BDs and takes over their buffers,
+ *		but must not call XAxiDma_BdRingAlloc() since the set has not
+ *		been returned to the free group yet. RX users re-allocate and
+ *		re-commit BDs after this function returns.
+ * @param	CallBackRef is passed to the handler.
+ *
+ * @return	The number of BDs processed. Less than Budget when no
+ *		completed packet is left in the ring.
+ *
+ * @note	This function should not be preempted by another XAxiDma ring
+ *		function call that modifies the BD space. It is the caller's
+ *		responsibility to provide a mutual exclusion mechanism.
+ *
+ *		Not supported for cyclic DMA mode, where BDs are never freed.
+ *
+ *		This function can be used only when DMA is in SG mode
+ *
+ *****************************************************************************/
+int XAxiDma_BdRingPoll(XAxiDma_BdRing * RingPtr, int Budget,
+		XAxiDma_BdRingPollHandler Handler, void *CallBackRef)
+{
+	XAxiDma_Bd *BdSetPtr;
+	int NumBd;
+	int Done = 0;
+
+	Xil_AssertNonvoid(RingPtr != NULL);
+	Xil_AssertNonvoid(Handler != NULL);
+	Xil_AssertNonvoid(RingPtr->Cyclic == 0);
+
+	while (Done < Budget) {
+		NumBd = XAxiDma_BdRingReap(RingPtr, Budget - Done, &BdSetPtr,
+									1);
+		if (NumBd == 0) {
+			/* The remaining budget ends inside the next packet, take
+			 * the whole packet if hardware has completed it
+			 */
+			NumBd = XAxiDma_BdRingPktBdCount(RingPtr);
+			if (NumBd == 0) {
+				break;
+			}
+			NumBd = XAxiDma_BdRingReap(RingPtr, NumBd, &BdSetPtr,
+									1);
+		}
+
+		Handler(CallBackRef, BdSetPtr, NumBd);
+
+		if (XAxiDma_BdRingFree(RingPtr, NumBd, BdSetPtr) !=
+							XST_SUCCESS) {
+			break;
+		}
+		Done += NumBd;
+	}
+
+	return Done;
+}
+
+/*****************************************************************************/
+/**
+ * Count the BDs of the packet at the head of the work group.
+ *
+ * @param	RingPtr is a pointer to the descriptor ring instance.
+ *
+ * @return	The number of BDs of the packet if hardware has completed all
+ *		of them, or 0 otherwise.
+ *
+ * @note	None.
+ *
+ *****************************************************************************/
+static int XAxiDma_BdRingPktBdCount(XAxiDma_BdRing * RingPtr)
+{
+	XAxiDma_Bd *CurBdPtr = RingPtr->HwHead;
+	int BdCount = 0;
+	u32 BdSts;
+	u32 BdCr;
+
+	while (BdCount < RingPtr->HwCnt) {
+		XAXIDMA_CACHE_INVALIDATE(CurBdPtr);
+		BdSts = XAxiDma_BdRead(CurBdPtr, XAXIDMA_BD_STS_OFFSET);
+		BdCr = XAxiDma_BdRead(CurBdPtr, XAXIDMA_BD_CTRL_LEN_OFFSET);
+
+		if (!(BdSts & XAXIDMA_BD_STS_COMPLETE_MASK)) {
+			break;
+		}
+
+		BdCount++;
+
+		if (((!(RingPtr->IsRxChannel) &&
+		(BdCr & XAXIDMA_BD_CTRL_TXEOF_MASK)) ||
+		((RingPtr->IsRxChannel) && (BdSts &
+			XAXIDMA_BD_STS_RXEOF_MASK)))) {
+			return BdCount;
+		}
+
+		CurBdPtr = (XAxiDma_Bd *)((void *)XAxiDma_BdRingNext(RingPtr, CurBdPtr));
+	}
+
+	return 0;
+}
+
+/*****************************************************************************/
+/**
+ * Flush or invalidate the data cache lines of a contiguous set of BDs in the
+ * ring, with one range operation, or two if the set wraps around the end of
+ * the ring.
+ *
+ * @param	RingPtr is a pointer to the descriptor ring instance.
+ * @param	BdPtr is the first BD of the set.
+ * @param	NumBd is the number of BDs in the set.
+ * @param	Flush selects a flush when non-zero, or an invalidate when zero.
+ *
+ * @return	None.
+ *
+ * @note	None.
+ *
+ *****************************************************************************/
+static void XAxiDma_BdRingSpanCache(XAxiDma_BdRing * RingPtr,
+		XAxiDma_Bd * BdPtr, int NumBd, int Flush)
+{
+	UINTPTR Start = (UINTPTR)BdPtr;
+	u32 Len = (u32)NumBd * (u32)RingPtr->Separation;
+	u32 FirstLen = (u32)(RingPtr->LastBdAddr + RingPtr->Separation - Start);
+
+	if (NumBd <= 0) {
+		return;
+	}
+
+	if (Len > FirstLen) {
+		/* The set wraps, handle the part at the start of the ring */
+		if (Flush) {
+			XAXIDMA_CACHE_FLUSH_RANGE(RingPtr->FirstBdAddr,
+							Len - FirstLen);
+		}
+		else {
+			XAXIDMA_CACHE_INVALIDATE_RANGE(RingPtr->FirstBdAddr,
+							Len - FirstLen);
+		}
+		Len = FirstLen;
+	}
+
+	if (Flush) {
+		XAXIDMA_CACHE_FLUSH_RANGE(Start, Len);
+	}
+	else {
+		XAXIDMA_CACHE_INVALIDATE_RANGE(Start, Len);
+	}
+}
 /*****************************************************************************/
 /**
  * Check the internal data structures of the BD ring for the provided channel.
@@ -111,6 +111,21 @@ typedef struct {
 	int Cyclic;		/**< Check for cyclic DMA Mode */
 } XAxiDma_BdRing;
 
+/**
+ * Callback type used by XAxiDma_BdRingPoll() to process a set of BDs that
+ * have been completed by hardware.
+ *
+ * @param	CallBackRef is the callback reference passed to
+ *		XAxiDma_BdRingPoll().
+ * @param	BdSetPtr is the first BD of the completed set.
+ * @param	NumBd is the number of BDs in the set.
+ *
+ * The set is freed when the handler returns, so the handler must not
+ * allocate BDs from the ring.
+ */
+typedef void (*XAxiDma_BdRingPollHandler)(void *CallBackRef,
+		XAxiDma_Bd *BdSetPtr, int NumBd);
+
 /***************** Macros (Inline Functions) Definitions *********************/
 
 /*****************************************************************************/
@@ -501,8 +516,14 @@ int XAxiDma_BdRingToHw(XAxiDma_BdRing * RingPtr, int NumBd,
 		XAxiDma_Bd * BdSetPtr);
 int XAxiDma_BdRingFromHw(XAxiDma_BdRing * RingPtr, int BdLimit,
 		XAxiDma_Bd ** BdSetPtr);
+int XAxiDma_BdRingToHwBurst(XAxiDma_BdRing * RingPtr, int NumBd,
+		XAxiDma_Bd * BdSetPtr);
+int XAxiDma_BdRingFromHwBurst(XAxiDma_BdRing * RingPtr, int BdLimit,
+		XAxiDma_Bd ** BdSetPtr);
 int XAxiDma_BdRingFree(XAxiDma_BdRing * RingPtr, int NumBd,
 		XAxiDma_Bd * BdSetPtr);
+int XAxiDma_BdRingPoll(XAxiDma_BdRing * RingPtr, int Budget,
+		XAxiDma_BdRingPollHandler Handler, void *CallBackRef);
 int XAxiDma_BdRingStart(XAxiDma_BdRing * RingPtr);
 int XAxiDma_BdRingSetCoalesce(XAxiDma_BdRing * RingPtr, u32 Counter, u32 Timer);
 void XAxiDma_BdRingGetCoalesce(XAxiDma_BdRing * RingPtr,
@@ -0,0 +1,769 @@
+/******************************************************************************
+* Copyright (C) 2020 Xilinx, Inc.  All rights reserved.
+* SPDX-License-Identifier: MIT
+******************************************************************************/
+
+/*****************************************************************************/
+/**
+*
+* @file test_xaxidma_bdring.c
+*
+* Host test of the burst BD ring functions, XAxiDma_BdRingToHwBurst(),
+* XAxiDma_BdRingFromHwBurst() and XAxiDma_BdRingPoll(). The driver runs
+* against a simulator of an SG channel: control, status, current and tail
+* descriptor registers, and an engine that fetches BDs from memory, checks
+* that they were handed over, and writes back the status word, with RX
+* packets spanning several BDs. The BD ring sits behind a model of a write
+* back data cache that is not coherent with the engine: the engine only sees
+* what the driver flushed, and the driver only sees what the engine wrote
+* once it invalidated, one cache line at a time.
+*
+* The test streams TX and RX packets through both the per BD and the burst
+* functions with the engine stopping at random points, including sets that
+* wrap around the end of the ring, checks every BD and packet in order and
+* counts the cache maintenance calls. It checks the whole packet and budget
+* rules of XAxiDma_BdRingPoll(), and measures the packet rate of both
+* functions with a fixed cost for each cache maintenance call.
+*
+* Build and run on the host:
+*   cc -Wall -O2 -I. -I../src -I../../../../lib/bsp/standalone/src/common \
+*      -I../../../../lib/bsp/standalone/src/arm/cortexa9 \
+*      test_xaxidma_bdring.c -o test_xaxidma_bdring
+*   ./test_xaxidma_bdring
+*
+******************************************************************************/
+
+/***************************** Include Files *********************************/
+
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+
+#include "xil_types.h"
+
+/* Register accesses go to the simulator below */
+#define XIL_IO_H
+static u32 Xil_In32(UINTPTR Addr);
+static void Xil_Out32(UINTPTR Addr, u32 Value);
+#define DATA_SYNC
+
+#define XIL_PRINTF_H
+void xil_printf(const char8 *Format, ...);
+
+#include "xaxidma_bd.c"
+#include "xaxidma_bdring.c"
+
+/************************** Simulator ****************************************/
+
+#define SIM_CHAN_BASE	0x40400000U
+#define SIM_BD_PHYS	0x10000000U
+#define SIM_BUF_PHYS	0x20000000U
+#define SIM_MAX_BDS	256
+#define SIM_BD_BYTES	XAXIDMA_BD_MINIMUM_ALIGNMENT
+#define SIM_LINE	32U
+#define SIM_LEN_MASK	0x3FFFFFFU
+#define SIM_LOG_LEN	200000
+
+/* The BD ring as the driver sees it, through the data cache */
+static u8 CpuMem[SIM_MAX_BDS * SIM_BD_BYTES]
+			__attribute__((aligned(SIM_BD_BYTES)));
+/* The BD ring in memory, as the engine sees it */
+static u8 Dram[SIM_MAX_BDS * SIM_BD_BYTES];
+
+typedef struct {
+	u32 Calls;		/* Range operations */
+	u32 Lines;		/* Cache lines written back or invalidated */
+	u32 Stray;		/* Lines outside the BD ring */
+	u32 SpinPerCall;	/* Work standing in for the cost of a call */
+} SimCacheStats;
+
+static SimCacheStats Cache;
+static volatile u32 SpinSink;
+
+typedef struct {
+	u32 Cr;
+	u32 Sr;
+	u32 Cdesc;
+	u32 Tdesc;
+	u32 Next;		/* Next BD the engine fetches */
+	int Pending;		/* BDs up to the tail are left to process */
+	int IsRx;
+	u32 Errors;		/* BDs the engine should never have seen */
+	u32 Processed;
+	u32 RxPkt;		/* RX packet being received */
+	u32 RxPktLeft;		/* BDs left in the RX packet */
+	u32 PktsDone;		/* Packets completed by the engine */
+	u32 Log[SIM_LOG_LEN];	/* Buffer address of every BD processed */
+} SimDma;
+
+static SimDma Dma;
+static u32 Seed = 1U;
+
+static u32 SimRand(void)
+{
+	Seed = Seed * 1103515245U + 12345U;
+	return (Seed >> 16) & 0x7FFFU;
+}
+
+static u32 SimDramRead(u32 Phys, u32 Offset)
+{
+	u32 Value;
+
+	memcpy(&Value, &Dram[Phys - SIM_BD_PHYS + Offset], sizeof(Value));
+	return Value;
+}
+
+static void SimDramWrite(u32 Phys, u32 Offset, u32 Value)
+{
+	memcpy(&Dram[Phys - SIM_BD_PHYS + Offset], &Value, sizeof(Value));
+}
+
+/* Number of BDs in RX packet Pkt */
+static u32 SimRxPktBds(u32 Pkt)
+{
+	return 1U + (Pkt * 7U) % 3U;
+}
+
+/* Length the engine reports for a BD */
+static u32 SimRxLen(u32 Pkt)
+{
+	return 64U + (Pkt * 13U) % 1400U;
+}
+
+static void SimReset(int IsRx)
+{
+	memset(&Dma, 0, sizeof(Dma));
+	memset(&Cache, 0, sizeof(Cache));
+	memset(CpuMem, 0, sizeof(CpuMem));
+	memset(Dram, 0, sizeof(Dram));
+	Dma.Sr = XAXIDMA_HALTED_MASK;
+	Dma.IsRx = IsRx;
+}
+
+/* Let the engine process up to MaxBds BDs */
+static void SimRun(u32 MaxBds)
+{
+	u32 Count = 0U;
+	u32 Sts;
+	u32 Ctrl;
+	u32 Bd;
+
+	while (Dma.Pending && (Count < MaxBds)) {
+		Bd = Dma.Next;
+		if ((Bd < SIM_BD_PHYS) || (Bd >= SIM_BD_PHYS + sizeof(Dram)) ||
+				((Bd - SIM_BD_PHYS) % SIM_BD_BYTES) != 0U) {
+			Dma.Errors++;
+			Dma.Pending = 0;
+			break;
+		}
+		Sts = SimDramRead(Bd, XAXIDMA_BD_STS_OFFSET);
+		Ctrl = SimDramRead(Bd, XAXIDMA_BD_CTRL_LEN_OFFSET);
+		if ((Sts & XAXIDMA_BD_STS_COMPLETE_MASK) ||
+				((Ctrl & SIM_LEN_MASK) == 0U)) {
+			/* A BD that was not handed over, halt like the
+			 * hardware does on an invalid descriptor
+			 */
+			Dma.Errors++;
+			Dma.Pending = 0;
+			break;
+		}
+		if (Dma.Processed < SIM_LOG_LEN) {
+			Dma.Log[Dma.Processed] =
+				SimDramRead(Bd, XAXIDMA_BD_BUFA_OFFSET);
+		}
+		Dma.Processed++;
+
+		if (Dma.IsRx) {
+			Sts = XAXIDMA_BD_STS_COMPLETE_MASK | SimRxLen(Dma.RxPkt);
+			if (Dma.RxPktLeft == 0U) {
+				Dma.RxPktLeft = SimRxPktBds(Dma.RxPkt);
+				Sts |= XAXIDMA_BD_STS_RXSOF_MASK;
+			}
+			SimDramWrite(Bd, XAXIDMA_BD_USR0_OFFSET, Dma.RxPkt);
+			if (--Dma.RxPktLeft == 0U) {
+				Sts |= XAXIDMA_BD_STS_RXEOF_MASK;
+				Dma.RxPkt++;
+				Dma.PktsDone++;
+			}
+		}
+		else {
+			Sts = XAXIDMA_BD_STS_COMPLETE_MASK |
+						(Ctrl & SIM_LEN_MASK);
+			if (Ctrl & XAXIDMA_BD_CTRL_TXEOF_MASK) {
+				Dma.PktsDone++;
+			}
+		}
+		SimDramWrite(Bd, XAXIDMA_BD_STS_OFFSET, Sts);
+
+		Dma.Cdesc = Bd;
+		Dma.Next = SimDramRead(Bd, XAXIDMA_BD_NDESC_OFFSET);
+		if (Bd == Dma.Tdesc) {
+			Dma.Pending = 0;
+			Dma.Sr |= XAXIDMA_IDLE_MASK;
+		}
+		Count++;
+	}
+}
+
+/* Write the CPU view of the whole ring to memory, as after a cold start */
+static void SimSyncRing(void)
+{
+	memcpy(Dram, CpuMem, sizeof(Dram));
+}
+
+/* Flush or invalidate whole cache lines covering a range */
+static void SimCache(INTPTR Addr, u32 Len, int Flush)
+{
+	UINTPTR Start = (UINTPTR)Addr & ~(UINTPTR)(SIM_LINE - 1U);
+	UINTPTR End = ((UINTPTR)Addr + Len + SIM_LINE - 1U) &
+					~(UINTPTR)(SIM_LINE - 1U);
+	UINTPTR Line;
+	u32 Spin;
+
+	Cache.Calls++;
+	for (Spin = 0U; Spin < Cache.SpinPerCall; Spin++) {
+		SpinSink++;
+	}
+	for (Line = Start; Line < End; Line += SIM_LINE) {
+		Cache.Lines++;
+		if ((Line < (UINTPTR)CpuMem) ||
+				(Line >= (UINTPTR)CpuMem + sizeof(CpuMem))) {
+			Cache.Stray++;
+			continue;
+		}
+		if (Flush) {
+			memcpy(&Dram[Line - (UINTPTR)CpuMem], (void *)Line,
+								SIM_LINE);
+		}
+		else {
+			memcpy((void *)Line, &Dram[Line - (UINTPTR)CpuMem],
+								SIM_LINE);
+		}
+	}
+}
+
+/************************** Stubs ********************************************/
+
+static u32 Xil_In32(UINTPTR Addr)
+{
+	switch (Addr - SIM_CHAN_BASE) {
+	case XAXIDMA_CR_OFFSET:
+		return Dma.Cr;
+	case XAXIDMA_SR_OFFSET:
+		return Dma.Sr;
+	case XAXIDMA_CDESC_OFFSET:
+		return Dma.Cdesc;
+	case XAXIDMA_TDESC_OFFSET:
+		return Dma.Tdesc;
+	default:
+		return 0U;
+	}
+}
+
+static void Xil_Out32(UINTPTR Addr, u32 Value)
+{
+	switch (Addr - SIM_CHAN_BASE) {
+	case XAXIDMA_CR_OFFSET:
+		Dma.Cr = Value;
+		if (Value & XAXIDMA_CR_RUNSTOP_MASK) {
+			Dma.Sr &= ~XAXIDMA_HALTED_MASK;
+			Dma.Sr |= XAXIDMA_IDLE_MASK;
+		}
+		break;
+	case XAXIDMA_CDESC_OFFSET:
+		Dma.Cdesc = Value;
+		Dma.Next = Value;
+		break;
+	case XAXIDMA_TDESC_OFFSET:
+		Dma.Tdesc = Value;
+		Dma.Pending = 1;
+		Dma.Sr &= ~XAXIDMA_IDLE_MASK;
+		break;
+	default:
+		break;
+	}
+}
+
+/* Cache maintenance goes to the cache model */
+void Xil_DCacheFlushRange(INTPTR Addr, u32 Len)
+{
+	SimCache(Addr, Len, 1);
+}
+
+void Xil_DCacheInvalidateRange(INTPTR Addr, u32 Len)
+{
+	SimCache(Addr, Len, 0);
+}
+
+void xil_printf(const char8 *Format, ...)
+{
+	(void)Format;
+}
+
+u32 Xil_AssertStatus;
+
+void Xil_Assert(const char8 *File, s32 Line)
+{
+	printf("assert %s:%d\n", File, (int)Line);
+}
+
+/************************** Test Helpers *************************************/
+
+static u32 Failures;
+
+#define CHECK(Cond, Msg)						\
+	do {								\
+		if (!(Cond)) {						\
+			printf("FAIL %s:%d: %s\n", __FILE__, __LINE__,	\
+								(Msg));	\
+			Failures++;					\
+		}							\
+	} while (0)
+
+static XAxiDma_BdRing Ring;
+
+/* Create and start a ring of NumBds BDs on the simulated channel */
+static void SetupRing(int IsRx, int NumBds)
+{
+	XAxiDma_Bd Template;
+	int Status;
+
+	SimReset(IsRx);
+	memset(&Ring, 0, sizeof(Ring));
+	Ring.ChanBase = SIM_CHAN_BASE;
+	Ring.IsRxChannel = IsRx;
+	Ring.HasDRE = 1;
+	Ring.DataWidth = 4;
+	Ring.MaxTransferLen = SIM_LEN_MASK;
+	Ring.RunState = AXIDMA_CHANNEL_HALTED;
+
+	Status = XAxiDma_BdRingCreate(&Ring, SIM_BD_PHYS, (UINTPTR)CpuMem,
+					XAXIDMA_BD_MINIMUM_ALIGNMENT, NumBds);
+	CHECK(Status == XST_SUCCESS, "ring create");
+	memset(&Template, 0, sizeof(Template));
+	Status = XAxiDma_BdRingClone(&Ring, &Template);
+	CHECK(Status == XST_SUCCESS, "ring clone");
+	SimSyncRing();
+
+	Status = XAxiDma_BdRingStart(&Ring);
+	CHECK(Status == XST_SUCCESS, "ring start");
+	memset(&Cache, 0, sizeof(Cache));
+}
+
+static int RingCountsValid(void)
+{
+	return (Ring.FreeCnt + Ring.PreCnt + Ring.HwCnt + Ring.PostCnt ==
+							Ring.AllCnt) &&
+		(Ring.FreeCnt >= 0) && (Ring.HwCnt >= 0);
+}
+
+static u32 TxBufAddr(u32 Bd)
+{
+	return SIM_BUF_PHYS + Bd * 0x800U;
+}
+
+static u32 TxLen(u32 Bd)
+{
+	return 1U + (Bd * 37U) % 1500U;
+}
+
+/*
+ * Stream Packets TX packets of 1 to MaxPktBds BDs, queueing up to MaxBatch
+ * packets per commit and letting the engine run up to RunMax BDs between
+ * commits. Returns the number of BDs sent.
+ */
+static u32 TxStream(int Burst, u32 Packets, u32 MaxPktBds, u32 MaxBatch,
+							u32 RunMax)
+{
+	XAxiDma_Bd *BdPtr;
+	XAxiDma_Bd *CurBd;
+	u32 Sent = 0U;
+	u32 SentBds = 0U;
+	u32 Reaped = 0U;
+	u32 Pkt;
+	u32 Batch;
+	u32 PktBds[64];
+	u32 NumBd;
+	u32 Index;
+	u32 Bd;
+	int Status;
+	int Got;
+
+	while ((Reaped < SentBds) || (Sent < Packets)) {
+		/* Queue a batch of packets that fits in the free group */
+		Batch = 1U + SimRand() % MaxBatch;
+		NumBd = 0U;
+		for (Pkt = 0U; (Pkt < Batch) && (Sent + Pkt < Packets);
+								Pkt++) {
+			PktBds[Pkt] = 1U + SimRand() % MaxPktBds;
+			if (NumBd + PktBds[Pkt] > (u32)Ring.FreeCnt) {
+				break;
+			}
+			NumBd += PktBds[Pkt];
+		}
+		Batch = Pkt;
+		if (NumBd != 0U) {
+			Status = XAxiDma_BdRingAlloc(&Ring, (int)NumBd, &BdPtr);
+			CHECK(Status == XST_SUCCESS, "TX alloc");
+			CurBd = BdPtr;
+			Bd = SentBds;
+			for (Pkt = 0U; Pkt < Batch; Pkt++) {
+				for (Index = 0U; Index < PktBds[Pkt]; Index++) {
+					XAxiDma_BdSetBufAddr(CurBd,
+							TxBufAddr(Bd));
+					XAxiDma_BdSetLength(CurBd, TxLen(Bd),
+							Ring.MaxTransferLen);
+					XAxiDma_BdSetCtrl(CurBd,
+						(Index == 0U ?
+						XAXIDMA_BD_CTRL_TXSOF_MASK : 0U) |
+						(Index == PktBds[Pkt] - 1U ?
+						XAXIDMA_BD_CTRL_TXEOF_MASK : 0U));
+					CurBd = (XAxiDma_Bd *)
+						XAxiDma_BdRingNext(&Ring, CurBd);
+					Bd++;
+				}
+			}
+			if (Burst) {
+				Status = XAxiDma_BdRingToHwBurst(&Ring,
+							(int)NumBd, BdPtr);
+			}
+			else {
+				Status = XAxiDma_BdRingToHw(&Ring, (int)NumBd,
+								BdPtr);
+			}
+			CHECK(Status == XST_SUCCESS, "TX commit");
+			if (Status != XST_SUCCESS) {
+				return SentBds;
+			}
+			Sent += Batch;
+			SentBds += NumBd;
+		}
+
+		SimRun(Sent < Packets ? SimRand() % (RunMax + 1U) :
+								SIM_MAX_BDS);
+		if (Dma.Errors != 0U) {
+			return SentBds;
+		}
+
+		/* Reap what the engine completed and check it */
+		if (Burst) {
+			Got = XAxiDma_BdRingFromHwBurst(&Ring, XAXIDMA_ALL_BDS,
+								&BdPtr);
+		}
+		else {
+			Got = XAxiDma_BdRingFromHw(&Ring, XAXIDMA_ALL_BDS,
+								&BdPtr);
+		}
+		CurBd = BdPtr;
+		for (Index = 0U; Index < (u32)Got; Index++) {
+			if ((XAxiDma_BdRead(CurBd, XAXIDMA_BD_STS_OFFSET) !=
+				(XAXIDMA_BD_STS_COMPLETE_MASK |
+						TxLen(Reaped + Index))) ||
+				(XAxiDma_BdRead(CurBd, XAXIDMA_BD_BUFA_OFFSET) !=
+						TxBufAddr(Reaped + Index))) {
+				CHECK(0, "TX BD status");
+				return SentBds;
+			}
+			CurBd = (XAxiDma_Bd *)XAxiDma_BdRingNext(&Ring, CurBd);
+		}
+		if (Got != 0) {
+			Status = XAxiDma_BdRingFree(&Ring, Got, BdPtr);
+			CHECK(Status == XST_SUCCESS, "TX free");
+			Reaped += (u32)Got;
+		}
+		if (!RingCountsValid() || (Reaped > Dma.Processed)) {
+			CHECK(0, "TX ring counts");
+			return SentBds;
+		}
+	}
+
+	return SentBds;
+}
+
+/* Allocate, fill and commit NumBd RX BDs */
+static void RxRefill(int NumBd, int Burst)
+{
+	XAxiDma_Bd *BdPtr;
+	XAxiDma_Bd *CurBd;
+	int Index;
+	int Status;
+
+	if (NumBd == 0) {
+		return;
+	}
+	Status = XAxiDma_BdRingAlloc(&Ring, NumBd, &BdPtr);
+	CHECK(Status == XST_SUCCESS, "RX alloc");
+	if (Status != XST_SUCCESS) {
+		return;
+	}
+	CurBd = BdPtr;
+	for (Index = 0; Index < NumBd; Index++) {
+		XAxiDma_BdSetBufAddr(CurBd, SIM_BUF_PHYS +
+				(u32)((UINTPTR)CurBd - (UINTPTR)CpuMem) * 32U);
+		XAxiDma_BdSetLength(CurBd, 2048U, Ring.MaxTransferLen);
+		XAxiDma_BdWrite(CurBd, XAXIDMA_BD_STS_OFFSET, 0U);
+		CurBd = (XAxiDma_Bd *)XAxiDma_BdRingNext(&Ring, CurBd);
+	}
+	if (Burst) {
+		Status = XAxiDma_BdRingToHwBurst(&Ring, NumBd, BdPtr);
+	}
+	else {
+		Status = XAxiDma_BdRingToHw(&Ring, NumBd, BdPtr);
+	}
+	CHECK(Status == XST_SUCCESS, "RX commit");
+}
+
+typedef struct {
+	u32 Pkts;		/* Whole packets received */
+	u32 Bds;
+	u32 Errors;
+	u32 Sets;
+	u32 LastPktBds;		/* BDs of the last packet handled */
+} RxResult;
+
+/* Poll handler checking that a set holds whole packets in order */
+static void RxHandler(void *CallBackRef, XAxiDma_Bd *BdSetPtr, int NumBd)
+{
+	RxResult *Result = CallBackRef;
+	XAxiDma_Bd *CurBd = BdSetPtr;
+	u32 Sts;
+	u32 Left = 0U;
+	int Index;
+
+	Result->Sets++;
+	for (Index = 0; Index < NumBd; Index++) {
+		Sts = XAxiDma_BdRead(CurBd, XAXIDMA_BD_STS_OFFSET);
+		if (Left == 0U) {
+			Left = SimRxPktBds(Result->Pkts);
+			if (!(Sts & XAXIDMA_BD_STS_RXSOF_MASK)) {
+				Result->Errors++;
+			}
+		}
+		if (!(Sts & XAXIDMA_BD_STS_COMPLETE_MASK) ||
+			((Sts & SIM_LEN_MASK) != SimRxLen(Result->Pkts)) ||
+			(XAxiDma_BdRead(CurBd, XAXIDMA_BD_USR0_OFFSET) !=
+							Result->Pkts)) {
+			Result->Errors++;
+		}
+		if (--Left == 0U) {
+			if (!(Sts & XAXIDMA_BD_STS_RXEOF_MASK)) {
+				Result->Errors++;
+			}
+			Result->LastPktBds = SimRxPktBds(Result->Pkts);
+			Result->Pkts++;
+		}
+		Result->Bds++;
+		CurBd = (XAxiDma_Bd *)XAxiDma_BdRingNext(&Ring, CurBd);
+	}
+	/* A set always ends on a packet boundary */
+	if (Left != 0U) {
+		Result->Errors++;
+	}
+}
+
+/************************** Tests ********************************************/
+
+static void TestTxStream(void)
+{
+	static const u32 Sizes[] = { 8, 37, 64, 256 };
+	u32 Index;
+	u32 Bds;
+	u32 Burst;
+	u32 Calls[2];
+
+	for (Index = 0U; Index < sizeof(Sizes) / sizeof(Sizes[0]); Index++) {
+		for (Burst = 0U; Burst < 2U; Burst++) {
+			Seed = 7U + Index;
+			SetupRing(0, (int)Sizes[Index]);
+			Bds = TxStream((int)Burst, 20000U, 4U,
+				Sizes[Index] < 32U ? 2U : 12U, Sizes[Index]);
+			Calls[Burst] = Cache.Calls;
+
+			CHECK(Dma.Errors == 0U, "engine saw a stale BD");
+			CHECK(Cache.Stray == 0U, "cache op outside the ring");
+			CHECK(Dma.Processed == Bds && Ring.HwCnt == 0 &&
+				Ring.FreeCnt == Ring.AllCnt, "TX BDs lost");
+			CHECK(Dma.Processed <= SIM_LOG_LEN, "log too short");
+			for (Bds = 0U; Bds < Dma.Processed; Bds++) {
+				if (Dma.Log[Bds] != TxBufAddr(Bds)) {
+					CHECK(0, "TX BD order");
+					break;
+				}
+			}
+		}
+		/* Every BD is flushed and invalidated at least once one by
+		 * one, a batch takes at most two calls each way
+		 */
+		CHECK(Calls[1] * 2U < Calls[0], "burst cache calls");
+	}
+}
+
+static void TestTxWrap(void)
+{
+	XAxiDma_Bd *BdPtr;
+	XAxiDma_Bd *CurBd;
+	int Index;
+	int Status;
+
+	/* Move the heads to BD 6 of an 8 BD ring */
+	SetupRing(0, 8);
+	Seed = 3U;
+	TxStream(1, 6U, 1U, 1U, 8U);
+	CHECK(Ring.HwHead == (XAxiDma_Bd *)(CpuMem + 6 * SIM_BD_BYTES),
+						"ring not at BD 6");
+
+	Status = XAxiDma_BdRingAlloc(&Ring, 5, &BdPtr);
+	CHECK(Status == XST_SUCCESS, "wrap alloc");
+	CurBd = BdPtr;
+	for (Index = 0; Index < 5; Index++) {
+		XAxiDma_BdSetBufAddr(CurBd, TxBufAddr(6U + (u32)Index));
+		XAxiDma_BdSetLength(CurBd, 100U, Ring.MaxTransferLen);
+		XAxiDma_BdSetCtrl(CurBd, XAXIDMA_BD_CTRL_TXSOF_MASK |
+					XAXIDMA_BD_CTRL_TXEOF_MASK);
+		CurBd = (XAxiDma_Bd *)XAxiDma_BdRingNext(&Ring, CurBd);
+	}
+	/* Something the driver must not write back, in BD 3 */
+	CpuMem[3 * SIM_BD_BYTES + XAXIDMA_BD_ID_OFFSET] = 0x5A;
+
+	memset(&Cache, 0, sizeof(Cache));
+	Status = XAxiDma_BdRingToHwBurst(&Ring, 5, BdPtr);
+	CHECK(Status == XST_SUCCESS, "wrap commit");
+	CHECK(Cache.Calls == 2U, "wrapping set takes two flushes");
+	CHECK(Cache.Lines == 5U * SIM_BD_BYTES / SIM_LINE,
+						"wrapping set flush lines");
+	CHECK(Dram[3 * SIM_BD_BYTES + XAXIDMA_BD_ID_OFFSET] == 0U,
+						"flush beyond the set");
+
+	memset(&Cache, 0, sizeof(Cache));
+	SimRun(SIM_MAX_BDS);
+	CHECK(Dma.Errors == 0U && Dma.Processed == 11U, "wrap engine");
+	Index = XAxiDma_BdRingFromHwBurst(&Ring, XAXIDMA_ALL_BDS, &BdPtr);
+	CHECK(Index == 5, "wrap reap");
+	CHECK(Cache.Calls == 2U && Cache.Lines == 5U * SIM_BD_BYTES /
+				SIM_LINE, "wrapping reap invalidates");
+	XAxiDma_BdRingFree(&Ring, Index, BdPtr);
+	CHECK(Dma.Log[10] == TxBufAddr(10U), "wrap order");
+
+	/* A limit smaller than the work group invalidates only that much */
+	TxStream(1, 0U, 1U, 1U, 0U);
+	memset(&Cache, 0, sizeof(Cache));
+	Index = XAxiDma_BdRingFromHwBurst(&Ring, 1, &BdPtr);
+	CHECK(Index == 0 && Cache.Calls == 0U, "empty work group");
+}
+
+static void TestRxPoll(void)
+{
+	static const int Budgets[] = { 1, 4, 16, 64 };
+	RxResult Result;
+	u32 Bi;
+	u32 Round;
+	u32 Burst;
+	int Done;
+	u32 Before;
+
+	for (Bi = 0U; Bi < sizeof(Budgets) / sizeof(Budgets[0]); Bi++) {
+		for (Burst = 0U; Burst < 2U; Burst++) {
+			Seed = 11U + Bi;
+			SetupRing(1, 64);
+			memset(&Result, 0, sizeof(Result));
+			RxRefill(Ring.FreeCnt, (int)Burst);
+
+			for (Round = 0U; Round < 4000U; Round++) {
+				SimRun(SimRand() % 40U);
+				Before = Result.Pkts;
+				Done = XAxiDma_BdRingPoll(&Ring,
+						Budgets[Bi], RxHandler, &Result);
+				/* Only the packet crossing the budget may
+				 * take it over
+				 */
+				if (((Done > 0) && (Done - (int)Result.LastPktBds >=
+							Budgets[Bi])) ||
+						(Result.Bds > Dma.Processed)) {
+					CHECK(0, "poll over budget");
+					break;
+				}
+				/* Less than the budget means nothing left */
+				if ((Done < Budgets[Bi]) &&
+					(Result.Pkts != Dma.PktsDone)) {
+					CHECK(0, "poll left a packet behind");
+					break;
+				}
+				if ((Done >= Budgets[Bi]) &&
+						(Result.Pkts == Before)) {
+					CHECK(0, "poll made no progress");
+					break;
+				}
+				RxRefill(Done, (int)Burst);
+				if (!RingCountsValid()) {
+					CHECK(0, "RX ring counts");
+					break;
+				}
+			}
+			CHECK(Dma.Errors == 0U, "engine saw a stale RX BD");
+			CHECK(Result.Errors == 0U, "RX packets");
+			CHECK(Cache.Stray == 0U, "RX cache op outside the ring");
+			CHECK(Result.Pkts > 1000U, "RX made little progress");
+		}
+	}
+}
+
+static double NowNs(void)
+{
+	struct timespec Ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &Ts);
+	return (double)Ts.tv_sec * 1e9 + (double)Ts.tv_nsec;
+}
+
+static void TestThroughput(void)
+{
+	const u32 Packets = 200000U;
+	double Best[2] = { 1e30, 1e30 };
+	double CallsPerPkt[2];
+	double Start;
+	double Ns;
+	u32 Run;
+	u32 Burst;
+
+	for (Run = 0U; Run < 5U; Run++) {
+		for (Burst = 0U; Burst < 2U; Burst++) {
+			Seed = 5U;
+			SetupRing(0, 256);
+			/* Roughly the cost of one range operation with its
+			 * barriers and outer cache sync, against the cost of
+			 * the driver code itself
+			 */
+			Cache.SpinPerCall = 150U;
+			Start = NowNs();
+			TxStream((int)Burst, Packets, 1U, 32U, 256U);
+			Ns = (NowNs() - Start) / Packets;
+			CHECK(Dma.Errors == 0U && Dma.Processed == Packets,
+						"throughput run");
+			CallsPerPkt[Burst] = (double)Cache.Calls / Packets;
+			if (Ns < Best[Burst]) {
+				Best[Burst] = Ns;
+			}
+		}
+	}
+
+	printf("TX of 1 BD packets in batches of up to 32: per BD %.2f cache "
+		"calls/packet, %.2f Mpkt/s; burst %.2f cache calls/packet, "
+		"%.2f Mpkt/s\n", CallsPerPkt[0], 1e3 / Best[0],
+		CallsPerPkt[1], 1e3 / Best[1]);
+	CHECK(CallsPerPkt[1] * 4.0 < CallsPerPkt[0], "burst calls per packet");
+	CHECK(Best[1] * 1.5 < Best[0], "burst not faster");
+}
+
+/************************** Main *********************************************/
+
+int main(void)
+{
+	TestTxStream();
+	TestTxWrap();
+	TestRxPoll();
+	TestThroughput();
+
+	printf("%s (%u failures)\n", Failures ? "FAILED" : "PASSED",
+							Failures);
+	return Failures ? 1 : 0;
+}
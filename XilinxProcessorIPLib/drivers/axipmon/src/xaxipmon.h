@@ -86,7 +86,23 @@
 *
 * <b>Interrupts</b>
 *
-* The AXI Performance Monitor does not support Interrupts
+* The AXI Performance Monitor raises interrupts on Global Clock Counter
+* overflow, Sample Interval Counter lapse, Event Log FIFO full and Metric
+* Counter overflow. They are enabled, cleared and queried with the
+* XAxiPmon_Intr* macros. The driver has no interrupt handler of its own
+* except the sampler handler described below, which services the Sample
+* Interval Counter lapse only.
+*
+* <b> Continuous Sampling </b>
+*
+* The sampler in xaxipmon_sampler.c uses the Sample Interval Counter lapse
+* interrupt to snapshot the sampled metric counters of an Advanced mode
+* monitor into a ring of timestamped samples. XAxiPmon_SamplerIntrHandler()
+* has to be connected to the interrupt system by the application. Samples
+* are consumed with XAxiPmon_SamplerRead() and converted to per slot
+* bandwidth, latency and outstanding transaction statistics with
+* XAxiPmon_SamplerGetSlotStats(), or combined over several monitors with
+* XAxiPmon_SamplerAggregate().
 *
 *
 * <b> Virtual Memory </b>
@@ -411,6 +427,18 @@ extern "C" {
 
 /*@}*/
 
+/**
+ * @name Macros for the continuous sampler
+ * @{
+ */
+
+#define XAPM_SAMPLER_ALL_SLOTS		0xFFU /**< Combine all monitor slots
+						in the sampler statistics */
+#define XAPM_SAMPLER_FRAC_BITS		16U /**< Fraction bits of the fixed
+						point sampler statistics */
+
+/*@}*/
+
 /**************************** Type Definitions *******************************/
 
 /**
@@ -452,6 +480,53 @@ typedef struct {
 	u8   Mode;		/**< APM Mode */
 } XAxiPmon;
 
+/**
+ * One snapshot of the sampled metric counters taken by the sampler at a
+ * Sample Interval Counter lapse.
+ */
+typedef struct {
+	u64 Timestamp;		/**< Global Clock Counter at the snapshot */
+	u32 Interval;		/**< Sample interval in clock cycles */
+	u32 Counter[XAPM_MAX_COUNTERS]; /**< Sampled Metric Counters */
+} XAxiPmon_Sample;
+
+/**
+ * The sampler instance data. The ring is filled by
+ * XAxiPmon_SamplerIntrHandler() and drained by XAxiPmon_SamplerRead().
+ */
+typedef struct {
+	XAxiPmon *PmonPtr;		/**< Monitor being sampled */
+	XAxiPmon_Sample *RingPtr;	/**< Sample ring provided by the user */
+	u32 RingSize;			/**< Number of ring entries, power of 2 */
+	volatile u32 Head;		/**< Producer index (interrupt handler) */
+	volatile u32 Tail;		/**< Consumer index */
+	u32 Dropped;			/**< Snapshots lost on a full ring */
+	u32 ClkFreqHz;			/**< Monitor clock frequency */
+	u32 SampleInterval;		/**< Sample interval in clock cycles */
+	u8  NumCounters;		/**< Metric Counters in the snapshot */
+	u8  Metric[XAPM_MAX_COUNTERS];	/**< Metric of each counter */
+	u8  Slot[XAPM_MAX_COUNTERS];	/**< Slot of each counter */
+} XAxiPmon_Sampler;
+
+/**
+ * Statistics of one slot, or of all slots, derived from samples. Fields are
+ * zero when the corresponding metric is not selected in any counter.
+ */
+typedef struct {
+	u64 WrBandwidth;	/**< Write bytes per second */
+	u64 RdBandwidth;	/**< Read bytes per second */
+	u32 WrTransactions;	/**< Write transactions in the interval */
+	u32 RdTransactions;	/**< Read transactions in the interval */
+	u32 WrLatency;		/**< Average write latency in clock cycles,
+				  *  XAPM_SAMPLER_FRAC_BITS fixed point */
+	u32 RdLatency;		/**< Average read latency in clock cycles,
+				  *  XAPM_SAMPLER_FRAC_BITS fixed point */
+	u32 WrOutstanding;	/**< Average outstanding writes,
+				  *  XAPM_SAMPLER_FRAC_BITS fixed point */
+	u32 RdOutstanding;	/**< Average outstanding reads,
+				  *  XAPM_SAMPLER_FRAC_BITS fixed point */
+} XAxiPmon_SlotStats;
+
 /***************** Macros (Inline Functions) Definitions ********************/
 
 
@@ -907,6 +982,29 @@ u32 XAxiPmon_GetWriteIdMask(XAxiPmon *InstancePtr);
 u32 XAxiPmon_GetReadIdMask(XAxiPmon *InstancePtr);
 
 
+/**
+ * Functions in xaxipmon_sampler.c
+ */
+s32 XAxiPmon_SamplerInitialize(XAxiPmon_Sampler *SamplerPtr,
+		XAxiPmon *InstancePtr, XAxiPmon_Sample *RingPtr,
+		u32 RingSize, u32 ClkFreqHz);
+
+s32 XAxiPmon_SamplerStart(XAxiPmon_Sampler *SamplerPtr, u32 SampleInterval);
+
+void XAxiPmon_SamplerStop(XAxiPmon_Sampler *SamplerPtr);
+
+void XAxiPmon_SamplerIntrHandler(void *CallBackRef);
+
+s32 XAxiPmon_SamplerRead(XAxiPmon_Sampler *SamplerPtr,
+		XAxiPmon_Sample *SamplePtr);
+
+void XAxiPmon_SamplerGetSlotStats(XAxiPmon_Sampler *SamplerPtr,
+		const XAxiPmon_Sample *SamplePtr, u8 Slot,
+		XAxiPmon_SlotStats *StatsPtr);
+
+s32 XAxiPmon_SamplerAggregate(XAxiPmon_Sampler *SamplerList[],
+		u32 NumSamplers, u8 Slot, XAxiPmon_SlotStats *StatsPtr);
+
 /**
  * Functions in xaxipmon_selftest.c
  */
@@ -0,0 +1,583 @@
+/******************************************************************************
+* Copyright (C) 2012 - 2020 Xilinx, Inc.  All rights reserved.
+* SPDX-License-Identifier: MIT
+******************************************************************************/
+
+/****************************************************************************/
+/**
+*
+* @file xaxipmon_sampler.c
+* @addtogroup axipmon_v6_9
+* @{
+*
+* This file contains a continuous sampler for the XAxiPmon driver. The sample
+* interval counter of an Advanced mode monitor is run with metric counter
+* reset on lapse, so every lapse leaves the counts of one interval in the
+* sampled metric counters. XAxiPmon_SamplerIntrHandler() copies them into a
+* ring together with the Global Clock Counter, and the statistics functions
+* turn a sample into bandwidth, average latency and average outstanding
+* transactions using integer and fixed point arithmetic only.
+*
+* See xaxipmon.h for more information.
+*
+*****************************************************************************/
+
+/***************************** Include Files ********************************/
+
+#include "xaxipmon.h"
+
+/************************** Constant Definitions ****************************/
+
+/**************************** Type Definitions ******************************/
+
+/**
+ * Raw totals the slot statistics are derived from. All fields add up over
+ * slots and monitors.
+ */
+typedef struct {
+	u64 WrBandwidth;	/**< Write bytes per second */
+	u64 RdBandwidth;	/**< Read bytes per second */
+	u64 WrOutstanding;	/**< Outstanding writes, fixed point */
+	u64 RdOutstanding;	/**< Outstanding reads, fixed point */
+	u64 WrTransactions;	/**< Write transaction count */
+	u64 RdTransactions;	/**< Read transaction count */
+	u64 WrLatency;		/**< Total write latency in clock cycles */
+	u64 RdLatency;		/**< Total read latency in clock cycles */
+} XAxiPmon_SlotAccum;
+
+/***************** Macros (Inline Functions) Definitions ********************/
+
+/************************** Function Prototypes *****************************/
+
+static void XAxiPmon_SamplerAccumulate(const XAxiPmon_Sampler *SamplerPtr,
+		const XAxiPmon_Sample *SamplePtr, u8 Slot,
+		XAxiPmon_SlotAccum *AccumPtr);
+static void XAxiPmon_SamplerFinish(const XAxiPmon_SlotAccum *AccumPtr,
+		XAxiPmon_SlotStats *StatsPtr);
+static u32 XAxiPmon_SamplerClamp(u64 Value);
+static u64 XAxiPmon_SamplerScale(u64 Value, u32 Mul, u32 Div);
+
+/************************** Variable Definitions ****************************/
+
+/****************************************************************************/
+/**
+*
+* This function initializes a sampler for an initialized XAxiPmon instance.
+*
+* @param	SamplerPtr is a pointer to the XAxiPmon_Sampler instance.
+* @param	InstancePtr is a pointer to the XAxiPmon instance to sample.
+* @param	RingPtr is the sample ring, RingSize entries long.
+* @param	RingSize is the number of ring entries, a power of 2.
+* @param	ClkFreqHz is the frequency of the monitor clock in Hz, used
+*		for the bandwidth statistics.
+*
+* @return
+*		- XST_SUCCESS if successful.
+*		- XST_FAILURE if the monitor is not in Advanced mode or has no
+*		  sampled metric counters.
+*
+* @note		None.
+*
+*****************************************************************************/
+s32 XAxiPmon_SamplerInitialize(XAxiPmon_Sampler *SamplerPtr,
+		XAxiPmon *InstancePtr, XAxiPmon_Sample *RingPtr,
+		u32 RingSize, u32 ClkFreqHz)
+{
+	/*
+	 * Assert the arguments.
+	 */
+	Xil_AssertNonvoid(SamplerPtr != NULL);
+	Xil_AssertNonvoid(InstancePtr != NULL);
+	Xil_AssertNonvoid(InstancePtr->IsReady == XIL_COMPONENT_IS_READY);
+	Xil_AssertNonvoid(RingPtr != NULL);
+	Xil_AssertNonvoid((RingSize != 0U) &&
+			((RingSize & (RingSize - 1U)) == 0U));
+	Xil_AssertNonvoid(ClkFreqHz != 0U);
+
+	if ((InstancePtr->Mode != XAPM_MODE_ADVANCED) ||
+		(InstancePtr->Config.HaveSampledCounters != 1U) ||
+		(InstancePtr->Config.IsEventCount != 1U)) {
+		return XST_FAILURE;
+	}
+
+	SamplerPtr->PmonPtr = InstancePtr;
+	SamplerPtr->RingPtr = RingPtr;
+	SamplerPtr->RingSize = RingSize;
+	SamplerPtr->Head = 0U;
+	SamplerPtr->Tail = 0U;
+	SamplerPtr->Dropped = 0U;
+	SamplerPtr->ClkFreqHz = ClkFreqHz;
+	SamplerPtr->SampleInterval = 0U;
+	SamplerPtr->NumCounters = InstancePtr->Config.NumberofCounters;
+	if (SamplerPtr->NumCounters > XAPM_MAX_COUNTERS) {
+		SamplerPtr->NumCounters = (u8)XAPM_MAX_COUNTERS;
+	}
+
+	return XST_SUCCESS;
+}
+
+/****************************************************************************/
+/**
+*
+* This function starts continuous sampling. The metric and slot selected for
+* each counter are recorded for the statistics, the counters are reset and
+* started, and the Sample Interval Counter lapse interrupt is enabled.
+*
+* @param	SamplerPtr is a pointer to the XAxiPmon_Sampler instance.
+* @param	SampleInterval is the sample interval in clock cycles.
+*
+* @return	XST_SUCCESS
+*
+* @note		Metrics must be set up with XAxiPmon_SetMetrics() before
+*		calling this function. XAxiPmon_SamplerIntrHandler() must be
+*		connected to the monitor interrupt with SamplerPtr as its
+*		callback reference.
+*
+*****************************************************************************/
+s32 XAxiPmon_SamplerStart(XAxiPmon_Sampler *SamplerPtr, u32 SampleInterval)
+{
+	XAxiPmon *InstancePtr;
+	u8 Index;
+
+	/*
+	 * Assert the arguments.
+	 */
+	Xil_AssertNonvoid(SamplerPtr != NULL);
+	Xil_AssertNonvoid(SamplerPtr->PmonPtr != NULL);
+	Xil_AssertNonvoid(SampleInterval != 0U);
+
+	InstancePtr = SamplerPtr->PmonPtr;
+
+	for (Index = 0U; Index < SamplerPtr->NumCounters; Index++) {
+		(void)XAxiPmon_GetMetrics(InstancePtr, Index,
+				&SamplerPtr->Metric[Index],
+				&SamplerPtr->Slot[Index]);
+	}
+
+	SamplerPtr->SampleInterval = SampleInterval;
+	SamplerPtr->Head = 0U;
+	SamplerPtr->Tail = 0U;
+	SamplerPtr->Dropped = 0U;
+
+	(void)XAxiPmon_ResetMetricCounter(InstancePtr);
+	(void)XAxiPmon_StartCounters(InstancePtr, SampleInterval);
+
+	/*
+	 * Reset the metric counters at every lapse so that each snapshot
+	 * holds the counts of exactly one interval.
+	 */
+	XAxiPmon_WriteReg(InstancePtr->Config.BaseAddress, XAPM_SICR_OFFSET,
+			XAPM_SICR_ENABLE_MASK | XAPM_SICR_MCNTR_RST_MASK);
+
+	XAxiPmon_WriteReg(InstancePtr->Config.BaseAddress, XAPM_IS_OFFSET,
+			XAPM_IXR_SIC_OVERFLOW_MASK);
+	XAxiPmon_IntrEnable(InstancePtr, XAPM_IXR_SIC_OVERFLOW_MASK);
+	XAxiPmon_IntrGlobalEnable(InstancePtr);
+
+	return XST_SUCCESS;
+}
+
+/****************************************************************************/
+/**
+*
+* This function stops continuous sampling. Samples already in the ring can
+* still be read.
+*
+* @param	SamplerPtr is a pointer to the XAxiPmon_Sampler instance.
+*
+* @return	None.
+*
+* @note		None.
+*
+*****************************************************************************/
+void XAxiPmon_SamplerStop(XAxiPmon_Sampler *SamplerPtr)
+{
+	XAxiPmon *InstancePtr;
+	u32 RegValue;
+
+	/*
+	 * Assert the arguments.
+	 */
+	Xil_AssertVoid(SamplerPtr != NULL);
+	Xil_AssertVoid(SamplerPtr->PmonPtr != NULL);
+
+	InstancePtr = SamplerPtr->PmonPtr;
+
+	RegValue = XAxiPmon_ReadReg(InstancePtr->Config.BaseAddress,
+			XAPM_IE_OFFSET);
+	XAxiPmon_WriteReg(InstancePtr->Config.BaseAddress, XAPM_IE_OFFSET,
+			RegValue & ~XAPM_IXR_SIC_OVERFLOW_MASK);
+
+	XAxiPmon_DisableSampleIntervalCounter(InstancePtr);
+	(void)XAxiPmon_StopCounters(InstancePtr);
+}
+
+/****************************************************************************/
+/**
+*
+* This function is the interrupt handler of the sampler. On a Sample Interval
+* Counter lapse it stores the Global Clock Counter and the sampled metric
+* counters in the next ring entry. The snapshot is dropped and counted in
+* Dropped when the ring is full.
+*
+* @param	CallBackRef is a pointer to the XAxiPmon_Sampler instance.
+*
+* @return	None.
+*
+* @note		None.
+*
+*****************************************************************************/
+void XAxiPmon_SamplerIntrHandler(void *CallBackRef)
+{
+	XAxiPmon_Sampler *SamplerPtr = (XAxiPmon_Sampler *)CallBackRef;
+	XAxiPmon *InstancePtr;
+	XAxiPmon_Sample *SamplePtr;
+	u32 IntrStatus;
+	u32 CntHighValue;
+	u32 CntLowValue;
+	u32 Index;
+
+	Xil_AssertVoid(SamplerPtr != NULL);
+	Xil_AssertVoid(SamplerPtr->PmonPtr != NULL);
+
+	InstancePtr = SamplerPtr->PmonPtr;
+
+	IntrStatus = XAxiPmon_IntrGetStatus(InstancePtr);
+	if ((IntrStatus & XAPM_IXR_SIC_OVERFLOW_MASK) == 0U) {
+		return;
+	}
+
+	/*
+	 * Acknowledge the lapse only, other pending interrupts are left to
+	 * the application.
+	 */
+	XAxiPmon_WriteReg(InstancePtr->Config.BaseAddress, XAPM_IS_OFFSET,
+			XAPM_IXR_SIC_OVERFLOW_MASK);
+
+	if ((SamplerPtr->Head - SamplerPtr->Tail) == SamplerPtr->RingSize) {
+		SamplerPtr->Dropped++;
+		return;
+	}
+
+	SamplePtr = &SamplerPtr->RingPtr[SamplerPtr->Head &
+					(SamplerPtr->RingSize - 1U)];
+
+	XAxiPmon_GetGlobalClkCounter(InstancePtr, &CntHighValue, &CntLowValue);
+	SamplePtr->Timestamp = ((u64)CntHighValue << 32U) | (u64)CntLowValue;
+	SamplePtr->Interval = SamplerPtr->SampleInterval;
+
+	for (Index = 0U; Index < SamplerPtr->NumCounters; Index++) {
+		SamplePtr->Counter[Index] = XAxiPmon_ReadReg(
+				InstancePtr->Config.BaseAddress,
+				((u32)XAPM_SMC0_OFFSET + (Index * (u32)16)));
+	}
+
+	SamplerPtr->Head++;
+}
+
+/****************************************************************************/
+/**
+*
+* This function removes the oldest sample from the ring.
+*
+* @param	SamplerPtr is a pointer to the XAxiPmon_Sampler instance.
+* @param	SamplePtr is a pointer to where the sample is copied.
+*
+* @return
+*		- XST_SUCCESS if a sample was copied.
+*		- XST_NO_DATA if the ring is empty.
+*
+* @note		None.
+*
+*****************************************************************************/
+s32 XAxiPmon_SamplerRead(XAxiPmon_Sampler *SamplerPtr,
+		XAxiPmon_Sample *SamplePtr)
+{
+	/*
+	 * Assert the arguments.
+	 */
+	Xil_AssertNonvoid(SamplerPtr != NULL);
+	Xil_AssertNonvoid(SamplePtr != NULL);
+
+	if (SamplerPtr->Head == SamplerPtr->Tail) {
+		return XST_NO_DATA;
+	}
+
+	*SamplePtr = SamplerPtr->RingPtr[SamplerPtr->Tail &
+					(SamplerPtr->RingSize - 1U)];
+	SamplerPtr->Tail++;
+
+	return XST_SUCCESS;
+}
+
+/****************************************************************************/
+/**
+*
+* This function derives the statistics of a slot from one sample.
+*
+* @param	SamplerPtr is a pointer to the XAxiPmon_Sampler instance the
+*		sample was read from.
+* @param	SamplePtr is a pointer to the sample.
+* @param	Slot is the monitor slot, or XAPM_SAMPLER_ALL_SLOTS to combine
+*		all slots.
+* @param	StatsPtr is a pointer to where the statistics are returned.
+*
+* @return	None.
+*
+* @note		None.
+*
+*****************************************************************************/
+void XAxiPmon_SamplerGetSlotStats(XAxiPmon_Sampler *SamplerPtr,
+		const XAxiPmon_Sample *SamplePtr, u8 Slot,
+		XAxiPmon_SlotStats *StatsPtr)
+{
+	XAxiPmon_SlotAccum Accum = {0};
+
+	/*
+	 * Assert the arguments.
+	 */
+	Xil_AssertVoid(SamplerPtr != NULL);
+	Xil_AssertVoid(SamplePtr != NULL);
+	Xil_AssertVoid(StatsPtr != NULL);
+
+	XAxiPmon_SamplerAccumulate(SamplerPtr, SamplePtr, Slot, &Accum);
+	XAxiPmon_SamplerFinish(&Accum, StatsPtr);
+}
+
+/****************************************************************************/
+/**
+*
+* This function removes the oldest sample from each of several samplers and
+* combines them into one set of statistics. Bandwidth, transactions and
+* outstanding transactions are summed, latencies are averaged over all
+* transactions.
+*
+* @param	SamplerList is an array of pointers to sampler instances.
+* @param	NumSamplers is the number of entries in SamplerList.
+* @param	Slot is the monitor slot, or XAPM_SAMPLER_ALL_SLOTS to combine
+*		all slots.
+* @param	StatsPtr is a pointer to where the statistics are returned.
+*
+* @return
+*		- XST_SUCCESS if the statistics were computed.
+*		- XST_NO_DATA if the ring of any sampler is empty. No sample
+*		  is removed in this case.
+*
+* @note		None.
+*
+*****************************************************************************/
+s32 XAxiPmon_SamplerAggregate(XAxiPmon_Sampler *SamplerList[],
+		u32 NumSamplers, u8 Slot, XAxiPmon_SlotStats *StatsPtr)
+{
+	XAxiPmon_SlotAccum Accum = {0};
+	XAxiPmon_Sample Sample;
+	u32 Index;
+
+	/*
+	 * Assert the arguments.
+	 */
+	Xil_AssertNonvoid(SamplerList != NULL);
+	Xil_AssertNonvoid(NumSamplers != 0U);
+	Xil_AssertNonvoid(StatsPtr != NULL);
+
+	for (Index = 0U; Index < NumSamplers; Index++) {
+		Xil_AssertNonvoid(SamplerList[Index] != NULL);
+		if (SamplerList[Index]->Head == SamplerList[Index]->Tail) {
+			return XST_NO_DATA;
+		}
+	}
+
+	for (Index = 0U; Index < NumSamplers; Index++) {
+		(void)XAxiPmon_SamplerRead(SamplerList[Index], &Sample);
+		XAxiPmon_SamplerAccumulate(SamplerList[Index], &Sample, Slot,
+				&Accum);
+	}
+
+	XAxiPmon_SamplerFinish(&Accum, StatsPtr);
+
+	return XST_SUCCESS;
+}
+
+/****************************************************************************/
+/**
+*
+* This function adds the counts of one sample to the raw totals. Counters
+* whose metric is not used by the statistics, or which monitor another slot,
+* are skipped.
+*
+* @param	SamplerPtr is a pointer to the XAxiPmon_Sampler instance.
+* @param	SamplePtr is a pointer to the sample.
+* @param	Slot is the monitor slot or XAPM_SAMPLER_ALL_SLOTS.
+* @param	AccumPtr is a pointer to the raw totals.
+*
+* @return	None.
+*
+* @note		None.
+*
+*****************************************************************************/
+static void XAxiPmon_SamplerAccumulate(const XAxiPmon_Sampler *SamplerPtr,
+		const XAxiPmon_Sample *SamplePtr, u8 Slot,
+		XAxiPmon_SlotAccum *AccumPtr)
+{
+	u64 WrBytes = 0U;
+	u64 RdBytes = 0U;
+	u64 WrLatency = 0U;
+	u64 RdLatency = 0U;
+	u64 Bandwidth;
+	u32 Interval;
+	u32 Index;
+
+	Interval = (SamplePtr->Interval != 0U) ? SamplePtr->Interval : 1U;
+
+	for (Index = 0U; Index < SamplerPtr->NumCounters; Index++) {
+		if ((Slot != XAPM_SAMPLER_ALL_SLOTS) &&
+			(SamplerPtr->Slot[Index] != Slot)) {
+			continue;
+		}
+
+		switch (SamplerPtr->Metric[Index]) {
+		case XAPM_METRIC_SET_0:
+			AccumPtr->WrTransactions += SamplePtr->Counter[Index];
+			break;
+		case XAPM_METRIC_SET_1:
+			AccumPtr->RdTransactions += SamplePtr->Counter[Index];
+			break;
+		case XAPM_METRIC_SET_2:
+			WrBytes += SamplePtr->Counter[Index];
+			break;
+		case XAPM_METRIC_SET_3:
+			RdBytes += SamplePtr->Counter[Index];
+			break;
+		case XAPM_METRIC_SET_5:
+			RdLatency += SamplePtr->Counter[Index];
+			break;
+		case XAPM_METRIC_SET_6:
+			WrLatency += SamplePtr->Counter[Index];
+			break;
+		default:
+			break;
+		}
+	}
+
+	/* Bandwidth saturates instead of wrapping */
+	Bandwidth = XAxiPmon_SamplerScale(WrBytes, SamplerPtr->ClkFreqHz,
+					Interval);
+	AccumPtr->WrBandwidth += Bandwidth;
+	if (AccumPtr->WrBandwidth < Bandwidth) {
+		AccumPtr->WrBandwidth = 0xFFFFFFFFFFFFFFFFU;
+	}
+	Bandwidth = XAxiPmon_SamplerScale(RdBytes, SamplerPtr->ClkFreqHz,
+					Interval);
+	AccumPtr->RdBandwidth += Bandwidth;
+	if (AccumPtr->RdBandwidth < Bandwidth) {
+		AccumPtr->RdBandwidth = 0xFFFFFFFFFFFFFFFFU;
+	}
+
+	/*
+	 * By Little's law the average number of outstanding transactions is
+	 * the total latency divided by the interval length.
+	 */
+	AccumPtr->WrOutstanding += (WrLatency << XAPM_SAMPLER_FRAC_BITS) /
+					Interval;
+	AccumPtr->RdOutstanding += (RdLatency << XAPM_SAMPLER_FRAC_BITS) /
+					Interval;
+	AccumPtr->WrLatency += WrLatency;
+	AccumPtr->RdLatency += RdLatency;
+}
+
+/****************************************************************************/
+/**
+*
+* This function converts raw totals into slot statistics.
+*
+* @param	AccumPtr is a pointer to the raw totals.
+* @param	StatsPtr is a pointer to where the statistics are returned.
+*
+* @return	None.
+*
+* @note		None.
+*
+*****************************************************************************/
+static void XAxiPmon_SamplerFinish(const XAxiPmon_SlotAccum *AccumPtr,
+		XAxiPmon_SlotStats *StatsPtr)
+{
+	StatsPtr->WrBandwidth = AccumPtr->WrBandwidth;
+	StatsPtr->RdBandwidth = AccumPtr->RdBandwidth;
+	StatsPtr->WrTransactions = XAxiPmon_SamplerClamp(
+					AccumPtr->WrTransactions);
+	StatsPtr->RdTransactions = XAxiPmon_SamplerClamp(
+					AccumPtr->RdTransactions);
+	StatsPtr->WrOutstanding = XAxiPmon_SamplerClamp(
+					AccumPtr->WrOutstanding);
+	StatsPtr->RdOutstanding = XAxiPmon_SamplerClamp(
+					AccumPtr->RdOutstanding);
+
+	StatsPtr->WrLatency = 0U;
+	if (AccumPtr->WrTransactions != 0U) {
+		StatsPtr->WrLatency = XAxiPmon_SamplerClamp(
+			(AccumPtr->WrLatency << XAPM_SAMPLER_FRAC_BITS) /
+			AccumPtr->WrTransactions);
+	}
+
+	StatsPtr->RdLatency = 0U;
+	if (AccumPtr->RdTransactions != 0U) {
+		StatsPtr->RdLatency = XAxiPmon_SamplerClamp(
+			(AccumPtr->RdLatency << XAPM_SAMPLER_FRAC_BITS) /
+			AccumPtr->RdTransactions);
+	}
+}
+
+/****************************************************************************/
+/**
+*
+* This function saturates a 64 bit value to 32 bits.
+*
+* @param	Value is the value to saturate.
+*
+* @return	Value, or 0xFFFFFFFF if Value does not fit in 32 bits.
+*
+* @note		None.
+*
+*****************************************************************************/
+static u32 XAxiPmon_SamplerClamp(u64 Value)
+{
+	return (Value > 0xFFFFFFFFU) ? 0xFFFFFFFFU : (u32)Value;
+}
+
+/****************************************************************************/
+/**
+*
+* This function computes Value * Mul / Div rounded down without overflowing
+* the 64 bit intermediate product.
+*
+* @param	Value is the value to scale.
+* @param	Mul is the multiplier.
+* @param	Div is the divisor, not zero.
+*
+* @return	The scaled value, or 0xFFFFFFFFFFFFFFFF if it does not fit in
+*		64 bits.
+*
+* @note		The byte count of an interval times the clock frequency
+*		exceeds 64 bits for byte counts above 4 GB.
+*
+*****************************************************************************/
+static u64 XAxiPmon_SamplerScale(u64 Value, u32 Mul, u32 Div)
+{
+	u64 Quotient = Value / Div;
+	u64 Remainder = Value % Div;
+	u64 Result;
+
+	if ((Mul != 0U) && (Quotient > (0xFFFFFFFFFFFFFFFFU / Mul))) {
+		return 0xFFFFFFFFFFFFFFFFU;
+	}
+	Result = Quotient * Mul;
+
+	/* Remainder < Div, so Remainder * Mul fits in 64 bits */
+	Remainder = (Remainder * Mul) / Div;
+	if (Result > (0xFFFFFFFFFFFFFFFFU - Remainder)) {
+		return 0xFFFFFFFFFFFFFFFFU;
+	}
+
+	return Result + Remainder;
+}
+/** @} */
@@ -0,0 +1,518 @@
+/******************************************************************************
+* Copyright (C) 2020 Xilinx, Inc.  All rights reserved.
+* SPDX-License-Identifier: MIT
+******************************************************************************/
+
+/*****************************************************************************/
+/**
+*
+* @file test_xaxipmon_sampler.c
+*
+* Host test of the continuous sampler. The driver is built against a register
+* model of an Advanced mode monitor with a write one to clear Interrupt Status
+* Register. The test checks the registers programmed by start and stop, the
+* snapshots taken by the interrupt handler and the ring overflow, and
+* compares the fixed point slot statistics against a 128 bit reference over
+* random and extreme counter values.
+*
+* Build and run on the host:
+*   cc -Wall -O2 -I../src -I../../../../lib/bsp/standalone/src/common \
+*      test_xaxipmon_sampler.c -o test_xaxipmon_sampler
+*   ./test_xaxipmon_sampler
+*
+******************************************************************************/
+
+/***************************** Include Files *********************************/
+
+#include <stdio.h>
+#include <string.h>
+
+/* Build the standalone (non Linux) flavour of the driver */
+#undef __linux__
+#include "xil_types.h"
+
+/* Register accesses go to the model below */
+#define XIL_IO_H
+static u32 Xil_In32(UINTPTR Addr);
+static void Xil_Out32(UINTPTR Addr, u32 Value);
+
+#include "xaxipmon.c"
+#include "xaxipmon_sampler.c"
+
+/************************** Model ********************************************/
+
+#define APM_BASE		0x43C00000U
+#define APM_SPAN		0x400U
+#define RING_SIZE		4U
+#define NUM_SAMPLERS		3U
+#define U64_MAX_VAL		0xFFFFFFFFFFFFFFFFULL
+
+typedef unsigned __int128 u128;
+
+static struct {
+	u32 Reg[APM_SPAN / 4U];
+	u32 IsWrites;		/* Writes to the Interrupt Status Register */
+} Model;
+
+static u32 Xil_In32(UINTPTR Addr)
+{
+	return Model.Reg[(Addr - APM_BASE) / 4U];
+}
+
+static void Xil_Out32(UINTPTR Addr, u32 Value)
+{
+	u32 Offset = (u32)(Addr - APM_BASE);
+
+	if (Offset == XAPM_IS_OFFSET) {
+		/* Write one to clear */
+		Model.Reg[Offset / 4U] &= ~Value;
+		Model.IsWrites++;
+	} else {
+		Model.Reg[Offset / 4U] = Value;
+	}
+}
+
+#define REG(Offset)	Model.Reg[(Offset) / 4U]
+
+/************************** Stubs ********************************************/
+
+u32 Xil_AssertStatus;
+s32 Xil_AssertWait;
+static u32 Asserts;
+
+void Xil_Assert(const char8 *File, s32 Line)
+{
+	printf("ASSERT %s:%d\n", File, (int)Line);
+	Asserts++;
+}
+
+/************************** Test Helpers *************************************/
+
+static u32 Failures;
+
+#define CHECK(Cond, Msg) \
+	do { \
+		if (!(Cond)) { \
+			printf("FAIL line %d: %s\n", __LINE__, Msg); \
+			Failures++; \
+		} \
+	} while (0)
+
+static u64 RandState = 0x9E3779B97F4A7C15ULL;
+
+static u64 Rand64(void)
+{
+	RandState ^= RandState << 13;
+	RandState ^= RandState >> 7;
+	RandState ^= RandState << 17;
+	return RandState;
+}
+
+/* Mostly small values with a fair share of the extremes */
+static u32 RandCount(void)
+{
+	switch (Rand64() % 6U) {
+		case 0:
+			return 0U;
+		case 1:
+			return 0xFFFFFFFFU;
+		case 2:
+			return (u32)(Rand64() % 16U);
+		default:
+			return (u32)Rand64();
+	}
+}
+
+static void ApmInit(XAxiPmon *ApmPtr)
+{
+	memset(&Model, 0, sizeof(Model));
+	memset(ApmPtr, 0, sizeof(*ApmPtr));
+	ApmPtr->Config.BaseAddress = APM_BASE;
+	ApmPtr->Config.GlobalClkCounterWidth = 64;
+	ApmPtr->Config.IsEventCount = 1U;
+	ApmPtr->Config.NumberofSlots = 8U;
+	ApmPtr->Config.NumberofCounters = XAPM_MAX_COUNTERS;
+	ApmPtr->Config.HaveSampledCounters = 1U;
+	ApmPtr->Config.ModeAdvanced = 1U;
+	ApmPtr->IsReady = XIL_COMPONENT_IS_READY;
+	ApmPtr->Mode = XAPM_MODE_ADVANCED;
+}
+
+/************************** Register Tests ***********************************/
+
+static void TestInitialize(void)
+{
+	XAxiPmon Apm;
+	XAxiPmon_Sampler Sampler;
+	XAxiPmon_Sample Ring[RING_SIZE];
+
+	ApmInit(&Apm);
+	Apm.Mode = XAPM_MODE_PROFILE;
+	CHECK(XAxiPmon_SamplerInitialize(&Sampler, &Apm, Ring, RING_SIZE,
+			100000000U) == XST_FAILURE, "profile mode accepted");
+
+	ApmInit(&Apm);
+	Apm.Config.HaveSampledCounters = 0U;
+	CHECK(XAxiPmon_SamplerInitialize(&Sampler, &Apm, Ring, RING_SIZE,
+			100000000U) == XST_FAILURE,
+			"monitor without sampled counters accepted");
+
+	ApmInit(&Apm);
+	Apm.Config.NumberofCounters = 4U;
+	CHECK(XAxiPmon_SamplerInitialize(&Sampler, &Apm, Ring, RING_SIZE,
+			100000000U) == XST_SUCCESS, "initialize failed");
+	CHECK(Sampler.NumCounters == 4U, "counter count not taken over");
+}
+
+static void TestStartStop(void)
+{
+	XAxiPmon Apm;
+	XAxiPmon_Sampler Sampler;
+	XAxiPmon_Sample Ring[RING_SIZE];
+	u8 Index;
+
+	ApmInit(&Apm);
+	(void)XAxiPmon_SamplerInitialize(&Sampler, &Apm, Ring, RING_SIZE,
+			100000000U);
+	for (Index = 0U; Index < XAPM_MAX_COUNTERS; Index++) {
+		(void)XAxiPmon_SetMetrics(&Apm, (u8)(Index % 8U),
+				(u8)(Index % 7U), Index);
+	}
+
+	/* A stale lapse and an application owned interrupt are pending */
+	REG(XAPM_IS_OFFSET) = XAPM_IXR_SIC_OVERFLOW_MASK |
+				XAPM_IXR_GCC_OVERFLOW_MASK;
+	REG(XAPM_IE_OFFSET) = XAPM_IXR_MC0_OVERFLOW_MASK;
+
+	CHECK(XAxiPmon_SamplerStart(&Sampler, 5000U) == XST_SUCCESS,
+			"start failed");
+	for (Index = 0U; Index < XAPM_MAX_COUNTERS; Index++) {
+		CHECK(Sampler.Slot[Index] == (Index % 8U), "slot not recorded");
+		CHECK(Sampler.Metric[Index] == (Index % 7U),
+				"metric not recorded");
+	}
+	CHECK(REG(XAPM_SI_LOW_OFFSET) == 5000U, "sample interval not set");
+	CHECK(REG(XAPM_SICR_OFFSET) ==
+		(XAPM_SICR_ENABLE_MASK | XAPM_SICR_MCNTR_RST_MASK),
+		"counters not reset at lapse");
+	CHECK((REG(XAPM_CTL_OFFSET) & (XAPM_CR_MCNTR_ENABLE_MASK |
+		XAPM_CR_GCC_ENABLE_MASK)) ==
+		(XAPM_CR_MCNTR_ENABLE_MASK | XAPM_CR_GCC_ENABLE_MASK),
+		"counters not enabled");
+	CHECK(REG(XAPM_IS_OFFSET) == XAPM_IXR_GCC_OVERFLOW_MASK,
+		"stale lapse not cleared or other interrupt cleared");
+	CHECK(REG(XAPM_IE_OFFSET) == (XAPM_IXR_MC0_OVERFLOW_MASK |
+		XAPM_IXR_SIC_OVERFLOW_MASK), "lapse interrupt not enabled");
+	CHECK(REG(XAPM_GIE_OFFSET) == 1U, "interrupts not globally enabled");
+
+	XAxiPmon_SamplerStop(&Sampler);
+	CHECK(REG(XAPM_IE_OFFSET) == XAPM_IXR_MC0_OVERFLOW_MASK,
+		"stop changed other interrupt enables");
+	CHECK((REG(XAPM_SICR_OFFSET) & XAPM_SICR_ENABLE_MASK) == 0U,
+		"sample interval counter still running");
+	CHECK((REG(XAPM_CTL_OFFSET) & XAPM_CR_MCNTR_ENABLE_MASK) == 0U,
+		"metric counters still running");
+}
+
+static void Lapse(u32 Seed)
+{
+	u32 Index;
+
+	REG(XAPM_GCC_HIGH_OFFSET) = Seed;
+	REG(XAPM_GCC_LOW_OFFSET) = ~Seed;
+	for (Index = 0U; Index < XAPM_MAX_COUNTERS; Index++) {
+		REG(XAPM_SMC0_OFFSET + (Index * 16U)) = (Seed * 100U) + Index;
+	}
+	REG(XAPM_IS_OFFSET) |= XAPM_IXR_SIC_OVERFLOW_MASK;
+}
+
+static void TestHandler(void)
+{
+	XAxiPmon Apm;
+	XAxiPmon_Sampler Sampler;
+	XAxiPmon_Sample Ring[RING_SIZE];
+	XAxiPmon_Sample Sample;
+	u32 Seed;
+	u32 Index;
+	int Ok;
+
+	ApmInit(&Apm);
+	(void)XAxiPmon_SamplerInitialize(&Sampler, &Apm, Ring, RING_SIZE,
+			100000000U);
+	(void)XAxiPmon_SamplerStart(&Sampler, 1000U);
+
+	/* Shared interrupt line, another source */
+	REG(XAPM_IS_OFFSET) = XAPM_IXR_GCC_OVERFLOW_MASK;
+	Model.IsWrites = 0U;
+	XAxiPmon_SamplerIntrHandler(&Sampler);
+	CHECK(Sampler.Head == 0U, "sample taken without a lapse");
+	CHECK(Model.IsWrites == 0U, "status written without a lapse");
+
+	/* One more lapse than the ring holds */
+	for (Seed = 1U; Seed <= RING_SIZE + 1U; Seed++) {
+		Lapse(Seed);
+		XAxiPmon_SamplerIntrHandler(&Sampler);
+		CHECK(REG(XAPM_IS_OFFSET) == XAPM_IXR_GCC_OVERFLOW_MASK,
+			"lapse not acknowledged or other interrupt cleared");
+	}
+	CHECK(Sampler.Dropped == 1U, "full ring not counted");
+
+	for (Seed = 1U; Seed <= RING_SIZE; Seed++) {
+		CHECK(XAxiPmon_SamplerRead(&Sampler, &Sample) == XST_SUCCESS,
+			"sample missing");
+		CHECK(Sample.Timestamp ==
+			(((u64)Seed << 32) | (u64)(u32)~Seed),
+			"wrong timestamp");
+		CHECK(Sample.Interval == 1000U, "wrong interval");
+		Ok = 1;
+		for (Index = 0U; Index < XAPM_MAX_COUNTERS; Index++) {
+			Ok &= (Sample.Counter[Index] == (Seed * 100U) + Index);
+		}
+		CHECK(Ok, "wrong sampled counters");
+	}
+	CHECK(XAxiPmon_SamplerRead(&Sampler, &Sample) == XST_NO_DATA,
+		"ring not empty");
+
+	/* The ring accepts samples again once drained */
+	Lapse(9U);
+	XAxiPmon_SamplerIntrHandler(&Sampler);
+	CHECK(XAxiPmon_SamplerRead(&Sampler, &Sample) == XST_SUCCESS,
+		"sample after drain missing");
+	CHECK(Sample.Counter[0] == 900U, "wrong sample after drain");
+}
+
+/************************** Statistics Tests *********************************/
+
+typedef struct {
+	u128 WrBandwidth;
+	u128 RdBandwidth;
+	u128 WrOutstanding;
+	u128 RdOutstanding;
+	u128 WrTransactions;
+	u128 RdTransactions;
+	u128 WrLatency;
+	u128 RdLatency;
+} RefAccum;
+
+static u128 Sat64(u128 Value)
+{
+	return (Value > U64_MAX_VAL) ? U64_MAX_VAL : Value;
+}
+
+static u32 Sat32(u128 Value)
+{
+	return (Value > 0xFFFFFFFFU) ? 0xFFFFFFFFU : (u32)Value;
+}
+
+static void RefAdd(const XAxiPmon_Sampler *SamplerPtr,
+		const XAxiPmon_Sample *SamplePtr, u8 Slot, RefAccum *AccPtr)
+{
+	u128 Bytes[2] = { 0, 0 };
+	u128 Lat[2] = { 0, 0 };
+	u128 Interval = SamplePtr->Interval ? SamplePtr->Interval : 1U;
+	u32 Index;
+
+	for (Index = 0U; Index < SamplerPtr->NumCounters; Index++) {
+		u128 Value = SamplePtr->Counter[Index];
+
+		if ((Slot != XAPM_SAMPLER_ALL_SLOTS) &&
+			(SamplerPtr->Slot[Index] != Slot)) {
+			continue;
+		}
+		switch (SamplerPtr->Metric[Index]) {
+			case 0: AccPtr->WrTransactions += Value; break;
+			case 1: AccPtr->RdTransactions += Value; break;
+			case 2: Bytes[0] += Value; break;
+			case 3: Bytes[1] += Value; break;
+			case 5: Lat[1] += Value; break;
+			case 6: Lat[0] += Value; break;
+			default: break;
+		}
+	}
+
+	AccPtr->WrBandwidth = Sat64(AccPtr->WrBandwidth +
+		Sat64((Bytes[0] * SamplerPtr->ClkFreqHz) / Interval));
+	AccPtr->RdBandwidth = Sat64(AccPtr->RdBandwidth +
+		Sat64((Bytes[1] * SamplerPtr->ClkFreqHz) / Interval));
+	AccPtr->WrOutstanding += (Lat[0] << 16) / Interval;
+	AccPtr->RdOutstanding += (Lat[1] << 16) / Interval;
+	AccPtr->WrLatency += Lat[0];
+	AccPtr->RdLatency += Lat[1];
+}
+
+static int RefMatch(const RefAccum *AccPtr, const XAxiPmon_SlotStats *Stats)
+{
+	u32 WrLatency = 0U;
+	u32 RdLatency = 0U;
+
+	if (AccPtr->WrTransactions != 0U) {
+		WrLatency = Sat32((AccPtr->WrLatency << 16) /
+				AccPtr->WrTransactions);
+	}
+	if (AccPtr->RdTransactions != 0U) {
+		RdLatency = Sat32((AccPtr->RdLatency << 16) /
+				AccPtr->RdTransactions);
+	}
+
+	return (Stats->WrBandwidth == (u64)AccPtr->WrBandwidth) &&
+		(Stats->RdBandwidth == (u64)AccPtr->RdBandwidth) &&
+		(Stats->WrTransactions == Sat32(AccPtr->WrTransactions)) &&
+		(Stats->RdTransactions == Sat32(AccPtr->RdTransactions)) &&
+		(Stats->WrOutstanding == Sat32(AccPtr->WrOutstanding)) &&
+		(Stats->RdOutstanding == Sat32(AccPtr->RdOutstanding)) &&
+		(Stats->WrLatency == WrLatency) &&
+		(Stats->RdLatency == RdLatency);
+}
+
+static void RandomSampler(XAxiPmon_Sampler *SamplerPtr,
+		XAxiPmon_Sample *RingPtr)
+{
+	u32 Index;
+
+	memset(SamplerPtr, 0, sizeof(*SamplerPtr));
+	SamplerPtr->RingPtr = RingPtr;
+	SamplerPtr->RingSize = RING_SIZE;
+	SamplerPtr->NumCounters = (u8)(1U + (Rand64() % XAPM_MAX_COUNTERS));
+	switch (Rand64() % 3U) {
+		case 0:
+			SamplerPtr->ClkFreqHz = 0xFFFFFFFFU;
+			break;
+		case 1:
+			SamplerPtr->ClkFreqHz = 100000000U;
+			break;
+		default:
+			SamplerPtr->ClkFreqHz = 1U + (u32)(Rand64() % 0xFFFFFFFFU);
+			break;
+	}
+	for (Index = 0U; Index < XAPM_MAX_COUNTERS; Index++) {
+		SamplerPtr->Metric[Index] = (u8)(Rand64() % 8U);
+		SamplerPtr->Slot[Index] = (u8)(Rand64() % 3U);
+	}
+}
+
+static void RandomSample(XAxiPmon_Sample *SamplePtr)
+{
+	u32 Index;
+
+	switch (Rand64() % 4U) {
+		case 0:
+			SamplePtr->Interval = 0U;
+			break;
+		case 1:
+			SamplePtr->Interval = 1U;
+			break;
+		default:
+			SamplePtr->Interval = RandCount();
+			break;
+	}
+	for (Index = 0U; Index < XAPM_MAX_COUNTERS; Index++) {
+		SamplePtr->Counter[Index] = RandCount();
+	}
+}
+
+static void TestSlotStats(void)
+{
+	XAxiPmon_Sampler Sampler;
+	XAxiPmon_Sample Ring[RING_SIZE];
+	XAxiPmon_Sample Sample;
+	XAxiPmon_SlotStats Stats;
+	RefAccum Ref;
+	u32 Iter;
+	u32 Mismatch = 0U;
+	u8 Slot;
+
+	for (Iter = 0U; Iter < 200000U; Iter++) {
+		RandomSampler(&Sampler, Ring);
+		RandomSample(&Sample);
+		Slot = (Iter & 3U) == 3U ? XAPM_SAMPLER_ALL_SLOTS : (u8)(Iter & 3U);
+
+		memset(&Ref, 0, sizeof(Ref));
+		RefAdd(&Sampler, &Sample, Slot, &Ref);
+		XAxiPmon_SamplerGetSlotStats(&Sampler, &Sample, Slot, &Stats);
+		Mismatch += RefMatch(&Ref, &Stats) ? 0U : 1U;
+	}
+	CHECK(Mismatch == 0U, "slot statistics differ from the reference");
+
+	/* Every counter at its maximum over one cycle at the top frequency */
+	memset(&Sampler, 0, sizeof(Sampler));
+	Sampler.NumCounters = XAPM_MAX_COUNTERS;
+	Sampler.ClkFreqHz = 0xFFFFFFFFU;
+	for (Iter = 0U; Iter < XAPM_MAX_COUNTERS; Iter++) {
+		Sampler.Metric[Iter] = (Iter < 5U) ? XAPM_METRIC_SET_2 :
+						XAPM_METRIC_SET_3;
+		Sample.Counter[Iter] = 0xFFFFFFFFU;
+	}
+	Sample.Interval = 1U;
+	XAxiPmon_SamplerGetSlotStats(&Sampler, &Sample,
+			XAPM_SAMPLER_ALL_SLOTS, &Stats);
+	CHECK(Stats.WrBandwidth == U64_MAX_VAL, "bandwidth not saturated");
+	CHECK(Stats.WrTransactions == 0U, "transactions without a counter");
+	CHECK(Stats.WrLatency == 0U, "latency without transactions");
+
+	/* 8 GB over a second at 1 GHz overflows a plain 64 bit product */
+	Sampler.ClkFreqHz = 1000000000U;
+	Sample.Interval = 1000000000U;
+	XAxiPmon_SamplerGetSlotStats(&Sampler, &Sample,
+			XAPM_SAMPLER_ALL_SLOTS, &Stats);
+	CHECK(Stats.WrBandwidth == 5ULL * 0xFFFFFFFFULL,
+		"bandwidth of a large byte count wrapped");
+}
+
+static void TestAggregate(void)
+{
+	XAxiPmon_Sampler Samplers[NUM_SAMPLERS];
+	XAxiPmon_Sampler *List[NUM_SAMPLERS];
+	XAxiPmon_Sample Rings[NUM_SAMPLERS][RING_SIZE];
+	XAxiPmon_Sample Sample;
+	XAxiPmon_SlotStats Stats;
+	RefAccum Ref;
+	u32 Iter;
+	u32 Index;
+	u32 Mismatch = 0U;
+	u8 Slot;
+
+	for (Iter = 0U; Iter < 50000U; Iter++) {
+		Slot = (Iter & 3U) == 3U ? XAPM_SAMPLER_ALL_SLOTS : (u8)(Iter & 3U);
+		memset(&Ref, 0, sizeof(Ref));
+		for (Index = 0U; Index < NUM_SAMPLERS; Index++) {
+			RandomSampler(&Samplers[Index], Rings[Index]);
+			RandomSample(&Sample);
+			Samplers[Index].RingPtr[0] = Sample;
+			Samplers[Index].Head = 1U;
+			List[Index] = &Samplers[Index];
+			RefAdd(&Samplers[Index], &Sample, Slot, &Ref);
+		}
+		if (XAxiPmon_SamplerAggregate(List, NUM_SAMPLERS, Slot,
+				&Stats) != XST_SUCCESS) {
+			Mismatch++;
+			continue;
+		}
+		Mismatch += RefMatch(&Ref, &Stats) ? 0U : 1U;
+		for (Index = 0U; Index < NUM_SAMPLERS; Index++) {
+			Mismatch += (Samplers[Index].Tail == 1U) ? 0U : 1U;
+		}
+	}
+	CHECK(Mismatch == 0U, "aggregate differs from the reference");
+
+	/* Nothing is consumed while any ring is empty */
+	Samplers[0].Head = 2U;
+	Samplers[1].Head = 1U;
+	CHECK(XAxiPmon_SamplerAggregate(List, NUM_SAMPLERS, 0U, &Stats) ==
+		XST_NO_DATA, "aggregate with an empty ring");
+	CHECK(Samplers[0].Tail == 1U, "sample consumed on an empty ring");
+}
+
+/************************** Main *********************************************/
+
+int main(void)
+{
+	TestInitialize();
+	TestStartStop();
+	TestHandler();
+	TestSlotStats();
+	TestAggregate();
+	CHECK(Asserts == 0U, "driver assertion");
+
+	printf("%s (%u failures)\n", Failures ? "FAILED" : "PASSED", Failures);
+	return (Failures ? 1 : 0);
+}
@@ -90,6 +90,13 @@ static void StubHandler(void);
 static int XCanfd_TrrVal_Get_SetBit_Position(u32 u);
 static u32 XCanFd_SeqRecv_logic(XCanFd *InstancePtr, u32 ReadIndex,
 	   u32 FsrVal, u32 *FramePtr, u8 fifo_no);
+static u32 XCanFd_RxRingFillFifo(XCanFd *InstancePtr, u8 fifo_no);
+static u32 XCanFd_RxRingFillMailbox(XCanFd *InstancePtr);
+static u32 XCanFd_MailboxRead(XCanFd *InstancePtr, u32 RxBufferIndex,
+	   u32 *FramePtr);
+static u32 *XCanFd_RxRingSlot(XCanFd *InstancePtr);
+static void XCanFd_WriteTxBuffer(XCanFd *InstancePtr, u32 FreeTxBuffer,
+	   u32 *FramePtr);
 
 /************************** Global Variables ******************************/
 
@@ -147,6 +154,15 @@ int XCanFd_CfgInitialize(XCanFd *InstancePtr, XCanFd_Config *ConfigPtr,
 	InstancePtr->ErrorHandler = (XCanFd_ErrorHandler) StubHandler;
 	InstancePtr->EventHandler = (XCanFd_EventHandler) StubHandler;
 
+	InstancePtr->RxRingPtr = NULL;
+	if ((ConfigPtr->NumofTxBuf == 0U) ||
+	    (ConfigPtr->NumofTxBuf >= (u32)MAX_BUFFER_VAL)) {
+		InstancePtr->TxBufMask = TRR_MASK_INIT_VAL;
+	} else {
+		InstancePtr->TxBufMask = ((u32)1 << ConfigPtr->NumofTxBuf) - 1U;
+	}
+	InstancePtr->TxFreeMask = InstancePtr->TxBufMask;
+
 	InstancePtr->IsReady = XIL_COMPONENT_IS_READY;
 
 	/* Reset the device to get it into its initial state. */
@@ -465,12 +481,7 @@ int XCanFd_Send(XCanFd *InstancePtr, u32 *FramePtr,u32 *TxBufferNumber)
 {
 	u32 FreeTxBuffer;
 	u32 TrrVal;
-	u32 DwIndex=0;
 	u32 Value;
-	u32 Dlc;
-	u32 Len;
-	u32 CanEDL;
-	u32 OutValue;
 
 	Xil_AssertNonvoid(InstancePtr != NULL);
 	Xil_AssertNonvoid(InstancePtr->IsReady == XIL_COMPONENT_IS_READY);
@@ -487,53 +498,8 @@ int XCanFd_Send(XCanFd *InstancePtr, u32 *FramePtr,u32 *TxBufferNumber)
 	if (FreeTxBuffer == XST_NOBUFFER){
 		return XST_FIFO_NO_ROOM;
 	}
-	else {
 
-		/* Write ID to ID Register */
-		XCanFd_WriteReg(InstancePtr->CanFdConfig.BaseAddress,
-				XCANFD_TXID_OFFSET(FreeTxBuffer), FramePtr[0]);
-
-		/* Write DLC to DLC Register */
-		XCanFd_WriteReg(InstancePtr->CanFdConfig.BaseAddress,
-				XCANFD_TXDLC_OFFSET(FreeTxBuffer), FramePtr[1]);
-		CanEDL = XCanFd_ReadReg(InstancePtr->CanFdConfig.BaseAddress,
-				XCANFD_TXDLC_OFFSET(FreeTxBuffer));
-
-		if (CanEDL & XCANFD_DLCR_EDL_MASK) {
-
-			/* CAN FD Frames. */
-			Dlc = XCanFd_GetDlc2len(FramePtr[1] &
-				XCANFD_DLCR_DLC_MASK,
-				(CanEDL & XCANFD_DLCR_EDL_MASK));
-			/* Write Data to Data Register */
-
-			for (Len = 0;Len < Dlc;Len += 4) {
-				OutValue = Xil_EndianSwap32(
-						FramePtr[2+DwIndex]);
-				XCanFd_WriteReg(
-					InstancePtr->CanFdConfig.BaseAddress,
-					(XCANFD_TXDW_OFFSET(FreeTxBuffer)+
-					(DwIndex*XCANFD_DW_BYTES)), OutValue);
-				DwIndex++;
-			}
-		}
-		else {
-
-			/* Legacy CAN Frames */
-			Dlc = XCanFd_GetDlc2len(FramePtr[1] &
-				XCANFD_DLCR_DLC_MASK,
-				(CanEDL & XCANFD_DLCR_EDL_MASK));
-			for (Len = 0;Len < Dlc;Len += 4) {
-				OutValue = Xil_EndianSwap32(
-						FramePtr[2+DwIndex]);
-				XCanFd_WriteReg(
-					InstancePtr->CanFdConfig.BaseAddress,
-					(XCANFD_TXDW_OFFSET(FreeTxBuffer)+
-					(Len)), OutValue);
-				DwIndex++;
-			}
-		}
-	}
+	XCanFd_WriteTxBuffer(InstancePtr, FreeTxBuffer, FramePtr);
 
 	Value = XCanFd_ReadReg(InstancePtr->CanFdConfig.BaseAddress,
 			XCANFD_TRR_OFFSET);
@@ -575,11 +541,6 @@ int XCanFd_Addto_Queue(XCanFd *InstancePtr, u32 *FramePtr,u32 *TxBufferNumber)
 	u32 FreeTxBuffer;
 	u32 TrrVal;
 	u32 MaskValue;
-	u32 DwIndex=0;
-	u32 Len;
-	u32 Dlc;
-	u32 CanEDL;
-	u32 OutValue;
 
 	Xil_AssertNonvoid(InstancePtr != NULL);
 	Xil_AssertNonvoid(InstancePtr->IsReady == XIL_COMPONENT_IS_READY);
@@ -607,49 +568,8 @@ int XCanFd_Addto_Queue(XCanFd *InstancePtr, u32 *FramePtr,u32 *TxBufferNumber)
 
 		InstancePtr->MultiBuffTrr = ~(InstancePtr->GlobalTrrMask);
 
-		/* Write ID to ID Register*/
-		XCanFd_WriteReg(InstancePtr->CanFdConfig.BaseAddress,
-				XCANFD_TXID_OFFSET(FreeTxBuffer),FramePtr[0]);
-
-		/* Write DLC to DLC Register*/
-		XCanFd_WriteReg(InstancePtr->CanFdConfig.BaseAddress,
-				XCANFD_TXDLC_OFFSET(FreeTxBuffer),FramePtr[1]);
-
-		CanEDL = XCanFd_ReadReg(InstancePtr->CanFdConfig.BaseAddress,
-				XCANFD_TXDLC_OFFSET(FreeTxBuffer));
-
-		Dlc = XCanFd_GetDlc2len(FramePtr[1] & XCANFD_DLCR_DLC_MASK,
-			(CanEDL & XCANFD_DLCR_EDL_MASK));
-
-		if (CanEDL & XCANFD_DLCR_EDL_MASK) {
+		XCanFd_WriteTxBuffer(InstancePtr, FreeTxBuffer, FramePtr);
 
-			/* CAN FD Frames */
-			for (Len = 0;Len < Dlc;Len += 4) {
-				OutValue = Xil_EndianSwap32(
-						FramePtr[2+DwIndex]);
-				XCanFd_WriteReg(
-					InstancePtr->CanFdConfig.BaseAddress,
-						(XCANFD_TXDW_OFFSET(
-						FreeTxBuffer)+(DwIndex*
-						XCANFD_DW_BYTES)),OutValue);
-				DwIndex++;
-			}
-		}
-
-		else {
-
-			/* Legacy CAN Frames */
-			for (Len = 0;Len < Dlc;Len += 4) {
-				OutValue = Xil_EndianSwap32(
-						FramePtr[2+DwIndex]);
-				XCanFd_WriteReg(
-					InstancePtr->CanFdConfig.BaseAddress,
-						(XCANFD_TXDW_OFFSET(
-						FreeTxBuffer)+(Len)),
-						OutValue);
-				DwIndex++;
-			}
-		}
 		/* Assign  Buffer to user */
 		*TxBufferNumber = FreeTxBuffer;
 
@@ -808,15 +728,7 @@ u32 XCanFd_Recv_TXEvents_Sequential(XCanFd *InstancePtr, u32 *FramePtr)
 ******************************************************************************/
 u32 XCanFd_Recv_Mailbox(XCanFd *InstancePtr, u32 *FramePtr)
 {
-	u32 DwIndex=0;
-	u32 Result;
-	u32 CanEDL;
-	u32 Dlc;
-	u32 Len;
-	u32 RcsRegNr=0;
 	u32 RxBufferIndex;
-	u32 CoreStatusBit;
-	u32 Mask;
 
 	Xil_AssertNonvoid(InstancePtr != NULL);
 	Xil_AssertNonvoid(InstancePtr->IsReady == XIL_COMPONENT_IS_READY);
@@ -825,6 +737,40 @@ u32 XCanFd_Recv_Mailbox(XCanFd *InstancePtr, u32 *FramePtr)
 					XCANFD_ISR_OFFSET) &
 					XCANFD_IXR_RXLRM_BI_MASK;
 	RxBufferIndex >>= XCANFD_RXLRM_BI_SHIFT;
+
+	return XCanFd_MailboxRead(InstancePtr, RxBufferIndex, FramePtr);
+}
+
+/*****************************************************************************/
+/**
+*
+* This static function reads the frame of one mailbox RxBuffer if its Core
+* Status Bit is set, and clears the bit so that the buffer can receive the
+* next frame.
+*
+* @param	InstancePtr is a pointer to the XCanFd instance to be worked on.
+* @param	RxBufferIndex is the RxBuffer to read.
+* @param	FramePtr is a pointer to a 32-bit aligned buffer where the CAN
+*		frame to be receive.
+*
+* @return	- XST_SUCCESS if the buffer held a frame.
+*		- XST_NO_DATA if the buffer is empty.
+*
+* @note		None.
+*
+******************************************************************************/
+static u32 XCanFd_MailboxRead(XCanFd *InstancePtr, u32 RxBufferIndex,
+	   u32 *FramePtr)
+{
+	u32 DwIndex=0;
+	u32 Result;
+	u32 CanEDL;
+	u32 Dlc;
+	u32 Len;
+	u32 RcsRegNr=0;
+	u32 CoreStatusBit;
+	u32 Mask;
+
 	CoreStatusBit = (RxBufferIndex%XCANFD_CSB_SHIFT) + XCANFD_CSB_SHIFT;
 	RcsRegNr = RxBufferIndex/XCANFD_CSB_SHIFT;
 
@@ -1904,4 +1850,444 @@ void XCanFd_Pee_BusOff_Handler(XCanFd *InstancePtr)
 			XCANFD_TRR_OFFSET, RegValue);
 }
 /*****************************************************************************/
+/**
+*
+* This function attaches a software receive ring to the instance. Once a ring
+* is attached, XCanFd_IntrHandler() moves every received frame from the RX
+* FIFO(s) or mailbox buffers into the ring before it calls the receive
+* handler, and the application reads the frames in place with
+* XCanFd_RxRingPeek() and XCanFd_RxRingConsume().
+*
+* @param	InstancePtr is a pointer to the XCanFd instance to be worked on.
+* @param	RingPtr is a pointer to the ring to attach, or NULL to detach
+*		the current ring.
+* @param	FrameBuf is a 32-bit aligned buffer of NumFrames *
+*		XCANFD_FRAME_WORDS words.
+* @param	NumFrames is the number of frame slots, a power of 2.
+*
+* @return	- XST_SUCCESS if the ring was attached or detached.
+*		- XST_INVALID_PARAM if NumFrames is not a power of 2.
+*
+* @note		The receive interrupt should be disabled while the ring is
+*		attached or detached. XCanFd_IntrHandler() still calls the
+*		receive handler after filling the ring, so a handler must be
+*		installed with XCanFd_SetHandler(XCANFD_HANDLER_RECV) even if
+*		it only signals the reader; the default handler asserts.
+*
+******************************************************************************/
+int XCanFd_RxRingInitialize(XCanFd *InstancePtr, XCanFd_RxRing *RingPtr,
+				u32 *FrameBuf, u32 NumFrames)
+{
+	Xil_AssertNonvoid(InstancePtr != NULL);
+	Xil_AssertNonvoid(InstancePtr->IsReady == XIL_COMPONENT_IS_READY);
+
+	if (RingPtr == NULL) {
+		InstancePtr->RxRingPtr = NULL;
+		return XST_SUCCESS;
+	}
+
+	Xil_AssertNonvoid(FrameBuf != NULL);
+
+	if ((NumFrames == 0U) || ((NumFrames & (NumFrames - 1U)) != 0U)) {
+		return XST_INVALID_PARAM;
+	}
+
+	RingPtr->FrameBuf = FrameBuf;
+	RingPtr->NumFrames = NumFrames;
+	RingPtr->Head = 0U;
+	RingPtr->Tail = 0U;
+	RingPtr->Dropped = 0U;
+	InstancePtr->RxRingPtr = RingPtr;
+
+	return XST_SUCCESS;
+}
+
+/*****************************************************************************/
+/**
+*
+* This function moves all frames pending in the RX FIFO(s), or in the mailbox
+* buffers in mailbox mode, into the attached receive ring. The fill level of
+* each FIFO is read once and the frames are read straight into their ring
+* slots, so each frame is copied out of the core only once. In mailbox mode
+* every RxBuffer with its Core Status Bit set is read, in buffer order, since
+* the core does not record the order in which the buffers were filled.
+*
+* @param	InstancePtr is a pointer to the XCanFd instance to be worked on.
+*
+* @return	The number of frames stored in the ring.
+*
+* @note		This function is called by XCanFd_IntrHandler() when a ring
+*		is attached. Frames that arrive while the ring is full are
+*		read out of the core and dropped so that the FIFO keeps
+*		accepting traffic; they are counted in the ring's Dropped.
+*
+******************************************************************************/
+u32 XCanFd_RxRingFill(XCanFd *InstancePtr)
+{
+	XCanFd_RxRing *RingPtr;
+	u32 Count = 0U;
+
+	Xil_AssertNonvoid(InstancePtr != NULL);
+	Xil_AssertNonvoid(InstancePtr->IsReady == XIL_COMPONENT_IS_READY);
+
+	RingPtr = InstancePtr->RxRingPtr;
+	if (RingPtr == NULL) {
+		return 0U;
+	}
+
+	if (XCANFD_GET_RX_MODE(InstancePtr) == 0U) {
+		Count = XCanFd_RxRingFillFifo(InstancePtr, XCANFD_RX_FIFO_0);
+		Count += XCanFd_RxRingFillFifo(InstancePtr, XCANFD_RX_FIFO_1);
+	} else {
+		Count = XCanFd_RxRingFillMailbox(InstancePtr);
+	}
+
+	return Count;
+}
+
+/*****************************************************************************/
+/**
+*
+* This function returns the oldest frame in the receive ring without removing
+* it, along with the number of frames that follow it contiguously in the
+* ring storage. Frames are XCANFD_FRAME_WORDS words apart, so the caller can
+* process up to *NumFramesPtr frames in place before calling
+* XCanFd_RxRingConsume().
+*
+* @param	InstancePtr is a pointer to the XCanFd instance to be worked on.
+* @param	NumFramesPtr is updated with the number of contiguous frames.
+*
+* @return	A pointer to the oldest frame, or NULL if the ring is empty or
+*		no ring is attached.
+*
+* @note		None.
+*
+******************************************************************************/
+u32 *XCanFd_RxRingPeek(XCanFd *InstancePtr, u32 *NumFramesPtr)
+{
+	XCanFd_RxRing *RingPtr;
+	u32 Tail;
+	u32 Index;
+	u32 Avail;
+
+	Xil_AssertNonvoid(InstancePtr != NULL);
+	Xil_AssertNonvoid(NumFramesPtr != NULL);
+
+	*NumFramesPtr = 0U;
+	RingPtr = InstancePtr->RxRingPtr;
+	if (RingPtr == NULL) {
+		return NULL;
+	}
+
+	Tail = RingPtr->Tail;
+	Avail = RingPtr->Head - Tail;
+	if (Avail == 0U) {
+		return NULL;
+	}
+
+	Index = Tail & (RingPtr->NumFrames - 1U);
+	if (Avail > (RingPtr->NumFrames - Index)) {
+		Avail = RingPtr->NumFrames - Index;
+	}
+	*NumFramesPtr = Avail;
+
+	return &RingPtr->FrameBuf[Index * XCANFD_FRAME_WORDS];
+}
+
+/*****************************************************************************/
+/**
+*
+* This function releases frames returned by XCanFd_RxRingPeek() so that their
+* slots can be filled again.
+*
+* @param	InstancePtr is a pointer to the XCanFd instance to be worked on.
+* @param	NumFrames is the number of frames to release, at most the
+*		count returned by XCanFd_RxRingPeek().
+*
+* @return	None.
+*
+* @note		None.
+*
+******************************************************************************/
+void XCanFd_RxRingConsume(XCanFd *InstancePtr, u32 NumFrames)
+{
+	XCanFd_RxRing *RingPtr;
+
+	Xil_AssertVoid(InstancePtr != NULL);
+	Xil_AssertVoid(InstancePtr->RxRingPtr != NULL);
+
+	RingPtr = InstancePtr->RxRingPtr;
+	Xil_AssertVoid(NumFrames <= (RingPtr->Head - RingPtr->Tail));
+
+	RingPtr->Tail += NumFrames;
+}
+
+/*****************************************************************************/
+/**
+*
+* This function sends a batch of CAN/CANFD frames. Free TX buffers are taken
+* from a software bitmap that is refreshed from the TRR register at most once
+* per call, when it runs out, and all written buffers are handed to the core with one TRR
+* write, instead of scanning TRR once per frame as XCanFd_Send() does.
+*
+* @param	InstancePtr is a pointer to the XCanFd instance to be worked on.
+* @param	FramePtr is a pointer to NumFrames frames, each in a 32-bit
+*		aligned slot of XCANFD_FRAME_WORDS words.
+* @param	NumFrames is the number of frames to send.
+* @param	NumSentPtr is updated with the number of frames queued, which
+*		are always the first frames of the batch.
+*
+* @return	- XST_SUCCESS if all frames were queued.
+*		- XST_FIFO_NO_ROOM if there were not enough free TX buffers;
+*		*NumSentPtr tells how many frames were queued.
+*
+* @note		The bitmap assumes this function owns the TX buffers, so it
+*		should not be mixed with XCanFd_Addto_Queue() on the same
+*		instance. The frames of one batch are sent in the order
+*		decided by the bus arbitration, as with XCanFd_Send_Queue().
+*
+******************************************************************************/
+int XCanFd_SendBulk(XCanFd *InstancePtr, u32 *FramePtr, u32 NumFrames,
+			u32 *NumSentPtr)
+{
+	u32 TrrVal = 0U;
+	u32 Sent = 0U;
+	u32 Refreshed = (u32)FALSE;
+	u32 Value;
+	u32 TxBuffer;
+#ifdef versal
+	u32 BufferNumber;
+#endif
+
+	Xil_AssertNonvoid(InstancePtr != NULL);
+	Xil_AssertNonvoid(InstancePtr->IsReady == XIL_COMPONENT_IS_READY);
+	Xil_AssertNonvoid((FramePtr != NULL) || (NumFrames == 0U));
+	Xil_AssertNonvoid(NumSentPtr != NULL);
+
+	while (Sent < NumFrames) {
+		if (InstancePtr->TxFreeMask == 0U) {
+			if (Refreshed == (u32)TRUE) {
+				break;
+			}
+			/* Pick up the buffers the core has finished with */
+			InstancePtr->TxFreeMask = ~XCanFd_ReadReg(
+					InstancePtr->CanFdConfig.BaseAddress,
+					XCANFD_TRR_OFFSET) &
+					InstancePtr->TxBufMask & ~TrrVal;
+			Refreshed = (u32)TRUE;
+			continue;
+		}
+		Value = XCanFD_Check_TrrVal_Set_Bit(InstancePtr->TxFreeMask);
+		TxBuffer = XCanfd_TrrVal_Get_SetBit_Position(Value);
+		InstancePtr->TxFreeMask &= ~Value;
+
+		XCanFd_WriteTxBuffer(InstancePtr, TxBuffer,
+				&FramePtr[Sent * XCANFD_FRAME_WORDS]);
+		TrrVal |= Value;
+		Sent++;
+	}
+
+	if (TrrVal != 0U) {
+#ifdef versal
+		if(XGetPSVersion_Info() == (u32)0x10 &&
+		   (!InstancePtr->CanFdConfig.IsPl)) {
+			for (BufferNumber = 0;BufferNumber < MAX_BUFFER_VAL;
+			     BufferNumber++) {
+				if ((TrrVal & (1U << BufferNumber)) != 0U) {
+					XCanFd_WriteReg(
+					InstancePtr->CanFdConfig.BaseAddress,
+					XCANFD_TRR_OFFSET,
+					(1U << BufferNumber));
+				}
+			}
+		} else
+#endif
+		{
+			XCanFd_WriteReg(InstancePtr->CanFdConfig.BaseAddress,
+					XCANFD_TRR_OFFSET, TrrVal);
+		}
+	}
+
+	*NumSentPtr = Sent;
+
+	return (Sent == NumFrames) ? XST_SUCCESS : XST_FIFO_NO_ROOM;
+}
+
+/*****************************************************************************/
+/**
+*
+* This function moves the frames of one RX FIFO into the receive ring.
+*
+* @param	InstancePtr is a pointer to the XCanFd instance to be worked on.
+* @param	fifo_no is XCANFD_RX_FIFO_0 or XCANFD_RX_FIFO_1.
+*
+* @return	The number of frames stored in the ring.
+*
+* @note		The fill level is sampled once; frames that arrive while the
+*		FIFO is drained raise a new receive interrupt.
+*
+******************************************************************************/
+static u32 XCanFd_RxRingFillFifo(XCanFd *InstancePtr, u8 fifo_no)
+{
+	XCanFd_RxRing *RingPtr = InstancePtr->RxRingPtr;
+	u32 Scratch[XCANFD_FRAME_WORDS];
+	u32 *FramePtr;
+	u32 FsrVal;
+	u32 FillLevel;
+	u32 ReadIndex;
+	u32 Count = 0U;
+
+	FillLevel = (u32)XCanFd_GetNofMessages_Stored_Rx_Fifo(InstancePtr,
+							fifo_no);
+
+	while (FillLevel > 0U) {
+		FsrVal = XCanFd_ReadReg(InstancePtr->CanFdConfig.BaseAddress,
+					XCANFD_FSR_OFFSET);
+		if (fifo_no == XCANFD_RX_FIFO_0) {
+			ReadIndex = FsrVal & XCANFD_FSR_RI_MASK;
+		} else {
+			ReadIndex = ((FsrVal & XCANFD_FSR_RI_1_MASK)
+					>> XCANFD_FSR_RI_1_SHIFT);
+		}
+
+		FramePtr = XCanFd_RxRingSlot(InstancePtr);
+		if (FramePtr == NULL) {
+			FramePtr = Scratch;
+		}
+		(void)XCanFd_SeqRecv_logic(InstancePtr, ReadIndex, FsrVal,
+					FramePtr, fifo_no);
+		if (FramePtr == Scratch) {
+			RingPtr->Dropped++;
+		} else {
+			RingPtr->Head++;
+			Count++;
+		}
+		FillLevel--;
+	}
+
+	return Count;
+}
+
+/*****************************************************************************/
+/**
+*
+* This static function moves the frames of all full mailbox RxBuffers into
+* the receive ring. The RCS registers are read once each and every buffer
+* with its Core Status Bit set is read and released.
+*
+* @param	InstancePtr is a pointer to the XCanFd instance to be worked on.
+*
+* @return	The number of frames stored in the ring.
+*
+* @note		Frames of full buffers are read and dropped while the ring is
+*		full, as in sequential mode.
+*
+******************************************************************************/
+static u32 XCanFd_RxRingFillMailbox(XCanFd *InstancePtr)
+{
+	XCanFd_RxRing *RingPtr = InstancePtr->RxRingPtr;
+	u32 Scratch[XCANFD_FRAME_WORDS];
+	u32 *FramePtr;
+	u32 NumRcs;
+	u32 RcsRegNr;
+	u32 Full;
+	u32 Bit;
+	u32 Count = 0U;
+
+	NumRcs = XCanFd_Get_NofRxBuffers(InstancePtr);
+	for (RcsRegNr = 0U; RcsRegNr < NumRcs; RcsRegNr++) {
+		Full = XCanFd_ReadReg(InstancePtr->CanFdConfig.BaseAddress,
+				XCANFD_RCS_OFFSET(RcsRegNr)) >> XCANFD_CSB_SHIFT;
+		while (Full != 0U) {
+			/* Position of the lowest set bit */
+			Bit = (u32)XCanfd_TrrVal_Get_SetBit_Position(
+					Full & (~Full + 1U));
+			Full &= Full - 1U;
+
+			FramePtr = XCanFd_RxRingSlot(InstancePtr);
+			if (FramePtr == NULL) {
+				FramePtr = Scratch;
+			}
+			if (XCanFd_MailboxRead(InstancePtr,
+					(RcsRegNr * XCANFD_CSB_SHIFT) + Bit,
+					FramePtr) != (u32)XST_SUCCESS) {
+				continue;
+			}
+			if (FramePtr == Scratch) {
+				RingPtr->Dropped++;
+			} else {
+				RingPtr->Head++;
+				Count++;
+			}
+		}
+	}
+
+	return Count;
+}
+
+/*****************************************************************************/
+/**
+*
+* This function returns the next free slot of the receive ring.
+*
+* @param	InstancePtr is a pointer to the XCanFd instance to be worked on.
+*
+* @return	A pointer to the slot, or NULL if the ring is full.
+*
+* @note		None.
+*
+******************************************************************************/
+static u32 *XCanFd_RxRingSlot(XCanFd *InstancePtr)
+{
+	XCanFd_RxRing *RingPtr = InstancePtr->RxRingPtr;
+	u32 Head = RingPtr->Head;
+
+	if ((Head - RingPtr->Tail) >= RingPtr->NumFrames) {
+		return NULL;
+	}
+
+	return &RingPtr->FrameBuf[(Head & (RingPtr->NumFrames - 1U)) *
+				XCANFD_FRAME_WORDS];
+}
+
+/*****************************************************************************/
+/**
+*
+* This function writes one frame into a TX buffer without requesting its
+* transmission.
+*
+* @param	InstancePtr is a pointer to the XCanFd instance to be worked on.
+* @param	FreeTxBuffer is the TX buffer number.
+* @param	FramePtr is a pointer to a 32-bit aligned buffer containing the
+*		CAN frame.
+*
+* @return	None.
+*
+* @note		None.
+*
+******************************************************************************/
+static void XCanFd_WriteTxBuffer(XCanFd *InstancePtr, u32 FreeTxBuffer,
+	   u32 *FramePtr)
+{
+	u32 DwIndex = 0;
+	u32 Dlc;
+	u32 Len;
+
+	XCanFd_WriteReg(InstancePtr->CanFdConfig.BaseAddress,
+			XCANFD_TXID_OFFSET(FreeTxBuffer), FramePtr[0]);
+	XCanFd_WriteReg(InstancePtr->CanFdConfig.BaseAddress,
+			XCANFD_TXDLC_OFFSET(FreeTxBuffer), FramePtr[1]);
+
+	Dlc = XCanFd_GetDlc2len(FramePtr[1] & XCANFD_DLCR_DLC_MASK,
+			(FramePtr[1] & XCANFD_DLCR_EDL_MASK));
+
+	for (Len = 0;Len < Dlc;Len += 4) {
+		XCanFd_WriteReg(InstancePtr->CanFdConfig.BaseAddress,
+				(XCANFD_TXDW_OFFSET(FreeTxBuffer) +
+				(DwIndex * XCANFD_DW_BYTES)),
+				Xil_EndianSwap32(FramePtr[2 + DwIndex]));
+		DwIndex++;
+	}
+}
+/*****************************************************************************/
 /** @} */
@@ -312,6 +312,8 @@ extern "C" {
 #define XCANFD_MODE_BR		0x0000000B /**< Bus-Off Recovery Mode */
 #define XCANFD_RX_FIFO_0	         0 /**< Selection for RX Fifo 0 */
 #define XCANFD_RX_FIFO_1	         1 /**< Selection for RX Fifo 1 */
+#define XCANFD_FRAME_WORDS	(XCANFD_MAX_FRAME_SIZE / XCANFD_DW_BYTES)
+				   /**< Words in one frame buffer */
 /* @} */
 
 /** @name Callback identifiers used as parameters to XCanFd_SetHandler()
@@ -376,6 +378,24 @@ typedef void (*XCanFd_ErrorHandler) (void *CallBackRef, u32 ErrorMask);
 ******************************************************************************/
 typedef void (*XCanFd_EventHandler) (void *CallBackRef, u32 Mask);
 
+/*****************************************************************************/
+/**
+ * Software receive ring filled from the RX FIFO(s), or from all full mailbox
+ * RxBuffers in mailbox mode, by XCanFd_RxRingFill(), normally from the
+ * receive interrupt. The receive handler is still called after each fill and
+ * must be installed. The frame storage is an array of
+ * NumFrames slots of XCANFD_FRAME_WORDS words each, in the same layout as
+ * the FramePtr buffer of XCanFd_Recv_Sequential(). Head and Tail are free
+ * running counters; the ring is full when they differ by NumFrames.
+ */
+typedef struct {
+	u32 *FrameBuf;		/**< Frame slots, provided by the user */
+	u32 NumFrames;		/**< Number of slots, a power of 2 */
+	volatile u32 Head;	/**< Slots filled, written by the fill side */
+	volatile u32 Tail;	/**< Slots consumed, written by the reader */
+	u32 Dropped;		/**< Frames dropped because the ring was full */
+} XCanFd_RxRing;
+
 /*****************************************************************************/
 /**
  * The XCanFd driver instance data. The user is required to allocate a
@@ -404,6 +424,11 @@ typedef struct {
 	XCanFd_EventHandler EventHandler;
 	void *EventRef;
 
+	XCanFd_RxRing *RxRingPtr;	/**< RX ring filled by the ISR, or NULL */
+	u32 TxBufMask;		/**< One bit per TX buffer in the design */
+	u32 TxFreeMask;		/**< TX buffers known free by
+				  XCanFd_SendBulk() */
+
 }XCanFd;
 
 /***************** Macros (Inline Functions) Definitions *********************/
@@ -1065,6 +1090,13 @@ void XCanFd_Enable_Tranceiver_Delay_Compensation(XCanFd *InstancePtr);
 void XCanFd_Set_Tranceiver_Delay_Compensation(XCanFd *InstancePtr, u32 TdcOffset);
 void XCanFd_Disable_Tranceiver_Delay_Compensation(XCanFd *InstancePtr);
 void XCanFd_Pee_BusOff_Handler(XCanFd *InstancePtr);
+int XCanFd_RxRingInitialize(XCanFd *InstancePtr, XCanFd_RxRing *RingPtr,
+				u32 *FrameBuf, u32 NumFrames);
+u32 XCanFd_RxRingFill(XCanFd *InstancePtr);
+u32 *XCanFd_RxRingPeek(XCanFd *InstancePtr, u32 *NumFramesPtr);
+void XCanFd_RxRingConsume(XCanFd *InstancePtr, u32 NumFrames);
+int XCanFd_SendBulk(XCanFd *InstancePtr, u32 *FramePtr, u32 NumFrames,
+			u32 *NumSentPtr);
 
 /* Configuration functions in xcan_config.c */
 int XCanFd_SetBaudRatePrescaler(XCanFd *InstancePtr, u8 Prescaler);
@@ -449,6 +449,10 @@ void XCanFd_IntrHandler(void *InstancePtr)
 	if ((PendingIntr & (XCANFD_IXR_RXFWMFLL_MASK | XCANFD_IXR_RXOK_MASK \
 			| XCANFD_IXR_RXRBF_MASK | XCANFD_IXR_RXFWMFLL_1_MASK ))) {
 
+		/* Move the frames into the receive ring, if one is attached */
+		if (CanPtr->RxRingPtr != NULL) {
+			(void)XCanFd_RxRingFill(CanPtr);
+		}
 		CanPtr->RecvHandler(CanPtr->RecvRef);
 	}
 
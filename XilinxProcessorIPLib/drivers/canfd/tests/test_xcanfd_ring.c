@@ -0,0 +1,1047 @@
+/******************************************************************************
+* Copyright (C) 2020 Xilinx, Inc.  All rights reserved.
+* SPDX-License-Identifier: MIT
+******************************************************************************/
+
+/*****************************************************************************/
+/**
+*
+* @file test_xcanfd_ring.c
+*
+* Host test of the CANFD receive ring and XCanFd_SendBulk() at full bus
+* load. The driver runs against a register model of the CAN FD core on a
+* bus shared with a remote node that always has its next frame ready, so
+* the bus never idles while the remote has traffic. The model has the TX
+* buffers with write-1-to-set TRR, RX FIFO 0 with its fill level, read
+* index and IRI handshake, and the mailbox RxBuffers with ID/mask match and
+* Core Status Bits cleared by writing 1. Frames arbitrate by identifier, the
+* TX buffer is sampled when its frame starts and writing a pending buffer is
+* a model error, as are reads of empty RX slots and TRR bits beyond the
+* configured buffers. A frame arriving at a full FIFO or mailbox is lost and
+* counted as an overflow.
+*
+* Time is simulated. Register accesses cost a fixed time and frames take
+* their bit count at 1 Mbit/s nominal and 5 Mbit/s data rate; bit stuffing
+* is ignored. The CPU takes receive and transmit interrupts with a fixed
+* entry cost and runs an application task every millisecond that consumes
+* the received frames at a cost per frame. Every tenth task run masks
+* interrupts for 700 us, as a flash write or a long critical section would.
+*
+* The tests receive a mix of classic and FD frames through the ring, in
+* sequential and mailbox mode, and check that every frame arrives once, in
+* order and intact, without FIFO overflow; the same traffic read one frame
+* per interrupt with XCanFd_Recv_Sequential(), as the interrupt example
+* does, is run for comparison and must overflow. The ring is also starved
+* to check that drops are counted and the FIFO keeps draining. The transmit
+* test refills the TX buffers with XCanFd_SendBulk() from the send handler
+* while receiving, and checks that every frame is sent once and intact and
+* that the node holds the bus while it has frames queued. XCanFd_Send() and
+* XCanFd_Addto_Queue() are checked for every data length.
+*
+* Build and run on the host:
+*   cc -Wall -O2 -I. -I../src -I../../../../lib/bsp/standalone/src/common \
+*      -I../../../../lib/bsp/standalone/src/arm/cortexa9 \
+*      test_xcanfd_ring.c -o test_xcanfd_ring
+*   ./test_xcanfd_ring
+*
+******************************************************************************/
+
+/***************************** Include Files *********************************/
+
+#include <stdio.h>
+#include <string.h>
+
+#include "xil_types.h"
+
+/* Register accesses go to the simulator below */
+#define XIL_IO_H
+static u32 Xil_In32(UINTPTR Addr);
+static void Xil_Out32(UINTPTR Addr, u32 Value);
+
+static u32 Xil_EndianSwap32(u32 Data)
+{
+	return __builtin_bswap32(Data);
+}
+
+#define XIL_PRINTF_H
+void xil_printf(const char8 *Format, ...);
+
+#include "xcanfd.c"
+#include "xcanfd_intr.c"
+
+/************************** Simulator ****************************************/
+
+#define SIM_BASE	0xFF060000U
+#define SIM_SPACE	0x6000U		/* Registers and message RAM */
+#define SIM_REG_NS	100U		/* One AXI register access */
+#define SIM_NOM_NS	1000U		/* Nominal bit, 1 Mbit/s */
+#define SIM_DATA_NS	200U		/* Data phase bit, 5 Mbit/s */
+#define SIM_RX_DEPTH	32U		/* RX FIFO 0 frames */
+#define SIM_TX_BUFS	8U
+#define SIM_MB_BUFS	16U
+#define SIM_LOG		32768U
+#define SIM_REMOTE_ID	0x200U		/* Loses arbitration to our 0x100 */
+#define SIM_TX_ID	0x100U
+#define SIM_NONE	(~0ULL)
+
+typedef struct {
+	u32 Regs[SIM_SPACE / 4U];	/* Plain registers and message RAM */
+	u32 Srr;
+	u32 Msr;
+	u32 Isr;
+	u32 Ier;
+	u32 Trr;
+	u64 TrrAt[SIM_TX_BUFS];		/* When each request was made */
+	u32 MbMode;
+	u32 Ri;				/* FIFO 0 read index */
+	u32 Fl;				/* FIFO 0 fill level */
+	u32 Rcs[3];
+	/* Bus */
+	int OnBus;
+	u32 OnBusBuf;			/* Our TX buffer, or SIM_TX_BUFS */
+	u32 OnBusSeq;
+	u32 BusFrame[XCANFD_FRAME_WORDS];
+	u64 BusStart;
+	u64 BusEnd;
+	u64 BusFree;
+	u64 BusNs;			/* Time the bus carried a frame */
+	/* Remote node */
+	u32 RemoteLeft;
+	u32 RemoteSeq;
+	u32 RemoteSpan;			/* Identifiers the remote cycles */
+	u64 RemoteAt;
+	/* Frames accepted by the core, in order */
+	u32 RxLog[SIM_LOG];
+	u32 RxLogged;
+	/* Our frames as they left the bus */
+	u32 TxSeen[SIM_LOG];
+	u32 TxCount;
+	u32 TxWrong;
+	u64 TxNs;
+	u64 TxFirst;
+	u64 TxLast;
+	/* Statistics */
+	u32 Errors;
+	u32 Overflows;
+	u32 NoMatch;
+	u32 Accesses;
+	u32 TrrReads;
+	u32 TrrWrites;
+	u32 MaxFill;
+} SimCan;
+
+static SimCan Sim;
+static u64 SimNow;
+
+static void SimError(const char *Why)
+{
+	if (Sim.Errors++ < 10U)
+		printf("model error: %s\n", Why);
+}
+
+/* ID, DLC and data words of a TX buffer */
+static u32 SimTxOff(u32 Buf, u32 Reg)
+{
+	return XCANFD_TXFIFO_0_BASE_ID_OFFSET + Buf * XCANFD_MAX_FRAME_SIZE +
+			Reg;
+}
+
+static u32 SimLen(u32 DlcReg)
+{
+	return (u32)XCanFd_GetDlc2len(DlcReg & XCANFD_DLCR_DLC_MASK,
+					DlcReg & XCANFD_DLCR_EDL_MASK);
+}
+
+static u32 SimWords(u32 DlcReg)
+{
+	return (SimLen(DlcReg) + 3U) / 4U;
+}
+
+/*
+ * The frames of the test. Remote frames mix empty, classic and FD frames;
+ * frames that are checked by their payload carry at least one word, and
+ * the first word is the sequence number.
+ */
+typedef struct {
+	u8 Len;
+	u32 Flags;
+} SimKind;
+
+static const SimKind SimMix[] = {
+	{ 0U, 0U },
+	{ 8U, 0U },
+	{ 5U, 0U },
+	{ 64U, XCANFD_DLCR_EDL_MASK | XCANFD_DLCR_BRS_MASK },
+	{ 16U, XCANFD_DLCR_EDL_MASK | XCANFD_DLCR_BRS_MASK },
+	{ 48U, XCANFD_DLCR_EDL_MASK },
+};
+
+static const SimKind SimPayload[] = {
+	{ 8U, 0U },
+	{ 4U, 0U },
+	{ 64U, XCANFD_DLCR_EDL_MASK | XCANFD_DLCR_BRS_MASK },
+	{ 12U, XCANFD_DLCR_EDL_MASK | XCANFD_DLCR_BRS_MASK },
+};
+
+static const SimKind *SimKinds = SimMix;
+static u32 SimNumKinds = sizeof(SimMix) / sizeof(SimMix[0]);
+
+static void GenFrame(const SimKind *Kinds, u32 NumKinds, u32 Id, u32 Seq,
+			u32 *Frame)
+{
+	const SimKind *K = &Kinds[Seq % NumKinds];
+	u32 i;
+
+	memset(Frame, 0, XCANFD_FRAME_WORDS * 4U);
+	Frame[0] = Id << XCANFD_IDR_ID1_SHIFT;
+	Frame[1] = ((u32)XCanFd_GetLen2Dlc(K->Len) << XCANFD_DLCR_DLC_SHIFT) |
+			K->Flags;
+	for (i = 0U; i < (K->Len + 3U) / 4U; i++)
+		Frame[2U + i] = (i == 0U) ? Seq :
+				(Seq * 0x01000193U) ^ (i * 0x9E3779B9U) ^ Id;
+}
+
+static u32 RemoteId(u32 Seq)
+{
+	return SIM_REMOTE_ID + (Seq % Sim.RemoteSpan);
+}
+
+static u32 TxId(u32 Seq)
+{
+	return SIM_TX_ID + (Seq & 7U);
+}
+
+static int SameFrame(const u32 *A, const u32 *B)
+{
+	u32 Mask = XCANFD_DLCR_DLC_MASK | XCANFD_DLCR_EDL_MASK |
+			XCANFD_DLCR_BRS_MASK;
+	u32 i;
+
+	if (A[0] != B[0] || (A[1] & Mask) != (B[1] & Mask))
+		return 0;
+	for (i = 0U; i < SimWords(B[1]); i++)
+		if (A[2U + i] != B[2U + i])
+			return 0;
+	return 1;
+}
+
+static u64 SimFrameNs(const u32 *Frame)
+{
+	u32 Len = SimLen(Frame[1]);
+	u32 Data;
+
+	if ((Frame[1] & XCANFD_DLCR_EDL_MASK) == 0U)
+		return (u64)(47U + 8U * Len) * SIM_NOM_NS;
+
+	/* Arbitration, ACK and EOF at the nominal rate, the rest may switch */
+	Data = 5U + 8U * Len + ((Len > 16U) ? 21U : 17U) + 5U;
+	return (u64)29U * SIM_NOM_NS + (u64)Data *
+		(((Frame[1] & XCANFD_DLCR_BRS_MASK) != 0U) ?
+					SIM_DATA_NS : SIM_NOM_NS);
+}
+
+/* Store a frame in a message RAM element as the core does */
+static void SimStore(u32 Off, const u32 *Frame)
+{
+	u32 i;
+
+	Sim.Regs[Off / 4U] = Frame[0];
+	Sim.Regs[Off / 4U + 1U] = Frame[1] |
+			((u32)(SimNow / 1000U) & XCANFD_DLCR_TIMESTAMP_MASK);
+	for (i = 0U; i < 16U; i++)
+		Sim.Regs[Off / 4U + 2U + i] = (i < SimWords(Frame[1])) ?
+				Xil_EndianSwap32(Frame[2U + i]) : 0xDEADBEEFU;
+}
+
+static void SimReceive(const u32 *Frame, u32 Seq)
+{
+	u32 Slot;
+	u32 Bit;
+	u32 Mask;
+	u32 i;
+
+	if (Sim.MbMode == 0U) {
+		if (Sim.Fl == SIM_RX_DEPTH) {
+			Sim.Overflows++;
+			Sim.Isr |= XCANFD_IXR_RXFOFLW_MASK;
+			return;
+		}
+		Slot = (Sim.Ri + Sim.Fl) % SIM_RX_DEPTH;
+		SimStore(XCANFD_RXID_OFFSET(Slot), Frame);
+		Sim.Fl++;
+		if (Sim.Fl > Sim.MaxFill)
+			Sim.MaxFill = Sim.Fl;
+	} else {
+		for (i = 0U; i < SIM_MB_BUFS; i++) {
+			Bit = 1U << (i % 16U);
+			if ((Sim.Rcs[i / 16U] & Bit) == 0U)
+				continue;
+			Mask = Sim.Regs[XCANFD_MAILBOX_MASK_OFFSET(i) / 4U];
+			if (((Frame[0] ^ Sim.Regs[XCANFD_RXID_OFFSET(i) / 4U]) &
+								Mask) != 0U)
+				continue;
+			if ((Sim.Rcs[i / 16U] & (Bit << XCANFD_CSB_SHIFT)) != 0U) {
+				Sim.Overflows++;
+				Sim.Isr |= XCANFD_IXR_RXBOFLW_MASK;
+				return;
+			}
+			SimStore(XCANFD_RXID_OFFSET(i), Frame);
+			Sim.Rcs[i / 16U] |= Bit << XCANFD_CSB_SHIFT;
+			break;
+		}
+		if (i == SIM_MB_BUFS) {
+			Sim.NoMatch++;
+			return;
+		}
+	}
+
+	Sim.Isr |= XCANFD_IXR_RXOK_MASK;
+	if (Sim.RxLogged < SIM_LOG)
+		Sim.RxLog[Sim.RxLogged++] = Seq;
+}
+
+/* Our frame left the bus */
+static void SimTransmitted(void)
+{
+	u32 Expect[XCANFD_FRAME_WORDS];
+	u32 Seq = Sim.BusFrame[2];
+
+	Sim.Trr &= ~(1U << Sim.OnBusBuf);
+	Sim.Isr |= XCANFD_IXR_TXOK_MASK;
+	if (Sim.TxCount++ == 0U)
+		Sim.TxFirst = Sim.BusStart;
+	Sim.TxLast = Sim.BusEnd;
+	Sim.TxNs += Sim.BusEnd - Sim.BusStart;
+
+	GenFrame(SimPayload, 4U, TxId(Seq), Seq, Expect);
+	if (Seq >= SIM_LOG || !SameFrame(Sim.BusFrame, Expect)) {
+		Sim.TxWrong++;
+		return;
+	}
+	Sim.TxSeen[Seq]++;
+}
+
+/* Earliest start of the next frame, or SIM_NONE */
+static u64 SimNextStart(void)
+{
+	u64 Start = SIM_NONE;
+	u32 i;
+
+	for (i = 0U; i < SIM_TX_BUFS; i++)
+		if ((Sim.Trr & (1U << i)) != 0U && Sim.TrrAt[i] < Start)
+			Start = Sim.TrrAt[i];
+	if (Sim.RemoteLeft != 0U && Sim.RemoteAt < Start)
+		Start = Sim.RemoteAt;
+	if (Start != SIM_NONE && Start < Sim.BusFree)
+		Start = Sim.BusFree;
+	return Start;
+}
+
+static int SimBusStart(void)
+{
+	u64 Start = SimNextStart();
+	u32 Best = SIM_TX_BUFS;
+	u32 Id;
+	u32 i;
+
+	if (Start == SIM_NONE || Start > SimNow ||
+	    (Sim.Srr & XCANFD_SRR_CEN_MASK) == 0U)
+		return 0;
+
+	/* The lowest identifier ready at the start wins arbitration */
+	for (i = 0U; i < SIM_TX_BUFS; i++) {
+		if ((Sim.Trr & (1U << i)) == 0U || Sim.TrrAt[i] > Start)
+			continue;
+		Id = Sim.Regs[SimTxOff(i, 0U) / 4U];
+		if (Best == SIM_TX_BUFS ||
+		    Id < Sim.Regs[SimTxOff(Best, 0U) / 4U])
+			Best = i;
+	}
+	if (Best != SIM_TX_BUFS && (Sim.RemoteLeft == 0U ||
+	    Sim.RemoteAt > Start ||
+	    (Sim.Regs[SimTxOff(Best, 0U) / 4U] & XCANFD_IDR_ID1_MASK) <
+	    (RemoteId(Sim.RemoteSeq) << XCANFD_IDR_ID1_SHIFT))) {
+		/* The core samples the TX buffer when the frame starts */
+		Sim.BusFrame[0] = Sim.Regs[SimTxOff(Best, 0U) / 4U];
+		Sim.BusFrame[1] = Sim.Regs[SimTxOff(Best, 4U) / 4U];
+		for (i = 0U; i < SimWords(Sim.BusFrame[1]); i++)
+			Sim.BusFrame[2U + i] = Xil_EndianSwap32(
+				Sim.Regs[SimTxOff(Best, 8U) / 4U + i]);
+		Sim.OnBusBuf = Best;
+	} else {
+		Sim.OnBusSeq = Sim.RemoteSeq++;
+		Sim.RemoteLeft--;
+		GenFrame(SimKinds, SimNumKinds, RemoteId(Sim.OnBusSeq),
+				Sim.OnBusSeq, Sim.BusFrame);
+		Sim.OnBusBuf = SIM_TX_BUFS;
+	}
+
+	Sim.OnBus = 1;
+	Sim.BusStart = Start;
+	Sim.BusEnd = Start + SimFrameNs(Sim.BusFrame);
+	return 1;
+}
+
+/* Run the bus up to SimNow */
+static void SimAdvance(void)
+{
+	u64 Now = SimNow;
+
+	for (;;) {
+		if (Sim.OnBus) {
+			if (Now < Sim.BusEnd)
+				break;
+			/* Deliver at the end of the frame */
+			SimNow = Sim.BusEnd;
+			Sim.OnBus = 0;
+			Sim.BusFree = Sim.BusEnd;
+			Sim.BusNs += Sim.BusEnd - Sim.BusStart;
+			if (Sim.OnBusBuf != SIM_TX_BUFS) {
+				SimTransmitted();
+			} else {
+				Sim.RemoteAt = Sim.BusEnd;
+				SimReceive(Sim.BusFrame, Sim.OnBusSeq);
+			}
+			SimNow = Now;
+		}
+		if (!SimBusStart())
+			break;
+	}
+}
+
+static u64 SimNextEvent(void)
+{
+	return Sim.OnBus ? Sim.BusEnd : SimNextStart();
+}
+
+static int SimIdle(void)
+{
+	return !Sim.OnBus && Sim.RemoteLeft == 0U && Sim.Trr == 0U;
+}
+
+static void SimReset(u32 MbMode, const SimKind *Kinds, u32 NumKinds,
+			u32 RemoteSpan)
+{
+	memset(&Sim, 0, sizeof(Sim));
+	SimNow = 0U;
+	Sim.MbMode = MbMode;
+	Sim.RemoteSpan = RemoteSpan;
+	SimKinds = Kinds;
+	SimNumKinds = NumKinds;
+}
+
+/************************** Stubs ********************************************/
+
+static u32 Xil_In32(UINTPTR Addr)
+{
+	u32 Off = (u32)(Addr - SIM_BASE);
+	u32 Slot;
+	u32 i;
+
+	SimNow += SIM_REG_NS;
+	SimAdvance();
+	Sim.Accesses++;
+
+	switch (Off) {
+	case XCANFD_SRR_OFFSET:
+		return Sim.Srr;
+	case XCANFD_MSR_OFFSET:
+		return Sim.Msr;
+	case XCANFD_SR_OFFSET:
+		return ((Sim.Srr & XCANFD_SRR_CEN_MASK) != 0U) ?
+			XCANFD_SR_NORMAL_MASK : XCANFD_SR_CONFIG_MASK;
+	case XCANFD_ISR_OFFSET:
+		return Sim.Isr;
+	case XCANFD_IER_OFFSET:
+		return Sim.Ier;
+	case XCANFD_TRR_OFFSET:
+		Sim.TrrReads++;
+		return Sim.Trr;
+	case XCANFD_FSR_OFFSET:
+		if (Sim.MbMode != 0U)
+			return 0U;
+		return (Sim.Fl << XCANFD_FSR_FL_0_SHIFT) | Sim.Ri;
+	case XCANFD_RCS0_OFFSET:
+	case XCANFD_RCS1_OFFSET:
+	case XCANFD_RCS2_OFFSET:
+		return Sim.Rcs[(Off - XCANFD_RCS0_OFFSET) / 4U];
+	default:
+		break;
+	}
+
+	if (Off >= XCANFD_RXFIFO_0_BASE_ID_OFFSET &&
+	    Off < XCANFD_RXFIFO_0_BASE_ID_OFFSET +
+				SIM_RX_DEPTH * XCANFD_MAX_FRAME_SIZE) {
+		Slot = (Off - XCANFD_RXFIFO_0_BASE_ID_OFFSET) /
+						XCANFD_MAX_FRAME_SIZE;
+		if (Sim.MbMode == 0U) {
+			if ((Slot + SIM_RX_DEPTH - Sim.Ri) % SIM_RX_DEPTH >=
+								Sim.Fl)
+				SimError("RX FIFO slot read while empty");
+		} else if (Slot < SIM_MB_BUFS) {
+			i = 1U << ((Slot % 16U) + XCANFD_CSB_SHIFT);
+			if ((Off - XCANFD_RXFIFO_0_BASE_ID_OFFSET) %
+				XCANFD_MAX_FRAME_SIZE != 0U &&
+			    (Sim.Rcs[Slot / 16U] & i) == 0U)
+				SimError("RxBuffer read while empty");
+		}
+	}
+
+	return Sim.Regs[(Off / 4U) % (SIM_SPACE / 4U)];
+}
+
+static void Xil_Out32(UINTPTR Addr, u32 Value)
+{
+	u32 Off = (u32)(Addr - SIM_BASE);
+	u32 Buf;
+	u32 i;
+
+	SimNow += SIM_REG_NS;
+	SimAdvance();
+	Sim.Accesses++;
+
+	switch (Off) {
+	case XCANFD_SRR_OFFSET:
+		if ((Value & XCANFD_SRR_SRST_MASK) != 0U) {
+			Sim.Srr = 0U;
+			Sim.Msr = 0U;
+			Sim.Isr = 0U;
+			Sim.Ier = 0U;
+			Sim.Trr = 0U;
+			Sim.Ri = 0U;
+			Sim.Fl = 0U;
+			memset(Sim.Rcs, 0, sizeof(Sim.Rcs));
+		} else {
+			Sim.Srr = Value;
+		}
+		return;
+	case XCANFD_MSR_OFFSET:
+		Sim.Msr = Value;
+		return;
+	case XCANFD_IER_OFFSET:
+		Sim.Ier = Value;
+		return;
+	case XCANFD_ICR_OFFSET:
+		Sim.Isr &= ~Value;
+		return;
+	case XCANFD_TRR_OFFSET:
+		Sim.TrrWrites++;
+		if ((Value & ~((1U << SIM_TX_BUFS) - 1U)) != 0U)
+			SimError("TRR bit beyond the TX buffers");
+		Value &= (1U << SIM_TX_BUFS) - 1U;
+		for (i = 0U; i < SIM_TX_BUFS; i++)
+			if ((Value & ~Sim.Trr & (1U << i)) != 0U)
+				Sim.TrrAt[i] = SimNow;
+		Sim.Trr |= Value;
+		SimAdvance();
+		return;
+	case XCANFD_FSR_OFFSET:
+		if ((Value & XCANFD_FSR_IRI_MASK) != 0U) {
+			if (Sim.Fl == 0U) {
+				SimError("IRI with an empty FIFO");
+			} else {
+				Sim.Ri = (Sim.Ri + 1U) % SIM_RX_DEPTH;
+				Sim.Fl--;
+			}
+		}
+		if ((Value & XCANFD_FSR_IRI_1_MASK) != 0U)
+			SimError("IRI of the empty FIFO 1");
+		return;
+	case XCANFD_RCS0_OFFSET:
+	case XCANFD_RCS1_OFFSET:
+	case XCANFD_RCS2_OFFSET:
+		i = (Off - XCANFD_RCS0_OFFSET) / 4U;
+		/* Host control bits are written, core status bits cleared */
+		Sim.Rcs[i] = (Value & XCANFD_RCS_HCB_MASK) |
+				(Sim.Rcs[i] & ~Value & ~XCANFD_RCS_HCB_MASK);
+		return;
+	default:
+		break;
+	}
+
+	if (Off >= XCANFD_TXFIFO_0_BASE_ID_OFFSET &&
+	    Off < XCANFD_TXFIFO_0_BASE_ID_OFFSET +
+				SIM_TX_BUFS * XCANFD_MAX_FRAME_SIZE) {
+		Buf = (Off - XCANFD_TXFIFO_0_BASE_ID_OFFSET) /
+						XCANFD_MAX_FRAME_SIZE;
+		if ((Sim.Trr & (1U << Buf)) != 0U)
+			SimError("TX buffer written while pending");
+	}
+	Sim.Regs[(Off / 4U) % (SIM_SPACE / 4U)] = Value;
+}
+
+void xil_printf(const char8 *Format, ...)
+{
+	(void)Format;
+}
+
+u32 Xil_AssertStatus;
+
+void Xil_Assert(const char8 *File, s32 Line)
+{
+	printf("assert %s:%d\n", File, (int)Line);
+}
+
+/************************** Test Helpers *************************************/
+
+#define CPU_IRQ_NS	2000U		/* Interrupt entry and exit */
+#define CPU_TASK_NS	1000000U	/* Period of the application task */
+#define CPU_FRAME_NS	2000U		/* Task work per received frame */
+#define CPU_MASK_EVERY	10U		/* Task runs between masked sections */
+#define CPU_MASK_NS	700000U		/* Interrupts masked */
+#define CPU_LIMIT_NS	20000000000ULL
+#define APP_BATCH	16U
+#define RING_FRAMES	256U
+
+#define CHECK(Cond, Msg)						\
+	do {								\
+		if (!(Cond)) {						\
+			printf("FAIL %s:%d: %s\n", __FILE__, __LINE__,	\
+								(Msg));	\
+			Failures++;					\
+		}							\
+	} while (0)
+
+static u32 Failures;
+
+static XCanFd Can;
+XCanFd_Config XCanFd_ConfigTable[XPAR_XCANFD_NUM_INSTANCES];
+static XCanFd_RxRing Ring;
+static u32 RingBuf[RING_FRAMES * XCANFD_FRAME_WORDS];
+
+typedef struct {
+	u32 UseRing;
+	u32 MaskEvery;
+	u32 StallRuns;		/* Task runs that skip the consumer */
+	u64 TaskAt;
+	u32 TaskRuns;
+	u32 Irqs;
+	u32 Events;
+	/* Receive check */
+	u32 Next;		/* Next frame of Sim.RxLog */
+	u32 LastSeq[SIM_MB_BUFS];
+	u32 Received;
+	u32 Skipped;
+	u32 Wrong;
+	/* Transmit */
+	u32 TxTotal;
+	u32 TxNext;
+	u32 TxCalls;
+	u32 TxBatch[APP_BATCH * XCANFD_FRAME_WORDS];
+} AppState;
+
+static AppState App;
+
+/* Sequential mode: frames must come in the order the core accepted them */
+static void AppCheck(const u32 *Frame)
+{
+	u32 Expect[XCANFD_FRAME_WORDS];
+	u32 Seq;
+
+	while (App.Next < Sim.RxLogged) {
+		Seq = Sim.RxLog[App.Next++];
+		GenFrame(SimKinds, SimNumKinds, RemoteId(Seq), Seq, Expect);
+		if (SameFrame(Frame, Expect)) {
+			App.Received++;
+			return;
+		}
+		App.Skipped++;
+	}
+	App.Wrong++;
+}
+
+/* Mailbox mode: each RxBuffer holds one identifier, in order */
+static void AppCheckMailbox(const u32 *Frame)
+{
+	u32 Expect[XCANFD_FRAME_WORDS];
+	u32 Seq = Frame[2];
+	u32 Buf = Seq % SIM_MB_BUFS;
+
+	GenFrame(SimKinds, SimNumKinds, RemoteId(Seq), Seq, Expect);
+	if (!SameFrame(Frame, Expect) || Seq < App.LastSeq[Buf]) {
+		App.Wrong++;
+		return;
+	}
+	App.Skipped += (Seq - App.LastSeq[Buf]) / SIM_MB_BUFS;
+	App.LastSeq[Buf] = Seq + SIM_MB_BUFS;
+	App.Received++;
+}
+
+static void AppFrame(const u32 *Frame)
+{
+	if (Sim.MbMode != 0U)
+		AppCheckMailbox(Frame);
+	else
+		AppCheck(Frame);
+}
+
+static void AppSend(void)
+{
+	u32 Num = App.TxTotal - App.TxNext;
+	u32 Sent;
+	u32 i;
+
+	if (Num == 0U)
+		return;
+	if (Num > APP_BATCH)
+		Num = APP_BATCH;
+	for (i = 0U; i < Num; i++)
+		GenFrame(SimPayload, 4U, TxId(App.TxNext + i), App.TxNext + i,
+				&App.TxBatch[i * XCANFD_FRAME_WORDS]);
+	(void)XCanFd_SendBulk(&Can, App.TxBatch, Num, &Sent);
+	App.TxNext += Sent;
+	App.TxCalls++;
+}
+
+static void RecvHandler(void *CallBackRef)
+{
+	u32 Frame[XCANFD_FRAME_WORDS];
+
+	(void)CallBackRef;
+	if (App.UseRing)
+		return;
+	/* One frame per interrupt, as the interrupt example does */
+	if (XCanFd_Recv_Sequential(&Can, Frame) == (u32)XST_SUCCESS)
+		AppFrame(Frame);
+}
+
+static void SendHandler(void *CallBackRef)
+{
+	(void)CallBackRef;
+	AppSend();
+}
+
+static void ErrorHandler(void *CallBackRef, u32 ErrorMask)
+{
+	(void)CallBackRef;
+	(void)ErrorMask;
+	SimError("bus error interrupt");
+}
+
+static void EventHandler(void *CallBackRef, u32 Mask)
+{
+	(void)CallBackRef;
+	(void)Mask;
+	App.Events++;
+}
+
+static void CpuIrq(void)
+{
+	if ((Sim.Isr & Sim.Ier) == 0U)
+		return;
+	SimNow += CPU_IRQ_NS;
+	App.Irqs++;
+	XCanFd_IntrHandler(&Can);
+}
+
+static void AppTask(void)
+{
+	u32 *FramePtr;
+	u32 Num;
+	u32 i;
+
+	App.TaskRuns++;
+	App.TaskAt += CPU_TASK_NS;
+
+	if (App.MaskEvery != 0U && App.TaskRuns % App.MaskEvery == 0U) {
+		SimNow += CPU_MASK_NS;
+		SimAdvance();
+	}
+	if (App.StallRuns != 0U) {
+		App.StallRuns--;
+		return;
+	}
+
+	while ((FramePtr = XCanFd_RxRingPeek(&Can, &Num)) != NULL) {
+		for (i = 0U; i < Num; i++) {
+			AppFrame(&FramePtr[i * XCANFD_FRAME_WORDS]);
+			SimNow += CPU_FRAME_NS;
+			SimAdvance();
+			/* The ISR preempts the task and fills the ring */
+			CpuIrq();
+		}
+		XCanFd_RxRingConsume(&Can, Num);
+	}
+}
+
+static void AppRun(void)
+{
+	u64 Next;
+	u32 Num;
+
+	while (SimNow < CPU_LIMIT_NS) {
+		SimAdvance();
+		if ((Sim.Isr & Sim.Ier) != 0U) {
+			CpuIrq();
+			continue;
+		}
+		if (SimNow >= App.TaskAt) {
+			AppTask();
+			continue;
+		}
+		if (SimIdle() && App.TxNext == App.TxTotal &&
+		    (XCanFd_RxRingPeek(&Can, &Num) == NULL ||
+		     App.StallRuns != 0U))
+			return;
+		Next = SimNextEvent();
+		SimNow = (Next < App.TaskAt) ? Next : App.TaskAt;
+	}
+	CHECK(0, "simulation did not finish");
+}
+
+static void SetUp(u32 MbMode, u32 UseRing, u32 RingFrames)
+{
+	XCanFd_Config *CfgPtr;
+	u32 i;
+
+	memset(&App, 0, sizeof(App));
+	App.UseRing = UseRing;
+	App.MaskEvery = CPU_MASK_EVERY;
+	App.TaskAt = CPU_TASK_NS;
+	for (i = 0U; i < SIM_MB_BUFS; i++)
+		App.LastSeq[i] = i;
+
+	memset(&Can, 0, sizeof(Can));
+	CfgPtr = XCanFd_GetConfig(0U);
+	CfgPtr->DeviceId = 0U;
+	CfgPtr->BaseAddress = SIM_BASE;
+	CfgPtr->Rx_Mode = MbMode;
+	CfgPtr->NumofRxMbBuf = (MbMode != 0U) ? SIM_MB_BUFS : 0U;
+	CfgPtr->NumofTxBuf = SIM_TX_BUFS;
+	CfgPtr->IsPl = 1U;
+	CHECK(XCanFd_CfgInitialize(&Can, CfgPtr, CfgPtr->BaseAddress) ==
+			XST_SUCCESS, "CfgInitialize");
+
+	XCanFd_SetHandler(&Can, XCANFD_HANDLER_SEND, (void *)SendHandler,
+			&Can);
+	XCanFd_SetHandler(&Can, XCANFD_HANDLER_RECV, (void *)RecvHandler,
+			&Can);
+	XCanFd_SetHandler(&Can, XCANFD_HANDLER_ERROR, (void *)ErrorHandler,
+			&Can);
+	XCanFd_SetHandler(&Can, XCANFD_HANDLER_EVENT, (void *)EventHandler,
+			&Can);
+
+	if (MbMode != 0U) {
+		for (i = 0U; i < SIM_MB_BUFS; i++) {
+			(void)XCanFd_Set_MailBox_IdMask(&Can, i,
+				XCANFD_IDR_ID1_MASK,
+				(SIM_REMOTE_ID + i) << XCANFD_IDR_ID1_SHIFT);
+			(void)XCanFd_RxBuff_MailBox_Active(&Can, i);
+		}
+	}
+	if (UseRing)
+		CHECK(XCanFd_RxRingInitialize(&Can, &Ring, RingBuf,
+				RingFrames) == XST_SUCCESS, "ring init");
+
+	XCanFd_InterruptEnable(&Can, XCANFD_IXR_RXOK_MASK |
+			XCANFD_IXR_TXOK_MASK | XCANFD_IXR_RXFOFLW_MASK |
+			XCANFD_IXR_RXBOFLW_MASK);
+	XCanFd_EnterMode(&Can, XCANFD_MODE_NORMAL);
+	CHECK(XCanFd_GetMode(&Can) == XCANFD_MODE_NORMAL, "normal mode");
+}
+
+/* Remote traffic from now on, back to back */
+static void Remote(u32 Frames)
+{
+	Sim.RemoteLeft = Frames;
+	Sim.RemoteAt = SimNow;
+	Sim.BusFree = SimNow;
+}
+
+static void Report(const char *Name, u32 Frames)
+{
+	printf("  %-23s %5u of %5u received, %5.1f%% bus, %4.2f irq/frame, "
+		"%4.1f reg/frame, overflow %u\n", Name, App.Received, Frames,
+		100.0 * (double)Sim.BusNs / (double)SimNow,
+		(double)App.Irqs / Frames, (double)Sim.Accesses / Frames,
+		Sim.Overflows);
+}
+
+/************************** Tests ********************************************/
+
+#define RX_FRAMES	20000U
+
+static void TestRxRing(void)
+{
+	u32 BaselineOverflows;
+
+	printf("Receive at 100%% bus load, 1/5 Mbit/s, %u-frame FIFO:\n",
+			SIM_RX_DEPTH);
+
+	/* One frame per interrupt, as the interrupt example */
+	SimReset(0U, SimMix, 6U, 256U);
+	SetUp(0U, 0U, 0U);
+	Remote(RX_FRAMES);
+	Sim.Accesses = 0U;
+	AppRun();
+	Report("Recv_Sequential per irq", RX_FRAMES);
+	BaselineOverflows = Sim.Overflows;
+	CHECK(Sim.Errors == 0U, "baseline model errors");
+	CHECK(BaselineOverflows != 0U,
+		"one frame per interrupt keeps up; the load is too light");
+
+	/* The ring drains the FIFO on every interrupt */
+	SimReset(0U, SimMix, 6U, 256U);
+	SetUp(0U, 1U, RING_FRAMES);
+	Remote(RX_FRAMES);
+	Sim.Accesses = 0U;
+	AppRun();
+	Report("RX ring", RX_FRAMES);
+
+	CHECK(Sim.Errors == 0U, "model errors");
+	CHECK(Sim.Overflows == 0U, "RX FIFO overflow");
+	CHECK(Sim.RxLogged == RX_FRAMES, "core accepted every frame");
+	CHECK(App.Received == RX_FRAMES, "every frame received");
+	CHECK(App.Skipped == 0U && App.Wrong == 0U,
+		"frames received in order and intact");
+	CHECK(Ring.Dropped == 0U, "no ring drops");
+	CHECK(Sim.Fl == 0U, "FIFO empty at the end");
+	CHECK(Sim.BusNs * 100U >= (u64)SimNow * 95U, "bus not fully loaded");
+}
+
+static void TestRxRingFull(void)
+{
+	SimReset(0U, SimMix, 6U, 256U);
+	SetUp(0U, 1U, 8U);
+	App.MaskEvery = 0U;
+	App.StallRuns = 5U;
+	Remote(2000U);
+	AppRun();
+
+	CHECK(Sim.Errors == 0U, "model errors");
+	CHECK(Ring.Dropped != 0U, "stalled reader drops frames");
+	CHECK(Sim.Overflows == 0U, "FIFO keeps draining while the ring is full");
+	CHECK(App.Wrong == 0U, "frames intact");
+	CHECK(App.Skipped == Ring.Dropped, "gaps match the drop count");
+	CHECK(App.Received + Ring.Dropped == 2000U, "frames accounted for");
+}
+
+static void TestRxMailbox(void)
+{
+	printf("Mailbox mode, %u RxBuffers at 100%% bus load:\n",
+			SIM_MB_BUFS);
+
+	SimReset(1U, SimPayload, 4U, SIM_MB_BUFS);
+	SetUp(1U, 1U, RING_FRAMES);
+	Remote(RX_FRAMES);
+	Sim.Accesses = 0U;
+	AppRun();
+	Report("RX ring", RX_FRAMES);
+
+	CHECK(Sim.Errors == 0U, "model errors");
+	CHECK(Sim.NoMatch == 0U, "frames matched a buffer");
+	CHECK(Sim.Overflows == 0U, "RxBuffer overflow");
+	CHECK(App.Received == RX_FRAMES, "every frame received");
+	CHECK(App.Skipped == 0U && App.Wrong == 0U,
+		"frames in order per buffer and intact");
+	CHECK(Sim.Rcs[0] == (1U << SIM_MB_BUFS) - 1U,
+		"buffers active and released");
+}
+
+#define TX_FRAMES	4000U
+
+static void TestSendBulk(void)
+{
+	u32 Once = 0U;
+	u32 i;
+
+	printf("SendBulk refilled from the send handler, %u TX buffers:\n",
+			SIM_TX_BUFS);
+
+	SimReset(0U, SimMix, 6U, 256U);
+	SetUp(0U, 1U, RING_FRAMES);
+	App.TxTotal = TX_FRAMES;
+	Remote(RX_FRAMES / 4U);
+	Sim.Accesses = 0U;
+	Sim.TrrReads = 0U;
+	AppSend();
+	AppRun();
+
+	for (i = 0U; i < TX_FRAMES; i++)
+		Once += (Sim.TxSeen[i] == 1U);
+	printf("  %u frames, %.2f calls, %.2f TRR reads and %.2f TRR writes "
+		"per frame,\n  bus held %.1f%% while queued\n", Sim.TxCount,
+		(double)App.TxCalls / Sim.TxCount,
+		(double)Sim.TrrReads / Sim.TxCount,
+		(double)Sim.TrrWrites / Sim.TxCount,
+		100.0 * (double)Sim.TxNs / (double)(Sim.TxLast - Sim.TxFirst));
+
+	CHECK(Sim.Errors == 0U, "model errors");
+	CHECK(Sim.TxCount == TX_FRAMES && Once == TX_FRAMES,
+		"every frame sent once");
+	CHECK(Sim.TxWrong == 0U, "frames sent intact");
+	CHECK(Sim.TrrWrites <= App.TxCalls, "TRR written once per batch");
+	CHECK(Sim.TrrReads <= App.TxCalls, "TRR read at most once per batch");
+	CHECK(Sim.TxNs * 100U >= (Sim.TxLast - Sim.TxFirst) * 90U,
+		"node gave up the bus with frames to send");
+	CHECK(App.Received == RX_FRAMES / 4U && Sim.Overflows == 0U,
+		"reception while sending");
+}
+
+static void TestSend(void)
+{
+	u32 Frame[XCANFD_FRAME_WORDS];
+	u32 Buf;
+	u32 Dlc;
+	u32 Fd;
+	u32 i;
+
+	SimReset(0U, SimMix, 6U, 256U);
+	SetUp(0U, 0U, 0U);
+
+	/* XCanFd_Send() for every data length code, classic and FD */
+	for (Fd = 0U; Fd < 2U; Fd++) {
+		for (Dlc = 0U; Dlc <= (Fd ? 15U : 8U); Dlc++) {
+			memset(Frame, 0, sizeof(Frame));
+			Frame[0] = (SIM_TX_ID + Dlc) << XCANFD_IDR_ID1_SHIFT;
+			Frame[1] = (Dlc << XCANFD_DLCR_DLC_SHIFT) |
+					(Fd ? XCANFD_DLCR_EDL_MASK : 0U);
+			for (i = 0U; i < 16U; i++)
+				Frame[2U + i] = (Dlc * 0x01010101U) ^ i;
+			Sim.TxCount = 0U;
+			CHECK(XCanFd_Send(&Can, Frame, &Buf) == XST_SUCCESS,
+				"Send");
+			SimNow += 1000000U;
+			SimAdvance();
+			CHECK(Sim.TxCount == 1U && Sim.Trr == 0U, "frame sent");
+			CHECK(SameFrame(Sim.BusFrame, Frame),
+				"Send frame on the bus");
+		}
+	}
+
+	/* XCanFd_Addto_Queue() and XCanFd_Send_Queue() */
+	Sim.TrrWrites = 0U;
+	Sim.TxWrong = 0U;
+	for (i = 0U; i < 3U; i++) {
+		GenFrame(SimPayload, 4U, TxId(i), i,
+				&App.TxBatch[i * XCANFD_FRAME_WORDS]);
+		CHECK(XCanFd_Addto_Queue(&Can,
+			&App.TxBatch[i * XCANFD_FRAME_WORDS], &Buf) ==
+			XST_SUCCESS, "Addto_Queue");
+	}
+	CHECK(Sim.Trr == 0U, "queued frames wait for Send_Queue");
+	Sim.TxCount = 0U;
+	(void)XCanFd_Send_Queue(&Can);
+	SimNow += 1000000U;
+	SimAdvance();
+	CHECK(Sim.TrrWrites == 1U, "one TRR write for the queue");
+	CHECK(Sim.TxCount == 3U && Sim.TxWrong == 0U &&
+		Sim.TxSeen[0] == 1U && Sim.TxSeen[1] == 1U &&
+		Sim.TxSeen[2] == 1U, "queued frames sent intact");
+	CHECK(Sim.Errors == 0U, "model errors");
+}
+
+/************************** Main *********************************************/
+
+int main(void)
+{
+	TestRxRing();
+	TestRxRingFull();
+	TestRxMailbox();
+	TestSendBulk();
+	TestSend();
+
+	printf("%s (%u failures)\n", Failures ? "FAILED" : "PASSED",
+							Failures);
+	return Failures ? 1 : 0;
+}
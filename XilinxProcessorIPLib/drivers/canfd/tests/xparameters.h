@@ -0,0 +1,12 @@
+/******************************************************************************
+* Copyright (C) 2020 Xilinx, Inc.  All rights reserved.
+* SPDX-License-Identifier: MIT
+******************************************************************************/
+
+/* Hardware parameters used by the host tests: one simulated CANFD */
+#ifndef XPARAMETERS_H
+#define XPARAMETERS_H
+
+#define XPAR_XCANFD_NUM_INSTANCES	1U
+
+#endif
@@ -701,6 +701,30 @@ typedef struct {
 						device. */
 } XDp_SbMsgLinkAddressReplyDeviceInfo;
 
+/**
+ * This typedef describes a CONNECTION_STATUS_NOTIFY sideband message, sent as
+ * an up request by a branch device when a device is plugged into or unplugged
+ * from one of its ports. This structure is used when the driver is operating
+ * in multi-stream transport (MST) mode.
+ */
+typedef struct {
+	u8 PortNum;			/**< The port number of the port whose
+						status changed. */
+	u8 Guid[XDP_GUID_NBYTES];	/**< The global unique identifier (GUID)
+						of the branch device that sent
+						the message. */
+	u8 LegacyDevPlugStatus;		/**< This port is connected to a legacy
+						device. */
+	u8 DpDevPlugStatus;		/**< There is a device connected to this
+						port. */
+	u8 MsgCapStatus;		/**< The device at this port can send
+						and receive MST messages. */
+	u8 InputPort;			/**< Specifies that this port is an
+						input port. */
+	u8 PeerDeviceType;		/**< Specifies the device type connected
+						to this port. */
+} XDp_SbMsgConnectionStatusNotify;
+
 /**
  * This typedef contains configuration information about the main link settings.
  */
@@ -1273,6 +1297,9 @@ void XDp_TxSetStreamSinkRad(XDp *InstancePtr, u8 Stream, u8 LinkCountTotal,
 u32 XDp_TxDiscoverTopology(XDp *InstancePtr);
 u32 XDp_TxFindAccessibleDpDevices(XDp *InstancePtr, u8 LinkCountTotal,
 							u8 *RelativeAddress);
+u32 XDp_TxUpdateBranchTopology(XDp *InstancePtr, u8 *Guid);
+u32 XDp_TxHandleConnectionStatusNotify(XDp *InstancePtr,
+				XDp_SbMsgConnectionStatusNotify *Notify);
 void XDp_TxTopologySwapSinks(XDp *InstancePtr, u8 Index0, u8 Index1);
 void XDp_TxTopologySortSinksByTiling(XDp *InstancePtr);
 
@@ -1313,6 +1340,8 @@ u32 XDp_TxSendSbMsgEnumPathResources(XDp *InstancePtr, u8 LinkCountTotal,
 u32 XDp_TxSendSbMsgAllocatePayload(XDp *InstancePtr, u8 LinkCountTotal,
 					u8 *RelativeAddress, u8 VcId, u16 Pbn);
 u32 XDp_TxSendSbMsgClearPayloadIdTable(XDp *InstancePtr);
+u32 XDp_TxReceiveConnectionStatusNotify(XDp *InstancePtr,
+				XDp_SbMsgConnectionStatusNotify *Notify);
 
 /* xdp_mst.c: Multi-stream transport (MST) utility functions. */
 void XDp_TxWriteGuid(XDp *InstancePtr, u8 LinkCountTotal, u8 *RelativeAddress,
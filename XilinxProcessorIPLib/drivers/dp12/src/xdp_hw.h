@@ -2453,6 +2453,9 @@
 #define XDP_DPCD_ADJ_REQ_PC2_LANE_2_SHIFT			4
 #define XDP_DPCD_ADJ_REQ_PC2_LANE_3_MASK			0xC0
 #define XDP_DPCD_ADJ_REQ_PC2_LANE_3_SHIFT			6
+/* 0x02003: SINK_DEVICE_SERVICE_IRQ_VECTOR_ESI0 */
+#define XDP_DPCD_ESI0_DOWN_REP_MSG_RDY_MASK			0x10
+#define XDP_DPCD_ESI0_UP_REQ_MSG_RDY_MASK			0x20
 /* @} */
 
 /******************************************************************************/
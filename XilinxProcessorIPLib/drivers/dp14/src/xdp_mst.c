@@ -172,10 +172,15 @@ static void XDp_RxReadDownReq(XDp *InstancePtr, XDp_SidebandMsg *Msg);
 
 #if XPAR_XDPTXSS_NUM_INSTANCES
 static u32 XDp_TxReceiveSbMsg(XDp *InstancePtr, XDp_SidebandReply *SbReply);
-static u32 XDp_TxWaitSbReply(XDp *InstancePtr);
+static u32 XDp_TxReadSbMsg(XDp *InstancePtr, u32 DpcdAddress, u8 RdyMask,
+		XDp_SidebandReply *SbReply, XDp_SidebandMsgHeader *Header);
+static u32 XDp_TxWaitSbMsgRdy(XDp *InstancePtr, u8 RdyMask);
+static u32 XDp_TxSendSbUpReply(XDp *InstancePtr, u8 RequestId,
+							u8 MsgSequenceNum);
 #endif /* XPAR_XDPTXSS_NUM_INSTANCES */
 
 static u32 XDp_Transaction2MsgFormat(u8 *Transaction, XDp_SidebandMsg *Msg);
+static u8 XDp_Msg2TransactionFormat(XDp_SidebandMsg *Msg, u8 *Transaction);
 
 #if XPAR_XDPRXSS_NUM_INSTANCES
 static u32 XDp_RxWriteRawDownReply(XDp *InstancePtr, u8 *Data, u8 DataLength);
@@ -232,6 +237,48 @@ u8 GuidTable[16][XDP_GUID_NBYTES] = {
 				0x33, 0x33, 0x33, 0x33, 0x33, 0x33, 0x33, 0x33}
 };
 
+/* CRC4 of each nibble value, generator polynomial x^4 + x + 1. */
+static const u8 XDp_Crc4Table[16] = {
+	0x00, 0x03, 0x06, 0x05, 0x0C, 0x0F, 0x0A, 0x09,
+	0x0B, 0x08, 0x0D, 0x0E, 0x07, 0x04, 0x01, 0x02
+};
+
+/* CRC8 of each byte value, generator polynomial x^8 + x^7 + x^6 + x^4 + x^2 + 1. */
+static const u8 XDp_Crc8Table[256] = {
+	0x00, 0xD5, 0x7F, 0xAA, 0xFE, 0x2B, 0x81, 0x54,
+	0x29, 0xFC, 0x56, 0x83, 0xD7, 0x02, 0xA8, 0x7D,
+	0x52, 0x87, 0x2D, 0xF8, 0xAC, 0x79, 0xD3, 0x06,
+	0x7B, 0xAE, 0x04, 0xD1, 0x85, 0x50, 0xFA, 0x2F,
+	0xA4, 0x71, 0xDB, 0x0E, 0x5A, 0x8F, 0x25, 0xF0,
+	0x8D, 0x58, 0xF2, 0x27, 0x73, 0xA6, 0x0C, 0xD9,
+	0xF6, 0x23, 0x89, 0x5C, 0x08, 0xDD, 0x77, 0xA2,
+	0xDF, 0x0A, 0xA0, 0x75, 0x21, 0xF4, 0x5E, 0x8B,
+	0x9D, 0x48, 0xE2, 0x37, 0x63, 0xB6, 0x1C, 0xC9,
+	0xB4, 0x61, 0xCB, 0x1E, 0x4A, 0x9F, 0x35, 0xE0,
+	0xCF, 0x1A, 0xB0, 0x65, 0x31, 0xE4, 0x4E, 0x9B,
+	0xE6, 0x33, 0x99, 0x4C, 0x18, 0xCD, 0x67, 0xB2,
+	0x39, 0xEC, 0x46, 0x93, 0xC7, 0x12, 0xB8, 0x6D,
+	0x10, 0xC5, 0x6F, 0xBA, 0xEE, 0x3B, 0x91, 0x44,
+	0x6B, 0xBE, 0x14, 0xC1, 0x95, 0x40, 0xEA, 0x3F,
+	0x42, 0x97, 0x3D, 0xE8, 0xBC, 0x69, 0xC3, 0x16,
+	0xEF, 0x3A, 0x90, 0x45, 0x11, 0xC4, 0x6E, 0xBB,
+	0xC6, 0x13, 0xB9, 0x6C, 0x38, 0xED, 0x47, 0x92,
+	0xBD, 0x68, 0xC2, 0x17, 0x43, 0x96, 0x3C, 0xE9,
+	0x94, 0x41, 0xEB, 0x3E, 0x6A, 0xBF, 0x15, 0xC0,
+	0x4B, 0x9E, 0x34, 0xE1, 0xB5, 0x60, 0xCA, 0x1F,
+	0x62, 0xB7, 0x1D, 0xC8, 0x9C, 0x49, 0xE3, 0x36,
+	0x19, 0xCC, 0x66, 0xB3, 0xE7, 0x32, 0x98, 0x4D,
+	0x30, 0xE5, 0x4F, 0x9A, 0xCE, 0x1B, 0xB1, 0x64,
+	0x72, 0xA7, 0x0D, 0xD8, 0x8C, 0x59, 0xF3, 0x26,
+	0x5B, 0x8E, 0x24, 0xF1, 0xA5, 0x70, 0xDA, 0x0F,
+	0x20, 0xF5, 0x5F, 0x8A, 0xDE, 0x0B, 0xA1, 0x74,
+	0x09, 0xDC, 0x76, 0xA3, 0xF7, 0x22, 0x88, 0x5D,
+	0xD6, 0x03, 0xA9, 0x7C, 0x28, 0xFD, 0x57, 0x82,
+	0xFF, 0x2A, 0x80, 0x55, 0x01, 0xD4, 0x7E, 0xAB,
+	0x84, 0x51, 0xFB, 0x2E, 0x7A, 0xAF, 0x05, 0xD0,
+	0xAD, 0x78, 0xD2, 0x07, 0x53, 0x86, 0x2C, 0xF9
+};
+
 /**************************** Function Definitions ****************************/
 
 #if XPAR_XDPTXSS_NUM_INSTANCES
@@ -766,6 +813,155 @@ u32 XDp_TxFindAccessibleDpDevices(XDp *InstancePtr, u8 LinkCountTotal,
 	return XST_SUCCESS;
 }
 
+/******************************************************************************/
+/**
+ * This function will refresh the part of the topology below a single branch
+ * device, for example the branch device that sent a CONNECTION_STATUS_NOTIFY
+ * sideband message. The branch device is looked up by its GUID in the
+ * topology's node table. It and all devices downstream of it are removed from
+ * the node table and the sink list, and only that branch is explored again
+ * using the XDp_TxFindAccessibleDpDevices algorithm. The rest of the topology
+ * is kept as it is, so no sideband messages are sent to other branches.
+ *
+ * @param	InstancePtr is a pointer to the XDp instance.
+ * @param	Guid is the global unique identifier of the branch device to
+ *		explore again.
+ *
+ * @return
+ *		- XST_SUCCESS if the branch was explored again successfully.
+ *		- XST_DEVICE_NOT_FOUND if no branch device in the topology has
+ *		  the given GUID.
+ *		- XST_FAILURE otherwise - if sending a LINK_ADDRESS sideband
+ *		  message to one of the branch devices below the branch failed.
+ *
+ * @note	The contents of the InstancePtr->TxInstance.Topology structure
+ *		will be modified. The sinks found below the branch are appended
+ *		to the end of the sink list, the order of the other sinks is
+ *		kept.
+ *
+*******************************************************************************/
+u32 XDp_TxUpdateBranchTopology(XDp *InstancePtr, u8 *Guid)
+{
+	u8 Index;
+	u8 NodeIndex;
+	u8 NewTotal;
+	u8 BranchLct = 0;
+	u8 RelativeAddress[15];
+	u8 NewIndex[63];
+	XDp_TxTopology *Topology;
+	XDp_TxTopologyNode *Node;
+
+	/* Verify arguments. */
+	Xil_AssertNonvoid(InstancePtr != NULL);
+	Xil_AssertNonvoid(InstancePtr->IsReady == XIL_COMPONENT_IS_READY);
+	Xil_AssertNonvoid(XDp_GetCoreType(InstancePtr) == XDP_TX);
+	Xil_AssertNonvoid(Guid != NULL);
+
+	Topology = &InstancePtr->TxInstance.Topology;
+
+	/* Find the branch device with the given GUID. */
+	for (NodeIndex = 0; NodeIndex < Topology->NodeTotal; NodeIndex++) {
+		Node = &Topology->NodeTable[NodeIndex];
+		if ((Node->DeviceType == 0x02) &&
+				(memcmp(Node->Guid, Guid, XDP_GUID_NBYTES) == 0)) {
+			BranchLct = Node->LinkCountTotal;
+			memcpy(RelativeAddress, Node->RelativeAddress,
+						sizeof(RelativeAddress));
+			break;
+		}
+	}
+	if (BranchLct == 0) {
+		return XST_DEVICE_NOT_FOUND;
+	}
+
+	/* Remove the branch and its downstream devices from the node table;
+	 * these are the nodes whose RAD starts with the branch's RAD. */
+	NewTotal = 0;
+	for (NodeIndex = 0; NodeIndex < Topology->NodeTotal; NodeIndex++) {
+		Node = &Topology->NodeTable[NodeIndex];
+		if ((Node->LinkCountTotal >= BranchLct) &&
+				(memcmp(Node->RelativeAddress, RelativeAddress,
+							BranchLct - 1) == 0)) {
+			NewIndex[NodeIndex] = 0xFF;
+			continue;
+		}
+		if (NewTotal != NodeIndex) {
+			Topology->NodeTable[NewTotal] = *Node;
+		}
+		NewIndex[NodeIndex] = NewTotal;
+		NewTotal++;
+	}
+
+	/* Re-point the remaining sinks at their moved nodes. */
+	Index = 0;
+	for (NodeIndex = 0; NodeIndex < Topology->SinkTotal; NodeIndex++) {
+		u8 OldIndex = Topology->SinkList[NodeIndex] -
+							Topology->NodeTable;
+
+		if (NewIndex[OldIndex] != 0xFF) {
+			Topology->SinkList[Index] =
+				&Topology->NodeTable[NewIndex[OldIndex]];
+			Index++;
+		}
+	}
+	Topology->SinkTotal = Index;
+	Topology->NodeTotal = NewTotal;
+
+	/* Explore only the branch that changed. */
+	return XDp_TxFindAccessibleDpDevices(InstancePtr, BranchLct,
+							RelativeAddress);
+}
+
+/******************************************************************************/
+/**
+ * This function will handle a CONNECTION_STATUS_NOTIFY sideband message sent
+ * by a branch device when a device is plugged into or unplugged from one of its
+ * ports. The message is received and acknowledged using
+ * XDp_TxReceiveConnectionStatusNotify, then the part of the topology below the
+ * branch device that sent it is refreshed using XDp_TxUpdateBranchTopology.
+ *
+ * @param	InstancePtr is a pointer to the XDp instance.
+ * @param	Notify is a pointer to the structure that will be filled in
+ *		with the contents of the message.
+ *
+ * @return
+ *		- XST_SUCCESS if the message was received and the branch was
+ *		  explored again successfully.
+ *		- XST_DEVICE_NOT_FOUND if no RX device is connected, or if the
+ *		  branch device that sent the message is not in the topology. In
+ *		  the latter case the whole topology should be discovered again.
+ *		- XST_ERROR_COUNT_MAX if waiting for the message, or an AUX
+ *		  request timed out.
+ *		- XST_FAILURE otherwise - if receiving the message failed, the
+ *		  message is not a CONNECTION_STATUS_NOTIFY, or sending a
+ *		  LINK_ADDRESS sideband message to one of the branch devices
+ *		  below the branch failed.
+ *
+ * @note	Call this function when the RX device indicates that an up
+ *		request is ready, by setting the UP_REQ_MSG_RDY bit of the
+ *		SINK_DEVICE_SERVICE_IRQ_VECTOR_ESI0 DPCD register after a HPD
+ *		pulse.
+ *
+*******************************************************************************/
+u32 XDp_TxHandleConnectionStatusNotify(XDp *InstancePtr,
+				XDp_SbMsgConnectionStatusNotify *Notify)
+{
+	u32 Status;
+
+	/* Verify arguments. */
+	Xil_AssertNonvoid(InstancePtr != NULL);
+	Xil_AssertNonvoid(InstancePtr->IsReady == XIL_COMPONENT_IS_READY);
+	Xil_AssertNonvoid(XDp_GetCoreType(InstancePtr) == XDP_TX);
+	Xil_AssertNonvoid(Notify != NULL);
+
+	Status = XDp_TxReceiveConnectionStatusNotify(InstancePtr, Notify);
+	if (Status != XST_SUCCESS) {
+		return Status;
+	}
+
+	return XDp_TxUpdateBranchTopology(InstancePtr, Notify->Guid);
+}
+
 /******************************************************************************/
 /**
  * Swap the ordering of the sinks in the topology's sink list. All sink
@@ -2231,6 +2427,81 @@ u32 XDp_TxSendSbMsgClearPayloadIdTable(XDp *InstancePtr)
 	return Status;
 }
 
+/******************************************************************************/
+/**
+ * This function will receive a CONNECTION_STATUS_NOTIFY sideband message, sent
+ * as an up request by a branch device when a device is plugged into or
+ * unplugged from one of its ports, and acknowledge it with an up reply.
+ *
+ * @param	InstancePtr is a pointer to the XDp instance.
+ * @param	Notify is a pointer to the structure that will be filled in
+ *		with the contents of the message.
+ *
+ * @return
+ *		- XST_SUCCESS if the message was received and acknowledged.
+ *		- XST_DEVICE_NOT_FOUND if no RX device is connected.
+ *		- XST_ERROR_COUNT_MAX if either waiting for the message, or an
+ *		  AUX request timed out.
+ *		- XST_FAILURE otherwise - if an AUX read or write transaction
+ *		  failed, the header or body CRC did not match the calculated
+ *		  value, or the up request is not a CONNECTION_STATUS_NOTIFY.
+ *
+ * @note	Any other up request that is received correctly is also
+ *		acknowledged, so that the branch device does not send it again.
+ *
+*******************************************************************************/
+u32 XDp_TxReceiveConnectionStatusNotify(XDp *InstancePtr,
+				XDp_SbMsgConnectionStatusNotify *Notify)
+{
+	u32 Status;
+	u8 Index;
+	XDp_SidebandReply SbMsgReq;
+	XDp_SidebandMsgHeader Header;
+
+	/* Verify arguments. */
+	Xil_AssertNonvoid(InstancePtr != NULL);
+	Xil_AssertNonvoid(InstancePtr->IsReady == XIL_COMPONENT_IS_READY);
+	Xil_AssertNonvoid(XDp_GetCoreType(InstancePtr) == XDP_TX);
+	Xil_AssertNonvoid(Notify != NULL);
+
+	Status = XDp_TxReadSbMsg(InstancePtr, XDP_DPCD_UP_REQ,
+			XDP_DPCD_ESI0_UP_REQ_MSG_RDY_MASK, &SbMsgReq, &Header);
+	if (Status != XST_SUCCESS) {
+		/* Either an AUX read or write transaction failed, there was a
+		 * time out waiting for the request, or a CRC check failed. */
+		return Status;
+	}
+	if (SbMsgReq.Length == 0) {
+		return XST_FAILURE;
+	}
+
+	Status = XDp_TxSendSbUpReply(InstancePtr, SbMsgReq.Data[0],
+							Header.MsgSequenceNum);
+	if (Status != XST_SUCCESS) {
+		/* The AUX write transaction used to send the up reply
+		 * failed. */
+		return Status;
+	}
+
+	/* Request identifier, port number, GUID and port status. */
+	if ((SbMsgReq.Data[0] != XDP_SBMSG_CONNECTION_STATUS_NOTIFY) ||
+						(SbMsgReq.Length < 19)) {
+		return XST_FAILURE;
+	}
+
+	Notify->PortNum = SbMsgReq.Data[1] >> 4;
+	for (Index = 0; Index < XDP_GUID_NBYTES; Index++) {
+		Notify->Guid[Index] = SbMsgReq.Data[2 + Index];
+	}
+	Notify->LegacyDevPlugStatus = (SbMsgReq.Data[18] & 0x40) >> 6;
+	Notify->DpDevPlugStatus = (SbMsgReq.Data[18] & 0x20) >> 5;
+	Notify->MsgCapStatus = (SbMsgReq.Data[18] & 0x10) >> 4;
+	Notify->InputPort = (SbMsgReq.Data[18] & 0x08) >> 3;
+	Notify->PeerDeviceType = SbMsgReq.Data[18] & 0x07;
+
+	return XST_SUCCESS;
+}
+
 /******************************************************************************/
 /**
  * This function will write a global unique identifier (GUID) to the target
@@ -3493,10 +3764,7 @@ static u32 XDp_SendSbMsgFragment(XDp *InstancePtr, XDp_SidebandMsg *Msg)
 {
 	u32 Status;
 	u8 Data[XDP_MAX_LENGTH_SBMSG];
-	XDp_SidebandMsgHeader *Header = &Msg->Header;
-	XDp_SidebandMsgBody *Body = &Msg->Body;
-	u8 FragmentOffset;
-	u8 Index;
+	u8 Length;
 
 	XDp_WaitUs(InstancePtr, InstancePtr->TxInstance.SbMsgDelayUs);
 
@@ -3504,7 +3772,7 @@ static u32 XDp_SendSbMsgFragment(XDp *InstancePtr, XDp_SidebandMsg *Msg)
 	if (XDp_GetCoreType(InstancePtr) == XDP_TX) {
 		/* First, clear the DOWN_REP_MSG_RDY in case the RX device is in
 		 * a weird state. */
-		Data[0] = 0x10;
+		Data[0] = XDP_DPCD_ESI0_DOWN_REP_MSG_RDY_MASK;
 		Status = XDp_TxAuxWrite(InstancePtr,
 				XDP_DPCD_SINK_DEVICE_SERVICE_IRQ_VECTOR_ESI0, 1,
 				Data);
@@ -3514,52 +3782,19 @@ static u32 XDp_SendSbMsgFragment(XDp *InstancePtr, XDp_SidebandMsg *Msg)
 	}
 #endif /* XPAR_XDPTXSS_NUM_INSTANCES */
 
-	/* Add the header to the sideband message transaction. */
-	Msg->Header.MsgHeaderLength = 0;
-	Data[Msg->Header.MsgHeaderLength++] =
-					(Msg->Header.LinkCountTotal << 4) |
-					Msg->Header.LinkCountRemaining;
-	for (Index = 0; Index < (Header->LinkCountTotal - 1); Index += 2) {
-		Data[Header->MsgHeaderLength] =
-					(Header->RelativeAddress[Index] << 4);
-
-		if ((Index + 1) < (Header->LinkCountTotal - 1)) {
-			Data[Header->MsgHeaderLength] |=
-					Header->RelativeAddress[Index + 1];
-		}
-		/* Else, the lower (4-bit) nibble is all zeros (for
-		 * byte-alignment). */
-
-		Header->MsgHeaderLength++;
-	}
-	Data[Header->MsgHeaderLength++] = (Header->BroadcastMsg << 7) |
-				(Header->PathMsg << 6) | Header->MsgBodyLength;
-	Data[Header->MsgHeaderLength++] = (Header->StartOfMsgTransaction << 7) |
-				(Header->EndOfMsgTransaction << 6) |
-				(Header->MsgSequenceNum << 4) | Header->Crc;
-
-	/* Add the body to the transaction. */
-	FragmentOffset = (Msg->FragmentNum * (XDP_MAX_LENGTH_SBMSG -
-					Msg->Header.MsgHeaderLength - 1));
-	for (Index = 0; Index < Body->MsgDataLength; Index++) {
-		Data[Index + Header->MsgHeaderLength] =
-					Body->MsgData[Index + FragmentOffset];
-	}
-	Data[Index + Header->MsgHeaderLength] = Body->Crc;
+	/* Add the header and the body to the sideband message transaction. */
+	Length = XDp_Msg2TransactionFormat(Msg, Data);
 
 	/* Submit the message. */
 #if XPAR_XDPTXSS_NUM_INSTANCES
 	if (XDp_GetCoreType(InstancePtr) == XDP_TX) {
-		Status = XDp_TxAuxWrite(InstancePtr, XDP_DPCD_DOWN_REQ,
-			Msg->Header.MsgHeaderLength + Msg->Header.MsgBodyLength,
-			Data);
+		Status = XDp_TxAuxWrite(InstancePtr, XDP_DPCD_DOWN_REQ, Length,
+									Data);
 	} else
 #endif /* XPAR_XDPTXSS_NUM_INSTANCES */
 #if XPAR_XDPRXSS_NUM_INSTANCES
 	if (XDp_GetCoreType(InstancePtr) == XDP_RX) {
-		Status = XDp_RxWriteRawDownReply(InstancePtr, Data,
-						Msg->Header.MsgHeaderLength +
-						Msg->Header.MsgBodyLength);
+		Status = XDp_RxWriteRawDownReply(InstancePtr, Data, Length);
 	}
 #endif /* XPAR_XDPRXSS_NUM_INSTANCES */
 	{
@@ -3623,6 +3858,53 @@ static void XDp_RxReadDownReq(XDp *InstancePtr, XDp_SidebandMsg *Msg)
  *
 *******************************************************************************/
 static u32 XDp_TxReceiveSbMsg(XDp *InstancePtr, XDp_SidebandReply *SbReply)
+{
+	u32 Status;
+
+	Status = XDp_TxReadSbMsg(InstancePtr, XDP_DPCD_DOWN_REP,
+			XDP_DPCD_ESI0_DOWN_REP_MSG_RDY_MASK, SbReply, NULL);
+	if (Status != XST_SUCCESS) {
+		return Status;
+	}
+
+	/* Check if the reply indicates a NACK. */
+	if ((SbReply->Data[0] & 0x80) == 0x80) {
+		return XST_FAILURE;
+	}
+
+	return XST_SUCCESS;
+}
+
+/******************************************************************************/
+/**
+ * This function will read all fragments of a sideband message transaction from
+ * one of the sideband message buffers of the RX device directly downstream to
+ * the DisplayPort TX, and collect the body data of the fragments.
+ *
+ * @param	InstancePtr is a pointer to the XDp instance.
+ * @param	DpcdAddress is the DPCD address of the buffer: XDP_DPCD_DOWN_REP
+ *		for down replies or XDP_DPCD_UP_REQ for up requests.
+ * @param	RdyMask is the bit of the SINK_DEVICE_SERVICE_IRQ_VECTOR_ESI0
+ *		register that indicates a new fragment in the buffer.
+ * @param	SbReply is a pointer to the structure that this function will
+ *		fill in with the body data of the transaction.
+ * @param	Header, if not NULL, will be filled in with the header of the
+ *		last fragment.
+ *
+ * @return
+ *		- XST_SUCCESS if the whole transaction was read.
+ *              - XST_DEVICE_NOT_FOUND if no RX device is connected.
+ *		- XST_ERROR_COUNT_MAX if either waiting for a fragment, or an
+ *		  AUX request timed out.
+ *		- XST_FAILURE otherwise - if an AUX read or write transaction
+ *		  failed, or the header or body CRC did not match the
+ *		  calculated value.
+ *
+ * @note	Each fragment is acknowledged by clearing RdyMask.
+ *
+*******************************************************************************/
+static u32 XDp_TxReadSbMsg(XDp *InstancePtr, u32 DpcdAddress, u8 RdyMask,
+		XDp_SidebandReply *SbReply, XDp_SidebandMsgHeader *Header)
 {
 	u32 Status;
 	u8 Index = 0;
@@ -3635,22 +3917,20 @@ static u32 XDp_TxReceiveSbMsg(XDp *InstancePtr, XDp_SidebandReply *SbReply)
 	do {
 		XDp_WaitUs(InstancePtr, InstancePtr->TxInstance.SbMsgDelayUs);
 
-		/* Wait for a reply. */
-		Status = XDp_TxWaitSbReply(InstancePtr);
+		/* Wait for a fragment. */
+		Status = XDp_TxWaitSbMsgRdy(InstancePtr, RdyMask);
 		if (Status != XST_SUCCESS) {
 			return Status;
 		}
 
-		/* Receive reply. */
-		Status = XDp_TxAuxRead(InstancePtr, XDP_DPCD_DOWN_REP, 80,
-								AuxData);
+		/* Receive the fragment. */
+		Status = XDp_TxAuxRead(InstancePtr, DpcdAddress, 80, AuxData);
 		if (Status != XST_SUCCESS) {
 			/* The AUX read transaction failed. */
 			return Status;
 		}
 
-		/* Convert the reply transaction into XDp_SidebandReply
-		 * format. */
+		/* Convert the transaction into XDp_SidebandReply format. */
 		Status = XDp_Transaction2MsgFormat(AuxData, &Msg);
 		if (Status != XST_SUCCESS) {
 			/* The CRC of the header or the body did not match the
@@ -3665,7 +3945,7 @@ static u32 XDp_TxReceiveSbMsg(XDp *InstancePtr, XDp_SidebandReply *SbReply)
 		}
 
 		/* Clear. */
-		AuxData[0] = 0x10;
+		AuxData[0] = RdyMask;
 		Status = XDp_TxAuxWrite(InstancePtr,
 				XDP_DPCD_SINK_DEVICE_SERVICE_IRQ_VECTOR_ESI0,
 				1, AuxData);
@@ -3676,9 +3956,8 @@ static u32 XDp_TxReceiveSbMsg(XDp *InstancePtr, XDp_SidebandReply *SbReply)
 	}
 	while (Msg.Header.EndOfMsgTransaction == 0);
 
-	/* Check if the reply indicates a NACK. */
-	if ((SbReply->Data[0] & 0x80) == 0x80) {
-		return XST_FAILURE;
+	if (Header != NULL) {
+		*Header = Msg.Header;
 	}
 
 	return XST_SUCCESS;
@@ -3687,23 +3966,26 @@ static u32 XDp_TxReceiveSbMsg(XDp *InstancePtr, XDp_SidebandReply *SbReply)
 /******************************************************************************/
 /**
  * This function will wait until the RX device directly downstream to the
- * DisplayPort TX indicates that a sideband reply is ready to be received by
- * the source.
+ * DisplayPort TX indicates that a sideband message fragment is ready to be
+ * received by the source.
  *
  * @param	InstancePtr is a pointer to the XDp instance.
+ * @param	RdyMask is the bit of the SINK_DEVICE_SERVICE_IRQ_VECTOR_ESI0
+ *		register to wait for: XDP_DPCD_ESI0_DOWN_REP_MSG_RDY_MASK for a
+ *		reply or XDP_DPCD_ESI0_UP_REQ_MSG_RDY_MASK for an up request.
  *
  * @return
- *		- XST_SUCCESS if a reply message is ready.
+ *		- XST_SUCCESS if a message fragment is ready.
  *		- XST_DEVICE_NOT_FOUND if no RX device is connected.
- *		- XST_ERROR_COUNT_MAX if either waiting for a reply, or the AUX
- *		  read request timed out.
+ *		- XST_ERROR_COUNT_MAX if either waiting for a message, or the
+ *		  AUX read request timed out.
  *		- XST_FAILURE if the AUX read transaction failed while accessing
  *		  the RX device.
  *
  * @note	None.
  *
 *******************************************************************************/
-static u32 XDp_TxWaitSbReply(XDp *InstancePtr)
+static u32 XDp_TxWaitSbMsgRdy(XDp *InstancePtr, u8 RdyMask)
 {
 	u32 Status;
 	u8 AuxData;
@@ -3726,10 +4008,59 @@ static u32 XDp_TxWaitSbReply(XDp *InstancePtr)
 		TimeoutCount++;
 		XDp_WaitUs(InstancePtr, 1000);
 	}
-	while ((AuxData & 0x10) != 0x10);
+	while ((AuxData & RdyMask) != RdyMask);
 
 	return XST_SUCCESS;
 }
+
+/******************************************************************************/
+/**
+ * This function will acknowledge an up request from the RX device directly
+ * downstream to the DisplayPort TX by writing an up reply.
+ *
+ * @param	InstancePtr is a pointer to the XDp instance.
+ * @param	RequestId is the request identifier of the up request.
+ * @param	MsgSequenceNum is the message sequence number of the up
+ *		request.
+ *
+ * @return
+ *		- XST_SUCCESS if the up reply was written.
+ *		- XST_DEVICE_NOT_FOUND if no RX device is connected.
+ *		- XST_ERROR_COUNT_MAX if the AUX request timed out.
+ *		- XST_FAILURE otherwise.
+ *
+ * @note	None.
+ *
+*******************************************************************************/
+static u32 XDp_TxSendSbUpReply(XDp *InstancePtr, u8 RequestId,
+							u8 MsgSequenceNum)
+{
+	XDp_SidebandMsg Msg;
+	u8 Data[XDP_MAX_LENGTH_SBMSG];
+	u8 Length;
+
+	Msg.FragmentNum = 0;
+
+	/* Prepare the sideband message header. */
+	Msg.Header.LinkCountTotal = 1;
+	Msg.Header.LinkCountRemaining = 0;
+	Msg.Header.BroadcastMsg = 0;
+	Msg.Header.PathMsg = 0;
+	Msg.Header.MsgBodyLength = 2;
+	Msg.Header.StartOfMsgTransaction = 1;
+	Msg.Header.EndOfMsgTransaction = 1;
+	Msg.Header.MsgSequenceNum = MsgSequenceNum;
+	Msg.Header.Crc = XDp_Crc4CalculateHeader(&Msg.Header);
+
+	/* Prepare the sideband message body: an ACK of the request. */
+	Msg.Body.MsgData[0] = RequestId & 0x7F;
+	Msg.Body.MsgDataLength = Msg.Header.MsgBodyLength - 1;
+	Msg.Body.Crc = XDp_Crc8CalculateBody(&Msg);
+
+	Length = XDp_Msg2TransactionFormat(&Msg, Data);
+
+	return XDp_TxAuxWrite(InstancePtr, XDP_DPCD_UP_REP, Length, Data);
+}
 #endif /* XPAR_XDPTXSS_NUM_INSTANCES */
 
 /******************************************************************************/
@@ -3818,6 +4149,67 @@ static u32 XDp_Transaction2MsgFormat(u8 *Transaction, XDp_SidebandMsg *Msg)
 	return XST_SUCCESS;
 }
 
+/******************************************************************************/
+/**
+ * This function will take a sideband message structure and convert it into the
+ * byte array that is written to a sideband message buffer. This is the reverse
+ * of XDp_Transaction2MsgFormat.
+ *
+ * @param	Msg is a pointer to the sideband message structure to convert.
+ *		Its MsgHeaderLength is set by this function.
+ * @param	Transaction is the pointer to the array that will be filled in,
+ *		of at least XDP_MAX_LENGTH_SBMSG bytes.
+ *
+ * @return	The number of bytes of the transaction.
+ *
+ * @note	For a message split into fragments, the body data of fragment
+ *		Msg->FragmentNum is used.
+ *
+*******************************************************************************/
+static u8 XDp_Msg2TransactionFormat(XDp_SidebandMsg *Msg, u8 *Transaction)
+{
+	XDp_SidebandMsgHeader *Header = &Msg->Header;
+	XDp_SidebandMsgBody *Body = &Msg->Body;
+	u8 FragmentOffset;
+	u8 Index;
+
+	/* Add the header to the sideband message transaction. */
+	Header->MsgHeaderLength = 0;
+	Transaction[Header->MsgHeaderLength++] =
+					(Header->LinkCountTotal << 4) |
+					Header->LinkCountRemaining;
+	for (Index = 0; Index < (Header->LinkCountTotal - 1); Index += 2) {
+		Transaction[Header->MsgHeaderLength] =
+					(Header->RelativeAddress[Index] << 4);
+
+		if ((Index + 1) < (Header->LinkCountTotal - 1)) {
+			Transaction[Header->MsgHeaderLength] |=
+					Header->RelativeAddress[Index + 1];
+		}
+		/* Else, the lower (4-bit) nibble is all zeros (for
+		 * byte-alignment). */
+
+		Header->MsgHeaderLength++;
+	}
+	Transaction[Header->MsgHeaderLength++] = (Header->BroadcastMsg << 7) |
+				(Header->PathMsg << 6) | Header->MsgBodyLength;
+	Transaction[Header->MsgHeaderLength++] =
+				(Header->StartOfMsgTransaction << 7) |
+				(Header->EndOfMsgTransaction << 6) |
+				(Header->MsgSequenceNum << 4) | Header->Crc;
+
+	/* Add the body to the transaction. */
+	FragmentOffset = (Msg->FragmentNum * (XDP_MAX_LENGTH_SBMSG -
+					Header->MsgHeaderLength - 1));
+	for (Index = 0; Index < Body->MsgDataLength; Index++) {
+		Transaction[Index + Header->MsgHeaderLength] =
+					Body->MsgData[Index + FragmentOffset];
+	}
+	Transaction[Index + Header->MsgHeaderLength] = Body->Crc;
+
+	return Header->MsgHeaderLength + Header->MsgBodyLength;
+}
+
 #if XPAR_XDPRXSS_NUM_INSTANCES
 /******************************************************************************/
 /**
@@ -4030,76 +4422,32 @@ static u8 XDp_Crc8CalculateBody(XDp_SidebandMsg *Msg)
  * @return	The CRC value obtained by running the algorithm on the data
  *		using the specified polynomial.
  *
- * @note	None.
+ * @note	The data is processed a nibble (CRC4) or a byte (CRC8) at a time
+ *		using the XDp_Crc4Table and XDp_Crc8Table lookup tables.
  *
 *******************************************************************************/
 static u8 XDp_CrcCalculate(const u8 *Data, u32 NumberOfBits, u8 Polynomial)
 {
-	u8 BitMask;
-	u8 BitShift;
-	u8 ArrayIndex = 0;
-	u16 Remainder = 0;
+	u32 ArrayIndex;
+	u8 Remainder = 0;
 
 	if (Polynomial == 4) {
 		/* For CRC4, expecting nibbles (4-bits). */
-		BitMask = 0x08;
-		BitShift = 3;
+		for (ArrayIndex = 0; ArrayIndex < (NumberOfBits / 4);
+							ArrayIndex++) {
+			Remainder = XDp_Crc4Table[(Remainder ^ Data[ArrayIndex])
+									& 0x0F];
+		}
 	}
 	else {
 		/* For CRC8, expecting bytes (8-bits). */
-		BitMask = 0x80;
-		BitShift = 7;
-	}
-
-	while (NumberOfBits != 0) {
-		NumberOfBits--;
-
-		Remainder <<= 1;
-		Remainder |= (Data[ArrayIndex] & BitMask) >> BitShift;
-
-		BitMask >>= 1;
-		BitShift--;
-
-		if (BitMask == 0) {
-			if (Polynomial == 4) {
-				BitMask = 0x08;
-				BitShift = 3;
-			}
-			else {
-				BitMask = 0x80;
-				BitShift = 7;
-			}
-			ArrayIndex++;
-		}
-
-		if ((Remainder & (1 << Polynomial)) != 0) {
-			if (Polynomial == 4) {
-				Remainder ^= 0x13;
-			}
-			else {
-				Remainder ^= 0xD5;
-			}
-		}
-	}
-
-	NumberOfBits = Polynomial;
-	while (NumberOfBits != 0) {
-		NumberOfBits--;
-
-		Remainder <<= 1;
-
-		if ((Remainder & (1 << Polynomial)) != 0) {
-			if (Polynomial == 4) {
-				Remainder ^= 0x13;
-				Remainder &= 0xFF;
-			}
-			else {
-				Remainder ^= 0xD5;
-			}
+		for (ArrayIndex = 0; ArrayIndex < (NumberOfBits / 8);
+							ArrayIndex++) {
+			Remainder = XDp_Crc8Table[Remainder ^ Data[ArrayIndex]];
 		}
 	}
 
-	return Remainder & 0xFF;
+	return Remainder;
 }
 
 #if XPAR_XDPTXSS_NUM_INSTANCES
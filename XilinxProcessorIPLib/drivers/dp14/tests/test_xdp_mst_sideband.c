@@ -0,0 +1,998 @@
+/******************************************************************************
+* Copyright (C) 2020 Xilinx, Inc.  All rights reserved.
+* SPDX-License-Identifier: MIT
+******************************************************************************/
+
+/*****************************************************************************/
+/**
+*
+* @file test_xdp_mst_sideband.c
+*
+* Host test of the MST sideband message code in xdp_mst.c against a simulated
+* topology of branch devices. The simulator stands in for the AUX channel: it
+* decodes the down requests written to DOWN_REQ, routes them by relative
+* address, queues the replies in DOWN_REP (split into fragments) and raises
+* DOWN_REP_MSG_RDY once a reply has crossed the hops back to the source. It
+* also queues up requests in UP_REQ and decodes the up replies. All headers
+* and bodies are encoded and checked with a bit at a time CRC, independent of
+* the driver's tables. AUX transactions and waits advance a simulated clock.
+*
+* The test checks the table CRCs against the bitwise CRC, topology discovery,
+* CONNECTION_STATUS_NOTIFY reception and acknowledgment, and the refresh of
+* the branch that sent it, which must give the same topology as discovering
+* it again while only sending LINK_ADDRESS messages below that branch. It
+* reports the simulated hotplug to topology time of both on a daisy chain.
+*
+* Build and run on the host:
+*   cc -Wall -O2 -I. -I../src -I../../video_common/src \
+*      -I../../../../lib/bsp/standalone/src/common \
+*      test_xdp_mst_sideband.c -o test_xdp_mst_sideband
+*   ./test_xdp_mst_sideband
+*
+******************************************************************************/
+
+/***************************** Include Files *********************************/
+
+#include <stdio.h>
+#include <string.h>
+#include <stdlib.h>
+#include <time.h>
+
+/* Build the standalone (non Linux) flavour of the driver */
+#undef __linux__
+#include "xil_types.h"
+#include "xparameters.h"
+#define INLINE inline
+
+/* No core register is accessed by the sideband message code */
+#define XIL_IO_H
+static inline u32 Xil_In32(UINTPTR Addr)
+{
+	(void)Addr;
+	return 0U;
+}
+static inline void Xil_Out32(UINTPTR Addr, u32 Value)
+{
+	(void)Addr;
+	(void)Value;
+}
+
+#define XIL_PRINTF_H
+#define xil_printf	printf
+
+#include "../src/xdp_mst.c"
+
+/************************** Constant Definitions *****************************/
+
+#define SIM_MAX_BRANCHES	16
+#define SIM_MAX_PORTS		8
+#define SIM_MAX_FRAGMENTS	16
+
+/* Sideband buffer size and AUX timing: 16 bytes per AUX request */
+#define SIM_SBMSG_LEN		48
+#define SIM_AUX_REQ_US		100U
+#define SIM_AUX_BYTE_US		10U
+/* A branch device takes this long to relay or answer a request */
+#define SIM_HOP_US		1500U
+
+#define PEER_NONE		0
+#define PEER_SOURCE		1
+#define PEER_BRANCH		2
+#define PEER_SST_SINK		3
+#define PEER_CONVERTER		4
+
+#define NUM_CRC_RUNS		200000U
+
+/**************************** Type Definitions *******************************/
+
+typedef struct {
+	u8 PeerDeviceType;
+	u8 Branch;		/* Index of the branch device if a branch */
+} SimPort;
+
+typedef struct {
+	u8 Guid[XDP_GUID_NBYTES];
+	u8 NumPorts;		/* Output ports 1 to NumPorts, 0 is input */
+	SimPort Ports[SIM_MAX_PORTS];
+	u32 LinkAddressCount;
+} SimBranch;
+
+typedef struct {
+	u8 Data[SIM_SBMSG_LEN];
+	u32 ReadyUs;
+} SimFragment;
+
+typedef struct {
+	SimFragment Frag[SIM_MAX_FRAGMENTS];
+	u32 Head;
+	u32 Count;
+} SimQueue;
+
+typedef struct {
+	u8 Lct;
+	u8 Lcr;
+	u8 Rad[15];
+	u8 Somt;
+	u8 Eomt;
+	u8 Seq;
+	u8 BodyLength;		/* Data bytes, without the body CRC */
+	u8 Body[SIM_SBMSG_LEN];
+} SimMsg;
+
+/************************** Variable Definitions *****************************/
+
+static u32 Failures;
+
+static XDp Dp;
+static SimBranch Branches[SIM_MAX_BRANCHES];
+static u32 NumBranches;
+static SimQueue DownRep;
+static SimQueue UpReq;
+static u32 SimTimeUs;
+static u32 DownReqCount;
+static u32 BadDownReqCount;
+static u32 UpRepCount;
+static SimMsg LastUpRep;
+static u32 CorruptNextReply;
+
+#define CHECK(Cond, Msg) \
+	do { \
+		if (!(Cond)) { \
+			printf("FAIL: %s (line %d)\n", (Msg), __LINE__); \
+			Failures++; \
+		} \
+	} while (0)
+
+/************************** Reference CRC ************************************/
+
+/* Polynomial long division one bit at a time, as the driver did originally */
+static u8 RefCrc(const u8 *Data, u32 NumberOfBits, u8 Polynomial)
+{
+	u8 BitMask = (Polynomial == 4) ? 0x08 : 0x80;
+	u8 BitShift = (Polynomial == 4) ? 3 : 7;
+	u32 ArrayIndex = 0;
+	u16 Remainder = 0;
+
+	while (NumberOfBits != 0) {
+		NumberOfBits--;
+		Remainder <<= 1;
+		Remainder |= (Data[ArrayIndex] & BitMask) >> BitShift;
+		BitMask >>= 1;
+		BitShift--;
+		if (BitMask == 0) {
+			BitMask = (Polynomial == 4) ? 0x08 : 0x80;
+			BitShift = (Polynomial == 4) ? 3 : 7;
+			ArrayIndex++;
+		}
+		if ((Remainder & (1 << Polynomial)) != 0) {
+			Remainder ^= (Polynomial == 4) ? 0x13 : 0xD5;
+		}
+	}
+
+	NumberOfBits = Polynomial;
+	while (NumberOfBits != 0) {
+		NumberOfBits--;
+		Remainder <<= 1;
+		if ((Remainder & (1 << Polynomial)) != 0) {
+			Remainder ^= (Polynomial == 4) ? 0x13 : 0xD5;
+			if (Polynomial == 4) {
+				Remainder &= 0xFF;
+			}
+		}
+	}
+
+	return Remainder & 0xFF;
+}
+
+/* Header CRC over the nibbles of the header bytes, except the CRC itself */
+static u8 RefHeaderCrc(const u8 *Header, u32 HeaderLength)
+{
+	u8 Nibbles[40];
+	u32 Index;
+
+	for (Index = 0; Index < HeaderLength; Index++) {
+		Nibbles[2 * Index] = Header[Index] >> 4;
+		Nibbles[(2 * Index) + 1] = Header[Index] & 0x0F;
+	}
+
+	return RefCrc(Nibbles, 4 * ((2 * HeaderLength) - 1), 4);
+}
+
+/************************** Simulator ****************************************/
+
+static void SimAdvance(u32 Bytes)
+{
+	SimTimeUs += ((Bytes + 15U) / 16U) * SIM_AUX_REQ_US +
+						(Bytes * SIM_AUX_BYTE_US);
+}
+
+/* Encodes a message, split into fragments, with the reference CRCs */
+static void SimQueueMsg(SimQueue *Queue, u8 Lct, const u8 *Rad, u8 Seq,
+		const u8 *Body, u32 BodyLength, u32 ReadyUs)
+{
+	u32 HeaderLength = 3 + (Lct / 2);
+	u32 MaxData = SIM_SBMSG_LEN - HeaderLength - 1;
+	u32 Offset = 0;
+	u32 Chunk;
+	u32 Index;
+	SimFragment *Frag;
+	u8 *Data;
+
+	do {
+		Chunk = BodyLength - Offset;
+		if (Chunk > MaxData) {
+			Chunk = MaxData;
+		}
+		Frag = &Queue->Frag[(Queue->Head + Queue->Count) %
+							SIM_MAX_FRAGMENTS];
+		Queue->Count++;
+		Frag->ReadyUs = ReadyUs;
+		Data = Frag->Data;
+		memset(Data, 0, SIM_SBMSG_LEN);
+
+		Data[0] = (Lct << 4) | 0;
+		for (Index = 0; Index < (u32)(Lct - 1); Index++) {
+			Data[1 + (Index / 2)] |= ((Index & 1) != 0) ?
+					Rad[Index] : (Rad[Index] << 4);
+		}
+		Data[HeaderLength - 2] = Chunk + 1;
+		Data[HeaderLength - 1] = ((Offset == 0) << 7) |
+				(((Offset + Chunk) == BodyLength) << 6) |
+				(Seq << 4);
+		Data[HeaderLength - 1] |= RefHeaderCrc(Data, HeaderLength);
+
+		memcpy(&Data[HeaderLength], &Body[Offset], Chunk);
+		Data[HeaderLength + Chunk] = RefCrc(&Body[Offset], 8 * Chunk,
+									8);
+		Offset += Chunk;
+	} while (Offset < BodyLength);
+}
+
+/* Decodes one fragment, returns 0 if a CRC does not match */
+static u32 SimParseMsg(const u8 *Data, SimMsg *Msg)
+{
+	u32 HeaderLength;
+	u32 Index;
+
+	Msg->Lct = Data[0] >> 4;
+	Msg->Lcr = Data[0] & 0x0F;
+	if (Msg->Lct == 0) {
+		return 0;
+	}
+	HeaderLength = 3 + (Msg->Lct / 2);
+	for (Index = 0; Index < (u32)(Msg->Lct - 1); Index++) {
+		Msg->Rad[Index] = ((Index & 1) != 0) ?
+				(Data[1 + (Index / 2)] & 0x0F) :
+				(Data[1 + (Index / 2)] >> 4);
+	}
+	Msg->BodyLength = (Data[HeaderLength - 2] & 0x3F) - 1;
+	Msg->Somt = Data[HeaderLength - 1] >> 7;
+	Msg->Eomt = (Data[HeaderLength - 1] >> 6) & 1;
+	Msg->Seq = (Data[HeaderLength - 1] >> 4) & 1;
+	if ((Data[HeaderLength - 1] & 0x0F) !=
+				RefHeaderCrc(Data, HeaderLength)) {
+		return 0;
+	}
+	if ((HeaderLength + Msg->BodyLength) >= SIM_SBMSG_LEN) {
+		return 0;
+	}
+	memcpy(Msg->Body, &Data[HeaderLength], Msg->BodyLength);
+
+	return Data[HeaderLength + Msg->BodyLength] ==
+			RefCrc(Msg->Body, 8 * Msg->BodyLength, 8);
+}
+
+static void SimLinkAddressReply(SimBranch *Branch, u8 *Body, u32 *Length)
+{
+	SimPort *Port;
+	u32 Len = 0;
+	u8 Index;
+
+	Body[Len++] = XDP_SBMSG_LINK_ADDRESS;
+	memcpy(&Body[Len], Branch->Guid, XDP_GUID_NBYTES);
+	Len += XDP_GUID_NBYTES;
+	Body[Len++] = Branch->NumPorts + 1;
+
+	/* The input port, connected to the source. */
+	Body[Len++] = 0x80 | (PEER_SOURCE << 4) | 0;
+	Body[Len++] = 0xC0;
+
+	for (Index = 1; Index <= Branch->NumPorts; Index++) {
+		Port = &Branch->Ports[Index];
+		Body[Len++] = (Port->PeerDeviceType << 4) | Index;
+		if (Port->PeerDeviceType == PEER_BRANCH) {
+			Body[Len++] = 0xC0;
+		}
+		else if (Port->PeerDeviceType == PEER_SST_SINK) {
+			Body[Len++] = 0x40;
+		}
+		else if (Port->PeerDeviceType == PEER_CONVERTER) {
+			Body[Len++] = 0x60;
+		}
+		else {
+			Body[Len++] = 0x00;
+		}
+		Body[Len++] = (Port->PeerDeviceType != PEER_NONE) ? 0x12 : 0;
+		memset(&Body[Len], 0, XDP_GUID_NBYTES);
+		if (Port->PeerDeviceType == PEER_BRANCH) {
+			memcpy(&Body[Len], Branches[Port->Branch].Guid,
+							XDP_GUID_NBYTES);
+		}
+		Len += XDP_GUID_NBYTES;
+		Body[Len++] = (Port->PeerDeviceType == PEER_SST_SINK) ?
+								0x11 : 0x00;
+	}
+	*Length = Len;
+}
+
+static void SimDownReq(const u8 *Data)
+{
+	SimMsg Req;
+	SimBranch *Branch = &Branches[0];
+	SimPort *Port;
+	u8 Body[256];
+	u32 Length = 0;
+	u32 Index;
+
+	DownReqCount++;
+	if (!SimParseMsg(Data, &Req) || (Req.Lcr != (Req.Lct - 1)) ||
+					!Req.Somt || !Req.Eomt) {
+		BadDownReqCount++;
+		return;
+	}
+
+	/* Route the request by its relative address. */
+	for (Index = 0; Index < (u32)(Req.Lct - 1); Index++) {
+		Port = &Branch->Ports[Req.Rad[Index]];
+		if ((Req.Rad[Index] == 0) ||
+				(Req.Rad[Index] > Branch->NumPorts) ||
+				(Port->PeerDeviceType != PEER_BRANCH)) {
+			Branch = NULL;
+			break;
+		}
+		Branch = &Branches[Port->Branch];
+	}
+
+	if ((Branch != NULL) && (Req.Body[0] == XDP_SBMSG_LINK_ADDRESS)) {
+		Branch->LinkAddressCount++;
+		SimLinkAddressReply(Branch, Body, &Length);
+	}
+	else {
+		/* NACK: request, GUID of the replying device and reason. */
+		Body[Length++] = 0x80 | Req.Body[0];
+		memset(&Body[Length], 0, XDP_GUID_NBYTES);
+		Length += XDP_GUID_NBYTES;
+		Body[Length++] = XDP_SBMSG_NAK_REASON_INVALID_RAD;
+		Body[Length++] = 0;
+	}
+	SimQueueMsg(&DownRep, 1, NULL, Req.Seq, Body, Length,
+				SimTimeUs + SIM_HOP_US * Req.Lct);
+	if (CorruptNextReply) {
+		/* Damage the first fragment after its CRC was computed. */
+		CorruptNextReply = 0;
+		DownRep.Frag[DownRep.Head].Data[8] ^= 0x10;
+	}
+}
+
+static u8 SimEsi0(void)
+{
+	u8 Value = 0;
+
+	if ((DownRep.Count != 0) &&
+			(DownRep.Frag[DownRep.Head].ReadyUs <= SimTimeUs)) {
+		Value |= XDP_DPCD_ESI0_DOWN_REP_MSG_RDY_MASK;
+	}
+	if ((UpReq.Count != 0) &&
+			(UpReq.Frag[UpReq.Head].ReadyUs <= SimTimeUs)) {
+		Value |= XDP_DPCD_ESI0_UP_REQ_MSG_RDY_MASK;
+	}
+
+	return Value;
+}
+
+static void SimPop(SimQueue *Queue)
+{
+	if (Queue->Count != 0) {
+		Queue->Head = (Queue->Head + 1) % SIM_MAX_FRAGMENTS;
+		Queue->Count--;
+	}
+}
+
+static void SimReset(void)
+{
+	memset(Branches, 0, sizeof(Branches));
+	memset(&DownRep, 0, sizeof(DownRep));
+	memset(&UpReq, 0, sizeof(UpReq));
+	NumBranches = 0;
+	SimTimeUs = 0;
+	DownReqCount = 0;
+	BadDownReqCount = 0;
+	UpRepCount = 0;
+	CorruptNextReply = 0;
+
+	memset(&Dp, 0, sizeof(Dp));
+	Dp.IsReady = XIL_COMPONENT_IS_READY;
+	Dp.Config.IsRx = 0;
+}
+
+static u8 SimAddBranch(void)
+{
+	u8 Index = NumBranches++;
+	u8 Byte;
+
+	for (Byte = 0; Byte < XDP_GUID_NBYTES; Byte++) {
+		Branches[Index].Guid[Byte] = 0xB0 + Index + (Byte * 0x11);
+	}
+
+	return Index;
+}
+
+static void SimPlug(u8 Branch, u8 PortNum, u8 PeerDeviceType, u8 Child)
+{
+	Branches[Branch].Ports[PortNum].PeerDeviceType = PeerDeviceType;
+	Branches[Branch].Ports[PortNum].Branch = Child;
+	if (PortNum > Branches[Branch].NumPorts) {
+		Branches[Branch].NumPorts = PortNum;
+	}
+}
+
+/* Queues a CONNECTION_STATUS_NOTIFY sent by a branch for one of its ports */
+static void SimNotify(u8 Branch, u8 PortNum, u8 Seq)
+{
+	SimPort *Port = &Branches[Branch].Ports[PortNum];
+	u8 Body[20];
+	u8 Status = Port->PeerDeviceType;
+
+	if (Port->PeerDeviceType != PEER_NONE) {
+		Status |= 0x20;
+	}
+	if (Port->PeerDeviceType == PEER_BRANCH) {
+		Status |= 0x10;
+	}
+	if (Port->PeerDeviceType == PEER_CONVERTER) {
+		Status |= 0x40;
+	}
+	Body[0] = XDP_SBMSG_CONNECTION_STATUS_NOTIFY;
+	Body[1] = PortNum << 4;
+	memcpy(&Body[2], Branches[Branch].Guid, XDP_GUID_NBYTES);
+	Body[18] = Status;
+	SimQueueMsg(&UpReq, 1, NULL, Seq, Body, 19, SimTimeUs);
+}
+
+/************************** AUX channel stubs ********************************/
+
+u32 XDp_TxAuxRead(XDp *InstancePtr, u32 DpcdAddress, u32 BytesToRead,
+								void *ReadData)
+{
+	u8 *Data = ReadData;
+	SimQueue *Queue = NULL;
+
+	(void)InstancePtr;
+	SimAdvance(BytesToRead);
+	memset(Data, 0, BytesToRead);
+
+	if (DpcdAddress == XDP_DPCD_SINK_DEVICE_SERVICE_IRQ_VECTOR_ESI0) {
+		Data[0] = SimEsi0();
+		return XST_SUCCESS;
+	}
+	if (DpcdAddress == XDP_DPCD_DOWN_REP) {
+		Queue = &DownRep;
+	}
+	else if (DpcdAddress == XDP_DPCD_UP_REQ) {
+		Queue = &UpReq;
+	}
+	/* The message buffer only holds a fragment once it is flagged ready. */
+	if ((Queue != NULL) && (Queue->Count != 0) &&
+			(Queue->Frag[Queue->Head].ReadyUs <= SimTimeUs)) {
+		memcpy(Data, Queue->Frag[Queue->Head].Data,
+			BytesToRead < SIM_SBMSG_LEN ? BytesToRead :
+							SIM_SBMSG_LEN);
+	}
+
+	return XST_SUCCESS;
+}
+
+u32 XDp_TxAuxWrite(XDp *InstancePtr, u32 DpcdAddress, u32 BytesToWrite,
+							void *WriteData)
+{
+	u8 *Data = WriteData;
+	u8 Buffer[SIM_SBMSG_LEN];
+
+	(void)InstancePtr;
+	SimAdvance(BytesToWrite);
+	if (BytesToWrite > SIM_SBMSG_LEN) {
+		return XST_FAILURE;
+	}
+	memset(Buffer, 0, sizeof(Buffer));
+	memcpy(Buffer, Data, BytesToWrite);
+
+	if (DpcdAddress == XDP_DPCD_SINK_DEVICE_SERVICE_IRQ_VECTOR_ESI0) {
+		if ((Data[0] & XDP_DPCD_ESI0_DOWN_REP_MSG_RDY_MASK) != 0) {
+			SimPop(&DownRep);
+		}
+		if ((Data[0] & XDP_DPCD_ESI0_UP_REQ_MSG_RDY_MASK) != 0) {
+			SimPop(&UpReq);
+		}
+	}
+	else if (DpcdAddress == XDP_DPCD_DOWN_REQ) {
+		SimDownReq(Buffer);
+	}
+	else if (DpcdAddress == XDP_DPCD_UP_REP) {
+		UpRepCount++;
+		if (!SimParseMsg(Buffer, &LastUpRep)) {
+			LastUpRep.Lct = 0;
+		}
+	}
+
+	return XST_SUCCESS;
+}
+
+void XDp_WaitUs(XDp *InstancePtr, u32 MicroSeconds)
+{
+	(void)InstancePtr;
+	SimTimeUs += MicroSeconds;
+}
+
+/********************************** Stubs ************************************/
+
+u32 Xil_AssertStatus;
+s32 Xil_AssertWait;
+
+void Xil_Assert(const char8 *File, s32 Line)
+{
+	printf("ASSERT %s:%d\n", File, Line);
+	Failures++;
+}
+
+u32 XDp_TxIicRead(XDp *InstancePtr, u8 IicAddress, u16 Offset,
+					u16 BytesToRead, void *ReadData)
+{
+	(void)InstancePtr;
+	(void)IicAddress;
+	(void)Offset;
+	(void)BytesToRead;
+	(void)ReadData;
+	return XST_FAILURE;
+}
+
+u32 XDp_TxIicWrite(XDp *InstancePtr, u8 IicAddress, u8 BytesToWrite,
+							void *WriteData)
+{
+	(void)InstancePtr;
+	(void)IicAddress;
+	(void)BytesToWrite;
+	(void)WriteData;
+	return XST_FAILURE;
+}
+
+u32 XDp_TxGetRemoteTiledDisplayDb(XDp *InstancePtr, u8 *EdidExt,
+		u8 LinkCountTotal, u8 *RelativeAddress, u8 **DataBlockPtr)
+{
+	(void)InstancePtr;
+	(void)EdidExt;
+	(void)LinkCountTotal;
+	(void)RelativeAddress;
+	(void)DataBlockPtr;
+	return XST_FAILURE;
+}
+
+/***************************** Test Helpers **********************************/
+
+/* A node as "type lct rad", for comparing topologies in any order */
+static void NodeKey(const XDp_TxTopologyNode *Node, char *Key)
+{
+	u32 Index;
+	int Len;
+
+	Len = sprintf(Key, "%u %u", Node->DeviceType, Node->LinkCountTotal);
+	for (Index = 0; Index < (u32)(Node->LinkCountTotal - 1); Index++) {
+		Len += sprintf(&Key[Len], " %u", Node->RelativeAddress[Index]);
+	}
+}
+
+static int CompareKeys(const void *A, const void *B)
+{
+	return strcmp((const char *)A, (const char *)B);
+}
+
+/* Sorted keys of the node table and of the sink list */
+static void TopologyKeys(char Nodes[63][64], char Sinks[63][64])
+{
+	XDp_TxTopology *Topology = &Dp.TxInstance.Topology;
+	u32 Index;
+
+	for (Index = 0; Index < Topology->NodeTotal; Index++) {
+		NodeKey(&Topology->NodeTable[Index], Nodes[Index]);
+	}
+	qsort(Nodes, Topology->NodeTotal, 64, CompareKeys);
+	for (Index = 0; Index < Topology->SinkTotal; Index++) {
+		NodeKey(Topology->SinkList[Index], Sinks[Index]);
+	}
+	qsort(Sinks, Topology->SinkTotal, 64, CompareKeys);
+}
+
+static u32 SameKeys(char A[63][64], char B[63][64], u32 Count)
+{
+	u32 Index;
+
+	for (Index = 0; Index < Count; Index++) {
+		if (strcmp(A[Index], B[Index]) != 0) {
+			return 0;
+		}
+	}
+
+	return 1;
+}
+
+static void ClearTopology(void)
+{
+	Dp.TxInstance.Topology.NodeTotal = 0;
+	Dp.TxInstance.Topology.SinkTotal = 0;
+}
+
+static u32 TotalLinkAddress(void)
+{
+	u32 Total = 0;
+	u32 Index;
+
+	for (Index = 0; Index < NumBranches; Index++) {
+		Total += Branches[Index].LinkAddressCount;
+		Branches[Index].LinkAddressCount = 0;
+	}
+
+	return Total;
+}
+
+/*
+ * B0: 1 sink, 2 B1, 3 sink, 4 B2
+ * B1: 1 B3, 2 sink, 3 empty
+ * B2: 1 sink, 2 sink
+ * B3: 1 sink, 2 sink, 3 B4
+ * B4: 1 sink
+ */
+static void BuildTree(void)
+{
+	u8 B0 = SimAddBranch();
+	u8 B1 = SimAddBranch();
+	u8 B2 = SimAddBranch();
+	u8 B3 = SimAddBranch();
+	u8 B4 = SimAddBranch();
+
+	SimPlug(B0, 1, PEER_SST_SINK, 0);
+	SimPlug(B0, 2, PEER_BRANCH, B1);
+	SimPlug(B0, 3, PEER_SST_SINK, 0);
+	SimPlug(B0, 4, PEER_BRANCH, B2);
+	SimPlug(B1, 1, PEER_BRANCH, B3);
+	SimPlug(B1, 2, PEER_SST_SINK, 0);
+	SimPlug(B1, 3, PEER_NONE, 0);
+	SimPlug(B2, 1, PEER_SST_SINK, 0);
+	SimPlug(B2, 2, PEER_SST_SINK, 0);
+	SimPlug(B3, 1, PEER_SST_SINK, 0);
+	SimPlug(B3, 2, PEER_SST_SINK, 0);
+	SimPlug(B3, 3, PEER_BRANCH, B4);
+	SimPlug(B4, 1, PEER_SST_SINK, 0);
+}
+
+/* A daisy chain of branches, each with one sink and the next branch */
+static void BuildChain(u8 Length)
+{
+	u8 Index;
+
+	for (Index = 0; Index < Length; Index++) {
+		SimAddBranch();
+	}
+	for (Index = 0; Index < Length; Index++) {
+		SimPlug(Index, 1, PEER_SST_SINK, 0);
+		if ((Index + 1) < Length) {
+			SimPlug(Index, 2, PEER_BRANCH, Index + 1);
+		}
+		else {
+			SimPlug(Index, 2, PEER_NONE, 0);
+		}
+	}
+}
+
+/********************************** Tests ************************************/
+
+static void TestCrc(void)
+{
+	XDp_SidebandMsg Msg;
+	u32 Run;
+	u32 Index;
+	u32 Mismatches = 0;
+	u8 Nibbles[20];
+	u32 NumNibbles;
+	double Start;
+	double Table;
+	double Bitwise;
+	struct timespec Ts;
+	volatile u8 Sink = 0;
+
+	srand(1);
+	for (Run = 0; Run < NUM_CRC_RUNS; Run++) {
+		NumNibbles = 1 + (rand() % 20);
+		for (Index = 0; Index < NumNibbles; Index++) {
+			Nibbles[Index] = rand() & 0x0F;
+		}
+		if (XDp_CrcCalculate(Nibbles, 4 * NumNibbles, 4) !=
+				RefCrc(Nibbles, 4 * NumNibbles, 4)) {
+			Mismatches++;
+		}
+
+		Msg.FragmentNum = 0;
+		Msg.Body.MsgDataLength = 1 + (rand() % 63);
+		for (Index = 0; Index < Msg.Body.MsgDataLength; Index++) {
+			Msg.Body.MsgData[Index] = rand();
+		}
+		if (XDp_Crc8CalculateBody(&Msg) != RefCrc(Msg.Body.MsgData,
+				8 * Msg.Body.MsgDataLength, 8)) {
+			Mismatches++;
+		}
+	}
+	CHECK(Mismatches == 0, "table CRC differs from the bitwise CRC");
+
+	/* Time the body CRC of a full fragment. */
+	for (Index = 0; Index < 44; Index++) {
+		Msg.Body.MsgData[Index] = Index * 37;
+	}
+	clock_gettime(CLOCK_MONOTONIC, &Ts);
+	Start = Ts.tv_sec * 1e9 + Ts.tv_nsec;
+	for (Run = 0; Run < NUM_CRC_RUNS; Run++) {
+		Msg.Body.MsgData[0] = Run;
+		Sink ^= RefCrc(Msg.Body.MsgData, 8 * 44, 8);
+	}
+	clock_gettime(CLOCK_MONOTONIC, &Ts);
+	Bitwise = (Ts.tv_sec * 1e9 + Ts.tv_nsec - Start) / NUM_CRC_RUNS;
+	Start = Ts.tv_sec * 1e9 + Ts.tv_nsec;
+	for (Run = 0; Run < NUM_CRC_RUNS; Run++) {
+		Msg.Body.MsgData[0] = Run;
+		Sink ^= XDp_CrcCalculate(Msg.Body.MsgData, 8 * 44, 8);
+	}
+	clock_gettime(CLOCK_MONOTONIC, &Ts);
+	Table = (Ts.tv_sec * 1e9 + Ts.tv_nsec - Start) / NUM_CRC_RUNS;
+	printf("CRC8 of 44 bytes: %.0f ns bitwise, %.0f ns table\n", Bitwise,
+									Table);
+	CHECK(Table * 2 < Bitwise, "table CRC not faster");
+}
+
+static void TestDiscovery(void)
+{
+	static char Nodes[63][64];
+	static char Sinks[63][64];
+	static XDp_SbMsgLinkAddressReplyDeviceInfo DeviceInfo;
+	XDp_TxTopology *Topology = &Dp.TxInstance.Topology;
+	u32 Status;
+
+	SimReset();
+	BuildTree();
+	Status = XDp_TxDiscoverTopology(&Dp);
+	CHECK(Status == XST_SUCCESS, "discovery failed");
+	CHECK(BadDownReqCount == 0, "down request with a bad CRC");
+	CHECK(TotalLinkAddress() == 5, "one LINK_ADDRESS per branch");
+	CHECK(Topology->NodeTotal == 13, "node count");
+	CHECK(Topology->SinkTotal == 8, "sink count");
+	CHECK(DownRep.Count == 0 && UpReq.Count == 0, "messages left over");
+
+	TopologyKeys(Nodes, Sinks);
+	CHECK(strcmp(Nodes[0], "2 1") == 0, "root branch");
+	CHECK(strcmp(Sinks[0], "3 2 1") == 0 && strcmp(Sinks[7],
+			"3 5 2 1 3 1") == 0, "sink relative addresses");
+
+	/* A reply whose body CRC does not match is rejected. */
+	CorruptNextReply = 1;
+	Status = XDp_TxSendSbMsgLinkAddress(&Dp, 1, NULL, &DeviceInfo);
+	CHECK(Status == XST_FAILURE, "reply with a bad CRC accepted");
+	DownRep.Count = 0;
+}
+
+static void TestConnectionStatusNotify(void)
+{
+	static char Nodes[63][64], Sinks[63][64];
+	static char FreshNodes[63][64], FreshSinks[63][64];
+	static XDp_TxTopologyNode Before[63];
+	static XDp_SbMsgLinkAddressReplyDeviceInfo DeviceInfo;
+	u8 Rad[3] = { 2, 1, 3 };
+	char Key[64];
+	XDp_TxTopology *Topology = &Dp.TxInstance.Topology;
+	XDp_SbMsgConnectionStatusNotify Notify;
+	u32 Status;
+	u32 Index;
+	u32 Kept;
+	u32 SinksBefore;
+	u8 B5;
+
+	SimReset();
+	BuildTree();
+	Status = XDp_TxDiscoverTopology(&Dp);
+	CHECK(Status == XST_SUCCESS, "discovery failed");
+	TotalLinkAddress();
+	SinksBefore = Topology->SinkTotal;
+	for (Index = 0; Index < SinksBefore; Index++) {
+		Before[Index] = *Topology->SinkList[Index];
+	}
+
+	/* Unplug a sink from B3 and plug a new branch with two sinks. */
+	B5 = SimAddBranch();
+	SimPlug(B5, 1, PEER_SST_SINK, 0);
+	SimPlug(B5, 2, PEER_SST_SINK, 0);
+	SimPlug(3, 2, PEER_NONE, 0);
+	SimPlug(3, 4, PEER_BRANCH, B5);
+	SimNotify(3, 4, 1);
+
+	memset(&Notify, 0, sizeof(Notify));
+	Status = XDp_TxHandleConnectionStatusNotify(&Dp, &Notify);
+	CHECK(Status == XST_SUCCESS, "notify handling failed");
+	CHECK(Notify.PortNum == 4, "notify port number");
+	CHECK(memcmp(Notify.Guid, Branches[3].Guid, XDP_GUID_NBYTES) == 0,
+							"notify GUID");
+	CHECK(Notify.DpDevPlugStatus == 1 && Notify.MsgCapStatus == 1 &&
+	      Notify.LegacyDevPlugStatus == 0 && Notify.InputPort == 0 &&
+	      Notify.PeerDeviceType == PEER_BRANCH, "notify port status");
+	CHECK(UpReq.Count == 0, "up request not cleared");
+
+	/* The up request is acknowledged with its sequence number. */
+	CHECK(UpRepCount == 1, "no up reply");
+	CHECK(LastUpRep.Lct == 1 && LastUpRep.Somt && LastUpRep.Eomt &&
+	      LastUpRep.Seq == 1 && LastUpRep.BodyLength == 1 &&
+	      LastUpRep.Body[0] == XDP_SBMSG_CONNECTION_STATUS_NOTIFY,
+	      "up reply contents or CRC");
+
+	/* Only B3 and the branches below it were explored again. */
+	CHECK(Branches[3].LinkAddressCount == 1 &&
+	      Branches[4].LinkAddressCount == 1 &&
+	      Branches[5].LinkAddressCount == 1, "changed branch not explored");
+	CHECK(TotalLinkAddress() == 3, "other branches explored again");
+
+	/* The sinks outside B3 (RAD 2 1) keep their order, new ones are
+	 * appended. */
+	Kept = 0;
+	for (Index = 0; Index < SinksBefore; Index++) {
+		if ((Before[Index].LinkCountTotal > 3) &&
+				(Before[Index].RelativeAddress[0] == 2) &&
+				(Before[Index].RelativeAddress[1] == 1)) {
+			continue;
+		}
+		NodeKey(Topology->SinkList[Kept], Key);
+		NodeKey(&Before[Index], Nodes[0]);
+		if (strcmp(Key, Nodes[0]) != 0) {
+			break;
+		}
+		Kept++;
+	}
+	CHECK(Kept == 5, "order of the unchanged sinks");
+
+	/* The result is the topology found by a full discovery. */
+	TopologyKeys(Nodes, Sinks);
+	Index = Topology->NodeTotal;
+	Kept = Topology->SinkTotal;
+	ClearTopology();
+	Status = XDp_TxDiscoverTopology(&Dp);
+	CHECK(Status == XST_SUCCESS, "discovery failed");
+	TopologyKeys(FreshNodes, FreshSinks);
+	CHECK(Index == Topology->NodeTotal && Kept == Topology->SinkTotal,
+						"node or sink count differs");
+	CHECK(SameKeys(Nodes, FreshNodes, Index) &&
+	      SameKeys(Sinks, FreshSinks, Kept),
+	      "refreshed topology differs from a full discovery");
+	CHECK(Topology->SinkTotal == 9, "sink count after hotplug");
+
+	/* A notify from a branch that is not in the topology. */
+	TotalLinkAddress();
+	memset(Branches[0].Guid, 0x5A, XDP_GUID_NBYTES);
+	SimNotify(0, 1, 0);
+	Status = XDp_TxHandleConnectionStatusNotify(&Dp, &Notify);
+	CHECK(Status == XST_DEVICE_NOT_FOUND, "unknown branch");
+	CHECK(UpRepCount == 2 && LastUpRep.Seq == 0, "unknown branch ACK");
+	CHECK(TotalLinkAddress() == 0, "unknown branch explored");
+
+	/* A legacy monitor behind a converter, plugged into B2. */
+	SimPlug(2, 2, PEER_CONVERTER, 0);
+	SimNotify(2, 2, 1);
+	Status = XDp_TxReceiveConnectionStatusNotify(&Dp, &Notify);
+	CHECK(Status == XST_SUCCESS && Notify.PortNum == 2 &&
+	      Notify.PeerDeviceType == PEER_CONVERTER &&
+	      Notify.LegacyDevPlugStatus == 1 && Notify.DpDevPlugStatus == 1 &&
+	      Notify.MsgCapStatus == 0, "converter port status");
+
+	/* An up request arriving while a reply is awaited stays queued. */
+	SimPlug(2, 1, PEER_NONE, 0);
+	SimNotify(2, 1, 0);
+	Status = XDp_TxSendSbMsgLinkAddress(&Dp, 4, Rad, &DeviceInfo);
+	CHECK(Status == XST_SUCCESS && !memcmp(DeviceInfo.Guid,
+				Branches[4].Guid, XDP_GUID_NBYTES),
+				"reply with an up request pending");
+	CHECK(UpReq.Count == 1, "pending up request consumed");
+	Status = XDp_TxReceiveConnectionStatusNotify(&Dp, &Notify);
+	CHECK(Status == XST_SUCCESS && Notify.PortNum == 1 &&
+	      Notify.DpDevPlugStatus == 0 && Notify.PeerDeviceType == PEER_NONE,
+	      "unplug port status");
+	CHECK(UpRepCount == 4, "unplug ACK");
+
+	/* Other up requests are acknowledged but not parsed. */
+	{
+		u8 Body[20] = { XDP_SBMSG_RESOURCE_STATUS_NOTIFY, 0x10 };
+
+		SimQueueMsg(&UpReq, 1, NULL, 1, Body, 20, SimTimeUs);
+	}
+	Status = XDp_TxReceiveConnectionStatusNotify(&Dp, &Notify);
+	CHECK(Status == XST_FAILURE, "other up request accepted");
+	CHECK(UpRepCount == 5 && LastUpRep.Body[0] ==
+		XDP_SBMSG_RESOURCE_STATUS_NOTIFY, "other up request ACK");
+
+	/* An up request with a bad CRC is not acknowledged. */
+	SimNotify(3, 4, 0);
+	UpReq.Frag[UpReq.Head].Data[10] ^= 0x01;
+	Status = XDp_TxReceiveConnectionStatusNotify(&Dp, &Notify);
+	CHECK(Status == XST_FAILURE, "up request with a bad CRC accepted");
+	CHECK(UpRepCount == 5, "up request with a bad CRC acknowledged");
+	UpReq.Count = 0;
+
+	/* Nothing is reported when no up request arrives. */
+	Status = XDp_TxReceiveConnectionStatusNotify(&Dp, &Notify);
+	CHECK(Status == XST_ERROR_COUNT_MAX, "no up request");
+}
+
+static void TestHotplugTime(void)
+{
+	static char Nodes[63][64], Sinks[63][64];
+	static char FreshNodes[63][64], FreshSinks[63][64];
+	XDp_SbMsgConnectionStatusNotify Notify;
+	u32 Start;
+	u32 FullUs;
+	u32 FullMsgs;
+	u32 IncrUs;
+	u32 IncrMsgs;
+	u32 Status;
+
+	SimReset();
+	BuildChain(6);
+	Status = XDp_TxDiscoverTopology(&Dp);
+	CHECK(Status == XST_SUCCESS, "chain discovery failed");
+	TotalLinkAddress();
+
+	/* A monitor is plugged into the last branch of the chain. */
+	SimPlug(5, 2, PEER_SST_SINK, 0);
+
+	SimNotify(5, 2, 0);
+	Start = SimTimeUs;
+	DownReqCount = 0;
+	Status = XDp_TxHandleConnectionStatusNotify(&Dp, &Notify);
+	IncrUs = SimTimeUs - Start;
+	IncrMsgs = DownReqCount;
+	CHECK(Status == XST_SUCCESS, "chain notify failed");
+	CHECK(TotalLinkAddress() == 1, "chain refresh explored others");
+	TopologyKeys(Nodes, Sinks);
+
+	/* The same event handled by discovering the whole chain again. */
+	SimNotify(5, 2, 1);
+	Start = SimTimeUs;
+	DownReqCount = 0;
+	Status = XDp_TxReceiveConnectionStatusNotify(&Dp, &Notify);
+	ClearTopology();
+	Status |= XDp_TxDiscoverTopology(&Dp);
+	FullUs = SimTimeUs - Start;
+	FullMsgs = DownReqCount;
+	CHECK(Status == XST_SUCCESS, "chain rediscovery failed");
+	CHECK(TotalLinkAddress() == 6, "chain rediscovery");
+	TopologyKeys(FreshNodes, FreshSinks);
+	CHECK(SameKeys(Nodes, FreshNodes, Dp.TxInstance.Topology.NodeTotal) &&
+	      SameKeys(Sinks, FreshSinks, Dp.TxInstance.Topology.SinkTotal),
+	      "chain topology differs");
+
+	printf("Hotplug at the end of a 6 branch chain: full discovery %u "
+		"requests %.1f ms, branch refresh %u requests %.1f ms\n",
+		FullMsgs, FullUs / 1000.0, IncrMsgs, IncrUs / 1000.0);
+	CHECK(IncrMsgs == 1 && FullMsgs == 6, "request counts");
+	CHECK(IncrUs * 3 < FullUs, "branch refresh not faster");
+}
+
+int main(void)
+{
+	TestCrc();
+	TestDiscovery();
+	TestConnectionStatusNotify();
+	TestHotplugTime();
+
+	printf("%s (%u failures)\n", Failures ? "FAILED" : "PASSED", Failures);
+	return Failures ? 1 : 0;
+}
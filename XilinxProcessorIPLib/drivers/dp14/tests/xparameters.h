@@ -0,0 +1,15 @@
+/******************************************************************************
+* Copyright (C) 2020 Xilinx, Inc.  All rights reserved.
+* SPDX-License-Identifier: MIT
+******************************************************************************/
+
+/* Hardware parameters of the host tests: one DisplayPort TX subsystem */
+#ifndef XPARAMETERS_H
+#define XPARAMETERS_H
+
+#define XPAR_XDPTXSS_NUM_INSTANCES		1
+#define XPAR_XDPRXSS_NUM_INSTANCES		0
+#define XPAR_XHDCP22_RX_NUM_INSTANCES		0
+#define XPAR_XHDCP22_TX_NUM_INSTANCES		0
+
+#endif
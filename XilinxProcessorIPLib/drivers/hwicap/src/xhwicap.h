@@ -655,6 +655,10 @@ int XHwIcap_DeviceReadFrame(XHwIcap *InstancePtr, long Top,
 				long Block, long HClkRow,
 				long MajorFrame, long MinorFrame,
 				u32 *FrameBuffer);
+int XHwIcap_DeviceReadFrames(XHwIcap *InstancePtr, long Top,
+				long Block, long HClkRow,
+				long MajorFrame, long MinorFrame,
+				u32 NumFrames, u32 *FrameBuffer);
 
 /*
  * Functions in the xhwicap_device_write_frame.c
@@ -663,6 +667,10 @@ int XHwIcap_DeviceWriteFrame(XHwIcap *InstancePtr, long Top,
 				long Block, long HClkRow,
 				long MajorFrame, long MinorFrame,
 				u32 *FrameData);
+int XHwIcap_DeviceWriteFrames(XHwIcap *InstancePtr, long Top,
+				long Block, long HClkRow,
+				long MajorFrame, long MinorFrame,
+				u32 NumFrames, u32 *FrameData);
 
 /************************** Variable Declarations ***************************/
 
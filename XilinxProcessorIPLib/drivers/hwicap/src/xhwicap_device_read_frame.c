@@ -10,8 +10,9 @@
 * @addtogroup hwicap_v11_4
 * @{
 *
-* This file contains the function that reads a specified frame from the
-* device (ICAP) and stores it in the memory specified by the user.
+* This file contains the functions that read a specified frame or a range of
+* frames from the device (ICAP) and store them in the memory specified by the
+* user.
 *
 * @note none.
 *
@@ -79,6 +80,46 @@ int XHwIcap_DeviceReadFrame(XHwIcap *InstancePtr, long Top, long Block,
 				long HClkRow, long MajorFrame, long MinorFrame,
 				u32 *FrameBuffer)
 {
+	return XHwIcap_DeviceReadFrames(InstancePtr, Top, Block, HClkRow,
+					MajorFrame, MinorFrame, 1, FrameBuffer);
+}
+
+/****************************************************************************/
+/**
+*
+* Reads a range of consecutive frames from the device and puts them in memory
+* specified by the user. A single FAR/FDRO command sequence is issued for the
+* whole range and the frame address auto increments in the device, so the
+* frames are returned back to back after the leading pad frame.
+*
+* @param	InstancePtr - a pointer to the XHwIcap instance to be worked on.
+* @param	Top - top (0) or bottom (1) half of device
+* @param	Block - Block Address (XHI_FAR_CLB_BLOCK,
+*		XHI_FAR_BRAM_BLOCK, XHI_FAR_BRAM_INT_BLOCK)
+* @param	HClkRow - selects the HClk Row
+* @param	MajorFrame - selects the column
+* @param	MinorFrame - selects the first frame inside column
+* @param	NumFrames - number of frames to read
+* @param	FrameBuffer is a pointer to the memory where the frames read
+*		from the device are stored. It must hold
+*		(NumFrames + 1) * WordsPerFrame words plus 10 words for
+*		UltraScale and 25 words for UltraScale+ devices.
+*
+* @return	XST_SUCCESS else XST_FAILURE.
+*
+* @note		This is a blocking call. The read FIFO is drained in
+*		chunks of at most XHI_MAX_XFER_WORDS words.
+*		The frame address auto increments through the columns of a
+*		row, and the device inserts pad frames into the readback
+*		when it moves on to the next row or block type. The range
+*		must therefore stay inside one row and one block type. The
+*		driver has no column map of the device and cannot check it.
+*
+*****************************************************************************/
+int XHwIcap_DeviceReadFrames(XHwIcap *InstancePtr, long Top, long Block,
+				long HClkRow, long MajorFrame, long MinorFrame,
+				u32 NumFrames, u32 *FrameBuffer)
+{
 
 	u32 Packet;
 	u32 Data;
@@ -87,10 +128,13 @@ int XHwIcap_DeviceReadFrame(XHwIcap *InstancePtr, long Top, long Block,
 	u32 WriteBuffer[WRITE_FRAME_SIZE];
 	u32 Index = 0;
 	u32 NumNoops;
+	u32 Offset;
+	u32 Chunk;
 
 	Xil_AssertNonvoid(InstancePtr != NULL);
 	Xil_AssertNonvoid(InstancePtr->IsReady == XIL_COMPONENT_IS_READY);
 	Xil_AssertNonvoid(FrameBuffer != NULL);
+	Xil_AssertNonvoid(NumFrames > 0);
 
 	/*
 	 * DUMMY and SYNC
@@ -133,20 +177,23 @@ int XHwIcap_DeviceReadFrame(XHwIcap *InstancePtr, long Top, long Block,
 
 	/*
 	 * Setup read data packet header.
-	 * The frame will be preceeded by a dummy frame, and we need to read one
-	 * extra word for V4 and V5 devices.
+	 * The frames will be preceeded by a dummy frame, and we need to read
+	 * extra words for UltraScale and UltraScale+ devices.
 	 */
 	switch (InstancePtr->DeviceFamily) {
 		case DEVICE_TYPE_7SERIES :
-				TotalWords = InstancePtr->WordsPerFrame << 1;
+				TotalWords = InstancePtr->WordsPerFrame *
+						(NumFrames + 1);
 				NumNoops = 32;
 				break;
 		case DEVICE_TYPE_ULTRA :
-			TotalWords = (InstancePtr->WordsPerFrame << 1) + 10;
+			TotalWords = (InstancePtr->WordsPerFrame *
+					(NumFrames + 1)) + 10;
 			NumNoops = 64;
 				break;
 		case DEVICE_TYPE_ULTRA_PLUS :
-			TotalWords = (InstancePtr->WordsPerFrame << 1) + 25;
+			TotalWords = (InstancePtr->WordsPerFrame *
+					(NumFrames + 1)) + 25;
 			NumNoops = 64;
 				break;
 		default:
@@ -183,11 +230,21 @@ int XHwIcap_DeviceReadFrame(XHwIcap *InstancePtr, long Top, long Block,
 
 
 	/*
-	 * Read the frame of the data including the NULL frame.
+	 * Read the frames of the data including the NULL frame. The FDRO
+	 * read stays open across the chunks, each chunk is drained as soon
+	 * as the read FIFO has data.
 	 */
-	Status = XHwIcap_DeviceRead(InstancePtr, FrameBuffer, TotalWords);
-	if (Status != XST_SUCCESS)  {
-		return XST_FAILURE;
+	for (Offset = 0; Offset < TotalWords; Offset += Chunk) {
+		Chunk = TotalWords - Offset;
+		if (Chunk > XHI_MAX_XFER_WORDS) {
+			Chunk = XHI_MAX_XFER_WORDS;
+		}
+
+		Status = XHwIcap_DeviceRead(InstancePtr, &FrameBuffer[Offset],
+				Chunk);
+		if (Status != XST_SUCCESS)  {
+			return XST_FAILURE;
+		}
 	}
 
 	/*
@@ -10,8 +10,8 @@
 * @addtogroup hwicap_v11_4
 * @{
 *
-* This file contains the function that writes the frame stored in the
-* memory to the device (ICAP).
+* This file contains the functions that write a frame or a range of frames
+* stored in the memory to the device (ICAP).
 *
 * @note none.
 *
@@ -57,6 +57,9 @@
 
 /************************** Function Prototypes *****************************/
 
+static int XHwIcap_WriteFrameWords(XHwIcap *InstancePtr, u32 *FrameData,
+				u32 NumWords);
+
 /****************************************************************************/
 /**
 *
@@ -85,6 +88,46 @@ int XHwIcap_DeviceWriteFrame(XHwIcap *InstancePtr, long Top, long Block,
 				long HClkRow, long MajorFrame, long MinorFrame,
 				u32 *FrameData)
 {
+	return XHwIcap_DeviceWriteFrames(InstancePtr, Top, Block, HClkRow,
+					MajorFrame, MinorFrame, 1, FrameData);
+}
+
+/****************************************************************************/
+/**
+*
+* Writes a range of consecutive frames from the specified buffer to the
+* device (ICAP). A single FAR/FDRI command sequence is issued for the whole
+* range and the frame address auto increments in the device.
+*
+* @param	InstancePtr is a pointer to the XHwIcap instance.
+* @param	Top - top (0) or bottom (1) half of device
+* @param	Block - Block Address (XHI_FAR_CLB_BLOCK,
+* 		XHI_FAR_BRAM_BLOCK, XHI_FAR_BRAM_INT_BLOCK)
+* @param	HClkRow - selects the HClk Row
+* @param	MajorFrame - selects the column
+* @param	MinorFrame - selects the first frame inside column
+* @param	NumFrames - number of frames to write
+* @param	FrameData is a pointer to the frames that are to be written
+*		to the device, laid out as returned by
+*		XHwIcap_DeviceReadFrames: the pad frame followed by
+*		NumFrames data frames.
+*
+* @return	XST_SUCCESS else XST_FAILURE.
+*
+* @note		This is a blocking function.
+*		The write FIFO is filled in chunks of at most
+*		XHI_MAX_XFER_WORDS words.
+*		The range must stay inside one row and one block type, as
+*		for XHwIcap_DeviceReadFrames. Across a row or block type
+*		boundary the device expects pad frames that are not part
+*		of FrameData, so the frames that follow would be written
+*		to the wrong addresses.
+*
+*****************************************************************************/
+int XHwIcap_DeviceWriteFrames(XHwIcap *InstancePtr, long Top, long Block,
+				long HClkRow, long MajorFrame, long MinorFrame,
+				u32 NumFrames, u32 *FrameData)
+{
 
 	u32 Packet;
 	u32 Data;
@@ -96,7 +139,7 @@ int XHwIcap_DeviceWriteFrame(XHwIcap *InstancePtr, long Top, long Block,
 	Xil_AssertNonvoid(InstancePtr != NULL);
 	Xil_AssertNonvoid(InstancePtr->IsReady == XIL_COMPONENT_IS_READY);
 	Xil_AssertNonvoid(FrameData != NULL);
-
+	Xil_AssertNonvoid(NumFrames > 0);
 
 	/*
 	 * DUMMY and SYNC
@@ -150,7 +193,7 @@ int XHwIcap_DeviceWriteFrame(XHwIcap *InstancePtr, long Top, long Block,
 	/*
 	 * Setup Packet header.
 	 */
-	TotalWords = InstancePtr->WordsPerFrame << 1;
+	TotalWords = InstancePtr->WordsPerFrame * (NumFrames + 1);
 	if (TotalWords < XHI_TYPE_1_PACKET_MAX_WORDS)  {
 		/*
 		 * Create Type 1 Packet.
@@ -182,9 +225,9 @@ int XHwIcap_DeviceWriteFrame(XHwIcap *InstancePtr, long Top, long Block,
 	/*
 	 * Write the modified frame data.
 	 */
-	Status = XHwIcap_DeviceWrite(InstancePtr,
+	Status = XHwIcap_WriteFrameWords(InstancePtr,
 				(u32 *) &FrameData[InstancePtr->WordsPerFrame],
-				InstancePtr->WordsPerFrame);
+				InstancePtr->WordsPerFrame * NumFrames);
 	if (Status != XST_SUCCESS) {
 		return XST_FAILURE;
 	}
@@ -244,5 +287,43 @@ int XHwIcap_DeviceWriteFrame(XHwIcap *InstancePtr, long Top, long Block,
 	return XST_SUCCESS;
 };
 
+/****************************************************************************/
+/**
+*
+* Writes frame data to the device in chunks of at most XHI_MAX_XFER_WORDS
+* words, each chunk is sent as soon as the write FIFO has room.
+*
+* @param	InstancePtr is a pointer to the XHwIcap instance.
+* @param	FrameData is a pointer to the data to be written.
+* @param	NumWords is the number of words to write.
+*
+* @return	XST_SUCCESS else XST_FAILURE.
+*
+* @note		None.
+*
+*****************************************************************************/
+static int XHwIcap_WriteFrameWords(XHwIcap *InstancePtr, u32 *FrameData,
+				u32 NumWords)
+{
+	u32 Offset;
+	u32 Chunk;
+	int Status;
+
+	for (Offset = 0; Offset < NumWords; Offset += Chunk) {
+		Chunk = NumWords - Offset;
+		if (Chunk > XHI_MAX_XFER_WORDS) {
+			Chunk = XHI_MAX_XFER_WORDS;
+		}
+
+		Status = XHwIcap_DeviceWrite(InstancePtr, &FrameData[Offset],
+				Chunk);
+		if (Status != XST_SUCCESS) {
+			return XST_FAILURE;
+		}
+	}
+
+	return XST_SUCCESS;
+}
+
 
 /** @} */
@@ -221,6 +221,12 @@ extern "C" {
  */
 #define XHI_MAX_RETRIES			1000
 
+/*
+ * Maximum number of words moved through the FIFOs by a single
+ * XHwIcap_DeviceRead/XHwIcap_DeviceWrite call in the multi-frame functions
+ */
+#define XHI_MAX_XFER_WORDS		1024
+
 /*
  * Mask for the Device ID read from the ID code Register
  */
@@ -0,0 +1,535 @@
+/******************************************************************************
+* Copyright (C) 2020 Xilinx, Inc.  All rights reserved.
+* SPDX-License-Identifier: MIT
+******************************************************************************/
+
+/*****************************************************************************/
+/**
+*
+* @file test_xhwicap_frames.c
+*
+* Host test of the multi-frame readback and writeback functions. The driver
+* is built against a model of the HWICAP core and of a 7 series configuration
+* port: write and read FIFOs, the packet processor with FAR auto increment,
+* the one frame write pipeline and a small configuration memory. The test
+* compares frame ranges against the configuration memory and reports the
+* register accesses and host frames per second of single frame and range
+* transfers.
+*
+* Build and run on the host:
+*   cc -Wall -O2 -I. -I../src -I../../../../lib/bsp/standalone/src/common \
+*      test_xhwicap_frames.c -o test_xhwicap_frames
+*   ./test_xhwicap_frames
+*
+******************************************************************************/
+
+/***************************** Include Files *********************************/
+
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+
+/* Build the standalone (non Linux) flavour of the driver */
+#undef __linux__
+#include "xil_types.h"
+
+/* Register accesses go to the model below */
+#define XIL_IO_H
+static u32 Xil_In32(UINTPTR Addr);
+static void Xil_Out32(UINTPTR Addr, u32 Value);
+
+#include "xhwicap.c"
+#include "xhwicap_srp.c"
+#include "xhwicap_device_read_frame.c"
+#include "xhwicap_device_write_frame.c"
+
+/************************** Model ********************************************/
+
+#define WPF			DEVICE_7SERIES_WORDS_PER_FRAME
+#define ICAP_IDCODE		0x03631093	/* A 7 series device */
+
+#define NUM_BLOCKS		2
+#define NUM_ROWS		2
+#define NUM_COLS		6
+#define MAX_MINORS		36
+#define WF_DEPTH		64
+#define RF_DEPTH		256
+#define MAX_READ_WORDS		((NUM_COLS * MAX_MINORS + 2) * WPF)
+
+/* Minor frames per column, as for a mix of CLB, DSP and BRAM columns */
+static const u32 Minors[NUM_COLS] = { 36, 36, 28, 36, 30, 36 };
+
+typedef struct {
+	/* HWICAP core */
+	u32 Wf[WF_DEPTH];
+	u32 WfCnt;
+	u32 Rf[MAX_READ_WORDS];
+	u32 RfHead;
+	u32 RfTail;
+	u32 RfLimit;		/* Words released by the size register */
+	u32 Size;
+	u32 Underflows;		/* Reads with no readback data pending */
+	u32 Gier;
+	u32 Reads;
+	u32 Writes;
+
+	/* Configuration port */
+	int Synced;
+	u32 Reg;		/* Register addressed by the last header */
+	u32 Op;
+	u32 Count;		/* Words left in the current packet */
+	u32 Far;
+	u32 Cmd;
+	u32 FrameIn[WPF];	/* Frame being received */
+	u32 FrameFill;
+	u32 Pipeline[WPF];	/* Frame waiting to be written */
+	int PipelineValid;
+	int Wrapped;		/* FAR moved on to the next row */
+	u32 RowCrossings;
+
+	u32 Mem[NUM_BLOCKS][NUM_ROWS][NUM_COLS][MAX_MINORS][WPF];
+} IcapModel;
+
+static IcapModel Model;
+
+#define FAR_BLOCK(Far)	(((Far) >> XHI_FAR_BLOCK_SHIFT) & XHI_FAR_BLOCK_MASK)
+#define FAR_ROW(Far)	(((Far) >> XHI_FAR_ROW_ADDR_SHIFT) & \
+				XHI_FAR_ROW_ADDR_MASK)
+#define FAR_COL(Far)	(((Far) >> XHI_FAR_COLUMN_ADDR_SHIFT) & \
+				XHI_FAR_COLUMN_ADDR_MASK)
+#define FAR_MINOR(Far)	((Far) & XHI_FAR_MINOR_ADDR_MASK)
+
+static u32 *ModelFrame(u32 Far)
+{
+	return Model.Mem[FAR_BLOCK(Far) % NUM_BLOCKS][FAR_ROW(Far) % NUM_ROWS]
+		[FAR_COL(Far) % NUM_COLS][FAR_MINOR(Far) % MAX_MINORS];
+}
+
+/* Next frame address. The device inserts pad frames at the end of a row,
+ * the model does not, it counts frames transferred past a row end instead */
+static void ModelFarIncrement(void)
+{
+	u32 Block = FAR_BLOCK(Model.Far);
+	u32 Row = FAR_ROW(Model.Far);
+	u32 Col = FAR_COL(Model.Far);
+	u32 Minor = FAR_MINOR(Model.Far) + 1;
+
+	if (Minor == Minors[Col % NUM_COLS]) {
+		Minor = 0;
+		if (++Col == NUM_COLS) {
+			Col = 0;
+			Row++;
+			Model.Wrapped = 1;
+		}
+	}
+	Model.Far = (Block << XHI_FAR_BLOCK_SHIFT) |
+		(Row << XHI_FAR_ROW_ADDR_SHIFT) |
+		(Col << XHI_FAR_COLUMN_ADDR_SHIFT) | Minor;
+}
+
+static u32 *ModelNextFrame(void)
+{
+	if (Model.Wrapped) {
+		Model.RowCrossings++;
+		Model.Wrapped = 0;
+	}
+	return ModelFrame(Model.Far);
+}
+
+static void ModelQueueRead(u32 Word)
+{
+	if (Model.RfTail < MAX_READ_WORDS) {
+		Model.Rf[Model.RfTail++] = Word;
+	}
+}
+
+/* Readback of a register or of FDRO: a pad frame, then frames from FAR */
+static void ModelStartRead(u32 NumWords)
+{
+	u32 *Frame = NULL;
+	u32 Index;
+
+	Model.RfHead = 0;
+	Model.RfTail = 0;
+	Model.RfLimit = 0;
+	if (Model.Reg != XHI_FDRO) {
+		ModelQueueRead((Model.Reg == XHI_IDCODE) ? ICAP_IDCODE :
+				(Model.Reg == XHI_FAR) ? Model.Far : 0);
+		return;
+	}
+	for (Index = 0; Index < NumWords; Index++) {
+		if (Index < WPF) {
+			ModelQueueRead(0);
+			continue;
+		}
+		if ((Index % WPF) == 0) {
+			Frame = ModelNextFrame();
+		}
+		ModelQueueRead(Frame[Index % WPF]);
+		if ((Index % WPF) == (WPF - 1)) {
+			ModelFarIncrement();
+		}
+	}
+}
+
+/* Writeback: a frame goes to FAR when the next one has been received */
+static void ModelFdriWord(u32 Word)
+{
+	Model.FrameIn[Model.FrameFill++] = Word;
+	if (Model.FrameFill < WPF) {
+		return;
+	}
+	Model.FrameFill = 0;
+	if (Model.PipelineValid) {
+		memcpy(ModelNextFrame(), Model.Pipeline,
+				sizeof(Model.Pipeline));
+		ModelFarIncrement();
+	}
+	memcpy(Model.Pipeline, Model.FrameIn, sizeof(Model.FrameIn));
+	Model.PipelineValid = 1;
+}
+
+static void ModelRegWrite(u32 Word)
+{
+	switch (Model.Reg) {
+		case XHI_FAR:
+			Model.Far = Word;
+			Model.Wrapped = 0;
+			break;
+		case XHI_FDRI:
+			ModelFdriWord(Word);
+			break;
+		case XHI_CMD:
+			Model.Cmd = Word;
+			if (Word == XHI_CMD_DESYNCH) {
+				Model.Synced = 0;
+			}
+			if (Word == XHI_CMD_WCFG) {
+				Model.FrameFill = 0;
+				Model.PipelineValid = 0;
+			}
+			break;
+		default:
+			break;
+	}
+}
+
+/* Packet processor, one configuration word at a time */
+static void ModelConfigWord(u32 Word)
+{
+	u32 Type;
+
+	if (!Model.Synced) {
+		Model.Synced = (Word == XHI_SYNC_PACKET);
+		Model.Count = 0;
+		return;
+	}
+
+	if (Model.Count != 0) {
+		Model.Count--;
+		if (Model.Op == XHI_OP_WRITE) {
+			ModelRegWrite(Word);
+		}
+		return;
+	}
+
+	Type = (Word >> XHI_TYPE_SHIFT) & XHI_TYPE_MASK;
+	Model.Op = (Word >> XHI_OP_SHIFT) & XHI_OP_MASK;
+	if (Type == XHI_TYPE_1) {
+		Model.Reg = (Word >> XHI_REGISTER_SHIFT) & XHI_REGISTER_MASK;
+		Model.Count = Word & XHI_WORD_COUNT_MASK_TYPE_1;
+	} else if (Type == XHI_TYPE_2) {
+		Model.Count = Word & XHI_WORD_COUNT_MASK_TYPE_2;
+	} else {
+		Model.Op = 0;
+	}
+
+	if ((Model.Op == XHI_OP_READ) && (Model.Count != 0)) {
+		ModelStartRead(Model.Count);
+		Model.Count = 0;
+	}
+}
+
+/* With no readback data pending the driver would poll forever, report a
+ * word instead and count the underflow */
+static u32 ModelRfAvailable(void)
+{
+	u32 Avail = Model.RfLimit - Model.RfHead;
+
+	if (Avail == 0) {
+		return 1;
+	}
+	return (Avail > RF_DEPTH) ? RF_DEPTH : Avail;
+}
+
+static u32 ModelRfRead(void)
+{
+	if (Model.RfHead < Model.RfLimit) {
+		return Model.Rf[Model.RfHead++];
+	}
+	Model.Underflows++;
+	return 0xDEADBEEF;
+}
+
+static u32 Xil_In32(UINTPTR Addr)
+{
+	Model.Reads++;
+	switch (Addr) {
+		case XHI_GIER_OFFSET:
+			return Model.Gier;
+		case XHI_RF_OFFSET:
+			return ModelRfRead();
+		case XHI_SR_OFFSET:
+			return XHI_SR_DONE_MASK | XHI_SR_EOS_MASK;
+		case XHI_WFV_OFFSET:
+			return WF_DEPTH - Model.WfCnt;
+		case XHI_RFO_OFFSET:
+			return ModelRfAvailable();
+		default:
+			return 0;
+	}
+}
+
+static void Xil_Out32(UINTPTR Addr, u32 Value)
+{
+	u32 Index;
+
+	Model.Writes++;
+	switch (Addr) {
+		case XHI_GIER_OFFSET:
+			Model.Gier = Value;
+			break;
+		case XHI_WF_OFFSET:
+			if (Model.WfCnt < WF_DEPTH) {
+				Model.Wf[Model.WfCnt++] = Value;
+			}
+			break;
+		case XHI_SZ_OFFSET:
+			Model.Size = Value;
+			break;
+		case XHI_CR_OFFSET:
+			if (Value & XHI_CR_WRITE_MASK) {
+				for (Index = 0; Index < Model.WfCnt; Index++) {
+					ModelConfigWord(Model.Wf[Index]);
+				}
+				Model.WfCnt = 0;
+			}
+			if (Value & XHI_CR_READ_MASK) {
+				Model.RfLimit += Model.Size;
+				if (Model.RfLimit > Model.RfTail) {
+					Model.RfLimit = Model.RfTail;
+				}
+			}
+			if (Value & (XHI_CR_SW_RESET_MASK | XHI_CR_FIFO_CLR_MASK)) {
+				Model.WfCnt = 0;
+			}
+			break;
+		default:
+			break;
+	}
+}
+
+/************************** Stubs ********************************************/
+
+u32 Xil_AssertStatus;
+s32 Xil_AssertWait;
+
+void Xil_Assert(const char8 *File, s32 Line)
+{
+	printf("ASSERT %s:%d\n", File, (int)Line);
+}
+
+/************************** Test Helpers *************************************/
+
+static u32 Failures;
+
+#define CHECK(Cond, Msg) \
+	do { \
+		if (!(Cond)) { \
+			printf("FAIL line %d: %s\n", __LINE__, Msg); \
+			Failures++; \
+		} \
+	} while (0)
+
+static XHwIcap HwIcap;
+static u32 Buffer[MAX_READ_WORDS];
+static u32 Expect[NUM_COLS * MAX_MINORS][WPF];
+
+static void ModelFill(u32 Seed)
+{
+	u32 *Word = &Model.Mem[0][0][0][0][0];
+	u32 Index;
+
+	for (Index = 0; Index < sizeof(Model.Mem) / 4; Index++) {
+		Word[Index] = (Index * 2654435761U) ^ Seed;
+	}
+}
+
+static u32 FarOf(u32 Block, u32 Row, u32 Col, u32 Minor)
+{
+	return XHwIcap_SetupFar(0, Block, Row, Col, Minor);
+}
+
+/* Frames of a range, following the auto increment of the device */
+static void ExpectRange(u32 Far, u32 NumFrames)
+{
+	u32 Saved = Model.Far;
+	u32 Index;
+
+	Model.Far = Far;
+	Model.Wrapped = 0;
+	for (Index = 0; Index < NumFrames; Index++) {
+		memcpy(Expect[Index], ModelFrame(Model.Far), WPF * 4);
+		ModelFarIncrement();
+	}
+	Model.Far = Saved;
+}
+
+/************************** Tests ********************************************/
+
+static void TestReadFrames(void)
+{
+	static const u32 Ranges[][5] = {
+		/* Block, Row, Col, Minor, NumFrames */
+		{ 0, 0, 0, 0, 1 },
+		{ 0, 0, 0, 5, 20 },
+		{ 1, 1, 2, 0, 28 },	/* One whole column */
+		{ 0, 1, 1, 30, 40 },	/* Across three columns */
+		{ 0, 0, 4, 10, 56 },	/* Up to the end of the row */
+		{ 1, 0, 0, 0, 202 },	/* The whole row */
+	};
+	u32 Index, Frame;
+	int Status;
+
+	for (Index = 0; Index < sizeof(Ranges) / sizeof(Ranges[0]); Index++) {
+		const u32 *R = Ranges[Index];
+		u32 Far = FarOf(R[0], R[1], R[2], R[3]);
+
+		ExpectRange(Far, R[4]);
+		memset(Buffer, 0xA5, sizeof(Buffer));
+		Model.RowCrossings = 0;
+
+		Status = XHwIcap_DeviceReadFrames(&HwIcap, 0, R[0], R[1],
+					R[2], R[3], R[4], Buffer);
+		CHECK(Status == XST_SUCCESS, "read frames failed");
+		for (Frame = 0; Frame < R[4]; Frame++) {
+			CHECK(memcmp(&Buffer[(Frame + 1) * WPF], Expect[Frame],
+					WPF * 4) == 0, "readback frame differs");
+		}
+		CHECK(Buffer[(R[4] + 1) * WPF] == 0xA5A5A5A5,
+				"read past the end of the buffer");
+		CHECK(Model.Synced == 0, "not desynced");
+	}
+
+	/* The single frame call is a range of one */
+	Status = XHwIcap_DeviceReadFrame(&HwIcap, 0, 0, 1, 3, 7, Buffer);
+	CHECK(Status == XST_SUCCESS, "read frame failed");
+	CHECK(memcmp(&Buffer[WPF], ModelFrame(FarOf(0, 1, 3, 7)), WPF * 4) == 0,
+			"single frame differs");
+}
+
+static void TestWriteFrames(void)
+{
+	static u32 Before[sizeof(Model.Mem) / 4];
+	u32 *Mem = &Model.Mem[0][0][0][0][0];
+	u32 NumFrames = 40;
+	u32 Far = FarOf(0, 1, 1, 30);
+	u32 Index, Frame;
+	u32 Changed = 0;
+	int Status;
+
+	/* Read the range, modify it and write it back */
+	Status = XHwIcap_DeviceReadFrames(&HwIcap, 0, 0, 1, 1, 30, NumFrames,
+				Buffer);
+	CHECK(Status == XST_SUCCESS, "read frames failed");
+	for (Index = WPF; Index < (NumFrames + 1) * WPF; Index++) {
+		Buffer[Index] = ~Buffer[Index];
+	}
+	memcpy(Before, Mem, sizeof(Before));
+
+	Status = XHwIcap_DeviceWriteFrames(&HwIcap, 0, 0, 1, 1, 30, NumFrames,
+				Buffer);
+	CHECK(Status == XST_SUCCESS, "write frames failed");
+
+	ExpectRange(Far, NumFrames);
+	for (Frame = 0; Frame < NumFrames; Frame++) {
+		CHECK(memcmp(&Buffer[(Frame + 1) * WPF], Expect[Frame],
+				WPF * 4) == 0, "written frame differs");
+	}
+
+	/* Nothing outside the range, the pad frame stays in the pipeline */
+	for (Index = 0; Index < sizeof(Before) / 4; Index++) {
+		Changed += (Before[Index] != Mem[Index]);
+	}
+	CHECK(Changed == NumFrames * WPF, "words outside the range written");
+	CHECK(Model.Synced == 0, "not desynced");
+}
+
+/* Register accesses and host time per frame, one call per frame against
+ * one call for the range */
+static void Benchmark(void)
+{
+	static const u32 Sizes[] = { 1, 4, 16, 36, 202 };
+	u32 Index, Frame, Iter, Iters;
+	u32 Accesses[2];
+	double Fps[2];
+	clock_t Start;
+
+	printf("%8s %16s %16s %12s %12s\n", "frames", "acc/frame single",
+			"acc/frame range", "fps single", "fps range");
+	for (Index = 0; Index < sizeof(Sizes) / sizeof(Sizes[0]); Index++) {
+		u32 NumFrames = Sizes[Index];
+
+		Iters = 2000 / NumFrames + 1;
+
+		Model.Reads = Model.Writes = 0;
+		Start = clock();
+		for (Iter = 0; Iter < Iters; Iter++) {
+			for (Frame = 0; Frame < NumFrames; Frame++) {
+				XHwIcap_DeviceReadFrame(&HwIcap, 0, 0, 0,
+					(Frame / 36), (Frame % 36), Buffer);
+			}
+		}
+		Accesses[0] = (Model.Reads + Model.Writes) /
+				(Iters * NumFrames);
+		Fps[0] = (double)Iters * NumFrames * CLOCKS_PER_SEC /
+				(double)(clock() - Start + 1);
+
+		Model.Reads = Model.Writes = 0;
+		Start = clock();
+		for (Iter = 0; Iter < Iters; Iter++) {
+			XHwIcap_DeviceReadFrames(&HwIcap, 0, 0, 0, 0, 0,
+					NumFrames, Buffer);
+		}
+		Accesses[1] = (Model.Reads + Model.Writes) /
+				(Iters * NumFrames);
+		Fps[1] = (double)Iters * NumFrames * CLOCKS_PER_SEC /
+				(double)(clock() - Start + 1);
+
+		printf("%8u %16u %16u %12.0f %12.0f\n", NumFrames,
+				Accesses[0], Accesses[1], Fps[0], Fps[1]);
+	}
+}
+
+int main(void)
+{
+	static XHwIcap_Config Config;
+	int Status;
+
+	ModelFill(0x5A5A0000);
+
+	Config.IcapWidth = 32;
+	Status = XHwIcap_CfgInitialize(&HwIcap, &Config, 0);
+	CHECK(Status == XST_SUCCESS, "initialize failed");
+	CHECK(HwIcap.WordsPerFrame == WPF, "not detected as 7 series");
+
+	TestReadFrames();
+	TestWriteFrames();
+	CHECK(Model.RowCrossings == 0, "a range crossed a row");
+	CHECK(Model.Underflows == 0, "read with no readback data");
+
+	Benchmark();
+
+	printf("%s (%u failures)\n", Failures ? "FAILED" : "PASSED", Failures);
+	return (Failures ? 1 : 0);
+}
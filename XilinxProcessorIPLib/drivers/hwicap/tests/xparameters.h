@@ -0,0 +1,17 @@
+/******************************************************************************
+* Copyright (C) 2020 Xilinx, Inc.  All rights reserved.
+* SPDX-License-Identifier: MIT
+******************************************************************************/
+
+/*
+ * Hardware parameters of the modelled HWICAP used by the host tests: 32-bit
+ * ICAP with the read and write FIFOs enabled
+ */
+#ifndef XPARAMETERS_H
+#define XPARAMETERS_H
+
+#define XPAR_XHWICAP_NUM_INSTANCES	1
+#define XPAR_HWICAP_0_ICAP_DWIDTH	32
+#define XPAR_HWICAP_0_MODE		0
+
+#endif
@@ -69,10 +69,21 @@
 
 /***************** Macros (Inline Functions) Definitions *********************/
 
+/*
+ * Use count leading zeros for the priority search when the processor has it,
+ * MicroBlaze only has it with the pattern compare instructions.
+ */
+#if defined (__GNUC__) && (!defined (__MICROBLAZE__) || \
+	(defined (XPAR_MICROBLAZE_USE_PCMP_INSTR) && \
+	 (XPAR_MICROBLAZE_USE_PCMP_INSTR == 1)))
+#define XINTC_USE_CLZ
+#endif
 
 /************************** Function Prototypes ******************************/
 
 static XIntc_Config *LookupConfigByBaseAddress(UINTPTR BaseAddress);
+static INLINE u32 XIntc_HighestPriorityIntr(u32 IntrStatus);
+static INLINE u32 XIntc_ValidIntrMask(XIntc_Config *CfgPtr);
 
 #if XPAR_INTC_0_INTC_TYPE != XIN_INTC_NOCASCADE
 static void XIntc_CascadeHandler(void *DeviceId);
@@ -80,6 +91,30 @@ static void XIntc_CascadeHandler(void *DeviceId);
 
 /************************** Variable Definitions *****************************/
 
+#ifndef XINTC_USE_CLZ
+/*
+ * Number of the lowest set bit of each byte value, entry 0 is unused.
+ */
+static const u8 XIntc_LowestBitTable[256] = {
+	0, 0, 1, 0, 2, 0, 1, 0, 3, 0, 1, 0, 2, 0, 1, 0,
+	4, 0, 1, 0, 2, 0, 1, 0, 3, 0, 1, 0, 2, 0, 1, 0,
+	5, 0, 1, 0, 2, 0, 1, 0, 3, 0, 1, 0, 2, 0, 1, 0,
+	4, 0, 1, 0, 2, 0, 1, 0, 3, 0, 1, 0, 2, 0, 1, 0,
+	6, 0, 1, 0, 2, 0, 1, 0, 3, 0, 1, 0, 2, 0, 1, 0,
+	4, 0, 1, 0, 2, 0, 1, 0, 3, 0, 1, 0, 2, 0, 1, 0,
+	5, 0, 1, 0, 2, 0, 1, 0, 3, 0, 1, 0, 2, 0, 1, 0,
+	4, 0, 1, 0, 2, 0, 1, 0, 3, 0, 1, 0, 2, 0, 1, 0,
+	7, 0, 1, 0, 2, 0, 1, 0, 3, 0, 1, 0, 2, 0, 1, 0,
+	4, 0, 1, 0, 2, 0, 1, 0, 3, 0, 1, 0, 2, 0, 1, 0,
+	5, 0, 1, 0, 2, 0, 1, 0, 3, 0, 1, 0, 2, 0, 1, 0,
+	4, 0, 1, 0, 2, 0, 1, 0, 3, 0, 1, 0, 2, 0, 1, 0,
+	6, 0, 1, 0, 2, 0, 1, 0, 3, 0, 1, 0, 2, 0, 1, 0,
+	4, 0, 1, 0, 2, 0, 1, 0, 3, 0, 1, 0, 2, 0, 1, 0,
+	5, 0, 1, 0, 2, 0, 1, 0, 3, 0, 1, 0, 2, 0, 1, 0,
+	4, 0, 1, 0, 2, 0, 1, 0, 3, 0, 1, 0, 2, 0, 1, 0
+};
+#endif
+
 /*****************************************************************************/
 /**
 *
@@ -125,6 +160,8 @@ void XIntc_LowLevelInterruptHandler(void)
 * active and enabled and call the appropriate interrupt handler. It uses
 * the AckBeforeService flag in the configuration data to determine when to
 * acknowledge the interrupt. Highest priority interrupts are serviced first.
+* Interrupts connected with XIntc_ConnectFastHandler are vectored to their
+* handler by the hardware and are not dispatched by this function.
 * This function assumes that an interrupt vector table has been previously
 * initialized.It does not verify that entries in the table are valid before
 * calling an interrupt handler. In Cascade mode this function calls
@@ -193,97 +230,88 @@ void XIntc_DeviceInterruptHandler(void *DeviceId)
 			IntrStatus &=  ~Imr;
 		}
 
-		/* Service each interrupt that is active and enabled by
-		 * checking each bit in the register from LSB to MSB which
-		 * corresponds to an interrupt input signal
+		/* Service each interrupt that is active and enabled, the
+		 * lowest set bit is the highest priority interrupt and is
+		 * found directly instead of checking each bit in turn
 		 */
-		for (IntrNumber = 0; IntrNumber < (CfgPtr->NumberofIntrs + CfgPtr->NumberofSwIntrs);
-								IntrNumber++) {
-			if (IntrStatus & 1) {
-				XIntc_VectorTableEntry *TablePtr;
+		IntrStatus &= XIntc_ValidIntrMask(CfgPtr);
+		while (IntrStatus != 0) {
+			XIntc_VectorTableEntry *TablePtr;
+
+			IntrNumber = (int)XIntc_HighestPriorityIntr(IntrStatus);
+			IntrMask = (u32)1 << IntrNumber;
+			IntrStatus &= ~IntrMask;
 #if XPAR_XINTC_HAS_ILR == TRUE
-				/* Write to ILR the current interrupt
-				* number
-				*/
-				Xil_Out32(CfgPtr->BaseAddress +
-						XIN_ILR_OFFSET, IntrNumber);
-
-				/* Read back ILR to ensure the value
-				* has been updated and it is safe to
-				* enable interrupts
-				*/
-
-				Xil_In32(CfgPtr->BaseAddress +
-						XIN_ILR_OFFSET);
-
-				/* Enable interrupts */
-				Xil_ExceptionEnable();
+			/* Write to ILR the current interrupt
+			* number
+			*/
+			Xil_Out32(CfgPtr->BaseAddress +
+					XIN_ILR_OFFSET, IntrNumber);
+
+			/* Read back ILR to ensure the value
+			* has been updated and it is safe to
+			* enable interrupts
+			*/
+
+			Xil_In32(CfgPtr->BaseAddress +
+					XIN_ILR_OFFSET);
+
+			/* Enable interrupts */
+			Xil_ExceptionEnable();
 #endif
-				/* If the interrupt has been setup to
-				 * acknowledge it before servicing the
-				 * interrupt, then ack it */
-				if (CfgPtr->AckBeforeService & IntrMask) {
-					XIntc_AckIntr(CfgPtr->BaseAddress,
-								IntrMask);
-				}
-
-				/* The interrupt is active and enabled, call
-				 * the interrupt handler that was setup with
-				 * the specified parameter
-				 */
-				TablePtr = &(CfgPtr->HandlerTable[IntrNumber]);
-				TablePtr->Handler(TablePtr->CallBackRef);
-
-				/* If the interrupt has been setup to
-				 * acknowledge it after it has been serviced
-				 * then ack it
-				 */
-				if ((CfgPtr->AckBeforeService &
-							IntrMask) == 0) {
-					XIntc_AckIntr(CfgPtr->BaseAddress,
-								IntrMask);
-				}
+			/* If the interrupt has been setup to
+			 * acknowledge it before servicing the
+			 * interrupt, then ack it */
+			if (CfgPtr->AckBeforeService & IntrMask) {
+				XIntc_AckIntr(CfgPtr->BaseAddress,
+							IntrMask);
+			}
+
+			/* The interrupt is active and enabled, call
+			 * the interrupt handler that was setup with
+			 * the specified parameter
+			 */
+			TablePtr = &(CfgPtr->HandlerTable[IntrNumber]);
+			TablePtr->Handler(TablePtr->CallBackRef);
+
+			/* If the interrupt has been setup to
+			 * acknowledge it after it has been serviced
+			 * then ack it
+			 */
+			if ((CfgPtr->AckBeforeService &
+						IntrMask) == 0) {
+				XIntc_AckIntr(CfgPtr->BaseAddress,
+							IntrMask);
+			}
 
 #if XPAR_XINTC_HAS_ILR == TRUE
-				/* Disable interrupts */
-				Xil_ExceptionDisable();
-				/* Restore ILR */
-				Xil_Out32(CfgPtr->BaseAddress + XIN_ILR_OFFSET,
-								ILR_reg);
+			/* Disable interrupts */
+			Xil_ExceptionDisable();
+			/* Restore ILR */
+			Xil_Out32(CfgPtr->BaseAddress + XIN_ILR_OFFSET,
+							ILR_reg);
 #endif
-				/*
-				 * Read the ISR again to handle architectures
-				 * with posted write bus access issues.
-				 */
-				 (void) XIntc_GetIntrStatus(CfgPtr->BaseAddress);
-
-				/*
-				 * If only the highest priority interrupt is to
-				 * be serviced, exit loop and return after
-				 * servicing
-				 * the interrupt
-				 */
-				if (CfgPtr->Options == XIN_SVC_SGL_ISR_OPTION) {
+			/*
+			 * Read the ISR again to handle architectures
+			 * with posted write bus access issues.
+			 */
+			 (void) XIntc_GetIntrStatus(CfgPtr->BaseAddress);
+
+			/*
+			 * If only the highest priority interrupt is to
+			 * be serviced, exit loop and return after
+			 * servicing
+			 * the interrupt
+			 */
+			if (CfgPtr->Options == XIN_SVC_SGL_ISR_OPTION) {
 
 #if XPAR_XINTC_HAS_ILR == TRUE
 #ifdef __MICROBLAZE__
-					/* Restore r14 */
-					mtgpr(r14, R14_register);
+				/* Restore r14 */
+				mtgpr(r14, R14_register);
 #endif
 #endif
-					return;
-				}
-			}
-
-			/* Move	 to the next interrupt to check */
-			IntrMask <<= 1;
-			IntrStatus >>= 1;
-
-			/* If there are no other bits set indicating that all
-			 * interrupts have been serviced, then exit the loop
-			 */
-			if (IntrStatus == 0) {
-				break;
+				return;
 			}
 		}
 #if XPAR_XINTC_HAS_ILR == TRUE
@@ -593,80 +621,128 @@ static void XIntc_CascadeHandler(void *DeviceId)
 		IntrStatus &=  ~Imr;
 	}
 
-	/* Service each interrupt that is active and enabled by
-	 * checking each bit in the register from LSB to MSB which
-	 * corresponds to an interrupt input signal
+	/* Service each interrupt that is active and enabled, the lowest set
+	 * bit is the highest priority interrupt. Interrupt 31 of a cascaded
+	 * controller is reached without scanning the bits below it
 	 */
-	for (IntrNumber = 0; IntrNumber < (CfgPtr->NumberofIntrs + CfgPtr->NumberofSwIntrs); IntrNumber++) {
-		if (IntrStatus & 1) {
-			XIntc_VectorTableEntry *TablePtr;
+	IntrStatus &= XIntc_ValidIntrMask(CfgPtr);
+	while (IntrStatus != 0) {
+		XIntc_VectorTableEntry *TablePtr;
 
-			/* In Cascade mode call this function recursively
-			 * for interrupt id 31 and until interrupts of last
-			 * instance/controller are handled
-			 */
-			if ((IntrNumber == 31) &&
-			  (CfgPtr->IntcType != XIN_INTC_LAST) &&
-			  (CfgPtr->IntcType != XIN_INTC_NOCASCADE)) {
-				XIntc_CascadeHandler((void *)++Id);
-				Id--;
-			}
+		IntrNumber = (int)XIntc_HighestPriorityIntr(IntrStatus);
+		IntrMask = (u32)1 << IntrNumber;
+		IntrStatus &= ~IntrMask;
 
-			/* If the interrupt has been setup to
-			 * acknowledge it before servicing the
-			 * interrupt, then ack it */
-			if (CfgPtr->AckBeforeService & IntrMask) {
-				XIntc_AckIntr(CfgPtr->BaseAddress, IntrMask);
-			}
+		/* In Cascade mode call this function recursively
+		 * for interrupt id 31 and until interrupts of last
+		 * instance/controller are handled
+		 */
+		if ((IntrNumber == 31) &&
+		  (CfgPtr->IntcType != XIN_INTC_LAST) &&
+		  (CfgPtr->IntcType != XIN_INTC_NOCASCADE)) {
+			XIntc_CascadeHandler((void *)++Id);
+			Id--;
+		}
 
-			/* Handler of 31 interrupt Id has to be called only
-			 * for Last controller in cascade Mode
-			 */
-			if (!((IntrNumber == 31) &&
-			  (CfgPtr->IntcType != XIN_INTC_LAST) &&
-			  (CfgPtr->IntcType != XIN_INTC_NOCASCADE))) {
-
-				/* The interrupt is active and enabled, call
-				 * the interrupt handler that was setup with
-				 * the specified parameter
-				 */
-				TablePtr = &(CfgPtr->HandlerTable[IntrNumber]);
-				TablePtr->Handler(TablePtr->CallBackRef);
-			}
-			/* If the interrupt has been setup to acknowledge it
-			 * after it has been serviced then ack it
-			 */
-			if ((CfgPtr->AckBeforeService & IntrMask) == 0) {
-				XIntc_AckIntr(CfgPtr->BaseAddress, IntrMask);
-			}
+		/* If the interrupt has been setup to
+		 * acknowledge it before servicing the
+		 * interrupt, then ack it */
+		if (CfgPtr->AckBeforeService & IntrMask) {
+			XIntc_AckIntr(CfgPtr->BaseAddress, IntrMask);
+		}
 
-			/*
-			 * Read the ISR again to handle architectures with
-			 * posted write bus access issues.
-			 */
-			 XIntc_GetIntrStatus(CfgPtr->BaseAddress);
+		/* Handler of 31 interrupt Id has to be called only
+		 * for Last controller in cascade Mode
+		 */
+		if (!((IntrNumber == 31) &&
+		  (CfgPtr->IntcType != XIN_INTC_LAST) &&
+		  (CfgPtr->IntcType != XIN_INTC_NOCASCADE))) {
 
-			/*
-			 * If only the highest priority interrupt is to be
-			 * serviced, exit loop and return after servicing
-			 * the interrupt
+			/* The interrupt is active and enabled, call
+			 * the interrupt handler that was setup with
+			 * the specified parameter
 			 */
-			if (CfgPtr->Options == XIN_SVC_SGL_ISR_OPTION) {
-				return;
-			}
+			TablePtr = &(CfgPtr->HandlerTable[IntrNumber]);
+			TablePtr->Handler(TablePtr->CallBackRef);
+		}
+		/* If the interrupt has been setup to acknowledge it
+		 * after it has been serviced then ack it
+		 */
+		if ((CfgPtr->AckBeforeService & IntrMask) == 0) {
+			XIntc_AckIntr(CfgPtr->BaseAddress, IntrMask);
 		}
 
-		/* Move	 to the next interrupt to check */
-		IntrMask <<= 1;
-		IntrStatus >>= 1;
+		/*
+		 * Read the ISR again to handle architectures with
+		 * posted write bus access issues.
+		 */
+		 XIntc_GetIntrStatus(CfgPtr->BaseAddress);
 
-		/* If there are no other bits set indicating that all interrupts
-		 * have been serviced, then exit the loop
+		/*
+		 * If only the highest priority interrupt is to be
+		 * serviced, exit loop and return after servicing
+		 * the interrupt
 		 */
-		if (IntrStatus == 0) {
-			break;
+		if (CfgPtr->Options == XIN_SVC_SGL_ISR_OPTION) {
+			return;
 		}
 	}
 }
 #endif
+
+/*****************************************************************************/
+/**
+*
+* Returns the number of the highest priority interrupt in a non zero interrupt
+* status value, which is its lowest set bit.
+*
+* @param	IntrStatus is the pending interrupt mask, must not be 0.
+*
+* @return	Interrupt number of the lowest set bit.
+*
+* @note		None.
+*
+******************************************************************************/
+static INLINE u32 XIntc_HighestPriorityIntr(u32 IntrStatus)
+{
+#ifdef XINTC_USE_CLZ
+	/* Isolate the lowest set bit, its position is 31 - clz */
+	return 31U - (u32)__builtin_clz(IntrStatus & (~IntrStatus + 1U));
+#else
+	u32 Shift = 0U;
+
+	if ((IntrStatus & 0xFFFFU) == 0U) {
+		Shift = 16U;
+	}
+	if (((IntrStatus >> Shift) & 0xFFU) == 0U) {
+		Shift += 8U;
+	}
+
+	return Shift + XIntc_LowestBitTable[(IntrStatus >> Shift) & 0xFFU];
+#endif
+}
+
+/*****************************************************************************/
+/**
+*
+* Returns the mask of the interrupt inputs, hardware and software, that are
+* present in a controller.
+*
+* @param	CfgPtr is the configuration of the controller.
+*
+* @return	Mask with a bit set for each interrupt input.
+*
+* @note		None.
+*
+******************************************************************************/
+static INLINE u32 XIntc_ValidIntrMask(XIntc_Config *CfgPtr)
+{
+	u32 NumIntrs = (u32)(CfgPtr->NumberofIntrs + CfgPtr->NumberofSwIntrs);
+
+	if (NumIntrs >= 32U) {
+		return 0xFFFFFFFFU;
+	}
+
+	return ((u32)1 << NumIntrs) - 1U;
+}
 /** @} */
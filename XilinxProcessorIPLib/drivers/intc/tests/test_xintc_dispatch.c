@@ -0,0 +1,474 @@
+/******************************************************************************
+* Copyright (C) 2020 Xilinx, Inc.  All rights reserved.
+* SPDX-License-Identifier: MIT
+******************************************************************************/
+
+/*****************************************************************************/
+/**
+*
+* @file test_xintc_dispatch.c
+*
+* Host test and benchmark of the interrupt dispatch of the INTC driver. The
+* driver is built against a model of AXI INTC controllers: status, enable,
+* mode and acknowledge registers, with a primary and a last controller in
+* cascade, the last one driving input 31 of the primary, and a controller
+* outside the cascade.
+*
+* XIntc_DeviceInterruptHandler is compared with the bit by bit loop it
+* replaced on random pending, enable, fast interrupt, acknowledge and
+* service option settings: the register accesses and handler calls must be
+* identical. Both are then timed per handler entry with 1, 4 and 32 pending
+* sources.
+*
+* Build and run on the host, with -DXINTC_TEST_LOOKUP_TABLE for the lookup
+* table used by processors without count leading zeros. The driver passes
+* device IDs as pointers through 32 bit integers and discards the status
+* read back after an acknowledge, hence the -Wno flags:
+*   cc -Wall -Wno-pointer-to-int-cast -Wno-int-to-pointer-cast \
+*      -Wno-unused-value -O2 -I. -I../src \
+*      -I../../../../lib/bsp/standalone/src/common \
+*      test_xintc_dispatch.c -o test_xintc_dispatch
+*   ./test_xintc_dispatch
+*
+******************************************************************************/
+
+/***************************** Include Files *********************************/
+
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+
+/* Build the standalone (non Linux) flavour of the driver */
+#undef __linux__
+#include "xil_types.h"
+
+/* Register accesses go to the model below */
+#define XIL_IO_H
+static u32 Xil_In32(UINTPTR Addr);
+static void Xil_Out32(UINTPTR Addr, u32 Value);
+static void Xil_Out64(UINTPTR Addr, u64 Value);
+
+#define INLINE inline
+#include "xparameters.h"
+#include "xil_assert.h"
+#include "xintc.h"
+#include "xintc_i.h"
+
+#ifdef XINTC_TEST_LOOKUP_TABLE
+/* Select the lookup table, the driver is otherwise not MicroBlaze specific
+ * without nested interrupts */
+#define __MICROBLAZE__
+#include "xintc_l.c"
+#undef __MICROBLAZE__
+#else
+#include "xintc_l.c"
+#endif
+
+/************************** Model ********************************************/
+
+#define NUM_CTRL	XPAR_XINTC_NUM_INSTANCES
+#define CTRL_BASE(n)	(0x41200000U + (n) * 0x10000U)
+#define MAX_TRACE	4096
+
+typedef struct {
+	u32 Isr;
+	u32 Ier;
+	u32 Imr;
+} IntcModel;
+
+static IntcModel Model[NUM_CTRL];
+
+/* Register accesses and handler calls, in order */
+static u32 Trace[MAX_TRACE];
+static u32 TraceLen;
+static int Tracing;
+
+#define TRACE_READ	0x10000000U
+#define TRACE_WRITE	0x20000000U
+#define TRACE_CALL	0x30000000U
+
+static void TraceAdd(u32 Event, u32 Value)
+{
+	if (Tracing && TraceLen + 2U <= MAX_TRACE) {
+		Trace[TraceLen++] = Event;
+		Trace[TraceLen++] = Value;
+	}
+}
+
+/* Input 31 of a cascaded controller is the output of the next one */
+static u32 ModelIsr(u32 Ctrl)
+{
+	u32 Isr = Model[Ctrl].Isr;
+
+	if (Ctrl + 1U < NUM_CTRL &&
+	    XIntc_ConfigTable[Ctrl].IntcType != XIN_INTC_NOCASCADE &&
+	    XIntc_ConfigTable[Ctrl].IntcType != XIN_INTC_LAST &&
+	    (ModelIsr(Ctrl + 1U) & Model[Ctrl + 1U].Ier) != 0U) {
+		Isr |= 0x80000000U;
+	}
+	return Isr;
+}
+
+static u32 Xil_In32(UINTPTR Addr)
+{
+	u32 Ctrl = (u32)((Addr - CTRL_BASE(0)) >> 16);
+	u32 Offset = (u32)(Addr & 0xFFFFU);
+	u32 Value = 0U;
+
+	switch (Offset) {
+	case XIN_ISR_OFFSET:
+		Value = ModelIsr(Ctrl);
+		break;
+	case XIN_IER_OFFSET:
+		Value = Model[Ctrl].Ier;
+		break;
+	case XIN_IMR_OFFSET:
+		Value = Model[Ctrl].Imr;
+		break;
+	default:
+		break;
+	}
+	TraceAdd(TRACE_READ | (u32)(Addr & 0xFFFFFU), Value);
+	return Value;
+}
+
+static void Xil_Out32(UINTPTR Addr, u32 Value)
+{
+	u32 Ctrl = (u32)((Addr - CTRL_BASE(0)) >> 16);
+
+	TraceAdd(TRACE_WRITE | (u32)(Addr & 0xFFFFFU), Value);
+	if ((Addr & 0xFFFFU) == XIN_IAR_OFFSET) {
+		Model[Ctrl].Isr &= ~Value;
+	}
+}
+
+/* Fast interrupt vector addresses, not used by the dispatch */
+static void Xil_Out64(UINTPTR Addr, u64 Value)
+{
+	(void)Addr;
+	(void)Value;
+}
+
+/************************** Stubs ********************************************/
+
+u32 Xil_AssertStatus;
+s32 Xil_AssertWait;
+
+void Xil_Assert(const char8 *File, s32 Line)
+{
+	printf("ASSERT %s:%d\n", File, (int)Line);
+}
+
+XIntc_Config XIntc_ConfigTable[NUM_CTRL];
+u32 XIntc_BitPosMask[XIN_CONTROLLER_MAX_INTRS];
+
+XIntc_Config *XIntc_LookupConfig(u16 DeviceId)
+{
+	return &XIntc_ConfigTable[DeviceId];
+}
+
+/************************** Reference ****************************************/
+
+/*
+ * The dispatch loop replaced by the direct search: XIntc_CascadeHandler as
+ * it was, which without ILR also matches the loop of
+ * XIntc_DeviceInterruptHandler for a controller outside the cascade.
+ */
+static void RefHandler(void *DeviceId)
+{
+	u32 IntrStatus;
+	u32 IntrMask = 1;
+	int IntrNumber;
+	u32 Imr;
+	XIntc_Config *CfgPtr;
+	static int Id = 0;
+
+	CfgPtr = &XIntc_ConfigTable[(u32)(UINTPTR)DeviceId];
+	if (CfgPtr->IntcType == XIN_INTC_PRIMARY) {
+		Id = 0;
+	}
+
+	IntrStatus = XIntc_GetIntrStatus(CfgPtr->BaseAddress);
+	if (CfgPtr->FastIntr == TRUE) {
+		Imr = XIntc_In32(CfgPtr->BaseAddress + XIN_IMR_OFFSET);
+		IntrStatus &=  ~Imr;
+	}
+
+	for (IntrNumber = 0; IntrNumber < (CfgPtr->NumberofIntrs +
+				CfgPtr->NumberofSwIntrs); IntrNumber++) {
+		if (IntrStatus & 1) {
+			XIntc_VectorTableEntry *TablePtr;
+
+			if ((IntrNumber == 31) &&
+			  (CfgPtr->IntcType != XIN_INTC_LAST) &&
+			  (CfgPtr->IntcType != XIN_INTC_NOCASCADE)) {
+				RefHandler((void *)(UINTPTR)++Id);
+				Id--;
+			}
+			if (CfgPtr->AckBeforeService & IntrMask) {
+				XIntc_AckIntr(CfgPtr->BaseAddress, IntrMask);
+			}
+			if (!((IntrNumber == 31) &&
+			  (CfgPtr->IntcType != XIN_INTC_LAST) &&
+			  (CfgPtr->IntcType != XIN_INTC_NOCASCADE))) {
+				TablePtr = &(CfgPtr->HandlerTable[IntrNumber]);
+				TablePtr->Handler(TablePtr->CallBackRef);
+			}
+			if ((CfgPtr->AckBeforeService & IntrMask) == 0) {
+				XIntc_AckIntr(CfgPtr->BaseAddress, IntrMask);
+			}
+			XIntc_GetIntrStatus(CfgPtr->BaseAddress);
+			if (CfgPtr->Options == XIN_SVC_SGL_ISR_OPTION) {
+				return;
+			}
+		}
+		IntrMask <<= 1;
+		IntrStatus >>= 1;
+		if (IntrStatus == 0) {
+			break;
+		}
+	}
+}
+
+/************************** Test Helpers *************************************/
+
+static u32 Failures;
+
+#define CHECK(Cond, Msg) \
+	do { \
+		if (!(Cond)) { \
+			printf("FAIL line %d: %s\n", __LINE__, Msg); \
+			Failures++; \
+		} \
+	} while (0)
+
+static u32 Calls;
+static u32 Lcg = 2020U;
+
+static u32 Rand(void)
+{
+	Lcg = Lcg * 1103515245U + 12345U;
+	return (Lcg >> 8) ^ (Lcg << 14);
+}
+
+static void Handler(void *CallBackRef)
+{
+	Calls++;
+	TraceAdd(TRACE_CALL, (u32)(UINTPTR)CallBackRef);
+}
+
+static void SetupConfig(void)
+{
+	u32 Ctrl;
+	u32 Id;
+
+	memset(XIntc_ConfigTable, 0, sizeof(XIntc_ConfigTable));
+	for (Ctrl = 0U; Ctrl < NUM_CTRL; Ctrl++) {
+		XIntc_ConfigTable[Ctrl].DeviceId = (u16)Ctrl;
+		XIntc_ConfigTable[Ctrl].BaseAddress = CTRL_BASE(Ctrl);
+		XIntc_ConfigTable[Ctrl].NumberofIntrs = 32;
+		for (Id = 0U; Id < XIN_CONTROLLER_MAX_INTRS; Id++) {
+			XIntc_ConfigTable[Ctrl].HandlerTable[Id].Handler =
+				Handler;
+			XIntc_ConfigTable[Ctrl].HandlerTable[Id].CallBackRef =
+				(void *)(UINTPTR)((Ctrl << 8) | Id);
+		}
+	}
+	XIntc_ConfigTable[0].IntcType = XIN_INTC_PRIMARY;
+	XIntc_ConfigTable[1].IntcType = XIN_INTC_LAST;
+	XIntc_ConfigTable[2].IntcType = XIN_INTC_NOCASCADE;
+}
+
+/************************** Tests ********************************************/
+
+static void RunTraced(void (*Fn)(void *), u32 DeviceId,
+		      const IntcModel *Start, u32 *Out, u32 *OutLen,
+		      IntcModel *End)
+{
+	memcpy(Model, Start, sizeof(Model));
+	TraceLen = 0U;
+	Tracing = 1;
+	Fn((void *)(UINTPTR)DeviceId);
+	Tracing = 0;
+	memcpy(Out, Trace, TraceLen * sizeof(Trace[0]));
+	*OutLen = TraceLen;
+	memcpy(End, Model, sizeof(Model));
+}
+
+/* Same register accesses and handler calls as the bit by bit loop */
+static void TestEquivalence(void)
+{
+	static u32 RefTrace[MAX_TRACE];
+	IntcModel Start[NUM_CTRL];
+	IntcModel RefEnd[NUM_CTRL];
+	IntcModel NewEnd[NUM_CTRL];
+	u32 RefLen;
+	u32 NewLen;
+	u32 Round;
+	u32 Ctrl;
+	u32 Mismatches = 0U;
+	u32 DeviceId;
+	u32 Sources;
+
+	SetupConfig();
+	for (Round = 0U; Round < 20000U; Round++) {
+		for (Ctrl = 0U; Ctrl < NUM_CTRL; Ctrl++) {
+			XIntc_Config *CfgPtr = &XIntc_ConfigTable[Ctrl];
+
+			/* From none to all sources pending */
+			Sources = Rand() % 33U;
+			Start[Ctrl].Isr = Sources == 32U ? 0xFFFFFFFFU :
+				(Rand() & Rand() & Rand()) |
+				(Sources ? 1U << (Rand() % 32U) : 0U);
+			Start[Ctrl].Ier = (Rand() % 4U) ? 0xFFFFFFFFU : Rand();
+			Start[Ctrl].Imr = Rand();
+			CfgPtr->FastIntr = (Rand() % 4U) == 0U;
+			CfgPtr->AckBeforeService = Rand();
+			CfgPtr->Options = (Rand() % 4U) == 0U ?
+				XIN_SVC_SGL_ISR_OPTION : XIN_SVC_ALL_ISRS_OPTION;
+			/* Fewer inputs than the register width, with software
+			 * interrupts above the hardware ones */
+			CfgPtr->NumberofIntrs = (Rand() % 3U) ? 32 :
+				(int)(Rand() % 32U);
+			CfgPtr->NumberofSwIntrs = CfgPtr->NumberofIntrs == 32 ?
+				0 : (int)(Rand() % (33U -
+				(u32)CfgPtr->NumberofIntrs));
+		}
+		/* Cascaded controllers have all 32 inputs */
+		XIntc_ConfigTable[0].NumberofIntrs = 32;
+		XIntc_ConfigTable[0].NumberofSwIntrs = 0;
+		DeviceId = (Round % 3U) == 2U ? 2U : 0U;
+
+		RunTraced(RefHandler, DeviceId, Start, RefTrace, &RefLen,
+			  RefEnd);
+		RunTraced(XIntc_DeviceInterruptHandler, DeviceId, Start,
+			  Trace, &NewLen, NewEnd);
+		if (RefLen != NewLen || memcmp(RefTrace, Trace,
+				RefLen * sizeof(Trace[0])) != 0 ||
+		    memcmp(RefEnd, NewEnd, sizeof(RefEnd)) != 0) {
+			if (Mismatches++ == 0U) {
+				printf("round %u device %u: isr %08x ier %08x, "
+				       "%u trace words vs %u\n", Round,
+				       DeviceId, Start[DeviceId].Isr,
+				       Start[DeviceId].Ier, RefLen, NewLen);
+			}
+		}
+	}
+	CHECK(Mismatches == 0U, "dispatch differs from the bit by bit loop");
+}
+
+/* Service order across the cascade */
+static void TestCascadeOrder(void)
+{
+	static const u32 Expected[] = { 0x003, 0x01E, 0x105, 0x11F };
+	u32 Served[4];
+	u32 Count = 0U;
+	u32 Index;
+
+	SetupConfig();
+	memset(Model, 0, sizeof(Model));
+	Model[0].Isr = (1U << 3) | (1U << 30);
+	Model[0].Ier = 0xFFFFFFFFU;
+	Model[1].Isr = (1U << 5) | (1U << 31);
+	Model[1].Ier = 0xFFFFFFFFU;
+	TraceLen = 0U;
+	Tracing = 1;
+	XIntc_DeviceInterruptHandler((void *)0);
+	Tracing = 0;
+
+	for (Index = 0U; Index + 1U < TraceLen; Index += 2U) {
+		if (Trace[Index] == TRACE_CALL && Count < 4U) {
+			Served[Count] = Trace[Index + 1U];
+			Count++;
+		}
+	}
+	CHECK(Count == 4U && memcmp(Served, Expected, sizeof(Served)) == 0,
+	      "cascade service order");
+	CHECK(Model[0].Isr == 0U && Model[1].Isr == 0U,
+	      "all cascaded interrupts acknowledged");
+}
+
+static double NowNs(void)
+{
+	struct timespec Ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &Ts);
+	return Ts.tv_sec * 1e9 + Ts.tv_nsec;
+}
+
+#define BENCH_ENTRIES	400000U
+#define BENCH_RUNS	5U
+
+/* Best time per handler entry with the given sources pending */
+static double Bench(void (*Fn)(void *), u32 Pending)
+{
+	double T0;
+	double Best = 0.0;
+	double Ns;
+	u32 Entry;
+	u32 Run;
+
+	Model[2].Ier = 0xFFFFFFFFU;
+	for (Run = 0U; Run < BENCH_RUNS; Run++) {
+		T0 = NowNs();
+		for (Entry = 0U; Entry < BENCH_ENTRIES; Entry++) {
+			Model[2].Isr = Pending;
+			Fn((void *)2);
+		}
+		Ns = (NowNs() - T0) / BENCH_ENTRIES;
+		if (Run == 0U || Ns < Best) {
+			Best = Ns;
+		}
+	}
+	return Best;
+}
+
+static void TestBenchmark(void)
+{
+	static const struct {
+		const char *Name;
+		u32 Pending;
+	} Cases[] = {
+		{ "1 source (input 31)", 0x80000000U },
+		{ "1 source (input 0)", 0x00000001U },
+		{ "4 sources", 0x80808080U },
+		{ "32 sources", 0xFFFFFFFFU },
+	};
+	double Ref;
+	double New;
+	u32 Index;
+	u32 RefCalls;
+
+	SetupConfig();
+	memset(Model, 0, sizeof(Model));
+	for (Index = 0U; Index < sizeof(Cases) / sizeof(Cases[0]); Index++) {
+		Calls = 0U;
+		Ref = Bench(RefHandler, Cases[Index].Pending);
+		RefCalls = Calls;
+		Calls = 0U;
+		New = Bench(XIntc_DeviceInterruptHandler, Cases[Index].Pending);
+		CHECK(Calls == RefCalls, "benchmark handler calls differ");
+		printf("%-20s %6.1f ns per entry bit loop, %6.1f ns %s\n",
+		       Cases[Index].Name, Ref, New,
+#ifdef XINTC_TEST_LOOKUP_TABLE
+		       "lookup table"
+#else
+		       "count leading zeros"
+#endif
+		       );
+		/* The bit loop walks 31 clear bits before the only source */
+		if (Index == 0U) {
+			CHECK(New * 1.25 < Ref, "direct search not faster");
+		}
+	}
+}
+
+int main(void)
+{
+	TestEquivalence();
+	TestCascadeOrder();
+	TestBenchmark();
+
+	printf("%s (%u failures)\n", Failures ? "FAILED" : "PASSED", Failures);
+	return Failures ? 1 : 0;
+}
@@ -0,0 +1,20 @@
+/******************************************************************************
+* Copyright (C) 2020 Xilinx, Inc.  All rights reserved.
+* SPDX-License-Identifier: MIT
+******************************************************************************/
+
+/*
+ * Hardware parameters of the modelled AXI INTC controllers used by the host
+ * tests: a primary and a last controller in cascade, and one more controller
+ * outside the cascade. Nested interrupts (ILR) are not configured.
+ */
+#ifndef XPARAMETERS_H
+#define XPARAMETERS_H
+
+#define XPAR_XINTC_NUM_INSTANCES	3
+#define XPAR_INTC_MAX_NUM_INTR_INPUTS	64
+#define XPAR_INTC_0_INTC_TYPE		1
+#define XPAR_XINTC_HAS_ILR		0
+#define XPAR_XINTC_USE_DCR		0
+
+#endif
@@ -152,6 +152,12 @@ extern "C" {
 #define XMCDMA_DEV_TO_MEM		0
 #define XMCDMA_MEM_TO_DEV		1
 
+/* Completion reaper tuning */
+#define XMCDMA_REAP_QUANTUM		4	/**< BDs reaped per unit of
+						  *  channel weight */
+#define XMCDMA_REAP_DELAY		16	/**< Irq delay used when the
+						  *  reaper enables coalescing */
+
 /**************************** Type Definitions *******************************/
 
 typedef enum {
@@ -227,8 +233,29 @@ typedef struct {
 	                                     * interrupt callback */
 	XMcdma_ChanPktDropHandler PktdropHandler;
 	void *PktDropRef;
+
+	u32 ReapWeight;		/**< Completion reaper weight, 0 means 1 */
+	u32 IrqCoalesce;	/**< Irq threshold set by the reaper,
+				  *  0 until first read from hardware */
+	u32 IrqDelay;		/**< Irq delay set by the reaper */
 } XMcdma_ChanCtrl;
 
+/**
+ * One buffer of a batched submit, see XMcDma_BatchSubmit().
+ */
+typedef struct {
+	u32 Chan_id;		/**< Channel number, 1 based */
+	UINTPTR BufAddr;	/**< Buffer address */
+	u32 Len;		/**< Buffer length in bytes */
+} XMcdma_BatchDesc;
+
+/**
+ * Called by XMcdma_ReapCompletions() for each set of completed BDs, before
+ * the BDs are freed.
+ */
+typedef void (*XMcdma_ReapHandler) (void *CallBackRef, XMcdma_ChanCtrl *Chan,
+				    XMcdma_Bd *BdSetPtr, int BdCount);
+
 typedef struct {
 	u32 DeviceId;
 	UINTPTR BaseAddress;
@@ -276,6 +303,8 @@ typedef struct {
 	                                          *  interrupt */
 	void *PktDropRef;                 /**< To be passed to the error
 	                                     * interrupt callback */
+	u32 TxReapNext;		/**< First MM2S channel for the next reap */
+	u32 RxReapNext;		/**< First S2MM channel for the next reap */
 
 } XMcdma;
 /***************** Macros (Inline Functions) Definitions *********************/
@@ -616,6 +645,14 @@ void XMcDma_DumpBd(XMcdma_Bd* BdPtr);
 int XMcDma_BdSetAppWord(XMcdma_Bd* BdPtr, int Offset, u32 Word);
 u32 XMcDma_BdGetAppWord(XMcdma_Bd* BdPtr, int Offset, int *Valid);
 
+/* Multi channel submit and completion */
+u32 XMcDma_BatchSubmit(XMcdma *InstancePtr, u32 Direction,
+		       XMcdma_BatchDesc *DescPtr, u32 Count);
+u32 XMcDma_BatchToHw(XMcdma *InstancePtr, u32 Direction, u32 ChanMask);
+u32 XMcdma_SetChanReapWeight(XMcdma_ChanCtrl *Chan, u8 Weight);
+int XMcdma_ReapCompletions(XMcdma *InstancePtr, u32 Direction, u32 Budget,
+			   XMcdma_ReapHandler Handler, void *CallBackRef);
+
 /* Global OR'ed Single interrupt */
 void XMcdma_IntrHandler(void *Instance);
 void XMcdma_TxIntrHandler(void *Instance);
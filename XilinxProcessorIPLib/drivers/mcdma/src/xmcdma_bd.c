@@ -57,6 +57,24 @@
         (BdPtr) = (XMcdma_Bd *)(void *)Addr;                            \
     }
 
+/*****************************************************************************/
+/**
+ * Get the channel of the given direction.
+ *
+ * @param	InstancePtr is the driver instance we are working on.
+ * @param	Direction is XMCDMA_MEM_TO_DEV or XMCDMA_DEV_TO_MEM.
+ * @param	ChanId is the channel number, 1 based.
+ *
+ * @returns	Pointer to the channel
+ *****************************************************************************/
+#define XMCDMA_DIR_CHAN(InstancePtr, Direction, ChanId)                 \
+    (((Direction) == XMCDMA_MEM_TO_DEV) ?                               \
+        XMcdma_GetMcdmaTxChan((InstancePtr), (ChanId)) :                \
+        XMcdma_GetMcdmaRxChan((InstancePtr), (ChanId)))
+
+static void XMcdma_AdaptCoalesce(XMcdma_ChanCtrl *Chan, u32 BdCount,
+				 u32 Quota, u32 Limit);
+
 
 /*****************************************************************************/
 /**
@@ -433,6 +451,119 @@ u32 XMcDma_ChanToHw(XMcdma_ChanCtrl *Chan)
 	return Status;
 }
 
+/*****************************************************************************/
+/**
+* This function populates the BD chains of several channels of one direction
+* and then starts them all with XMcDma_BatchToHw(), so that the channel enable
+* register is updated once for the whole batch.
+*
+* @param	InstancePtr is the driver instance we are working on.
+* @param	Direction is XMCDMA_MEM_TO_DEV or XMCDMA_DEV_TO_MEM.
+* @param	DescPtr is an array of buffers to submit. Buffers for the same
+*		channel are queued in array order.
+* @param	Count is the number of entries in DescPtr.
+*
+* @return
+*		- XST_SUCCESS if all buffers were submitted and started
+*		- XST_INVALID_PARAM if a channel number is out of range
+*		- XST_FAILURE if a channel has not enough free BDs. Buffers
+*		  before the failing entry are submitted but not started.
+*		- Error from XMcDma_BatchToHw() otherwise
+*
+*****************************************************************************/
+u32 XMcDma_BatchSubmit(XMcdma *InstancePtr, u32 Direction,
+		       XMcdma_BatchDesc *DescPtr, u32 Count)
+{
+	XMcdma_ChanCtrl *Chan;
+	u32 NumChans;
+	u32 ChanMask = 0;
+	u32 Status;
+	u32 i;
+
+	Xil_AssertNonvoid(InstancePtr != NULL);
+	Xil_AssertNonvoid(DescPtr != NULL);
+
+	NumChans = (Direction == XMCDMA_MEM_TO_DEV) ?
+		   (u32)InstancePtr->Config.TxNumChannels :
+		   (u32)InstancePtr->Config.RxNumChannels;
+
+	for (i = 0; i < Count; i++) {
+		if (DescPtr[i].Chan_id == 0 || DescPtr[i].Chan_id > NumChans)
+			return XST_INVALID_PARAM;
+
+		Chan = XMCDMA_DIR_CHAN(InstancePtr, Direction,
+				       DescPtr[i].Chan_id);
+		Status = XMcDma_ChanSubmit(Chan, DescPtr[i].BufAddr,
+					   DescPtr[i].Len);
+		if (Status != XST_SUCCESS)
+			return Status;
+
+		ChanMask |= 1U << (DescPtr[i].Chan_id - 1);
+	}
+
+	return XMcDma_BatchToHw(InstancePtr, Direction, ChanMask);
+}
+
+/*****************************************************************************/
+/**
+* This function hands the pending BDs of several channels to the hardware in
+* one pass. It does what XMcDma_ChanToHw() does for each channel in ChanMask
+* that has pending BDs, but enables all of them with a single write of the
+* channel enable register.
+*
+* @param	InstancePtr is the driver instance we are working on.
+* @param	Direction is XMCDMA_MEM_TO_DEV or XMCDMA_DEV_TO_MEM.
+* @param	ChanMask has bit (n - 1) set for each channel n to start.
+*
+* @return
+*		- XST_SUCCESS if all channels with pending BDs were started
+*		- Error from XMcdma_UpdateChanCDesc() or
+*		  XMcdma_UpdateChanTDesc() otherwise. Channels started before
+*		  the failing one are enabled.
+*
+*****************************************************************************/
+u32 XMcDma_BatchToHw(XMcdma *InstancePtr, u32 Direction, u32 ChanMask)
+{
+	XMcdma_ChanCtrl *Chan = NULL;
+	u32 NumChans;
+	u32 EnMask = 0;
+	u32 Chan_id;
+	int Status = XST_SUCCESS;
+
+	Xil_AssertNonvoid(InstancePtr != NULL);
+
+	NumChans = (Direction == XMCDMA_MEM_TO_DEV) ?
+		   (u32)InstancePtr->Config.TxNumChannels :
+		   (u32)InstancePtr->Config.RxNumChannels;
+
+	for (Chan_id = 1; Chan_id <= NumChans; Chan_id++) {
+		if (!(ChanMask & (1U << (Chan_id - 1))))
+			continue;
+
+		Chan = XMCDMA_DIR_CHAN(InstancePtr, Direction, Chan_id);
+		if (Chan->BdPendingCnt == 0)
+			continue;
+
+		Status = XMcdma_UpdateChanCDesc(Chan);
+		if (Status != XST_SUCCESS)
+			break;
+
+		Status = XMcdma_UpdateChanTDesc(Chan);
+		if (Status != XST_SUCCESS)
+			break;
+
+		EnMask |= 1U << (Chan_id - 1);
+	}
+
+	if (EnMask != 0) {
+		XMcdma_WriteReg(Chan->ChanBase, XMCDMA_CHEN_OFFSET,
+				XMcdma_ReadReg(Chan->ChanBase,
+					       XMCDMA_CHEN_OFFSET) | EnMask);
+	}
+
+	return Status;
+}
+
 /*****************************************************************************/
 /**
 * Returns a set of BD(s) that have been processed by hardware. The returned
@@ -568,6 +699,217 @@ int XMcdma_BdChainFree(XMcdma_ChanCtrl *Chan, int BdCount, XMcdma_Bd *BdSetPtr)
 	return XST_SUCCESS;
 }
 
+/*****************************************************************************/
+/**
+* Set the weight of a channel for XMcdma_ReapCompletions(). A channel reaps up
+* to Weight * XMCDMA_REAP_QUANTUM BDs each time it is visited.
+*
+* @param	Chan is the MCDMA Channel to be worked on.
+* @param	Weight is the weight, valid ranges are 1 to 15.
+*
+* @return
+*		- XST_SUCCESS if the weight is set
+*		- XST_INVALID_PARAM if Weight is out of range
+*
+*****************************************************************************/
+u32 XMcdma_SetChanReapWeight(XMcdma_ChanCtrl *Chan, u8 Weight)
+{
+	if (Weight == 0 || Weight > 0xF)
+		return XST_INVALID_PARAM;
+
+	Chan->ReapWeight = Weight;
+
+	return XST_SUCCESS;
+}
+
+/*****************************************************************************/
+/**
+* Reap completed BDs from all channels of one direction in weighted round
+* robin order.
+*
+* The interrupt serviced register is read once to find the channels with
+* completions; when it reads zero, as in polled operation, the channels with
+* BDs in hardware are visited instead. Each visited channel acknowledges its
+* IOC and delay interrupts and reaps up to its weight times
+* XMCDMA_REAP_QUANTUM BDs, which are passed to Handler and then freed.
+* Channels that filled their quota are visited again, in the same order,
+* until they run dry or Budget is used up, so a return value below Budget
+* means that all signalled completions were reaped. The next call starts
+* after the last channel visited, so that a small Budget still serves all
+* channels over time.
+*
+* After the first visit of a call the channel's Irq threshold is adapted to
+* the measured load: it is doubled when the channel used its whole weight
+* quota, up to the quota, and halved when fewer BDs than the threshold were
+* found, which means the delay timer rather than the threshold raised the
+* interrupt. A visit cut short by the end of Budget says nothing about the
+* load and leaves it unchanged.
+*
+* @param	InstancePtr is the driver instance we are working on.
+* @param	Direction is XMCDMA_MEM_TO_DEV or XMCDMA_DEV_TO_MEM.
+* @param	Budget is the maximum number of BDs to reap in this call.
+* @param	Handler is called for each set of completed BDs.
+* @param	CallBackRef is passed to Handler.
+*
+* @return	The number of BDs reaped, at most Budget.
+*
+* @note	Error interrupts are left pending for the interrupt handler.
+*		This function should not be preempted by another XMcdma
+*		function call that modifies the BD space of the same channels.
+*
+*****************************************************************************/
+int XMcdma_ReapCompletions(XMcdma *InstancePtr, u32 Direction, u32 Budget,
+			   XMcdma_ReapHandler Handler, void *CallBackRef)
+{
+	XMcdma_ChanCtrl *Chan;
+	XMcdma_Bd *BdSetPtr;
+	u32 *NextPtr;
+	u32 NumChans;
+	u32 SerMask;
+	u32 Chan_id;
+	u32 LastId = 0;
+	u32 Quota;
+	u32 Limit;
+	u32 Done = 0;
+	u32 IrqStatus;
+	u32 Pass;
+	u32 i;
+	int BdCount;
+
+	Xil_AssertNonvoid(InstancePtr != NULL);
+	Xil_AssertNonvoid(Handler != NULL);
+
+	if (Direction == XMCDMA_MEM_TO_DEV) {
+		NumChans = (u32)InstancePtr->Config.TxNumChannels;
+		NextPtr = &InstancePtr->TxReapNext;
+		SerMask = XMcdma_ReadReg(InstancePtr->Config.BaseAddress,
+					 XMCDMA_TXINT_SER_OFFSET);
+	} else {
+		NumChans = (u32)InstancePtr->Config.RxNumChannels;
+		NextPtr = &InstancePtr->RxReapNext;
+		SerMask = XMcdma_ReadReg(InstancePtr->Config.BaseAddress,
+					 XMCDMA_RX_OFFSET +
+					 XMCDMA_RXINT_SER_OFFSET);
+	}
+
+	if (NumChans == 0)
+		return 0;
+
+	if (SerMask == 0) {
+		for (Chan_id = 1; Chan_id <= NumChans; Chan_id++) {
+			Chan = XMCDMA_DIR_CHAN(InstancePtr, Direction, Chan_id);
+			if (Chan->BdSubmitCnt != 0)
+				SerMask |= 1U << (Chan_id - 1);
+		}
+	}
+
+	if (*NextPtr == 0 || *NextPtr > NumChans)
+		*NextPtr = 1;
+
+	for (Pass = 0; SerMask != 0 && Done < Budget; Pass++) {
+		for (i = 0; i < NumChans && Done < Budget; i++) {
+			Chan_id = ((*NextPtr - 1 + i) % NumChans) + 1;
+			if (!(SerMask & (1U << (Chan_id - 1))))
+				continue;
+
+			Chan = XMCDMA_DIR_CHAN(InstancePtr, Direction, Chan_id);
+			LastId = Chan_id;
+
+			if (Pass == 0) {
+				IrqStatus = XMcdma_ChanGetIrq(Chan);
+				if (IrqStatus & (XMCDMA_IRQ_IOC_MASK |
+						 XMCDMA_IRQ_DELAY_MASK)) {
+					XMcdma_ChanAckIrq(Chan, IrqStatus &
+						(XMCDMA_IRQ_IOC_MASK |
+						 XMCDMA_IRQ_DELAY_MASK));
+				}
+			}
+
+			Quota = ((Chan->ReapWeight != 0) ?
+				 Chan->ReapWeight : 1) * XMCDMA_REAP_QUANTUM;
+			Limit = Quota;
+			if (Limit > Budget - Done)
+				Limit = Budget - Done;
+
+			BdCount = XMcdma_BdChainFromHW(Chan, Limit, &BdSetPtr);
+			if (BdCount > 0) {
+				Handler(CallBackRef, Chan, BdSetPtr, BdCount);
+				XMcdma_BdChainFree(Chan, BdCount, BdSetPtr);
+				Done += (u32)BdCount;
+			} else {
+				BdCount = 0;
+			}
+
+			if (Pass == 0)
+				XMcdma_AdaptCoalesce(Chan, (u32)BdCount, Quota,
+						     Limit);
+
+			/* Only a channel that filled its quota may have more */
+			if ((u32)BdCount < Quota)
+				SerMask &= ~(1U << (Chan_id - 1));
+		}
+	}
+
+	if (LastId != 0)
+		*NextPtr = (LastId % NumChans) + 1;
+
+	return (int)Done;
+}
+
+/*****************************************************************************/
+/**
+* Adapt the Irq threshold of a channel to the number of BDs found by the
+* completion reaper.
+*
+* @param	Chan is the MCDMA Channel to be worked on.
+* @param	BdCount is the number of BDs reaped from the channel.
+* @param	Quota is the weight quota of the channel.
+* @param	Limit is the number of BDs the channel was allowed to reap,
+*		the quota clipped to what was left of the budget.
+*
+* @return	None
+*
+*****************************************************************************/
+static void XMcdma_AdaptCoalesce(XMcdma_ChanCtrl *Chan, u32 BdCount,
+				 u32 Quota, u32 Limit)
+{
+	u32 Coalesce;
+	u32 Cr;
+
+	/* The budget ran out before the channel did */
+	if (Limit < Quota && BdCount >= Limit)
+		return;
+
+	if (Chan->IrqCoalesce == 0) {
+		Cr = XMcdma_ReadReg(Chan->ChanBase, XMCDMA_CR_OFFSET +
+				    (Chan->Chan_id - 1) * XMCDMA_NXTCHAN_OFFSET);
+		Chan->IrqCoalesce = (Cr & XMCDMA_COALESCE_MASK) >>
+				    XMCDMA_COALESCE_SHIFT;
+		Chan->IrqDelay = (Cr & XMCDMA_DELAY_MASK) >>
+				 XMCDMA_DELAY_SHIFT;
+		if (Chan->IrqCoalesce == 0)
+			Chan->IrqCoalesce = 1;
+		if (Chan->IrqDelay == 0)
+			Chan->IrqDelay = XMCDMA_REAP_DELAY;
+	}
+
+	Coalesce = Chan->IrqCoalesce;
+	if (BdCount != 0 && BdCount >= Quota) {
+		Coalesce <<= 1;
+		/* One interrupt must not signal more than one visit reaps */
+		if (Coalesce > Quota)
+			Coalesce = Quota;
+	} else if (BdCount < Coalesce && Coalesce > 1) {
+		Coalesce >>= 1;
+	}
+
+	if (Coalesce != Chan->IrqCoalesce) {
+		Chan->IrqCoalesce = Coalesce;
+		(void)XMcdma_SetChanCoalesceDelay(Chan, Coalesce,
+						  Chan->IrqDelay);
+	}
+}
+
 /*****************************************************************************/
 /**
 * Set the Buffer descriptor buffer address field.
@@ -0,0 +1,790 @@
+/******************************************************************************
+* Copyright (C) 2020 Xilinx, Inc.  All rights reserved.
+* SPDX-License-Identifier: MIT
+******************************************************************************/
+
+/*****************************************************************************/
+/**
+*
+* @file test_xmcdma_reap.c
+*
+* Host test of the batched submit and of the completion reaper,
+* XMcDma_BatchSubmit() and XMcdma_ReapCompletions(). The driver runs against
+* a simulator of the MCDMA registers: common control and status, channel
+* enable, interrupt serviced register and, for every channel, control,
+* status, current and tail descriptor registers. The engine walks the BD
+* chain of each enabled channel from the current to the tail descriptor and
+* writes back the status words. It raises the IOC interrupt of a channel
+* when the number of packets completed since the last interrupt reaches the
+* threshold in the channel control register, and the delay interrupt when
+* no packet completed for the programmed delay, as the hardware does.
+*
+* The test checks that a batch starts all its channels with one write of the
+* channel enable register, that the reaper honours the channel weights, the
+* budget and the round robin order, and how it adapts the Irq threshold:
+* doubled only when a channel fills its whole weight quota, unchanged when
+* the visit was cut short by the budget, never above the quota. A traffic run
+* with one busy and several quiet channels, serviced at a fixed interval,
+* checks that the threshold of the busy channel settles at its quota while
+* the quiet ones stay at or near 1 and are served by the delay interrupt,
+* and that no packet is dropped, reordered or left waiting for long.
+*
+* Build and run on the host:
+*   cc -Wall -O2 -I. -I../src -I../../../../lib/bsp/standalone/src/common \
+*      -I../../../../lib/bsp/standalone/src/arm/cortexa9 \
+*      test_xmcdma_reap.c -o test_xmcdma_reap
+*   ./test_xmcdma_reap
+*
+******************************************************************************/
+
+/***************************** Include Files *********************************/
+
+#include <stdio.h>
+#include <string.h>
+
+#include "xil_types.h"
+
+/* Register accesses go to the simulator below */
+#define XIL_IO_H
+static u32 Xil_In32(UINTPTR Addr);
+static void Xil_Out32(UINTPTR Addr, u32 Value);
+#define DATA_SYNC
+#define dmb()
+
+#define XIL_PRINTF_H
+void xil_printf(const char8 *Format, ...);
+
+#include "xmcdma.c"
+#include "xmcdma_bd.c"
+
+/************************** Simulator ****************************************/
+
+#define SIM_BASE	0x44A00000U
+#define SIM_CHANS	4
+#define SIM_RING	64
+#define SIM_BUF_BASE	0x30000000U
+#define SIM_BUF_LEN	0x800U
+#define SIM_TX		0
+#define SIM_RX		1
+
+/* BD rings of both directions, the driver writes the low 32 bits of their
+ * addresses to the registers and the next descriptor fields
+ */
+static XMcdma_Bd BdMem[2][SIM_CHANS + 1][SIM_RING]
+			__attribute__((aligned(XMCDMA_BD_MINIMUM_ALIGNMENT)));
+
+typedef struct {
+	u32 Cr;
+	u32 Sr;
+	u32 Cdesc;
+	u32 Tdesc;
+	XMcdma_Bd *Next;	/* Next BD the engine fills */
+	int Pending;		/* BDs up to the tail are left to process */
+	double Rate;		/* Packets arriving per tick */
+	double Credit;
+	u32 Unsignaled;		/* Packets since the last interrupt */
+	u32 Idle;		/* Ticks since the last packet */
+	u32 Seq;		/* Sequence number of the next packet */
+	u32 Completed;
+	u32 Drops;		/* Packets that found no BD */
+	u32 Irqs;		/* Interrupts raised */
+} SimChan;
+
+typedef struct {
+	u32 Ccr;
+	u32 Csr;
+	u32 Chen;
+	u32 ChenWrites;
+	u32 SerReads;
+	SimChan Chan[SIM_CHANS + 1];
+} SimDir;
+
+static SimDir Sim[2];
+static u32 SimTick;
+static u32 SimErrors;	/* Accesses the engine should never have seen */
+
+/* Rebuild the host address of a BD from the 32 bits in a register */
+static XMcdma_Bd *SimBdPtr(u32 Low)
+{
+	UINTPTR Base = (UINTPTR)BdMem;
+
+	return (XMcdma_Bd *)(Base - LOWER_32_BITS(Base) + Low);
+}
+
+static void SimReset(void)
+{
+	memset(Sim, 0, sizeof(Sim));
+	Sim[SIM_TX].Csr = XMCDMA_CSR_HALTED_MASK;
+	Sim[SIM_RX].Csr = XMCDMA_CSR_HALTED_MASK;
+}
+
+static u32 SimSer(SimDir *Dir)
+{
+	u32 Mask = 0U;
+	u32 Id;
+
+	for (Id = 1U; Id <= SIM_CHANS; Id++) {
+		if (Dir->Chan[Id].Sr & XMCDMA_IRQ_ALL_MASK)
+			Mask |= 1U << (Id - 1U);
+	}
+
+	return Mask;
+}
+
+static void SimRaise(SimChan *C, u32 Mask)
+{
+	if (!(C->Sr & (XMCDMA_IRQ_IOC_MASK | XMCDMA_IRQ_DELAY_MASK)))
+		C->Irqs++;
+	C->Sr |= Mask;
+	C->Unsignaled = 0U;
+	C->Idle = 0U;
+}
+
+/* Complete the next BD of channel Id, returns 0 if there is none */
+static int SimComplete(int Dir, u32 Id)
+{
+	SimDir *D = &Sim[Dir];
+	SimChan *C = &D->Chan[Id];
+	XMcdma_Bd *Bd = C->Next;
+	u32 Ctrl;
+
+	if (!(D->Ccr & XMCDMA_CCR_RUNSTOP_MASK) ||
+	    !(C->Cr & XMCDMA_CCR_RUNSTOP_MASK) ||
+	    !(D->Chen & (1U << (Id - 1U))) || !C->Pending)
+		return 0;
+
+	if (Bd < &BdMem[Dir][Id][0] || Bd > &BdMem[Dir][Id][SIM_RING - 1]) {
+		SimErrors++;
+		C->Pending = 0;
+		return 0;
+	}
+
+	Ctrl = XMcdma_BdRead(Bd, XMCDMA_BD_CTRL_OFFSET);
+	XMcdma_BdWrite(Bd, XMCDMA_BD_USR0_OFFSET, (Id << 24) | C->Seq);
+	XMcdma_BdWrite(Bd, XMCDMA_BD_USR1_OFFSET, SimTick);
+	if (Dir == SIM_RX) {
+		XMcdma_BdWrite(Bd, XMCDMA_BD_STS_OFFSET,
+			       XMCDMA_BD_STS_COMPLETE_MASK |
+			       XMCDMA_BD_STS_RXSOF_MASK |
+			       XMCDMA_BD_STS_RXEOF_MASK |
+			       (Ctrl & XMCDMA_MAX_TRANSFER_LEN));
+	} else {
+		XMcdma_BdWrite(Bd, XMCDMA_BD_SIDEBAND_STS_OFFSET,
+			       XMCDMA_BD_STS_COMPLETE_MASK |
+			       (Ctrl & XMCDMA_MAX_TRANSFER_LEN));
+	}
+
+	C->Seq++;
+	C->Completed++;
+	C->Unsignaled++;
+	if (LOWER_32_BITS((UINTPTR)Bd) == C->Tdesc)
+		C->Pending = 0;
+	C->Next = SimBdPtr(XMcdma_BdRead(Bd, XMCDMA_BD_NDESC_OFFSET));
+
+	return 1;
+}
+
+/* Raise the interrupts of a channel from its packet counters */
+static void SimIrq(SimChan *C, int Active)
+{
+	u32 Threshold = (C->Cr & XMCDMA_COALESCE_MASK) >> XMCDMA_COALESCE_SHIFT;
+	u32 Delay = (C->Cr & XMCDMA_DELAY_MASK) >> XMCDMA_DELAY_SHIFT;
+
+	if (Threshold == 0U)
+		Threshold = 1U;
+
+	if (C->Unsignaled >= Threshold) {
+		SimRaise(C, XMCDMA_IRQ_IOC_MASK);
+	} else if (C->Unsignaled != 0U && Delay != 0U) {
+		C->Idle = Active ? 0U : C->Idle + 1U;
+		if (C->Idle >= Delay)
+			SimRaise(C, XMCDMA_IRQ_DELAY_MASK);
+	}
+}
+
+/* Advance the RX side by one tick of arriving packets */
+static void SimStep(void)
+{
+	SimChan *C;
+	int Active;
+	u32 Id;
+
+	SimTick++;
+	for (Id = 1U; Id <= SIM_CHANS; Id++) {
+		C = &Sim[SIM_RX].Chan[Id];
+		Active = 0;
+		C->Credit += C->Rate;
+		while (C->Credit >= 1.0) {
+			C->Credit -= 1.0;
+			if (SimComplete(SIM_RX, Id))
+				Active = 1;
+			else
+				C->Drops++;
+		}
+		SimIrq(C, Active);
+	}
+}
+
+/* Complete Count BDs of a channel at once, as after a long interrupt
+ * latency
+ */
+static u32 SimBurst(int Dir, u32 Id, u32 Count)
+{
+	u32 Done = 0U;
+
+	while (Done < Count && SimComplete(Dir, Id))
+		Done++;
+	SimIrq(&Sim[Dir].Chan[Id], 1);
+
+	return Done;
+}
+
+/************************** Stubs ********************************************/
+
+static u32 Xil_In32(UINTPTR Addr)
+{
+	u32 Off = (u32)(Addr - SIM_BASE);
+	int Dir = SIM_TX;
+	SimDir *D;
+	SimChan *C;
+	u32 Id;
+
+	if (Off >= XMCDMA_RX_OFFSET) {
+		Dir = SIM_RX;
+		Off -= XMCDMA_RX_OFFSET;
+	}
+	D = &Sim[Dir];
+
+	if (Off >= XMCDMA_CR_OFFSET &&
+	    Off < XMCDMA_CR_OFFSET + SIM_CHANS * XMCDMA_NXTCHAN_OFFSET) {
+		Id = (Off - XMCDMA_CR_OFFSET) / XMCDMA_NXTCHAN_OFFSET + 1U;
+		C = &D->Chan[Id];
+		switch (XMCDMA_CR_OFFSET +
+			(Off - XMCDMA_CR_OFFSET) % XMCDMA_NXTCHAN_OFFSET) {
+		case XMCDMA_CR_OFFSET:
+			return C->Cr;
+		case XMCDMA_SR_OFFSET:
+			return C->Sr;
+		case XMCDMA_CDESC_OFFSET:
+			return C->Cdesc;
+		case XMCDMA_TDESC_OFFSET:
+			return C->Tdesc;
+		default:
+			return 0U;
+		}
+	}
+
+	switch (Off) {
+	case XMCDMA_CCR_OFFSET:
+		return D->Ccr;
+	case XMCDMA_CSR_OFFSET:
+		return D->Csr;
+	case XMCDMA_CHEN_OFFSET:
+		return D->Chen;
+	case XMCDMA_TXINT_SER_OFFSET:
+		if (Dir != SIM_TX)
+			return 0U;
+		D->SerReads++;
+		return SimSer(D);
+	case XMCDMA_RXINT_SER_OFFSET:
+		if (Dir != SIM_RX)
+			return 0U;
+		D->SerReads++;
+		return SimSer(D);
+	default:
+		return 0U;
+	}
+}
+
+static void Xil_Out32(UINTPTR Addr, u32 Value)
+{
+	u32 Off = (u32)(Addr - SIM_BASE);
+	int Dir = SIM_TX;
+	SimDir *D;
+	SimChan *C;
+	u32 Id;
+
+	if (Off >= XMCDMA_RX_OFFSET) {
+		Dir = SIM_RX;
+		Off -= XMCDMA_RX_OFFSET;
+	}
+	D = &Sim[Dir];
+
+	if (Off >= XMCDMA_CR_OFFSET &&
+	    Off < XMCDMA_CR_OFFSET + SIM_CHANS * XMCDMA_NXTCHAN_OFFSET) {
+		Id = (Off - XMCDMA_CR_OFFSET) / XMCDMA_NXTCHAN_OFFSET + 1U;
+		C = &D->Chan[Id];
+		switch (XMCDMA_CR_OFFSET +
+			(Off - XMCDMA_CR_OFFSET) % XMCDMA_NXTCHAN_OFFSET) {
+		case XMCDMA_CR_OFFSET:
+			C->Cr = Value;
+			break;
+		case XMCDMA_SR_OFFSET:
+			C->Sr &= ~(Value & XMCDMA_IRQ_ALL_MASK);
+			break;
+		case XMCDMA_CDESC_OFFSET:
+			C->Cdesc = Value;
+			C->Next = SimBdPtr(Value);
+			break;
+		case XMCDMA_TDESC_OFFSET:
+			C->Tdesc = Value;
+			C->Pending = 1;
+			break;
+		default:
+			break;
+		}
+		return;
+	}
+
+	switch (Off) {
+	case XMCDMA_CCR_OFFSET:
+		if (Value & XMCDMA_CCR_RESET_MASK) {
+			/* Resetting one side resets the whole engine */
+			SimReset();
+			break;
+		}
+		D->Ccr = Value;
+		if (Value & XMCDMA_CCR_RUNSTOP_MASK)
+			D->Csr &= ~XMCDMA_CSR_HALTED_MASK;
+		break;
+	case XMCDMA_CHEN_OFFSET:
+		D->Chen = Value;
+		D->ChenWrites++;
+		break;
+	default:
+		break;
+	}
+}
+
+/* The BD rings are coherent with the engine in this model */
+void Xil_DCacheFlushRange(INTPTR Addr, u32 Len)
+{
+	(void)Addr;
+	(void)Len;
+}
+
+void Xil_DCacheInvalidateRange(INTPTR Addr, u32 Len)
+{
+	(void)Addr;
+	(void)Len;
+}
+
+void xil_printf(const char8 *Format, ...)
+{
+	(void)Format;
+}
+
+u32 Xil_AssertStatus;
+
+void Xil_Assert(const char8 *File, s32 Line)
+{
+	printf("assert %s:%d\n", File, (int)Line);
+}
+
+/************************** Test Helpers *************************************/
+
+static u32 Failures;
+
+#define CHECK(Cond, Msg)						\
+	do {								\
+		if (!(Cond)) {						\
+			printf("FAIL %s:%d: %s\n", __FILE__, __LINE__,	\
+								(Msg));	\
+			Failures++;					\
+		}							\
+	} while (0)
+
+static XMcdma Mcdma;
+
+typedef struct {
+	u32 Reaped[SIM_CHANS + 1];	/* BDs passed to the handler */
+	u32 Expect[SIM_CHANS + 1];	/* Next packet sequence number */
+	u32 MaxLatency[SIM_CHANS + 1];	/* Ticks from completion to reap */
+	u32 Errors;
+	XMcdma_BatchDesc Refill[SIM_CHANS * SIM_RING];
+	u32 RefillCnt;
+} ReapLog;
+
+static ReapLog Log;
+
+static XMcdma_ChanCtrl *RxChan(u32 Id)
+{
+	return XMcdma_GetMcdmaRxChan(&Mcdma, Id);
+}
+
+/* Irq threshold the hardware uses for an RX channel */
+static u32 RxThreshold(u32 Id)
+{
+	return (Sim[SIM_RX].Chan[Id].Cr & XMCDMA_COALESCE_MASK) >>
+		XMCDMA_COALESCE_SHIFT;
+}
+
+static void ReapHandler(void *CallBackRef, XMcdma_ChanCtrl *Chan,
+			XMcdma_Bd *BdSetPtr, int BdCount)
+{
+	XMcdma_Bd *Bd = BdSetPtr;
+	u32 Id = Chan->Chan_id;
+	u32 Usr0;
+	u32 Age;
+	int i;
+
+	(void)CallBackRef;
+
+	for (i = 0; i < BdCount; i++) {
+		Usr0 = XMcdma_BdRead(Bd, XMCDMA_BD_USR0_OFFSET);
+		if (Usr0 != ((Id << 24) | Log.Expect[Id]))
+			Log.Errors++;
+		Log.Expect[Id]++;
+
+		Age = SimTick - XMcdma_BdRead(Bd, XMCDMA_BD_USR1_OFFSET);
+		if (Age > Log.MaxLatency[Id])
+			Log.MaxLatency[Id] = Age;
+
+		/* Give a buffer back once the BDs are freed */
+		Log.Refill[Log.RefillCnt].Chan_id = Id;
+		Log.Refill[Log.RefillCnt].BufAddr = SIM_BUF_BASE +
+			(Id * SIM_RING + Log.Expect[Id] % SIM_RING) *
+			SIM_BUF_LEN;
+		Log.Refill[Log.RefillCnt].Len = SIM_BUF_LEN;
+		Log.RefillCnt++;
+
+		Bd = (XMcdma_Bd *)XMcdma_BdChainNextBd(Chan, Bd);
+	}
+
+	Log.Reaped[Id] += (u32)BdCount;
+}
+
+/* Reap one direction and resubmit the buffers it returned */
+static int Reap(u32 Budget)
+{
+	int Done;
+	u32 Status;
+
+	Log.RefillCnt = 0U;
+	Done = XMcdma_ReapCompletions(&Mcdma, XMCDMA_DEV_TO_MEM, Budget,
+				      ReapHandler, NULL);
+	CHECK(Done >= 0 && (u32)Done <= Budget, "budget exceeded");
+
+	if (Log.RefillCnt != 0U) {
+		Status = XMcDma_BatchSubmit(&Mcdma, XMCDMA_DEV_TO_MEM,
+					    Log.Refill, Log.RefillCnt);
+		CHECK(Status == XST_SUCCESS, "refill");
+	}
+
+	return Done;
+}
+
+/* Bring up the engine with full RX rings and the given reaper weights */
+static void Setup(const u8 *Weights)
+{
+	XMcdma_Config Config;
+	XMcdma_ChanCtrl *Chan;
+	u32 Status;
+	u32 Id;
+	u32 i;
+
+	memset(&Config, 0, sizeof(Config));
+	Config.BaseAddress = SIM_BASE;
+	Config.AddrWidth = 32;
+	Config.HasMM2S = 1;
+	Config.HasS2MM = 1;
+	Config.TxNumChannels = SIM_CHANS;
+	Config.RxNumChannels = SIM_CHANS;
+	Config.MM2SDataWidth = 32;
+	Config.S2MMDataWidth = 32;
+	Config.MaxTransferlen = 23;
+
+	SimReset();
+	SimTick = 0U;
+	SimErrors = 0U;
+	memset(&Log, 0, sizeof(Log));
+	memset(BdMem, 0, sizeof(BdMem));
+
+	Status = XMcDma_CfgInitialize(&Mcdma, &Config);
+	CHECK(Status == XST_SUCCESS, "initialize");
+
+	for (Id = 1U; Id <= SIM_CHANS; Id++) {
+		Chan = XMcdma_GetMcdmaTxChan(&Mcdma, Id);
+		Status = XMcDma_ChanBdCreate(Chan, (UINTPTR)BdMem[SIM_TX][Id],
+					     SIM_RING);
+		CHECK(Status == XST_SUCCESS, "tx bd create");
+
+		Chan = RxChan(Id);
+		Status = XMcDma_ChanBdCreate(Chan, (UINTPTR)BdMem[SIM_RX][Id],
+					     SIM_RING);
+		CHECK(Status == XST_SUCCESS, "rx bd create");
+		Status = XMcdma_SetChanReapWeight(Chan, Weights[Id - 1U]);
+		CHECK(Status == XST_SUCCESS, "weight");
+		Status = XMcdma_SetChanCoalesceDelay(Chan, 1U,
+						     XMCDMA_REAP_DELAY);
+		CHECK(Status == XST_SUCCESS, "coalesce");
+
+		for (i = 0U; i < SIM_RING; i++) {
+			Log.Refill[Log.RefillCnt].Chan_id = Id;
+			Log.Refill[Log.RefillCnt].BufAddr = SIM_BUF_BASE +
+				(Id * SIM_RING + i) * SIM_BUF_LEN;
+			Log.Refill[Log.RefillCnt].Len = SIM_BUF_LEN;
+			Log.RefillCnt++;
+		}
+	}
+
+	Sim[SIM_RX].ChenWrites = 0U;
+	Status = XMcDma_BatchSubmit(&Mcdma, XMCDMA_DEV_TO_MEM, Log.Refill,
+				    Log.RefillCnt);
+	CHECK(Status == XST_SUCCESS, "batch submit");
+	Log.RefillCnt = 0U;
+}
+
+/************************** Tests ********************************************/
+
+static void TestBatchSubmit(void)
+{
+	static const u8 Weights[SIM_CHANS] = { 1, 1, 1, 1 };
+	XMcdma_BatchDesc Desc[3];
+	XMcdma_ChanCtrl *Chan;
+	u32 Status;
+	u32 Id;
+
+	Setup(Weights);
+
+	/* The whole batch is started with one channel enable write */
+	CHECK(Sim[SIM_RX].ChenWrites == 1U, "one CHEN write per batch");
+	CHECK(Sim[SIM_RX].Chen == (1U << SIM_CHANS) - 1U, "channels enabled");
+	CHECK(Sim[SIM_TX].Chen == 0U, "tx untouched");
+	for (Id = 1U; Id <= SIM_CHANS; Id++) {
+		Chan = RxChan(Id);
+		CHECK(Sim[SIM_RX].Chan[Id].Cdesc ==
+		      LOWER_32_BITS((UINTPTR)BdMem[SIM_RX][Id]), "cdesc");
+		CHECK(Sim[SIM_RX].Chan[Id].Tdesc ==
+		      LOWER_32_BITS((UINTPTR)BdMem[SIM_RX][Id][SIM_RING - 1]),
+		      "tdesc");
+		CHECK(Sim[SIM_RX].Chan[Id].Cr & XMCDMA_CCR_RUNSTOP_MASK,
+		      "channel running");
+		CHECK(Chan->BdSubmitCnt == SIM_RING && Chan->BdCnt == 0U,
+		      "bd counts");
+	}
+
+	/* Bad channel numbers are rejected before anything is queued */
+	Desc[0].Chan_id = 1U;
+	Desc[0].BufAddr = SIM_BUF_BASE;
+	Desc[0].Len = SIM_BUF_LEN;
+	Desc[1] = Desc[0];
+	Desc[1].Chan_id = 0U;
+	Status = XMcDma_BatchSubmit(&Mcdma, XMCDMA_DEV_TO_MEM, &Desc[1], 1U);
+	CHECK(Status == XST_INVALID_PARAM, "channel 0");
+	Desc[1].Chan_id = SIM_CHANS + 1U;
+	Status = XMcDma_BatchSubmit(&Mcdma, XMCDMA_DEV_TO_MEM, &Desc[1], 1U);
+	CHECK(Status == XST_INVALID_PARAM, "channel out of range");
+	CHECK(Sim[SIM_RX].ChenWrites == 1U, "no CHEN write on error");
+
+	/* TX: a batch over two channels, one of them twice */
+	Desc[1].Chan_id = 3U;
+	Desc[2] = Desc[0];
+	Desc[2].BufAddr += SIM_BUF_LEN;
+	Status = XMcDma_BatchSubmit(&Mcdma, XMCDMA_MEM_TO_DEV, Desc, 3U);
+	CHECK(Status == XST_SUCCESS, "tx batch");
+	CHECK(Sim[SIM_TX].ChenWrites == 1U && Sim[SIM_TX].Chen == 0x5U,
+	      "tx channels enabled");
+	CHECK(XMcdma_GetMcdmaTxChan(&Mcdma, 1U)->BdSubmitCnt == 2U,
+	      "tx channel 1 bds");
+
+	CHECK(SimErrors == 0U, "engine errors");
+}
+
+static void TestWeights(void)
+{
+	static const u8 Weights[SIM_CHANS] = { 1, 2, 4, 8 };
+	u32 Id;
+	int Done;
+
+	Setup(Weights);
+	for (Id = 1U; Id <= SIM_CHANS; Id++)
+		CHECK(SimBurst(SIM_RX, Id, 40U) == 40U, "burst");
+
+	/* A budget of one pass takes each channel's quota */
+	Sim[SIM_RX].SerReads = 0U;
+	Done = Reap(60U);
+	CHECK(Done == 4 + 8 + 16 + 32, "weighted pass");
+	CHECK(Log.Reaped[1] == 4U && Log.Reaped[2] == 8U &&
+	      Log.Reaped[3] == 16U && Log.Reaped[4] == 32U, "weights");
+	CHECK(Sim[SIM_RX].SerReads == 1U, "serviced register read once");
+	for (Id = 1U; Id <= SIM_CHANS; Id++) {
+		CHECK(!(Sim[SIM_RX].Chan[Id].Sr & XMCDMA_IRQ_IOC_MASK),
+		      "interrupt acknowledged");
+		/* Every channel filled its quota */
+		CHECK(RxThreshold(Id) == 2U, "threshold doubled");
+	}
+
+	/* A small budget ends inside channel 2, the next call goes on
+	 * with channel 3. Channel 2 ran out of budget, not of BDs, so its
+	 * threshold stays.
+	 */
+	for (Id = 1U; Id <= SIM_CHANS; Id++)
+		SimBurst(SIM_RX, Id, 2U);
+	memset(Log.Reaped, 0, sizeof(Log.Reaped));
+	Done = Reap(10U);
+	CHECK(Done == 10, "budget pass");
+	CHECK(Log.Reaped[1] == 4U && Log.Reaped[2] == 6U &&
+	      Log.Reaped[3] == 0U && Log.Reaped[4] == 0U, "budget split");
+	CHECK(RxThreshold(1U) == 4U, "full quota doubles");
+	CHECK(RxThreshold(2U) == 2U, "budget cut leaves threshold");
+	CHECK(Mcdma.RxReapNext == 3U, "round robin position");
+	CHECK(Sim[SIM_RX].Chan[3].Sr & XMCDMA_IRQ_IOC_MASK,
+	      "unvisited interrupt pending");
+
+	memset(Log.Reaped, 0, sizeof(Log.Reaped));
+	Done = Reap(20U);
+	CHECK(Log.Reaped[3] == 16U && Log.Reaped[4] == 4U &&
+	      Log.Reaped[1] == 0U, "round robin continues");
+	CHECK(RxThreshold(3U) == 4U && RxThreshold(4U) == 2U,
+	      "thresholds after second pass");
+
+	/* A large budget goes round again until every channel is dry */
+	memset(Log.Reaped, 0, sizeof(Log.Reaped));
+	Done = Reap(1000U);
+	CHECK(Done == 34 + 28 + 10 + 6, "drained");
+	CHECK(Log.Reaped[1] == 34U && Log.Reaped[4] == 6U, "drain split");
+	for (Id = 1U; Id <= SIM_CHANS; Id++)
+		CHECK(Log.Expect[Id] == Sim[SIM_RX].Chan[Id].Completed,
+		      "all completions reaped");
+	/* Only the first visit adapts, and never beyond the quota */
+	CHECK(RxThreshold(1U) == 4U && RxThreshold(2U) == 4U &&
+	      RxThreshold(3U) == 4U && RxThreshold(4U) == 2U,
+	      "thresholds after drain");
+	CHECK(Reap(1000U) == 0, "nothing left");
+	CHECK(Log.Errors == 0U && SimErrors == 0U, "order");
+}
+
+static void TestBudgetCut(void)
+{
+	static const u8 Weights[SIM_CHANS] = { 4, 1, 1, 1 };
+	int Done;
+
+	Setup(Weights);
+
+	/* Quota 16, 10 BDs done, a budget of 4 cuts the visit short */
+	SimBurst(SIM_RX, 1U, 10U);
+	Done = Reap(4U);
+	CHECK(Done == 4 && RxThreshold(1U) == 1U, "cut visit unchanged");
+
+	/* The rest is less than the quota but not less than the threshold */
+	Done = Reap(100U);
+	CHECK(Done == 6 && RxThreshold(1U) == 1U, "partial quota unchanged");
+
+	/* A whole quota doubles, a budget of exactly the quota is no cut */
+	SimBurst(SIM_RX, 1U, 20U);
+	Done = Reap(16U);
+	CHECK(Done == 16 && RxThreshold(1U) == 2U, "full quota doubles");
+
+	/* Cut again with 4 left, then a single BD halves */
+	Done = Reap(3U);
+	CHECK(Done == 3 && RxThreshold(1U) == 2U, "second cut unchanged");
+	Done = Reap(100U);
+	CHECK(Done == 1 && RxThreshold(1U) == 1U, "light visit halves");
+
+	/* A cut that found fewer BDs than the threshold does not halve */
+	SimBurst(SIM_RX, 1U, 40U);
+	Reap(16U);
+	Reap(16U);
+	CHECK(RxThreshold(1U) == 4U, "two full quotas");
+	Done = Reap(2U);
+	CHECK(Done == 2 && RxThreshold(1U) == 4U, "short cut unchanged");
+	Done = Reap(100U);
+	CHECK(Done == 6 && RxThreshold(1U) == 4U, "rest unchanged");
+	CHECK(Log.Errors == 0U && SimErrors == 0U, "order");
+}
+
+static void TestTraffic(void)
+{
+	static const u8 Weights[SIM_CHANS] = { 2, 2, 1, 1 };
+	static const double Rates[SIM_CHANS] = { 0.9, 0.05, 0.01, 0.0 };
+	const u32 Ticks = 400000U;
+	const u32 Service = 16U;	/* Ticks between looks at the interrupt */
+	u32 Completed = 0U;
+	u32 Reaped = 0U;
+	u32 Polling = 0U;
+	u32 BusyMin = 0xFFU;
+	u32 QuietMax = 0U;
+	u32 Id;
+	u32 t;
+
+	Setup(Weights);
+	for (Id = 1U; Id <= SIM_CHANS; Id++)
+		Sim[SIM_RX].Chan[Id].Rate = Rates[Id - 1U];
+
+	for (t = 0U; t < Ticks; t++) {
+		SimStep();
+		if (t % Service != 0U)
+			continue;
+
+		/* Keep polling while the budget is used up, as after an
+		 * interrupt
+		 */
+		if (Polling || SimSer(&Sim[SIM_RX]) != 0U)
+			Polling = ((u32)Reap(64U) == 64U);
+
+		if (t >= Ticks / 2U) {
+			if (RxThreshold(1U) < BusyMin)
+				BusyMin = RxThreshold(1U);
+			for (Id = 2U; Id <= SIM_CHANS; Id++) {
+				if (RxThreshold(Id) > QuietMax)
+					QuietMax = RxThreshold(Id);
+			}
+		}
+	}
+
+	/* Drain what is left */
+	for (Id = 1U; Id <= SIM_CHANS; Id++)
+		Sim[SIM_RX].Chan[Id].Rate = 0.0;
+	for (t = 0U; t < 1000U; t++) {
+		SimStep();
+		Reap(64U);
+	}
+
+	for (Id = 1U; Id <= SIM_CHANS; Id++) {
+		Completed += Sim[SIM_RX].Chan[Id].Completed;
+		Reaped += Log.Reaped[Id];
+		CHECK(Sim[SIM_RX].Chan[Id].Drops == 0U, "packet dropped");
+	}
+
+	printf("Traffic: busy channel %u packets, %.3f interrupts/packet, "
+	       "threshold %u or more; quiet channels %.3f interrupts/packet, "
+	       "threshold up to %u, latency up to %u ticks\n",
+	       Sim[SIM_RX].Chan[1].Completed,
+	       (double)Sim[SIM_RX].Chan[1].Irqs / Sim[SIM_RX].Chan[1].Completed,
+	       BusyMin,
+	       (double)(Sim[SIM_RX].Chan[2].Irqs + Sim[SIM_RX].Chan[3].Irqs) /
+	       (Sim[SIM_RX].Chan[2].Completed + Sim[SIM_RX].Chan[3].Completed),
+	       QuietMax, Log.MaxLatency[2] > Log.MaxLatency[3] ?
+	       Log.MaxLatency[2] : Log.MaxLatency[3]);
+
+	CHECK(Completed == Reaped && Completed > 300000U, "all reaped");
+	CHECK(Log.Errors == 0U && SimErrors == 0U, "order");
+	/* The busy channel fills its quota of 8 on every visit */
+	CHECK(BusyMin == 8U, "busy channel threshold");
+	CHECK(Sim[SIM_RX].Chan[1].Irqs * 8U <= Sim[SIM_RX].Chan[1].Completed,
+	      "busy channel interrupts");
+	CHECK(QuietMax <= 2U, "quiet channels not coalesced");
+	CHECK(Log.MaxLatency[2] <= Service + XMCDMA_REAP_DELAY &&
+	      Log.MaxLatency[3] <= Service + XMCDMA_REAP_DELAY,
+	      "quiet latency");
+}
+
+/************************** Main *********************************************/
+
+int main(void)
+{
+	/* The driver keeps 32 bits of each BD address */
+	CHECK(UPPER_32_BITS((UINTPTR)BdMem) ==
+	      UPPER_32_BITS((UINTPTR)&BdMem[1][SIM_CHANS][SIM_RING - 1]),
+	      "BD memory crosses a 4 GB boundary");
+
+	TestBatchSubmit();
+	TestWeights();
+	TestBudgetCut();
+	TestTraffic();
+
+	printf("%s (%u failures)\n", Failures ? "FAILED" : "PASSED",
+							Failures);
+	return Failures ? 1 : 0;
+}
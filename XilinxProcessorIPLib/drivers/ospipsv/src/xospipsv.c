@@ -61,6 +61,9 @@
 static inline void XOspiPsv_AssertCS(const XOspiPsv *InstancePtr);
 static inline void XOspiPsv_DeAssertCS(const XOspiPsv *InstancePtr);
 static inline void StubStatusHandler(void *CallBackRef, u32 StatusEvent);
+static u32 XOspiPsv_StreamStart(XOspiPsv *InstancePtr, XOspiPsv_Msg *Msg,
+		u32 *InFlightPtr);
+static u32 XOspiPsv_StreamWait(XOspiPsv *InstancePtr);
 
 /************************** Variable Definitions *****************************/
 
@@ -945,4 +948,183 @@ static inline void StubStatusHandler(void *CallBackRef, u32 StatusEvent)
 	Xil_AssertVoidAlways();
 }
 
+/*****************************************************************************/
+/**
+* @brief
+* This function reads a range of flash in chunks into two ping-pong buffers
+* and hands each chunk to a consumer, such as a hash or a decompressor, while
+* the DMA reads the next chunk into the other buffer. Each chunk is read with
+* the command in the stream's MsgTemplate at the address of the chunk.
+*
+* @param	InstancePtr is a pointer to the XOspiPsv instance.
+* @param	StreamPtr is a pointer to the stream buffers and callback.
+* @param	Offset is the flash address to start reading from.
+* @param	ByteCount is the number of bytes to read.
+*
+* @return
+*		- XST_SUCCESS if all chunks were read and consumed.
+*		- XST_DEVICE_BUSY if a transfer is already in progress.
+*		- XST_FAILURE if a transfer failed.
+*		- The DataHandler return value if it stopped the stream.
+*
+* @note		Chunks are read with XOspiPsv_StartDmaTransfer() only in IDAC
+*		mode and when the chunk size is a multiple of 4; otherwise, as
+*		for the last chunk of an unaligned ByteCount, the chunk is read
+*		with XOspiPsv_PollTransfer() before the previous one is
+*		consumed.
+*
+******************************************************************************/
+u32 XOspiPsv_StreamRead(XOspiPsv *InstancePtr, XOspiPsv_Stream *StreamPtr,
+				u32 Offset, u32 ByteCount)
+{
+	XOspiPsv_Msg Msg[2];
+	u32 Pos = 0U;
+	u32 Len;
+	u32 CurLen;
+	u32 Idx = 0U;
+	u32 InFlight = (u32)FALSE;
+	u32 Status;
+	u32 DataStatus;
+
+	Xil_AssertNonvoid(InstancePtr != NULL);
+	Xil_AssertNonvoid(StreamPtr != NULL);
+	Xil_AssertNonvoid(StreamPtr->Buf[0] != NULL);
+	Xil_AssertNonvoid(StreamPtr->Buf[1] != NULL);
+	Xil_AssertNonvoid(StreamPtr->ChunkSize > 0U);
+	Xil_AssertNonvoid((StreamPtr->ChunkSize % 4U) == 0U);
+	Xil_AssertNonvoid(StreamPtr->MsgTemplate != NULL);
+	Xil_AssertNonvoid(StreamPtr->DataHandler != NULL);
+	Xil_AssertNonvoid(InstancePtr->IsReady == XIL_COMPONENT_IS_READY);
+
+	if (InstancePtr->IsBusy == (u32)TRUE) {
+		Status = (u32)XST_DEVICE_BUSY;
+		goto ERROR_PATH;
+	}
+	if (ByteCount == 0U) {
+		Status = (u32)XST_SUCCESS;
+		goto ERROR_PATH;
+	}
+
+	Msg[0] = *StreamPtr->MsgTemplate;
+	Msg[0].Flags = XOSPIPSV_MSG_FLAG_RX;
+	Msg[0].TxBfrPtr = NULL;
+	Msg[0].Addrvalid = 1U;
+	Msg[0].RxAddr64bit = 0U;
+	Msg[0].Xfer64bit = 0U;
+	Msg[1] = Msg[0];
+
+	Len = (ByteCount < StreamPtr->ChunkSize) ?
+			ByteCount : StreamPtr->ChunkSize;
+	Msg[0].Addr = Offset;
+	Msg[0].RxBfrPtr = StreamPtr->Buf[0];
+	Msg[0].ByteCount = Len;
+	Status = XOspiPsv_StreamStart(InstancePtr, &Msg[0], &InFlight);
+
+	while (Status == (u32)XST_SUCCESS) {
+		/* Wait for the chunk in flight */
+		if (InFlight == (u32)TRUE) {
+			InFlight = (u32)FALSE;
+			Status = XOspiPsv_StreamWait(InstancePtr);
+			if (Status != (u32)XST_SUCCESS) {
+				break;
+			}
+		}
+		CurLen = Len;
+		Pos += CurLen;
+
+		/* Start the next chunk before handing this one out */
+		if (Pos < ByteCount) {
+			Len = ((ByteCount - Pos) < StreamPtr->ChunkSize) ?
+					(ByteCount - Pos) : StreamPtr->ChunkSize;
+			Msg[Idx ^ 1U].Addr = Offset + Pos;
+			Msg[Idx ^ 1U].RxBfrPtr = StreamPtr->Buf[Idx ^ 1U];
+			Msg[Idx ^ 1U].ByteCount = Len;
+			Status = XOspiPsv_StreamStart(InstancePtr, &Msg[Idx ^ 1U],
+					&InFlight);
+		}
+
+		if (InstancePtr->Config.IsCacheCoherent == 0U) {
+			Xil_DCacheInvalidateRange((UINTPTR)StreamPtr->Buf[Idx],
+							CurLen);
+		}
+		DataStatus = StreamPtr->DataHandler(StreamPtr->CallBackRef,
+					StreamPtr->Buf[Idx], CurLen);
+		if ((DataStatus != (u32)XST_SUCCESS) &&
+				(Status == (u32)XST_SUCCESS)) {
+			Status = DataStatus;
+		}
+
+		if (Pos >= ByteCount) {
+			break;
+		}
+		Idx ^= 1U;
+	}
+
+	/* Do not leave a chunk running after an early stop */
+	if (InFlight == (u32)TRUE) {
+		(void)XOspiPsv_StreamWait(InstancePtr);
+	}
+
+ERROR_PATH:
+	return Status;
+}
+
+/*****************************************************************************/
+/**
+* @brief
+* This static function starts the read of one stream chunk.
+*
+* @param	InstancePtr is a pointer to the XOspiPsv instance.
+* @param	Msg is a pointer to the chunk message.
+* @param	InFlightPtr is set to TRUE if the chunk was started with DMA
+*		and must be completed with XOspiPsv_StreamWait(), or FALSE if
+*		it was read before returning.
+*
+* @return
+*		- XST_SUCCESS if the chunk was started or read.
+*		- The transfer function error otherwise.
+*
+******************************************************************************/
+static u32 XOspiPsv_StreamStart(XOspiPsv *InstancePtr, XOspiPsv_Msg *Msg,
+		u32 *InFlightPtr)
+{
+	u32 Status;
+
+	if ((InstancePtr->OpMode == XOSPIPSV_IDAC_MODE) &&
+			((Msg->ByteCount % 4U) == 0U)) {
+		Status = XOspiPsv_StartDmaTransfer(InstancePtr, Msg);
+		*InFlightPtr = (Status == (u32)XST_SUCCESS) ?
+				(u32)TRUE : (u32)FALSE;
+	} else {
+		Status = XOspiPsv_PollTransfer(InstancePtr, Msg);
+		*InFlightPtr = (u32)FALSE;
+	}
+
+	return Status;
+}
+
+/*****************************************************************************/
+/**
+* @brief
+* This static function waits for the stream chunk started with DMA.
+*
+* @param	InstancePtr is a pointer to the XOspiPsv instance.
+*
+* @return
+*		- XST_SUCCESS if the chunk completed.
+*		- XST_FAILURE if the controller did not go idle.
+*
+******************************************************************************/
+static u32 XOspiPsv_StreamWait(XOspiPsv *InstancePtr)
+{
+	u32 Status;
+
+	/* CheckDmaDone clears IsBusy once the DMA is done */
+	do {
+		Status = XOspiPsv_CheckDmaDone(InstancePtr);
+	} while (InstancePtr->IsBusy == (u32)TRUE);
+
+	return Status;
+}
+
 /** @} */
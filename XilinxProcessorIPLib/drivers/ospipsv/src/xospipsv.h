@@ -140,6 +140,31 @@ typedef struct {
 #endif
 } XOspiPsv;
 
+/**
+ * Callback type used by XOspiPsv_StreamRead() to hand one chunk of read data
+ * to the consumer while the next chunk is being read.
+ *
+ * @param	CallBackRef is the reference given in the stream.
+ * @param	DataPtr is the chunk data.
+ * @param	ByteCount is the size of the chunk.
+ *
+ * @return	XST_SUCCESS to continue, any other value stops the stream.
+ */
+typedef u32 (*XOspiPsv_StreamDataHandler) (void *CallBackRef,
+			const u8 *DataPtr, u32 ByteCount);
+
+/**
+ * This typedef contains the buffers, read command and callback of a
+ * streaming read.
+ */
+typedef struct {
+	u8 *Buf[2];		/**< Ping-pong receive buffers */
+	u32 ChunkSize;		/**< Size of each buffer, multiple of 4 */
+	const XOspiPsv_Msg *MsgTemplate; /**< Read command, Addr/Rx unused */
+	XOspiPsv_StreamDataHandler DataHandler; /**< Consumes chunk data */
+	void *CallBackRef;	/**< Passed to DataHandler */
+} XOspiPsv_Stream;
+
 /************************** Variable Definitions *****************************/
 extern XOspiPsv_Config XOspiPsv_ConfigTable[];
 
@@ -265,6 +290,8 @@ void XOspiPsv_Idle(const XOspiPsv *InstancePtr);
 u32 XOspiPsv_DeviceReset(u8 Type);
 u32 XOspiPsv_StartDmaTransfer(XOspiPsv *InstancePtr, XOspiPsv_Msg *Msg);
 u32 XOspiPsv_CheckDmaDone(XOspiPsv *InstancePtr);
+u32 XOspiPsv_StreamRead(XOspiPsv *InstancePtr, XOspiPsv_Stream *StreamPtr,
+				u32 Offset, u32 ByteCount);
 u32 XOspiPsv_SetDllDelay(XOspiPsv *InstancePtr);
 #ifdef __cplusplus
 }
@@ -0,0 +1,676 @@
+/******************************************************************************
+* Copyright (C) 2020 Xilinx, Inc.  All rights reserved.
+* SPDX-License-Identifier: MIT
+******************************************************************************/
+
+/*****************************************************************************/
+/**
+*
+* @file test_xospipsv_stream.c
+*
+* Host test and benchmark of XOspiPsv_StreamRead(). The driver runs against
+* a simulated OSPI controller with an octal SPI-NOR on chip select 0. The
+* controller model executes an indirect read when it is started: the flash
+* decodes the read instruction register and checks the opcode, address
+* length, dummy cycles and instruction, address and data widths, and the
+* destination DMA writes the data at the address and size it was programmed
+* with. Any violation, a start while a read is running or a read with chip
+* select high is counted as a protocol error.
+*
+* Time is simulated. Register accesses and usleep() cost their time, the
+* SPI bus runs at the reference clock divided by the baud rate divisor in
+* the configuration register, and the consumer of the data costs a time per
+* byte. The DMA writes a chunk when its last byte has been clocked in and the
+* buffer reads as poison until then, so a consumer handed a buffer that is
+* still being read sees wrong data; the model also counts a consumer call on
+* the buffer of the running DMA as an overlap.
+*
+* The tests read aligned and unaligned ranges, stop the stream from the
+* consumer and check the data, the chunk order, protocol errors and that the
+* controller is idle afterwards. The benchmark reads 4 MB with the 1-8-8
+* octal read at 50 MHz SDR, the non-PHY limit, with consumers of 100 MB/s
+* (a hash) and 40 MB/s (a decompressor), once chunk by chunk with
+* XOspiPsv_PollTransfer() followed by the consumer, as boot loaders do, and
+* once with XOspiPsv_StreamRead(), and reports the sustained MB/s of each.
+*
+* Build and run on the host:
+*   cc -Wall -O2 -Dversal -I. -I../src \
+*      -I../../../../lib/bsp/standalone/src/common \
+*      -I../../../../lib/bsp/standalone/src/arm/cortexa9 \
+*      test_xospipsv_stream.c -o test_xospipsv_stream
+*   ./test_xospipsv_stream
+*
+******************************************************************************/
+
+/***************************** Include Files *********************************/
+
+#include <stdio.h>
+#include <string.h>
+
+#include "xil_types.h"
+
+/* Register accesses go to the simulator below */
+#define XIL_IO_H
+static u32 Xil_In32(UINTPTR Addr);
+static void Xil_Out32(UINTPTR Addr, u32 Value);
+
+#define XIL_PRINTF_H
+void xil_printf(const char8 *Format, ...);
+
+#include "xospipsv.c"
+#include "xospipsv_control.c"
+#include "xospipsv_hw.c"
+#include "xospipsv_options.c"
+
+/************************** Simulator ****************************************/
+
+#define SIM_BASE	0xF1010000U
+#define SIM_REF_HZ	100000000U	/* OSPI reference clock */
+#define SIM_REG_PS	50000U		/* One APB register access */
+
+#define FLASH_SIZE	(16U * 1024U * 1024U)
+#define FLASH_POISON	0xEEU
+
+/* Chip select lines of chip select 0 */
+#define SIM_CS0		(0xEU << XOSPIPSV_CONFIG_REG_PERIPH_CS_LINES_FLD_SHIFT)
+
+/* Read commands of the flash, widths in lines */
+typedef struct {
+	u8 Opcode;
+	u8 AddrBytes;
+	u8 DummyCycles;
+	u8 InstrWidth;
+	u8 AddrWidth;
+	u8 DataWidth;
+} SimCmd;
+
+static const SimCmd SimCmds[] = {
+	{ 0x13U, 4U, 0U, 1U, 1U, 1U },		/* 4 byte read */
+	{ 0x0CU, 4U, 8U, 1U, 1U, 1U },		/* 4 byte fast read */
+	{ 0x7CU, 4U, 8U, 1U, 1U, 8U },		/* 4 byte octal output */
+	{ 0xCCU, 4U, 16U, 1U, 8U, 8U },		/* 4 byte octal IO */
+};
+
+typedef struct {
+	u32 Cfg;
+	u32 RdInstr;
+	u32 DevSize;
+	u32 Capture;
+	u32 IndAddr;
+	u32 IndBytes;
+	u32 IndCtrl;
+	u32 Irq;
+	u64 BusEnd;		/* The running read ends */
+	/* Destination DMA */
+	u32 DmaLsb;
+	u32 DmaMsb;
+	u32 DmaSize;
+	u32 DmaSrc;
+	u32 DmaIsts;
+	u8 *DmaPtr;
+	u32 DmaAddr;		/* Flash address, or ~0 after a protocol error */
+	u64 DmaAt;
+	UINTPTR DmaBusy;	/* Buffer of the running DMA */
+	u32 DmaBusyLen;
+	/* Statistics */
+	u32 Errors;		/* Protocol errors */
+	u32 Reads;		/* Indirect reads */
+	u32 DmaBytes;
+} SimOspi;
+
+static SimOspi Sim;
+static u64 SimNow;
+static u8 FlashMem[FLASH_SIZE];
+
+/* Buffers the DMA may write, the model maps 32-bit DMA addresses here */
+static u8 DmaMem[2U * 65536U] __attribute__((aligned(64)));
+
+/* The driver reads unaligned tails into its instance */
+static XOspiPsv Ospi;
+
+static void SimError(const char *Why)
+{
+	printf("protocol error: %s\n", Why);
+	Sim.Errors++;
+}
+
+static void SimReset(void)
+{
+	u32 i;
+
+	memset(&Sim, 0, sizeof(Sim));
+	SimNow = 0U;
+	for (i = 0U; i < FLASH_SIZE; i++)
+		FlashMem[i] = (u8)((i >> 16) ^ (i >> 8) ^ (i * 13U));
+}
+
+static u64 SimSpiPs(u32 Cycles)
+{
+	u32 Div = (Sim.Cfg & XOSPIPSV_CONFIG_REG_MSTR_BAUD_DIV_FLD_MASK) >>
+			XOSPIPSV_CONFIG_REG_MSTR_BAUD_DIV_FLD_SHIFT;
+	u64 Hz = (u64)SIM_REF_HZ / (2U * (Div + 1U));
+
+	return (u64)Cycles * 1000000000000ULL / Hz;
+}
+
+static u32 SimWidth(u32 Type)
+{
+	static const u32 Lines[] = { 1U, 2U, 4U, 8U };
+
+	return Lines[Type & 3U];
+}
+
+/* Land the DMA data once the read has clocked it in */
+static void SimAdvance(void)
+{
+	if (Sim.DmaBusy == 0U || SimNow < Sim.DmaAt)
+		return;
+
+	if (Sim.DmaAddr != ~0U)
+		memcpy(Sim.DmaPtr, &FlashMem[Sim.DmaAddr], Sim.DmaBusyLen);
+	Sim.DmaBytes += Sim.DmaBusyLen;
+	Sim.DmaIsts |= XOSPIPSV_OSPIDMA_DST_I_STS_DONE_MASK;
+	Sim.IndCtrl |=
+		XOSPIPSV_INDIRECT_READ_XFER_CTRL_REG_IND_OPS_DONE_STATUS_FLD_MASK;
+	Sim.Irq |= XOSPIPSV_IRQ_STATUS_REG_INDIRECT_OP_DONE_FLD_MASK;
+	Sim.DmaBusy = 0U;
+	Sim.DmaBusyLen = 0U;
+}
+
+/* Decode the read instruction and return the flash address, ~0 if bad */
+static u32 SimDecode(u32 *CyclesPtr)
+{
+	const SimCmd *Cmd = NULL;
+	u32 Opcode = Sim.RdInstr &
+		XOSPIPSV_DEV_INSTR_RD_CONFIG_REG_RD_OPCODE_NON_XIP_FLD_MASK;
+	u32 Dummy = (Sim.RdInstr &
+		XOSPIPSV_DEV_INSTR_RD_CONFIG_REG_DUMMY_RD_CLK_CYCLES_FLD_MASK) >>
+		XOSPIPSV_DEV_INSTR_RD_CONFIG_REG_DUMMY_RD_CLK_CYCLES_FLD_SHIFT;
+	u32 InstrW = SimWidth((Sim.RdInstr &
+		XOSPIPSV_DEV_INSTR_RD_CONFIG_REG_INSTR_TYPE_FLD_MASK) >>
+		XOSPIPSV_DEV_INSTR_RD_CONFIG_REG_INSTR_TYPE_FLD_SHIFT);
+	u32 AddrW = SimWidth((Sim.RdInstr &
+		XOSPIPSV_DEV_INSTR_RD_CONFIG_REG_ADDR_XFER_TYPE_STD_MODE_FLD_MASK) >>
+		XOSPIPSV_DEV_INSTR_RD_CONFIG_REG_ADDR_XFER_TYPE_STD_MODE_FLD_SHIFT);
+	u32 DataW = SimWidth((Sim.RdInstr &
+		XOSPIPSV_DEV_INSTR_RD_CONFIG_REG_DATA_XFER_TYPE_EXT_MODE_FLD_MASK) >>
+		XOSPIPSV_DEV_INSTR_RD_CONFIG_REG_DATA_XFER_TYPE_EXT_MODE_FLD_SHIFT);
+	u32 AddrBytes = (Sim.DevSize &
+		XOSPIPSV_DEV_SIZE_CONFIG_REG_NUM_ADDR_BYTES_FLD_MASK) + 1U;
+	u32 i;
+
+	for (i = 0U; i < sizeof(SimCmds) / sizeof(SimCmds[0]); i++) {
+		if (SimCmds[i].Opcode == Opcode)
+			Cmd = &SimCmds[i];
+	}
+	*CyclesPtr = Sim.IndBytes * 8U;
+	if (Cmd == NULL) {
+		SimError("unknown opcode");
+		return ~0U;
+	}
+	*CyclesPtr = 8U / InstrW + AddrBytes * 8U / AddrW + Dummy +
+			Sim.IndBytes * 8U / DataW;
+
+	if (InstrW != Cmd->InstrWidth || AddrW != Cmd->AddrWidth ||
+	    DataW != Cmd->DataWidth) {
+		SimError("wrong bus width");
+		return ~0U;
+	}
+	if (AddrBytes != Cmd->AddrBytes) {
+		SimError("wrong address length");
+		return ~0U;
+	}
+	if (Dummy != Cmd->DummyCycles) {
+		SimError("wrong dummy cycles");
+		return ~0U;
+	}
+	if ((Sim.RdInstr & XOSPIPSV_DEV_INSTR_RD_CONFIG_REG_DDR_EN_FLD_MASK) ||
+	    (Sim.Cfg & XOSPIPSV_CONFIG_REG_ENABLE_DTR_PROTOCOL_FLD_MASK) ||
+	    (Sim.Capture & XOSPIPSV_RD_DATA_CAPTURE_REG_DQS_ENABLE_FLD_MASK)) {
+		SimError("DDR read of an SDR command");
+		return ~0U;
+	}
+	if (Sim.IndAddr > FLASH_SIZE - Sim.IndBytes) {
+		SimError("read past the flash");
+		return ~0U;
+	}
+
+	return Sim.IndAddr;
+}
+
+/* Start the indirect read to the destination DMA */
+static void SimStart(void)
+{
+	u64 T = (Sim.BusEnd > SimNow) ? Sim.BusEnd : SimNow;
+	u32 Cycles;
+	u32 Addr;
+
+	if (Sim.DmaBusy != 0U ||
+	    (Sim.DmaIsts & XOSPIPSV_OSPIDMA_DST_I_STS_DONE_MASK) != 0U) {
+		SimError("read started while one is running");
+		return;
+	}
+	if (!(Sim.Cfg & XOSPIPSV_CONFIG_REG_ENB_SPI_FLD_MASK) ||
+	    (Sim.Cfg & XOSPIPSV_CONFIG_REG_PERIPH_CS_LINES_FLD_MASK) != SIM_CS0)
+		SimError("read with the controller off or CS high");
+	if (Sim.DmaSrc != XOSPIPSV_IND_TRIGGAHB_BASE ||
+	    Sim.DmaSize != Sim.IndBytes || Sim.IndBytes == 0U ||
+	    (Sim.IndBytes % 4U) != 0U)
+		SimError("DMA does not match the read");
+
+	Addr = SimDecode(&Cycles);
+	Sim.Reads++;
+
+	/* A 32-bit DMA address is in the simulated DMA memory */
+	Sim.DmaPtr = (u8 *)(((UINTPTR)Sim.DmaMsb << 32) |
+			(Sim.DmaLsb & XOSPIPSV_OSPIDMA_DST_ADDR_ADDR_MASK));
+	if (Sim.DmaMsb == 0U)
+		Sim.DmaPtr = (u8 *)((UINTPTR)Sim.DmaPtr |
+			((UINTPTR)DmaMem & ~(UINTPTR)0xFFFFFFFFU));
+	if ((Sim.DmaPtr < DmaMem ||
+	     Sim.DmaPtr + Sim.DmaSize > DmaMem + sizeof(DmaMem)) &&
+	    (Sim.DmaPtr != Ospi.UnalignReadBuffer || Sim.DmaSize != 4U)) {
+		SimError("DMA outside its memory");
+		Sim.DmaSize = 0U;
+	}
+
+	memset(Sim.DmaPtr, FLASH_POISON, Sim.DmaSize);
+	Sim.DmaAddr = Addr;
+	Sim.DmaBusy = (UINTPTR)Sim.DmaPtr;
+	Sim.DmaBusyLen = Sim.DmaSize;
+	Sim.BusEnd = T + SimSpiPs(Cycles);
+	Sim.DmaAt = Sim.BusEnd;
+}
+
+/************************** Stubs ********************************************/
+
+static u32 Xil_In32(UINTPTR Addr)
+{
+	SimNow += SIM_REG_PS;
+	SimAdvance();
+
+	switch (Addr - SIM_BASE) {
+	case XOSPIPSV_CONFIG_REG:
+		return Sim.Cfg | ((SimNow >= Sim.BusEnd) ?
+				XOSPIPSV_CONFIG_REG_IDLE_FLD_MASK : 0U);
+	case XOSPIPSV_DEV_INSTR_RD_CONFIG_REG:
+		return Sim.RdInstr;
+	case XOSPIPSV_DEV_SIZE_CONFIG_REG:
+		return Sim.DevSize;
+	case XOSPIPSV_RD_DATA_CAPTURE_REG:
+		return Sim.Capture;
+	case XOSPIPSV_INDIRECT_READ_XFER_CTRL_REG:
+		return Sim.IndCtrl;
+	case XOSPIPSV_IRQ_STATUS_REG:
+		return Sim.Irq;
+	case XOSPIPSV_OSPIDMA_DST_I_STS:
+		return Sim.DmaIsts;
+	default:
+		return 0U;
+	}
+}
+
+static void Xil_Out32(UINTPTR Addr, u32 Value)
+{
+	SimNow += SIM_REG_PS;
+	SimAdvance();
+
+	switch (Addr - SIM_BASE) {
+	case XOSPIPSV_CONFIG_REG:
+		Sim.Cfg = Value & ~XOSPIPSV_CONFIG_REG_IDLE_FLD_MASK;
+		break;
+	case XOSPIPSV_DEV_INSTR_RD_CONFIG_REG:
+		Sim.RdInstr = Value;
+		break;
+	case XOSPIPSV_DEV_SIZE_CONFIG_REG:
+		Sim.DevSize = Value;
+		break;
+	case XOSPIPSV_RD_DATA_CAPTURE_REG:
+		Sim.Capture = Value;
+		break;
+	case XOSPIPSV_INDIRECT_READ_XFER_START_REG:
+		Sim.IndAddr = Value;
+		break;
+	case XOSPIPSV_INDIRECT_READ_XFER_NUM_BYTES_REG:
+		Sim.IndBytes = Value;
+		break;
+	case XOSPIPSV_INDIRECT_READ_XFER_CTRL_REG:
+		Sim.IndCtrl &= ~(Value &
+		XOSPIPSV_INDIRECT_READ_XFER_CTRL_REG_IND_OPS_DONE_STATUS_FLD_MASK);
+		if (Value & XOSPIPSV_INDIRECT_READ_XFER_CTRL_REG_START_FLD_MASK)
+			SimStart();
+		break;
+	case XOSPIPSV_IRQ_STATUS_REG:
+		Sim.Irq &= ~Value;
+		break;
+	case XOSPIPSV_OSPIDMA_SRC_RD_ADDR:
+		Sim.DmaSrc = Value;
+		break;
+	case XOSPIPSV_OSPIDMA_DST_ADDR:
+		Sim.DmaLsb = Value;
+		break;
+	case XOSPIPSV_OSPIDMA_DST_ADDR_MSB:
+		Sim.DmaMsb = Value;
+		break;
+	case XOSPIPSV_OSPIDMA_DST_SIZE:
+		if (Sim.DmaBusy != 0U)
+			SimError("DMA programmed while running");
+		Sim.DmaSize = Value;
+		break;
+	case XOSPIPSV_OSPIDMA_DST_I_STS:
+		Sim.DmaIsts &= ~Value;
+		break;
+	default:
+		break;
+	}
+}
+
+void usleep(unsigned long useconds)
+{
+	SimNow += (u64)useconds * 1000000U;
+	SimAdvance();
+}
+
+u32 XGetPSVersion_Info(void)
+{
+	/* Keeps the DLL in bypass mode */
+	return SILICON_VERSION_1;
+}
+
+void Xil_MemCpy(void *Dst, const void *Src, u32 Cnt)
+{
+	memcpy(Dst, Src, Cnt);
+}
+
+void Xil_DCacheInvalidateRange(INTPTR Addr, u32 Len)
+{
+	(void)Addr;
+	(void)Len;
+}
+
+void Xil_DCacheFlushRange(INTPTR Addr, u32 Len)
+{
+	(void)Addr;
+	(void)Len;
+}
+
+void xil_printf(const char8 *Format, ...)
+{
+	(void)Format;
+}
+
+u32 Xil_AssertStatus;
+
+void Xil_Assert(const char8 *File, s32 Line)
+{
+	printf("assert %s:%d\n", File, (int)Line);
+}
+
+/************************** Test Helpers *************************************/
+
+static u32 Failures;
+
+#define CHECK(Cond, Msg)						\
+	do {								\
+		if (!(Cond)) {						\
+			printf("FAIL %s:%d: %s\n", __FILE__, __LINE__,	\
+								(Msg));	\
+			Failures++;					\
+		}							\
+	} while (0)
+
+/* The 4 byte octal IO read */
+static const XOspiPsv_Msg ReadCmd = {
+	.Opcode = 0xCCU,
+	.Addrsize = 4U,
+	.Addrvalid = 1U,
+	.Dummy = 16U,
+	.Proto = XOSPIPSV_READ_1_8_8,
+	.Flags = XOSPIPSV_MSG_FLAG_RX,
+};
+
+typedef struct {
+	u32 ExpectOffset;	/* Flash offset of the next chunk */
+	u32 Chunks;
+	u32 Bytes;
+	u32 BadData;
+	u32 Overlaps;		/* Chunks handed out while the DMA wrote them */
+	u32 StopAt;		/* Chunk to stop the stream at, 0 for none */
+	u64 PsPerByte;		/* Consumer cost */
+} StreamCtx;
+
+static u32 Consume(void *CallBackRef, const u8 *DataPtr, u32 ByteCount)
+{
+	StreamCtx *Ctx = (StreamCtx *)CallBackRef;
+
+	if (Sim.DmaBusy != 0U && (UINTPTR)DataPtr < Sim.DmaBusy +
+			Sim.DmaBusyLen && Sim.DmaBusy < (UINTPTR)DataPtr +
+			ByteCount)
+		Ctx->Overlaps++;
+	if (memcmp(DataPtr, &FlashMem[Ctx->ExpectOffset], ByteCount) != 0)
+		Ctx->BadData++;
+
+	Ctx->ExpectOffset += ByteCount;
+	Ctx->Bytes += ByteCount;
+	Ctx->Chunks++;
+	SimNow += Ctx->PsPerByte * ByteCount;
+
+	return (Ctx->Chunks == Ctx->StopAt) ? (u32)XST_FAILURE :
+			(u32)XST_SUCCESS;
+}
+
+static void Setup(void)
+{
+	XOspiPsv_Config Config;
+
+	SimReset();
+	memset(&Ospi, 0, sizeof(Ospi));
+	memset(&Config, 0, sizeof(Config));
+	Config.BaseAddress = SIM_BASE;
+	Config.InputClockHz = SIM_REF_HZ;
+	CHECK(XOspiPsv_CfgInitialize(&Ospi, &Config) == XST_SUCCESS,
+	      "initialize");
+	CHECK(XOspiPsv_SelectFlash(&Ospi, 0U) == XST_SUCCESS, "select");
+}
+
+static void InitStream(XOspiPsv_Stream *Stream, StreamCtx *Ctx,
+		       u32 ChunkSize, u32 Offset)
+{
+	memset(Ctx, 0, sizeof(*Ctx));
+	Ctx->ExpectOffset = Offset;
+	Stream->Buf[0] = DmaMem;
+	Stream->Buf[1] = DmaMem + 65536U;
+	Stream->ChunkSize = ChunkSize;
+	Stream->MsgTemplate = &ReadCmd;
+	Stream->DataHandler = Consume;
+	Stream->CallBackRef = Ctx;
+}
+
+/* Idle controller: no transfer or DMA left and chip select high */
+static int Idle(void)
+{
+	return !Ospi.IsBusy && Sim.DmaBusy == 0U && Sim.DmaIsts == 0U &&
+	       SimNow >= Sim.BusEnd &&
+	       (Sim.Cfg & XOSPIPSV_CONFIG_REG_PERIPH_CS_LINES_FLD_MASK) ==
+	       XOSPIPSV_CONFIG_REG_PERIPH_CS_LINES_FLD_MASK;
+}
+
+/************************** Tests ********************************************/
+
+static void TestRead(void)
+{
+	XOspiPsv_Stream Stream;
+	StreamCtx Ctx;
+	u32 Status;
+
+	/* Aligned: every chunk goes by DMA */
+	Setup();
+	InitStream(&Stream, &Ctx, 65536U, 0x123400U);
+	Status = XOspiPsv_StreamRead(&Ospi, &Stream, 0x123400U,
+				     5U * 65536U + 1024U);
+	CHECK(Status == XST_SUCCESS, "aligned read");
+	CHECK(Ctx.Bytes == 5U * 65536U + 1024U && Ctx.Chunks == 6U,
+	      "aligned chunks");
+	CHECK(Ctx.BadData == 0U && Ctx.Overlaps == 0U, "aligned data");
+	CHECK(Sim.Reads == 6U && Sim.DmaBytes == Ctx.Bytes, "aligned by DMA");
+	CHECK(Sim.Errors == 0U && Idle(), "aligned idle");
+
+	/* Unaligned: the last chunk is polled, its tail read as one word */
+	Setup();
+	InitStream(&Stream, &Ctx, 4096U, 0xFF0001U);
+	Status = XOspiPsv_StreamRead(&Ospi, &Stream, 0xFF0001U,
+				     3U * 4096U + 1027U);
+	CHECK(Status == XST_SUCCESS, "unaligned read");
+	CHECK(Ctx.Bytes == 3U * 4096U + 1027U && Ctx.Chunks == 4U,
+	      "unaligned chunks");
+	CHECK(Ctx.BadData == 0U && Ctx.Overlaps == 0U, "unaligned data");
+	CHECK(Sim.Reads == 5U && Sim.DmaBytes == Ctx.Bytes + 1U,
+	      "unaligned tail read as a word");
+	CHECK(Sim.Errors == 0U && Idle(), "unaligned idle");
+
+	/* A short range fits one chunk */
+	Setup();
+	InitStream(&Stream, &Ctx, 4096U, 100U);
+	Status = XOspiPsv_StreamRead(&Ospi, &Stream, 100U, 64U);
+	CHECK(Status == XST_SUCCESS && Ctx.Chunks == 1U &&
+	      Ctx.BadData == 0U && Sim.Errors == 0U && Idle(), "one chunk");
+
+	/* Nothing to read */
+	Status = XOspiPsv_StreamRead(&Ospi, &Stream, 100U, 0U);
+	CHECK(Status == XST_SUCCESS && Ctx.Chunks == 1U, "empty read");
+}
+
+static void TestStop(void)
+{
+	XOspiPsv_Stream Stream;
+	StreamCtx Ctx;
+	u32 Status;
+
+	Setup();
+	InitStream(&Stream, &Ctx, 8192U, 0U);
+	Ctx.StopAt = 2U;
+	Status = XOspiPsv_StreamRead(&Ospi, &Stream, 0U, 10U * 8192U);
+	CHECK(Status == XST_FAILURE, "consumer status returned");
+	CHECK(Ctx.Chunks == 2U, "no chunk after the stop");
+	/* The third chunk was already running and is drained */
+	CHECK(Sim.Reads == 3U && Sim.Errors == 0U && Idle(),
+	      "idle after the stop");
+
+	/* The controller is usable again */
+	InitStream(&Stream, &Ctx, 8192U, 65536U);
+	Status = XOspiPsv_StreamRead(&Ospi, &Stream, 65536U, 3U * 8192U);
+	CHECK(Status == XST_SUCCESS && Ctx.Chunks == 3U &&
+	      Ctx.BadData == 0U && Sim.Errors == 0U && Idle(),
+	      "read after the stop");
+
+	/* Busy controller */
+	Ospi.IsBusy = TRUE;
+	CHECK(XOspiPsv_StreamRead(&Ospi, &Stream, 0U, 8192U) ==
+	      XST_DEVICE_BUSY, "busy");
+	Ospi.IsBusy = FALSE;
+}
+
+/* Read Total bytes chunk by chunk, consuming each after it is read */
+static u32 SerialRead(StreamCtx *Ctx, u32 ChunkSize, u32 Offset, u32 Total)
+{
+	XOspiPsv_Msg Msg;
+	u32 Pos;
+	u32 Len;
+	u32 Status = XST_SUCCESS;
+
+	for (Pos = 0U; Pos < Total && Status == XST_SUCCESS; Pos += Len) {
+		Len = (Total - Pos < ChunkSize) ? Total - Pos : ChunkSize;
+		Msg = ReadCmd;
+		Msg.Addr = Offset + Pos;
+		Msg.RxBfrPtr = DmaMem;
+		Msg.ByteCount = Len;
+		Status = XOspiPsv_PollTransfer(&Ospi, &Msg);
+		if (Status == XST_SUCCESS)
+			Status = Consume(Ctx, DmaMem, Len);
+	}
+
+	return Status;
+}
+
+static double MBps(u32 Bytes, u64 Ps)
+{
+	return (double)Bytes * 1e6 / (double)Ps;
+}
+
+static void TestBenchmark(void)
+{
+	static const struct {
+		const char *Name;
+		u64 PsPerByte;
+	} Consumers[] = {
+		{ "none", 0U },
+		{ "hash 100 MB/s", 10000U },
+		{ "inflate 40 MB/s", 25000U },
+	};
+	const u32 Total = 4U * 1024U * 1024U;
+	const u32 Chunk = 65536U;
+	XOspiPsv_Stream Stream;
+	StreamCtx Ctx;
+	double Serial;
+	double Streamed;
+	double Flash = 0.0;
+	double Bound;
+	double Consumer;
+	u64 Start;
+	u32 i;
+
+	printf("4 MB from octal SPI at 50 MHz SDR in 64 KB chunks, "
+	       "simulated:\n");
+	printf("  %-16s %10s %10s\n", "consumer", "serial", "stream");
+	for (i = 0U; i < sizeof(Consumers) / sizeof(Consumers[0]); i++) {
+		Setup();
+		InitStream(&Stream, &Ctx, Chunk, 0U);
+		Ctx.PsPerByte = Consumers[i].PsPerByte;
+		Start = SimNow;
+		CHECK(SerialRead(&Ctx, Chunk, 0U, Total) == XST_SUCCESS,
+		      "serial read");
+		Serial = MBps(Total, SimNow - Start);
+		CHECK(Ctx.BadData == 0U && Sim.Errors == 0U, "serial data");
+
+		Setup();
+		InitStream(&Stream, &Ctx, Chunk, 0U);
+		Ctx.PsPerByte = Consumers[i].PsPerByte;
+		Start = SimNow;
+		CHECK(XOspiPsv_StreamRead(&Ospi, &Stream, 0U, Total) ==
+		      XST_SUCCESS, "stream read");
+		Streamed = MBps(Total, SimNow - Start);
+		CHECK(Ctx.BadData == 0U && Ctx.Overlaps == 0U &&
+		      Sim.Errors == 0U && Idle(), "stream data");
+
+		printf("  %-16s %10.1f %10.1f MB/s\n", Consumers[i].Name,
+		       Serial, Streamed);
+
+		if (Consumers[i].PsPerByte == 0U) {
+			/* Nothing to overlap: the flash bounds both */
+			Flash = Serial;
+			CHECK(Streamed >= 0.98 * Serial, "stream without consumer");
+			continue;
+		}
+
+		/* The stream runs at the slower of the flash and the
+		 * consumer, the serial read at their combined rate
+		 */
+		Consumer = 1e6 / (double)Consumers[i].PsPerByte;
+		Bound = (Flash < Consumer) ? Flash : Consumer;
+		CHECK(Streamed >= 0.95 * Bound, "stream below the bound");
+		CHECK(Streamed >= 1.4 * Serial, "stream gains too little");
+	}
+}
+
+/************************** Main *********************************************/
+
+int main(void)
+{
+	TestRead();
+	TestStop();
+	TestBenchmark();
+
+	printf("%s (%u failures)\n", Failures ? "FAILED" : "PASSED",
+							Failures);
+	return Failures ? 1 : 0;
+}
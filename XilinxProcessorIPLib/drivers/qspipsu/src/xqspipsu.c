@@ -87,6 +87,10 @@
 
 /************************** Function Prototypes ******************************/
 
+static s32 XQspiPsu_StreamStart(XQspiPsu *InstancePtr,
+		const XQspiPsu_Stream *StreamPtr, u32 Offset, u8 *BufPtr,
+		u32 ByteCount, u32 *InFlightPtr);
+
 /************************** Variable Definitions *****************************/
 
 /*****************************************************************************/
@@ -986,4 +990,162 @@ s32 XQspiPsu_CheckDmaDone(XQspiPsu *InstancePtr)
 	}
 
 }
+/*****************************************************************************/
+/**
+*
+* This function reads a range of flash in chunks into two ping-pong buffers
+* and hands each chunk to a consumer, such as a hash or a decompressor, while
+* the DMA reads the next chunk into the other buffer. The flash commands of
+* each chunk are built by the stream's PrepHandler, so any read command and
+* connection mode supported by XQspiPsu_StartDmaTransfer() can be used.
+*
+* @param	InstancePtr is a pointer to the XQspiPsu instance.
+* @param	StreamPtr is a pointer to the stream buffers and callbacks.
+* @param	Offset is the flash offset to start reading from.
+* @param	ByteCount is the number of bytes to read.
+*
+* @return
+*		- XST_SUCCESS if all chunks were read and consumed.
+*		- XST_DEVICE_BUSY if a transfer is already in progress.
+*		- XST_FAILURE if PrepHandler returned no message or a
+*		  transfer failed.
+*		- The DataHandler return value if it stopped the stream.
+*
+* @note		Chunks are read with DMA only when the read mode is DMA and
+*		the chunk size is a multiple of 4; otherwise, as for the last
+*		chunk of an unaligned ByteCount, the chunk is read with
+*		XQspiPsu_PolledTransfer() before the previous one is consumed.
+*
+******************************************************************************/
+s32 XQspiPsu_StreamRead(XQspiPsu *InstancePtr, XQspiPsu_Stream *StreamPtr,
+				u32 Offset, u32 ByteCount)
+{
+	u32 Pos = 0U;
+	u32 Len;
+	u32 CurLen;
+	u32 Idx = 0U;
+	u32 InFlight = (u32)FALSE;
+	s32 Status;
+	s32 DataStatus;
+
+	Xil_AssertNonvoid(InstancePtr != NULL);
+	Xil_AssertNonvoid(StreamPtr != NULL);
+	Xil_AssertNonvoid(StreamPtr->Buf[0] != NULL);
+	Xil_AssertNonvoid(StreamPtr->Buf[1] != NULL);
+	Xil_AssertNonvoid(StreamPtr->ChunkSize > 0U);
+	Xil_AssertNonvoid((StreamPtr->ChunkSize % 4U) == 0U);
+	Xil_AssertNonvoid(StreamPtr->PrepHandler != NULL);
+	Xil_AssertNonvoid(StreamPtr->DataHandler != NULL);
+	Xil_AssertNonvoid(InstancePtr->IsReady == XIL_COMPONENT_IS_READY);
+
+	if (InstancePtr->IsBusy == TRUE) {
+		Status = (s32)XST_DEVICE_BUSY;
+		goto END;
+	}
+	if (ByteCount == 0U) {
+		Status = XST_SUCCESS;
+		goto END;
+	}
+
+	Len = (ByteCount < StreamPtr->ChunkSize) ?
+			ByteCount : StreamPtr->ChunkSize;
+	Status = XQspiPsu_StreamStart(InstancePtr, StreamPtr, Offset,
+			StreamPtr->Buf[0], Len, &InFlight);
+
+	while (Status == XST_SUCCESS) {
+		/* Wait for the chunk in flight */
+		if (InFlight == (u32)TRUE) {
+			while (XQspiPsu_CheckDmaDone(InstancePtr) !=
+							XST_SUCCESS) {
+				/* Wait for the DMA */
+			}
+			InFlight = (u32)FALSE;
+		}
+		CurLen = Len;
+		Pos += CurLen;
+
+		/* Start the next chunk before handing this one out */
+		if (Pos < ByteCount) {
+			Len = ((ByteCount - Pos) < StreamPtr->ChunkSize) ?
+					(ByteCount - Pos) : StreamPtr->ChunkSize;
+			Status = XQspiPsu_StreamStart(InstancePtr, StreamPtr,
+					Offset + Pos, StreamPtr->Buf[Idx ^ 1U],
+					Len, &InFlight);
+		}
+
+		if (InstancePtr->Config.IsCacheCoherent == 0U) {
+			Xil_DCacheInvalidateRange((INTPTR)StreamPtr->Buf[Idx],
+							CurLen);
+		}
+		DataStatus = StreamPtr->DataHandler(StreamPtr->CallBackRef,
+					StreamPtr->Buf[Idx], CurLen);
+		if ((DataStatus != XST_SUCCESS) && (Status == XST_SUCCESS)) {
+			Status = DataStatus;
+		}
+
+		if (Pos >= ByteCount) {
+			break;
+		}
+		Idx ^= 1U;
+	}
+
+	/* Do not leave a chunk running after an early stop */
+	if (InFlight == (u32)TRUE) {
+		while (XQspiPsu_CheckDmaDone(InstancePtr) != XST_SUCCESS) {
+			/* Wait for the DMA */
+		}
+	}
+
+	END:
+	return Status;
+}
+
+/*****************************************************************************/
+/**
+*
+* This static function starts the read of one stream chunk.
+*
+* @param	InstancePtr is a pointer to the XQspiPsu instance.
+* @param	StreamPtr is a pointer to the stream.
+* @param	Offset is the flash offset of the chunk.
+* @param	BufPtr is the buffer to read into.
+* @param	ByteCount is the size of the chunk.
+* @param	InFlightPtr is set to TRUE if the chunk was started with DMA
+*		and must be completed with XQspiPsu_CheckDmaDone(), or FALSE
+*		if it was read before returning.
+*
+* @return
+*		- XST_SUCCESS if the chunk was started or read.
+*		- XST_FAILURE or the transfer function error otherwise.
+*
+* @note		None.
+*
+******************************************************************************/
+static s32 XQspiPsu_StreamStart(XQspiPsu *InstancePtr,
+		const XQspiPsu_Stream *StreamPtr, u32 Offset, u8 *BufPtr,
+		u32 ByteCount, u32 *InFlightPtr)
+{
+	XQspiPsu_Msg *Msg = NULL;
+	u32 NumMsg;
+	s32 Status;
+
+	NumMsg = StreamPtr->PrepHandler(StreamPtr->CallBackRef, Offset, BufPtr,
+					ByteCount, &Msg);
+	if ((NumMsg == 0U) || (Msg == NULL)) {
+		Status = XST_FAILURE;
+		goto END;
+	}
+
+	if ((InstancePtr->ReadMode == XQSPIPSU_READMODE_DMA) &&
+			((ByteCount % 4U) == 0U)) {
+		Status = XQspiPsu_StartDmaTransfer(InstancePtr, Msg, NumMsg);
+		*InFlightPtr = (Status == XST_SUCCESS) ? (u32)TRUE : (u32)FALSE;
+	} else {
+		Status = XQspiPsu_PolledTransfer(InstancePtr, Msg, NumMsg);
+		*InFlightPtr = (u32)FALSE;
+	}
+
+	END:
+	return Status;
+}
 /** @} */
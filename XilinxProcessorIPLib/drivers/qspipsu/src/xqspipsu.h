@@ -263,6 +263,46 @@ typedef struct {
 	void *StatusRef;	/**< Callback reference for status handler */
 } XQspiPsu;
 
+/**
+ * Callback type used by XQspiPsu_StreamRead() to build the messages that read
+ * one chunk of flash. The messages must read ByteCount bytes from flash
+ * offset Offset into RxBfrPtr and stay valid until the chunk is read.
+ *
+ * @param	CallBackRef is the reference given in the stream.
+ * @param	Offset is the flash offset of the chunk.
+ * @param	RxBfrPtr is the buffer the chunk is read into.
+ * @param	ByteCount is the size of the chunk.
+ * @param	MsgPtr is set to the first message of the chunk.
+ *
+ * @return	The number of messages, or 0 to stop the stream.
+ */
+typedef u32 (*XQspiPsu_StreamPrepHandler) (void *CallBackRef, u32 Offset,
+			u8 *RxBfrPtr, u32 ByteCount, XQspiPsu_Msg **MsgPtr);
+
+/**
+ * Callback type used by XQspiPsu_StreamRead() to hand one chunk of read data
+ * to the consumer while the next chunk is being read.
+ *
+ * @param	CallBackRef is the reference given in the stream.
+ * @param	DataPtr is the chunk data.
+ * @param	ByteCount is the size of the chunk.
+ *
+ * @return	XST_SUCCESS to continue, any other value stops the stream.
+ */
+typedef s32 (*XQspiPsu_StreamDataHandler) (void *CallBackRef,
+			const u8 *DataPtr, u32 ByteCount);
+
+/**
+ * This typedef contains the buffers and callbacks of a streaming read.
+ */
+typedef struct {
+	u8 *Buf[2];		/**< Ping-pong receive buffers */
+	u32 ChunkSize;		/**< Size of each buffer, multiple of 4 */
+	XQspiPsu_StreamPrepHandler PrepHandler; /**< Builds chunk messages */
+	XQspiPsu_StreamDataHandler DataHandler; /**< Consumes chunk data */
+	void *CallBackRef;	/**< Passed to both handlers */
+} XQspiPsu_Stream;
+
 /***************** Macros (Inline Functions) Definitions *********************/
 
 /**
@@ -516,6 +556,8 @@ void XQspiPsu_SetStatusHandler(XQspiPsu *InstancePtr, void *CallBackRef,
 s32 XQspiPsu_StartDmaTransfer(XQspiPsu *InstancePtr, XQspiPsu_Msg *Msg,
 				u32 NumMsg);
 s32 XQspiPsu_CheckDmaDone(XQspiPsu *InstancePtr);
+s32 XQspiPsu_StreamRead(XQspiPsu *InstancePtr, XQspiPsu_Stream *StreamPtr,
+				u32 Offset, u32 ByteCount);
 
 /* Configuration functions */
 s32 XQspiPsu_SetClkPrescaler(const XQspiPsu *InstancePtr, u8 Prescaler);
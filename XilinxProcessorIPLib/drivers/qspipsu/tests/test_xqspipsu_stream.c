@@ -0,0 +1,821 @@
+/******************************************************************************
+* Copyright (C) 2020 Xilinx, Inc.  All rights reserved.
+* SPDX-License-Identifier: MIT
+******************************************************************************/
+
+/*****************************************************************************/
+/**
+*
+* @file test_xqspipsu_stream.c
+*
+* Host test and benchmark of XQspiPsu_StreamRead(). The driver runs against
+* a simulated GQSPI controller with a quad SPI-NOR on the lower bus and chip
+* select. The controller model executes the generic FIFO entries when they
+* are started: chip select setup and hold, transmit from the TX FIFO, dummy
+* cycles and receive, with exponent lengths, to the RX FIFO in IO mode or to
+* the destination DMA in DMA mode. The flash decodes the read commands and
+* checks their address length, dummy cycles and bus width; any violation is
+* counted as a protocol error.
+*
+* Time is simulated. Register accesses cost a fixed time, the SPI bus runs at
+* the reference clock divided by the prescaler in the configuration register,
+* and the consumer of the data costs a time per byte. The DMA writes a chunk
+* when its last byte has been clocked in and the buffer reads as poison until
+* then, so a consumer handed a buffer that is still being read sees wrong
+* data; the model also counts a consumer call on the buffer of the running
+* DMA as an overlap.
+*
+* The tests read aligned and unaligned ranges, stop the stream from the
+* consumer and check the data, the chunk order, protocol errors and that the
+* controller is idle afterwards. The benchmark reads 4 MB at 150 MHz quad SPI
+* with consumers of 100 MB/s (a hash) and 40 MB/s (a decompressor), once
+* chunk by chunk with XQspiPsu_PolledTransfer() followed by the consumer, as
+* boot loaders do, and once with XQspiPsu_StreamRead(), and reports the
+* sustained MB/s of each.
+*
+* Build and run on the host:
+*   cc -Wall -O2 -I. -I../src -I../../../../lib/bsp/standalone/src/common \
+*      -I../../../../lib/bsp/standalone/src/arm/cortexa9 \
+*      test_xqspipsu_stream.c -o test_xqspipsu_stream
+*   ./test_xqspipsu_stream
+*
+******************************************************************************/
+
+/***************************** Include Files *********************************/
+
+#include <stdio.h>
+#include <string.h>
+
+#include "xil_types.h"
+
+/* Register accesses go to the simulator below */
+#define XIL_IO_H
+static u32 Xil_In32(UINTPTR Addr);
+static void Xil_Out32(UINTPTR Addr, u32 Value);
+
+#define XIL_PRINTF_H
+void xil_printf(const char8 *Format, ...);
+
+#include "xqspipsu.c"
+#include "xqspipsu_control.c"
+#include "xqspipsu_hw.c"
+#include "xqspipsu_options.c"
+
+/************************** Simulator ****************************************/
+
+#define SIM_BASE	0xFF0F0000U
+#define SIM_REGS	(SIM_BASE + XQSPIPSU_OFFSET)
+#define SIM_REF_HZ	300000000U	/* QSPI reference clock */
+#define SIM_REG_PS	50000U		/* One APB register access */
+
+#define FLASH_SIZE	(16U * 1024U * 1024U)
+#define FLASH_POISON	0xEEU
+
+#define SIM_GF_DEPTH	32U
+#define SIM_TX_DEPTH	256U		/* Bytes */
+#define SIM_RX_DEPTH	256U		/* Bytes */
+#define SIM_COMMITS	16U
+
+/* Read commands of the flash */
+typedef struct {
+	u8 Opcode;
+	u8 AddrBytes;
+	u8 DummyCycles;
+	u8 DataWidth;	/* XQSPIPSU_SELECT_MODE_* */
+} SimCmd;
+
+static const SimCmd SimCmds[] = {
+	{ 0x03U, 3U, 0U, XQSPIPSU_SELECT_MODE_SPI },	/* Read */
+	{ 0x0BU, 3U, 8U, XQSPIPSU_SELECT_MODE_SPI },	/* Fast read */
+	{ 0x6BU, 3U, 8U, XQSPIPSU_SELECT_MODE_QUADSPI },	/* Quad out */
+	{ 0x13U, 4U, 0U, XQSPIPSU_SELECT_MODE_SPI },	/* 4 byte read */
+	{ 0x6CU, 4U, 8U, XQSPIPSU_SELECT_MODE_QUADSPI },	/* 4 byte quad */
+};
+
+#define PHASE_IDLE	0	/* CS high */
+#define PHASE_OPCODE	1
+#define PHASE_ADDR	2
+#define PHASE_DATA	3	/* Dummy cycles, then data */
+
+/* A DMA write that lands when the SPI has clocked in its last byte */
+typedef struct {
+	u8 *Dst;
+	u32 Addr;	/* Flash address, or ~0 after a protocol error */
+	u32 Len;
+	u64 At;
+	u32 Last;	/* Completes the DMA */
+} SimCommit;
+
+typedef struct {
+	u32 Cfg;
+	u32 RxThr;
+	u32 GenFifo[SIM_GF_DEPTH];
+	u32 GfCount;
+	u8 Tx[SIM_TX_DEPTH];
+	u32 TxCount;
+	u8 Rx[SIM_RX_DEPTH];
+	u32 RxHead;
+	u32 RxCount;
+	u64 RxReadyAt;
+	u64 BusEnd;		/* The last started entry ends */
+	/* Destination DMA */
+	u32 DmaLsb;
+	u32 DmaMsb;
+	u8 *DmaPtr;
+	u32 DmaLeft;
+	u32 DmaIsts;
+	UINTPTR DmaBusy;	/* Buffer of the running DMA */
+	u32 DmaBusyLen;
+	SimCommit Commit[SIM_COMMITS];
+	u32 CommitCount;
+	/* Flash */
+	int Cs;
+	int Phase;
+	const SimCmd *Cmd;
+	u32 AddrLeft;
+	u32 Addr;
+	u32 Dummy;
+	/* Statistics */
+	u32 Errors;		/* Protocol errors */
+	u32 Reads;		/* Read commands */
+	u32 DmaBytes;
+	u32 IoBytes;
+} SimQspi;
+
+static SimQspi Sim;
+static u64 SimNow;
+static u8 FlashMem[FLASH_SIZE];
+
+/* Buffers the DMA may write, the model maps 32-bit DMA addresses here */
+static u8 DmaMem[4U * 65536U + 64U] __attribute__((aligned(64)));
+
+static void SimError(const char *Why)
+{
+	printf("protocol error: %s\n", Why);
+	Sim.Errors++;
+}
+
+static void SimReset(void)
+{
+	u32 i;
+
+	memset(&Sim, 0, sizeof(Sim));
+	SimNow = 0U;
+	for (i = 0U; i < FLASH_SIZE; i++)
+		FlashMem[i] = (u8)((i >> 16) ^ (i >> 8) ^ (i * 13U));
+}
+
+static u32 SimSpiPs(u32 Cycles)
+{
+	u32 Div = (Sim.Cfg & XQSPIPSU_CFG_BAUD_RATE_DIV_MASK) >>
+			XQSPIPSU_CFG_BAUD_RATE_DIV_SHIFT;
+	u64 Hz = (u64)SIM_REF_HZ >> (Div + 1U);
+
+	return (u32)((u64)Cycles * 1000000000000ULL / Hz);
+}
+
+static u32 SimWidth(u32 Entry)
+{
+	switch (Entry & XQSPIPSU_GENFIFO_MODE_MASK) {
+	case XQSPIPSU_GENFIFO_MODE_QUADSPI:
+		return XQSPIPSU_SELECT_MODE_QUADSPI;
+	case XQSPIPSU_GENFIFO_MODE_DUALSPI:
+		return XQSPIPSU_SELECT_MODE_DUALSPI;
+	default:
+		return XQSPIPSU_SELECT_MODE_SPI;
+	}
+}
+
+/* Apply the DMA writes whose data has arrived */
+static void SimAdvance(void)
+{
+	SimCommit *C;
+	u32 i = 0U;
+
+	while (i < Sim.CommitCount) {
+		C = &Sim.Commit[i];
+		if (SimNow < C->At) {
+			i++;
+			continue;
+		}
+		if (C->Addr != ~0U)
+			memcpy(C->Dst, &FlashMem[C->Addr], C->Len);
+		if (C->Last) {
+			Sim.DmaIsts |= XQSPIPSU_QSPIDMA_DST_I_STS_DONE_MASK;
+			Sim.DmaBusy = 0U;
+			Sim.DmaBusyLen = 0U;
+		}
+		Sim.Commit[i] = Sim.Commit[--Sim.CommitCount];
+	}
+}
+
+static void SimFlashByte(u8 Byte, u32 Width)
+{
+	u32 i;
+
+	switch (Sim.Phase) {
+	case PHASE_OPCODE:
+		Sim.Cmd = NULL;
+		for (i = 0U; i < sizeof(SimCmds) / sizeof(SimCmds[0]); i++) {
+			if (SimCmds[i].Opcode == Byte)
+				Sim.Cmd = &SimCmds[i];
+		}
+		if (Sim.Cmd == NULL || Width != XQSPIPSU_SELECT_MODE_SPI) {
+			SimError("unknown opcode or opcode width");
+			Sim.Phase = PHASE_IDLE;
+			break;
+		}
+		Sim.AddrLeft = Sim.Cmd->AddrBytes;
+		Sim.Addr = 0U;
+		Sim.Dummy = 0U;
+		Sim.Phase = PHASE_ADDR;
+		Sim.Reads++;
+		break;
+	case PHASE_ADDR:
+		Sim.Addr = (Sim.Addr << 8) | Byte;
+		if (--Sim.AddrLeft == 0U)
+			Sim.Phase = PHASE_DATA;
+		break;
+	default:
+		SimError("byte sent outside a command");
+		break;
+	}
+}
+
+/* Check that the flash may send Len bytes now and return their address */
+static int SimFlashData(u32 Width, u32 Len, u32 *AddrPtr)
+{
+	if (Sim.Phase != PHASE_DATA || Sim.Cmd == NULL) {
+		SimError("receive before the address");
+		return 0;
+	}
+	if (Sim.Dummy != Sim.Cmd->DummyCycles) {
+		SimError("wrong dummy cycles");
+		return 0;
+	}
+	if (Width != Sim.Cmd->DataWidth) {
+		SimError("wrong data width");
+		return 0;
+	}
+	if (Sim.Addr + Len > FLASH_SIZE) {
+		SimError("read past the flash");
+		return 0;
+	}
+	*AddrPtr = Sim.Addr;
+	Sim.Addr += Len;
+
+	return 1;
+}
+
+static u64 SimRun(u32 Entry, u64 T)
+{
+	u32 Width = SimWidth(Entry);
+	u32 Len = Entry & XQSPIPSU_GENFIFO_IMM_DATA_MASK;
+	u32 Addr;
+	u32 i;
+	SimCommit *C;
+
+	if (!(Entry & XQSPIPSU_GENFIFO_DATA_XFER)) {
+		/* Chip select setup, hold or idle cycles */
+		if ((Entry & (XQSPIPSU_GENFIFO_CS_LOWER |
+			      XQSPIPSU_GENFIFO_CS_UPPER)) != 0U) {
+			if (!Sim.Cs)
+				Sim.Phase = PHASE_OPCODE;
+			Sim.Cs = 1;
+		}
+		else {
+			Sim.Cs = 0;
+			Sim.Phase = PHASE_IDLE;
+		}
+		return T + SimSpiPs(Len);
+	}
+
+	if (Entry & XQSPIPSU_GENFIFO_EXP)
+		Len = 1U << Len;
+	if (!Sim.Cs)
+		SimError("transfer with CS high");
+	if (Entry & (XQSPIPSU_GENFIFO_STRIPE | XQSPIPSU_GENFIFO_POLL))
+		SimError("stripe or poll on a single flash");
+
+	if ((Entry & XQSPIPSU_GENFIFO_TX) && !(Entry & XQSPIPSU_GENFIFO_RX)) {
+		if (Len > Sim.TxCount) {
+			SimError("TX FIFO underflow");
+			Len = Sim.TxCount;
+		}
+		for (i = 0U; i < Len; i++)
+			SimFlashByte(Sim.Tx[i], Width);
+		/* The unused bytes of the last word are dropped */
+		i = (Len + 3U) & ~3U;
+		i = (i > Sim.TxCount) ? Sim.TxCount : i;
+		Sim.TxCount -= i;
+		memmove(Sim.Tx, &Sim.Tx[i], Sim.TxCount);
+		return T + SimSpiPs(Len * 8U / Width);
+	}
+
+	if (!(Entry & (XQSPIPSU_GENFIFO_TX | XQSPIPSU_GENFIFO_RX))) {
+		/* Dummy: the length is in clock cycles */
+		if (Sim.Phase == PHASE_DATA)
+			Sim.Dummy += Len;
+		else
+			SimError("dummy cycles outside a read");
+		return T + SimSpiPs(Len);
+	}
+
+	/* Data that the flash does not send reads as poison, the transfer
+	 * still completes so that the driver does not hang
+	 */
+	if ((Entry & XQSPIPSU_GENFIFO_TX) != 0U) {
+		SimError("full duplex transfer");
+		Addr = ~0U;
+	}
+	else if (!SimFlashData(Width, Len, &Addr)) {
+		Addr = ~0U;
+	}
+	T += SimSpiPs(Len * 8U / Width);
+
+	if ((Sim.Cfg & XQSPIPSU_CFG_MODE_EN_MASK) ==
+			XQSPIPSU_CFG_MODE_EN_DMA_MASK) {
+		if (Len > Sim.DmaLeft || Sim.CommitCount == SIM_COMMITS) {
+			SimError("DMA overflow");
+			return T;
+		}
+		C = &Sim.Commit[Sim.CommitCount++];
+		C->Dst = Sim.DmaPtr;
+		C->Addr = Addr;
+		C->Len = Len;
+		C->At = T;
+		memset(Sim.DmaPtr, FLASH_POISON, Len);
+		Sim.DmaPtr += Len;
+		Sim.DmaLeft -= Len;
+		C->Last = (Sim.DmaLeft == 0U);
+		Sim.DmaBytes += Len;
+	}
+	else {
+		if (Sim.RxCount + Len > SIM_RX_DEPTH) {
+			SimError("RX FIFO overflow");
+			return T;
+		}
+		for (i = 0U; i < Len; i++) {
+			Sim.Rx[(Sim.RxHead + Sim.RxCount) % SIM_RX_DEPTH] =
+				(Addr == ~0U) ? FLASH_POISON : FlashMem[Addr + i];
+			Sim.RxCount++;
+		}
+		Sim.RxReadyAt = T;
+		Sim.IoBytes += Len;
+	}
+
+	return T;
+}
+
+static void SimStart(void)
+{
+	u64 T = (Sim.BusEnd > SimNow) ? Sim.BusEnd : SimNow;
+	u32 i;
+
+	for (i = 0U; i < Sim.GfCount; i++)
+		T = SimRun(Sim.GenFifo[i], T);
+	Sim.GfCount = 0U;
+	Sim.BusEnd = T;
+}
+
+static u32 SimIsr(void)
+{
+	u32 Isr = XQSPIPSU_ISR_GENFIFONOT_FULL_MASK;
+
+	if (Sim.GfCount == 0U && SimNow >= Sim.BusEnd)
+		Isr |= XQSPIPSU_ISR_GENFIFOEMPTY_MASK;
+	if (Sim.TxCount == 0U)
+		Isr |= XQSPIPSU_ISR_TXEMPTY_MASK;
+	if (Sim.TxCount + 4U <= SIM_TX_DEPTH)
+		Isr |= XQSPIPSU_ISR_TXNOT_FULL_MASK;
+	if (Sim.RxCount != 0U && SimNow >= Sim.RxReadyAt)
+		Isr |= XQSPIPSU_ISR_RXNEMPTY_MASK;
+	else
+		Isr |= XQSPIPSU_ISR_RXEMPTY_MASK;
+
+	return Isr;
+}
+
+/************************** Stubs ********************************************/
+
+static u32 Xil_In32(UINTPTR Addr)
+{
+	u32 Value = 0U;
+	u32 i;
+
+	SimNow += SIM_REG_PS;
+	SimAdvance();
+
+	switch (Addr - SIM_REGS) {
+	case XQSPIPSU_CFG_OFFSET:
+		return Sim.Cfg;
+	case XQSPIPSU_ISR_OFFSET:
+		return SimIsr();
+	case XQSPIPSU_RXD_OFFSET:
+		if (Sim.RxCount == 0U || SimNow < Sim.RxReadyAt) {
+			SimError("RX FIFO read while empty");
+			return 0U;
+		}
+		for (i = 0U; i < 4U && Sim.RxCount != 0U; i++) {
+			Value |= (u32)Sim.Rx[Sim.RxHead] << (8U * i);
+			Sim.RxHead = (Sim.RxHead + 1U) % SIM_RX_DEPTH;
+			Sim.RxCount--;
+		}
+		return Value;
+	case XQSPIPSU_RX_THRESHOLD_OFFSET:
+		return Sim.RxThr;
+	case XQSPIPSU_QSPIDMA_DST_I_STS_OFFSET:
+		return Sim.DmaIsts;
+	default:
+		return 0U;
+	}
+}
+
+static void Xil_Out32(UINTPTR Addr, u32 Value)
+{
+	SimNow += SIM_REG_PS;
+	SimAdvance();
+
+	switch (Addr - SIM_REGS) {
+	case XQSPIPSU_CFG_OFFSET:
+		Sim.Cfg = Value & ~XQSPIPSU_CFG_START_GEN_FIFO_MASK;
+		if (Value & XQSPIPSU_CFG_START_GEN_FIFO_MASK)
+			SimStart();
+		break;
+	case XQSPIPSU_TXD_OFFSET:
+		if (Sim.TxCount + 4U > SIM_TX_DEPTH) {
+			SimError("TX FIFO overflow");
+			break;
+		}
+		memcpy(&Sim.Tx[Sim.TxCount], &Value, 4U);
+		Sim.TxCount += 4U;
+		break;
+	case XQSPIPSU_GEN_FIFO_OFFSET:
+		if (Sim.GfCount == SIM_GF_DEPTH) {
+			SimError("generic FIFO overflow");
+			break;
+		}
+		Sim.GenFifo[Sim.GfCount++] = Value;
+		break;
+	case XQSPIPSU_RX_THRESHOLD_OFFSET:
+		Sim.RxThr = Value;
+		break;
+	case XQSPIPSU_FIFO_CTRL_OFFSET:
+		if (Value & XQSPIPSU_FIFO_CTRL_RST_TX_FIFO_MASK)
+			Sim.TxCount = 0U;
+		if (Value & XQSPIPSU_FIFO_CTRL_RST_GEN_FIFO_MASK)
+			Sim.GfCount = 0U;
+		if (Value & XQSPIPSU_FIFO_CTRL_RST_RX_FIFO_MASK)
+			Sim.RxCount = 0U;
+		break;
+	case XQSPIPSU_QSPIDMA_DST_ADDR_OFFSET:
+		Sim.DmaLsb = Value;
+		break;
+	case XQSPIPSU_QSPIDMA_DST_ADDR_MSB_OFFSET:
+		Sim.DmaMsb = Value;
+		break;
+	case XQSPIPSU_QSPIDMA_DST_SIZE_OFFSET:
+		if (Sim.DmaLeft != 0U || Sim.CommitCount != 0U)
+			SimError("DMA programmed while running");
+		/* A 32-bit DMA address is in the simulated DMA memory */
+		Sim.DmaPtr = (u8 *)(((UINTPTR)Sim.DmaMsb << 32) |
+				(Sim.DmaLsb & XQSPIPSU_QSPIDMA_DST_ADDR_MASK));
+		if (Sim.DmaMsb == 0U)
+			Sim.DmaPtr = (u8 *)((UINTPTR)Sim.DmaPtr |
+				((UINTPTR)DmaMem & ~(UINTPTR)0xFFFFFFFFU));
+		if (Sim.DmaPtr < DmaMem ||
+		    Sim.DmaPtr + Value > DmaMem + sizeof(DmaMem))
+			SimError("DMA outside its memory");
+		Sim.DmaLeft = Value;
+		Sim.DmaBusy = (UINTPTR)Sim.DmaPtr;
+		Sim.DmaBusyLen = Value;
+		break;
+	case XQSPIPSU_QSPIDMA_DST_I_STS_OFFSET:
+		Sim.DmaIsts &= ~Value;
+		break;
+	default:
+		break;
+	}
+}
+
+void Xil_MemCpy(void *Dst, const void *Src, u32 Cnt)
+{
+	memcpy(Dst, Src, Cnt);
+}
+
+void Xil_DCacheInvalidateRange(INTPTR Addr, u32 Len)
+{
+	(void)Addr;
+	(void)Len;
+}
+
+void Xil_DCacheFlushRange(INTPTR Addr, u32 Len)
+{
+	(void)Addr;
+	(void)Len;
+}
+
+void xil_printf(const char8 *Format, ...)
+{
+	(void)Format;
+}
+
+u32 Xil_AssertStatus;
+
+void Xil_Assert(const char8 *File, s32 Line)
+{
+	printf("assert %s:%d\n", File, (int)Line);
+}
+
+/************************** Test Helpers *************************************/
+
+static u32 Failures;
+
+#define CHECK(Cond, Msg)						\
+	do {								\
+		if (!(Cond)) {						\
+			printf("FAIL %s:%d: %s\n", __FILE__, __LINE__,	\
+								(Msg));	\
+			Failures++;					\
+		}							\
+	} while (0)
+
+static XQspiPsu Qspi;
+
+/* Messages of one chunk read with the 4 byte quad output command */
+typedef struct {
+	XQspiPsu_Msg Msg[3];
+	u8 Cmd[8];
+	u32 ExpectOffset;	/* Flash offset of the next chunk */
+	u32 Chunks;
+	u32 Bytes;
+	u32 BadData;
+	u32 Overlaps;		/* Chunks handed out while the DMA wrote them */
+	u32 StopAt;		/* Chunk to stop the stream at, 0 for none */
+	u64 PsPerByte;		/* Consumer cost */
+} StreamCtx;
+
+static u32 Prep(void *CallBackRef, u32 Offset, u8 *RxBfrPtr, u32 ByteCount,
+		XQspiPsu_Msg **MsgPtr)
+{
+	StreamCtx *Ctx = (StreamCtx *)CallBackRef;
+
+	memset(Ctx->Msg, 0, sizeof(Ctx->Msg));
+	Ctx->Cmd[0] = 0x6CU;
+	Ctx->Cmd[1] = (u8)(Offset >> 24);
+	Ctx->Cmd[2] = (u8)(Offset >> 16);
+	Ctx->Cmd[3] = (u8)(Offset >> 8);
+	Ctx->Cmd[4] = (u8)Offset;
+
+	Ctx->Msg[0].TxBfrPtr = Ctx->Cmd;
+	Ctx->Msg[0].ByteCount = 5U;
+	Ctx->Msg[0].BusWidth = XQSPIPSU_SELECT_MODE_SPI;
+	Ctx->Msg[0].Flags = XQSPIPSU_MSG_FLAG_TX;
+
+	Ctx->Msg[1].ByteCount = 8U;	/* Dummy clocks */
+	Ctx->Msg[1].BusWidth = XQSPIPSU_SELECT_MODE_QUADSPI;
+
+	Ctx->Msg[2].RxBfrPtr = RxBfrPtr;
+	Ctx->Msg[2].ByteCount = ByteCount;
+	Ctx->Msg[2].BusWidth = XQSPIPSU_SELECT_MODE_QUADSPI;
+	Ctx->Msg[2].Flags = XQSPIPSU_MSG_FLAG_RX;
+
+	*MsgPtr = Ctx->Msg;
+	return 3U;
+}
+
+static s32 Consume(void *CallBackRef, const u8 *DataPtr, u32 ByteCount)
+{
+	StreamCtx *Ctx = (StreamCtx *)CallBackRef;
+
+	if (Sim.DmaBusy != 0U && (UINTPTR)DataPtr < Sim.DmaBusy +
+			Sim.DmaBusyLen && Sim.DmaBusy < (UINTPTR)DataPtr +
+			ByteCount)
+		Ctx->Overlaps++;
+	if (memcmp(DataPtr, &FlashMem[Ctx->ExpectOffset], ByteCount) != 0)
+		Ctx->BadData++;
+
+	Ctx->ExpectOffset += ByteCount;
+	Ctx->Bytes += ByteCount;
+	Ctx->Chunks++;
+	SimNow += Ctx->PsPerByte * ByteCount;
+
+	return (Ctx->Chunks == Ctx->StopAt) ? XST_FAILURE : XST_SUCCESS;
+}
+
+static void Setup(void)
+{
+	XQspiPsu_Config Config;
+
+	SimReset();
+	memset(&Qspi, 0, sizeof(Qspi));
+	memset(&Config, 0, sizeof(Config));
+	Config.BaseAddress = SIM_BASE;
+	Config.InputClockHz = SIM_REF_HZ;
+	Config.ConnectionMode = XQSPIPSU_CONNECTION_MODE_SINGLE;
+	Config.BusWidth = 2U;
+	CHECK(XQspiPsu_CfgInitialize(&Qspi, &Config, SIM_BASE) ==
+	      XST_SUCCESS, "initialize");
+	XQspiPsu_SelectFlash(&Qspi, XQSPIPSU_SELECT_FLASH_CS_LOWER,
+			     XQSPIPSU_SELECT_FLASH_BUS_LOWER);
+	CHECK(XQspiPsu_SetClkPrescaler(&Qspi, XQSPIPSU_CLK_PRESCALE_2) ==
+	      XST_SUCCESS, "prescaler");
+}
+
+static void InitStream(XQspiPsu_Stream *Stream, StreamCtx *Ctx,
+		       u32 ChunkSize, u32 Offset)
+{
+	memset(Ctx, 0, sizeof(*Ctx));
+	Ctx->ExpectOffset = Offset;
+	Stream->Buf[0] = DmaMem;
+	Stream->Buf[1] = DmaMem + 2U * 65536U;
+	Stream->ChunkSize = ChunkSize;
+	Stream->PrepHandler = Prep;
+	Stream->DataHandler = Consume;
+	Stream->CallBackRef = Ctx;
+}
+
+/* Idle controller: no transfer, DMA or FIFO data left */
+static int Idle(void)
+{
+	return !Qspi.IsBusy && Sim.DmaLeft == 0U && Sim.CommitCount == 0U &&
+	       Sim.GfCount == 0U && Sim.TxCount == 0U && Sim.RxCount == 0U &&
+	       !Sim.Cs && SimNow >= Sim.BusEnd;
+}
+
+/************************** Tests ********************************************/
+
+static void TestRead(void)
+{
+	XQspiPsu_Stream Stream;
+	StreamCtx Ctx;
+	s32 Status;
+
+	/* Aligned: every chunk goes by DMA */
+	Setup();
+	InitStream(&Stream, &Ctx, 65536U, 0x123400U);
+	Status = XQspiPsu_StreamRead(&Qspi, &Stream, 0x123400U,
+				     5U * 65536U + 1024U);
+	CHECK(Status == XST_SUCCESS, "aligned read");
+	CHECK(Ctx.Bytes == 5U * 65536U + 1024U && Ctx.Chunks == 6U,
+	      "aligned chunks");
+	CHECK(Ctx.BadData == 0U && Ctx.Overlaps == 0U, "aligned data");
+	CHECK(Sim.Reads == 6U && Sim.DmaBytes == Ctx.Bytes &&
+	      Sim.IoBytes == 0U, "aligned by DMA");
+	CHECK(Sim.Errors == 0U && Idle(), "aligned idle");
+
+	/* Unaligned: the last chunk is polled, its tail read in IO mode */
+	Setup();
+	InitStream(&Stream, &Ctx, 4096U, 0xFF0001U);
+	Status = XQspiPsu_StreamRead(&Qspi, &Stream, 0xFF0001U,
+				     3U * 4096U + 1027U);
+	CHECK(Status == XST_SUCCESS, "unaligned read");
+	CHECK(Ctx.Bytes == 3U * 4096U + 1027U && Ctx.Chunks == 4U,
+	      "unaligned chunks");
+	CHECK(Ctx.BadData == 0U && Ctx.Overlaps == 0U, "unaligned data");
+	CHECK(Sim.IoBytes == 3U, "unaligned tail in IO mode");
+	CHECK(Sim.Errors == 0U && Idle(), "unaligned idle");
+
+	/* A short range fits one chunk */
+	Setup();
+	InitStream(&Stream, &Ctx, 4096U, 100U);
+	Status = XQspiPsu_StreamRead(&Qspi, &Stream, 100U, 64U);
+	CHECK(Status == XST_SUCCESS && Ctx.Chunks == 1U &&
+	      Ctx.BadData == 0U && Sim.Errors == 0U && Idle(), "one chunk");
+
+	/* Nothing to read */
+	Status = XQspiPsu_StreamRead(&Qspi, &Stream, 100U, 0U);
+	CHECK(Status == XST_SUCCESS && Ctx.Chunks == 1U, "empty read");
+}
+
+static void TestStop(void)
+{
+	XQspiPsu_Stream Stream;
+	StreamCtx Ctx;
+	s32 Status;
+
+	Setup();
+	InitStream(&Stream, &Ctx, 8192U, 0U);
+	Ctx.StopAt = 2U;
+	Status = XQspiPsu_StreamRead(&Qspi, &Stream, 0U, 10U * 8192U);
+	CHECK(Status == XST_FAILURE, "consumer status returned");
+	CHECK(Ctx.Chunks == 2U, "no chunk after the stop");
+	/* The third chunk was already running and is drained */
+	CHECK(Sim.Reads == 3U && Sim.Errors == 0U && Idle(),
+	      "idle after the stop");
+
+	/* The controller is usable again */
+	InitStream(&Stream, &Ctx, 8192U, 65536U);
+	Status = XQspiPsu_StreamRead(&Qspi, &Stream, 65536U, 3U * 8192U);
+	CHECK(Status == XST_SUCCESS && Ctx.Chunks == 3U &&
+	      Ctx.BadData == 0U && Sim.Errors == 0U && Idle(),
+	      "read after the stop");
+
+	/* Busy controller */
+	Qspi.IsBusy = TRUE;
+	CHECK(XQspiPsu_StreamRead(&Qspi, &Stream, 0U, 8192U) ==
+	      XST_DEVICE_BUSY, "busy");
+	Qspi.IsBusy = FALSE;
+}
+
+/* Read Total bytes chunk by chunk, consuming each after it is read */
+static s32 SerialRead(StreamCtx *Ctx, u32 ChunkSize, u32 Offset, u32 Total)
+{
+	XQspiPsu_Msg *Msg;
+	u32 Pos;
+	u32 Len;
+	u32 NumMsg;
+	s32 Status = XST_SUCCESS;
+
+	for (Pos = 0U; Pos < Total && Status == XST_SUCCESS; Pos += Len) {
+		Len = (Total - Pos < ChunkSize) ? Total - Pos : ChunkSize;
+		NumMsg = Prep(Ctx, Offset + Pos, DmaMem, Len, &Msg);
+		Status = XQspiPsu_PolledTransfer(&Qspi, Msg, NumMsg);
+		if (Status == XST_SUCCESS)
+			Status = Consume(Ctx, DmaMem, Len);
+	}
+
+	return Status;
+}
+
+static double MBps(u32 Bytes, u64 Ps)
+{
+	return (double)Bytes * 1e6 / (double)Ps;
+}
+
+static void TestBenchmark(void)
+{
+	static const struct {
+		const char *Name;
+		u64 PsPerByte;
+	} Consumers[] = {
+		{ "none", 0U },
+		{ "hash 100 MB/s", 10000U },
+		{ "inflate 40 MB/s", 25000U },
+	};
+	const u32 Total = 4U * 1024U * 1024U;
+	const u32 Chunk = 65536U;
+	XQspiPsu_Stream Stream;
+	StreamCtx Ctx;
+	double Serial;
+	double Streamed;
+	double Flash = 0.0;
+	double Bound;
+	double Consumer;
+	u64 Start;
+	u32 i;
+
+	printf("4 MB from quad SPI at 150 MHz in 64 KB chunks, simulated:\n");
+	printf("  %-16s %10s %10s\n", "consumer", "serial", "stream");
+	for (i = 0U; i < sizeof(Consumers) / sizeof(Consumers[0]); i++) {
+		Setup();
+		InitStream(&Stream, &Ctx, Chunk, 0U);
+		Ctx.PsPerByte = Consumers[i].PsPerByte;
+		Start = SimNow;
+		CHECK(SerialRead(&Ctx, Chunk, 0U, Total) == XST_SUCCESS,
+		      "serial read");
+		Serial = MBps(Total, SimNow - Start);
+		CHECK(Ctx.BadData == 0U && Sim.Errors == 0U, "serial data");
+
+		Setup();
+		InitStream(&Stream, &Ctx, Chunk, 0U);
+		Ctx.PsPerByte = Consumers[i].PsPerByte;
+		Start = SimNow;
+		CHECK(XQspiPsu_StreamRead(&Qspi, &Stream, 0U, Total) ==
+		      XST_SUCCESS, "stream read");
+		Streamed = MBps(Total, SimNow - Start);
+		CHECK(Ctx.BadData == 0U && Ctx.Overlaps == 0U &&
+		      Sim.Errors == 0U && Idle(), "stream data");
+
+		printf("  %-16s %10.1f %10.1f MB/s\n", Consumers[i].Name,
+		       Serial, Streamed);
+
+		if (Consumers[i].PsPerByte == 0U) {
+			/* Nothing to overlap: the flash bounds both */
+			Flash = Serial;
+			CHECK(Streamed >= 0.98 * Serial, "stream without consumer");
+			continue;
+		}
+
+		/* The stream runs at the slower of the flash and the
+		 * consumer, the serial read at their combined rate
+		 */
+		Consumer = 1e6 / (double)Consumers[i].PsPerByte;
+		Bound = (Flash < Consumer) ? Flash : Consumer;
+		CHECK(Streamed >= 0.95 * Bound, "stream below the bound");
+		CHECK(Streamed >= 1.4 * Serial, "stream gains too little");
+	}
+}
+
+/************************** Main *********************************************/
+
+int main(void)
+{
+	TestRead();
+	TestStop();
+	TestBenchmark();
+
+	printf("%s (%u failures)\n", Failures ? "FAILED" : "PASSED",
+							Failures);
+	return Failures ? 1 : 0;
+}
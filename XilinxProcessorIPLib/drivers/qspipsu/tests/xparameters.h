@@ -0,0 +1,10 @@
+/******************************************************************************
+* Copyright (C) 2020 Xilinx, Inc.  All rights reserved.
+* SPDX-License-Identifier: MIT
+******************************************************************************/
+
+/* Hardware parameters used by the host tests: none are needed by the driver */
+#ifndef XPARAMETERS_H
+#define XPARAMETERS_H
+
+#endif
@@ -423,6 +423,10 @@ s32  XScuGic_CfgInitialize(XScuGic *InstancePtr,
 		XScuGic_set_priority_filter(0xff);
 #else
 		CPUInitialize(InstancePtr);
+#endif
+		InstancePtr->MaxIntrPerEntry = XSCUGIC_MAX_INTR_PER_ENTRY;
+#ifdef XSCUGIC_INTR_STATS
+		InstancePtr->IntrStatsPtr = NULL;
 #endif
 		InstancePtr->IsReady = XIL_COMPONENT_IS_READY;
 	}
@@ -197,6 +197,24 @@ extern "C" {
 
 #define XSCUGIC500_DCTLR_ARE_NS_ENABLE  0x20
 #define XSCUGIC500_DCTLR_ARE_S_ENABLE  0x10
+
+/*
+ * Default number of interrupts XScuGic_InterruptHandler services per entry.
+ * The default of 1 keeps the one interrupt per exception behavior, larger
+ * values drain back to back interrupts without leaving the handler.
+ */
+#ifndef XSCUGIC_MAX_INTR_PER_ENTRY
+#define XSCUGIC_MAX_INTR_PER_ENTRY	1U
+#endif
+
+#ifdef XSCUGIC_INTR_STATS
+/*
+ * Number of log2 buckets in the per vector handler cycle histogram, bucket n
+ * counts handler runs that took 2^n to 2^(n+1)-1 PMU cycles, the last bucket
+ * also counts everything longer.
+ */
+#define XSCUGIC_INTR_STATS_BUCKETS	16U
+#endif
 /**************************** Type Definitions *******************************/
 
 /* The following data type defines each entry in an interrupt vector table.
@@ -221,6 +239,34 @@ typedef struct
 				 Vector table of interrupt handlers */
 } XScuGic_Config;
 
+#ifdef XSCUGIC_INTR_STATS
+/**
+ * Dispatch statistics of one interrupt ID.
+ */
+typedef struct
+{
+	u32 Count;		/**< Number of times the handler ran */
+	u32 MaxCycles;		/**< Longest handler run in PMU cycles */
+	u32 Hist[XSCUGIC_INTR_STATS_BUCKETS]; /**< log2 cycle histogram */
+} XScuGic_VectorStats;
+
+/**
+ * Dispatch statistics of an interrupt controller, attached with
+ * XScuGic_SetIntrStats.
+ */
+typedef struct
+{
+	u32 Entries;		/**< Calls of XScuGic_InterruptHandler */
+	u32 Drained;		/**< Interrupts serviced after the first one
+				     of an entry */
+	u32 CapReached;		/**< Entries that stopped at the per entry
+				     limit with interrupts still pending */
+	u32 Spurious;		/**< Entries that found no valid interrupt */
+	XScuGic_VectorStats Vector[XSCUGIC_MAX_NUM_INTR_INPUTS]; /**< Per
+				     interrupt ID statistics */
+} XScuGic_IntrStats;
+#endif
+
 /**
  * The XScuGic driver instance data. The user is required to allocate a
  * variable of this type for every intc device in the system. A pointer
@@ -231,6 +277,11 @@ typedef struct
 	XScuGic_Config *Config;  /**< Configuration table entry */
 	u32 IsReady;		 /**< Device is initialized and ready */
 	u32 UnhandledInterrupts; /**< Intc Statistics */
+	u32 MaxIntrPerEntry;	 /**< Interrupts serviced per handler entry */
+#ifdef XSCUGIC_INTR_STATS
+	XScuGic_IntrStats *IntrStatsPtr; /**< Dispatch statistics, NULL if
+					      not collected */
+#endif
 } XScuGic;
 
 /***************** Macros (Inline Functions) Definitions *********************/
@@ -522,6 +573,25 @@ XSCUGIC_RDIST_OFFSET), (RegOffset)))
 #endif
 /****************************************************************************/
 /**
+* This function returns interrupt id of highest priority pending interrupt
+* without acknowledging it
+*
+* @param	None.
+*
+* @return	None.
+*
+* @note        None.
+*
+*****************************************************************************/
+#if defined (__aarch64__)
+#if EL3
+#define XScuGic_get_PendIntID()  mfcp(S3_0_C12_C8_2)
+#else
+#define XScuGic_get_PendIntID()  mfcp(S3_0_C12_C12_2)
+#endif
+#endif
+/****************************************************************************/
+/**
 * This macro returns bit position for the specific interrupt's trigger type
 * configuration within GICR_ICFGR0/GICR_ICFGR1 register
 *
@@ -570,6 +640,10 @@ XScuGic_Config *XScuGic_LookupConfig(u16 DeviceId);
  * Interrupt functions in xscugic_intr.c
  */
 void XScuGic_InterruptHandler(XScuGic *InstancePtr);
+void XScuGic_SetMaxIntrPerEntry(XScuGic *InstancePtr, u32 MaxIntr);
+#ifdef XSCUGIC_INTR_STATS
+void XScuGic_SetIntrStats(XScuGic *InstancePtr, XScuGic_IntrStats *StatsPtr);
+#endif
 
 /*
  * Self-test functions in xscugic_selftest.c
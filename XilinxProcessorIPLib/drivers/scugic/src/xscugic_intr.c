@@ -59,6 +59,9 @@
 #include "xil_types.h"
 #include "xil_assert.h"
 #include "xscugic.h"
+#ifdef XSCUGIC_INTR_STATS
+#include "xpseudo_asm.h"
+#endif
 
 /************************** Constant Definitions *****************************/
 
@@ -68,6 +71,12 @@
 
 /************************** Function Prototypes ******************************/
 
+#ifdef XSCUGIC_INTR_STATS
+static INLINE u32 XScuGic_ReadCycleCount(void);
+static void XScuGic_RecordDispatch(XScuGic_IntrStats *StatsPtr,
+					u32 InterruptID, u32 Cycles);
+#endif
+
 /************************** Variable Definitions *****************************/
 
 /*****************************************************************************/
@@ -79,6 +88,13 @@
 * the Interrupt Type information to determine when to acknowledge the interrupt.
 * Highest priority interrupts are serviced first.
 *
+* After an interrupt is serviced the acknowledge register is read again and
+* the next pending interrupt is serviced in the same call, up to
+* MaxIntrPerEntry interrupts (see XScuGic_SetMaxIntrPerEntry). This saves the
+* exception entry and exit for bursts of interrupts. The GIC still selects the
+* highest priority pending interrupt on each read, and the limit bounds the
+* time the interrupted context is held off.
+*
 * This function assumes that an interrupt vector table has been previously
 * initialized.  It does not verify that entries in the table are valid before
 * calling an interrupt handler.
@@ -99,11 +115,29 @@ void XScuGic_InterruptHandler(XScuGic *InstancePtr)
 	    u32 IntIDFull;
 #endif
 	    XScuGic_VectorTableEntry *TablePtr;
+	    u32 Serviced = 0U;
+	    u32 MaxIntr;
+#ifdef XSCUGIC_INTR_STATS
+	    XScuGic_IntrStats *StatsPtr;
+	    u32 StartCycles;
+#endif
 
 	    /* Assert that the pointer to the instance is valid
 	     */
 	    Xil_AssertVoid(InstancePtr != NULL);
 
+	    MaxIntr = InstancePtr->MaxIntrPerEntry;
+	    if (MaxIntr == 0U) {
+		MaxIntr = 1U;
+	    }
+#ifdef XSCUGIC_INTR_STATS
+	    StatsPtr = InstancePtr->IntrStatsPtr;
+	    if (StatsPtr != NULL) {
+		StatsPtr->Entries++;
+	    }
+#endif
+
+	    do {
 	    /*
 	     * Read the int_ack register to identify the highest priority
 	     * interrupt ID and make sure it is valid. Reading Int_Ack will
@@ -116,6 +150,23 @@ void XScuGic_InterruptHandler(XScuGic *InstancePtr)
 	    InterruptID = IntIDFull & XSCUGIC_ACK_INTID_MASK;
 #endif
 	    if (XSCUGIC_MAX_NUM_INTR_INPUTS <= InterruptID) {
+		/*
+		 * Nothing pending. The first read of an entry keeps the
+		 * original EOI write, later reads simply end the drain.
+		 */
+		if (Serviced == 0U) {
+#ifdef XSCUGIC_INTR_STATS
+			if (StatsPtr != NULL) {
+				StatsPtr->Spurious++;
+			}
+#endif
+#if defined (GICv3)
+			XScuGic_ack_Int(InterruptID);
+#else
+			XScuGic_CPUWriteReg(InstancePtr, XSCUGIC_EOI_OFFSET,
+						IntIDFull);
+#endif
+		}
 		goto IntrExit;
 	    }
 
@@ -139,25 +190,202 @@ void XScuGic_InterruptHandler(XScuGic *InstancePtr)
 	     * based on the IRQSource. A software trigger is cleared by
 	     *.the ACK.
 	     */
+#ifdef XSCUGIC_INTR_STATS
+	    if (StatsPtr != NULL) {
+		StartCycles = XScuGic_ReadCycleCount();
+	    }
+#endif
 	    TablePtr = &(InstancePtr->Config->HandlerTable[InterruptID]);
 		if (TablePtr != NULL) {
 			TablePtr->Handler(TablePtr->CallBackRef);
 		}
+#ifdef XSCUGIC_INTR_STATS
+	    if (StatsPtr != NULL) {
+		XScuGic_RecordDispatch(StatsPtr, InterruptID,
+				XScuGic_ReadCycleCount() - StartCycles);
+	    }
+#endif
 
-IntrExit:
 	    /*
-	     * Write to the EOI register, we are all done here.
-	     * Let this function return, the boot code will restore the stack.
+	     * Write to the EOI register, we are all done with this
+	     * interrupt.
 	     */
 #if defined (GICv3)
 	   XScuGic_ack_Int(InterruptID);
 
 #else
 	    XScuGic_CPUWriteReg(InstancePtr, XSCUGIC_EOI_OFFSET, IntIDFull);
+#endif
+	    Serviced++;
+	    } while (Serviced < MaxIntr);
+
+#ifdef XSCUGIC_INTR_STATS
+	    /*
+	     * Only count the limit as reached when it left an interrupt
+	     * pending, the highest pending register does not acknowledge it.
+	     */
+	    if (StatsPtr != NULL) {
+#if defined (GICv3)
+		InterruptID = (u32)XScuGic_get_PendIntID();
+#else
+		InterruptID = XScuGic_CPUReadReg(InstancePtr,
+				XSCUGIC_HI_PEND_OFFSET) & XSCUGIC_ACK_INTID_MASK;
+#endif
+		if (InterruptID < XSCUGIC_MAX_NUM_INTR_INPUTS) {
+			StatsPtr->CapReached++;
+		}
+	    }
+#endif
+
+IntrExit:
+#ifdef XSCUGIC_INTR_STATS
+	    if ((StatsPtr != NULL) && (Serviced > 1U)) {
+		StatsPtr->Drained += Serviced - 1U;
+	    }
 #endif
 	    /*
-	     * Return from the interrupt. Change security domains
-	     * could happen here.
+	     * Return from the interrupt, the boot code will restore the
+	     * stack. Change security domains could happen here.
 	     */
+	    return;
+}
+
+/*****************************************************************************/
+/**
+* This function sets the maximum number of interrupts XScuGic_InterruptHandler
+* services before it returns. The default is XSCUGIC_MAX_INTR_PER_ENTRY.
+*
+* @param	InstancePtr is a pointer to the XScuGic instance.
+* @param	MaxIntr is the number of interrupts to service per entry, 1
+*		services a single interrupt per exception.
+*
+* @return	None.
+*
+* @note		None.
+*
+******************************************************************************/
+void XScuGic_SetMaxIntrPerEntry(XScuGic *InstancePtr, u32 MaxIntr)
+{
+	Xil_AssertVoid(InstancePtr != NULL);
+	Xil_AssertVoid(MaxIntr != 0U);
+
+	InstancePtr->MaxIntrPerEntry = MaxIntr;
 }
+
+#ifdef XSCUGIC_INTR_STATS
+/*****************************************************************************/
+/**
+* This function attaches a statistics buffer to the instance and starts
+* collecting dispatch counters and handler cycle histograms into it. The buffer
+* is cleared and the PMU cycle counter is enabled.
+*
+* @param	InstancePtr is a pointer to the XScuGic instance.
+* @param	StatsPtr is the buffer to collect into, NULL stops collecting.
+*
+* @return	None.
+*
+* @note		The cycle counter is 32 bits wide, handler runs longer than
+*		one counter wrap are not measured correctly.
+*
+******************************************************************************/
+void XScuGic_SetIntrStats(XScuGic *InstancePtr, XScuGic_IntrStats *StatsPtr)
+{
+	u32 Index;
+	u32 Bucket;
+
+	Xil_AssertVoid(InstancePtr != NULL);
+
+	InstancePtr->IntrStatsPtr = NULL;
+	if (StatsPtr == NULL) {
+		return;
+	}
+
+	StatsPtr->Entries = 0U;
+	StatsPtr->Drained = 0U;
+	StatsPtr->CapReached = 0U;
+	StatsPtr->Spurious = 0U;
+	for (Index = 0U; Index < XSCUGIC_MAX_NUM_INTR_INPUTS; Index++) {
+		StatsPtr->Vector[Index].Count = 0U;
+		StatsPtr->Vector[Index].MaxCycles = 0U;
+		for (Bucket = 0U; Bucket < XSCUGIC_INTR_STATS_BUCKETS; Bucket++) {
+			StatsPtr->Vector[Index].Hist[Bucket] = 0U;
+		}
+	}
+
+	/* Enable the PMU and its cycle counter */
+#if defined (__aarch64__)
+	mtcp(PMCR_EL0, mfcp(PMCR_EL0) | 0x1U);
+	mtcp(PMCNTENSET_EL0, 0x80000000U);
+#elif defined (__GNUC__)
+	mtcp(XREG_CP15_PERF_MONITOR_CTRL,
+		mfcp(XREG_CP15_PERF_MONITOR_CTRL) | 0x1U);
+	mtcp(XREG_CP15_COUNT_ENABLE_SET, 0x80000000U);
+#else
+	{
+		u32 Pmcr;
+		mfcp(XREG_CP15_PERF_MONITOR_CTRL, Pmcr);
+		mtcp(XREG_CP15_PERF_MONITOR_CTRL, Pmcr | 0x1U);
+		mtcp(XREG_CP15_COUNT_ENABLE_SET, 0x80000000U);
+	}
+#endif
+	isb();
+
+	InstancePtr->IntrStatsPtr = StatsPtr;
+}
+
+/*****************************************************************************/
+/**
+* This function reads the PMU cycle counter.
+*
+* @return	Current cycle count.
+*
+* @note		None.
+*
+******************************************************************************/
+static INLINE u32 XScuGic_ReadCycleCount(void)
+{
+	u32 Cycles;
+
+#if defined (__aarch64__)
+	Cycles = (u32)mfcp(PMCCNTR_EL0);
+#elif defined (__GNUC__)
+	Cycles = mfcp(XREG_CP15_PERF_CYCLE_COUNTER);
+#else
+	mfcp(XREG_CP15_PERF_CYCLE_COUNTER, Cycles);
+#endif
+
+	return Cycles;
+}
+
+/*****************************************************************************/
+/**
+* This function adds one handler run to the statistics of an interrupt ID.
+*
+* @param	StatsPtr is the statistics buffer.
+* @param	InterruptID is the serviced interrupt ID.
+* @param	Cycles is the handler run time in PMU cycles.
+*
+* @return	None.
+*
+* @note		None.
+*
+******************************************************************************/
+static void XScuGic_RecordDispatch(XScuGic_IntrStats *StatsPtr,
+					u32 InterruptID, u32 Cycles)
+{
+	XScuGic_VectorStats *VectorPtr = &StatsPtr->Vector[InterruptID];
+	u32 Bucket = 0U;
+
+	VectorPtr->Count++;
+	if (Cycles > VectorPtr->MaxCycles) {
+		VectorPtr->MaxCycles = Cycles;
+	}
+
+	while (((Cycles >> Bucket) > 1U) &&
+		(Bucket < (XSCUGIC_INTR_STATS_BUCKETS - 1U))) {
+		Bucket++;
+	}
+	VectorPtr->Hist[Bucket]++;
+}
+#endif
 /** @} */
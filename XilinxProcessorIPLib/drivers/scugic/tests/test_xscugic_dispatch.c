@@ -0,0 +1,470 @@
+/******************************************************************************
+* Copyright (C) 2020 Xilinx, Inc.  All rights reserved.
+* SPDX-License-Identifier: MIT
+******************************************************************************/
+
+/*****************************************************************************/
+/**
+*
+* @file test_xscugic_dispatch.c
+*
+* Host test of XScuGic_InterruptHandler servicing several interrupts per
+* entry. The driver is built against a model of a GICv2 distributor and CPU
+* interface: enable and priority registers, the priority mask, pending and
+* active state, and the acknowledge, end of interrupt and highest pending
+* registers, which select the highest priority pending interrupt with the
+* lowest ID winning ties. Handlers raise further interrupts to model bursts
+* and interrupt storms.
+*
+* The test checks that interrupts are serviced in priority order within an
+* entry, including ones raised by a running handler, that the per entry
+* limit bounds the time the interrupted context is held off during a storm
+* and that lower priority interrupts are serviced once it ends, and the
+* Drained, CapReached and Spurious statistics.
+*
+* Build and run on the host:
+*   cc -Wall -O2 -I. -I../src -I../../../../lib/bsp/standalone/src/common \
+*      -I../../../../lib/bsp/standalone/src/arm/common \
+*      -I../../../../lib/bsp/standalone/src/arm/ARMv8/64bit \
+*      test_xscugic_dispatch.c -o test_xscugic_dispatch
+*   ./test_xscugic_dispatch
+*
+******************************************************************************/
+
+/***************************** Include Files *********************************/
+
+#include <stdio.h>
+#include <string.h>
+
+/* Build the standalone (non Linux) flavour of the driver */
+#undef __linux__
+#include "xil_types.h"
+#include "xparameters.h"
+#define INLINE inline
+
+/* Register accesses go to the model below */
+#define XIL_IO_H
+static u32 Xil_In32(UINTPTR Addr);
+static void Xil_Out32(UINTPTR Addr, u32 Value);
+
+#define XIL_EXCEPTION_H
+typedef void (*Xil_InterruptHandler)(void *data);
+
+/* PMU cycle counter, advanced on every read */
+#define XPSEUDO_ASM_H
+static u32 FakeCycles;
+#define mfcp(Reg)		(FakeCycles += 100U)
+#define mtcp(Reg, Val)		((void)(Val))
+#define isb()
+
+#define XSCUGIC_INTR_STATS
+#include "xscugic.c"
+#include "xscugic_intr.c"
+
+/************************** Model ********************************************/
+
+#define DIST_BASE	XPAR_SCUGIC_0_DIST_BASEADDR
+#define CPU_BASE	XPAR_SCUGIC_0_CPU_BASEADDR
+#define NUM_IDS		XSCUGIC_MAX_NUM_INTR_INPUTS
+#define SPURIOUS_ID	1023U
+
+typedef struct {
+	u32 Dist[0x1000 / 4];		/* Plain distributor registers */
+	u8 Enabled[NUM_IDS];
+	u8 Pending[NUM_IDS];
+	u8 Active[NUM_IDS];
+	u32 Pmr;
+	u32 Acks;			/* Valid acknowledges */
+	u32 Eois;
+	u32 LastEoi;
+	u32 BadEois;			/* EOI of an interrupt not active */
+} GicModel;
+
+static GicModel Model;
+
+static u32 ModelPriority(u32 Id)
+{
+	return (Model.Dist[(XSCUGIC_PRIORITY_OFFSET + Id) / 4] >>
+		((Id % 4U) * 8U)) & 0xFFU;
+}
+
+/* Highest priority pending interrupt that may preempt the active ones */
+static u32 ModelHighestPending(void)
+{
+	u32 Running = 0x100U;
+	u32 Best = SPURIOUS_ID;
+	u32 Id;
+
+	for (Id = 0U; Id < NUM_IDS; Id++) {
+		if (Model.Active[Id] && ModelPriority(Id) < Running) {
+			Running = ModelPriority(Id);
+		}
+	}
+	for (Id = 0U; Id < NUM_IDS; Id++) {
+		if (!Model.Pending[Id] || !Model.Enabled[Id] ||
+		    ModelPriority(Id) >= Model.Pmr ||
+		    ModelPriority(Id) >= Running) {
+			continue;
+		}
+		if (Best == SPURIOUS_ID ||
+		    ModelPriority(Id) < ModelPriority(Best)) {
+			Best = Id;
+		}
+	}
+	return Best;
+}
+
+static void ModelRaise(u32 Id)
+{
+	Model.Pending[Id] = 1U;
+}
+
+static u32 Xil_In32(UINTPTR Addr)
+{
+	u32 Id;
+
+	if (Addr >= CPU_BASE) {
+		switch (Addr - CPU_BASE) {
+		case XSCUGIC_INT_ACK_OFFSET:
+			Id = ModelHighestPending();
+			if (Id != SPURIOUS_ID) {
+				Model.Pending[Id] = 0U;
+				Model.Active[Id] = 1U;
+				Model.Acks++;
+			}
+			return Id;
+		case XSCUGIC_HI_PEND_OFFSET:
+			return ModelHighestPending();
+		case XSCUGIC_CPU_PRIOR_OFFSET:
+			return Model.Pmr;
+		default:
+			return 0U;
+		}
+	}
+	return Model.Dist[((Addr - DIST_BASE) & 0xFFFU) / 4];
+}
+
+static void Xil_Out32(UINTPTR Addr, u32 Value)
+{
+	u32 Offset;
+	u32 Bit;
+
+	if (Addr >= CPU_BASE) {
+		switch (Addr - CPU_BASE) {
+		case XSCUGIC_EOI_OFFSET:
+			Model.Eois++;
+			Model.LastEoi = Value & XSCUGIC_ACK_INTID_MASK;
+			if (Model.LastEoi < NUM_IDS) {
+				if (!Model.Active[Model.LastEoi]) {
+					Model.BadEois++;
+				}
+				Model.Active[Model.LastEoi] = 0U;
+			}
+			break;
+		case XSCUGIC_CPU_PRIOR_OFFSET:
+			Model.Pmr = Value & 0xFFU;
+			break;
+		default:
+			break;
+		}
+		return;
+	}
+
+	Offset = (Addr - DIST_BASE) & 0xFFFU;
+	if (Offset >= XSCUGIC_ENABLE_SET_OFFSET &&
+	    Offset < XSCUGIC_DISABLE_OFFSET + 0x80U) {
+		for (Bit = 0U; Bit < 32U; Bit++) {
+			u32 Id = ((Offset & 0x7FU) / 4U) * 32U + Bit;
+
+			if ((Value & (1U << Bit)) && Id < NUM_IDS) {
+				Model.Enabled[Id] =
+					(Offset < XSCUGIC_DISABLE_OFFSET);
+			}
+		}
+		return;
+	}
+	Model.Dist[Offset / 4] = Value;
+}
+
+/************************** Stubs ********************************************/
+
+u32 Xil_AssertStatus;
+s32 Xil_AssertWait;
+
+void Xil_Assert(const char8 *File, s32 Line)
+{
+	printf("ASSERT %s:%d\n", File, (int)Line);
+}
+
+/************************** Test Helpers *************************************/
+
+static u32 Failures;
+
+#define CHECK(Cond, Msg) \
+	do { \
+		if (!(Cond)) { \
+			printf("FAIL line %d: %s\n", __LINE__, Msg); \
+			Failures++; \
+		} \
+	} while (0)
+
+#define MAX_LOG		256
+
+static XScuGic Gic;
+static XScuGic_IntrStats Stats;
+static XScuGic_Config Config = {
+	.DeviceId = XPAR_SCUGIC_0_DEVICE_ID,
+	.CpuBaseAddress = XPAR_SCUGIC_0_CPU_BASEADDR,
+	.DistBaseAddress = XPAR_SCUGIC_0_DIST_BASEADDR,
+};
+
+static u32 Log[MAX_LOG];
+static u32 LogLen;
+/* Interrupts raised by a handler: Raise[Id] while RaiseCount[Id] lasts */
+static u32 Raise[NUM_IDS];
+static u32 RaiseCount[NUM_IDS];
+
+static void Handler(void *CallBackRef)
+{
+	u32 Id = (u32)(UINTPTR)CallBackRef;
+
+	if (LogLen < MAX_LOG) {
+		Log[LogLen] = Id;
+	}
+	LogLen++;
+	if (RaiseCount[Id] != 0U) {
+		RaiseCount[Id]--;
+		ModelRaise(Raise[Id]);
+	}
+}
+
+static void Setup(u32 MaxIntr)
+{
+	memset(&Model, 0, sizeof(Model));
+	memset(&Gic, 0, sizeof(Gic));
+	memset(Config.HandlerTable, 0, sizeof(Config.HandlerTable));
+	memset(RaiseCount, 0, sizeof(RaiseCount));
+	LogLen = 0U;
+
+	CHECK(XScuGic_CfgInitialize(&Gic, &Config, 0U) == XST_SUCCESS,
+	      "initialize");
+	CHECK(Gic.MaxIntrPerEntry == XSCUGIC_MAX_INTR_PER_ENTRY,
+	      "default limit");
+	XScuGic_SetMaxIntrPerEntry(&Gic, MaxIntr);
+	XScuGic_SetIntrStats(&Gic, &Stats);
+}
+
+static void Connect(u32 Id, u8 Priority)
+{
+	XScuGic_Connect(&Gic, Id, Handler, (void *)(UINTPTR)Id);
+	XScuGic_SetPriorityTriggerType(&Gic, Id, Priority, 0x3U);
+	XScuGic_Enable(&Gic, Id);
+}
+
+static int LogIs(const u32 *Expected, u32 Count)
+{
+	return LogLen == Count &&
+		memcmp(Log, Expected, Count * sizeof(Expected[0])) == 0;
+}
+
+static void PrintLog(const char *Name)
+{
+	u32 Index;
+
+	printf("%s:", Name);
+	for (Index = 0U; Index < LogLen && Index < MAX_LOG; Index++) {
+		printf(" %u", Log[Index]);
+	}
+	printf("\n");
+}
+
+/************************** Tests ********************************************/
+
+/* A burst is serviced in one entry, highest priority first */
+static void TestPriorityOrder(void)
+{
+	static const u32 Expected[] = { 41, 42, 43, 40, 44 };
+
+	Setup(8U);
+	Connect(40, 0xA0);
+	Connect(41, 0x20);
+	Connect(42, 0x60);
+	Connect(43, 0x60);
+	Connect(44, 0xC8);
+	ModelRaise(44);
+	ModelRaise(43);
+	ModelRaise(42);
+	ModelRaise(41);
+	ModelRaise(40);
+
+	XScuGic_InterruptHandler(&Gic);
+	if (!LogIs(Expected, 5U)) {
+		PrintLog("priority order");
+		CHECK(0, "burst not serviced in priority order");
+	}
+	CHECK(Model.Acks == 5U && Model.Eois == 5U && Model.BadEois == 0U,
+	      "acknowledge and end of interrupt pairs");
+	CHECK(Stats.Entries == 1U && Stats.Drained == 4U, "drained count");
+	CHECK(Stats.CapReached == 0U, "limit not reached");
+	CHECK(Stats.Spurious == 0U, "no spurious entry");
+	CHECK(Stats.Vector[41].Count == 1U && Stats.Vector[40].Count == 1U,
+	      "per vector counts");
+	CHECK(Stats.Vector[41].MaxCycles == 100U, "handler cycles");
+}
+
+/* An interrupt raised by a handler is serviced in the same entry, in
+ * priority order with the ones already pending */
+static void TestRaisedInHandler(void)
+{
+	static const u32 Expected[] = { 50, 51, 53, 52 };
+
+	Setup(8U);
+	Connect(50, 0x80);
+	Connect(51, 0x40);
+	Connect(52, 0xC0);
+	Connect(53, 0xA0);
+	Raise[50] = 51;
+	RaiseCount[50] = 1U;
+	Raise[51] = 52;
+	RaiseCount[51] = 1U;
+	ModelRaise(50);
+	ModelRaise(53);
+
+	XScuGic_InterruptHandler(&Gic);
+	if (!LogIs(Expected, 4U)) {
+		PrintLog("raised in handler");
+		CHECK(0, "raised interrupts not serviced in priority order");
+	}
+	CHECK(Stats.Entries == 1U && Stats.Drained == 3U, "drained count");
+}
+
+/* The limit is only counted as reached when it leaves work pending */
+static void TestCapReached(void)
+{
+	u32 Id;
+
+	Setup(4U);
+	for (Id = 60U; Id < 66U; Id++) {
+		Connect(Id, 0x80);
+		ModelRaise(Id);
+	}
+	XScuGic_InterruptHandler(&Gic);
+	CHECK(LogLen == 4U, "limit of 4 per entry");
+	CHECK(Stats.CapReached == 1U, "limit reached with 2 pending");
+	XScuGic_InterruptHandler(&Gic);
+	CHECK(LogLen == 6U, "rest serviced by the next entry");
+	CHECK(Stats.CapReached == 1U, "limit not reached by the second entry");
+	CHECK(Stats.Spurious == 0U, "drain end is not spurious");
+	CHECK(Stats.Drained == 4U, "drained count");
+
+	/* Exactly as many interrupts as the limit */
+	Setup(4U);
+	for (Id = 60U; Id < 64U; Id++) {
+		Connect(Id, 0x80);
+		ModelRaise(Id);
+	}
+	XScuGic_InterruptHandler(&Gic);
+	CHECK(LogLen == 4U, "all 4 serviced");
+	CHECK(Stats.CapReached == 0U, "limit reached with nothing pending");
+	CHECK(Model.Acks == 4U, "highest pending read acknowledged");
+
+	/* One per entry, as before the limit existed */
+	Setup(1U);
+	for (Id = 60U; Id < 63U; Id++) {
+		Connect(Id, 0x80);
+		ModelRaise(Id);
+	}
+	for (Id = 0U; Id < 3U; Id++) {
+		XScuGic_InterruptHandler(&Gic);
+		CHECK(LogLen == Id + 1U, "one interrupt per entry");
+	}
+	CHECK(Stats.Drained == 0U, "nothing drained");
+	CHECK(Stats.CapReached == 2U, "limit reached while 2 and 1 pending");
+	CHECK(Model.Eois == 3U && Model.BadEois == 0U, "one EOI per entry");
+
+	/* An instance set up without XScuGic_CfgInitialize has no limit set */
+	Setup(4U);
+	Gic.MaxIntrPerEntry = 0U;
+	Connect(60, 0x80);
+	Connect(61, 0x80);
+	ModelRaise(60);
+	ModelRaise(61);
+	XScuGic_InterruptHandler(&Gic);
+	CHECK(LogLen == 1U, "no limit set services one per entry");
+}
+
+/* A handler that keeps raising its own interrupt holds the CPU for at most
+ * the limit per entry, and lower priority interrupts run once it stops */
+static void TestStorm(void)
+{
+	u32 Entry;
+	u32 Before;
+	u32 MaxPerEntry = 0U;
+	u32 Index;
+	u32 LowAt = MAX_LOG;
+
+	Setup(5U);
+	Connect(70, 0x40);
+	Connect(71, 0x40);
+	Connect(72, 0x90);
+	Raise[70] = 70;
+	RaiseCount[70] = 22U;
+	ModelRaise(70);
+	ModelRaise(71);
+	ModelRaise(72);
+
+	for (Entry = 0U; Entry < 10U && (Model.Pending[70] ||
+		Model.Pending[71] || Model.Pending[72]); Entry++) {
+		Before = LogLen;
+		XScuGic_InterruptHandler(&Gic);
+		if (LogLen - Before > MaxPerEntry) {
+			MaxPerEntry = LogLen - Before;
+		}
+	}
+	CHECK(MaxPerEntry == 5U, "entry held the CPU beyond the limit");
+	CHECK(LogLen == 25U, "storm, equal and low priority serviced");
+	CHECK(Entry == 5U, "entries to drain the storm");
+	CHECK(Stats.CapReached == 4U, "every full entry left work pending");
+	for (Index = 0U; Index < LogLen && Index < MAX_LOG; Index++) {
+		if (Log[Index] == 72U) {
+			LowAt = Index;
+		}
+	}
+	/* Equal priority ties go to the lower ID, then lower priority */
+	CHECK(LowAt == 24U && Log[23] == 71U,
+	      "low priority interrupt serviced after the storm");
+	CHECK(Stats.Vector[70].Count == 23U, "storm vector count");
+}
+
+/* An entry finding nothing is spurious and ends with the original EOI */
+static void TestSpurious(void)
+{
+	Setup(8U);
+	Connect(80, 0x80);
+	XScuGic_InterruptHandler(&Gic);
+	CHECK(LogLen == 0U, "nothing serviced");
+	CHECK(Stats.Spurious == 1U, "spurious entry counted");
+	CHECK(Model.Eois == 1U && Model.LastEoi == SPURIOUS_ID,
+	      "spurious ID written back");
+
+	/* An enabled interrupt without a handler goes to the stub */
+	Model.Enabled[81] = 1U;
+	Model.Dist[(XSCUGIC_PRIORITY_OFFSET + 81U) / 4U] = 0x80U << 8;
+	ModelRaise(81);
+	XScuGic_InterruptHandler(&Gic);
+	CHECK(Gic.UnhandledInterrupts == 1U, "unhandled interrupt counted");
+	CHECK(Stats.Spurious == 1U && Stats.Drained == 0U,
+	      "unhandled interrupt is not spurious");
+}
+
+int main(void)
+{
+	TestPriorityOrder();
+	TestRaisedInHandler();
+	TestCapReached();
+	TestStorm();
+	TestSpurious();
+
+	printf("%s (%u failures)\n", Failures ? "FAILED" : "PASSED", Failures);
+	return Failures ? 1 : 0;
+}
@@ -0,0 +1,20 @@
+/******************************************************************************
+* Copyright (C) 2020 Xilinx, Inc.  All rights reserved.
+* SPDX-License-Identifier: MIT
+******************************************************************************/
+
+/*
+ * Hardware parameters of the modelled GIC used by the host tests: a GICv2
+ * distributor and CPU interface as on Zynq UltraScale+ MPSoC
+ */
+#ifndef XPARAMETERS_H
+#define XPARAMETERS_H
+
+#define XPAR_CPU_ID			0U
+#define XPAR_SCUGIC_NUM_INSTANCES	1U
+#define XPAR_SCUGIC_0_DEVICE_ID		0U
+#define XPAR_SCUGIC_0_CPU_BASEADDR	0xF9020000U
+#define XPAR_SCUGIC_0_DIST_BASEADDR	0xF9010000U
+#define XPS_EFUSE_BASEADDR		0xF800D000U
+
+#endif
@@ -138,6 +138,7 @@ s32 XUartPs_CfgInitialize(XUartPs *InstancePtr,
 	InstancePtr->Platform = XGetPlatform_Info();
 
 	InstancePtr->is_rxbs_error = 0U;
+	InstancePtr->RingPtr = NULL;
 
 	/* Flag that the driver instance is ready to use */
 	InstancePtr->IsReady = XIL_COMPONENT_IS_READY;
@@ -555,6 +556,11 @@ s32 XUartPs_SetBaudRate(XUartPs *InstancePtr, u32 BaudRate)
 		/* Calculate the value for BRGR register */
 		BRGR_Value = InputClk / (BaudRate * (IterBAUDDIV + 1));
 
+		/* Larger dividers leave no BRGR value for this rate */
+		if (BRGR_Value == (u32)0) {
+			break;
+		}
+
 		/* Calculate the baud rate from the BRGR value */
 		CalcBaudRate = InputClk/ (BRGR_Value * (IterBAUDDIV + 1));
 
@@ -598,6 +604,11 @@ s32 XUartPs_SetBaudRate(XUartPs *InstancePtr, u32 BaudRate)
 
 	InstancePtr->BaudRate = BaudRate;
 
+	/* Keep the ring layer RX trigger level matched to the new rate */
+	if (InstancePtr->RingPtr != NULL) {
+		XUartPs_RingTuneRxTrigger(InstancePtr);
+	}
+
 	return XST_SUCCESS;
 
 }
@@ -261,6 +261,28 @@ extern "C" {
 
 /*@}*/
 
+/** @name Ring buffer layer
+ *
+ * These constants are used by the optional ring buffer layer in
+ * xuartps_ring.c.
+ *
+ * @{
+ */
+#define XUARTPS_FIFO_SIZE		64U /**< Depth of the TX and RX FIFOs */
+#define XUARTPS_RING_RX_LATENCY_US	100U /**< Worst case interrupt latency
+					       *  the RX trigger level leaves
+					       *  room for in the RX FIFO */
+#define XUARTPS_RING_RX_TRIG_MAX	56U /**< Highest RX trigger level */
+#define XUARTPS_RING_RX_TOUT		4U  /**< RX timeout value, see
+					      *  XUartPs_SetRecvTimeout() */
+#define XUARTPS_RING_IXR_MASK	((u32)XUARTPS_IXR_RXOVR | \
+				 (u32)XUARTPS_IXR_RXFULL | \
+				 (u32)XUARTPS_IXR_TOUT | \
+				 (u32)XUARTPS_IXR_TXEMPTY | \
+				 (u32)XUARTPS_IXR_TXFULL)
+				/**< Interrupts handled by the ring layer */
+/*@}*/
+
 
 /**************************** Type Definitions ******************************/
 
@@ -295,6 +317,26 @@ typedef struct {
 	u8 StopBits;	/**< Number of stop bits */
 } XUartPsFormat;
 
+/**
+ * Keep track of the TX and RX rings of the optional ring buffer layer. The
+ * ring sizes must be powers of 2; the Head and Tail indices are free running
+ * and are masked with the size when the buffers are accessed.
+ */
+typedef struct {
+	u8 *TxBufPtr;		/**< TX ring storage */
+	u32 TxSize;		/**< TX ring size in bytes */
+	volatile u32 TxHead;	/**< Written by XUartPs_RingWrite() */
+	volatile u32 TxTail;	/**< Advanced as bytes enter the TX FIFO */
+	u8 *RxBufPtr;		/**< RX ring storage */
+	u32 RxSize;		/**< RX ring size in bytes */
+	volatile u32 RxHead;	/**< Advanced by the interrupt handler */
+	volatile u32 RxTail;	/**< Written by XUartPs_RingRead() */
+	u32 RxDropped;		/**< Bytes dropped because the RX ring was full */
+	u32 IntrCount;		/**< Data interrupts handled by the ring layer */
+	u32 TxBytes;		/**< Bytes moved into the TX FIFO */
+	u32 RxBytes;		/**< Bytes moved out of the RX FIFO */
+} XUartPsRing;
+
 /******************************************************************************/
 /**
  * This data type defines a handler that an application defines to communicate
@@ -332,6 +374,7 @@ typedef struct {
 	void *CallBackRef;	/* Callback reference for event handler */
 	u32 Platform;
 	u8 is_rxbs_error;
+	XUartPsRing *RingPtr;	/* Ring buffer layer, NULL if not used */
 } XUartPs;
 
 
@@ -493,6 +536,19 @@ void XUartPs_InterruptHandler(XUartPs *InstancePtr);
 void XUartPs_SetHandler(XUartPs *InstancePtr, XUartPs_Handler FuncPtr,
 			 void *CallBackRef);
 
+/* Ring buffer functions in xuartps_ring.c */
+s32 XUartPs_RingInitialize(XUartPs *InstancePtr, XUartPsRing *RingPtr,
+			u8 *TxBufPtr, u32 TxSize, u8 *RxBufPtr, u32 RxSize);
+
+u32 XUartPs_RingWrite(XUartPs *InstancePtr, const u8 *BufferPtr,
+			u32 NumBytes);
+
+u32 XUartPs_RingRead(XUartPs *InstancePtr, u8 *BufferPtr, u32 NumBytes);
+
+u32 XUartPs_RingRxCount(XUartPs *InstancePtr);
+
+void XUartPs_RingTuneRxTrigger(XUartPs *InstancePtr);
+
 /* self-test functions in xuartps_selftest.c */
 s32 XUartPs_SelfTest(XUartPs *InstancePtr);
 
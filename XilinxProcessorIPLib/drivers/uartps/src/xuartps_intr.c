@@ -48,6 +48,9 @@ static void ModemHandler(XUartPs *InstancePtr);
 extern u32 XUartPs_ReceiveBuffer(XUartPs *InstancePtr);
 extern u32 XUartPs_SendBuffer(XUartPs *InstancePtr);
 
+/* Internal function prototype implemented in xuartps_ring.c */
+extern u32 XUartPs_RingHandler(XUartPs *InstancePtr, u32 IsrStatus);
+
 /************************** Variable Definitions ****************************/
 
 typedef void (*Handler)(XUartPs *InstancePtr);
@@ -173,6 +176,11 @@ void XUartPs_InterruptHandler(XUartPs *InstancePtr)
 	IsrStatus &= XUartPs_ReadReg(InstancePtr->Config.BaseAddress,
 				   XUARTPS_ISR_OFFSET);
 
+	/* The ring buffer layer, if used, services the data interrupts */
+	if (InstancePtr->RingPtr != NULL) {
+		IsrStatus = XUartPs_RingHandler(InstancePtr, IsrStatus);
+	}
+
 	/* Dispatch an appropriate handler. */
 	if((IsrStatus & ((u32)XUARTPS_IXR_RXOVR | (u32)XUARTPS_IXR_RXEMPTY |
 			(u32)XUARTPS_IXR_RXFULL)) != (u32)0) {
@@ -0,0 +1,404 @@
+/******************************************************************************
+* Copyright (C) 2010 - 2020 Xilinx, Inc.  All rights reserved.
+* SPDX-License-Identifier: MIT
+******************************************************************************/
+
+/****************************************************************************/
+/**
+*
+* @file xuartps_ring.c
+* @addtogroup uartps_v3_10
+* @{
+*
+* This file contains an optional ring buffer layer for the XUartPs driver.
+* Once XUartPs_RingInitialize() has attached a TX and an RX ring to an
+* instance, XUartPs_RingWrite() and XUartPs_RingRead() only copy to and from
+* the rings and never wait for the device. XUartPs_InterruptHandler() then
+* refills the TX FIFO from the TX ring each time it runs empty, and drains
+* the RX FIFO into the RX ring on the RX trigger and RX timeout interrupts.
+* The RX trigger level is derived from the baud rate so that the FIFO has
+* room for XUARTPS_RING_RX_LATENCY_US of traffic when the interrupt fires.
+*
+*****************************************************************************/
+
+/***************************** Include Files ********************************/
+
+#include "xuartps.h"
+
+/************************** Constant Definitions ****************************/
+
+/**************************** Type Definitions ******************************/
+
+/***************** Macros (Inline Functions) Definitions ********************/
+
+/************************** Function Prototypes *****************************/
+
+u32 XUartPs_RingHandler(XUartPs *InstancePtr, u32 IsrStatus);
+
+static u32 XUartPs_RingFillTxFifo(XUartPs *InstancePtr);
+static u32 XUartPs_RingDrainRxFifo(XUartPs *InstancePtr);
+
+/************************** Variable Definitions ****************************/
+
+/****************************************************************************/
+/**
+*
+* This function attaches a TX and an RX ring to the instance and enables the
+* interrupts the ring layer needs: the RX trigger, RX FIFO full and RX timeout
+* interrupts. The TX FIFO empty interrupt is enabled while the TX ring holds
+* data. The RX trigger level and the RX timeout are set for the current baud
+* rate.
+*
+* @param	InstancePtr is a pointer to the XUartPs instance.
+* @param	RingPtr is a pointer to the ring state to attach.
+* @param	TxBufPtr is the TX ring storage.
+* @param	TxSize is the size of the TX ring, a power of 2.
+* @param	RxBufPtr is the RX ring storage.
+* @param	RxSize is the size of the RX ring, a power of 2.
+*
+* @return
+*		- XST_SUCCESS if the rings were attached.
+*		- XST_INVALID_PARAM if a ring size is not a power of 2.
+*
+* @note		A handler must be set with XUartPs_SetHandler(). It is called
+*		with XUARTPS_EVENT_RECV_DATA and the number of bytes added
+*		when data was added to the RX ring, and with
+*		XUARTPS_EVENT_SENT_DATA and the total number of bytes sent
+*		when the TX ring became empty. The ring counters IntrCount,
+*		TxBytes and RxBytes give the bytes moved per interrupt.
+*
+*****************************************************************************/
+s32 XUartPs_RingInitialize(XUartPs *InstancePtr, XUartPsRing *RingPtr,
+			u8 *TxBufPtr, u32 TxSize, u8 *RxBufPtr, u32 RxSize)
+{
+	u32 ImrRegister;
+
+	Xil_AssertNonvoid(InstancePtr != NULL);
+	Xil_AssertNonvoid(InstancePtr->IsReady == XIL_COMPONENT_IS_READY);
+	Xil_AssertNonvoid(RingPtr != NULL);
+	Xil_AssertNonvoid(TxBufPtr != NULL);
+	Xil_AssertNonvoid(RxBufPtr != NULL);
+
+	if ((TxSize == 0U) || ((TxSize & (TxSize - 1U)) != 0U) ||
+	    (RxSize == 0U) || ((RxSize & (RxSize - 1U)) != 0U)) {
+		return (s32)XST_INVALID_PARAM;
+	}
+
+	/* Keep the interrupt handler away from the rings while they change */
+	XUartPs_WriteReg(InstancePtr->Config.BaseAddress, XUARTPS_IDR_OFFSET,
+			XUARTPS_RING_IXR_MASK);
+
+	RingPtr->TxBufPtr = TxBufPtr;
+	RingPtr->TxSize = TxSize;
+	RingPtr->TxHead = 0U;
+	RingPtr->TxTail = 0U;
+	RingPtr->RxBufPtr = RxBufPtr;
+	RingPtr->RxSize = RxSize;
+	RingPtr->RxHead = 0U;
+	RingPtr->RxTail = 0U;
+	RingPtr->RxDropped = 0U;
+	RingPtr->IntrCount = 0U;
+	RingPtr->TxBytes = 0U;
+	RingPtr->RxBytes = 0U;
+	InstancePtr->RingPtr = RingPtr;
+
+	XUartPs_RingTuneRxTrigger(InstancePtr);
+	XUartPs_SetRecvTimeout(InstancePtr, (u8)XUARTPS_RING_RX_TOUT);
+
+	ImrRegister = XUartPs_ReadReg(InstancePtr->Config.BaseAddress,
+				XUARTPS_IMR_OFFSET);
+	XUartPs_WriteReg(InstancePtr->Config.BaseAddress, XUARTPS_IER_OFFSET,
+			ImrRegister | (u32)XUARTPS_IXR_RXOVR |
+			(u32)XUARTPS_IXR_RXFULL | (u32)XUARTPS_IXR_TOUT);
+
+	return (s32)XST_SUCCESS;
+}
+
+/****************************************************************************/
+/**
+*
+* This function copies data into the TX ring and makes sure the transmitter
+* is running. It does not wait for the data to be sent.
+*
+* @param	InstancePtr is a pointer to the XUartPs instance.
+* @param	BufferPtr is a pointer to the data to send.
+* @param	NumBytes is the number of bytes to send.
+*
+* @return	The number of bytes accepted, less than NumBytes if the TX ring
+*		did not have room for all of them.
+*
+* @note		None.
+*
+*****************************************************************************/
+u32 XUartPs_RingWrite(XUartPs *InstancePtr, const u8 *BufferPtr,
+			u32 NumBytes)
+{
+	XUartPsRing *RingPtr;
+	u32 Head;
+	u32 Space;
+	u32 Count;
+
+	Xil_AssertNonvoid(InstancePtr != NULL);
+	Xil_AssertNonvoid(InstancePtr->RingPtr != NULL);
+	Xil_AssertNonvoid((BufferPtr != NULL) || (NumBytes == 0U));
+
+	RingPtr = InstancePtr->RingPtr;
+	Head = RingPtr->TxHead;
+	Space = RingPtr->TxSize - (Head - RingPtr->TxTail);
+	if (NumBytes < Space) {
+		Space = NumBytes;
+	}
+
+	for (Count = 0U; Count < Space; Count++) {
+		RingPtr->TxBufPtr[(Head + Count) & (RingPtr->TxSize - 1U)] =
+			BufferPtr[Count];
+	}
+	RingPtr->TxHead = Head + Count;
+
+	if (Count != 0U) {
+		/*
+		 * Mask the TX interrupt so the handler cannot disable it
+		 * behind our back, top up the FIFO and let the TX FIFO empty
+		 * interrupt carry on with the rest of the ring.
+		 */
+		XUartPs_WriteReg(InstancePtr->Config.BaseAddress,
+				XUARTPS_IDR_OFFSET, (u32)XUARTPS_IXR_TXEMPTY);
+		(void)XUartPs_RingFillTxFifo(InstancePtr);
+		XUartPs_WriteReg(InstancePtr->Config.BaseAddress,
+				XUARTPS_IER_OFFSET, (u32)XUARTPS_IXR_TXEMPTY);
+	}
+
+	return Count;
+}
+
+/****************************************************************************/
+/**
+*
+* This function copies received data out of the RX ring. It does not wait
+* for data to arrive.
+*
+* @param	InstancePtr is a pointer to the XUartPs instance.
+* @param	BufferPtr is a pointer to the buffer to copy the data to.
+* @param	NumBytes is the size of the buffer.
+*
+* @return	The number of bytes copied.
+*
+* @note		None.
+*
+*****************************************************************************/
+u32 XUartPs_RingRead(XUartPs *InstancePtr, u8 *BufferPtr, u32 NumBytes)
+{
+	XUartPsRing *RingPtr;
+	u32 Tail;
+	u32 Avail;
+	u32 Count;
+
+	Xil_AssertNonvoid(InstancePtr != NULL);
+	Xil_AssertNonvoid(InstancePtr->RingPtr != NULL);
+	Xil_AssertNonvoid((BufferPtr != NULL) || (NumBytes == 0U));
+
+	RingPtr = InstancePtr->RingPtr;
+	Tail = RingPtr->RxTail;
+	Avail = RingPtr->RxHead - Tail;
+	if (NumBytes < Avail) {
+		Avail = NumBytes;
+	}
+
+	for (Count = 0U; Count < Avail; Count++) {
+		BufferPtr[Count] =
+			RingPtr->RxBufPtr[(Tail + Count) & (RingPtr->RxSize - 1U)];
+	}
+	RingPtr->RxTail = Tail + Count;
+
+	return Count;
+}
+
+/****************************************************************************/
+/**
+*
+* This function returns the number of bytes waiting in the RX ring.
+*
+* @param	InstancePtr is a pointer to the XUartPs instance.
+*
+* @return	The number of bytes that XUartPs_RingRead() can return.
+*
+* @note		None.
+*
+*****************************************************************************/
+u32 XUartPs_RingRxCount(XUartPs *InstancePtr)
+{
+	Xil_AssertNonvoid(InstancePtr != NULL);
+	Xil_AssertNonvoid(InstancePtr->RingPtr != NULL);
+
+	return InstancePtr->RingPtr->RxHead - InstancePtr->RingPtr->RxTail;
+}
+
+/****************************************************************************/
+/**
+*
+* This function sets the RX FIFO trigger level for the current baud rate. The
+* level leaves enough free FIFO entries for the characters that arrive in
+* XUARTPS_RING_RX_LATENCY_US, so that fast rates interrupt early enough not
+* to overrun and slow rates interrupt once per many bytes. The RX timeout
+* interrupt collects the bytes below the trigger level at the end of a burst.
+*
+* @param	InstancePtr is a pointer to the XUartPs instance.
+*
+* @return	None.
+*
+* @note		XUartPs_SetBaudRate() calls this function when a ring is
+*		attached.
+*
+*****************************************************************************/
+void XUartPs_RingTuneRxTrigger(XUartPs *InstancePtr)
+{
+	u32 Headroom;
+	u32 TriggerLevel;
+
+	Xil_AssertVoid(InstancePtr != NULL);
+	Xil_AssertVoid(InstancePtr->IsReady == XIL_COMPONENT_IS_READY);
+
+	/* Characters received during the latency, 10 bits per character */
+	Headroom = ((InstancePtr->BaudRate / 10U) *
+			XUARTPS_RING_RX_LATENCY_US) / 1000000U + 1U;
+
+	if (Headroom >= (XUARTPS_FIFO_SIZE - 1U)) {
+		TriggerLevel = 1U;
+	} else {
+		TriggerLevel = XUARTPS_FIFO_SIZE - Headroom;
+	}
+	if (TriggerLevel > XUARTPS_RING_RX_TRIG_MAX) {
+		TriggerLevel = XUARTPS_RING_RX_TRIG_MAX;
+	}
+
+	XUartPs_SetFifoThreshold(InstancePtr, (u8)TriggerLevel);
+}
+
+/****************************************************************************/
+/*
+*
+* This function services the data interrupts for an instance with a ring
+* attached. It is called by XUartPs_InterruptHandler().
+*
+* @param	InstancePtr is a pointer to the XUartPs instance.
+* @param	IsrStatus is the pending and enabled interrupt status.
+*
+* @return	IsrStatus without the interrupts serviced here, which have
+*		been cleared.
+*
+* @note		None.
+*
+*****************************************************************************/
+u32 XUartPs_RingHandler(XUartPs *InstancePtr, u32 IsrStatus)
+{
+	XUartPsRing *RingPtr = InstancePtr->RingPtr;
+	u32 Count;
+
+	if ((IsrStatus & XUARTPS_RING_IXR_MASK) == (u32)0) {
+		return IsrStatus;
+	}
+	RingPtr->IntrCount++;
+
+	if ((IsrStatus & ((u32)XUARTPS_IXR_RXOVR | (u32)XUARTPS_IXR_RXFULL |
+			(u32)XUARTPS_IXR_TOUT)) != (u32)0) {
+		Count = XUartPs_RingDrainRxFifo(InstancePtr);
+		if (Count != (u32)0) {
+			InstancePtr->Handler(InstancePtr->CallBackRef,
+					XUARTPS_EVENT_RECV_DATA, Count);
+		}
+	}
+
+	if ((IsrStatus & (u32)XUARTPS_IXR_TXEMPTY) != (u32)0) {
+		if (RingPtr->TxHead == RingPtr->TxTail) {
+			/* Nothing left to send, stop the empty interrupt */
+			XUartPs_WriteReg(InstancePtr->Config.BaseAddress,
+					XUARTPS_IDR_OFFSET,
+					((u32)XUARTPS_IXR_TXEMPTY |
+					(u32)XUARTPS_IXR_TXFULL));
+			InstancePtr->Handler(InstancePtr->CallBackRef,
+					XUARTPS_EVENT_SENT_DATA, RingPtr->TxBytes);
+		} else {
+			(void)XUartPs_RingFillTxFifo(InstancePtr);
+		}
+	}
+
+	XUartPs_WriteReg(InstancePtr->Config.BaseAddress, XUARTPS_ISR_OFFSET,
+			IsrStatus & XUARTPS_RING_IXR_MASK);
+
+	return IsrStatus & ~XUARTPS_RING_IXR_MASK;
+}
+
+/****************************************************************************/
+/*
+*
+* This function moves bytes from the TX ring into the TX FIFO until the FIFO
+* is full or the ring is empty.
+*
+* @param	InstancePtr is a pointer to the XUartPs instance.
+*
+* @return	The number of bytes moved.
+*
+* @note		None.
+*
+*****************************************************************************/
+static u32 XUartPs_RingFillTxFifo(XUartPs *InstancePtr)
+{
+	XUartPsRing *RingPtr = InstancePtr->RingPtr;
+	u32 Tail = RingPtr->TxTail;
+	u32 Head = RingPtr->TxHead;
+	u32 Count = 0U;
+
+	while ((Tail != Head) &&
+	       (!XUartPs_IsTransmitFull(InstancePtr->Config.BaseAddress))) {
+		XUartPs_WriteReg(InstancePtr->Config.BaseAddress,
+				XUARTPS_FIFO_OFFSET,
+				(u32)RingPtr->TxBufPtr[Tail &
+						(RingPtr->TxSize - 1U)]);
+		Tail++;
+		Count++;
+	}
+	RingPtr->TxTail = Tail;
+	RingPtr->TxBytes += Count;
+
+	return Count;
+}
+
+/****************************************************************************/
+/*
+*
+* This function moves all bytes in the RX FIFO into the RX ring. Bytes that
+* do not fit in the ring are read and counted as dropped, so the FIFO does not
+* overrun and the interrupt condition is cleared.
+*
+* @param	InstancePtr is a pointer to the XUartPs instance.
+*
+* @return	The number of bytes added to the RX ring.
+*
+* @note		None.
+*
+*****************************************************************************/
+static u32 XUartPs_RingDrainRxFifo(XUartPs *InstancePtr)
+{
+	XUartPsRing *RingPtr = InstancePtr->RingPtr;
+	u32 Head = RingPtr->RxHead;
+	u32 Count = 0U;
+	u32 Data;
+
+	while (XUartPs_IsReceiveData(InstancePtr->Config.BaseAddress)) {
+		Data = XUartPs_ReadReg(InstancePtr->Config.BaseAddress,
+				XUARTPS_FIFO_OFFSET);
+		if ((Head - RingPtr->RxTail) < RingPtr->RxSize) {
+			RingPtr->RxBufPtr[Head & (RingPtr->RxSize - 1U)] =
+				(u8)Data;
+			Head++;
+			Count++;
+		} else {
+			RingPtr->RxDropped++;
+		}
+	}
+	RingPtr->RxHead = Head;
+	RingPtr->RxBytes += Count;
+
+	return Count;
+}
+/** @} */
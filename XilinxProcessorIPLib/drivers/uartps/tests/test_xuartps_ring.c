@@ -0,0 +1,885 @@
+/******************************************************************************
+* Copyright (C) 2020 Xilinx, Inc.  All rights reserved.
+* SPDX-License-Identifier: MIT
+******************************************************************************/
+
+/*****************************************************************************/
+/**
+*
+* @file test_xuartps_ring.c
+*
+* Host test of the XUartPs ring buffer layer against a register model of the
+* UART with its 64-byte TX and RX FIFOs. The model derives the character time
+* from BAUDGEN and BAUDDIV at 8N1, receives characters from a remote sender
+* into the RX FIFO, where a character arriving at a full FIFO is lost and
+* raises the overrun status, and shifts the TX FIFO out on the line, logging
+* every character sent. Interrupt status bits are sticky and cleared by
+* writing 1: the RX trigger, RX full and TX empty conditions are set when
+* they start and set again by a clear while they still hold, the RX timeout
+* fires once when RXTOUT * 4 bit times pass without a character received or
+* a FIFO read while the RX FIFO holds data. Reading the empty RX FIFO and
+* writing the full TX FIFO are model errors.
+*
+* Time is simulated. Register accesses cost a fixed time, the CPU takes
+* interrupts with a fixed entry cost and runs an application task every
+* millisecond that copies the received data out of the ring and checks it.
+* Each task run first masks interrupts for 80 us, close to the
+* XUARTPS_RING_RX_LATENCY_US the trigger level is derived from.
+*
+* The receive tests stream bursts of data at 115200, 921600 and 3125000
+* baud, with burst lengths that are not multiples of the trigger level, and
+* check that every byte arrives once, in order, with no FIFO overrun and the
+* tail of each burst delivered by the RX timeout. The same traffic is run
+* with a fixed trigger level of 56, which must overrun at 3125000 baud, and
+* of 8, which must take several times more interrupts per byte at 115200
+* baud. The transmit test queues bursts of messages with
+* XUartPs_RingWrite() and checks that the line carries them intact and back
+* to back without the producer waiting, compared with XUartPs_Send(), which
+* has to wait for each message to finish before taking the next. Both rings
+* are also filled: a full RX ring must count the drops and keep the FIFO
+* draining, and XUartPs_RingWrite() must take only what fits.
+*
+* Build and run on the host:
+*   cc -Wall -O2 -I. -I../src -I../../../../lib/bsp/standalone/src/common \
+*      -I../../../../lib/bsp/standalone/src/arm/cortexa9 \
+*      test_xuartps_ring.c -o test_xuartps_ring
+*   ./test_xuartps_ring
+*
+******************************************************************************/
+
+/***************************** Include Files *********************************/
+
+#include <stdio.h>
+#include <string.h>
+
+#include "xil_types.h"
+
+/* Register accesses go to the simulator below */
+#define XIL_IO_H
+static u32 Xil_In32(UINTPTR Addr);
+static void Xil_Out32(UINTPTR Addr, u32 Value);
+
+#define XIL_PRINTF_H
+void xil_printf(const char8 *Format, ...);
+
+#include "xuartps.c"
+#include "xuartps_intr.c"
+#include "xuartps_options.c"
+#include "xuartps_ring.c"
+
+/************************** Simulator ****************************************/
+
+#define SIM_BASE	0xFF000000U
+#define SIM_CLK_HZ	100000000U	/* UART reference clock */
+#define SIM_REG_NS	100U		/* One APB register access */
+#define SIM_FIFO	64U
+#define SIM_LOG		65536U
+#define SIM_NONE	(~0ULL)
+#define SIM_BURST_GAP_NS	1000000U	/* Longer idle ends a burst */
+
+typedef struct {
+	u32 Cr;
+	u32 Mr;
+	u32 Imr;
+	u32 Isr;
+	u32 BaudGen;
+	u32 BaudDiv;
+	u32 RxTout;
+	u32 Rxwm;
+	u8 RxFifo[SIM_FIFO];
+	u32 RxRd;
+	u32 RxFill;
+	u8 TxFifo[SIM_FIFO];
+	u32 TxRd;
+	u32 TxFill;
+	/* RX timeout */
+	u64 ToutAt;			/* SIM_NONE when not running */
+	/* TX shifter */
+	int TxBusy;
+	u8 TxShift;
+	u64 TxStart;
+	u64 TxEnd;
+	u64 TxBusyNs;
+	u64 TxGapNs;			/* Line idle inside a burst */
+	u64 TxLast;
+	u8 TxLog[SIM_LOG];
+	u32 TxCount;
+	/* Remote sender */
+	u32 RemoteLeft;
+	u32 RemoteSent;
+	u32 BurstBase;			/* 0 for a continuous stream */
+	u32 BurstLen;
+	u32 BurstPos;
+	u32 Bursts;
+	u32 GapChars;
+	u64 RemoteAt;			/* End of the next character */
+	u64 RemoteLast;
+	/* Statistics */
+	u32 Errors;
+	u32 Overruns;
+	u32 Timeouts;
+	u32 Accesses;
+	u32 MaxFill;
+} SimUart;
+
+static SimUart Sim;
+static u64 SimNow;
+
+static void SimError(const char *Why)
+{
+	if (Sim.Errors++ < 10U)
+		printf("model error: %s\n", Why);
+}
+
+/* The byte stream both directions carry, position by position */
+static u8 SimByte(u32 Pos)
+{
+	return (u8)(Pos * 7U + (Pos >> 8) + 1U);
+}
+
+/* 8N1: ten bit times per character */
+static u64 SimBitNs(void)
+{
+	u32 Clk = SIM_CLK_HZ;
+
+	if ((Sim.Mr & XUARTPS_MR_CLKSEL) != 0U)
+		Clk /= 8U;
+	if (Sim.BaudGen == 0U)
+		return 1000U;
+	return (1000000000ULL * Sim.BaudGen * (Sim.BaudDiv + 1U)) / Clk;
+}
+
+static u64 SimCharNs(void)
+{
+	return 10U * SimBitNs();
+}
+
+/* Restart the RX timeout, on a character received or a FIFO read */
+static void SimToutRestart(u64 At)
+{
+	if (Sim.RxTout == 0U)
+		Sim.ToutAt = SIM_NONE;
+	else
+		Sim.ToutAt = At + 4U * Sim.RxTout * SimBitNs();
+}
+
+static void SimRxPush(u8 Data, u64 At)
+{
+	if ((Sim.Cr & XUARTPS_CR_RX_EN) == 0U ||
+	    (Sim.Cr & XUARTPS_CR_RX_DIS) != 0U)
+		return;
+	SimToutRestart(At);
+	if (Sim.RxFill == SIM_FIFO) {
+		Sim.Isr |= XUARTPS_IXR_OVER;
+		Sim.Overruns++;
+		return;
+	}
+	Sim.RxFifo[(Sim.RxRd + Sim.RxFill) % SIM_FIFO] = Data;
+	Sim.RxFill++;
+	if (Sim.RxFill > Sim.MaxFill)
+		Sim.MaxFill = Sim.RxFill;
+	if (Sim.Rxwm != 0U && Sim.RxFill == Sim.Rxwm)
+		Sim.Isr |= XUARTPS_IXR_RXOVR;
+	if (Sim.RxFill == SIM_FIFO)
+		Sim.Isr |= XUARTPS_IXR_RXFULL;
+}
+
+/* Move the next TX FIFO entry into the shifter */
+static void SimTxLoad(u64 At)
+{
+	if (Sim.TxBusy || Sim.TxFill == 0U ||
+	    (Sim.Cr & XUARTPS_CR_TX_EN) == 0U ||
+	    (Sim.Cr & XUARTPS_CR_TX_DIS) != 0U)
+		return;
+	Sim.TxShift = Sim.TxFifo[Sim.TxRd];
+	Sim.TxRd = (Sim.TxRd + 1U) % SIM_FIFO;
+	Sim.TxFill--;
+	if (Sim.TxFill == 0U)
+		Sim.Isr |= XUARTPS_IXR_TXEMPTY;
+	Sim.TxBusy = 1;
+	Sim.TxStart = At;
+	Sim.TxEnd = At + SimCharNs();
+	if (Sim.TxCount != 0U && At - Sim.TxLast < SIM_BURST_GAP_NS)
+		Sim.TxGapNs += At - Sim.TxLast;
+}
+
+static void SimTxDone(void)
+{
+	Sim.TxBusy = 0;
+	Sim.TxBusyNs += Sim.TxEnd - Sim.TxStart;
+	Sim.TxLast = Sim.TxEnd;
+	if (Sim.TxCount < SIM_LOG)
+		Sim.TxLog[Sim.TxCount] = Sim.TxShift;
+	Sim.TxCount++;
+	SimTxLoad(Sim.TxEnd);
+}
+
+static void SimRemoteChar(void)
+{
+	u64 At = Sim.RemoteAt;
+
+	SimRxPush(SimByte(Sim.RemoteSent), At);
+	Sim.RemoteSent++;
+	Sim.RemoteLeft--;
+	Sim.RemoteLast = At;
+	Sim.RemoteAt = At + SimCharNs();
+	if (Sim.BurstBase != 0U && ++Sim.BurstPos == Sim.BurstLen) {
+		Sim.BurstPos = 0U;
+		Sim.Bursts++;
+		Sim.BurstLen = Sim.BurstBase + (Sim.Bursts * 37U) % 61U;
+		Sim.RemoteAt += Sim.GapChars * SimCharNs();
+	}
+}
+
+static u64 SimNextEvent(void)
+{
+	u64 Next = SIM_NONE;
+
+	if (Sim.RemoteLeft != 0U)
+		Next = Sim.RemoteAt;
+	if (Sim.TxBusy && Sim.TxEnd < Next)
+		Next = Sim.TxEnd;
+	if (Sim.ToutAt < Next)
+		Next = Sim.ToutAt;
+	return Next;
+}
+
+/* Run the line up to SimNow */
+static void SimAdvance(void)
+{
+	u64 Next;
+
+	while ((Next = SimNextEvent()) <= SimNow) {
+		if (Sim.TxBusy && Next == Sim.TxEnd) {
+			SimTxDone();
+		} else if (Sim.RemoteLeft != 0U && Next == Sim.RemoteAt) {
+			SimRemoteChar();
+		} else {
+			Sim.ToutAt = SIM_NONE;
+			if (Sim.RxFill != 0U) {
+				Sim.Isr |= XUARTPS_IXR_TOUT;
+				Sim.Timeouts++;
+			}
+		}
+	}
+}
+
+static int SimIdle(void)
+{
+	return Sim.RemoteLeft == 0U && !Sim.TxBusy && Sim.TxFill == 0U &&
+			Sim.ToutAt == SIM_NONE;
+}
+
+static void SimReset(void)
+{
+	memset(&Sim, 0, sizeof(Sim));
+	SimNow = 0U;
+	Sim.ToutAt = SIM_NONE;
+	Sim.Cr = XUARTPS_CR_RX_DIS | XUARTPS_CR_TX_DIS;
+	Sim.Rxwm = XUARTPS_RXWM_RESET_VAL;
+	Sim.Isr = XUARTPS_IXR_TXEMPTY | XUARTPS_IXR_RXEMPTY;
+}
+
+static u32 SimStatus(void)
+{
+	u32 Sr = 0U;
+
+	if (Sim.Rxwm != 0U && Sim.RxFill >= Sim.Rxwm)
+		Sr |= XUARTPS_SR_RXOVR;
+	if (Sim.RxFill == 0U)
+		Sr |= XUARTPS_SR_RXEMPTY;
+	if (Sim.RxFill == SIM_FIFO)
+		Sr |= XUARTPS_SR_RXFULL;
+	if (Sim.TxFill == 0U)
+		Sr |= XUARTPS_SR_TXEMPTY;
+	if (Sim.TxFill == SIM_FIFO)
+		Sr |= XUARTPS_SR_TXFULL;
+	if (Sim.TxBusy)
+		Sr |= XUARTPS_SR_TACTIVE;
+	return Sr;
+}
+
+/************************** Stubs ********************************************/
+
+static u32 Xil_In32(UINTPTR Addr)
+{
+	u32 Off = (u32)(Addr - SIM_BASE);
+	u32 Value = 0U;
+
+	SimNow += SIM_REG_NS;
+	Sim.Accesses++;
+	SimAdvance();
+
+	switch (Off) {
+	case XUARTPS_CR_OFFSET:
+		Value = Sim.Cr;
+		break;
+	case XUARTPS_MR_OFFSET:
+		Value = Sim.Mr;
+		break;
+	case XUARTPS_IMR_OFFSET:
+		Value = Sim.Imr;
+		break;
+	case XUARTPS_ISR_OFFSET:
+		Value = Sim.Isr;
+		break;
+	case XUARTPS_BAUDGEN_OFFSET:
+		Value = Sim.BaudGen;
+		break;
+	case XUARTPS_BAUDDIV_OFFSET:
+		Value = Sim.BaudDiv;
+		break;
+	case XUARTPS_RXTOUT_OFFSET:
+		Value = Sim.RxTout;
+		break;
+	case XUARTPS_RXWM_OFFSET:
+		Value = Sim.Rxwm;
+		break;
+	case XUARTPS_SR_OFFSET:
+		Value = SimStatus();
+		break;
+	case XUARTPS_FIFO_OFFSET:
+		if (Sim.RxFill == 0U) {
+			SimError("read of the empty RX FIFO");
+			break;
+		}
+		Value = Sim.RxFifo[Sim.RxRd];
+		Sim.RxRd = (Sim.RxRd + 1U) % SIM_FIFO;
+		Sim.RxFill--;
+		SimToutRestart(SimNow);
+		break;
+	default:
+		break;
+	}
+	return Value;
+}
+
+static void Xil_Out32(UINTPTR Addr, u32 Value)
+{
+	u32 Off = (u32)(Addr - SIM_BASE);
+
+	SimNow += SIM_REG_NS;
+	Sim.Accesses++;
+	SimAdvance();
+
+	switch (Off) {
+	case XUARTPS_CR_OFFSET:
+		if ((Value & XUARTPS_CR_RXRST) != 0U) {
+			Sim.RxRd = 0U;
+			Sim.RxFill = 0U;
+		}
+		if ((Value & XUARTPS_CR_TXRST) != 0U) {
+			Sim.TxRd = 0U;
+			Sim.TxFill = 0U;
+			Sim.Isr |= XUARTPS_IXR_TXEMPTY;
+		}
+		if ((Value & XUARTPS_CR_TORST) != 0U)
+			SimToutRestart(SimNow);
+		Sim.Cr = Value & ~(u32)(XUARTPS_CR_RXRST | XUARTPS_CR_TXRST |
+				XUARTPS_CR_TORST);
+		SimTxLoad(SimNow);
+		break;
+	case XUARTPS_MR_OFFSET:
+		Sim.Mr = Value;
+		break;
+	case XUARTPS_IER_OFFSET:
+		Sim.Imr |= Value & XUARTPS_IXR_MASK;
+		break;
+	case XUARTPS_IDR_OFFSET:
+		Sim.Imr &= ~Value;
+		break;
+	case XUARTPS_ISR_OFFSET:
+		Sim.Isr &= ~Value;
+		/* Conditions that still hold are raised again */
+		if (Sim.Rxwm != 0U && Sim.RxFill >= Sim.Rxwm)
+			Sim.Isr |= XUARTPS_IXR_RXOVR;
+		if (Sim.RxFill == SIM_FIFO)
+			Sim.Isr |= XUARTPS_IXR_RXFULL;
+		if (Sim.TxFill == 0U)
+			Sim.Isr |= XUARTPS_IXR_TXEMPTY;
+		if (Sim.TxFill == SIM_FIFO)
+			Sim.Isr |= XUARTPS_IXR_TXFULL;
+		break;
+	case XUARTPS_BAUDGEN_OFFSET:
+		Sim.BaudGen = Value;
+		break;
+	case XUARTPS_BAUDDIV_OFFSET:
+		Sim.BaudDiv = Value;
+		break;
+	case XUARTPS_RXTOUT_OFFSET:
+		Sim.RxTout = Value & XUARTPS_RXTOUT_MASK;
+		break;
+	case XUARTPS_RXWM_OFFSET:
+		Sim.Rxwm = Value & XUARTPS_RXWM_MASK;
+		if (Sim.Rxwm != 0U && Sim.RxFill >= Sim.Rxwm)
+			Sim.Isr |= XUARTPS_IXR_RXOVR;
+		break;
+	case XUARTPS_FIFO_OFFSET:
+		if (Sim.TxFill == SIM_FIFO) {
+			SimError("write to the full TX FIFO");
+			break;
+		}
+		Sim.TxFifo[(Sim.TxRd + Sim.TxFill) % SIM_FIFO] = (u8)Value;
+		Sim.TxFill++;
+		if (Sim.TxFill == SIM_FIFO)
+			Sim.Isr |= XUARTPS_IXR_TXFULL;
+		SimTxLoad(SimNow);
+		break;
+	default:
+		break;
+	}
+}
+
+void xil_printf(const char8 *Format, ...)
+{
+	(void)Format;
+}
+
+u32 XGetPlatform_Info(void)
+{
+	return XPLAT_ZYNQ;
+}
+
+u32 Xil_AssertStatus;
+s32 Xil_AssertWait;
+
+void Xil_Assert(const char8 *File, s32 Line)
+{
+	printf("assert %s:%d\n", File, (int)Line);
+}
+
+/************************** Test Helpers *************************************/
+
+#define CPU_IRQ_NS	5000U		/* Interrupt entry and exit */
+#define CPU_TASK_NS	1000000U	/* Period of the application task */
+#define CPU_MASK_NS	80000U		/* Interrupts masked in each task run */
+#define CPU_BYTE_NS	20U		/* Task work per received byte */
+#define CPU_POLL_NS	1000U		/* Producer busy-wait step */
+#define CPU_LIMIT_NS	10000000000ULL
+#define APP_CHUNK	64U
+#define RX_RING		1024U
+#define TX_RING		2048U
+
+#define CHECK(Cond, Msg)						\
+	do {								\
+		if (!(Cond)) {						\
+			printf("FAIL %s:%d: %s\n", __FILE__, __LINE__,	\
+								(Msg));	\
+			Failures++;					\
+		}							\
+	} while (0)
+
+static u32 Failures;
+
+static XUartPs Uart;
+static XUartPs_Config UartConfig;
+static XUartPsRing Ring;
+static u8 TxRingBuf[TX_RING];
+static u8 RxRingBuf[RX_RING];
+
+typedef struct {
+	u32 UseRing;
+	u32 Stall;		/* Task does not consume */
+	u64 TaskAt;
+	u32 TaskRuns;
+	u32 Irqs;
+	u32 RxIrqs;
+	u32 TxIrqs;
+	/* Receive check */
+	u32 Received;
+	u32 Wrong;
+	u32 RecvEvents;
+	u64 LastRecvAt;		/* When the last byte reached the ring */
+	/* Transmit */
+	u32 SentEvents;
+	u32 TxQueued;
+	u64 WaitNs;		/* Producer time spent waiting for room */
+} AppState;
+
+static AppState App;
+
+static void AppHandler(void *CallBackRef, u32 Event, u32 EventData)
+{
+	(void)CallBackRef;
+	(void)EventData;
+	if (Event == XUARTPS_EVENT_RECV_DATA) {
+		App.RecvEvents++;
+		if (Sim.RemoteLeft == 0U &&
+		    Ring.RxBytes == Sim.RemoteSent - Sim.Overruns)
+			App.LastRecvAt = SimNow;
+	} else if (Event == XUARTPS_EVENT_SENT_DATA) {
+		App.SentEvents++;
+	} else {
+		SimError("unexpected event");
+	}
+}
+
+static void CpuIrq(void)
+{
+	u32 Pending = Sim.Isr & Sim.Imr;
+
+	if (Pending == 0U)
+		return;
+	SimNow += CPU_IRQ_NS;
+	SimAdvance();
+	App.Irqs++;
+	if ((Pending & (XUARTPS_IXR_RXOVR | XUARTPS_IXR_RXFULL |
+			XUARTPS_IXR_TOUT)) != 0U)
+		App.RxIrqs++;
+	if ((Pending & XUARTPS_IXR_TXEMPTY) != 0U)
+		App.TxIrqs++;
+	XUartPs_InterruptHandler(&Uart);
+}
+
+/* Copy the received data out of the ring and check it */
+static void AppConsume(void)
+{
+	u8 Chunk[APP_CHUNK];
+	u32 Num;
+	u32 i;
+
+	while ((Num = XUartPs_RingRead(&Uart, Chunk, APP_CHUNK)) != 0U) {
+		for (i = 0U; i < Num; i++) {
+			if (Chunk[i] != SimByte(App.Received))
+				App.Wrong++;
+			App.Received++;
+		}
+		SimNow += Num * CPU_BYTE_NS;
+		SimAdvance();
+		/* The ISR preempts the task */
+		CpuIrq();
+	}
+}
+
+static void AppTask(void)
+{
+	App.TaskRuns++;
+	App.TaskAt += CPU_TASK_NS;
+
+	SimNow += CPU_MASK_NS;
+	SimAdvance();
+	if (!App.Stall)
+		AppConsume();
+}
+
+static void AppRun(void)
+{
+	u64 Next;
+
+	while (SimNow < CPU_LIMIT_NS) {
+		SimAdvance();
+		if ((Sim.Isr & Sim.Imr) != 0U) {
+			CpuIrq();
+			continue;
+		}
+		if (SimNow >= App.TaskAt) {
+			AppTask();
+			continue;
+		}
+		if (SimIdle() && (XUartPs_RingRxCount(&Uart) == 0U ||
+				App.Stall))
+			return;
+		Next = SimNextEvent();
+		SimNow = (Next < App.TaskAt) ? Next : App.TaskAt;
+	}
+	CHECK(0, "simulation did not finish");
+}
+
+/* Wait for something the interrupt handler does, with interrupts enabled */
+static void AppWait(void)
+{
+	SimNow += CPU_POLL_NS;
+	App.WaitNs += CPU_POLL_NS;
+	SimAdvance();
+	CpuIrq();
+}
+
+static void SetUp(u32 BaudRate, u32 UseRing)
+{
+	memset(&App, 0, sizeof(App));
+	App.UseRing = UseRing;
+	App.TaskAt = CPU_TASK_NS;
+
+	SimReset();
+	memset(&Uart, 0, sizeof(Uart));
+	UartConfig.DeviceId = 0U;
+	UartConfig.BaseAddress = SIM_BASE;
+	UartConfig.InputClockHz = SIM_CLK_HZ;
+	UartConfig.ModemPinsConnected = 0;
+	CHECK(XUartPs_CfgInitialize(&Uart, &UartConfig, SIM_BASE) ==
+			XST_SUCCESS, "CfgInitialize");
+	XUartPs_SetHandler(&Uart, AppHandler, &Uart);
+
+	if (UseRing) {
+		CHECK(XUartPs_RingInitialize(&Uart, &Ring, TxRingBuf, TX_RING,
+				RxRingBuf, RX_RING) == XST_SUCCESS,
+				"ring init");
+	} else {
+		XUartPs_SetInterruptMask(&Uart, XUARTPS_IXR_RXOVR |
+				XUARTPS_IXR_RXFULL | XUARTPS_IXR_TOUT);
+	}
+	/* A ring attached before the rate is set follows it */
+	CHECK(XUartPs_SetBaudRate(&Uart, BaudRate) == XST_SUCCESS,
+			"baud rate");
+	Sim.Isr = 0U;
+	Sim.Overruns = 0U;
+}
+
+/* Remote traffic from now on, in bursts */
+static void Remote(u32 Bytes, u32 BurstBase, u32 GapChars)
+{
+	Sim.RemoteLeft = Bytes;
+	Sim.BurstBase = BurstBase;
+	Sim.BurstLen = BurstBase;
+	Sim.GapChars = GapChars;
+	Sim.RemoteAt = SimNow + SimCharNs();
+}
+
+static double Baud(void)
+{
+	return 1e9 / (double)SimBitNs();
+}
+
+/************************** Tests ********************************************/
+
+#define RX_BYTES	20000U
+
+typedef struct {
+	u32 Received;
+	u32 Wrong;
+	u32 Overruns;
+	u32 Irqs;
+	u32 Timeouts;
+	u32 Trigger;
+} RxResult;
+
+static void RxRun(u32 BaudRate, u32 FixedTrigger, RxResult *Res)
+{
+	SetUp(BaudRate, 1U);
+	if (FixedTrigger != 0U)
+		XUartPs_SetFifoThreshold(&Uart, (u8)FixedTrigger);
+	Remote(RX_BYTES, 700U, 40U);
+	AppRun();
+	AppConsume();
+
+	Res->Received = App.Received;
+	Res->Wrong = App.Wrong;
+	Res->Overruns = Sim.Overruns;
+	Res->Irqs = App.RxIrqs;
+	Res->Timeouts = Sim.Timeouts;
+	Res->Trigger = Sim.Rxwm;
+
+	printf("  %7.0f baud trigger %2u%s: %5u of %5u received, "
+		"overrun %4u, %5.1f bytes/irq, %3u timeouts, fill max %2u\n",
+		Baud(), Res->Trigger, FixedTrigger ? " fixed" : "      ",
+		Res->Received, RX_BYTES, Res->Overruns,
+		Res->Irqs ? (double)Ring.RxBytes / Res->Irqs : 0.0,
+		Res->Timeouts, Sim.MaxFill);
+}
+
+static void TestRxRates(void)
+{
+	static const u32 Rates[] = { 115200U, 921600U, 3125000U };
+	static const u32 Triggers[] = { 56U, 54U, 32U };
+	RxResult Res;
+	RxResult Fixed;
+	u32 i;
+
+	printf("Receive, %u bytes in bursts, %u us masked per ms:\n",
+			RX_BYTES, CPU_MASK_NS / 1000U);
+
+	for (i = 0U; i < sizeof(Rates) / sizeof(Rates[0]); i++) {
+		RxRun(Rates[i], 0U, &Res);
+		CHECK(Res.Trigger == Triggers[i], "trigger for the rate");
+		CHECK(Res.Received == RX_BYTES, "all bytes received");
+		CHECK(Res.Wrong == 0U, "bytes intact and in order");
+		CHECK(Res.Overruns == 0U, "no RX FIFO overrun");
+		CHECK(Ring.RxDropped == 0U, "no ring drop");
+		CHECK(Res.Timeouts != 0U, "burst tails by timeout");
+		CHECK(Sim.Errors == 0U, "model errors");
+	}
+
+	/* A high fixed trigger cannot absorb the latency at a fast rate */
+	RxRun(3125000U, 56U, &Fixed);
+	CHECK(Fixed.Overruns != 0U, "fixed trigger 56 overruns");
+	CHECK(Fixed.Received + Fixed.Overruns == RX_BYTES,
+			"overrun bytes are the missing ones");
+
+	/* A low fixed trigger interrupts far more often at a slow rate */
+	RxRun(115200U, 0U, &Res);
+	RxRun(115200U, 8U, &Fixed);
+	CHECK(Fixed.Overruns == 0U && Fixed.Wrong == 0U,
+			"fixed trigger 8 receives");
+	CHECK(Fixed.Irqs > 4U * Res.Irqs, "fewer interrupts per byte");
+}
+
+static void TestRxTail(void)
+{
+	u64 Limit;
+
+	printf("Receive timeout:\n");
+
+	/* Fewer bytes than the trigger level only come in by the timeout */
+	SetUp(921600U, 1U);
+	Remote(45U, 0U, 0U);
+	AppRun();
+	Limit = Sim.RemoteLast + 4U * XUARTPS_RING_RX_TOUT * SimBitNs() +
+			CPU_MASK_NS + 2U * CPU_IRQ_NS;
+	printf("  45 bytes below trigger %u: delivered %.1f us after the "
+		"last byte\n", Sim.Rxwm,
+		(double)(App.LastRecvAt - Sim.RemoteLast) / 1000.0);
+	CHECK(App.Received == 45U && App.Wrong == 0U, "tail received");
+	CHECK(Sim.Timeouts == 1U, "one timeout");
+	CHECK(App.LastRecvAt != 0U && App.LastRecvAt <= Limit,
+			"tail delivered within the timeout");
+	CHECK(Sim.Errors == 0U, "model errors");
+}
+
+static void TestRingFull(void)
+{
+	static u8 Big[TX_RING + 500U];
+	u32 Done;
+	u32 Wrong = 0U;
+	u32 i;
+
+	printf("Full rings:\n");
+
+	/* A full RX ring drops, and the FIFO keeps draining */
+	SetUp(921600U, 1U);
+	App.Stall = 1U;
+	Remote(3000U, 0U, 0U);
+	AppRun();
+	printf("  RX ring of %u, 3000 bytes unread: %u kept, %u dropped, "
+		"overrun %u\n", RX_RING, Ring.RxBytes, Ring.RxDropped,
+		Sim.Overruns);
+	CHECK(Ring.RxBytes == RX_RING, "RX ring filled");
+	CHECK(Ring.RxDropped == 3000U - RX_RING, "RX drops counted");
+	CHECK(Sim.Overruns == 0U, "no RX FIFO overrun while dropping");
+	AppConsume();
+	CHECK(App.Received == RX_RING && App.Wrong == 0U,
+			"ring keeps the oldest bytes");
+
+	/* RingWrite() takes what fits and the rest follows */
+	SetUp(921600U, 1U);
+	for (i = 0U; i < sizeof(Big); i++)
+		Big[i] = SimByte(i);
+	Done = XUartPs_RingWrite(&Uart, Big, sizeof(Big));
+	CHECK(Done == TX_RING, "TX ring takes its size");
+	while (Done < sizeof(Big)) {
+		AppWait();
+		Done += XUartPs_RingWrite(&Uart, &Big[Done],
+				sizeof(Big) - Done);
+	}
+	AppRun();
+	for (i = 0U; i < Sim.TxCount; i++)
+		if (Sim.TxLog[i] != Big[i])
+			Wrong++;
+	CHECK(Sim.TxCount == sizeof(Big) && Wrong == 0U,
+			"TX ring wraps intact");
+	CHECK(Sim.Errors == 0U, "model errors");
+}
+
+#define TX_BURSTS	20U
+#define TX_MSGS		8U
+#define TX_MSG_BYTES	100U
+#define TX_PERIOD_NS	10000000U
+
+static void TxRun(u32 UseRing)
+{
+	u8 Msg[TX_MSG_BYTES];
+	u32 Pos = 0U;
+	u32 Done;
+	u32 Burst;
+	u32 m;
+	u32 i;
+
+	SetUp(921600U, UseRing);
+
+	for (Burst = 0U; Burst < TX_BURSTS; Burst++) {
+		for (m = 0U; m < TX_MSGS; m++) {
+			for (i = 0U; i < TX_MSG_BYTES; i++)
+				Msg[i] = SimByte(Pos + i);
+			Pos += TX_MSG_BYTES;
+			if (UseRing) {
+				Done = 0U;
+				while (Done < TX_MSG_BYTES) {
+					Done += XUartPs_RingWrite(&Uart,
+						&Msg[Done],
+						TX_MSG_BYTES - Done);
+					if (Done < TX_MSG_BYTES)
+						AppWait();
+				}
+			} else {
+				/* One send in flight: wait for the last */
+				while (App.SentEvents != App.TxQueued)
+					AppWait();
+				(void)XUartPs_Send(&Uart, Msg, TX_MSG_BYTES);
+			}
+			App.TxQueued++;
+			CpuIrq();
+		}
+		/* Sleep until the next burst, serving interrupts */
+		while (SimNow < (u64)(Burst + 1U) * TX_PERIOD_NS) {
+			SimAdvance();
+			if ((Sim.Isr & Sim.Imr) != 0U) {
+				CpuIrq();
+				continue;
+			}
+			Done = (SimNextEvent() < (u64)(Burst + 1U) *
+					TX_PERIOD_NS);
+			SimNow = Done ? SimNextEvent() :
+					(u64)(Burst + 1U) * TX_PERIOD_NS;
+		}
+	}
+
+	printf("  %-22s %5u of %5u bytes sent, %5.1f bytes/irq, "
+		"line %5.1f%% busy in bursts, producer waited %6.2f ms\n",
+		UseRing ? "XUartPs_RingWrite()" : "XUartPs_Send()",
+		Sim.TxCount, Pos, (double)Sim.TxCount / App.TxIrqs,
+		100.0 * (double)Sim.TxBusyNs /
+			(double)(Sim.TxBusyNs + Sim.TxGapNs),
+		(double)App.WaitNs / 1e6);
+}
+
+static void TestTx(void)
+{
+	u32 i;
+	u32 Wrong = 0U;
+	u64 SendWait;
+
+	printf("Transmit at 921600 baud, %u bursts of %u x %u bytes:\n",
+			TX_BURSTS, TX_MSGS, TX_MSG_BYTES);
+
+	TxRun(0U);
+	SendWait = App.WaitNs;
+	CHECK(Sim.TxCount == TX_BURSTS * TX_MSGS * TX_MSG_BYTES,
+			"XUartPs_Send sends everything");
+
+	TxRun(1U);
+	for (i = 0U; i < Sim.TxCount && i < SIM_LOG; i++)
+		if (Sim.TxLog[i] != SimByte(i))
+			Wrong++;
+	CHECK(Sim.TxCount == TX_BURSTS * TX_MSGS * TX_MSG_BYTES,
+			"ring sends everything");
+	CHECK(Wrong == 0U, "ring output intact and in order");
+	CHECK(App.WaitNs == 0U, "ring producer does not wait");
+	CHECK(SendWait > 0U, "XUartPs_Send producer waits");
+	CHECK(App.TxIrqs != 0U && Sim.TxCount / App.TxIrqs >= 48U,
+			"TX FIFO refilled in large batches");
+	CHECK(App.SentEvents == TX_BURSTS, "one sent event per burst");
+	CHECK(Sim.Errors == 0U, "model errors");
+}
+
+/************************** Main *********************************************/
+
+int main(void)
+{
+	TestRxRates();
+	TestRxTail();
+	TestRingFull();
+	TestTx();
+
+	printf("%s (%u failures)\n", Failures ? "FAILED" : "PASSED",
+							Failures);
+	return Failures ? 1 : 0;
+}
@@ -88,11 +88,36 @@ static const u8 bkgndColorRGB[XVMIX_BKGND_LAST][3] =
   {0, 0, 1}  //Blue
 };
 
+/* Offset of each shadowed register from the layer alpha register */
+static const u16 LayerShadowRegOffset[XVMIX_SHADOW_REG_NUM] =
+{
+  0x00, //Alpha
+  0x08, //StartX
+  0x10, //StartY
+  0x18, //Width
+  0x20, //Stride
+  0x28, //Height
+  0x30, //ScaleFactor
+  0x40, //Buffer1
+  0x4c  //Buffer2
+};
+
 /************************** Function Prototypes ******************************/
 static void SetPowerOnDefaultState(XV_Mix_l2 *InstancePtr);
 static int IsWindowValid(XVidC_VideoStream *Strm,
                          XVidC_VideoWindow *Win,
                          XVMix_Scalefactor ScaleFactor);
+static void XVMix_WriteLayerReg(XV_Mix_l2 *InstancePtr,
+                                XVMix_LayerId LayerId,
+                                XVMix_ShadowReg Reg,
+                                u32 Data);
+static u32 XVMix_ReadLayerReg(XV_Mix_l2 *InstancePtr,
+                              XVMix_LayerId LayerId,
+                              XVMix_ShadowReg Reg);
+static void XVMix_WriteLogoPlane(UINTPTR BaseAddress,
+                                 u32 PlaneAddr,
+                                 const u8 *Buf,
+                                 u32 Len);
 
 /*****************************************************************************/
 /**
@@ -584,31 +609,18 @@ int XVMix_SetLayerWindow(XV_Mix_l2 *InstancePtr,
            }
 
            if(WinValid) {
-
-             u32 BaseStartXReg, BaseStartYReg;
-             u32 BaseWidthReg, BaseHeightReg;
-             u32 BaseStrideReg;
-             u32 Offset;
-
-             BaseStartXReg = XV_MIX_CTRL_ADDR_HWREG_LAYERSTARTX_0_DATA;
-             BaseStartYReg = XV_MIX_CTRL_ADDR_HWREG_LAYERSTARTY_0_DATA;
-             BaseWidthReg  = XV_MIX_CTRL_ADDR_HWREG_LAYERWIDTH_0_DATA;
-             BaseHeightReg = XV_MIX_CTRL_ADDR_HWREG_LAYERHEIGHT_0_DATA;
-             BaseStrideReg = XV_MIX_CTRL_ADDR_HWREG_LAYERSTRIDE_0_DATA;
-             Offset = LayerId*XVMIX_REG_OFFSET;
-
-             XV_mix_WriteReg(MixPtr->Config.BaseAddress,
-                             (BaseStartXReg+Offset), Win->StartX);
-             XV_mix_WriteReg(MixPtr->Config.BaseAddress,
-                             (BaseStartYReg+Offset), Win->StartY);
-             XV_mix_WriteReg(MixPtr->Config.BaseAddress,
-                             (BaseWidthReg+Offset),  Win->Width);
-             XV_mix_WriteReg(MixPtr->Config.BaseAddress,
-                             (BaseHeightReg+Offset), Win->Height);
+             XVMix_WriteLayerReg(InstancePtr, LayerId,
+                                 XVMIX_SHADOW_REG_STARTX, Win->StartX);
+             XVMix_WriteLayerReg(InstancePtr, LayerId,
+                                 XVMIX_SHADOW_REG_STARTY, Win->StartY);
+             XVMix_WriteLayerReg(InstancePtr, LayerId,
+                                 XVMIX_SHADOW_REG_WIDTH,  Win->Width);
+             XVMix_WriteLayerReg(InstancePtr, LayerId,
+                                 XVMIX_SHADOW_REG_HEIGHT, Win->Height);
 
              if(!XVMix_IsLayerInterfaceStream(InstancePtr, LayerId)) {
-                XV_mix_WriteReg(MixPtr->Config.BaseAddress,
-                                (BaseStrideReg+Offset), StrideInBytes);
+                XVMix_WriteLayerReg(InstancePtr, LayerId,
+                                    XVMIX_SHADOW_REG_STRIDE, StrideInBytes);
              }
              InstancePtr->Layer[LayerId].Win = *Win;
              Status = XST_SUCCESS;
@@ -669,25 +681,14 @@ int XVMix_GetLayerWindow(XV_Mix_l2 *InstancePtr,
 
     default: //Layer0-Layer8
       if(LayerId < XVMix_GetNumLayers(InstancePtr)) {
-
-        u32 BaseStartXReg, BaseStartYReg;
-        u32 BaseWidthReg, BaseHeightReg;
-        u32 Offset;
-
-        BaseStartXReg = XV_MIX_CTRL_ADDR_HWREG_LAYERSTARTX_0_DATA;
-        BaseStartYReg = XV_MIX_CTRL_ADDR_HWREG_LAYERSTARTY_0_DATA;
-        BaseWidthReg  = XV_MIX_CTRL_ADDR_HWREG_LAYERWIDTH_0_DATA;
-        BaseHeightReg = XV_MIX_CTRL_ADDR_HWREG_LAYERHEIGHT_0_DATA;
-        Offset = LayerId*XVMIX_REG_OFFSET;
-
-        Win->StartX = XV_mix_ReadReg(MixPtr->Config.BaseAddress,
-                                     (BaseStartXReg+Offset));
-        Win->StartY = XV_mix_ReadReg(MixPtr->Config.BaseAddress,
-                                     (BaseStartYReg+Offset));
-        Win->Width  = XV_mix_ReadReg(MixPtr->Config.BaseAddress,
-                                     (BaseWidthReg+Offset));
-        Win->Height = XV_mix_ReadReg(MixPtr->Config.BaseAddress,
-                                     (BaseHeightReg+Offset));
+        Win->StartX = XVMix_ReadLayerReg(InstancePtr, LayerId,
+                                         XVMIX_SHADOW_REG_STARTX);
+        Win->StartY = XVMix_ReadLayerReg(InstancePtr, LayerId,
+                                         XVMIX_SHADOW_REG_STARTY);
+        Win->Width  = XVMix_ReadLayerReg(InstancePtr, LayerId,
+                                         XVMIX_SHADOW_REG_WIDTH);
+        Win->Height = XVMix_ReadLayerReg(InstancePtr, LayerId,
+                                         XVMIX_SHADOW_REG_HEIGHT);
 
         Status = XST_SUCCESS;
       } else {
@@ -765,17 +766,10 @@ int XVMix_MoveLayerWindow(XV_Mix_l2 *InstancePtr,
 
     default: //Layer1-Layer8
       if(LayerId < XVMix_GetNumLayers(InstancePtr)) {
-        u32 BaseStartXReg, BaseStartYReg;
-        u32 Offset;
-
-        BaseStartXReg = XV_MIX_CTRL_ADDR_HWREG_LAYERSTARTX_0_DATA;
-        BaseStartYReg = XV_MIX_CTRL_ADDR_HWREG_LAYERSTARTY_0_DATA;
-        Offset = LayerId*XVMIX_REG_OFFSET;
-
-        XV_mix_WriteReg(MixPtr->Config.BaseAddress,
-                        (BaseStartXReg+Offset), StartX);
-        XV_mix_WriteReg(MixPtr->Config.BaseAddress,
-                        (BaseStartYReg+Offset), StartY);
+        XVMix_WriteLayerReg(InstancePtr, LayerId,
+                            XVMIX_SHADOW_REG_STARTX, StartX);
+        XVMix_WriteLayerReg(InstancePtr, LayerId,
+                            XVMIX_SHADOW_REG_STARTY, StartY);
 
         InstancePtr->Layer[LayerId].Win.StartX = StartX;
         InstancePtr->Layer[LayerId].Win.StartY = StartY;
@@ -837,12 +831,8 @@ int XVMix_SetLayerScaleFactor(XV_Mix_l2 *InstancePtr,
     default: //Layer0-Layer8
       if((LayerId < XVMix_GetNumLayers(InstancePtr)) &&
          (XVMix_IsScalingEnabled(InstancePtr, LayerId))) {
-
-        u32 BaseReg;
-
-        BaseReg = XV_MIX_CTRL_ADDR_HWREG_LAYERSCALEFACTOR_0_DATA;
-        XV_mix_WriteReg(MixPtr->Config.BaseAddress,
-                        (BaseReg+(LayerId*XVMIX_REG_OFFSET)), Scale);
+        XVMix_WriteLayerReg(InstancePtr, LayerId,
+                            XVMIX_SHADOW_REG_SCALE, Scale);
 
         Status = XST_SUCCESS;
       }
@@ -884,11 +874,8 @@ int XVMix_GetLayerScaleFactor(XV_Mix_l2 *InstancePtr, XVMix_LayerId LayerId)
     default: //Layer0-Layer8
       if((LayerId < XVMix_GetNumLayers(InstancePtr)) &&
          (XVMix_IsScalingEnabled(InstancePtr, LayerId))) {
-        u32 BaseReg;
-
-        BaseReg = XV_MIX_CTRL_ADDR_HWREG_LAYERSCALEFACTOR_0_DATA;
-        ReadVal = XV_mix_ReadReg(MixPtr->Config.BaseAddress,
-                                 (BaseReg+(LayerId*XVMIX_REG_OFFSET)));
+        ReadVal = XVMix_ReadLayerReg(InstancePtr, LayerId,
+                                     XVMIX_SHADOW_REG_SCALE);
       }
       break;
   }
@@ -935,11 +922,8 @@ int XVMix_SetLayerAlpha(XV_Mix_l2 *InstancePtr,
     default: //Layer1-Layer8
       if((LayerId < XVMix_GetNumLayers(InstancePtr)) &&
          (XVMix_IsAlphaEnabled(InstancePtr, LayerId))) {
-        u32 BaseReg;
-
-        BaseReg = XV_MIX_CTRL_ADDR_HWREG_LAYERALPHA_0_DATA;
-        XV_mix_WriteReg(MixPtr->Config.BaseAddress,
-                        (BaseReg+(LayerId*XVMIX_REG_OFFSET)), Alpha);
+        XVMix_WriteLayerReg(InstancePtr, LayerId,
+                            XVMIX_SHADOW_REG_ALPHA, Alpha);
         Status = XST_SUCCESS;
       } else {
         Status = XVMIX_ERR_DISABLED_IN_HW;
@@ -982,11 +966,8 @@ int XVMix_GetLayerAlpha(XV_Mix_l2 *InstancePtr, XVMix_LayerId LayerId)
     default: //Layer1-Layer8
       if((LayerId < XVMix_GetNumLayers(InstancePtr)) &&
          (XVMix_IsAlphaEnabled(InstancePtr, LayerId))) {
-        u32 BaseReg;
-
-        BaseReg = XV_MIX_CTRL_ADDR_HWREG_LAYERALPHA_0_DATA;
-        ReadVal = XV_mix_ReadReg(MixPtr->Config.BaseAddress,
-                                 (BaseReg+(LayerId*XVMIX_REG_OFFSET)));
+        ReadVal = XVMix_ReadLayerReg(InstancePtr, LayerId,
+                                     XVMIX_SHADOW_REG_ALPHA);
       }
       break;
   }
@@ -1108,8 +1089,7 @@ int XVMix_SetLayerBufferAddr(XV_Mix_l2 *InstancePtr,
                              XVMix_LayerId LayerId,
                              UINTPTR Addr)
 {
-  XV_mix *MixPtr;
-  UINTPTR BaseReg, Align;
+  UINTPTR Align;
   u32 WinValid = FALSE;
   int Status = XST_FAILURE;
 
@@ -1118,8 +1098,6 @@ int XVMix_SetLayerBufferAddr(XV_Mix_l2 *InstancePtr,
                     (LayerId < XVMIX_LAYER_LOGO));
   Xil_AssertNonvoid(Addr != 0);
 
-  MixPtr = &InstancePtr->Mix;
-
   if(LayerId < XVMix_GetNumLayers(InstancePtr)) {
       /* Check if addr is aligned to aximm width (2*PPC*32-bits (4Bytes)) */
       Align = 2 * InstancePtr->Mix.Config.PixPerClk * 4;
@@ -1131,10 +1109,8 @@ int XVMix_SetLayerBufferAddr(XV_Mix_l2 *InstancePtr,
       }
 
       if(WinValid) {
-        BaseReg = XV_MIX_CTRL_ADDR_HWREG_LAYER1_BUF1_V_DATA;
-
-        XV_mix_WriteReg(MixPtr->Config.BaseAddress,
-                        (BaseReg+((LayerId-1)*XVMIX_REG_OFFSET)), Addr);
+        XVMix_WriteLayerReg(InstancePtr, LayerId,
+                            XVMIX_SHADOW_REG_BUF1, (u32)Addr);
 
         InstancePtr->Layer[LayerId].BufAddr = Addr;
         Status = XST_SUCCESS;
@@ -1157,21 +1133,15 @@ int XVMix_SetLayerBufferAddr(XV_Mix_l2 *InstancePtr,
 ******************************************************************************/
 UINTPTR XVMix_GetLayerBufferAddr(XV_Mix_l2 *InstancePtr, XVMix_LayerId LayerId)
 {
-  XV_mix *MixPtr;
-  u32 BaseReg;
   UINTPTR ReadVal = 0;
 
   Xil_AssertNonvoid(InstancePtr != NULL);
   Xil_AssertNonvoid((LayerId > XVMIX_LAYER_MASTER) &&
                     (LayerId < XVMIX_LAYER_LOGO));
 
-  MixPtr = &InstancePtr->Mix;
-
   if(LayerId < XVMix_GetNumLayers(InstancePtr)) {
-        BaseReg = XV_MIX_CTRL_ADDR_HWREG_LAYER1_BUF1_V_DATA;
-
-        ReadVal = XV_mix_ReadReg(MixPtr->Config.BaseAddress,
-                                 (BaseReg+((LayerId-1)*XVMIX_REG_OFFSET)));
+        ReadVal = XVMix_ReadLayerReg(InstancePtr, LayerId,
+                                     XVMIX_SHADOW_REG_BUF1);
   }
   return(ReadVal);
 }
@@ -1194,8 +1164,7 @@ int XVMix_SetLayerChromaBufferAddr(XV_Mix_l2 *InstancePtr,
                                    XVMix_LayerId LayerId,
                                    UINTPTR Addr)
 {
-  XV_mix *MixPtr;
-  UINTPTR BaseReg, Align;
+  UINTPTR Align;
   u32 WinValid = FALSE;
   int Status = XST_FAILURE;
 
@@ -1204,8 +1173,6 @@ int XVMix_SetLayerChromaBufferAddr(XV_Mix_l2 *InstancePtr,
                     (LayerId < XVMIX_LAYER_LOGO));
   Xil_AssertNonvoid(Addr != 0);
 
-  MixPtr = &InstancePtr->Mix;
-
   if(LayerId < XVMix_GetNumLayers(InstancePtr)) {
       /* Check if addr is aligned to aximm width (2*PPC*32-bits (4Bytes)) */
       Align = 2 * InstancePtr->Mix.Config.PixPerClk * 4;
@@ -1217,10 +1184,8 @@ int XVMix_SetLayerChromaBufferAddr(XV_Mix_l2 *InstancePtr,
       }
 
       if(WinValid) {
-        BaseReg = XV_MIX_CTRL_ADDR_HWREG_LAYER1_BUF2_V_DATA;
-
-        XV_mix_WriteReg(MixPtr->Config.BaseAddress,
-                        (BaseReg+((LayerId-1)*XVMIX_REG_OFFSET)), Addr);
+        XVMix_WriteLayerReg(InstancePtr, LayerId,
+                            XVMIX_SHADOW_REG_BUF2, (u32)Addr);
 
         InstancePtr->Layer[LayerId].ChromaBufAddr = Addr;
         Status = XST_SUCCESS;
@@ -1245,21 +1210,15 @@ int XVMix_SetLayerChromaBufferAddr(XV_Mix_l2 *InstancePtr,
 UINTPTR XVMix_GetLayerChromaBufferAddr(XV_Mix_l2 *InstancePtr,
                                        XVMix_LayerId LayerId)
 {
-  XV_mix *MixPtr;
-  u32 BaseReg;
   UINTPTR ReadVal = 0;
 
   Xil_AssertNonvoid(InstancePtr != NULL);
   Xil_AssertNonvoid((LayerId > XVMIX_LAYER_MASTER) &&
                     (LayerId < XVMIX_LAYER_LOGO));
 
-  MixPtr = &InstancePtr->Mix;
-
   if(LayerId < XVMix_GetNumLayers(InstancePtr)) {
-        BaseReg = XV_MIX_CTRL_ADDR_HWREG_LAYER1_BUF2_V_DATA;
-
-        ReadVal = XV_mix_ReadReg(MixPtr->Config.BaseAddress,
-                                 (BaseReg+((LayerId-1)*XVMIX_REG_OFFSET)));
+        ReadVal = XVMix_ReadLayerReg(InstancePtr, LayerId,
+                                     XVMIX_SHADOW_REG_BUF2);
   }
   return(ReadVal);
 }
@@ -1360,8 +1319,6 @@ int XVMix_LoadLogo(XV_Mix_l2 *InstancePtr,
                    u8 *BBuffer)
 {
   XV_mix *MixPtr;
-  u32 x,y;
-  u32 Rword, Gword, Bword;
   u32 Width, Height;
   u32 RBaseAddr, GBaseAddr, BBaseAddr;
   int Status = XST_FAILURE;
@@ -1386,28 +1343,13 @@ int XVMix_LoadLogo(XV_Mix_l2 *InstancePtr,
       GBaseAddr = XV_MIX_CTRL_ADDR_HWREG_LOGOG_V_BASE;
       BBaseAddr = XV_MIX_CTRL_ADDR_HWREG_LOGOB_V_BASE;
 
-      for (y=0; y<Height; y++) {
-          for (x=0; x<Width; x+=4) {
-            Rword = (u32)RBuffer[y*Width+x] |
-                    (((u32)RBuffer[y*Width+x+1])<<8) |
-                    (((u32)RBuffer[y*Width+x+2])<<16) |
-                    (((u32)RBuffer[y*Width+x+3])<<24);
-
-            Gword = (u32)GBuffer[y*Width+x] |
-                    (((u32)GBuffer[y*Width+x+1])<<8) |
-                    (((u32)GBuffer[y*Width+x+2])<<16) |
-                    (((u32)GBuffer[y*Width+x+3])<<24);
-
-            Bword = (u32)BBuffer[y*Width+x] |
-                    (((u32)BBuffer[y*Width+x+1])<<8) |
-                    (((u32)BBuffer[y*Width+x+2])<<16) |
-                    (((u32)BBuffer[y*Width+x+3])<<24);
-
-            XV_mix_WriteReg(MixPtr->Config.BaseAddress, (RBaseAddr+(y*Width+x)), Rword);
-            XV_mix_WriteReg(MixPtr->Config.BaseAddress, (GBaseAddr+(y*Width+x)), Gword);
-            XV_mix_WriteReg(MixPtr->Config.BaseAddress, (BBaseAddr+(y*Width+x)), Bword);
-          }
-      }
+      /* Logo rows are contiguous in BRAM, load one color plane at a time */
+      XVMix_WriteLogoPlane(MixPtr->Config.BaseAddress, RBaseAddr,
+                           RBuffer, (Width*Height));
+      XVMix_WriteLogoPlane(MixPtr->Config.BaseAddress, GBaseAddr,
+                           GBuffer, (Width*Height));
+      XVMix_WriteLogoPlane(MixPtr->Config.BaseAddress, BBaseAddr,
+                           BBuffer, (Width*Height));
       InstancePtr->Layer[XVMIX_LAYER_LOGO].RBuffer = RBuffer;
       InstancePtr->Layer[XVMIX_LAYER_LOGO].GBuffer = GBuffer;
       InstancePtr->Layer[XVMIX_LAYER_LOGO].BBuffer = BBuffer;
@@ -1435,8 +1377,7 @@ int XVMix_LoadLogoPixelAlpha(XV_Mix_l2 *InstancePtr,
                              u8 *ABuffer)
 {
   XV_mix *MixPtr;
-  u32 x,y;
-  u32 Aword, ABaseAddr;
+  u32 ABaseAddr;
   u32 Width, Height;
   int Status = XST_FAILURE;
 
@@ -1457,21 +1398,208 @@ int XVMix_LoadLogoPixelAlpha(XV_Mix_l2 *InstancePtr,
 
       ABaseAddr = XV_MIX_CTRL_ADDR_HWREG_LOGOA_V_BASE;
 
-      for (y=0; y<Height; y++) {
-          for (x=0; x<Width; x+=4) {
-            Aword = (u32)ABuffer[y*Width+x] |
-                    (((u32)ABuffer[y*Width+x+1])<<8) |
-                    (((u32)ABuffer[y*Width+x+2])<<16) |
-                    (((u32)ABuffer[y*Width+x+3])<<24);
-
-            XV_mix_WriteReg(MixPtr->Config.BaseAddress, (ABaseAddr+(y*Width+x)), Aword);
-          }
-      }
+      XVMix_WriteLogoPlane(MixPtr->Config.BaseAddress, ABaseAddr,
+                           ABuffer, (Width*Height));
       Status = XST_SUCCESS;
   }
   return(Status);
 }
 
+/*****************************************************************************/
+/**
+* This function writes a layer register through the shadow register image.
+* When shadow mode is disabled the register is written to the core directly
+*
+* @param  InstancePtr is a pointer to core instance to be worked upon
+* @param  LayerId is the layer to be updated (Layer1-16)
+* @param  Reg is the layer register to be written
+* @param  Data is the value to be written
+*
+* @return none
+*
+******************************************************************************/
+static void XVMix_WriteLayerReg(XV_Mix_l2 *InstancePtr,
+                                XVMix_LayerId LayerId,
+                                XVMix_ShadowReg Reg,
+                                u32 Data)
+{
+  XVMix_LayerShadow *ShadowPtr;
+  u32 RegAddr;
+
+  if(InstancePtr->ShadowEnable) {
+    ShadowPtr = &InstancePtr->Shadow[LayerId-1];
+    ShadowPtr->Reg[Reg] = Data;
+    ShadowPtr->Dirty |= (u16)(1u << Reg);
+  } else {
+    RegAddr = XV_MIX_CTRL_ADDR_HWREG_LAYERALPHA_0_DATA +
+              (LayerId*XVMIX_REG_OFFSET) + LayerShadowRegOffset[Reg];
+    XV_mix_WriteReg(InstancePtr->Mix.Config.BaseAddress, RegAddr, Data);
+  }
+}
+
+/*****************************************************************************/
+/**
+* This function reads a layer register. A value pending in the shadow register
+* image is returned in place of the register content
+*
+* @param  InstancePtr is a pointer to core instance to be worked upon
+* @param  LayerId is the layer to be read (Layer1-16)
+* @param  Reg is the layer register to be read
+*
+* @return Register value
+*
+******************************************************************************/
+static u32 XVMix_ReadLayerReg(XV_Mix_l2 *InstancePtr,
+                              XVMix_LayerId LayerId,
+                              XVMix_ShadowReg Reg)
+{
+  XVMix_LayerShadow *ShadowPtr;
+  u32 RegAddr;
+
+  ShadowPtr = &InstancePtr->Shadow[LayerId-1];
+  if(ShadowPtr->Dirty & (1u << Reg)) {
+    return(ShadowPtr->Reg[Reg]);
+  }
+
+  RegAddr = XV_MIX_CTRL_ADDR_HWREG_LAYERALPHA_0_DATA +
+            (LayerId*XVMIX_REG_OFFSET) + LayerShadowRegOffset[Reg];
+  return(XV_mix_ReadReg(InstancePtr->Mix.Config.BaseAddress, RegAddr));
+}
+
+/*****************************************************************************/
+/**
+* This function writes a byte buffer into a logo BRAM plane as consecutive
+* 32-bit words. A trailing partial word is zero padded
+*
+* @param  BaseAddress is the core base address
+* @param  PlaneAddr is the offset of the logo plane in the core address map
+* @param  Buf is the pointer to the plane data
+* @param  Len is the number of bytes to write
+*
+* @return none
+*
+******************************************************************************/
+static void XVMix_WriteLogoPlane(UINTPTR BaseAddress,
+                                 u32 PlaneAddr,
+                                 const u8 *Buf,
+                                 u32 Len)
+{
+  u32 Index, Word, Shift;
+
+  for(Index=0; (Index+4)<=Len; Index+=4) {
+    Word = (u32)Buf[Index] |
+           (((u32)Buf[Index+1])<<8) |
+           (((u32)Buf[Index+2])<<16) |
+           (((u32)Buf[Index+3])<<24);
+    XV_mix_WriteReg(BaseAddress, (PlaneAddr+Index), Word);
+  }
+
+  if(Index < Len) {
+    Word = 0;
+    for(Shift=0; Index<Len; ++Index, Shift+=8) {
+      Word |= ((u32)Buf[Index])<<Shift;
+    }
+    XV_mix_WriteReg(BaseAddress, (PlaneAddr+(Len & ~3u)), Word);
+  }
+}
+
+/*****************************************************************************/
+/**
+* This function enables or disables the layer shadow register mode. With
+* shadow mode enabled the window, stride, scale, alpha and buffer address
+* registers of Layer1-16 are held in the driver and only written to the core
+* by XVMix_CommitLayerRegs(), so a multi register layer update takes effect
+* in a single frame. Pending values are committed when shadow mode is
+* disabled
+*
+* @param  InstancePtr is a pointer to core instance to be worked upon
+* @param  Enable is TRUE to enable shadow mode or FALSE to disable it
+*
+* @return none
+*
+* @note   Logo layer registers are always written directly
+*
+******************************************************************************/
+void XVMix_SetShadowMode(XV_Mix_l2 *InstancePtr, u8 Enable)
+{
+  Xil_AssertVoid(InstancePtr != NULL);
+
+  if(!Enable && InstancePtr->ShadowEnable) {
+    XVMix_CommitLayerRegs(InstancePtr);
+  }
+  InstancePtr->ShadowEnable = (Enable ? TRUE : FALSE);
+}
+
+/*****************************************************************************/
+/**
+* This function writes all pending shadow registers to the core. Registers
+* are written in ascending address order and only registers that changed
+* since the last commit are accessed
+*
+* @param  InstancePtr is a pointer to core instance to be worked upon
+*
+* @return none
+*
+* @note   Call when the core is idle, e.g. from the frame done callback, or
+*         use XVMix_RequestLayerCommit() to have the interrupt handler commit
+*         before the next frame is started
+*
+******************************************************************************/
+void XVMix_CommitLayerRegs(XV_Mix_l2 *InstancePtr)
+{
+  XVMix_LayerShadow *ShadowPtr;
+  UINTPTR BaseAddress;
+  u32 LayerBase, Reg;
+  u32 Layer;
+
+  Xil_AssertVoid(InstancePtr != NULL);
+
+  BaseAddress = InstancePtr->Mix.Config.BaseAddress;
+
+  for(Layer=0; Layer<XVMIX_MAX_SUPPORTED_LAYERS; ++Layer) {
+    ShadowPtr = &InstancePtr->Shadow[Layer];
+    if(ShadowPtr->Dirty == 0) {
+      continue;
+    }
+
+    LayerBase = XV_MIX_CTRL_ADDR_HWREG_LAYERALPHA_0_DATA +
+                ((Layer+1)*XVMIX_REG_OFFSET);
+    for(Reg=0; Reg<XVMIX_SHADOW_REG_NUM; ++Reg) {
+      if(ShadowPtr->Dirty & (1u << Reg)) {
+        XV_mix_WriteReg(BaseAddress, (LayerBase+LayerShadowRegOffset[Reg]),
+                        ShadowPtr->Reg[Reg]);
+      }
+    }
+    ShadowPtr->Dirty = 0;
+  }
+  InstancePtr->CommitPending = FALSE;
+}
+
+/*****************************************************************************/
+/**
+* This function requests the interrupt handler to commit the pending shadow
+* registers on the next frame done interrupt, before the core is restarted
+*
+* @param  InstancePtr is a pointer to core instance to be worked upon
+*
+* @return none
+*
+* @note   Requires the frame done interrupt to be enabled. Use
+*         XVMix_IsLayerCommitPending() to check for completion.
+*         The commit takes whatever is in the shadow image when the frame
+*         done interrupt fires. Complete the layer update before calling
+*         this function and do not change shadowed registers until the
+*         commit is done, otherwise writes made in between may be split
+*         across two frames
+*
+******************************************************************************/
+void XVMix_RequestLayerCommit(XV_Mix_l2 *InstancePtr)
+{
+  Xil_AssertVoid(InstancePtr != NULL);
+
+  InstancePtr->CommitPending = TRUE;
+}
+
 /*****************************************************************************/
 /**
 * This function reports the mixer status
@@ -245,6 +245,23 @@ typedef enum {
   XVMIX_LAYER_TYPE_STREAM
 }XVMix_LayerType;
 
+/**
+ * This typedef enumerates the per layer registers held in the shadow
+ * register image, in ascending register address order
+ */
+typedef enum {
+  XVMIX_SHADOW_REG_ALPHA = 0,
+  XVMIX_SHADOW_REG_STARTX,
+  XVMIX_SHADOW_REG_STARTY,
+  XVMIX_SHADOW_REG_WIDTH,
+  XVMIX_SHADOW_REG_STRIDE,
+  XVMIX_SHADOW_REG_HEIGHT,
+  XVMIX_SHADOW_REG_SCALE,
+  XVMIX_SHADOW_REG_BUF1,
+  XVMIX_SHADOW_REG_BUF2,
+  XVMIX_SHADOW_REG_NUM
+}XVMix_ShadowReg;
+
 /****************** Mixer status 4096 - 4100  *****************************/
 typedef enum {
   XVMIX_ERR_LAYER_WINDOW_INVALID     = 0x1000L,
@@ -280,6 +297,14 @@ typedef struct {
     };
 }XVMix_Layer;
 
+/**
+ * This typedef contains the shadow register image of a layer
+ */
+typedef struct {
+    u32 Reg[XVMIX_SHADOW_REG_NUM]; /**< Register values not yet written */
+    u16 Dirty;                     /**< Bit n set if Reg[n] is pending */
+}XVMix_LayerShadow;
+
 /**
 * Callback type for interrupt.
 *
@@ -312,6 +337,13 @@ typedef struct {
     XVMix_BackgroundId BkgndColor;
 
     XVidC_VideoStream Stream;    /**< Input AXIS */
+
+    XVMix_LayerShadow Shadow[XVMIX_MAX_SUPPORTED_LAYERS]; /**< Shadow image
+                                        of Layer1-16 registers */
+    u8 ShadowEnable;             /**< Layer register writes go to the shadow
+                                      image when set */
+    volatile u8 CommitPending;   /**< Shadow image is written to the core
+                                      on the next frame done interrupt */
 }XV_Mix_l2;
 
 /************************** Macros Definitions *******************************/
@@ -469,6 +501,19 @@ typedef struct {
 #define XVMix_IsLayerInterfaceStream(InstancePtr, LayerId) \
  ((InstancePtr)->Mix.Config.LayerIntrfType[LayerId-1] == XVMIX_LAYER_TYPE_STREAM)
 
+/*****************************************************************************/
+/**
+*
+* This macro checks if a shadow register commit requested with
+* XVMix_RequestLayerCommit() has not been done yet
+*
+* @param    InstancePtr is a pointer to the core instance.
+*
+* @return   TRUE(1)/FALSE(0)
+*
+******************************************************************************/
+#define XVMix_IsLayerCommitPending(InstancePtr) ((InstancePtr)->CommitPending)
+
 /**************************** Function Prototypes *****************************/
 int XVMix_Initialize(XV_Mix_l2 *InstancePtr, u16 DeviceId);
 void XVMix_Start(XV_Mix_l2 *InstancePtr);
@@ -533,6 +578,10 @@ int XVMix_LoadLogoPixelAlpha(XV_Mix_l2 *InstancePtr,
                              XVidC_VideoWindow *Win,
                              u8 *ABuffer);
 
+void XVMix_SetShadowMode(XV_Mix_l2 *InstancePtr, u8 Enable);
+void XVMix_CommitLayerRegs(XV_Mix_l2 *InstancePtr);
+void XVMix_RequestLayerCommit(XV_Mix_l2 *InstancePtr);
+
 void XVMix_DbgReportStatus(XV_Mix_l2 *InstancePtr);
 void XVMix_DbgLayerInfo(XV_Mix_l2 *InstancePtr, XVMix_LayerId LayerId);
 
@@ -65,8 +65,9 @@ int XVMix_SetCallback(XV_Mix_l2 *InstancePtr, void *CallbackFunc, void *Callback
 * This function is the interrupt handler for the mixer core driver.
 *
 * This handler clears the pending interrupt and determined if the source is
-* frame done signal. If yes, starts the next frame processing and calls the
-* registered callback function
+* frame done signal. If yes, calls the registered callback function, commits
+* the layer shadow registers if a commit was requested and starts the next
+* frame processing
 *
 * The application is responsible for connecting this function to the interrupt
 * system. Application beyond this driver is also responsible for providing
@@ -102,6 +103,10 @@ void XVMix_InterruptHandler(void *InstancePtr)
     if(MixPtr->FrameDoneCallback) {
 	      MixPtr->FrameDoneCallback(MixPtr->CallbackRef);
     }
+    //Core is idle, apply requested layer update before next frame
+    if(MixPtr->CommitPending) {
+      XVMix_CommitLayerRegs(MixPtr);
+    }
     XV_mix_Start(&MixPtr->Mix);
   }
 }
@@ -0,0 +1,351 @@
+/******************************************************************************
+* Copyright (C) 2020 Xilinx, Inc.  All rights reserved.
+* SPDX-License-Identifier: MIT
+******************************************************************************/
+
+/*****************************************************************************/
+/**
+*
+* @file test_xv_mix_shadow.c
+*
+* Host test of the mixer layer shadow registers and logo BRAM loading. The
+* driver is built against a register model that replaces Xil_In32/Xil_Out32
+* and counts every AXI access, so the number and order of accesses made with
+* and without shadow mode can be compared.
+*
+* Build and run on the host:
+*   cc -Wall -Wno-format -U__linux__ -I../src -I../../video_common/src \
+*      -I../../../../lib/bsp/standalone/src/common \
+*      test_xv_mix_shadow.c -o test_xv_mix_shadow
+*   ./test_xv_mix_shadow
+*
+******************************************************************************/
+
+/***************************** Include Files *********************************/
+
+#include <stdio.h>
+#include <string.h>
+
+/* Build the standalone (non Linux) flavour of the driver */
+#undef __linux__
+#include "xil_types.h"
+
+/************************** Register Model ***********************************/
+
+/* Covers the control registers and the four logo BRAM planes */
+#define MODEL_SIZE		0x50000
+#define MODEL_MAX_LOG	4096
+
+typedef struct {
+  u32 Reg[MODEL_SIZE/4];
+  u32 Reads;
+  u32 Writes;
+  u32 NumLog;
+  u32 Log[MODEL_MAX_LOG];        /* Offsets written, in order */
+} RegModel;
+
+static RegModel Model;
+
+/* Replace the BSP services the driver pulls in with host versions */
+#define XIL_PRINTF_H
+#define SLEEP_H
+#define XIL_IO_H
+#define xil_printf printf
+
+static void usleep(unsigned long useconds)
+{
+  (void)useconds;
+}
+
+static inline u32 Xil_In32(UINTPTR Addr)
+{
+  Model.Reads++;
+  return Model.Reg[(Addr % MODEL_SIZE)/4];
+}
+
+static inline void Xil_Out32(UINTPTR Addr, u32 Value)
+{
+  Model.Writes++;
+  if(Model.NumLog < MODEL_MAX_LOG) {
+    Model.Log[Model.NumLog++] = (u32)Addr;
+  }
+  Model.Reg[(Addr % MODEL_SIZE)/4] = Value;
+}
+
+#include "xv_mix.c"
+#include "xv_mix_l2.c"
+#include "xv_mix_l2_intr.c"
+
+/************************** Stubs ********************************************/
+
+u32 Xil_AssertStatus;
+s32 Xil_AssertWait;
+static u32 AssertCount;
+
+void Xil_Assert(const char8 *File, s32 Line)
+{
+  printf("ASSERT %s:%d\n", File, (int)Line);
+  AssertCount++;
+}
+
+/* xv_mix_sinit.c needs xparameters.h, the tests set up the config directly */
+int XV_mix_Initialize(XV_mix *InstancePtr, u16 DeviceId)
+{
+  (void)InstancePtr;
+  (void)DeviceId;
+  return XST_DEVICE_NOT_FOUND;
+}
+
+const char *XVidC_GetColorFormatStr(XVidC_ColorFormat ColorFormatId)
+{
+  (void)ColorFormatId;
+  return "";
+}
+
+void XVidC_ReportStreamInfo(const XVidC_VideoStream *Stream)
+{
+  (void)Stream;
+}
+
+/************************** Test Helpers *************************************/
+
+static u32 Failures;
+
+#define CHECK(Cond, Msg) \
+  do { \
+    if(!(Cond)) { \
+      printf("FAIL line %d: %s\n", __LINE__, Msg); \
+      Failures++; \
+    } \
+  } while(0)
+
+static void ModelReset(void)
+{
+  memset(&Model, 0, sizeof(Model));
+}
+
+static void ModelClearCounts(void)
+{
+  Model.Reads = 0;
+  Model.Writes = 0;
+  Model.NumLog = 0;
+}
+
+static void InitMixer(XV_Mix_l2 *Mix)
+{
+  u32 Index;
+
+  memset(Mix, 0, sizeof(*Mix));
+  Mix->Mix.Config.BaseAddress = 0;
+  Mix->Mix.Config.PixPerClk = 2;
+  Mix->Mix.Config.MaxWidth = 3840;
+  Mix->Mix.Config.MaxHeight = 2160;
+  Mix->Mix.Config.NumLayers = 9;
+  Mix->Mix.Config.LogoEn = 1;
+  Mix->Mix.Config.LogoPixAlphaEn = 1;
+  Mix->Mix.Config.MaxLogoWidth = 64;
+  Mix->Mix.Config.MaxLogoHeight = 64;
+  for(Index=0; Index<XV_MIX_MAX_MEMORY_LAYERS; ++Index) {
+    Mix->Mix.Config.AlphaEn[Index] = 1;
+    Mix->Mix.Config.ScalingEn[Index] = 1;
+    Mix->Mix.Config.LayerMaxWidth[Index] = 3840;
+    Mix->Mix.Config.LayerIntrfType[Index] = XVMIX_LAYER_TYPE_MEMORY;
+  }
+  Mix->Mix.IsReady = XIL_COMPONENT_IS_READY;
+  Mix->Stream.Timing.HActive = 1920;
+  Mix->Stream.Timing.VActive = 1080;
+}
+
+/* Full update of one memory layer: window, stride, alpha, scale, buffer */
+static void UpdateLayer(XV_Mix_l2 *Mix, XVMix_LayerId Layer, u16 Pos)
+{
+  XVidC_VideoWindow Win;
+
+  Win.StartX = Pos;
+  Win.StartY = Pos/2;
+  Win.Width = 320;
+  Win.Height = 240;
+  CHECK(XVMix_SetLayerWindow(Mix, Layer, &Win, 1280) == XST_SUCCESS,
+        "set window");
+  CHECK(XVMix_SetLayerAlpha(Mix, Layer, (u16)(Pos & 0xFF)) == XST_SUCCESS,
+        "set alpha");
+  CHECK(XVMix_SetLayerScaleFactor(Mix, Layer, XVMIX_SCALE_FACTOR_2X) ==
+        XST_SUCCESS, "set scale");
+  CHECK(XVMix_SetLayerBufferAddr(Mix, Layer, 0x10000000 + Pos*16) ==
+        XST_SUCCESS, "set buffer");
+}
+
+/************************** Tests ********************************************/
+
+static void TestShadowCommit(void)
+{
+  static XV_Mix_l2 Mix;
+  static u32 DirectImage[MODEL_SIZE/4];
+  u32 DirectWrites, DirectReads, ShadowReads;
+  u32 Index;
+
+  /* Direct writes, the reference for register contents and access count */
+  ModelReset();
+  InitMixer(&Mix);
+  UpdateLayer(&Mix, XVMIX_LAYER_1, 64);
+  UpdateLayer(&Mix, XVMIX_LAYER_3, 128);
+  DirectWrites = Model.Writes;
+  DirectReads = Model.Reads;
+  memcpy(DirectImage, Model.Reg, sizeof(DirectImage));
+
+  /* Shadowed: nothing reaches the core until the commit */
+  ModelReset();
+  InitMixer(&Mix);
+  XVMix_SetShadowMode(&Mix, TRUE);
+  UpdateLayer(&Mix, XVMIX_LAYER_1, 32);
+  UpdateLayer(&Mix, XVMIX_LAYER_1, 64);
+  UpdateLayer(&Mix, XVMIX_LAYER_3, 128);
+  CHECK(Model.Writes == 0, "shadow mode wrote to the core");
+  ShadowReads = Model.Reads;
+  CHECK(ShadowReads < DirectReads, "pending values not read from shadow");
+
+  ModelClearCounts();
+  XVMix_CommitLayerRegs(&Mix);
+  /* Eight registers per layer are touched, each written once */
+  CHECK(Model.Writes == 16, "commit did not write only dirty registers");
+  CHECK(Model.Reads == 0, "commit read from the core");
+  for(Index=1; Index<Model.NumLog; ++Index) {
+    CHECK(Model.Log[Index] > Model.Log[Index-1],
+          "commit not in ascending address order");
+  }
+  CHECK(memcmp(DirectImage, Model.Reg, sizeof(DirectImage)) == 0,
+        "committed registers differ from direct writes");
+
+  ModelClearCounts();
+  XVMix_CommitLayerRegs(&Mix);
+  CHECK(Model.Writes == 0, "second commit wrote registers");
+
+  printf("layer update: direct %u writes %u reads, "
+         "shadowed 0 writes %u reads, commit 16 writes\n",
+         DirectWrites, DirectReads, ShadowReads);
+}
+
+static void TestInterruptCommit(void)
+{
+  static XV_Mix_l2 Mix;
+  u32 Index;
+  u32 SawStart = FALSE;
+
+  ModelReset();
+  InitMixer(&Mix);
+  XVMix_SetShadowMode(&Mix, TRUE);
+  UpdateLayer(&Mix, XVMIX_LAYER_2, 96);
+  XVMix_RequestLayerCommit(&Mix);
+  CHECK(XVMix_IsLayerCommitPending(&Mix), "commit not pending");
+  CHECK(Model.Writes == 0, "request wrote to the core");
+
+  /* Frame done */
+  Model.Reg[XV_MIX_CTRL_ADDR_ISR/4] = XVMIX_IRQ_DONE_MASK;
+  ModelClearCounts();
+  XVMix_InterruptHandler(&Mix);
+  CHECK(!XVMix_IsLayerCommitPending(&Mix), "commit still pending");
+  CHECK(Mix.Shadow[XVMIX_LAYER_2-1].Dirty == 0, "shadow still dirty");
+
+  /* The layer registers are written before the core is restarted */
+  for(Index=0; Index<Model.NumLog; ++Index) {
+    if(Model.Log[Index] == XV_MIX_CTRL_ADDR_AP_CTRL) {
+      SawStart = TRUE;
+    } else if(Model.Log[Index] >= XV_MIX_CTRL_ADDR_HWREG_LAYERALPHA_0_DATA) {
+      CHECK(!SawStart, "layer register written after restart");
+    }
+  }
+  CHECK(SawStart, "core not restarted");
+
+  /* Disabling shadow mode flushes pending writes */
+  UpdateLayer(&Mix, XVMIX_LAYER_2, 160);
+  ModelClearCounts();
+  XVMix_SetShadowMode(&Mix, FALSE);
+  CHECK(Model.Writes == 8, "disable did not flush");
+}
+
+/* Logo load as done before the per plane helper, one word of each plane
+ * at a time */
+static void LoadLogoReference(u32 *Image, u32 Width, u32 Height,
+                              const u8 *R, const u8 *G, const u8 *B)
+{
+  u32 x, y, Off;
+
+  for(y=0; y<Height; y++) {
+    for(x=0; x<Width; x+=4) {
+      Off = y*Width+x;
+      Image[(XV_MIX_CTRL_ADDR_HWREG_LOGOR_V_BASE+Off)/4] =
+        R[Off] | (R[Off+1]<<8) | (R[Off+2]<<16) | ((u32)R[Off+3]<<24);
+      Image[(XV_MIX_CTRL_ADDR_HWREG_LOGOG_V_BASE+Off)/4] =
+        G[Off] | (G[Off+1]<<8) | (G[Off+2]<<16) | ((u32)G[Off+3]<<24);
+      Image[(XV_MIX_CTRL_ADDR_HWREG_LOGOB_V_BASE+Off)/4] =
+        B[Off] | (B[Off+1]<<8) | (B[Off+2]<<16) | ((u32)B[Off+3]<<24);
+    }
+  }
+}
+
+static void TestLogoLoad(void)
+{
+  static XV_Mix_l2 Mix;
+  static u32 RefImage[MODEL_SIZE/4];
+  static u8 R[64*64], G[64*64], B[64*64], A[64*64];
+  XVidC_VideoWindow Win;
+  u32 Index, Words, Plane;
+
+  for(Index=0; Index<sizeof(R); ++Index) {
+    R[Index] = (u8)(Index*7);
+    G[Index] = (u8)(Index*13+1);
+    B[Index] = (u8)(Index*29+2);
+    A[Index] = (u8)(Index*3+5);
+  }
+
+  Win.StartX = 0;
+  Win.StartY = 0;
+  Win.Width = 36;
+  Win.Height = 40;
+  Words = (Win.Width*Win.Height)/4;
+
+  memset(RefImage, 0, sizeof(RefImage));
+  LoadLogoReference(RefImage, Win.Width, Win.Height, R, G, B);
+
+  ModelReset();
+  InitMixer(&Mix);
+  CHECK(XVMix_LoadLogo(&Mix, &Win, R, G, B) == XST_SUCCESS, "load logo");
+  CHECK(memcmp(&Model.Reg[XV_MIX_CTRL_ADDR_HWREG_LOGOR_V_BASE/4],
+               &RefImage[XV_MIX_CTRL_ADDR_HWREG_LOGOR_V_BASE/4],
+               0x30000) == 0, "logo planes differ from reference");
+
+  /* One sequential run per plane, then the logo window registers */
+  for(Plane=0; Plane<3; ++Plane) {
+    for(Index=1; Index<Words; ++Index) {
+      CHECK(Model.Log[Plane*Words+Index] ==
+            Model.Log[Plane*Words+Index-1] + 4, "plane not sequential");
+    }
+  }
+  CHECK(Model.Writes == 3*Words + 4, "logo write count");
+
+  /* Pixel alpha plane, with a partial last word */
+  ModelClearCounts();
+  Win.Width = 34;
+  Win.Height = 33;
+  CHECK(XVMix_LoadLogoPixelAlpha(&Mix, &Win, A) == XST_SUCCESS,
+        "load logo alpha");
+  Words = (Win.Width*Win.Height + 3)/4;
+  CHECK(Model.Writes == Words, "alpha write count");
+  for(Index=0; Index<Win.Width*Win.Height; ++Index) {
+    u32 Word = Model.Reg[(XV_MIX_CTRL_ADDR_HWREG_LOGOA_V_BASE+Index)/4];
+    CHECK(((Word >> ((Index%4)*8)) & 0xFF) == A[Index], "alpha byte");
+  }
+  CHECK((Model.Reg[(XV_MIX_CTRL_ADDR_HWREG_LOGOA_V_BASE/4)+Words-1] >>
+         (((Win.Width*Win.Height)%4)*8)) == 0, "alpha padding not zero");
+}
+
+int main(void)
+{
+  TestShadowCommit();
+  TestInterruptCommit();
+  TestLogoLoad();
+
+  CHECK(AssertCount == 0, "driver asserted");
+  printf("%s (%u failures)\n", Failures ? "FAILED" : "PASSED", Failures);
+  return (Failures ? 1 : 0);
+}
@@ -57,11 +57,29 @@ extern const XVidC_VideoTimingMode XVidC_VideoTimingModes[XVIDC_VM_NUM_SUPPORTED
 const XVidC_VideoTimingMode *XVidC_CustomTimingModes = NULL;
 int XVidC_NumCustomModes = 0;
 
+/* Number of buckets in the video mode index. Must be a power of 2 larger than
+ * XVIDC_VM_NUM_SUPPORTED. */
+#define XVIDC_VM_HASH_SIZE	512
+
+/* Video mode index of XVidC_VideoTimingModes, keyed on HActive, VActive,
+ * frame rate and interlacing. Buckets hold the table index + 1 of the first
+ * entry with a given key, 0 marks an empty bucket. XVidC_VmHashNext links
+ * each entry to the next entry with the same key (index + 1, 0 = last) so
+ * that entries differing only in blanking can be walked in table order. */
+static u16 XVidC_VmHashTable[XVIDC_VM_HASH_SIZE];
+static u16 XVidC_VmHashNext[XVIDC_VM_NUM_SUPPORTED];
+static volatile u8 XVidC_VmHashReady = 0;
+
 /**************************** Function Prototypes *****************************/
 
 static const XVidC_VideoTimingMode *XVidC_GetCustomVideoModeData(
 		XVidC_VideoMode VmId);
 static u8 XVidC_IsVtmRb(const char *VideoModeStr, u8 RbN);
+static u32 XVidC_VmHash(u32 Width, u32 Height, u32 FrameRate,
+		u8 IsInterlaced);
+static void XVidC_BuildVmIndex(void);
+static u32 XVidC_FindVideoMode(u32 Width, u32 Height, u32 FrameRate,
+		u8 IsInterlaced);
 
 /*************************** Function Definitions *****************************/
 
@@ -317,19 +335,14 @@ XVidC_VideoMode XVidC_GetVideoModeIdWBlanking(const XVidC_VideoTiming *Timing,
 XVidC_VideoMode XVidC_GetVideoModeId(u32 Width, u32 Height, u32 FrameRate,
 					u8 IsInterlaced)
 {
-	u32 Low;
-	u32 High;
-	u32 Mid;
 	u32 HActive;
 	u32 VActive;
 	u32 Rate;
-	u32 ResFound = (FALSE);
-	XVidC_VideoMode Mode;
-	u16 Index;
+	u32 Index;
 
 	/* First, attempt a linear search on the custom video timing table. */
 	if(XVidC_CustomTimingModes) {
-	  for (Index = 0; Index < XVidC_NumCustomModes; Index++) {
+	  for (Index = 0; Index < (u32)XVidC_NumCustomModes; Index++) {
 		HActive = XVidC_CustomTimingModes[Index].Timing.HActive;
 		VActive = XVidC_CustomTimingModes[Index].Timing.VActive;
 		Rate = XVidC_CustomTimingModes[Index].FrameRate;
@@ -341,82 +354,11 @@ XVidC_VideoMode XVidC_GetVideoModeId(u32 Width, u32 Height, u32 FrameRate,
 	  }
 	}
 
-	if (IsInterlaced) {
-		Low = (XVIDC_VM_INTL_START);
-		High = (XVIDC_VM_INTL_END);
-	}
-	else {
-		Low = (XVIDC_VM_PROG_START);
-		High = (XVIDC_VM_PROG_END);
-	}
+	/* Then look up the first matching entry in the default table */
+	Index = XVidC_FindVideoMode(Width, Height, FrameRate, IsInterlaced);
 
-	HActive = VActive = Rate = 0;
-
-	/* Binary search finds item in sorted array.
-	 * And returns index (zero based) of item
-	 * If item is not found returns flag remains
-	 * FALSE. Search key is "width or HActive"
-	 */
-	while (Low <= High) {
-		Mid = (Low + High) / 2;
-		HActive = XVidC_VideoTimingModes[Mid].Timing.HActive;
-		if (Width == HActive) {
-			ResFound = (TRUE);
-			break;
-		}
-		else if (Width < HActive) {
-			if (Mid == 0) {
-				break;
-			}
-			else {
-				High = Mid - 1;
-			}
-		}
-		else {
-			Low = Mid + 1;
-		}
-	}
-
-	 /* HActive matched at middle */
-	if (ResFound) {
-		/* Rewind to start index of mode with matching width */
-		while ((Mid > 0) &&
-			(XVidC_VideoTimingModes[Mid - 1].Timing.HActive ==
-								Width)) {
-			--Mid;
-		}
-
-		ResFound = (FALSE);
-		VActive = XVidC_VideoTimingModes[Mid].Timing.VActive;
-		Rate = XVidC_VideoTimingModes[Mid].FrameRate;
-
-		/* Now do a linear search for matching VActive and Frame
-		 * Rate
-		 */
-		while (HActive == Width) {
-			/* check current entry */
-			if ((VActive == Height) && (Rate == FrameRate)) {
-				ResFound = (TRUE);
-				break;
-			}
-			/* Check next entry */
-			else {
-				Mid = Mid + 1;
-				HActive =
-				XVidC_VideoTimingModes[Mid].Timing.HActive;
-				VActive =
-				XVidC_VideoTimingModes[Mid].Timing.VActive;
-				Rate = XVidC_VideoTimingModes[Mid].FrameRate;
-			}
-		}
-		Mode =
-		(ResFound) ? (XVidC_VideoMode)Mid : (XVIDC_VM_NOT_SUPPORTED);
-	}
-	else {
-		Mode = (XVIDC_VM_NOT_SUPPORTED);
-	}
-
-	return (Mode);
+	return ((Index != 0) ? (XVidC_VideoMode)(Index - 1) :
+						(XVIDC_VM_NOT_SUPPORTED));
 }
 
 /******************************************************************************/
@@ -444,19 +386,15 @@ XVidC_VideoMode XVidC_GetVideoModeIdExtensive(XVidC_VideoTiming *Timing,
 											  u8 IsInterlaced,
 											  u8 IsExtensive)
 {
-	u32 Low;
-	u32 High;
-	u32 Mid;
 	u32 HActive;
 	u32 VActive;
 	u32 Rate;
-	u32 ResFound = (FALSE);
-	XVidC_VideoMode Mode;
-	u16 Index;
+	u32 Index;
+	const XVidC_VideoTimingMode *Vtm;
 
 	/* First, attempt a linear search on the custom video timing table. */
 	if(XVidC_CustomTimingModes) {
-	  for (Index = 0; Index < XVidC_NumCustomModes; Index++) {
+	  for (Index = 0; Index < (u32)XVidC_NumCustomModes; Index++) {
 		HActive = XVidC_CustomTimingModes[Index].Timing.HActive;
 		VActive = XVidC_CustomTimingModes[Index].Timing.VActive;
 		Rate = XVidC_CustomTimingModes[Index].FrameRate;
@@ -488,112 +426,30 @@ XVidC_VideoMode XVidC_GetVideoModeIdExtensive(XVidC_VideoTiming *Timing,
 	  }
 	}
 
-	if (IsInterlaced) {
-		Low = (XVIDC_VM_INTL_START);
-		High = (XVIDC_VM_INTL_END);
-	}
-	else {
-		Low = (XVIDC_VM_PROG_START);
-		High = (XVIDC_VM_PROG_END);
-	}
-
-	HActive = VActive = Rate = 0;
-
-	/* Binary search finds item in sorted array.
-	 * And returns index (zero based) of item
-	 * If item is not found returns flag remains
-	 * FALSE. Search key is "Timing->HActive or HActive"
-	 */
-	while (Low <= High) {
-		Mid = (Low + High) / 2;
-		HActive = XVidC_VideoTimingModes[Mid].Timing.HActive;
-		if (Timing->HActive == HActive) {
-			ResFound = (TRUE);
-			break;
-		}
-		else if (Timing->HActive < HActive) {
-			if (Mid == 0) {
-				break;
-			}
-			else {
-				High = Mid - 1;
-			}
-		}
-		else {
-			Low = Mid + 1;
-		}
-	}
-
-	 /* HActive matched at middle */
-	if (ResFound) {
-		/* Rewind to start index of mode with matching Timing->HActive */
-		while ((Mid > 0) &&
-			(XVidC_VideoTimingModes[Mid - 1].Timing.HActive ==
-								Timing->HActive)) {
-			--Mid;
-		}
-
-		ResFound = (FALSE);
-		VActive = XVidC_VideoTimingModes[Mid].Timing.VActive;
-		Rate = XVidC_VideoTimingModes[Mid].FrameRate;
-
-		/* Now do a linear search for matching VActive and Frame
-		 * Rate
-		 */
-		while (HActive == Timing->HActive) {
-			/* check current entry */
-			if ((VActive == Timing->VActive) && (Rate == FrameRate) &&
-					(IsExtensive == 0 ||
-					(XVidC_VideoTimingModes[Mid].Timing.HTotal ==
-							Timing->HTotal &&
-					XVidC_VideoTimingModes[Mid].Timing.F0PVTotal ==
-							Timing->F0PVTotal &&
-					XVidC_VideoTimingModes[Mid].Timing.HFrontPorch ==
-							Timing->HFrontPorch &&
-					XVidC_VideoTimingModes[Mid].Timing.F0PVFrontPorch ==
-							Timing->F0PVFrontPorch &&
-					XVidC_VideoTimingModes[Mid].Timing.HSyncWidth ==
-							Timing->HSyncWidth &&
-					XVidC_VideoTimingModes[Mid].Timing.F0PVSyncWidth ==
-							Timing->F0PVSyncWidth &&
-					XVidC_VideoTimingModes[Mid].Timing.VSyncPolarity ==
-							Timing->VSyncPolarity))) {
-				if (!IsInterlaced || IsExtensive == 0 || (
-						XVidC_VideoTimingModes[Mid].Timing.F1VTotal ==
-								Timing->F1VTotal &&
-						XVidC_VideoTimingModes[Mid].Timing.F1VFrontPorch ==
-								Timing->F1VFrontPorch &&
-						XVidC_VideoTimingModes[Mid].Timing.F1VSyncWidth ==
-								Timing->F1VSyncWidth)) {
-					ResFound = (TRUE);
-					break;
-				} else {
-					Mid = Mid + 1;
-					HActive =
-					XVidC_VideoTimingModes[Mid].Timing.HActive;
-					VActive =
-					XVidC_VideoTimingModes[Mid].Timing.VActive;
-					Rate = XVidC_VideoTimingModes[Mid].FrameRate;
-				}
-			}
-			/* Check next entry */
-			else {
-				Mid = Mid + 1;
-				HActive =
-				XVidC_VideoTimingModes[Mid].Timing.HActive;
-				VActive =
-				XVidC_VideoTimingModes[Mid].Timing.VActive;
-				Rate = XVidC_VideoTimingModes[Mid].FrameRate;
-			}
+	/* Walk the entries with matching HActive, VActive and frame rate in
+	 * table order and check the blanking parameters */
+	Index = XVidC_FindVideoMode(Timing->HActive, Timing->VActive, FrameRate,
+				IsInterlaced);
+	while (Index != 0) {
+		Vtm = &XVidC_VideoTimingModes[Index - 1];
+		if ((IsExtensive == 0) ||
+			((Vtm->Timing.HTotal == Timing->HTotal) &&
+			(Vtm->Timing.F0PVTotal == Timing->F0PVTotal) &&
+			(Vtm->Timing.HFrontPorch == Timing->HFrontPorch) &&
+			(Vtm->Timing.F0PVFrontPorch == Timing->F0PVFrontPorch) &&
+			(Vtm->Timing.HSyncWidth == Timing->HSyncWidth) &&
+			(Vtm->Timing.F0PVSyncWidth == Timing->F0PVSyncWidth) &&
+			(Vtm->Timing.VSyncPolarity == Timing->VSyncPolarity) &&
+			(!IsInterlaced ||
+			((Vtm->Timing.F1VTotal == Timing->F1VTotal) &&
+			(Vtm->Timing.F1VFrontPorch == Timing->F1VFrontPorch) &&
+			(Vtm->Timing.F1VSyncWidth == Timing->F1VSyncWidth))))) {
+			return (XVidC_VideoMode)(Index - 1);
 		}
-		Mode =
-		(ResFound) ? (XVidC_VideoMode)Mid : (XVIDC_VM_NOT_SUPPORTED);
-	}
-	else {
-		Mode = (XVIDC_VM_NOT_SUPPORTED);
+		Index = XVidC_VmHashNext[Index - 1];
 	}
 
-	return (Mode);
+	return (XVIDC_VM_NOT_SUPPORTED);
 }
 
 /******************************************************************************/
@@ -634,7 +490,8 @@ XVidC_VideoMode XVidC_GetVideoModeIdRb(u32 Width, u32 Height,
 
 	while (!Found) {
 		VtmPtr = XVidC_GetVideoModeData(VmId);
-		if ((Height != VtmPtr->Timing.VActive) ||
+		if ((!VtmPtr) ||
+		    (Height != VtmPtr->Timing.VActive) ||
 		    (Width != VtmPtr->Timing.HActive) ||
 		    (FrameRate != VtmPtr->FrameRate) ||
 		    (IsInterlaced && !XVidC_IsInterlaced(VmId))) {
@@ -1200,4 +1057,136 @@ static u8 XVidC_IsVtmRb(const char *VideoModeStr, u8 RbN)
 	}
 	return 0;
 }
+
+/******************************************************************************/
+/**
+ * This function computes the bucket of a video mode in the video mode index.
+ *
+ * @param	Width specifies the number pixels per scanline.
+ * @param	Height specifies the number of scanline's.
+ * @param	FrameRate specifies refresh rate in HZ
+ * @param	IsInterlaced specifies interlaced or progressive mode.
+ *
+ * @return	Bucket index, less than XVIDC_VM_HASH_SIZE.
+ *
+ * @note	None.
+ *
+*******************************************************************************/
+static u32 XVidC_VmHash(u32 Width, u32 Height, u32 FrameRate,
+		u8 IsInterlaced)
+{
+	u32 Hash;
+
+	Hash = (Width * 0x9E3779B1U) ^ (Height * 0x85EBCA77U) ^
+		(FrameRate * 0xC2B2AE3DU) ^ ((IsInterlaced != 0) ? 1U : 0U);
+	Hash ^= Hash >> 15;
+	Hash *= 0x2C1B3C6DU;
+	Hash ^= Hash >> 12;
+
+	return (Hash & (XVIDC_VM_HASH_SIZE - 1));
+}
+
+/******************************************************************************/
+/**
+ * This function builds the video mode index of the default video mode timing
+ * table (XVidC_VideoTimingModes). Entries are inserted in table order so that
+ * each key resolves to its first entry, as the ordered table search did.
+ *
+ * @return	None.
+ *
+ * @note	The index is built on first use. Building is idempotent, so a
+ *		build interrupted by another lookup that builds the index as
+ *		well still produces the same index.
+ *
+*******************************************************************************/
+static void XVidC_BuildVmIndex(void)
+{
+	const XVidC_VideoTimingMode *Vtm;
+	const XVidC_VideoTimingMode *First;
+	u32 Index;
+	u32 Bucket;
+	u32 Entry;
+	u8 IsInterlaced;
+
+	for (Index = 0; Index < XVIDC_VM_NUM_SUPPORTED; Index++) {
+		Vtm = &XVidC_VideoTimingModes[Index];
+		IsInterlaced = (Index <= XVIDC_VM_INTL_END) ? 1 : 0;
+		Bucket = XVidC_VmHash(Vtm->Timing.HActive, Vtm->Timing.VActive,
+					Vtm->FrameRate, IsInterlaced);
+
+		/* Linear probing for the bucket of the key or an empty one */
+		while (XVidC_VmHashTable[Bucket] != 0) {
+			Entry = XVidC_VmHashTable[Bucket] - 1;
+			First = &XVidC_VideoTimingModes[Entry];
+			if ((First->Timing.HActive == Vtm->Timing.HActive) &&
+				(First->Timing.VActive == Vtm->Timing.VActive) &&
+				(First->FrameRate == Vtm->FrameRate) &&
+				((Entry <= XVIDC_VM_INTL_END) ==
+						(Index <= XVIDC_VM_INTL_END))) {
+				break;
+			}
+			Bucket = (Bucket + 1) & (XVIDC_VM_HASH_SIZE - 1);
+		}
+
+		if (XVidC_VmHashTable[Bucket] == 0) {
+			XVidC_VmHashTable[Bucket] = (u16)(Index + 1);
+			continue;
+		}
+
+		/* Key present, append to the end of its chain once */
+		Entry = XVidC_VmHashTable[Bucket] - 1;
+		while ((Entry != Index) && (XVidC_VmHashNext[Entry] != 0)) {
+			Entry = XVidC_VmHashNext[Entry] - 1;
+		}
+		if (Entry != Index) {
+			XVidC_VmHashNext[Entry] = (u16)(Index + 1);
+		}
+	}
+
+	XVidC_VmHashReady = 1;
+}
+
+/******************************************************************************/
+/**
+ * This function looks up the first entry of the default video mode timing
+ * table that matches width, height, frame rate and I/P flag.
+ *
+ * @param	Width specifies the number pixels per scanline.
+ * @param	Height specifies the number of scanline's.
+ * @param	FrameRate specifies refresh rate in HZ
+ * @param	IsInterlaced specifies interlaced or progressive mode.
+ *
+ * @return	Table index + 1 of the first matching entry, 0 if none.
+ *		Further entries with the same key are linked through
+ *		XVidC_VmHashNext.
+ *
+ * @note	None.
+ *
+*******************************************************************************/
+static u32 XVidC_FindVideoMode(u32 Width, u32 Height, u32 FrameRate,
+		u8 IsInterlaced)
+{
+	const XVidC_VideoTimingMode *Vtm;
+	u32 Bucket;
+	u32 Entry;
+
+	if (!XVidC_VmHashReady) {
+		XVidC_BuildVmIndex();
+	}
+
+	Bucket = XVidC_VmHash(Width, Height, FrameRate, IsInterlaced);
+	while (XVidC_VmHashTable[Bucket] != 0) {
+		Entry = XVidC_VmHashTable[Bucket] - 1;
+		Vtm = &XVidC_VideoTimingModes[Entry];
+		if ((Vtm->Timing.HActive == Width) &&
+			(Vtm->Timing.VActive == Height) &&
+			(Vtm->FrameRate == FrameRate) &&
+			((Entry <= XVIDC_VM_INTL_END) == (IsInterlaced != 0))) {
+			return (Entry + 1);
+		}
+		Bucket = (Bucket + 1) & (XVIDC_VM_HASH_SIZE - 1);
+	}
+
+	return 0;
+}
 /** @} */
@@ -148,7 +148,6 @@ struct _Pragma ("pack()") xvidc_cea861_short_video_descriptor {
 #endif
     unsigned video_identification_code : 8;
 };
-#if XVIDC_EDID_VERBOSITY > 1
 #if defined(__GNUC__)
 struct __attribute__ (( packed )) xvidc_cea861_video_data_block {
 #elif defined(__ICCARM__)
@@ -157,7 +156,6 @@ struct _Pragma ("pack()") xvidc_cea861_video_data_block {
     struct xvidc_cea861_data_block_header      header;
     struct xvidc_cea861_short_video_descriptor svd[];
 };
-#endif
 #if defined(__GNUC__)
 struct __attribute__ (( packed )) xvidc_cea861_short_audio_descriptor {
 #elif defined(__ICCARM__)
@@ -138,6 +138,56 @@ XV_VidC_timing
     return timing;
 }
 
+XV_VidC_TimingParam
+XV_VidC_DispIdTiming
+    (const struct xvidc_displayid_detailed_timing_descriptor * const dtd,
+     u32 PixClkKhz)
+{
+    XV_VidC_TimingParam timing;
+    u32 Total;
+
+#define XVIDC_DISPLAYID_FIELD(f)        ((u32)(f)[0] | ((u32)(f)[1] << 8))
+    timing.hres   = XVIDC_DISPLAYID_FIELD(dtd->horizontal_active) + 1;
+    timing.vres   = XVIDC_DISPLAYID_FIELD(dtd->vertical_active) + 1;
+    timing.htotal = timing.hres +
+                    XVIDC_DISPLAYID_FIELD(dtd->horizontal_blanking) + 1;
+    timing.vtotal = timing.vres +
+                    XVIDC_DISPLAYID_FIELD(dtd->vertical_blanking) + 1;
+    timing.hfp    =
+           (XVIDC_DISPLAYID_FIELD(dtd->horizontal_sync_offset) & 0x7FFF) + 1;
+    timing.vfp    =
+             (XVIDC_DISPLAYID_FIELD(dtd->vertical_sync_offset) & 0x7FFF) + 1;
+    timing.hsync_width  =
+                    XVIDC_DISPLAYID_FIELD(dtd->horizontal_sync_width) + 1;
+    timing.vsync_width  =
+                      XVIDC_DISPLAYID_FIELD(dtd->vertical_sync_width) + 1;
+    timing.hsync_polarity = dtd->horizontal_sync_offset[1] >> 7;
+    timing.vsync_polarity = dtd->vertical_sync_offset[1] >> 7;
+#undef XVIDC_DISPLAYID_FIELD
+
+    /* Clocks above 4.29 GHz do not fit the Hz field and saturate */
+    timing.pixclk = (PixClkKhz > (0xFFFFFFFF / 1000)) ?
+                                        0xFFFFFFFF : (PixClkKhz * 1000);
+    Total = (u32)timing.htotal * timing.vtotal;
+    timing.vfreq  = (Total != 0) ?
+                        (u8)(((u64)PixClkKhz * 1000) / Total) : 0;
+    timing.vidfrmt      = (XVidC_VideoFormat) ((dtd->options >> 4) & 0x1);
+    timing.aspect_ratio =
+                         xv_vidc_getPicAspectRatio (timing.hres, timing.vres);
+
+    return timing;
+}
+
+XV_VidC_Supp XV_VidC_EdidIsVicSupported
+           (const XV_VidC_EdidCntrlParam *EdidCtrlParam, u8 Vic)
+{
+	/* Verify arguments. */
+	Xil_AssertNonvoid(EdidCtrlParam != NULL);
+
+	return ((EdidCtrlParam->SuppCeaVicMap[Vic >> 5] & (1U << (Vic & 0x1F)))
+			? XVIDC_SUPPORTED : XVIDC_NOT_SUPPORTED);
+}
+
 #if XVIDC_EDID_VERBOSITY > 1
 XV_VidC_DoubleRep Double2Int (double in_val) {
 	XV_VidC_DoubleRep DR;
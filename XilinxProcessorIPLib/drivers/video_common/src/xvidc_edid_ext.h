@@ -62,6 +62,7 @@ enum xvidc_edid_extension_type {
                                                           Extension (LS-EXT) */
     XVIDC_EDID_EXTENSION_MI               = 0x60, /* Microdisplay Interface
                                                           Extension (MI-EXT) */
+    XVIDC_EDID_EXTENSION_DISPLAYID        = 0x70, /* DisplayID Extension */
     XVIDC_EDID_EXTENSION_DTCDB_1          = 0xA7, /* Display Transfer
                                           Characteristics Data Block (DTCDB) */
     XVIDC_EDID_EXTENSION_DTCDB_2          = 0xAF,
@@ -71,6 +72,17 @@ enum xvidc_edid_extension_type {
                                                                  Block (DDDB)*/
 };
 
+enum xvidc_displayid_data_block_type {
+    XVIDC_DISPLAYID_DATA_BLOCK_TYPE_I_TIMING       = 0x03, /* Type I Detailed
+                                                      Timing (DisplayID 1.x) */
+    XVIDC_DISPLAYID_DATA_BLOCK_TYPE_VII_TIMING     = 0x22, /* Type VII Detailed
+                                                      Timing (DisplayID 2.x) */
+    XVIDC_DISPLAYID_DATA_BLOCK_INTERFACE_FEATURES  = 0x26, /* Display Interface
+                                                  Features (DisplayID 2.x) */
+    XVIDC_DISPLAYID_DATA_BLOCK_CTA                 = 0x81, /* CTA-861 Data
+                                                                 Blocks */
+};
+
 enum xvidc_edid_display_type {
     XVIDC_EDID_DISPLAY_TYPE_MONOCHROME,
     XVIDC_EDID_DISPLAY_TYPE_RGB,
@@ -565,6 +577,51 @@ struct _Pragma ("pack()") xvidc_edid_extension {
 };
 
 
+#if defined(__GNUC__)
+struct __attribute__ (( packed )) xvidc_displayid_extension {
+#elif defined(__ICCARM__)
+struct _Pragma ("pack()") xvidc_displayid_extension {
+#endif
+    u8 tag;
+    u8 version;                           /* 0x1x DisplayID 1.x, 0x2x 2.x */
+    u8 bytes;                             /* Data block bytes of the section */
+    u8 product_type;
+    u8 extension_count;
+    u8 data[122];                         /* Data blocks, section checksum */
+    u8 checksum;
+};
+
+
+#if defined(__GNUC__)
+struct __attribute__ (( packed )) xvidc_displayid_data_block_header {
+#elif defined(__ICCARM__)
+struct _Pragma ("pack()") xvidc_displayid_data_block_header {
+#endif
+    u8 tag;
+    u8 revision;
+    u8 length;                            /* Payload bytes after the header */
+};
+
+
+#if defined(__GNUC__)
+struct __attribute__ (( packed )) xvidc_displayid_detailed_timing_descriptor {
+#elif defined(__ICCARM__)
+struct _Pragma ("pack()") xvidc_displayid_detailed_timing_descriptor {
+#endif
+    u8 pixel_clock[3];                    /* = value + 1, in 10 kHz (Type I)
+                                                        or 1 kHz (Type VII) */
+    u8 options;                           /* [7] preferred, [4] interlaced */
+    u8 horizontal_active[2];              /* = value + 1 */
+    u8 horizontal_blanking[2];            /* = value + 1 */
+    u8 horizontal_sync_offset[2];         /* = [14:0] + 1, [15] polarity */
+    u8 horizontal_sync_width[2];          /* = value + 1 */
+    u8 vertical_active[2];                /* = value + 1 */
+    u8 vertical_blanking[2];              /* = value + 1 */
+    u8 vertical_sync_offset[2];           /* = [14:0] + 1, [15] polarity */
+    u8 vertical_sync_width[2];            /* = value + 1 */
+};
+
+
 static inline bool
 xvidc_edid_verify_checksum(const u8 * const block)
 {
@@ -661,14 +718,27 @@ typedef struct {
     u8             MaxFrlLanesSupp;
 	/*CEA 861 Supported VIC Support*/
     u8             SuppCeaVIC[32];
+	/*CEA 861 Supported VIC bitmap, bit (VIC % 32) of word (VIC / 32)*/
+    u32            SuppCeaVicMap[8];
 	/*VESA Sink Preffered Timing Support*/
     XV_VidC_TimingParam PreferedTiming[4];
+	/*DisplayID Type I and Type VII Detailed Timings, in EDID order*/
+    XV_VidC_TimingParam DispIdTiming[4];
+    u8             NumDispIdTiming;
+	/*Highest DisplayID Detailed Timing pixel clock in kHz*/
+    u32            MaxDispIdPixClkKhz;
+	/*Signature of the EDID the parameters were parsed from, 0 if none*/
+    u32            EdidSignature;
 } XV_VidC_EdidCntrlParam;
 
 
 XV_VidC_TimingParam
 XV_VidC_timing
            (const struct xvidc_edid_detailed_timing_descriptor * const dtb);
+XV_VidC_TimingParam
+XV_VidC_DispIdTiming
+    (const struct xvidc_displayid_detailed_timing_descriptor * const dtd,
+     u32 PixClkKhz);
 #if XVIDC_EDID_VERBOSITY > 1
 XV_VidC_DoubleRep Double2Int (double in_val);
 #endif
@@ -678,6 +748,12 @@ void
 XV_VidC_parse_edid(const u8 * const data,
                   XV_VidC_EdidCntrlParam *EdidCtrlParam,
                   XV_VidC_Verbose VerboseEn);
+u8
+XV_VidC_parse_edid_cached(const u8 * const data, u32 Length,
+                  XV_VidC_EdidCntrlParam *EdidCtrlParam,
+                  XV_VidC_Verbose VerboseEn);
+XV_VidC_Supp XV_VidC_EdidIsVicSupported
+           (const XV_VidC_EdidCntrlParam *EdidCtrlParam, u8 Vic);
 
 #ifdef __cplusplus
 }
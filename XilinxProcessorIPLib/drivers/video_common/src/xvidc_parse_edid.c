@@ -82,6 +82,11 @@ xvidc_disp_cea861_video_data(
                   XV_VidC_Verbose VerboseEn);
 #endif
 
+static void
+xvidc_map_cea861_video_data(
+                  const struct xvidc_cea861_video_data_block * const vdb,
+                  XV_VidC_EdidCntrlParam *EdidCtrlParam);
+
 static void
 xvidc_disp_cea861_extended_data(
                   const struct xvidc_cea861_extended_data_block * const edb,
@@ -94,11 +99,34 @@ xvidc_disp_cea861_vendor_data(
                   XV_VidC_EdidCntrlParam *EdidCtrlParam,
                   XV_VidC_Verbose VerboseEn);
 
+static void
+xvidc_disp_cea861_data_blocks(const u8 * const data, u8 length,
+                  XV_VidC_EdidCntrlParam *EdidCtrlParam,
+                  XV_VidC_Verbose VerboseEn);
+
 static void
 xvidc_disp_cea861(const struct xvidc_edid_extension * const ext,
                   XV_VidC_EdidCntrlParam *EdidCtrlParam,
                   XV_VidC_Verbose VerboseEn);
 
+static void
+xvidc_disp_displayid_timing(
+                  const struct xvidc_displayid_data_block_header * const header,
+                  u8 ClkUnitKhz, u8 DescSize,
+                  XV_VidC_EdidCntrlParam *EdidCtrlParam,
+                  XV_VidC_Verbose VerboseEn);
+
+static void
+xvidc_disp_displayid_interface_features(
+                  const struct xvidc_displayid_data_block_header * const header,
+                  XV_VidC_EdidCntrlParam *EdidCtrlParam,
+                  XV_VidC_Verbose VerboseEn);
+
+static void
+xvidc_disp_displayid(const struct xvidc_edid_extension * const ext,
+                  XV_VidC_EdidCntrlParam *EdidCtrlParam,
+                  XV_VidC_Verbose VerboseEn);
+
 static void
 xvidc_disp_edid1(const struct edid * const edid,
                   XV_VidC_EdidCntrlParam *EdidCtrlParam,
@@ -917,7 +945,9 @@ xvidc_disp_cea861_video_data(
         const struct xvidc_cea861_timing * const timing =
             &xvidc_cea861_timings[Vic];
 
-        EdidCtrlParam->SuppCeaVIC[i] = Vic;
+        if (i < sizeof(EdidCtrlParam->SuppCeaVIC)) {
+            EdidCtrlParam->SuppCeaVIC[i] = Vic;
+        }
         if (VerboseEn) {
             xil_printf(" %s CEA Mode %02u: %4u x %4u%c @ %dHz\r\n",
                    Native ? "*" : " ",
@@ -933,6 +963,35 @@ xvidc_disp_cea861_video_data(
 }
 #endif
 
+/*****************************************************************************/
+/**
+*
+* This function records the VICs of a CEA 861 Video Data Block in the
+* supported VIC bitmap of the EDID Control parameter
+*
+* @param    vdb is a pointer to the Video Data Block.
+* @param    EdidCtrlParam is a pointer the EDID Control parameter
+*
+* @return None
+*
+* @note   SVDs 129 to 192 carry the native flag in bit 7.
+*
+******************************************************************************/
+static void
+xvidc_map_cea861_video_data(
+                  const struct xvidc_cea861_video_data_block * const vdb,
+                  XV_VidC_EdidCntrlParam *EdidCtrlParam) {
+    u8 Vic;
+
+    for (u8 i = 0; i < vdb->header.length; i++) {
+        Vic = vdb->svd[i].video_identification_code;
+        if (Vic >= 129 && Vic <= 192) {
+            Vic = Vic & 0x7F;
+        }
+        EdidCtrlParam->SuppCeaVicMap[Vic >> 5] |= (1U << (Vic & 0x1F));
+    }
+}
+
 /*****************************************************************************/
 /**
 *
@@ -1227,6 +1286,107 @@ xvidc_disp_cea861_speaker_allocation_data(
 }
 #endif
 
+/*****************************************************************************/
+/**
+*
+* This function parse a sequence of CEA 861 data blocks, as found in a CEA 861
+* extension or in a DisplayID CTA data block
+*
+* @param    data is a pointer to the first data block.
+* @param    length is the number of bytes of data blocks.
+* @param    EdidCtrlParam is a pointer the EDID Control parameter
+* @param    VerboseEn is a pointer to the XV_HdmiTxSs core instance.
+*
+* @return None
+*
+* @note   Parsing stops at a data block which does not fit in length.
+*
+******************************************************************************/
+static void
+xvidc_disp_cea861_data_blocks(const u8 * const data, u8 length,
+                  XV_VidC_EdidCntrlParam *EdidCtrlParam,
+                  XV_VidC_Verbose VerboseEn) {
+    u8 index = 0;
+
+    while (index < length) {
+        const struct xvidc_cea861_data_block_header * const header =
+            (struct xvidc_cea861_data_block_header *) &data[index];
+
+        if (header->length + sizeof(*header) > (u8)(length - index)) {
+            break;
+        }
+
+        switch (header->tag) {
+
+        case XVIDC_CEA861_DATA_BLOCK_TYPE_AUDIO:
+            {
+#if XVIDC_EDID_VERBOSITY > 1
+                const struct xvidc_cea861_audio_data_block * const db =
+                    (struct xvidc_cea861_audio_data_block *) header;
+
+                xvidc_disp_cea861_audio_data(db,EdidCtrlParam,VerboseEn);
+#endif
+            }
+            break;
+
+        case XVIDC_CEA861_DATA_BLOCK_TYPE_VIDEO:
+            {
+                const struct xvidc_cea861_video_data_block * const db =
+                    (struct xvidc_cea861_video_data_block *) header;
+
+                xvidc_map_cea861_video_data(db,EdidCtrlParam);
+#if XVIDC_EDID_VERBOSITY > 1
+                xvidc_disp_cea861_video_data(db,EdidCtrlParam,VerboseEn);
+#endif
+            }
+            break;
+
+        case XVIDC_CEA861_DATA_BLOCK_TYPE_VENDOR_SPECIFIC:
+            {
+                const struct
+                xvidc_cea861_vendor_specific_data_block * const db =
+                 (struct xvidc_cea861_vendor_specific_data_block *) header;
+
+                xvidc_disp_cea861_vendor_data(db,EdidCtrlParam,VerboseEn);
+            }
+            break;
+
+        case XVIDC_CEA861_DATA_BLOCK_TYPE_SPEAKER_ALLOCATION:
+            {
+#if XVIDC_EDID_VERBOSITY > 1
+                const struct
+                xvidc_cea861_speaker_allocation_data_block * const db =
+              (struct xvidc_cea861_speaker_allocation_data_block *) header;
+
+                xvidc_disp_cea861_speaker_allocation_data(db,
+                                                  EdidCtrlParam,VerboseEn);
+#endif
+            }
+            break;
+
+        case XVIDC_CEA861_DATA_BLOCK_TYPE_EXTENDED:
+            {
+                const struct xvidc_cea861_extended_data_block * const db =
+                    (struct xvidc_cea861_extended_data_block *) header;
+
+               xvidc_disp_cea861_extended_data(db,EdidCtrlParam,VerboseEn);
+            }
+            break;
+
+        default:
+#if XVIDC_EDID_VERBOSITY > 1
+            if (VerboseEn) {
+                xil_printf("Unknown CEA-861 data block type 0x%02x\r\n",
+                        header->tag);
+            }
+#endif
+            break;
+        }
+
+        index = index + header->length + sizeof(*header);
+    }
+}
+
 /*****************************************************************************/
 /**
 *
@@ -1249,7 +1409,6 @@ xvidc_disp_cea861(const struct xvidc_edid_extension * const ext,
     const struct xvidc_cea861_timing_block * const ctb =
         (struct xvidc_cea861_timing_block *) ext;
     const u8 offset = offsetof(struct xvidc_cea861_timing_block, data);
-    u8 index = 0;
 
 #if XVIDC_EDID_VERBOSITY > 1
     const struct xvidc_edid_detailed_timing_descriptor *dtd = NULL;
@@ -1293,7 +1452,8 @@ xvidc_disp_cea861(const struct xvidc_edid_extension * const ext,
 #if XVIDC_EDID_VERBOSITY > 1
     dtd = (struct xvidc_edid_detailed_timing_descriptor *)
                                             ((u8 *) ctb + ctb->dtd_offset);
-    for (i = 0; dtd->pixel_clock; i++, dtd++) {
+    for (i = 0; ((u8 *) (dtd + 1) < (u8 *) ctb + XVIDC_EDID_BLOCK_SIZE) &&
+                                            dtd->pixel_clock; i++, dtd++) {
 
         timing_params = XV_VidC_timing(dtd);
         if (VerboseEn) {
@@ -1334,79 +1494,231 @@ xvidc_disp_cea861(const struct xvidc_edid_extension * const ext,
         }
 #endif
 
-    if (ctb->revision >= 3) {
-        do {
-            const struct xvidc_cea861_data_block_header * const header =
-                (struct xvidc_cea861_data_block_header *) &ctb->data[index];
+    /* Data blocks end at the first detailed timing, within the block */
+    if ((ctb->revision >= 3) && (ctb->dtd_offset > offset)) {
+        xvidc_disp_cea861_data_blocks(ctb->data,
+              ((ctb->dtd_offset < XVIDC_EDID_BLOCK_SIZE - 1) ?
+                ctb->dtd_offset : XVIDC_EDID_BLOCK_SIZE - 1) - offset,
+              EdidCtrlParam, VerboseEn);
+    }
+#if XVIDC_EDID_VERBOSITY > 0
+    if (VerboseEn) {
+        xil_printf("\r\n");
+    }
+#endif
+}
 
-            switch (header->tag) {
 
-            case XVIDC_CEA861_DATA_BLOCK_TYPE_AUDIO:
-                {
-#if XVIDC_EDID_VERBOSITY > 1
-                    const struct xvidc_cea861_audio_data_block * const db =
-                        (struct xvidc_cea861_audio_data_block *) header;
+/*****************************************************************************/
+/**
+*
+* This function parse a DisplayID Type I or Type VII Detailed Timing data
+* block into the DisplayID timings of the EDID Control parameter
+*
+* @param    header is a pointer to the data block.
+* @param    ClkUnitKhz is the pixel clock unit of the descriptors in kHz.
+* @param    DescSize is the size of a descriptor in bytes.
+* @param    EdidCtrlParam is a pointer the EDID Control parameter
+* @param    VerboseEn is a pointer to the XV_HdmiTxSs core instance.
+*
+* @return None
+*
+* @note   Descriptors beyond the size of DispIdTiming only update
+*         MaxDispIdPixClkKhz.
+*
+******************************************************************************/
+static void
+xvidc_disp_displayid_timing(
+                  const struct xvidc_displayid_data_block_header * const header,
+                  u8 ClkUnitKhz, u8 DescSize,
+                  XV_VidC_EdidCntrlParam *EdidCtrlParam,
+                  XV_VidC_Verbose VerboseEn) {
+    const u8 * const desc = (const u8 *) (header + 1);
+    const struct xvidc_displayid_detailed_timing_descriptor *dtd;
+    u32 PixClkKhz;
+    u8 Offset;
+
+    for (Offset = 0; (u32)Offset + DescSize <= header->length;
+                                                    Offset += DescSize) {
+        dtd = (struct xvidc_displayid_detailed_timing_descriptor *)
+                                                            &desc[Offset];
+        PixClkKhz = (((u32)dtd->pixel_clock[0] |
+                      ((u32)dtd->pixel_clock[1] << 8) |
+                      ((u32)dtd->pixel_clock[2] << 16)) + 1) * ClkUnitKhz;
+        if (PixClkKhz > EdidCtrlParam->MaxDispIdPixClkKhz) {
+            EdidCtrlParam->MaxDispIdPixClkKhz = PixClkKhz;
+        }
+        if (EdidCtrlParam->NumDispIdTiming <
+                                ARRAY_SIZE(EdidCtrlParam->DispIdTiming)) {
+            EdidCtrlParam->DispIdTiming[EdidCtrlParam->NumDispIdTiming++] =
+                                        XV_VidC_DispIdTiming(dtd, PixClkKhz);
+        }
+#if XVIDC_EDID_VERBOSITY > 0
+        if (VerboseEn) {
+            const XV_VidC_TimingParam timing_params =
+                                        XV_VidC_DispIdTiming(dtd, PixClkKhz);
 
-                    xvidc_disp_cea861_audio_data(db,EdidCtrlParam,VerboseEn);
+            xil_printf("  Detailed timing.......... %ux%u%c at %uHz, "
+                                                    "%u kHz%s\r\n",
+                                        timing_params.hres,
+                                        timing_params.vres,
+                                        timing_params.vidfrmt ? 'i' : 'p',
+                                        timing_params.vfreq,
+                                        PixClkKhz,
+                                        (dtd->options & 0x80) ?
+                                                    " (preferred)" : "");
+        }
 #endif
-                }
-                break;
+    }
+}
 
-            case XVIDC_CEA861_DATA_BLOCK_TYPE_VIDEO:
-                {
-#if XVIDC_EDID_VERBOSITY > 1
-                    const struct xvidc_cea861_video_data_block * const db =
-                        (struct xvidc_cea861_video_data_block *) header;
+/*****************************************************************************/
+/**
+*
+* This function parse a DisplayID Display Interface Features data block into
+* the color space and deep color support of the EDID Control parameter
+*
+* @param    header is a pointer to the data block.
+* @param    EdidCtrlParam is a pointer the EDID Control parameter
+* @param    VerboseEn is a pointer to the XV_HdmiTxSs core instance.
+*
+* @return None
+*
+* @note   The first four payload bytes hold the supported bits per component
+*         of RGB, YCbCr 4:4:4 (bit 0 6 bpc to bit 5 16 bpc), YCbCr 4:2:2 and
+*         YCbCr 4:2:0 (bit 0 8 bpc to bit 4 16 bpc). Support is only ever
+*         added to what the CEA 861 extensions report.
+*
+******************************************************************************/
+static void
+xvidc_disp_displayid_interface_features(
+                  const struct xvidc_displayid_data_block_header * const header,
+                  XV_VidC_EdidCntrlParam *EdidCtrlParam,
+                  XV_VidC_Verbose VerboseEn) {
+    const u8 * const payload = (const u8 *) (header + 1);
+
+    if (header->length < 4) {
+        return;
+    }
 
-                    xvidc_disp_cea861_video_data(db,EdidCtrlParam,VerboseEn);
+    if (payload[0] & 0x04) {
+        EdidCtrlParam->Is30bppSupp = XVIDC_SUPPORTED;
+    }
+    if (payload[0] & 0x08) {
+        EdidCtrlParam->Is36bppSupp = XVIDC_SUPPORTED;
+    }
+    if (payload[0] & 0x20) {
+        EdidCtrlParam->Is48bppSupp = XVIDC_SUPPORTED;
+    }
+    if (payload[1] != 0) {
+        EdidCtrlParam->IsYCbCr444Supp = XVIDC_SUPPORTED;
+    }
+    if (payload[1] & 0x3C) {
+        EdidCtrlParam->IsYCbCr444DeepColSupp = XVIDC_SUPPORTED;
+    }
+    if (payload[2] != 0) {
+        EdidCtrlParam->IsYCbCr422Supp = XVIDC_SUPPORTED;
+    }
+    if (payload[3] != 0) {
+        EdidCtrlParam->IsYCbCr420Supp = XVIDC_SUPPORTED;
+    }
+    if (payload[3] & 0x02) {
+        EdidCtrlParam->IsYCbCr420dc30bppSupp = XVIDC_SUPPORTED;
+    }
+    if (payload[3] & 0x04) {
+        EdidCtrlParam->IsYCbCr420dc36bppSupp = XVIDC_SUPPORTED;
+    }
+    if (payload[3] & 0x10) {
+        EdidCtrlParam->IsYCbCr420dc48bppSupp = XVIDC_SUPPORTED;
+    }
+#if XVIDC_EDID_VERBOSITY > 0
+    if (VerboseEn) {
+        xil_printf("  Color depth support...... RGB 0x%02x, YCbCr 4:4:4 "
+                   "0x%02x, 4:2:2 0x%02x, 4:2:0 0x%02x\r\n",
+                   payload[0], payload[1], payload[2], payload[3]);
+    }
 #endif
-                }
-                break;
+}
 
-            case XVIDC_CEA861_DATA_BLOCK_TYPE_VENDOR_SPECIFIC:
-                {
-                    const struct
-                    xvidc_cea861_vendor_specific_data_block * const db =
-                     (struct xvidc_cea861_vendor_specific_data_block *) header;
+/*****************************************************************************/
+/**
+*
+* This function Parse and Display the DisplayID extension
+*
+* @param    ext is a pointer to the DisplayID extension block.
+* @param    EdidCtrlParam is a pointer the EDID Control parameter
+* @param    VerboseEn is a pointer to the XV_HdmiTxSs core instance.
+*
+* @return None
+*
+* @note   Only the section of the extension block is parsed, parsing stops
+*         at a data block which does not fit in it.
+*
+******************************************************************************/
+static void
+xvidc_disp_displayid(const struct xvidc_edid_extension * const ext,
+                  XV_VidC_EdidCntrlParam *EdidCtrlParam,
+                  XV_VidC_Verbose VerboseEn) {
+    const struct xvidc_displayid_extension * const dext =
+        (struct xvidc_displayid_extension *) ext;
+    /* The last byte of the section data is the section checksum */
+    const u8 length = (dext->bytes < sizeof(dext->data)) ?
+                                dext->bytes : (sizeof(dext->data) - 1);
+    const struct xvidc_displayid_data_block_header *header;
+    u8 index = 0;
 
-                    xvidc_disp_cea861_vendor_data(db,EdidCtrlParam,VerboseEn);
-                }
-                break;
+#if XVIDC_EDID_VERBOSITY > 0
+    if (VerboseEn) {
+        xil_printf("DisplayID Information\r\n");
+        xil_printf("  Version.................. %u.%u\r\n",
+               dext->version >> 4, dext->version & 0xF);
+    }
+#endif
 
-            case XVIDC_CEA861_DATA_BLOCK_TYPE_SPEAKER_ALLOCATION:
-                {
-#if XVIDC_EDID_VERBOSITY > 1
-                    const struct
-                    xvidc_cea861_speaker_allocation_data_block * const db =
-                  (struct xvidc_cea861_speaker_allocation_data_block *) header;
+    while ((u32)index + sizeof(*header) <= length) {
+        header = (struct xvidc_displayid_data_block_header *)
+                                                        &dext->data[index];
+        if (header->length > length - index - sizeof(*header)) {
+            break;
+        }
 
-                    xvidc_disp_cea861_speaker_allocation_data(db,
-                                                      EdidCtrlParam,VerboseEn);
-#endif
-                }
-                break;
+        switch (header->tag) {
 
-            case XVIDC_CEA861_DATA_BLOCK_TYPE_EXTENDED:
-                {
-                    const struct xvidc_cea861_extended_data_block * const db =
-                        (struct xvidc_cea861_extended_data_block *) header;
+        case XVIDC_DISPLAYID_DATA_BLOCK_TYPE_I_TIMING:
+            xvidc_disp_displayid_timing(header, 10,
+                  sizeof(struct xvidc_displayid_detailed_timing_descriptor),
+                  EdidCtrlParam, VerboseEn);
+            break;
 
-                   xvidc_disp_cea861_extended_data(db,EdidCtrlParam,VerboseEn);
-                }
-                break;
+        case XVIDC_DISPLAYID_DATA_BLOCK_TYPE_VII_TIMING:
+            /* Bits 6:4 of the revision hold the bytes beyond 20 */
+            xvidc_disp_displayid_timing(header, 1,
+                  sizeof(struct xvidc_displayid_detailed_timing_descriptor) +
+                                            ((header->revision >> 4) & 0x7),
+                  EdidCtrlParam, VerboseEn);
+            break;
 
-            default:
+        case XVIDC_DISPLAYID_DATA_BLOCK_INTERFACE_FEATURES:
+            xvidc_disp_displayid_interface_features(header,
+                                                    EdidCtrlParam, VerboseEn);
+            break;
+
+        case XVIDC_DISPLAYID_DATA_BLOCK_CTA:
+            xvidc_disp_cea861_data_blocks((const u8 *) (header + 1),
+                                header->length, EdidCtrlParam, VerboseEn);
+            break;
+
+        default:
 #if XVIDC_EDID_VERBOSITY > 1
-                if (VerboseEn) {
-                    xil_printf("Unknown CEA-861 data block type 0x%02x\r\n",
-                            header->tag);
-                }
-#endif
-                break;
+            if (VerboseEn) {
+                xil_printf("Unknown DisplayID data block type 0x%02x\r\n",
+                        header->tag);
             }
+#endif
+            break;
+        }
 
-            index = index + header->length + sizeof(*header);
-        } while (index < ctb->dtd_offset - offset);
+        index = index + header->length + sizeof(*header);
     }
 #if XVIDC_EDID_VERBOSITY > 0
     if (VerboseEn) {
@@ -1436,6 +1748,7 @@ static const struct xvidc_edid_extension_handler {
 	[XVIDC_EDID_EXTENSION_DI]             = { NULL },
 	[XVIDC_EDID_EXTENSION_LS]             = { NULL },
 	[XVIDC_EDID_EXTENSION_MI]             = { NULL },
+	[XVIDC_EDID_EXTENSION_DISPLAYID]      = { xvidc_disp_displayid },
 	[XVIDC_EDID_EXTENSION_DTCDB_1]        = { NULL },
 	[XVIDC_EDID_EXTENSION_DTCDB_2]        = { NULL },
 	[XVIDC_EDID_EXTENSION_DTCDB_3]        = { NULL },
@@ -1447,9 +1760,11 @@ static const struct xvidc_edid_extension_handler {
 /*****************************************************************************/
 /**
 *
-* This function parse and print the EDID of the Sink
+* This function parse the base block and the given number of extension blocks
+* of the EDID of the Sink
 *
 * @param    data is a pointer to the EDID array.
+* @param    NumExt is the number of extension blocks to parse.
 * @param    EdidCtrlParam is a pointer the EDID Control parameter
 * @param    VerboseEn is a pointer to the XV_HdmiTxSs core instance.
 *
@@ -1458,8 +1773,8 @@ static const struct xvidc_edid_extension_handler {
 * @note   None.
 *
 ******************************************************************************/
-void
-XV_VidC_parse_edid(const u8 * const data,
+static void
+xvidc_parse_edid(const u8 * const data, u8 NumExt,
                   XV_VidC_EdidCntrlParam *EdidCtrlParam,
                   XV_VidC_Verbose VerboseEn) {
     const struct edid * const edid = (struct edid *) data;
@@ -1470,7 +1785,7 @@ XV_VidC_parse_edid(const u8 * const data,
 
     xvidc_disp_edid1(edid,EdidCtrlParam,VerboseEn);
 
-    for (u8 i = 0; i < edid->extensions; i++) {
+    for (u8 i = 0; i < NumExt; i++) {
         const struct xvidc_edid_extension * const extension = &extensions[i];
         const struct xvidc_edid_extension_handler * const handler =
             &xvidc_edid_extension_handlers[extension->tag];
@@ -1488,3 +1803,135 @@ XV_VidC_parse_edid(const u8 * const data,
         }
     }
 }
+
+/*****************************************************************************/
+/**
+*
+* This function parse and print the EDID of the Sink
+*
+* @param    data is a pointer to the EDID array.
+* @param    EdidCtrlParam is a pointer the EDID Control parameter
+* @param    VerboseEn is a pointer to the XV_HdmiTxSs core instance.
+*
+* @return None
+*
+* @note   data must hold the number of extension blocks the base block
+*         reports, use XV_VidC_parse_edid_cached when it may not.
+*
+******************************************************************************/
+void
+XV_VidC_parse_edid(const u8 * const data,
+                  XV_VidC_EdidCntrlParam *EdidCtrlParam,
+                  XV_VidC_Verbose VerboseEn) {
+    const struct edid * const edid = (struct edid *) data;
+
+    xvidc_parse_edid(data, edid->extensions, EdidCtrlParam, VerboseEn);
+}
+
+/*****************************************************************************/
+/**
+*
+* This function computes the signature of an EDID over the contents of the
+* base block and of the given number of extension blocks
+*
+* @param    data is a pointer to the EDID array.
+* @param    NumExt is the number of extension blocks to include.
+*
+* @return Signature of the EDID, never 0.
+*
+* @note   None.
+*
+******************************************************************************/
+static u32
+xvidc_edid_signature(const u8 * const data, u8 NumExt) {
+    const u32 Size = ((u32)NumExt + 1) * XVIDC_EDID_BLOCK_SIZE;
+    u32 Lane[4];
+    u32 Signature;
+    u32 Word;
+    u32 Offset;
+    u8 Index;
+
+#define XVIDC_ROTL(x, r)                        (((x) << (r)) | ((x) >> (32 - (r))))
+    /* xxHash32 over every byte, seeded with the number of extensions, with
+     * four independent lanes of 32-bit words */
+    Lane[0] = NumExt + 0x9E3779B1 + 0x85EBCA77;
+    Lane[1] = NumExt + 0x85EBCA77;
+    Lane[2] = NumExt;
+    Lane[3] = NumExt - 0x9E3779B1;
+    for (Offset = 0; Offset < Size; Offset += 16) {
+        for (Index = 0; Index < 4; Index++) {
+            Word = (u32)data[Offset + (Index * 4)] |
+                   ((u32)data[Offset + (Index * 4) + 1] << 8) |
+                   ((u32)data[Offset + (Index * 4) + 2] << 16) |
+                   ((u32)data[Offset + (Index * 4) + 3] << 24);
+            Lane[Index] += Word * 0x85EBCA77;
+            Lane[Index] = XVIDC_ROTL(Lane[Index], 13) * 0x9E3779B1;
+        }
+    }
+
+    Signature = XVIDC_ROTL(Lane[0], 1) + XVIDC_ROTL(Lane[1], 7) +
+                XVIDC_ROTL(Lane[2], 12) + XVIDC_ROTL(Lane[3], 18) + Size;
+    Signature ^= Signature >> 15;
+    Signature *= 0x85EBCA77;
+    Signature ^= Signature >> 13;
+    Signature *= 0xC2B2AE3D;
+    Signature ^= Signature >> 16;
+#undef XVIDC_ROTL
+
+    return (Signature != 0) ? Signature : 1;
+}
+
+/*****************************************************************************/
+/**
+*
+* This function parses the EDID of the Sink unless EdidCtrlParam already holds
+* the parameters of the same EDID, identified by a signature of the contents
+* of all its blocks
+*
+* @param    data is a pointer to the EDID array.
+* @param    Length is the number of bytes of the EDID array.
+* @param    EdidCtrlParam is a pointer the EDID Control parameter
+* @param    VerboseEn is a pointer to the XV_HdmiTxSs core instance.
+*
+* @return
+*           - TRUE if the EDID was parsed into EdidCtrlParam.
+*           - FALSE if EdidCtrlParam already held the parameters of the EDID.
+*
+* @note   EdidCtrlParam must be initialized with XV_VidC_EdidCtrlParamInit or
+*         a previous parse. The EDID is always parsed when VerboseEn is set.
+*         Extension blocks which the base block reports but which are not
+*         within Length are ignored. A hit reads every byte of the EDID and
+*         costs about as much as a parse at XVIDC_EDID_VERBOSITY 0, the
+*         return value tells the caller whether the Sink capabilities can
+*         have changed.
+*
+******************************************************************************/
+u8
+XV_VidC_parse_edid_cached(const u8 * const data, u32 Length,
+                  XV_VidC_EdidCntrlParam *EdidCtrlParam,
+                  XV_VidC_Verbose VerboseEn) {
+    const struct edid * const edid = (struct edid *) data;
+    u32 Signature;
+    u8 NumExt;
+
+    /* Verify arguments. */
+    Xil_AssertNonvoid(data != NULL);
+    Xil_AssertNonvoid(Length >= XVIDC_EDID_BLOCK_SIZE);
+    Xil_AssertNonvoid(EdidCtrlParam != NULL);
+
+    NumExt = edid->extensions;
+    if (NumExt > (Length / XVIDC_EDID_BLOCK_SIZE) - 1) {
+        NumExt = (Length / XVIDC_EDID_BLOCK_SIZE) - 1;
+    }
+
+    Signature = xvidc_edid_signature(data, NumExt);
+    if ((VerboseEn == XVIDC_VERBOSE_DISABLE) &&
+                    (EdidCtrlParam->EdidSignature == Signature)) {
+        return FALSE;
+    }
+
+    xvidc_parse_edid(data, NumExt, EdidCtrlParam, VerboseEn);
+    EdidCtrlParam->EdidSignature = Signature;
+
+    return TRUE;
+}
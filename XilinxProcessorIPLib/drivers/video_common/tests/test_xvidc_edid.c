@@ -0,0 +1,716 @@
+/******************************************************************************
+* Copyright (C) 2020 Xilinx, Inc.  All rights reserved.
+* SPDX-License-Identifier: MIT
+******************************************************************************/
+
+/*****************************************************************************/
+/**
+*
+* @file test_xvidc_edid.c
+*
+* Host test and benchmark of the EDID parser. A corpus of EDIDs, the sink
+* EDIDs of the HDMI and DisplayPort example designs and a DisplayID 2.0 EDID,
+* is parsed with XV_VidC_parse_edid_cached() and the capabilities checked
+* against values decoded by hand. The cache is checked to reparse on any
+* change of the EDID contents, the parse to stay within the given length and
+* the DisplayID and CEA 861 data block walks within their blocks, the EDID
+* placed before an inaccessible page to fault on any read past it. The
+* benchmark reports the time of a parse and of a cache hit for every EDID, a
+* hit computes the signature over every byte of the EDID.
+*
+* Build and run on the host:
+*   cc -Wall -O2 -I. -I../src -I../../../../lib/bsp/standalone/src/common \
+*      test_xvidc_edid.c -o test_xvidc_edid
+*   ./test_xvidc_edid
+*
+******************************************************************************/
+
+/***************************** Include Files *********************************/
+
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/mman.h>
+
+/* Build the standalone (non Linux) flavour of the driver */
+#undef __linux__
+#include "xil_types.h"
+
+/* xil_printf.h pulls in the BSP configuration, use the host printf */
+#define XIL_PRINTF_H
+#define xil_printf printf
+
+#include "xvidc_edid_ext.c"
+#include "xvidc_parse_edid.c"
+
+/************************** Stubs ********************************************/
+
+u32 Xil_AssertStatus;
+s32 Xil_AssertWait;
+
+void Xil_Assert(const char8 *File, s32 Line)
+{
+  printf("ASSERT %s:%d\n", File, (int)Line);
+}
+
+/************************** Constant Definitions *****************************/
+
+#define BENCH_PARSES            20000
+
+/* Capability flags of the corpus expectations */
+#define CAP_YCBCR444            0x001
+#define CAP_YCBCR422            0x002
+#define CAP_YCBCR420            0x004
+#define CAP_YCBCR444_DC         0x008
+#define CAP_30BPP               0x010
+#define CAP_36BPP               0x020
+#define CAP_48BPP               0x040
+#define CAP_YCBCR420_30BPP      0x080
+#define CAP_YCBCR420_36BPP      0x100
+#define CAP_YCBCR420_48BPP      0x200
+
+/************************** Corpus *******************************************/
+
+/* Xilinx HDMI 2.0 sink, v_hdmirxss examples */
+static const u8 EdidHdmi20[256] = {
+  0x00, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0x00, 0x61, 0x98, 0x34, 0x12,
+  0x78, 0x56, 0x34, 0x12, 0x0E, 0x1C, 0x01, 0x03, 0x80, 0xA0, 0x5A, 0x78,
+  0x0A, 0xEE, 0x91, 0xA3, 0x54, 0x4C, 0x99, 0x26, 0x0F, 0x50, 0x54, 0x21,
+  0x08, 0x00, 0x71, 0x4F, 0x81, 0xC0, 0x81, 0x00, 0x81, 0x80, 0x95, 0x00,
+  0xA9, 0xC0, 0xB3, 0x00, 0x01, 0x01, 0x08, 0xE8, 0x00, 0x30, 0xF2, 0x70,
+  0x5A, 0x80, 0xB0, 0x58, 0x8A, 0x00, 0x40, 0x84, 0x63, 0x00, 0x00, 0x1E,
+  0x02, 0x3A, 0x80, 0x18, 0x71, 0x38, 0x2D, 0x40, 0x58, 0x2C, 0x45, 0x00,
+  0x40, 0x84, 0x63, 0x00, 0x00, 0x1E, 0x00, 0x00, 0x00, 0xFD, 0x00, 0x18,
+  0x4B, 0x0F, 0x8C, 0x3C, 0x00, 0x0A, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20,
+  0x00, 0x00, 0x00, 0xFC, 0x00, 0x58, 0x49, 0x4C, 0x49, 0x4E, 0x58, 0x20,
+  0x48, 0x44, 0x4D, 0x49, 0x0A, 0x20, 0x01, 0x85, 0x02, 0x03, 0x3B, 0xF1,
+  0x57, 0x61, 0x10, 0x1F, 0x04, 0x13, 0x05, 0x14, 0x20, 0x21, 0x22, 0x5D,
+  0x5E, 0x5F, 0x60, 0x65, 0x66, 0x62, 0x63, 0x64, 0x07, 0x16, 0x03, 0x12,
+  0x23, 0x09, 0x07, 0x07, 0x6B, 0x03, 0x0C, 0x00, 0x10, 0x00, 0x78, 0x3C,
+  0x20, 0x00, 0x20, 0x03, 0x67, 0xD8, 0x5D, 0xC4, 0x01, 0x78, 0x80, 0x07,
+  0xE3, 0x0F, 0x01, 0xE0, 0xE2, 0x00, 0xCF, 0x02, 0x3A, 0x80, 0x18, 0x71,
+  0x38, 0x2D, 0x40, 0x58, 0x2C, 0x45, 0x00, 0x20, 0xC2, 0x31, 0x00, 0x00,
+  0x1E, 0x08, 0xE8, 0x00, 0x30, 0xF2, 0x70, 0x5A, 0x80, 0xB0, 0x58, 0x8A,
+  0x00, 0x20, 0xC2, 0x31, 0x00, 0x00, 0x1E, 0x04, 0x74, 0x00, 0x30, 0xF2,
+  0x70, 0x5A, 0x80, 0xB0, 0x58, 0x8A, 0x00, 0x20, 0x52, 0x31, 0x00, 0x00,
+  0x1E, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+  0x00, 0x00, 0x00, 0xDC
+};
+
+/* Xilinx HDMI 2.1 sink, v_hdmirxss1 examples */
+static const u8 EdidHdmi21[256] = {
+  0x00, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0x00, 0x61, 0x98, 0x34, 0x12,
+  0x78, 0x56, 0x34, 0x12, 0x17, 0x1D, 0x01, 0x03, 0x80, 0xA0, 0x5A, 0x78,
+  0x0A, 0xEE, 0x91, 0xA3, 0x54, 0x4C, 0x99, 0x26, 0x0F, 0x50, 0x54, 0x21,
+  0x00, 0x00, 0x01, 0x01, 0x01, 0x01, 0x01, 0x01, 0x01, 0x01, 0x01, 0x01,
+  0x01, 0x01, 0x01, 0x01, 0x01, 0x01, 0x08, 0xE8, 0x00, 0x30, 0xF2, 0x70,
+  0x5A, 0x80, 0xB0, 0x58, 0x8A, 0x00, 0x20, 0xC2, 0x31, 0x00, 0x00, 0x1E,
+  0x02, 0x3A, 0x80, 0x18, 0x71, 0x38, 0x2D, 0x40, 0x58, 0x2C, 0x45, 0x00,
+  0x20, 0xC2, 0x31, 0x00, 0x00, 0x1E, 0x00, 0x00, 0x00, 0xFD, 0x00, 0x18,
+  0x90, 0x0F, 0x8C, 0x3C, 0x00, 0x0A, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20,
+  0x00, 0x00, 0x00, 0xFC, 0x00, 0x58, 0x49, 0x4C, 0x49, 0x4E, 0x58, 0x20,
+  0x48, 0x44, 0x4D, 0x49, 0x32, 0x31, 0x01, 0x53, 0x02, 0x03, 0x44, 0xF1,
+  0x56, 0xC4, 0xC3, 0xC2, 0xD4, 0xD3, 0xD2, 0xC1, 0x7F, 0x7E, 0x7D, 0xDB,
+  0xDA, 0x66, 0x65, 0x76, 0x75, 0x61, 0x60, 0x3F, 0x40, 0x10, 0x1F, 0x2C,
+  0x0F, 0x7F, 0x07, 0x5F, 0x7C, 0x01, 0x57, 0x06, 0x03, 0x67, 0x7E, 0x03,
+  0x6B, 0x03, 0x0C, 0x00, 0x10, 0x00, 0x38, 0x3C, 0x20, 0x00, 0x20, 0x03,
+  0x67, 0xD8, 0x5D, 0xC4, 0x01, 0x78, 0x80, 0x63, 0xE4, 0x0F, 0x09, 0xCC,
+  0x00, 0xE2, 0x00, 0xCF, 0x08, 0xE8, 0x00, 0x30, 0xF2, 0x70, 0x5A, 0x80,
+  0xB0, 0x58, 0x8A, 0x00, 0x20, 0xC2, 0x31, 0x00, 0x00, 0x1E, 0x04, 0x74,
+  0x00, 0x30, 0xF2, 0x70, 0x5A, 0x80, 0xB0, 0x58, 0x8A, 0x00, 0x20, 0xC2,
+  0x31, 0x00, 0x00, 0x1E, 0x02, 0x3A, 0x80, 0x18, 0x71, 0x38, 0x2D, 0x40,
+  0x58, 0x2C, 0x45, 0x00, 0x20, 0xC2, 0x31, 0x00, 0x00, 0x1E, 0x00, 0x00,
+  0x00, 0x00, 0x00, 0x94
+};
+
+/* Dell UP2718Q, dp14txss examples */
+static const u8 EdidDellUp2718q[256] = {
+  0x00, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0x00, 0x10, 0xAC, 0x19, 0x41,
+  0x4C, 0x33, 0x32, 0x30, 0x0C, 0x1B, 0x01, 0x04, 0xB5, 0x3C, 0x22, 0x78,
+  0x3A, 0x27, 0x15, 0xAC, 0x51, 0x35, 0xB5, 0x26, 0x0E, 0x50, 0x54, 0xA5,
+  0x4B, 0x00, 0xD1, 0x00, 0xD1, 0xC0, 0xB3, 0x00, 0xA9, 0x40, 0x81, 0x80,
+  0x81, 0x00, 0x71, 0x4F, 0xE1, 0xC0, 0x4D, 0xD0, 0x00, 0xA0, 0xF0, 0x70,
+  0x3E, 0x80, 0x30, 0x20, 0x35, 0x00, 0x55, 0x50, 0x21, 0x00, 0x00, 0x1A,
+  0x00, 0x00, 0x00, 0xFF, 0x00, 0x37, 0x33, 0x4B, 0x30, 0x32, 0x37, 0x33,
+  0x4C, 0x30, 0x32, 0x33, 0x4C, 0x0A, 0x00, 0x00, 0x00, 0xFC, 0x00, 0x44,
+  0x45, 0x4C, 0x4C, 0x20, 0x55, 0x50, 0x32, 0x37, 0x31, 0x38, 0x51, 0x0A,
+  0x00, 0x00, 0x00, 0xFD, 0x00, 0x1D, 0x56, 0x1E, 0x8C, 0x36, 0x01, 0x0A,
+  0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x01, 0x30, 0x02, 0x03, 0x24, 0xF1,
+  0x4C, 0x10, 0x1F, 0x20, 0x05, 0x14, 0x04, 0x13, 0x12, 0x11, 0x03, 0x02,
+  0x01, 0x23, 0x09, 0x1F, 0x07, 0x83, 0x01, 0x00, 0x00, 0xE3, 0x05, 0xFF,
+  0x01, 0xE6, 0x06, 0x07, 0x01, 0x8B, 0x60, 0x11, 0xA3, 0x66, 0x00, 0xA0,
+  0xF0, 0x70, 0x1F, 0x80, 0x30, 0x20, 0x35, 0x00, 0x55, 0x50, 0x21, 0x00,
+  0x00, 0x1A, 0x56, 0x5E, 0x00, 0xA0, 0xA0, 0xA0, 0x29, 0x50, 0x30, 0x20,
+  0x35, 0x00, 0x55, 0x50, 0x21, 0x00, 0x00, 0x1A, 0x11, 0x44, 0x00, 0xA0,
+  0x80, 0x00, 0x1F, 0x50, 0x30, 0x20, 0x36, 0x00, 0x55, 0x50, 0x21, 0x00,
+  0x00, 0x1A, 0xBF, 0x16, 0x00, 0xA0, 0x80, 0x38, 0x13, 0x40, 0x30, 0x20,
+  0x3A, 0x00, 0x55, 0x50, 0x21, 0x00, 0x00, 0x1A, 0x00, 0x00, 0x00, 0x00,
+  0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+  0x00, 0x00, 0x00, 0x91
+};
+
+/* Xilinx DP 1.2 sink, dp12rxss examples */
+static const u8 EdidDp12[256] = {
+  0x00, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0x00, 0x61, 0x2C, 0x00, 0x00,
+  0x00, 0x00, 0x00, 0x00, 0x0E, 0x19, 0x01, 0x04, 0xB5, 0x3C, 0x22, 0x78,
+  0x3A, 0x4D, 0xD5, 0xA7, 0x55, 0x4A, 0x9D, 0x24, 0x0E, 0x50, 0x54, 0xBF,
+  0xEF, 0x00, 0xD1, 0xC0, 0x81, 0x40, 0x81, 0x80, 0x95, 0x00, 0xB3, 0x00,
+  0x71, 0x4F, 0x81, 0xC0, 0x01, 0x01, 0x4D, 0xD0, 0x00, 0xA0, 0xF0, 0x70,
+  0x3E, 0x80, 0x30, 0x20, 0x35, 0x00, 0x54, 0x4F, 0x21, 0x00, 0x00, 0x1A,
+  0x04, 0x74, 0x00, 0x30, 0xF2, 0x70, 0x5A, 0x80, 0xB0, 0x58, 0x8A, 0x00,
+  0x54, 0x4F, 0x21, 0x00, 0x00, 0x1A, 0x00, 0x00, 0x00, 0xFD, 0x00, 0x1D,
+  0x50, 0x18, 0xA0, 0x3C, 0x04, 0x11, 0x00, 0xF0, 0xF8, 0x38, 0xF0, 0x3C,
+  0x00, 0x00, 0x00, 0xFC, 0x00, 0x58, 0x49, 0x4C, 0x49, 0x4E, 0x58, 0x20,
+  0x44, 0x50, 0x0A, 0x20, 0x20, 0x20, 0x01, 0x19, 0x02, 0x03, 0x27, 0x71,
+  0x4F, 0x01, 0x02, 0x03, 0x11, 0x12, 0x13, 0x04, 0x14, 0x05, 0x1F, 0x90,
+  0x0E, 0x0F, 0x1D, 0x1E, 0x23, 0x09, 0x17, 0x07, 0x83, 0x01, 0x00, 0x00,
+  0x6A, 0x03, 0x0C, 0x00, 0x00, 0x00, 0x00, 0x78, 0x20, 0x00, 0x00, 0x56,
+  0x5E, 0x00, 0xA0, 0xA0, 0xA0, 0x29, 0x50, 0x30, 0x20, 0x35, 0x00, 0x54,
+  0x4F, 0x21, 0x00, 0x00, 0x1E, 0xE2, 0x68, 0x00, 0xA0, 0xA0, 0x40, 0x2E,
+  0x60, 0x30, 0x20, 0x36, 0x00, 0x54, 0x4F, 0x21, 0x00, 0x00, 0x1A, 0x01,
+  0x1D, 0x00, 0xBC, 0x52, 0xD0, 0x1E, 0x20, 0xB8, 0x28, 0x55, 0x40, 0x54,
+  0x4F, 0x21, 0x00, 0x00, 0x1E, 0x8C, 0x0A, 0xD0, 0x90, 0x20, 0x40, 0x31,
+  0x20, 0x0C, 0x40, 0x55, 0x00, 0x54, 0x4F, 0x21, 0x00, 0x00, 0x18, 0x00,
+  0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+  0x00, 0x00, 0x00, 0xF0
+};
+
+/* Xilinx DP 4K120 sink with DisplayID 1.2, dp14txss examples */
+static const u8 EdidDp4k120[256] = {
+  0x00, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0x00, 0x61, 0x98, 0x23, 0x01,
+  0x00, 0x00, 0x00, 0x00, 0x28, 0x1C, 0x01, 0x04, 0xB5, 0x3C, 0x22, 0x78,
+  0x26, 0x61, 0x50, 0xA6, 0x56, 0x50, 0xA0, 0x00, 0x0D, 0x50, 0x54, 0xA5,
+  0x6B, 0x80, 0xD1, 0xC0, 0x81, 0xC0, 0x81, 0x00, 0x81, 0x80, 0xA9, 0x00,
+  0xB3, 0x00, 0xD1, 0xFC, 0x01, 0x01, 0x04, 0x74, 0x00, 0x30, 0xF2, 0x70,
+  0x5A, 0x80, 0xB0, 0x58, 0x8A, 0x00, 0x54, 0x4F, 0x21, 0x00, 0x00, 0x1A,
+  0x4D, 0xD0, 0x00, 0xA0, 0xF0, 0x70, 0x3E, 0x80, 0x30, 0x20, 0x35, 0x00,
+  0x56, 0x50, 0x21, 0x00, 0x00, 0x1A, 0x00, 0x00, 0x00, 0xFD, 0x00, 0x1E,
+  0x3C, 0x32, 0xB4, 0x66, 0x01, 0x0A, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20,
+  0x00, 0x00, 0x00, 0xFC, 0x00, 0x58, 0x69, 0x6C, 0x69, 0x6E, 0x78, 0x20,
+  0x73, 0x69, 0x6E, 0x6B, 0x0A, 0x20, 0x01, 0x17, 0x70, 0x12, 0x6E, 0x00,
+  0x00, 0x81, 0x00, 0x04, 0x23, 0x09, 0x03, 0x07, 0x03, 0x00, 0x64, 0xEB,
+  0xA0, 0x01, 0x04, 0xFF, 0x0E, 0xA0, 0x00, 0x2F, 0x80, 0x21, 0x00, 0x6F,
+  0x08, 0x3E, 0x00, 0x03, 0x00, 0x05, 0x00, 0xFD, 0x68, 0x01, 0x04, 0xFF,
+  0x13, 0x4F, 0x00, 0x27, 0x80, 0x1F, 0x00, 0x3F, 0x0B, 0x51, 0x00, 0x43,
+  0x00, 0x07, 0x00, 0x65, 0x8E, 0x01, 0x04, 0xFF, 0x1D, 0x4F, 0x00, 0x07,
+  0x80, 0x1F, 0x00, 0xDF, 0x10, 0x3C, 0x00, 0x2E, 0x00, 0x07, 0x00, 0x86,
+  0x3D, 0x01, 0x04, 0xFF, 0x1D, 0x4F, 0x00, 0x07, 0x80, 0x1F, 0x00, 0xDF,
+  0x10, 0x30, 0x00, 0x22, 0x00, 0x07, 0x00, 0x5C, 0x7F, 0x01, 0x00, 0xFF,
+  0x0E, 0x4F, 0x00, 0x07, 0x80, 0x1F, 0x00, 0x6F, 0x08, 0x73, 0x00, 0x65,
+  0x00, 0x07, 0x00, 0x60, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+  0x00, 0x00, 0x00, 0x90
+};
+
+/* Xilinx DP 8K60 sink with CEA 861 and DisplayID 1.2, dp14txss examples */
+static const u8 EdidDp8k60[384] = {
+  0x00, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0x00, 0x61, 0x98, 0x01, 0x00,
+  0x01, 0x00, 0x00, 0x00, 0x00, 0x1C, 0x01, 0x04, 0xB5, 0x46, 0x27, 0x78,
+  0x3A, 0x73, 0x95, 0xAD, 0x51, 0x34, 0xB9, 0x26, 0x0D, 0x50, 0x54, 0xA5,
+  0x4B, 0x00, 0x81, 0x00, 0xB3, 0x00, 0xD1, 0x00, 0xA9, 0x40, 0x81, 0x80,
+  0xD1, 0xC0, 0x01, 0x01, 0x01, 0x01, 0x4D, 0xD0, 0x00, 0xA0, 0xF0, 0x70,
+  0x3E, 0x80, 0x30, 0x20, 0x35, 0x00, 0xB9, 0x88, 0x21, 0x00, 0x00, 0x1A,
+  0x00, 0x00, 0x00, 0xFF, 0x00, 0x30, 0x0A, 0x20, 0x20, 0x20, 0x20, 0x20,
+  0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x00, 0x00, 0x00, 0xFC, 0x00, 0x58,
+  0x69, 0x6C, 0x69, 0x6E, 0x78, 0x20, 0x38, 0x4B, 0x36, 0x30, 0x0A, 0x20,
+  0x00, 0x00, 0x00, 0xFD, 0x00, 0x18, 0x4B, 0x1E, 0xB4, 0x6C, 0x01, 0x0A,
+  0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x02, 0x4D, 0x02, 0x03, 0x1D, 0xF1,
+  0x50, 0x10, 0x1F, 0x20, 0x05, 0x14, 0x04, 0x13, 0x12, 0x11, 0x03, 0x02,
+  0x16, 0x15, 0x07, 0x06, 0x01, 0x23, 0x09, 0x1F, 0x07, 0x83, 0x01, 0x00,
+  0x00, 0xA3, 0x66, 0x00, 0xA0, 0xF0, 0x70, 0x1F, 0x80, 0x30, 0x20, 0x35,
+  0x00, 0xB9, 0x88, 0x21, 0x00, 0x00, 0x1A, 0x56, 0x5E, 0x00, 0xA0, 0xA0,
+  0xA0, 0x29, 0x50, 0x30, 0x20, 0x35, 0x00, 0xB9, 0x88, 0x21, 0x00, 0x00,
+  0x1A, 0x7C, 0x39, 0x00, 0xA0, 0x80, 0x38, 0x1F, 0x40, 0x30, 0x20, 0x3A,
+  0x00, 0xB9, 0x88, 0x21, 0x00, 0x00, 0x1A, 0xA8, 0x16, 0x00, 0xA0, 0x80,
+  0x38, 0x13, 0x40, 0x30, 0x20, 0x3A, 0x00, 0xB9, 0x88, 0x21, 0x00, 0x00,
+  0x1A, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+  0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+  0x00, 0x00, 0x00, 0x4F, 0x70, 0x12, 0x79, 0x00, 0x00, 0x12, 0x00, 0x16,
+  0x82, 0x10, 0x00, 0x00, 0xFF, 0x0E, 0xDF, 0x10, 0x00, 0x00, 0x00, 0x00,
+  0x00, 0x30, 0x30, 0x30, 0x01, 0x00, 0x01, 0x00, 0x00, 0x00, 0x03, 0x00,
+  0x3C, 0x70, 0x92, 0x01, 0x84, 0xFF, 0x1D, 0x9F, 0x00, 0x2F, 0x80, 0x1F,
+  0x00, 0xDF, 0x10, 0x3C, 0x00, 0x02, 0x00, 0x04, 0x00, 0x80, 0xA0, 0x01,
+  0x04, 0xFF, 0x0E, 0x9F, 0x00, 0x2F, 0x80, 0x1F, 0x00, 0xDF, 0x10, 0x7A,
+  0x00, 0x02, 0x00, 0x09, 0x00, 0x58, 0x4B, 0x01, 0x04, 0xFF, 0x0E, 0x9F,
+  0x00, 0x2F, 0x80, 0x1F, 0x00, 0xDF, 0x10, 0x61, 0x00, 0x02, 0x00, 0x09,
+  0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+  0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+  0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x1D, 0x90
+};
+
+/* Xilinx DP 8K30 only sink with DisplayID 1.2, dp14txss examples */
+static const u8 EdidDp8k30[256] = {
+  0x00, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0x00, 0x61, 0x98, 0x23, 0x01,
+  0x00, 0x00, 0x00, 0x00, 0x28, 0x1C, 0x01, 0x04, 0xA5, 0x3C, 0x22, 0x78,
+  0x3E, 0x61, 0x50, 0xA6, 0x56, 0x50, 0xA0, 0x00, 0x0D, 0x50, 0x54, 0x00,
+  0x00, 0x00, 0x01, 0x01, 0x01, 0x01, 0x01, 0x01, 0x01, 0x01, 0x01, 0x01,
+  0x01, 0x01, 0x01, 0x01, 0x01, 0x01, 0x00, 0x00, 0x00, 0x10, 0x00, 0x00,
+  0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+  0x00, 0x00, 0x00, 0x10, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+  0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x10, 0x00, 0x00,
+  0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+  0x00, 0x00, 0x00, 0xFC, 0x00, 0x38, 0x6B, 0x33, 0x30, 0x2D, 0x6F, 0x6E,
+  0x6C, 0x79, 0x0A, 0x20, 0x20, 0x20, 0x01, 0xFD, 0x70, 0x12, 0x1E, 0x00,
+  0x00, 0x81, 0x00, 0x04, 0x23, 0x08, 0x1F, 0x03, 0x03, 0x00, 0x14, 0x65,
+  0x8E, 0x01, 0x84, 0xFF, 0x1D, 0x4F, 0x00, 0x07, 0x80, 0x1F, 0x00, 0xDF,
+  0x10, 0x3C, 0x00, 0x2E, 0x00, 0x07, 0x00, 0xFE, 0x00, 0x00, 0x00, 0x00,
+  0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+  0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+  0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+  0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+  0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+  0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+  0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+  0x00, 0x00, 0x00, 0x90
+};
+
+/* DisplayID 2.0 sink, Type VII timings, interface features and CTA data */
+static const u8 EdidDispId20[256] = {
+  0x00, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0x00, 0x61, 0x98, 0x23, 0x01,
+  0x00, 0x00, 0x00, 0x00, 0x28, 0x1C, 0x01, 0x04, 0xA5, 0x3C, 0x22, 0x78,
+  0x3E, 0x61, 0x50, 0xA6, 0x56, 0x50, 0xA0, 0x00, 0x0D, 0x50, 0x54, 0x00,
+  0x00, 0x00, 0x01, 0x01, 0x01, 0x01, 0x01, 0x01, 0x01, 0x01, 0x01, 0x01,
+  0x01, 0x01, 0x01, 0x01, 0x01, 0x01, 0x00, 0x00, 0x00, 0x10, 0x00, 0x00,
+  0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+  0x00, 0x00, 0x00, 0x10, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+  0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x10, 0x00, 0x00,
+  0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+  0x00, 0x00, 0x00, 0xFC, 0x00, 0x38, 0x6B, 0x33, 0x30, 0x2D, 0x6F, 0x6E,
+  0x6C, 0x79, 0x0A, 0x20, 0x20, 0x20, 0x01, 0xFD, 0x70, 0x20, 0x3D, 0x03,
+  0x00, 0x22, 0x00, 0x28, 0x4F, 0x10, 0x09, 0x84, 0xFF, 0x0E, 0x2F, 0x02,
+  0xAF, 0x80, 0x57, 0x00, 0x6F, 0x08, 0x59, 0x00, 0x07, 0x80, 0x09, 0x00,
+  0x7F, 0x82, 0x48, 0x04, 0xFF, 0x1D, 0x27, 0x05, 0x5F, 0x81, 0xAF, 0x00,
+  0xDF, 0x10, 0x4F, 0x00, 0x0F, 0x80, 0x13, 0x00, 0x26, 0x00, 0x09, 0x2E,
+  0x06, 0x00, 0x05, 0x04, 0x00, 0x00, 0x00, 0x00, 0x81, 0x00, 0x03, 0x42,
+  0x61, 0x75, 0x3A, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+  0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+  0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+  0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+  0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+  0x00, 0x00, 0x00, 0x90
+};
+
+/**************************** Type Definitions *******************************/
+
+typedef struct {
+  const char *Name;
+  const u8 *Edid;
+  u32 Length;
+  XV_VidC_IsHdmi IsHdmi;
+  u16 MaxTmdsMhz;
+  u32 Caps;
+  u8 NumVics;
+  u8 Vics[24];
+  u8 NumDispIdTiming;
+  u32 MaxDispIdPixClkKhz;
+  /* First DisplayID timing */
+  u16 HRes;
+  u16 VRes;
+  u8 VFreq;
+  u32 PixClk;
+} CorpusEntry;
+
+/************************** Variable Definitions *****************************/
+
+#define EDID(Name)      #Name, Name, sizeof(Name)
+
+static const CorpusEntry Corpus[] = {
+  { EDID(EdidHdmi20), XVIDC_ISHDMI, 600,
+    CAP_YCBCR444 | CAP_YCBCR422 | CAP_YCBCR420 | CAP_YCBCR444_DC |
+    CAP_30BPP | CAP_36BPP | CAP_48BPP | CAP_YCBCR420_30BPP |
+    CAP_YCBCR420_36BPP | CAP_YCBCR420_48BPP,
+    23, { 3, 4, 5, 7, 16, 18, 19, 20, 22, 31, 32, 33, 34, 93, 94, 95, 96, 97,
+          98, 99, 100, 101, 102 },
+    0, 0, 0, 0, 0, 0 },
+  { EDID(EdidHdmi21), XVIDC_ISHDMI, 600,
+    CAP_YCBCR444 | CAP_YCBCR422 | CAP_YCBCR420 | CAP_YCBCR444_DC |
+    CAP_30BPP | CAP_36BPP | CAP_YCBCR420_30BPP | CAP_YCBCR420_36BPP,
+    22, { 16, 31, 63, 64, 96, 97, 101, 102, 117, 118, 125, 126, 127, 193, 194,
+          195, 196, 210, 211, 212, 218, 219 },
+    0, 0, 0, 0, 0, 0 },
+  { EDID(EdidDellUp2718q), XVIDC_ISDVI, 540,
+    CAP_YCBCR444 | CAP_YCBCR422,
+    12, { 1, 2, 3, 4, 5, 16, 17, 18, 19, 20, 31, 32 },
+    0, 0, 0, 0, 0, 0 },
+  { EDID(EdidDp12), XVIDC_ISHDMI, 600,
+    CAP_YCBCR444 | CAP_YCBCR422,
+    15, { 1, 2, 3, 4, 5, 14, 15, 16, 17, 18, 19, 20, 29, 30, 31 },
+    0, 0, 0, 0, 0, 0 },
+  /* Five Type I timings, only four are kept */
+  { EDID(EdidDp4k120), XVIDC_ISDVI, 1020, 0,
+    0, { 0 },
+    4, 1067320, 3840, 2160, 120, 1067320000 },
+  /* CEA 861 and DisplayID 1.2 extensions */
+  { EDID(EdidDp8k60), XVIDC_ISDVI, 1080,
+    CAP_YCBCR444 | CAP_YCBCR422,
+    16, { 1, 2, 3, 4, 5, 6, 7, 16, 17, 18, 19, 20, 21, 22, 31, 32 },
+    3, 1066250, 7680, 4320, 29, 1030250000 },
+  { EDID(EdidDp8k30), XVIDC_ISDVI, 0, 0,
+    0, { 0 },
+    1, 1019900, 7680, 4320, 30, 1019900000 },
+  /* 4752 MHz second timing, saturates the pixel clock in Hz */
+  { EDID(EdidDispId20), XVIDC_ISDVI, 0,
+    CAP_YCBCR444 | CAP_YCBCR420 | CAP_YCBCR444_DC | CAP_30BPP | CAP_36BPP |
+    CAP_48BPP | CAP_YCBCR420_36BPP,
+    2, { 97, 117 },
+    2, 4752000, 3840, 2160, 60, 594000000 },
+};
+
+static u32 Failures;
+
+/************************** Test Helpers *************************************/
+
+#define CHECK(Cond, Msg) \
+  do { \
+    if(!(Cond)) { \
+      printf("FAIL %s:%d: %s\n", __func__, __LINE__, (Msg)); \
+      Failures++; \
+    } \
+  } while(0)
+
+static u32 Caps(const XV_VidC_EdidCntrlParam *Param)
+{
+  return (Param->IsYCbCr444Supp ? CAP_YCBCR444 : 0) |
+         (Param->IsYCbCr422Supp ? CAP_YCBCR422 : 0) |
+         (Param->IsYCbCr420Supp ? CAP_YCBCR420 : 0) |
+         (Param->IsYCbCr444DeepColSupp ? CAP_YCBCR444_DC : 0) |
+         (Param->Is30bppSupp ? CAP_30BPP : 0) |
+         (Param->Is36bppSupp ? CAP_36BPP : 0) |
+         (Param->Is48bppSupp ? CAP_48BPP : 0) |
+         (Param->IsYCbCr420dc30bppSupp ? CAP_YCBCR420_30BPP : 0) |
+         (Param->IsYCbCr420dc36bppSupp ? CAP_YCBCR420_36BPP : 0) |
+         (Param->IsYCbCr420dc48bppSupp ? CAP_YCBCR420_48BPP : 0);
+}
+
+/* Copy of Edid ending where an inaccessible page starts */
+static u8 *GuardedCopy(const u8 *Edid, u32 Length)
+{
+  static u8 *Map;
+  long Page = sysconf(_SC_PAGESIZE);
+
+  if(Map == NULL) {
+    Map = mmap(NULL, 2 * Page, PROT_READ | PROT_WRITE,
+               MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if((Map == MAP_FAILED) || (mprotect(Map + Page, Page, PROT_NONE) != 0)) {
+      perror("mmap");
+      _exit(2);
+    }
+  }
+  memcpy(Map + Page - Length, Edid, Length);
+  return Map + Page - Length;
+}
+
+static void FixChecksum(u8 *Block)
+{
+  u8 Sum = 0;
+  u32 Index;
+
+  for(Index=0; Index<XVIDC_EDID_BLOCK_SIZE - 1; Index++) {
+    Sum += Block[Index];
+  }
+  Block[XVIDC_EDID_BLOCK_SIZE - 1] = (u8)(0x100 - Sum);
+}
+
+static double NowNs(void)
+{
+  struct timespec Ts;
+
+  clock_gettime(CLOCK_MONOTONIC, &Ts);
+  return ((double)Ts.tv_sec * 1e9) + (double)Ts.tv_nsec;
+}
+
+/************************** Tests ********************************************/
+
+/* Every corpus EDID decodes to its hand decoded capabilities */
+static void TestCorpus(void)
+{
+  XV_VidC_EdidCntrlParam Param;
+  const CorpusEntry *Entry;
+  u32 Index, Vic, NumVics;
+  u8 Listed;
+
+  for(Index=0; Index<ARRAY_SIZE(Corpus); Index++) {
+    Entry = &Corpus[Index];
+    XV_VidC_EdidCtrlParamInit(&Param);
+    CHECK(XV_VidC_parse_edid_cached(GuardedCopy(Entry->Edid, Entry->Length),
+                                    Entry->Length, &Param,
+                                    XVIDC_VERBOSE_DISABLE) == TRUE,
+          Entry->Name);
+
+    if((Param.IsHdmi != Entry->IsHdmi) ||
+       (Param.MaxTmdsMhz != Entry->MaxTmdsMhz) ||
+       (Caps(&Param) != Entry->Caps)) {
+      printf("FAIL %s: HDMI %d TMDS %u MHz caps 0x%03x, expected %d %u 0x%03x\n",
+             Entry->Name, Param.IsHdmi, Param.MaxTmdsMhz, Caps(&Param),
+             Entry->IsHdmi, Entry->MaxTmdsMhz, Entry->Caps);
+      Failures++;
+    }
+
+    NumVics = 0;
+    for(Vic=0; Vic<256; Vic++) {
+      Listed = (memchr(Entry->Vics, Vic, Entry->NumVics) != NULL) && (Vic != 0);
+      if(XV_VidC_EdidIsVicSupported(&Param, Vic) !=
+         (Listed ? XVIDC_SUPPORTED : XVIDC_NOT_SUPPORTED)) {
+        printf("FAIL %s: VIC %u %s\n", Entry->Name, Vic,
+               Listed ? "missing" : "unexpected");
+        Failures++;
+      }
+      NumVics += Listed;
+    }
+    CHECK(NumVics == Entry->NumVics, Entry->Name);
+
+    if((Param.NumDispIdTiming != Entry->NumDispIdTiming) ||
+       (Param.MaxDispIdPixClkKhz != Entry->MaxDispIdPixClkKhz)) {
+      printf("FAIL %s: %u DisplayID timings up to %u kHz, expected %u %u\n",
+             Entry->Name, Param.NumDispIdTiming, Param.MaxDispIdPixClkKhz,
+             Entry->NumDispIdTiming, Entry->MaxDispIdPixClkKhz);
+      Failures++;
+    }
+    if((Entry->NumDispIdTiming != 0) &&
+       ((Param.DispIdTiming[0].hres != Entry->HRes) ||
+        (Param.DispIdTiming[0].vres != Entry->VRes) ||
+        (Param.DispIdTiming[0].vfreq != Entry->VFreq) ||
+        (Param.DispIdTiming[0].pixclk != Entry->PixClk))) {
+      printf("FAIL %s: DisplayID timing %ux%u@%u %u Hz\n", Entry->Name,
+             Param.DispIdTiming[0].hres, Param.DispIdTiming[0].vres,
+             Param.DispIdTiming[0].vfreq, Param.DispIdTiming[0].pixclk);
+      Failures++;
+    }
+  }
+}
+
+/* Fields of DisplayID timings beyond the first */
+static void TestDisplayIdTimings(void)
+{
+  XV_VidC_EdidCntrlParam Param;
+  const XV_VidC_TimingParam *Timing;
+
+  XV_VidC_EdidCtrlParamInit(&Param);
+  XV_VidC_parse_edid_cached(EdidDp4k120, sizeof(EdidDp4k120), &Param,
+                            XVIDC_VERBOSE_DISABLE);
+  Timing = &Param.DispIdTiming[3];
+  CHECK((Timing->hres == 7680) && (Timing->vres == 4320) &&
+        (Timing->htotal == 7760) && (Timing->vtotal == 4369) &&
+        (Timing->hfp == 8) && (Timing->vfp == 35) &&
+        (Timing->hsync_width == 32) && (Timing->vsync_width == 8) &&
+        Timing->hsync_polarity && !Timing->vsync_polarity &&
+        (Timing->vfreq == 23) && (Timing->pixclk == 812870000),
+        "4K120 fourth timing");
+
+  XV_VidC_EdidCtrlParamInit(&Param);
+  XV_VidC_parse_edid_cached(EdidDispId20, sizeof(EdidDispId20), &Param,
+                            XVIDC_VERBOSE_DISABLE);
+  Timing = &Param.DispIdTiming[1];
+  CHECK((Timing->hres == 7680) && (Timing->vres == 4320) &&
+        (Timing->htotal == 9000) && (Timing->vtotal == 4400) &&
+        (Timing->hfp == 352) && (Timing->vfp == 16) &&
+        (Timing->hsync_width == 176) && (Timing->vsync_width == 20) &&
+        Timing->hsync_polarity && Timing->vsync_polarity &&
+        (Timing->vfreq == 120) && (Timing->pixclk == 0xFFFFFFFF),
+        "Type VII 8K120 timing");
+}
+
+/* The cache reparses on any change of the contents */
+static void TestCache(void)
+{
+  XV_VidC_EdidCntrlParam Param;
+  u8 Edid[256];
+  u32 Signature;
+  u32 Index;
+
+  XV_VidC_EdidCtrlParamInit(&Param);
+  CHECK(XV_VidC_parse_edid_cached(EdidHdmi20, sizeof(EdidHdmi20), &Param,
+                                  XVIDC_VERBOSE_DISABLE) == TRUE, "first");
+  Signature = Param.EdidSignature;
+  CHECK(Signature != 0, "signature");
+  CHECK(XV_VidC_parse_edid_cached(EdidHdmi20, sizeof(EdidHdmi20), &Param,
+                                  XVIDC_VERBOSE_DISABLE) == FALSE, "hit");
+  CHECK(XV_VidC_EdidIsVicSupported(&Param, 97) == XVIDC_SUPPORTED,
+        "hit keeps parameters");
+
+  /* VIC 97 to 98 and a padding byte down by one, the checksum unchanged */
+  memcpy(Edid, EdidHdmi20, sizeof(Edid));
+  CHECK(Edid[133] == 97, "VIC 97 offset");
+  Edid[133] = 17;
+  Edid[240] = (u8)(Edid[240] + 80);
+  CHECK(XV_VidC_parse_edid_cached(Edid, sizeof(Edid), &Param,
+                                  XVIDC_VERBOSE_DISABLE) == TRUE,
+        "same checksum, other VIC");
+  CHECK((XV_VidC_EdidIsVicSupported(&Param, 97) == XVIDC_NOT_SUPPORTED) &&
+        (XV_VidC_EdidIsVicSupported(&Param, 17) == XVIDC_SUPPORTED),
+        "reparsed VICs");
+
+  /* Any bit of any byte of either block */
+  memcpy(Edid, EdidHdmi20, sizeof(Edid));
+  for(Index=0; Index<sizeof(Edid) * 8; Index++) {
+    Edid[Index / 8] ^= (u8)(1 << (Index % 8));
+    if(XV_VidC_parse_edid_cached(Edid, sizeof(Edid), &Param,
+                                 XVIDC_VERBOSE_DISABLE) != TRUE) {
+      printf("FAIL %s: byte %u bit %u not in the signature\n", __func__,
+             Index / 8, Index % 8);
+      Failures++;
+    }
+    Edid[Index / 8] ^= (u8)(1 << (Index % 8));
+    CHECK(XV_VidC_parse_edid_cached(Edid, sizeof(Edid), &Param,
+                                    XVIDC_VERBOSE_DISABLE) == TRUE,
+          "back to the first EDID");
+  }
+  CHECK(Param.EdidSignature == Signature, "signature of the first EDID");
+}
+
+/* Extensions beyond Length are not read */
+static void TestLength(void)
+{
+  XV_VidC_EdidCntrlParam Param;
+  XV_VidC_EdidCntrlParam Ref;
+  u8 Edid[256];
+  u8 *Guarded;
+
+  XV_VidC_EdidCtrlParamInit(&Ref);
+  XV_VidC_parse_edid_cached(EdidHdmi20, sizeof(EdidHdmi20), &Ref,
+                            XVIDC_VERBOSE_DISABLE);
+
+  /* The base block reports 255 extensions, only one is there */
+  memcpy(Edid, EdidHdmi20, sizeof(Edid));
+  Edid[126] = 0xFF;
+  FixChecksum(Edid);
+  Guarded = GuardedCopy(Edid, sizeof(Edid));
+  XV_VidC_EdidCtrlParamInit(&Param);
+  CHECK(XV_VidC_parse_edid_cached(Guarded, sizeof(Edid), &Param,
+                                  XVIDC_VERBOSE_DISABLE) == TRUE, "parse");
+  CHECK((Param.MaxTmdsMhz == Ref.MaxTmdsMhz) &&
+        (memcmp(Param.SuppCeaVicMap, Ref.SuppCeaVicMap,
+                sizeof(Ref.SuppCeaVicMap)) == 0),
+        "extension within the length parsed");
+
+  /* Base block only */
+  Guarded = GuardedCopy(EdidHdmi20, XVIDC_EDID_BLOCK_SIZE);
+  XV_VidC_EdidCtrlParamInit(&Param);
+  CHECK(XV_VidC_parse_edid_cached(Guarded, XVIDC_EDID_BLOCK_SIZE, &Param,
+                                  XVIDC_VERBOSE_DISABLE) == TRUE, "base");
+  CHECK((Param.IsHdmi == XVIDC_ISDVI) &&
+        (XV_VidC_EdidIsVicSupported(&Param, 16) == XVIDC_NOT_SUPPORTED),
+        "extension beyond the length ignored");
+  CHECK(Param.EdidSignature != Ref.EdidSignature, "signature of the base");
+
+  /* A trailing partial block is not parsed */
+  XV_VidC_EdidCtrlParamInit(&Param);
+  XV_VidC_parse_edid_cached(EdidHdmi20, sizeof(EdidHdmi20) - 1, &Param,
+                            XVIDC_VERBOSE_DISABLE);
+  CHECK(Param.IsHdmi == XVIDC_ISDVI, "partial extension ignored");
+}
+
+/* Data block walks stay within their block */
+static void TestDataBlockBounds(void)
+{
+  XV_VidC_EdidCntrlParam Param;
+  u8 Edid[256];
+  u8 *Ext = &Edid[XVIDC_EDID_BLOCK_SIZE];
+
+  /* CEA 861 detailed timing offset beyond the block */
+  memcpy(Edid, EdidHdmi20, sizeof(Edid));
+  Ext[2] = 0xFF;
+  FixChecksum(Ext);
+  XV_VidC_EdidCtrlParamInit(&Param);
+  XV_VidC_parse_edid_cached(GuardedCopy(Edid, sizeof(Edid)), sizeof(Edid),
+                            &Param, XVIDC_VERBOSE_DISABLE);
+  CHECK(XV_VidC_EdidIsVicSupported(&Param, 97) == XVIDC_SUPPORTED,
+        "CEA data blocks before the bad offset");
+
+  /* CEA 861 data block running past the detailed timing offset */
+  memcpy(Edid, EdidHdmi20, sizeof(Edid));
+  Ext[2] = 6;
+  XV_VidC_EdidCtrlParamInit(&Param);
+  XV_VidC_parse_edid_cached(Edid, sizeof(Edid), &Param,
+                            XVIDC_VERBOSE_DISABLE);
+  CHECK(XV_VidC_EdidIsVicSupported(&Param, 97) == XVIDC_NOT_SUPPORTED,
+        "CEA data block past the offset");
+
+  /* DisplayID section longer than the block, empty data blocks after the
+   * timing up to the end of the block */
+  memcpy(Edid, EdidDp8k30, sizeof(Edid));
+  Ext[2] = 0xFF;
+  memset(&Ext[35], 0, XVIDC_EDID_BLOCK_SIZE - 35);
+  XV_VidC_EdidCtrlParamInit(&Param);
+  XV_VidC_parse_edid_cached(GuardedCopy(Edid, sizeof(Edid)), sizeof(Edid),
+                            &Param, XVIDC_VERBOSE_DISABLE);
+  CHECK(Param.NumDispIdTiming == 1, "DisplayID section clipped");
+
+  /* DisplayID timing block running past the section */
+  memcpy(Edid, EdidDp8k30, sizeof(Edid));
+  Ext[2] = 29;
+  XV_VidC_EdidCtrlParamInit(&Param);
+  XV_VidC_parse_edid_cached(Edid, sizeof(Edid), &Param,
+                            XVIDC_VERBOSE_DISABLE);
+  CHECK(Param.NumDispIdTiming == 0, "DisplayID block past the section");
+
+  /* DisplayID timing block length not a multiple of the descriptor */
+  memcpy(Edid, EdidDp8k30, sizeof(Edid));
+  Ext[14] = 19;
+  XV_VidC_EdidCtrlParamInit(&Param);
+  XV_VidC_parse_edid_cached(Edid, sizeof(Edid), &Param,
+                            XVIDC_VERBOSE_DISABLE);
+  CHECK(Param.NumDispIdTiming == 0, "DisplayID partial descriptor");
+
+  /* Type VII descriptors of 21 bytes */
+  memcpy(Edid, EdidDispId20, sizeof(Edid));
+  Ext[6] = 0x10;
+  XV_VidC_EdidCtrlParamInit(&Param);
+  XV_VidC_parse_edid_cached(Edid, sizeof(Edid), &Param,
+                            XVIDC_VERBOSE_DISABLE);
+  CHECK((Param.NumDispIdTiming == 1) &&
+        (Param.DispIdTiming[0].pixclk == 594000000),
+        "Type VII descriptor size");
+}
+
+/* Time of a parse and of a cache hit */
+static void Benchmark(void)
+{
+  XV_VidC_EdidCntrlParam Param;
+  const CorpusEntry *Entry;
+  double Start, ParseNs, HitNs;
+  u32 Index, Iter;
+  u32 Hits = 0;
+
+  printf("%-16s %6s %12s %12s\n", "EDID", "Bytes", "Parse (ns)", "Hit (ns)");
+  for(Index=0; Index<ARRAY_SIZE(Corpus); Index++) {
+    Entry = &Corpus[Index];
+
+    Start = NowNs();
+    for(Iter=0; Iter<BENCH_PARSES; Iter++) {
+      XV_VidC_parse_edid(Entry->Edid, &Param, XVIDC_VERBOSE_DISABLE);
+    }
+    ParseNs = (NowNs() - Start) / BENCH_PARSES;
+
+    XV_VidC_EdidCtrlParamInit(&Param);
+    XV_VidC_parse_edid_cached(Entry->Edid, Entry->Length, &Param,
+                              XVIDC_VERBOSE_DISABLE);
+    Start = NowNs();
+    for(Iter=0; Iter<BENCH_PARSES; Iter++) {
+      Hits += !XV_VidC_parse_edid_cached(Entry->Edid, Entry->Length, &Param,
+                                         XVIDC_VERBOSE_DISABLE);
+    }
+    HitNs = (NowNs() - Start) / BENCH_PARSES;
+
+    printf("%-16s %6u %12.0f %12.0f\n", Entry->Name + 4,
+           (unsigned)Entry->Length, ParseNs, HitNs);
+  }
+
+  CHECK(Hits == ARRAY_SIZE(Corpus) * BENCH_PARSES, "cache hits");
+}
+
+/************************** Main *********************************************/
+
+int main(void)
+{
+  TestCorpus();
+  TestDisplayIdTimings();
+  TestCache();
+  TestLength();
+  TestDataBlockBounds();
+  Benchmark();
+
+  printf("%u EDIDs: %s (%u failures)\n", (u32)ARRAY_SIZE(Corpus),
+         Failures ? "FAILED" : "PASSED", Failures);
+  return (Failures ? 1 : 0);
+}
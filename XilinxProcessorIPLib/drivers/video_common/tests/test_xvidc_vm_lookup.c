@@ -0,0 +1,187 @@
+/******************************************************************************
+* Copyright (C) 2020 Xilinx, Inc.  All rights reserved.
+* SPDX-License-Identifier: MIT
+******************************************************************************/
+
+/*****************************************************************************/
+/**
+*
+* @file test_xvidc_vm_lookup.c
+*
+* Host test of the video mode index. XVidC_GetVideoModeId() and
+* XVidC_GetVideoModeIdExtensive() are compared with a linear search of
+* XVidC_VideoTimingModes for the active size of every table entry, every
+* frame rate from 0 to 255 Hz and both scan types.
+*
+* Build and run on the host:
+*   cc -Wall -I../src -I../../../../lib/bsp/standalone/src/common \
+*      test_xvidc_vm_lookup.c -o test_xvidc_vm_lookup
+*   ./test_xvidc_vm_lookup
+*
+******************************************************************************/
+
+/***************************** Include Files *********************************/
+
+#include <stdio.h>
+
+/* Build the standalone (non Linux) flavour of the driver */
+#undef __linux__
+#include "xil_types.h"
+
+/* xil_printf.h pulls in the BSP configuration, use the host printf */
+#define XIL_PRINTF_H
+#define xil_printf printf
+
+#include "xvidc.c"
+#include "xvidc_timings_table.c"
+
+/************************** Stubs ********************************************/
+
+u32 Xil_AssertStatus;
+s32 Xil_AssertWait;
+
+void Xil_Assert(const char8 *File, s32 Line)
+{
+  printf("ASSERT %s:%d\n", File, (int)Line);
+}
+
+/************************** Reference ****************************************/
+
+/* First entry of the scan type range with matching size and rate */
+static XVidC_VideoMode RefGetVideoModeId(u32 Width, u32 Height,
+                                         u32 FrameRate, u8 IsInterlaced)
+{
+  const XVidC_VideoTimingMode *Vtm;
+  u32 Index, Start, End;
+
+  Start = IsInterlaced ? XVIDC_VM_INTL_START : XVIDC_VM_PROG_START;
+  End = IsInterlaced ? XVIDC_VM_INTL_END : XVIDC_VM_PROG_END;
+
+  for(Index=Start; Index<=End; Index++) {
+    Vtm = &XVidC_VideoTimingModes[Index];
+    if((Vtm->Timing.HActive == Width) && (Vtm->Timing.VActive == Height) &&
+       (Vtm->FrameRate == FrameRate)) {
+      return (XVidC_VideoMode)Index;
+    }
+  }
+  return XVIDC_VM_NOT_SUPPORTED;
+}
+
+/* First entry of the scan type range that also matches the blanking */
+static XVidC_VideoMode RefGetVideoModeIdExtensive(XVidC_VideoTiming *Timing,
+                                                  u32 FrameRate,
+                                                  u8 IsInterlaced,
+                                                  u8 IsExtensive)
+{
+  const XVidC_VideoTimingMode *Vtm;
+  u32 Index, Start, End;
+
+  Start = IsInterlaced ? XVIDC_VM_INTL_START : XVIDC_VM_PROG_START;
+  End = IsInterlaced ? XVIDC_VM_INTL_END : XVIDC_VM_PROG_END;
+
+  for(Index=Start; Index<=End; Index++) {
+    Vtm = &XVidC_VideoTimingModes[Index];
+    if((Vtm->Timing.HActive != Timing->HActive) ||
+       (Vtm->Timing.VActive != Timing->VActive) ||
+       (Vtm->FrameRate != FrameRate)) {
+      continue;
+    }
+    if(!IsExtensive) {
+      return (XVidC_VideoMode)Index;
+    }
+    if((Vtm->Timing.HTotal == Timing->HTotal) &&
+       (Vtm->Timing.F0PVTotal == Timing->F0PVTotal) &&
+       (Vtm->Timing.HFrontPorch == Timing->HFrontPorch) &&
+       (Vtm->Timing.F0PVFrontPorch == Timing->F0PVFrontPorch) &&
+       (Vtm->Timing.HSyncWidth == Timing->HSyncWidth) &&
+       (Vtm->Timing.F0PVSyncWidth == Timing->F0PVSyncWidth) &&
+       (Vtm->Timing.VSyncPolarity == Timing->VSyncPolarity) &&
+       (!IsInterlaced ||
+        ((Vtm->Timing.F1VTotal == Timing->F1VTotal) &&
+         (Vtm->Timing.F1VFrontPorch == Timing->F1VFrontPorch) &&
+         (Vtm->Timing.F1VSyncWidth == Timing->F1VSyncWidth)))) {
+      return (XVidC_VideoMode)Index;
+    }
+  }
+  return XVIDC_VM_NOT_SUPPORTED;
+}
+
+/************************** Test *********************************************/
+
+int main(void)
+{
+  XVidC_VideoTiming Timing;
+  u32 Lookups = 0;
+  u32 Failures = 0;
+  u32 Found = 0;
+  u32 Index, Rate, Variant;
+  u8 IsInterlaced, IsExtensive;
+  XVidC_VideoMode Got, Exp;
+
+  for(Index=0; Index<XVIDC_VM_NUM_SUPPORTED; Index++) {
+    for(Rate=0; Rate<256; Rate++) {
+      for(IsInterlaced=0; IsInterlaced<2; IsInterlaced++) {
+        Timing = XVidC_VideoTimingModes[Index].Timing;
+
+        Got = XVidC_GetVideoModeId(Timing.HActive, Timing.VActive, Rate,
+                                   IsInterlaced);
+        Exp = RefGetVideoModeId(Timing.HActive, Timing.VActive, Rate,
+                                IsInterlaced);
+        Lookups++;
+        Found += (Exp != XVIDC_VM_NOT_SUPPORTED);
+        if(Got != Exp) {
+          printf("FAIL %s %u Hz %s: got %d expected %d\n",
+                 XVidC_VideoTimingModes[Index].Name, Rate,
+                 IsInterlaced ? "I" : "P", Got, Exp);
+          Failures++;
+        }
+
+        /* Exact blanking of the entry, then with each blanking field off */
+        for(Variant=0; Variant<5; Variant++) {
+          Timing = XVidC_VideoTimingModes[Index].Timing;
+          switch(Variant) {
+            case 1: Timing.HTotal++; break;
+            case 2: Timing.F0PVFrontPorch++; break;
+            case 3: Timing.VSyncPolarity ^= 1; break;
+            case 4: Timing.F1VSyncWidth++; break;
+            default: break;
+          }
+          for(IsExtensive=0; IsExtensive<2; IsExtensive++) {
+            Got = XVidC_GetVideoModeIdExtensive(&Timing, Rate, IsInterlaced,
+                                                IsExtensive);
+            Exp = RefGetVideoModeIdExtensive(&Timing, Rate, IsInterlaced,
+                                             IsExtensive);
+            Lookups++;
+            if(Got != Exp) {
+              printf("FAIL extensive %s %u Hz %s variant %u: "
+                     "got %d expected %d\n",
+                     XVidC_VideoTimingModes[Index].Name, Rate,
+                     IsInterlaced ? "I" : "P", Variant, Got, Exp);
+              Failures++;
+            }
+          }
+        }
+      }
+    }
+  }
+
+  /* Every table entry must be reachable through its own key */
+  for(Index=0; Index<XVIDC_VM_NUM_SUPPORTED; Index++) {
+    Timing = XVidC_VideoTimingModes[Index].Timing;
+    IsInterlaced = (Index <= XVIDC_VM_INTL_END) ? 1 : 0;
+    Got = XVidC_GetVideoModeIdExtensive(&Timing,
+                                        XVidC_VideoTimingModes[Index].FrameRate,
+                                        IsInterlaced, 1);
+    if((Got == XVIDC_VM_NOT_SUPPORTED) ||
+       (XVidC_VideoTimingModes[Got].FrameRate !=
+        XVidC_VideoTimingModes[Index].FrameRate)) {
+      printf("FAIL %s not found\n", XVidC_VideoTimingModes[Index].Name);
+      Failures++;
+    }
+  }
+
+  printf("%u modes, %u lookups, %u hits: %s (%u failures)\n",
+         (u32)XVIDC_VM_NUM_SUPPORTED, Lookups, Found,
+         Failures ? "FAILED" : "PASSED", Failures);
+  return (Failures ? 1 : 0);
+}
@@ -134,6 +134,14 @@ extern "C" {
 
 /************************** Constant Definitions *****************************/
 
+#define XZDMA_MCPY_CPU_THRESHOLD	(512U)	/**< Default size in bytes below
+						  *  which the memcpy service
+						  *  copies with the CPU */
+#define XZDMA_MCPY_CAL_MIN_SIZE		(64U)	/**< First size tried by
+						  *  XZDma_McpyCalibrate */
+#define XZDMA_MCPY_CAL_TIMEOUT		(1000000U) /**< Polls before
+						  *  XZDma_McpyCalibrate gives
+						  *  up on a copy */
 
 /**************************** Type Definitions *******************************/
 
@@ -350,6 +358,65 @@ typedef struct {
 				  *  this transfer only for SG mode */
 } XZDma_Transfer;
 
+/******************************************************************************/
+/**
+* Callback type for completion of a memcpy service request.
+* @param 	CallBackRef is the reference given in the request.
+* @param	Status is XST_SUCCESS, or XST_FAILURE if the DMA reported an
+*		error for the descriptor list that carried the request.
+*******************************************************************************/
+typedef void (*XZDma_McpyHandler) (void *CallBackRef, s32 Status);
+
+/******************************************************************************/
+/**
+* This typedef contains one copy or fill request of the memcpy service. The
+* request is owned by the client and must stay valid until its handler is
+* called.
+*/
+typedef struct XZDma_McpyReq {
+	UINTPTR DstAddr;	/**< Destination address */
+	UINTPTR SrcAddr;	/**< Source address, unused for fill */
+	u32 Size;		/**< Size in bytes */
+	u8 IsFill;		/**< Fill DstAddr with FillValue instead of
+				  *  copying from SrcAddr */
+	u8 FillValue;		/**< Byte value for fill requests */
+	XZDma_McpyHandler Handler;	/**< Completion callback, may be
+					  *  NULL */
+	void *CallBackRef;		/**< Passed to Handler */
+	struct XZDma_McpyReq *Next;	/**< Used by the service */
+} XZDma_McpyReq;
+
+/******************************************************************************/
+/**
+* Optional time source for XZDma_McpyCalibrate(), returning a free running
+* tick count such as XTime_GetTime().
+*/
+typedef u64 (*XZDma_McpyTimeFn) (void);
+
+/******************************************************************************/
+/**
+* The memcpy service instance. It queues copy and fill requests from any
+* number of clients, runs them as linked list descriptor chains on one ZDMA
+* channel and completes them through their callbacks.
+*/
+typedef struct {
+	XZDma *ZDmaPtr;		/**< ZDMA channel used by the service */
+	XZDma_LlDscr *SrcDscr;	/**< Source descriptor array */
+	XZDma_LlDscr *DstDscr;	/**< Destination descriptor array */
+	u32 DscrCount;		/**< Descriptors in each array */
+	u8 *FillBuf;		/**< Pattern buffer for fill requests */
+	u32 FillLen;		/**< Size of FillBuf in bytes */
+	s32 FillValue;		/**< Byte value in FillBuf, -1 if unknown */
+	u32 CpuThreshold;	/**< Requests smaller than this are done by
+				  *  the CPU */
+	XZDma_McpyReq *Head;	/**< First queued request */
+	XZDma_McpyReq *Tail;	/**< Last queued request */
+	XZDma_McpyReq *Active;	/**< Requests of the running chain */
+	u32 DmaCount;		/**< Requests completed by the DMA */
+	u32 CpuCount;		/**< Requests completed by the CPU */
+	u32 ChainCount;		/**< Descriptor chains started */
+} XZDma_Mcpy;
+
 /***************** Macros (Inline Functions) Definitions *********************/
 
 /*****************************************************************************/
@@ -690,6 +757,16 @@ void XZDma_ScatterGather(XZDma *InstancePtr, XZDma_Transfer *Data,
 								u32 Num);
 void XZDma_Enable(XZDma *InstancePtr);
 
+s32 XZDma_McpyInitialize(XZDma_Mcpy *McpyPtr, XZDma *InstancePtr,
+		UINTPTR Dscr_MemPtr, u32 NoOfBytes, u8 *FillBuf, u32 FillLen);
+s32 XZDma_McpySubmit(XZDma_Mcpy *McpyPtr, XZDma_McpyReq *ReqPtr);
+void XZDma_McpySetCpuThreshold(XZDma_Mcpy *McpyPtr, u32 Threshold);
+s32 XZDma_McpyCalibrate(XZDma_Mcpy *McpyPtr, UINTPTR SrcBuf,
+		UINTPTR DstBuf, u32 MaxSize, XZDma_McpyTimeFn TimeFn,
+		u32 *ThresholdPtr);
+u32 XZDma_McpyPoll(XZDma_Mcpy *McpyPtr);
+void XZDma_McpyIntrHandler(void *CallBackRef);
+
 /*@}*/
 
 #ifdef __cplusplus
@@ -0,0 +1,707 @@
+/******************************************************************************
+* Copyright (C) 2014 - 2021 Xilinx, Inc.  All rights reserved.
+* SPDX-License-Identifier: MIT
+******************************************************************************/
+
+/*****************************************************************************/
+/**
+*
+* @file xzdma_mcpy.c
+* @addtogroup zdma_v1_11
+* @{
+*
+* This file contains an asynchronous memcpy service built on the linked list
+* scatter gather mode of the ZDMA core. Clients queue copy and fill requests
+* with XZDma_McpySubmit(); queued requests are chained into one descriptor
+* list per DMA run and completed through their callbacks from
+* XZDma_McpyIntrHandler(), or from XZDma_McpyPoll() when interrupts are not
+* used.
+* Requests smaller than a threshold, which XZDma_McpyCalibrate() can measure,
+* are done by the CPU at submit time. Please see xzdma.h for more details of
+* the driver.
+*
+******************************************************************************/
+
+/***************************** Include Files *********************************/
+
+#include <string.h>
+#include "xzdma.h"
+
+/************************** Constant Definitions *****************************/
+
+/* Interrupts that fail the running descriptor chain */
+#define XZDMA_MCPY_ERR_MASK	(XZDMA_IXR_AXI_WR_DATA_MASK | \
+				 XZDMA_IXR_AXI_RD_DATA_MASK | \
+				 XZDMA_IXR_AXI_RD_DST_DSCR_MASK | \
+				 XZDMA_IXR_AXI_RD_SRC_DSCR_MASK)
+
+/************************** Function Prototypes ******************************/
+
+static void XZDma_McpyComplete(XZDma_Mcpy *McpyPtr, s32 Status);
+static void XZDma_McpyCalDone(void *CallBackRef, s32 Status);
+static void XZDma_McpyKick(XZDma_Mcpy *McpyPtr);
+static void XZDma_McpyCpu(XZDma_McpyReq *ReqPtr);
+static u32 XZDma_McpyFillDscrs(XZDma_Mcpy *McpyPtr, u32 Size);
+static void XZDma_McpySetDscr(XZDma_LlDscr *DscrPtr, u64 Addr, u32 Size,
+				u32 CtrlValue, XZDma_LlDscr *NextPtr);
+
+/************************** Function Definitions *****************************/
+
+/*****************************************************************************/
+/**
+*
+* This function initializes the memcpy service on a ZDMA channel. The channel
+* is put in linked list scatter gather mode and the descriptor memory is split
+* with XZDma_CreateBDList().
+*
+* @param	McpyPtr is a pointer to the XZDma_Mcpy instance.
+* @param	InstancePtr is a pointer to an initialized, idle XZDma
+*		instance which is used only by the service from now on.
+* @param	Dscr_MemPtr is a pointer to the memory for descriptors. It
+*		should be aligned to 64 bytes.
+* @param	NoOfBytes is the size of the descriptor memory. Each copy
+*		request takes 64 bytes of it while in a chain.
+* @param	FillBuf is a buffer used as source of fill requests, or NULL
+*		to do all fill requests with the CPU.
+* @param	FillLen is the size of FillBuf in bytes. A fill request takes
+*		one source descriptor per FillLen bytes.
+*
+* @return
+*		- XST_SUCCESS if the service is initialized.
+*		- XST_FAILURE if the channel mode could not be set or the
+*		  descriptor memory holds no descriptors.
+*
+* @note		XZDma_McpyIntrHandler() has to be connected to the ZDMA
+*		channel interrupt by the application, or XZDma_McpyPoll()
+*		called, for requests to complete. XZDma_IntrHandler() must
+*		not be connected for a channel used by the service.
+*
+******************************************************************************/
+s32 XZDma_McpyInitialize(XZDma_Mcpy *McpyPtr, XZDma *InstancePtr,
+		UINTPTR Dscr_MemPtr, u32 NoOfBytes, u8 *FillBuf, u32 FillLen)
+{
+	s32 Status;
+
+	/* Verify arguments */
+	Xil_AssertNonvoid(McpyPtr != NULL);
+	Xil_AssertNonvoid(InstancePtr != NULL);
+	Xil_AssertNonvoid(InstancePtr->IsReady ==
+				(u32)(XIL_COMPONENT_IS_READY));
+	Xil_AssertNonvoid((FillBuf == NULL) || (FillLen != 0x00U));
+
+	(void)memset(McpyPtr, 0, sizeof(XZDma_Mcpy));
+
+	Status = XZDma_SetMode(InstancePtr, TRUE, XZDMA_NORMAL_MODE);
+	if (Status != XST_SUCCESS) {
+		goto End;
+	}
+
+	McpyPtr->DscrCount = XZDma_CreateBDList(InstancePtr, XZDMA_LINKEDLIST,
+					Dscr_MemPtr, NoOfBytes);
+	if (McpyPtr->DscrCount == 0x00U) {
+		Status = XST_FAILURE;
+		goto End;
+	}
+
+	McpyPtr->ZDmaPtr = InstancePtr;
+	McpyPtr->SrcDscr =
+		(XZDma_LlDscr *)(void *)InstancePtr->Descriptor.SrcDscrPtr;
+	McpyPtr->DstDscr =
+		(XZDma_LlDscr *)(void *)InstancePtr->Descriptor.DstDscrPtr;
+	McpyPtr->FillBuf = FillBuf;
+	McpyPtr->FillLen = FillLen;
+	McpyPtr->FillValue = -1;
+	McpyPtr->CpuThreshold = XZDMA_MCPY_CPU_THRESHOLD;
+
+	XZDma_IntrClear(InstancePtr, XZDMA_IXR_ALL_INTR_MASK);
+	XZDma_EnableIntr(InstancePtr,
+			(XZDMA_IXR_DMA_DONE_MASK | XZDMA_MCPY_ERR_MASK));
+
+End:
+	return Status;
+}
+
+/*****************************************************************************/
+/**
+*
+* This function queues a copy or fill request. If no descriptor chain is
+* running, a new chain is started with the request and any other requests
+* already queued.
+*
+* Requests smaller than the CPU threshold, and fill requests when the service
+* has no fill buffer, are done by the CPU before this function returns and
+* their handler is called from here. They can therefore complete before
+* requests queued earlier.
+*
+* @param	McpyPtr is a pointer to the XZDma_Mcpy instance.
+* @param	ReqPtr is the request to queue.
+*
+* @return
+*		- XST_SUCCESS if the request is queued or done.
+*		- XST_INVALID_PARAM if the request size is 0 or larger than
+*		  one descriptor can transfer.
+*
+* @note		This function must not be preempted by the ZDMA interrupt
+*		handler. It is the caller's responsibility to provide a
+*		mutual exclusion mechanism, for example by disabling the ZDMA
+*		interrupt around the call.
+*
+******************************************************************************/
+s32 XZDma_McpySubmit(XZDma_Mcpy *McpyPtr, XZDma_McpyReq *ReqPtr)
+{
+	s32 Status = XST_SUCCESS;
+
+	/* Verify arguments */
+	Xil_AssertNonvoid(McpyPtr != NULL);
+	Xil_AssertNonvoid(McpyPtr->ZDmaPtr != NULL);
+	Xil_AssertNonvoid(ReqPtr != NULL);
+
+	if ((ReqPtr->Size == 0x00U) ||
+			(ReqPtr->Size > XZDMA_WORD2_SIZE_MASK)) {
+		Status = XST_INVALID_PARAM;
+		goto End;
+	}
+
+	if ((ReqPtr->Size < McpyPtr->CpuThreshold) ||
+			((ReqPtr->IsFill != FALSE) &&
+			 (XZDma_McpyFillDscrs(McpyPtr, ReqPtr->Size) >
+						McpyPtr->DscrCount))) {
+		XZDma_McpyCpu(ReqPtr);
+		McpyPtr->CpuCount++;
+		if (ReqPtr->Handler != NULL) {
+			ReqPtr->Handler(ReqPtr->CallBackRef, XST_SUCCESS);
+		}
+		goto End;
+	}
+
+	ReqPtr->Next = NULL;
+	if (McpyPtr->Tail != NULL) {
+		McpyPtr->Tail->Next = ReqPtr;
+	}
+	else {
+		McpyPtr->Head = ReqPtr;
+	}
+	McpyPtr->Tail = ReqPtr;
+
+	if (McpyPtr->Active == NULL) {
+		XZDma_McpyKick(McpyPtr);
+	}
+
+End:
+	return Status;
+}
+
+/*****************************************************************************/
+/**
+*
+* This function sets the size below which requests are done by the CPU.
+*
+* @param	McpyPtr is a pointer to the XZDma_Mcpy instance.
+* @param	Threshold is the size in bytes. 0 sends every request to the
+*		DMA.
+*
+* @return	None.
+*
+* @note		None.
+*
+******************************************************************************/
+void XZDma_McpySetCpuThreshold(XZDma_Mcpy *McpyPtr, u32 Threshold)
+{
+	/* Verify arguments */
+	Xil_AssertVoid(McpyPtr != NULL);
+
+	McpyPtr->CpuThreshold = Threshold;
+}
+
+/*****************************************************************************/
+/**
+*
+* This function measures the copy size from which the DMA is faster than the
+* CPU and uses it as the CPU threshold. For each power of two size from
+* XZDMA_MCPY_CAL_MIN_SIZE up to MaxSize, it times a CPU memcpy() and a DMA
+* copy through the service, including the cache maintenance the service does.
+* The threshold is the first size at which the DMA copy is faster.
+*
+* Every DMA copy is checked: it must be accepted, complete without error
+* within XZDMA_MCPY_CAL_TIMEOUT polls and leave the same data as the source.
+* If any of them fails the calibration fails and the previous threshold is
+* kept.
+*
+* @param	McpyPtr is a pointer to the XZDma_Mcpy instance.
+* @param	SrcBuf is a source buffer of at least MaxSize bytes.
+* @param	DstBuf is a destination buffer of at least MaxSize bytes.
+* @param	MaxSize is the largest size to try. It is clamped to the
+*		largest size one descriptor can transfer.
+* @param	TimeFn returns a free running tick count.
+* @param	ThresholdPtr returns the new CPU threshold in bytes. It is
+*		above MaxSize when the CPU was faster for all sizes.
+*
+* @return
+*		- XST_SUCCESS if the threshold was measured and set.
+*		- XST_FAILURE if a DMA copy failed, timed out or left wrong
+*		  data.
+*		- XST_INVALID_PARAM if MaxSize is below
+*		  XZDMA_MCPY_CAL_MIN_SIZE or a copy was rejected.
+*
+* @note		The service must be idle and the ZDMA interrupt must not be
+*		enabled, as completions are polled with XZDma_McpyPoll().
+*
+******************************************************************************/
+s32 XZDma_McpyCalibrate(XZDma_Mcpy *McpyPtr, UINTPTR SrcBuf,
+		UINTPTR DstBuf, u32 MaxSize, XZDma_McpyTimeFn TimeFn,
+		u32 *ThresholdPtr)
+{
+	XZDma_McpyReq Req;
+	s32 ReqStatus;
+	s32 Status = XST_SUCCESS;
+	u32 OldThreshold;
+	u32 Size;
+	u32 Poll;
+	u64 Start;
+	u64 CpuTime;
+	u64 DmaTime;
+
+	/* Verify arguments */
+	Xil_AssertNonvoid(McpyPtr != NULL);
+	Xil_AssertNonvoid(McpyPtr->Active == NULL);
+	Xil_AssertNonvoid(SrcBuf != 0x00U);
+	Xil_AssertNonvoid(DstBuf != 0x00U);
+	Xil_AssertNonvoid(TimeFn != NULL);
+	Xil_AssertNonvoid(ThresholdPtr != NULL);
+
+	if (MaxSize > XZDMA_WORD2_SIZE_MASK) {
+		MaxSize = XZDMA_WORD2_SIZE_MASK;
+	}
+	if (MaxSize < XZDMA_MCPY_CAL_MIN_SIZE) {
+		Status = XST_INVALID_PARAM;
+		goto End;
+	}
+
+	OldThreshold = McpyPtr->CpuThreshold;
+	McpyPtr->CpuThreshold = 0x00U;
+
+	for (Size = XZDMA_MCPY_CAL_MIN_SIZE; Size <= MaxSize; Size <<= 1U) {
+		Start = TimeFn();
+		(void)memcpy((void *)DstBuf, (void *)SrcBuf, Size);
+		CpuTime = TimeFn() - Start;
+
+		/* Make a DMA copy that does nothing show up */
+		(void)memset((void *)DstBuf, ~(*(u8 *)SrcBuf), Size);
+
+		(void)memset(&Req, 0, sizeof(Req));
+		Req.DstAddr = DstBuf;
+		Req.SrcAddr = SrcBuf;
+		Req.Size = Size;
+		Req.Handler = XZDma_McpyCalDone;
+		Req.CallBackRef = &ReqStatus;
+		ReqStatus = XST_DEVICE_BUSY;
+
+		Start = TimeFn();
+		Status = XZDma_McpySubmit(McpyPtr, &Req);
+		if (Status != XST_SUCCESS) {
+			break;
+		}
+		for (Poll = 0x00U; (McpyPtr->Active != NULL) &&
+				(Poll < XZDMA_MCPY_CAL_TIMEOUT); Poll++) {
+			(void)XZDma_McpyPoll(McpyPtr);
+		}
+		DmaTime = TimeFn() - Start;
+
+		if (McpyPtr->Active != NULL) {
+			/* Give up the copy, this fails its request */
+			XZDma_DisableCh(McpyPtr->ZDmaPtr);
+			McpyPtr->ZDmaPtr->ChannelState = XZDMA_IDLE;
+			XZDma_McpyComplete(McpyPtr, XST_FAILURE);
+		}
+		if ((ReqStatus != XST_SUCCESS) ||
+				(memcmp((void *)DstBuf, (void *)SrcBuf,
+					Size) != 0)) {
+			Status = XST_FAILURE;
+			break;
+		}
+
+		if (DmaTime < CpuTime) {
+			break;
+		}
+	}
+
+	if (Status != XST_SUCCESS) {
+		McpyPtr->CpuThreshold = OldThreshold;
+		goto End;
+	}
+
+	McpyPtr->CpuThreshold = Size;
+	*ThresholdPtr = Size;
+
+End:
+	return Status;
+}
+
+/*****************************************************************************/
+/**
+*
+* This function completes the running descriptor chain if the DMA has
+* finished it. It is used instead of XZDma_McpyIntrHandler() when the
+* interrupt is not connected.
+*
+* The done and error status is cleared before the next chain is started, so
+* the completion of that chain can not be lost.
+*
+* @param	McpyPtr is a pointer to the XZDma_Mcpy instance.
+*
+* @return	The number of requests completed.
+*
+* @note		Do not use this function while XZDma_McpyIntrHandler() is
+*		connected for the channel.
+*
+******************************************************************************/
+u32 XZDma_McpyPoll(XZDma_Mcpy *McpyPtr)
+{
+	XZDma_McpyReq *ReqPtr;
+	u32 Pending;
+	u32 Count = 0x00U;
+
+	/* Verify arguments */
+	Xil_AssertNonvoid(McpyPtr != NULL);
+
+	Pending = XZDma_IntrGetStatus(McpyPtr->ZDmaPtr) &
+			(XZDMA_IXR_DMA_DONE_MASK | XZDMA_MCPY_ERR_MASK);
+	if (Pending == 0x00U) {
+		goto End;
+	}
+	XZDma_IntrClear(McpyPtr->ZDmaPtr, Pending);
+
+	if (McpyPtr->Active == NULL) {
+		goto End;
+	}
+
+	for (ReqPtr = McpyPtr->Active; ReqPtr != NULL; ReqPtr = ReqPtr->Next) {
+		Count++;
+	}
+
+	McpyPtr->ZDmaPtr->ChannelState = XZDMA_IDLE;
+	if ((Pending & XZDMA_MCPY_ERR_MASK) != 0x00U) {
+		XZDma_DisableCh(McpyPtr->ZDmaPtr);
+		XZDma_McpyComplete(McpyPtr, XST_FAILURE);
+	}
+	else {
+		XZDma_McpyComplete(McpyPtr, XST_SUCCESS);
+	}
+
+End:
+	return Count;
+}
+
+/*****************************************************************************/
+/**
+*
+* This function is the interrupt handler of the memcpy service. It has to be
+* connected to the ZDMA channel interrupt instead of XZDma_IntrHandler(), with
+* the XZDma_Mcpy instance as callback reference.
+*
+* The handler clears the done and error status before it starts the next
+* chain. XZDma_IntrHandler() clears the status it read only after its
+* callbacks return, which would drop the done interrupt of a chain started
+* from the callback and finished before that.
+*
+* @param	CallBackRef is a pointer to the XZDma_Mcpy instance.
+*
+* @return	None.
+*
+* @note		An AXI error fails all requests of the running chain and the
+*		channel is disabled before the next chain is started.
+*
+******************************************************************************/
+void XZDma_McpyIntrHandler(void *CallBackRef)
+{
+	XZDma_Mcpy *McpyPtr = (XZDma_Mcpy *)CallBackRef;
+
+	/* Verify arguments */
+	Xil_AssertVoid(McpyPtr != NULL);
+
+	(void)XZDma_McpyPoll(McpyPtr);
+}
+
+/*****************************************************************************/
+/**
+*
+* This static function completes the requests of the running chain. The next
+* chain is started before the callbacks are called, so that the DMA is kept
+* busy while the clients run.
+*
+* @param	McpyPtr is a pointer to the XZDma_Mcpy instance.
+* @param	Status is passed to the request callbacks.
+*
+* @return	None.
+*
+* @note		None.
+*
+******************************************************************************/
+static void XZDma_McpyComplete(XZDma_Mcpy *McpyPtr, s32 Status)
+{
+	XZDma_McpyReq *ReqPtr = McpyPtr->Active;
+	XZDma_McpyReq *NextPtr;
+
+	if (ReqPtr == NULL) {
+		return;
+	}
+
+	McpyPtr->Active = NULL;
+	XZDma_McpyKick(McpyPtr);
+
+	while (ReqPtr != NULL) {
+		NextPtr = ReqPtr->Next;
+		if ((Status == XST_SUCCESS) &&
+			(!McpyPtr->ZDmaPtr->Config.IsCacheCoherent)) {
+			Xil_DCacheInvalidateRange((INTPTR)ReqPtr->DstAddr,
+						ReqPtr->Size);
+		}
+		McpyPtr->DmaCount++;
+		if (ReqPtr->Handler != NULL) {
+			ReqPtr->Handler(ReqPtr->CallBackRef, Status);
+		}
+		ReqPtr = NextPtr;
+	}
+}
+
+/*****************************************************************************/
+/**
+*
+* This static function moves as many queued requests as fit in the
+* descriptor arrays into a linked list chain and starts it. A copy takes one
+* source and one destination descriptor. A fill takes one destination
+* descriptor and one source descriptor per FillLen bytes, all pointing to the
+* fill buffer, so one chain only holds fills of a single byte value.
+*
+* @param	McpyPtr is a pointer to the XZDma_Mcpy instance.
+*
+* @return	None.
+*
+* @note		None.
+*
+******************************************************************************/
+static void XZDma_McpyKick(XZDma_Mcpy *McpyPtr)
+{
+	XZDma *InstancePtr = McpyPtr->ZDmaPtr;
+	XZDma_McpyReq *ReqPtr;
+	XZDma_McpyReq *LastPtr = NULL;
+	XZDma_LlDscr *SrcPtr = McpyPtr->SrcDscr;
+	XZDma_LlDscr *DstPtr = McpyPtr->DstDscr;
+	u32 SrcUsed = 0x00U;
+	u32 DstUsed = 0x00U;
+	u32 Need;
+	u32 Left;
+	u32 Len;
+	u32 Cntl = 0x00U;
+	s32 ChainFill = -1;
+	u64 LocalAddr;
+
+	if (InstancePtr->Config.IsCacheCoherent) {
+		Cntl = XZDMA_WORD3_COHRNT_MASK;
+	}
+
+	while (McpyPtr->Head != NULL) {
+		ReqPtr = McpyPtr->Head;
+
+		if (ReqPtr->IsFill != FALSE) {
+			if ((ChainFill >= 0) &&
+				(ChainFill != (s32)ReqPtr->FillValue)) {
+				break;
+			}
+			Need = XZDma_McpyFillDscrs(McpyPtr, ReqPtr->Size);
+		}
+		else {
+			Need = 1U;
+		}
+		if (((SrcUsed + Need) > McpyPtr->DscrCount) ||
+				(DstUsed >= McpyPtr->DscrCount)) {
+			break;
+		}
+
+		if (ReqPtr->IsFill != FALSE) {
+			if (McpyPtr->FillValue != (s32)ReqPtr->FillValue) {
+				(void)memset(McpyPtr->FillBuf,
+					ReqPtr->FillValue, McpyPtr->FillLen);
+				if (!InstancePtr->Config.IsCacheCoherent) {
+					Xil_DCacheFlushRange(
+						(INTPTR)McpyPtr->FillBuf,
+						McpyPtr->FillLen);
+				}
+				McpyPtr->FillValue = (s32)ReqPtr->FillValue;
+			}
+			ChainFill = (s32)ReqPtr->FillValue;
+			Left = ReqPtr->Size;
+			while (Left != 0x00U) {
+				Len = (Left < McpyPtr->FillLen) ?
+					Left : McpyPtr->FillLen;
+				XZDma_McpySetDscr(&SrcPtr[SrcUsed],
+					(u64)(UINTPTR)McpyPtr->FillBuf, Len,
+					Cntl, &SrcPtr[SrcUsed + 1U]);
+				SrcUsed++;
+				Left -= Len;
+			}
+		}
+		else {
+			if (!InstancePtr->Config.IsCacheCoherent) {
+				Xil_DCacheFlushRange((INTPTR)ReqPtr->SrcAddr,
+							ReqPtr->Size);
+			}
+			XZDma_McpySetDscr(&SrcPtr[SrcUsed],
+				(u64)ReqPtr->SrcAddr, ReqPtr->Size, Cntl,
+				&SrcPtr[SrcUsed + 1U]);
+			SrcUsed++;
+		}
+
+		if (!InstancePtr->Config.IsCacheCoherent) {
+			Xil_DCacheFlushRange((INTPTR)ReqPtr->DstAddr,
+						ReqPtr->Size);
+		}
+		XZDma_McpySetDscr(&DstPtr[DstUsed], (u64)ReqPtr->DstAddr,
+				ReqPtr->Size, Cntl, &DstPtr[DstUsed + 1U]);
+		DstUsed++;
+
+		McpyPtr->Head = ReqPtr->Next;
+		ReqPtr->Next = NULL;
+		if (LastPtr != NULL) {
+			LastPtr->Next = ReqPtr;
+		}
+		else {
+			McpyPtr->Active = ReqPtr;
+		}
+		LastPtr = ReqPtr;
+	}
+
+	if (McpyPtr->Head == NULL) {
+		McpyPtr->Tail = NULL;
+	}
+
+	if (DstUsed == 0x00U) {
+		return;
+	}
+
+	/* Terminate both lists */
+	SrcPtr[SrcUsed - 1U].Cntl |= XZDMA_WORD3_CMD_STOP_MASK;
+	SrcPtr[SrcUsed - 1U].NextDscr = 0x00U;
+	DstPtr[DstUsed - 1U].Cntl |= XZDMA_WORD3_CMD_STOP_MASK;
+	DstPtr[DstUsed - 1U].NextDscr = 0x00U;
+
+	Xil_DCacheFlushRange((UINTPTR)SrcPtr, SrcUsed * sizeof(XZDma_LlDscr));
+	Xil_DCacheFlushRange((UINTPTR)DstPtr, DstUsed * sizeof(XZDma_LlDscr));
+
+	XZDma_WriteReg(InstancePtr->Config.BaseAddress,
+		XZDMA_CH_SRC_START_LSB_OFFSET,
+		((UINTPTR)SrcPtr & XZDMA_WORD0_LSB_MASK));
+	LocalAddr = (u64)(UINTPTR)SrcPtr;
+	XZDma_WriteReg(InstancePtr->Config.BaseAddress,
+		XZDMA_CH_SRC_START_MSB_OFFSET,
+		((LocalAddr >> XZDMA_WORD1_MSB_SHIFT) & XZDMA_WORD1_MSB_MASK));
+	XZDma_WriteReg(InstancePtr->Config.BaseAddress,
+		XZDMA_CH_DST_START_LSB_OFFSET,
+		((UINTPTR)DstPtr & XZDMA_WORD0_LSB_MASK));
+	LocalAddr = (u64)(UINTPTR)DstPtr;
+	XZDma_WriteReg(InstancePtr->Config.BaseAddress,
+		XZDMA_CH_DST_START_MSB_OFFSET,
+		((LocalAddr >> XZDMA_WORD1_MSB_SHIFT) & XZDMA_WORD1_MSB_MASK));
+
+	McpyPtr->ChainCount++;
+	XZDma_Enable(InstancePtr);
+}
+
+/*****************************************************************************/
+/**
+*
+* This static function does a request with the CPU.
+*
+* @param	ReqPtr is the request.
+*
+* @return	None.
+*
+* @note		None.
+*
+******************************************************************************/
+static void XZDma_McpyCpu(XZDma_McpyReq *ReqPtr)
+{
+	if (ReqPtr->IsFill != FALSE) {
+		(void)memset((void *)ReqPtr->DstAddr, ReqPtr->FillValue,
+				ReqPtr->Size);
+	}
+	else {
+		(void)memcpy((void *)ReqPtr->DstAddr, (void *)ReqPtr->SrcAddr,
+				ReqPtr->Size);
+	}
+}
+
+/*****************************************************************************/
+/**
+*
+* This static function is the request callback of XZDma_McpyCalibrate().
+*
+* @param	CallBackRef is a pointer to the status of the request.
+* @param	Status is the completion status.
+*
+* @return	None.
+*
+* @note		None.
+*
+******************************************************************************/
+static void XZDma_McpyCalDone(void *CallBackRef, s32 Status)
+{
+	*(s32 *)CallBackRef = Status;
+}
+
+/*****************************************************************************/
+/**
+*
+* This static function returns the number of source descriptors a fill
+* request takes.
+*
+* @param	McpyPtr is a pointer to the XZDma_Mcpy instance.
+* @param	Size is the fill size in bytes.
+*
+* @return	Number of source descriptors, or a value larger than the
+*		descriptor count if the service has no fill buffer.
+*
+* @note		None.
+*
+******************************************************************************/
+static u32 XZDma_McpyFillDscrs(XZDma_Mcpy *McpyPtr, u32 Size)
+{
+	u32 Count;
+
+	if (McpyPtr->FillBuf == NULL) {
+		Count = McpyPtr->DscrCount + 1U;
+	}
+	else {
+		Count = (Size / McpyPtr->FillLen) +
+			(((Size % McpyPtr->FillLen) != 0x00U) ? 1U : 0U);
+	}
+
+	return Count;
+}
+
+/*****************************************************************************/
+/**
+*
+* This static function fills a linked list descriptor without flushing it.
+*
+* @param	DscrPtr is a pointer to source/destination descriptor.
+* @param	Addr is a 64 bit variable which denotes the address of data.
+* @param	Size specifies the amount of the data to be transferred.
+* @param	CtrlValue contains all the control fields of descriptor.
+* @param	NextPtr is the next descriptor.
+*
+* @return	None.
+*
+* @note		None.
+*
+******************************************************************************/
+static void XZDma_McpySetDscr(XZDma_LlDscr *DscrPtr, u64 Addr, u32 Size,
+				u32 CtrlValue, XZDma_LlDscr *NextPtr)
+{
+	DscrPtr->Address = Addr;
+	DscrPtr->Size = Size & XZDMA_WORD2_SIZE_MASK;
+	DscrPtr->Cntl = CtrlValue;
+	DscrPtr->NextDscr = (u64)(UINTPTR)NextPtr;
+	DscrPtr->Reserved = 0U;
+}
+/** @} */
@@ -0,0 +1,13 @@
+/******************************************************************************
+* Copyright (C) 2020 Xilinx, Inc.  All rights reserved.
+* SPDX-License-Identifier: MIT
+******************************************************************************/
+
+/* BSP configuration of the host tests: EL3, as for the A53 standalone BSP */
+#ifndef BSPCONFIG_H
+#define BSPCONFIG_H
+
+#define EL3 1
+#define EL1_NONSECURE 0
+
+#endif
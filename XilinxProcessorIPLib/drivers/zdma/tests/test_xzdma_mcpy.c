@@ -0,0 +1,641 @@
+/******************************************************************************
+* Copyright (C) 2020 Xilinx, Inc.  All rights reserved.
+* SPDX-License-Identifier: MIT
+******************************************************************************/
+
+/*****************************************************************************/
+/**
+*
+* @file test_xzdma_mcpy.c
+*
+* Host test of the memcpy service, XZDma_McpySubmit(), XZDma_McpyPoll() and
+* XZDma_McpyCalibrate(). The driver runs against a simulator of a ZDMA
+* channel: interrupt status, enable and disable registers, control, the
+* descriptor list start registers and an engine that walks the source and
+* destination linked lists from an enable of the channel up to the
+* descriptors with the stop command, copies the data and reports done, or
+* an AXI error, once the transfer time has passed.
+*
+* Time is simulated so that the calibration is deterministic: register
+* accesses, cache maintenance by line, CPU memcpy() by byte and the DMA
+* transfer with its start latency all advance a clock that serves as the
+* time source of XZDma_McpyCalibrate(). memcpy() of the service is routed to
+* the clock for this.
+*
+* The test checks the copies and fills through chained descriptor lists, the
+* threshold the calibration finds for four sets of bus speeds, and that the
+* calibration fails, keeping the previous threshold, when a DMA copy reports
+* an error, never completes, leaves wrong data or writes nothing, both at
+* the first copy and at the copy where the DMA takes over. A benchmark copies
+* buffers of each size, one at a time and queued, through the calibrated
+* service and through the CPU and the DMA alone. One at a time, as
+* calibrated, the service must be within 10% of the faster of the two;
+* queued it must not be slower than memcpy().
+*
+* Build and run on the host:
+*   cc -Wall -O2 -I. -I../src -I../../../../lib/bsp/standalone/src/common \
+*      -I../../../../lib/bsp/standalone/src/arm/cortexa9 \
+*      test_xzdma_mcpy.c -o test_xzdma_mcpy
+*   ./test_xzdma_mcpy
+*
+******************************************************************************/
+
+/***************************** Include Files *********************************/
+
+#include <stdio.h>
+#include <string.h>
+
+#include "xil_types.h"
+
+/* Register accesses go to the simulator below */
+#define XIL_IO_H
+static u32 Xil_In32(UINTPTR Addr);
+static void Xil_Out32(UINTPTR Addr, u32 Value);
+
+#define XIL_PRINTF_H
+void xil_printf(const char8 *Format, ...);
+
+/* CPU copies of the service are timed by the simulator */
+static void *SimMemcpy(void *Dst, const void *Src, size_t Len);
+#define memcpy(Dst, Src, Len)	SimMemcpy((Dst), (Src), (Len))
+
+#include "xzdma.c"
+#include "xzdma_mcpy.c"
+
+#undef memcpy
+
+/************************** Simulator ****************************************/
+
+#define SIM_BASE	0xFD500000U
+#define SIM_DSCRS	32
+#define SIM_BUF_LEN	(256U * 1024U)
+#define SIM_LINE	64U
+
+/* Costs in picoseconds */
+typedef struct {
+	u64 RegPs;		/* One register access */
+	u64 CacheCallPs;	/* One cache maintenance call */
+	u64 CacheLinePs;	/* Each line flushed or invalidated */
+	u64 CpuCallPs;		/* One memcpy() call */
+	u64 CpuBytePs;		/* Each byte copied by the CPU */
+	u64 DmaStartPs;		/* From enable to the first byte */
+	u64 DmaBytePs;		/* Each byte copied by the DMA */
+} SimTiming;
+
+typedef struct {
+	u32 Isr;
+	u32 Ctrl0;
+	u32 Ctrl2;
+	u32 SrcLsb;
+	u32 SrcMsb;
+	u32 DstLsb;
+	u32 DstMsb;
+	int Running;
+	u64 DoneAt;		/* Time the running transfer ends */
+	u32 DoneBits;		/* Status it ends with */
+	u32 Chains;		/* Descriptor lists run */
+	u32 Bytes;		/* Bytes copied */
+	u32 Errors;		/* Malformed descriptor lists */
+	int Fault;		/* SIM_FAULT_* of the faulty chain */
+	u32 FaultChain;		/* Number of the faulty chain */
+} SimZDma;
+
+/* Faults the simulator can inject into one chain */
+#define SIM_FAULT_NONE		0
+#define SIM_FAULT_AXI_ERR	1	/* Ends with an AXI read error */
+#define SIM_FAULT_HANG		2	/* Never ends */
+#define SIM_FAULT_CORRUPT	3	/* Flips a byte of the data */
+#define SIM_FAULT_DROP		4	/* Ends without writing anything */
+#define SIM_FAULTS		5
+
+static SimZDma Sim;
+static SimTiming Timing;
+static u64 SimNow;
+
+static u8 DscrMem[SIM_DSCRS * 2U * sizeof(XZDma_LlDscr)]
+			__attribute__((aligned(64)));
+static u8 FillBuf[256] __attribute__((aligned(64)));
+static u8 SrcBuf[SIM_BUF_LEN] __attribute__((aligned(64)));
+static u8 DstBuf[SIM_BUF_LEN] __attribute__((aligned(64)));
+
+static void *SimMemcpy(void *Dst, const void *Src, size_t Len)
+{
+	SimNow += Timing.CpuCallPs + Timing.CpuBytePs * Len;
+	return memcpy(Dst, Src, Len);
+}
+
+static u64 SimTime(void)
+{
+	return SimNow;
+}
+
+static void SimReset(void)
+{
+	memset(&Sim, 0, sizeof(Sim));
+}
+
+/* Collect the segments of a descriptor list up to the stop command */
+static u32 SimList(u64 Addr, XZDma_LlDscr **Seg, u32 Max)
+{
+	XZDma_LlDscr *Dscr;
+	u32 Count = 0U;
+
+	while (Count < Max) {
+		if (Addr < (UINTPTR)DscrMem ||
+		    Addr >= (UINTPTR)DscrMem + sizeof(DscrMem)) {
+			Sim.Errors++;
+			return 0U;
+		}
+		Dscr = (XZDma_LlDscr *)(UINTPTR)Addr;
+		Seg[Count++] = Dscr;
+		if ((Dscr->Cntl & XZDMA_WORD3_CMD_MASK) ==
+				XZDMA_WORD3_CMD_STOP_MASK) {
+			return Count;
+		}
+		Addr = Dscr->NextDscr;
+	}
+
+	Sim.Errors++;
+	return 0U;
+}
+
+/* Copy the source list into the destination list */
+static void SimStart(void)
+{
+	XZDma_LlDscr *Src[SIM_DSCRS];
+	XZDma_LlDscr *Dst[SIM_DSCRS];
+	u32 SrcCnt;
+	u32 DstCnt;
+	u32 SrcIdx = 0U;
+	u32 DstIdx = 0U;
+	u32 SrcOff = 0U;
+	u32 DstOff = 0U;
+	u32 Total = 0U;
+	u32 Len;
+	int Fault;
+
+	if (!(Sim.Ctrl0 & XZDMA_CTRL0_POINT_TYPE_MASK)) {
+		Sim.Errors++;
+		return;
+	}
+
+	SrcCnt = SimList(((u64)Sim.SrcMsb << 32) | Sim.SrcLsb, Src, SIM_DSCRS);
+	DstCnt = SimList(((u64)Sim.DstMsb << 32) | Sim.DstLsb, Dst, SIM_DSCRS);
+	if (SrcCnt == 0U || DstCnt == 0U)
+		return;
+
+	Sim.Chains++;
+	Fault = (Sim.Chains == Sim.FaultChain) ? Sim.Fault : SIM_FAULT_NONE;
+
+	while (SrcIdx < SrcCnt && DstIdx < DstCnt) {
+		Len = Src[SrcIdx]->Size - SrcOff;
+		if (Dst[DstIdx]->Size - DstOff < Len)
+			Len = Dst[DstIdx]->Size - DstOff;
+		if (Fault != SIM_FAULT_DROP) {
+			memmove((u8 *)(UINTPTR)Dst[DstIdx]->Address + DstOff,
+				(u8 *)(UINTPTR)Src[SrcIdx]->Address + SrcOff,
+				Len);
+		}
+		SrcOff += Len;
+		DstOff += Len;
+		Total += Len;
+		if (SrcOff == Src[SrcIdx]->Size) {
+			SrcIdx++;
+			SrcOff = 0U;
+		}
+		if (DstOff == Dst[DstIdx]->Size) {
+			DstIdx++;
+			DstOff = 0U;
+		}
+	}
+	if (SrcIdx != SrcCnt || DstIdx != DstCnt)
+		Sim.Errors++;
+
+	if (Fault == SIM_FAULT_CORRUPT)
+		((u8 *)(UINTPTR)Dst[DstCnt - 1U]->Address)[0] ^= 0x5AU;
+
+	Sim.Bytes += Total;
+	Sim.Running = 1;
+	Sim.DoneAt = SimNow + Timing.DmaStartPs + Timing.DmaBytePs * Total;
+	Sim.DoneBits = XZDMA_IXR_DMA_DONE_MASK;
+	if (Fault == SIM_FAULT_AXI_ERR)
+		Sim.DoneBits = XZDMA_IXR_AXI_RD_DATA_MASK | XZDMA_IXR_DMA_DONE_MASK;
+	if (Fault == SIM_FAULT_HANG)
+		Sim.DoneAt = ~0ULL;
+}
+
+/************************** Stubs ********************************************/
+
+static u32 Xil_In32(UINTPTR Addr)
+{
+	SimNow += Timing.RegPs;
+	switch (Addr - SIM_BASE) {
+	case XZDMA_CH_ISR_OFFSET:
+		if (Sim.Running && SimNow >= Sim.DoneAt) {
+			Sim.Running = 0;
+			Sim.Ctrl2 = 0U;
+			Sim.Isr |= Sim.DoneBits;
+		}
+		return Sim.Isr;
+	case XZDMA_CH_CTRL0_OFFSET:
+		return Sim.Ctrl0;
+	case XZDMA_CH_CTRL2_OFFSET:
+		return Sim.Ctrl2;
+	case XZDMA_CH_STS_OFFSET:
+		return Sim.Running ? XZDMA_STS_BUSY_MASK : 0U;
+	default:
+		return 0U;
+	}
+}
+
+static void Xil_Out32(UINTPTR Addr, u32 Value)
+{
+	SimNow += Timing.RegPs;
+	switch (Addr - SIM_BASE) {
+	case XZDMA_CH_ISR_OFFSET:
+		Sim.Isr &= ~Value;
+		break;
+	case XZDMA_CH_CTRL0_OFFSET:
+		Sim.Ctrl0 = Value;
+		break;
+	case XZDMA_CH_CTRL2_OFFSET:
+		if ((Value & XZDMA_CH_CTRL2_EN_MASK) && !Sim.Running) {
+			Sim.Ctrl2 = Value;
+			SimStart();
+		} else if (!(Value & XZDMA_CH_CTRL2_EN_MASK)) {
+			Sim.Ctrl2 = 0U;
+			Sim.Running = 0;
+		}
+		break;
+	case XZDMA_CH_SRC_START_LSB_OFFSET:
+		Sim.SrcLsb = Value;
+		break;
+	case XZDMA_CH_SRC_START_MSB_OFFSET:
+		Sim.SrcMsb = Value;
+		break;
+	case XZDMA_CH_DST_START_LSB_OFFSET:
+		Sim.DstLsb = Value;
+		break;
+	case XZDMA_CH_DST_START_MSB_OFFSET:
+		Sim.DstMsb = Value;
+		break;
+	default:
+		break;
+	}
+}
+
+/* Cache maintenance only costs time, the model is coherent */
+static void SimCache(INTPTR Addr, u32 Len)
+{
+	u64 Lines = ((u64)Addr + Len + SIM_LINE - 1U) / SIM_LINE -
+		    (u64)Addr / SIM_LINE;
+
+	SimNow += Timing.CacheCallPs + Timing.CacheLinePs * Lines;
+}
+
+void Xil_DCacheFlushRange(INTPTR Addr, u32 Len)
+{
+	SimCache(Addr, Len);
+}
+
+void Xil_DCacheInvalidateRange(INTPTR Addr, u32 Len)
+{
+	SimCache(Addr, Len);
+}
+
+void xil_printf(const char8 *Format, ...)
+{
+	(void)Format;
+}
+
+u32 Xil_AssertStatus;
+
+void Xil_Assert(const char8 *File, s32 Line)
+{
+	printf("assert %s:%d\n", File, (int)Line);
+}
+
+/************************** Test Helpers *************************************/
+
+static u32 Failures;
+
+#define CHECK(Cond, Msg)						\
+	do {								\
+		if (!(Cond)) {						\
+			printf("FAIL %s:%d: %s\n", __FILE__, __LINE__,	\
+								(Msg));	\
+			Failures++;					\
+		}							\
+	} while (0)
+
+/* Bus speeds of a ZynqMP: APB register access, A53 memcpy() from cache,
+ * ZDMA on the FPD
+ */
+static const SimTiming ZynqMpTiming = {
+	60000U, 40000U, 1000U, 20000U, 400U, 400000U, 160U
+};
+
+static XZDma ZDma;
+static XZDma_Mcpy Mcpy;
+
+typedef struct {
+	u32 Calls;
+	s32 Status;
+	u32 Order;
+} DoneLog;
+
+static u32 DoneSeq;
+
+static void DoneHandler(void *CallBackRef, s32 Status)
+{
+	DoneLog *Log = (DoneLog *)CallBackRef;
+
+	Log->Calls++;
+	Log->Status = Status;
+	Log->Order = DoneSeq++;
+}
+
+static void Setup(const SimTiming *T)
+{
+	XZDma_Config Config;
+	s32 Status;
+	u32 i;
+
+	SimReset();
+	Timing = *T;
+	SimNow = 0U;
+	DoneSeq = 0U;
+
+	memset(&Config, 0, sizeof(Config));
+	Config.BaseAddress = SIM_BASE;
+	Status = XZDma_CfgInitialize(&ZDma, &Config, SIM_BASE);
+	CHECK(Status == XST_SUCCESS, "cfg initialize");
+	Status = XZDma_McpyInitialize(&Mcpy, &ZDma, (UINTPTR)DscrMem,
+				      sizeof(DscrMem), FillBuf,
+				      sizeof(FillBuf));
+	CHECK(Status == XST_SUCCESS && Mcpy.DscrCount == SIM_DSCRS,
+	      "mcpy initialize");
+
+	for (i = 0U; i < SIM_BUF_LEN; i++)
+		SrcBuf[i] = (u8)(i * 7U + (i >> 8));
+	memset(DstBuf, 0, sizeof(DstBuf));
+}
+
+static void Drain(void)
+{
+	u32 Loops = 0U;
+
+	while (Mcpy.Active != NULL && Loops++ < 1000000U)
+		(void)XZDma_McpyPoll(&Mcpy);
+}
+
+/************************** Tests ********************************************/
+
+static void TestCopyFill(void)
+{
+	XZDma_McpyReq Req[6];
+	DoneLog Log[6];
+	u32 i;
+
+	Setup(&ZynqMpTiming);
+	XZDma_McpySetCpuThreshold(&Mcpy, 0U);
+	memset(Log, 0, sizeof(Log));
+	memset(Req, 0, sizeof(Req));
+
+	/* The first copy starts at once, the rest, a fill among them,
+	 * queue up and go as the next chain
+	 */
+	for (i = 0U; i < 6U; i++) {
+		Req[i].DstAddr = (UINTPTR)&DstBuf[i * 4096U];
+		Req[i].SrcAddr = (UINTPTR)&SrcBuf[i * 1000U];
+		Req[i].Size = 1000U + i * 500U;
+		Req[i].Handler = DoneHandler;
+		Req[i].CallBackRef = &Log[i];
+	}
+	Req[3].IsFill = TRUE;
+	Req[3].FillValue = 0xA5U;
+	Req[3].Size = 1000U;	/* Four source descriptors of FillBuf */
+
+	for (i = 0U; i < 6U; i++)
+		CHECK(XZDma_McpySubmit(&Mcpy, &Req[i]) == XST_SUCCESS,
+		      "submit");
+	CHECK(Sim.Chains == 1U, "first chain started at once");
+	Drain();
+
+	CHECK(Sim.Errors == 0U, "descriptor lists");
+	CHECK(Sim.Chains == 2U, "copies and fill chained");
+	for (i = 0U; i < 6U; i++) {
+		CHECK(Log[i].Calls == 1U && Log[i].Status == XST_SUCCESS &&
+		      Log[i].Order == i, "completion");
+	}
+	for (i = 0U; i < 6U; i++) {
+		if (i == 3U)
+			continue;
+		CHECK(memcmp((void *)Req[i].DstAddr, (void *)Req[i].SrcAddr,
+			     Req[i].Size) == 0, "copy data");
+	}
+	for (i = 0U; i < Req[3].Size; i++) {
+		if (DstBuf[3U * 4096U + i] != 0xA5U)
+			break;
+	}
+	CHECK(i == Req[3].Size, "fill data");
+	CHECK(Mcpy.DmaCount == 6U && Mcpy.CpuCount == 0U, "counts");
+
+	/* Below the threshold the CPU does it at submit */
+	XZDma_McpySetCpuThreshold(&Mcpy, 512U);
+	Req[0].Size = 100U;
+	Log[0].Calls = 0U;
+	CHECK(XZDma_McpySubmit(&Mcpy, &Req[0]) == XST_SUCCESS &&
+	      Log[0].Calls == 1U && Mcpy.CpuCount == 1U &&
+	      Sim.Chains == 2U, "cpu copy");
+}
+
+static void TestCalibrate(void)
+{
+	SimTiming Slow = ZynqMpTiming;
+	SimTiming Fast = ZynqMpTiming;
+	SimTiming NoDma = ZynqMpTiming;
+	u32 Threshold = 0U;
+	s32 Status;
+
+	Setup(&ZynqMpTiming);
+	Status = XZDma_McpyCalibrate(&Mcpy, (UINTPTR)SrcBuf, (UINTPTR)DstBuf,
+				     SIM_BUF_LEN, SimTime, &Threshold);
+	printf("Calibrated threshold %u bytes\n", Threshold);
+	CHECK(Status == XST_SUCCESS && Threshold == 8192U &&
+	      Mcpy.CpuThreshold == 8192U, "crossover");
+	CHECK(Sim.Errors == 0U && Mcpy.Active == NULL, "idle after");
+
+	/* A DMA that starts slowly takes over later */
+	Slow.DmaStartPs *= 8U;
+	Setup(&Slow);
+	Status = XZDma_McpyCalibrate(&Mcpy, (UINTPTR)SrcBuf, (UINTPTR)DstBuf,
+				     SIM_BUF_LEN, SimTime, &Threshold);
+	CHECK(Status == XST_SUCCESS && Threshold == 32768U, "slow start");
+
+	/* Free maintenance and a quick start: the DMA wins from the
+	 * first size
+	 */
+	Fast.DmaStartPs = 0U;
+	Fast.RegPs = 1000U;
+	Fast.CacheCallPs = 0U;
+	Fast.CacheLinePs = 0U;
+	Setup(&Fast);
+	Status = XZDma_McpyCalibrate(&Mcpy, (UINTPTR)SrcBuf, (UINTPTR)DstBuf,
+				     SIM_BUF_LEN, SimTime, &Threshold);
+	CHECK(Status == XST_SUCCESS &&
+	      Threshold == XZDMA_MCPY_CAL_MIN_SIZE, "dma always faster");
+
+	/* A DMA slower per byte than the CPU never wins */
+	NoDma.DmaBytePs = NoDma.CpuBytePs * 2U;
+	Setup(&NoDma);
+	Status = XZDma_McpyCalibrate(&Mcpy, (UINTPTR)SrcBuf, (UINTPTR)DstBuf,
+				     SIM_BUF_LEN, SimTime, &Threshold);
+	CHECK(Status == XST_SUCCESS && Threshold == 2U * SIM_BUF_LEN &&
+	      Mcpy.CpuThreshold == 2U * SIM_BUF_LEN, "cpu always faster");
+
+	/* Nothing to measure */
+	Setup(&ZynqMpTiming);
+	Threshold = 1U;
+	Status = XZDma_McpyCalibrate(&Mcpy, (UINTPTR)SrcBuf, (UINTPTR)DstBuf,
+				     XZDMA_MCPY_CAL_MIN_SIZE - 1U, SimTime,
+				     &Threshold);
+	CHECK(Status == XST_INVALID_PARAM && Threshold == 1U &&
+	      Mcpy.CpuThreshold == XZDMA_MCPY_CPU_THRESHOLD, "max too small");
+}
+
+static void TestCalibrateFails(void)
+{
+	/* The first copy, and the one at which the DMA takes over */
+	static const u32 FaultChain[2] = { 1U, 8U };
+	u32 Threshold;
+	s32 Status;
+	u32 Run;
+	XZDma_McpyReq Req;
+	DoneLog Log;
+
+	for (Run = 0U; Run < 2U * (SIM_FAULTS - 1); Run++) {
+		Setup(&ZynqMpTiming);
+		XZDma_McpySetCpuThreshold(&Mcpy, 777U);
+		Sim.Fault = (int)(Run >> 1U) + 1;
+		Sim.FaultChain = FaultChain[Run & 1U];
+
+		Threshold = 1U;
+		Status = XZDma_McpyCalibrate(&Mcpy, (UINTPTR)SrcBuf,
+					     (UINTPTR)DstBuf, SIM_BUF_LEN,
+					     SimTime, &Threshold);
+		CHECK(Status == XST_FAILURE, "calibration must fail");
+		CHECK(Threshold == 1U && Mcpy.CpuThreshold == 777U,
+		      "threshold kept");
+		CHECK(Mcpy.Active == NULL && Mcpy.Head == NULL,
+		      "service idle after a failure");
+
+		/* The service still works */
+		memset(&Req, 0, sizeof(Req));
+		memset(&Log, 0, sizeof(Log));
+		memset(DstBuf, 0, 2048U);
+		Req.DstAddr = (UINTPTR)DstBuf;
+		Req.SrcAddr = (UINTPTR)SrcBuf;
+		Req.Size = 2048U;
+		Req.Handler = DoneHandler;
+		Req.CallBackRef = &Log;
+		CHECK(XZDma_McpySubmit(&Mcpy, &Req) == XST_SUCCESS, "resubmit");
+		Drain();
+		CHECK(Log.Calls == 1U && Log.Status == XST_SUCCESS &&
+		      memcmp(DstBuf, SrcBuf, 2048U) == 0, "copy after failure");
+	}
+}
+
+/* Simulated time to copy Count buffers of Size bytes with Threshold,
+ * waiting for each copy or queueing them all
+ */
+static u64 CopyPs(u32 Size, u32 Count, u32 Threshold, int Queue)
+{
+	XZDma_McpyReq Req[16];
+	u64 Start;
+	u32 i;
+
+	XZDma_McpySetCpuThreshold(&Mcpy, Threshold);
+	memset(Req, 0, sizeof(Req));
+	Start = SimNow;
+	for (i = 0U; i < Count; i++) {
+		Req[i].DstAddr = (UINTPTR)&DstBuf[(i * Size) % SIM_BUF_LEN];
+		Req[i].SrcAddr = (UINTPTR)&SrcBuf[(i * Size) % SIM_BUF_LEN];
+		Req[i].Size = Size;
+		(void)XZDma_McpySubmit(&Mcpy, &Req[i]);
+		if (!Queue)
+			Drain();
+	}
+	Drain();
+
+	return SimNow - Start;
+}
+
+static double MBps(u32 Size, u32 Count, u64 Ps)
+{
+	return (double)Size * Count * 1e6 / (double)Ps;
+}
+
+static void TestBenchmark(void)
+{
+	const u32 Count = 16U;
+	u32 Threshold;
+	u32 Size;
+	u64 Cpu;
+	u64 Dma;
+	u64 Cal;
+	u64 Best;
+	int Queue;
+
+	Setup(&ZynqMpTiming);
+	CHECK(XZDma_McpyCalibrate(&Mcpy, (UINTPTR)SrcBuf, (UINTPTR)DstBuf,
+				  SIM_BUF_LEN, SimTime, &Threshold) ==
+	      XST_SUCCESS, "calibrate");
+
+	/* The calibration times single copies, so with one copy at a time
+	 * the calibrated service must keep up with the faster of memcpy()
+	 * and the DMA at every size. Queued copies share a chain and the
+	 * start latency, the DMA then wins below the threshold too, but
+	 * the service is never slower than memcpy() alone.
+	 */
+	for (Queue = 0; Queue < 2; Queue++) {
+		printf("%s copies of %u buffers, simulated MB/s:\n",
+		       Queue ? "Queued" : "Single", Count);
+		printf("  %8s %10s %10s %12s\n", "size", "memcpy", "dma",
+		       "calibrated");
+		for (Size = 64U; Size <= 16384U; Size <<= 1U) {
+			Cpu = CopyPs(Size, Count, ~0U, Queue);
+			Dma = CopyPs(Size, Count, 0U, Queue);
+			Cal = CopyPs(Size, Count, Threshold, Queue);
+			printf("  %8u %10.0f %10.0f %12.0f\n", Size,
+			       MBps(Size, Count, Cpu), MBps(Size, Count, Dma),
+			       MBps(Size, Count, Cal));
+
+			Best = (Cpu < Dma) ? Cpu : Dma;
+			if (!Queue) {
+				CHECK(Cal * 10U <= Best * 11U,
+				      "calibrated service too slow");
+			}
+			else {
+				CHECK(Cal <= Cpu,
+				      "calibrated service slower than memcpy");
+			}
+			CHECK(memcmp(DstBuf, SrcBuf, Size) == 0, "copy data");
+		}
+	}
+	CHECK(Sim.Errors == 0U, "descriptor lists");
+}
+
+/************************** Main *********************************************/
+
+int main(void)
+{
+	TestCopyFill();
+	TestCalibrate();
+	TestCalibrateFails();
+	TestBenchmark();
+
+	printf("%s (%u failures)\n", Failures ? "FAILED" : "PASSED",
+							Failures);
+	return Failures ? 1 : 0;
+}
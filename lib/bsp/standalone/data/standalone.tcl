@@ -752,6 +752,8 @@ proc generate {os_handle} {
 			puts $bspcfg_fh "#define EL1_NONSECURE 0"
 			puts $bspcfg_fh "#define HYP_GUEST 0"
 		}
+		set mmu_l3_tables [common::get_property CONFIG.mmu_l3_tables $os_handle ]
+		puts $bspcfg_fh "#define XIL_MMU_L3_TABLES ${mmu_l3_tables}U"
 	}
     } elseif { $proctype == "psu_cortexa72" || $proctype == "psv_cortexa72"} {
                 set extra_flags [common::get_property CONFIG.extra_compiler_flags [hsi::get_sw_processor]]
@@ -765,6 +767,8 @@ proc generate {os_handle} {
                     puts $bspcfg_fh "#define EL1_NONSECURE 0"
                     puts $bspcfg_fh "#define HYP_GUEST 0"
                }
+               set mmu_l3_tables [common::get_property CONFIG.mmu_l3_tables $os_handle ]
+               puts $bspcfg_fh "#define XIL_MMU_L3_TABLES ${mmu_l3_tables}U"
 
     } elseif { $proctype == "ps7_cortexa9" } {
 		if {[string compare -nocase $compiler "arm-none-eabi-gcc"] == 0} {
@@ -106,6 +106,7 @@ extern "C" {
 
 #define mtcpicall(reg)	__asm__ __volatile__("ic " #reg)
 #define mtcptlbi(reg)	__asm__ __volatile__("tlbi " #reg)
+#define mtcptlbiva(reg,val)	__asm__ __volatile__("tlbi " #reg ",%x0" : : "r" (val))
 #define mtcpat(reg,val)	__asm__ __volatile__("at " #reg ",%x0" : : "r" (val))
 
 /* CP15 operations */
@@ -33,6 +33,7 @@
 #include "xpseudo_asm.h"
 #include "xil_types.h"
 #include "xil_mmu.h"
+#include "xstatus.h"
 #include "bspconfig.h"
 /***************** Macros (Inline Functions) Definitions *********************/
 
@@ -44,12 +45,220 @@
 #define BLOCK_SIZE_1GB 0x40000000U
 #define ADDRESS_LIMIT_4GB 0x100000000UL
 
+#define PAGE_SIZE_4KB 0x1000U
+#define ENTRIES_PER_TABLE 512U
+
+/* Translation table descriptor fields */
+#define DESC_TYPE_MASK 0x3UL
+#define DESC_TYPE_TABLE 0x3UL
+#define DESC_VALID 0x1UL
+#define DESC_PAGE 0x2UL
+#define DESC_ADDR_MASK 0x0000FFFFFFFFF000UL
+#define DESC_BLOCK_2MB_ADDR_MASK 0x0000FFFFFFE00000UL
+
+/*
+ * Number of 4KB level 3 tables available to split 2MB blocks, set by the
+ * mmu_l3_tables BSP parameter. Each table occupies 4KB and maps one 2MB
+ * block. With no table, Xil_SetTlbAttributesRange only accepts whole 2MB
+ * sections.
+ */
+#ifndef XIL_MMU_L3_TABLES
+#define XIL_MMU_L3_TABLES 0U
+#endif
+
+/*
+ * Above these sizes the commit falls back to full cache and TLB
+ * maintenance, which is cheaper than walking the range line by line or
+ * page by page.
+ */
+#define CACHE_RANGE_FLUSH_LIMIT 0x100000U
+#define TLB_RANGE_INVAL_LIMIT 64U
+
 /************************** Variable Definitions *****************************/
 
 extern INTPTR MMUTableL1;
 extern INTPTR MMUTableL2;
 
+#if XIL_MMU_L3_TABLES > 0
+static u64 MmuL3Tables[XIL_MMU_L3_TABLES][ENTRIES_PER_TABLE]
+	__attribute__ ((aligned (PAGE_SIZE_4KB)));
+static u8 MmuL3TableUsed[XIL_MMU_L3_TABLES];
+#endif
+
+static u32 MmuBatchDepth;
+static UINTPTR MmuDirtyStart;
+static UINTPTR MmuDirtyEnd;
+static u8 MmuFullFlush;
+
 /************************** Function Prototypes ******************************/
+
+static void Xil_MmuTlbInvalidate(UINTPTR Start, UINTPTR End);
+static void Xil_MmuSetEntry(u64 *Entry, u64 Desc, UINTPTR Va, u64 Size);
+
+/*****************************************************************************/
+/**
+* @brief	Records a remapped region for the next cache and TLB maintenance
+* 			sequence and runs it right away unless a batch is open.
+*
+* @param	Start: First address of the remapped region.
+* @param	End: Address following the remapped region.
+* @param	attrib: New attributes of the region.
+*
+* @return	None.
+*
+******************************************************************************/
+static void Xil_MmuMarkDirty(UINTPTR Start, UINTPTR End, u64 attrib)
+{
+	if (MmuDirtyStart == MmuDirtyEnd) {
+		MmuDirtyStart = Start;
+		MmuDirtyEnd = End;
+	} else {
+		MmuDirtyStart = (Start < MmuDirtyStart) ? Start : MmuDirtyStart;
+		MmuDirtyEnd = (End > MmuDirtyEnd) ? End : MmuDirtyEnd;
+	}
+
+	/* Cache maintenance by VA is not possible on a faulting region */
+	if ((attrib & DESC_VALID) == 0U) {
+		MmuFullFlush = 1U;
+	}
+
+	if (MmuBatchDepth == 0U) {
+		Xil_MmuBatchCommit();
+	}
+}
+
+/*****************************************************************************/
+/**
+* @brief	Takes a level 3 table from the static pool.
+*
+* @return	Pointer to the table, or NULL if the pool is empty.
+*
+******************************************************************************/
+static u64 *Xil_MmuAllocL3Table(void)
+{
+#if XIL_MMU_L3_TABLES > 0
+	u32 Idx;
+
+	for (Idx = 0U; Idx < XIL_MMU_L3_TABLES; Idx++) {
+		if (MmuL3TableUsed[Idx] == 0U) {
+			MmuL3TableUsed[Idx] = 1U;
+			return MmuL3Tables[Idx];
+		}
+	}
+#endif
+	return NULL;
+}
+
+/*****************************************************************************/
+/**
+* @brief	Returns a level 3 table to the pool if Entry points to one.
+*
+* @param	Entry: Level 2 descriptor which has been replaced.
+*
+* @return	None.
+*
+* @note		The descriptor must already be unlinked and its TLB entries
+* 			invalidated, as done by Xil_MmuSetEntry.
+*
+******************************************************************************/
+static void Xil_MmuFreeL3Table(u64 Entry)
+{
+#if XIL_MMU_L3_TABLES > 0
+	u32 Idx;
+
+	if ((Entry & DESC_TYPE_MASK) != DESC_TYPE_TABLE) {
+		return;
+	}
+
+	for (Idx = 0U; Idx < XIL_MMU_L3_TABLES; Idx++) {
+		if ((Entry & DESC_ADDR_MASK) == (u64)(UINTPTR)MmuL3Tables[Idx]) {
+			MmuL3TableUsed[Idx] = 0U;
+			break;
+		}
+	}
+#else
+	(void)Entry;
+#endif
+}
+
+/*****************************************************************************/
+/**
+* @brief	Fills a level 3 table which is about to replace a 2MB block. The
+* 			pages of [Start, End) get the new attributes, the other pages
+* 			keep the mapping and attributes of the block.
+*
+* @param	Table: Level 3 table, not linked yet.
+* @param	Block: Level 2 block or fault descriptor being replaced.
+* @param	Va: First address mapped by the block.
+* @param	Start: First page to remap, within the block.
+* @param	End: Address following the last page to remap.
+* @param	PageAttrib: Page attributes for [Start, End).
+*
+* @return	None.
+*
+******************************************************************************/
+static void Xil_MmuFillL3Table(u64 *Table, u64 Block, UINTPTR Va,
+			       UINTPTR Start, UINTPTR End, u64 PageAttrib)
+{
+	u64 Base = Block & DESC_BLOCK_2MB_ADDR_MASK;
+	u64 Attrib = Block & ~(DESC_BLOCK_2MB_ADDR_MASK | DESC_TYPE_MASK);
+	UINTPTR PageVa;
+	u32 Idx;
+
+	for (Idx = 0U; Idx < ENTRIES_PER_TABLE; Idx++) {
+		PageVa = Va + ((UINTPTR)Idx * PAGE_SIZE_4KB);
+		if ((PageVa >= Start) && (PageVa < End)) {
+			Table[Idx] = PageVa | PageAttrib;
+		} else if ((Block & DESC_VALID) == 0U) {
+			Table[Idx] = 0U;
+		} else {
+			Table[Idx] = (Base + ((u64)Idx * PAGE_SIZE_4KB)) |
+					Attrib | DESC_PAGE | DESC_VALID;
+		}
+	}
+}
+
+/*****************************************************************************/
+/**
+* @brief	Remaps pages of a level 3 table in use. Valid pages whose
+* 			descriptor changes follow the break-before-make sequence: they
+* 			are all made invalid, their TLB entries are invalidated and
+* 			only then the new descriptors are written.
+*
+* @param	Table: Level 3 table linked in the level 2 table.
+* @param	Va: First address mapped by the table.
+* @param	Start: First page to remap, within the table.
+* @param	End: Address following the last page to remap.
+* @param	PageAttrib: New page attributes.
+*
+* @return	None.
+*
+******************************************************************************/
+static void Xil_MmuUpdateL3Pages(u64 *Table, UINTPTR Va, UINTPTR Start,
+				 UINTPTR End, u64 PageAttrib)
+{
+	UINTPTR PageVa;
+	u32 Broken = 0U;
+	u64 *Page;
+
+	for (PageVa = Start; PageVa < End; PageVa += PAGE_SIZE_4KB) {
+		Page = &Table[(PageVa - Va) / PAGE_SIZE_4KB];
+		if (((*Page & DESC_VALID) != 0U) &&
+		    (*Page != (PageVa | PageAttrib))) {
+			*Page = 0U;
+			Broken = 1U;
+		}
+	}
+
+	if (Broken != 0U) {
+		Xil_MmuTlbInvalidate(Start, End);
+	}
+
+	for (PageVa = Start; PageVa < End; PageVa += PAGE_SIZE_4KB) {
+		Table[(PageVa - Va) / PAGE_SIZE_4KB] = PageVa | PageAttrib;
+	}
+}
+
 /*****************************************************************************/
 /**
 * brief		It sets the memory attributes for a section, in the translation
@@ -66,7 +275,11 @@ extern INTPTR MMUTableL2;
 * @return	None.
 *
 * @note		The MMU and D-cache need not be disabled before changing an
-*			translation table attribute.
+*			translation table attribute. A 2MB section which was split by
+*			Xil_SetTlbAttributesRange is merged back into a single block,
+*			using a break-before-make sequence during which the section
+*			is unmapped. Such a section must not hold the code, stack or
+*			translation tables in use.
 *
 ******************************************************************************/
 void Xil_SetTlbAttributes(UINTPTR Addr, u64 attrib)
@@ -74,6 +287,7 @@ void Xil_SetTlbAttributes(UINTPTR Addr, u64 attrib)
 	INTPTR *ptr;
 	INTPTR section;
 	u64 block_size;
+	u64 old;
 	/* if region is less than 4GB MMUTable level 2 need to be modified */
 	if(Addr < ADDRESS_LIMIT_4GB){
 		/* block size is 2MB for addressed < 4GB*/
@@ -88,16 +302,262 @@ void Xil_SetTlbAttributes(UINTPTR Addr, u64 attrib)
 		section = Addr / block_size;
 		ptr = &MMUTableL1 + section;
 	}
-	*ptr = (Addr & (~(block_size-1))) | attrib;
+	old = (u64)*ptr;
+	Xil_MmuSetEntry((u64 *)ptr, (Addr & (~(block_size-1))) | attrib,
+			Addr & (~(block_size-1)), block_size);
+	Xil_MmuFreeL3Table(old);
 
-	Xil_DCacheFlush();
+	Xil_MmuMarkDirty(Addr & (~(block_size-1)),
+			 (Addr & (~(block_size-1))) + block_size, attrib);
+}
+
+/*****************************************************************************/
+/**
+* @brief	It sets the memory attributes for an address range with 4KB
+* 			granularity. Whole 2MB sections in the range are updated as
+* 			blocks, partially covered 2MB sections are split into 4KB
+* 			pages using level 3 tables taken from a static pool of
+* 			XIL_MMU_L3_TABLES tables, set by the mmu_l3_tables BSP
+* 			parameter. Pages of a section split earlier are changed with
+* 			the break-before-make sequence. Regions above 4GB can only be
+* 			updated in whole 1GB sections.
+*
+* @param	Addr: 64-bit start address of the region, 4KB aligned.
+* @param	Size: Size of the region in bytes, multiple of 4KB.
+* @param	attrib: Attribute for the specified memory region. xil_mmu.h
+*			contains commonly used memory attributes definitions which can be
+*			utilized for this function.
+*
+* @return	XST_SUCCESS if the range is updated, XST_INVALID_PARAM for a
+* 			misaligned range or one wrapping around the address space, or
+* 			XST_FAILURE if the level 3 table pool is exhausted or empty. On failure the part of the range processed so far
+* 			keeps its new attributes.
+*
+* @note		The TLB and data cache maintenance is done once for the whole
+* 			range, or once at Xil_MmuBatchCommit when called between
+* 			Xil_MmuBatchStart and Xil_MmuBatchCommit. Small ranges are
+* 			handled by address instead of flushing the entire cache.
+* 			Splitting a 2MB block into pages, or merging pages back into
+* 			a block, is done at once with a break-before-make sequence
+* 			during which the whole 2MB section is unmapped. Such a
+* 			section must not hold the code, stack or translation tables
+* 			in use.
+*
+******************************************************************************/
+s32 Xil_SetTlbAttributesRange(UINTPTR Addr, u64 Size, u64 attrib)
+{
+	s32 Status = XST_SUCCESS;
+	UINTPTR Cur = Addr;
+	UINTPTR End = Addr + Size;
+	u64 *L2Table = (u64 *)&MMUTableL2;
+	u64 *L1Table = (u64 *)&MMUTableL1;
+	u64 *L3Table;
+	u64 *Entry;
+	UINTPTR Section;
+	UINTPTR SegEnd;
+	u64 PageAttrib;
+	u64 Old;
+
+	if (((Addr | Size) & (PAGE_SIZE_4KB - 1U)) != 0U) {
+		return XST_INVALID_PARAM;
+	}
+	if (Size == 0U) {
+		return XST_SUCCESS;
+	}
+	/* The range must not wrap around the end of the address space */
+	if (End <= Addr) {
+		return XST_INVALID_PARAM;
+	}
+	/* Above 4GB only whole 1GB sections can be updated */
+	if ((End > ADDRESS_LIMIT_4GB) &&
+	    (((Addr > ADDRESS_LIMIT_4GB) && ((Addr % BLOCK_SIZE_1GB) != 0U)) ||
+	     ((End % BLOCK_SIZE_1GB) != 0U))) {
+		return XST_INVALID_PARAM;
+	}
+
+	/* A fault entry stays a fault entry at page level */
+	PageAttrib = ((attrib & DESC_VALID) != 0U) ? (attrib | DESC_PAGE) : attrib;
+
+	while (Cur < End) {
+		if (Cur >= ADDRESS_LIMIT_4GB) {
+			Xil_MmuSetEntry(&L1Table[Cur / BLOCK_SIZE_1GB],
+					Cur | attrib, Cur, BLOCK_SIZE_1GB);
+			Cur += BLOCK_SIZE_1GB;
+		} else if (((Cur % BLOCK_SIZE_2MB) == 0U) &&
+			   ((End - Cur) >= BLOCK_SIZE_2MB)) {
+			Old = L2Table[Cur / BLOCK_SIZE_2MB];
+			Xil_MmuSetEntry(&L2Table[Cur / BLOCK_SIZE_2MB],
+					Cur | attrib, Cur, BLOCK_SIZE_2MB);
+			Xil_MmuFreeL3Table(Old);
+			Cur += BLOCK_SIZE_2MB;
+		} else {
+			Section = Cur & ~(UINTPTR)(BLOCK_SIZE_2MB - 1U);
+			SegEnd = ((End - Section) < BLOCK_SIZE_2MB) ?
+				 End : (Section + BLOCK_SIZE_2MB);
+			Entry = &L2Table[Cur / BLOCK_SIZE_2MB];
+			if ((*Entry & DESC_TYPE_MASK) == DESC_TYPE_TABLE) {
+				L3Table = (u64 *)(UINTPTR)(*Entry & DESC_ADDR_MASK);
+				Xil_MmuUpdateL3Pages(L3Table, Section, Cur, SegEnd,
+						     PageAttrib);
+			} else {
+				L3Table = Xil_MmuAllocL3Table();
+				if (L3Table == NULL) {
+					Status = XST_FAILURE;
+					break;
+				}
+				/* Complete the table before it is linked */
+				Xil_MmuFillL3Table(L3Table, *Entry, Section, Cur,
+						   SegEnd, PageAttrib);
+				dsb();
+				Xil_MmuSetEntry(Entry,
+						(u64)(UINTPTR)L3Table | DESC_TYPE_TABLE,
+						Section, BLOCK_SIZE_2MB);
+			}
+			Cur = SegEnd;
+		}
+	}
+
+	if (Cur != Addr) {
+		Xil_MmuMarkDirty(Addr, Cur, attrib);
+	}
+
+	return Status;
+}
+
+/*****************************************************************************/
+/**
+* @brief	Opens a batch of translation table updates. Xil_SetTlbAttributes
+* 			and Xil_SetTlbAttributesRange calls made until the matching
+* 			Xil_MmuBatchCommit only update the translation tables, the
+* 			TLB and data cache maintenance is deferred to the commit.
+* 			Batches can be nested.
+*
+* @return	None.
+*
+* @note		Accesses to an updated region may use the old attributes
+* 			until the batch is committed.
+*
+******************************************************************************/
+void Xil_MmuBatchStart(void)
+{
+	MmuBatchDepth++;
+}
+
+/*****************************************************************************/
+/**
+* @brief	Closes a batch of translation table updates and performs a single
+* 			TLB invalidation and data cache clean and invalidate covering
+* 			every region updated in the batch.
+*
+* @return	None.
+*
+******************************************************************************/
+void Xil_MmuBatchCommit(void)
+{
+	if (MmuBatchDepth > 0U) {
+		MmuBatchDepth--;
+	}
+	if ((MmuBatchDepth != 0U) || (MmuDirtyStart == MmuDirtyEnd)) {
+		return;
+	}
+
+	Xil_MmuTlbInvalidate(MmuDirtyStart, MmuDirtyEnd);
+
+	/* Drop lines allocated under the old attributes */
+	if ((MmuFullFlush != 0U) ||
+	    ((MmuDirtyEnd - MmuDirtyStart) > CACHE_RANGE_FLUSH_LIMIT)) {
+		Xil_DCacheFlush();
+	} else {
+		Xil_DCacheFlushRange((INTPTR)MmuDirtyStart,
+				     (INTPTR)(MmuDirtyEnd - MmuDirtyStart));
+	}
+
+	MmuDirtyStart = 0U;
+	MmuDirtyEnd = 0U;
+	MmuFullFlush = 0U;
+}
+
+/*****************************************************************************/
+/**
+* @brief	Invalidates the TLB entries of a region, page by page for small
+* 			regions and as a whole for large ones.
+*
+* @param	Start: First address of the region.
+* @param	End: Address following the region.
+*
+* @return	None.
+*
+******************************************************************************/
+static void Xil_MmuTlbInvalidate(UINTPTR Start, UINTPTR End)
+{
+	UINTPTR Page;
 
-	if (EL3 == 1)
-		mtcptlbi(ALLE3);
-	else if (EL1_NONSECURE == 1)
-		mtcptlbi(VMALLE1);
+	/* ensure completion of the translation table updates */
+	dsb();
+
+	if (((End - Start) / PAGE_SIZE_4KB) > TLB_RANGE_INVAL_LIMIT) {
+		if (EL3 == 1)
+			mtcptlbi(ALLE3);
+		else if (EL1_NONSECURE == 1)
+			mtcptlbi(VMALLE1);
+	} else {
+		for (Page = Start; Page < End; Page += PAGE_SIZE_4KB) {
+			if (EL3 == 1)
+				mtcptlbiva(VAE3, Page >> 12U);
+			else if (EL1_NONSECURE == 1)
+				mtcptlbiva(VAE1, Page >> 12U);
+		}
+	}
 
 	dsb(); /* ensure completion of the BP and TLB invalidation */
-    isb(); /* synchronize context on this processor */
+	isb(); /* synchronize context on this processor */
+}
+
+/*****************************************************************************/
+/**
+* @brief	Writes a level 1 or level 2 translation table entry. Replacing
+* 			a valid block by a table, or a table by a block or a fault
+* 			entry, follows the break-before-make sequence: the entry is
+* 			made invalid, the TLB entries of the region are invalidated
+* 			and only then the new descriptor is written. Other updates
+* 			are plain writes whose maintenance is left to
+* 			Xil_MmuBatchCommit.
+*
+* @param	Entry: Translation table entry to update.
+* @param	Desc: New descriptor.
+* @param	Va: First address mapped by the entry.
+* @param	Size: Size of the region mapped by the entry.
+*
+* @return	None.
+*
+* @note		The region is unmapped during the sequence, so it must not hold
+* 			the code, stack or translation tables used by the caller.
+*
+******************************************************************************/
+static void Xil_MmuSetEntry(u64 *Entry, u64 Desc, UINTPTR Va, u64 Size)
+{
+	u64 Old = *Entry;
+
+	if (((Old & DESC_VALID) == 0U) ||
+	    ((Old & DESC_TYPE_MASK) == (Desc & DESC_TYPE_MASK)) ||
+	    (((Old & DESC_TYPE_MASK) != DESC_TYPE_TABLE) &&
+	     ((Desc & DESC_TYPE_MASK) != DESC_TYPE_TABLE))) {
+		*Entry = Desc;
+		return;
+	}
+
+	*Entry = 0U;
+	/*
+	 * A block is cached as a single TLB entry, while a table may have
+	 * left one entry per page of the region.
+	 */
+	if ((Old & DESC_TYPE_MASK) == DESC_TYPE_TABLE) {
+		Xil_MmuTlbInvalidate(Va, Va + Size);
+	} else {
+		Xil_MmuTlbInvalidate(Va, Va + PAGE_SIZE_4KB);
+	}
+	*Entry = Desc;
 
+	dsb(); /* ensure completion of the translation table update */
+	isb(); /* synchronize context on this processor */
 }
@@ -76,6 +76,9 @@ extern "C" {
 /************************** Function Prototypes ******************************/
 
 void Xil_SetTlbAttributes(UINTPTR Addr, u64 attrib);
+s32 Xil_SetTlbAttributesRange(UINTPTR Addr, u64 Size, u64 attrib);
+void Xil_MmuBatchStart(void);
+void Xil_MmuBatchCommit(void);
 
 #ifdef __cplusplus
 }
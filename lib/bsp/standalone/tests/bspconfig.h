@@ -0,0 +1,19 @@
+/******************************************************************************
+* Copyright (C) 2020 Xilinx, Inc.  All rights reserved.
+* SPDX-License-Identifier: MIT
+******************************************************************************/
+
+/*
+ * BSP configuration used by the host tests: A53/A72 64-bit BSP running at
+ * EL3 with two level 3 translation tables
+ */
+#ifndef BSPCONFIG_H
+#define BSPCONFIG_H
+
+#define MICROBLAZE_PVR_NONE
+#define EL3 1
+#define EL1_NONSECURE 0
+#define HYP_GUEST 0
+#define XIL_MMU_L3_TABLES 2U
+
+#endif
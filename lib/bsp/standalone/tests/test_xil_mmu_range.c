@@ -0,0 +1,331 @@
+/******************************************************************************
+* Copyright (C) 2020 Xilinx, Inc.  All rights reserved.
+* SPDX-License-Identifier: MIT
+******************************************************************************/
+
+/*
+ * Host test of Xil_SetTlbAttributesRange in the A53/A72 64-bit xil_mmu.c.
+ *
+ * The level 1 and level 2 tables are arrays in host memory and the level 3
+ * tables come from the pool of xil_mmu.c, sized to two tables by the
+ * bspconfig.h of this directory. A TLB model sits behind the barrier and
+ * TLBI macros: at every barrier each page of a 8MB window is looked up in
+ * the tables, a cached translation which differs from a valid table entry
+ * counts as a break-before-make violation, and valid translations are then
+ * cached as the hardware walker may do at any time. Block translations are
+ * cached once for the whole block, and a TLBI by address drops them. After
+ * every call the tables must hold the expected mapping and the TLB model no
+ * stale translation.
+ *
+ * Build and run on the host:
+ *   cc -Wall -I. -I../src/common -I../src/arm/ARMv8/64bit \
+ *      test_xil_mmu_range.c -o test_xil_mmu_range
+ *   ./test_xil_mmu_range
+ */
+
+#include <stdio.h>
+#include <string.h>
+
+#undef __linux__
+#include "xil_types.h"
+
+/* Barriers and TLB maintenance go to the TLB model */
+#define XPSEUDO_ASM_H
+static void ModelBarrier(void);
+static void ModelTlbiAll(void);
+static void ModelTlbiVa(u64 Page);
+#define dsb()			ModelBarrier()
+#define isb()			ModelBarrier()
+#define mtcptlbi(reg)		ModelTlbiAll()
+#define mtcptlbiva(reg, val)	ModelTlbiVa(val)
+
+#define XIL_CACHE_H
+static unsigned int FullFlushes;
+static unsigned int RangeFlushes;
+static void Xil_DCacheFlush(void) { FullFlushes++; }
+static void Xil_DCacheFlushRange(INTPTR adr, INTPTR len)
+{
+	(void)adr;
+	(void)len;
+	RangeFlushes++;
+}
+
+/* The translation tables of translation_table.S */
+#define MMUTableL1 (*MmuModelL1Base)
+#define MMUTableL2 (*MmuModelL2Base)
+
+#include "../src/arm/ARMv8/64bit/xil_mmu.c"
+
+static INTPTR MmuModelL1[512];
+static INTPTR MmuModelL2[2048];
+INTPTR *MmuModelL1Base = MmuModelL1;
+INTPTR *MmuModelL2Base = MmuModelL2;
+
+#define WIN_BASE	0x40000000UL
+#define WIN_SECTIONS	4U
+#define WIN_PAGES	(WIN_SECTIONS * ENTRIES_PER_TABLE)
+#define PAGE_VA(p)	(WIN_BASE + ((UINTPTR)(p) * PAGE_SIZE_4KB))
+
+#define CHECK(cond, msg) \
+	do { \
+		if (!(cond)) { \
+			printf("FAIL: %s (line %d)\n", msg, __LINE__); \
+			Failures++; \
+		} \
+	} while (0)
+
+static unsigned int Failures;
+
+/* TLB model: cached page translation and the block it came from, if any */
+static u64 TlbDesc[WIN_PAGES];
+static UINTPTR TlbBlock[WIN_PAGES];
+static unsigned int Violations;
+static unsigned int Tlbis;
+
+/* Page mapping expected after each call */
+static u64 Expected[WIN_PAGES];
+
+/* Page translation of the tables in page descriptor form, 0 for a fault */
+static u64 Translate(UINTPTR Va, UINTPTR *Block)
+{
+	u64 Entry = (u64)MmuModelL2[Va / BLOCK_SIZE_2MB];
+	u64 *L3;
+
+	*Block = 0U;
+	if ((Entry & DESC_VALID) == 0U) {
+		return 0U;
+	}
+	if ((Entry & DESC_TYPE_MASK) == DESC_TYPE_TABLE) {
+		L3 = (u64 *)(UINTPTR)(Entry & DESC_ADDR_MASK);
+		Entry = L3[(Va / PAGE_SIZE_4KB) % ENTRIES_PER_TABLE];
+		return ((Entry & DESC_VALID) != 0U) ? Entry : 0U;
+	}
+	*Block = (Va & ~(UINTPTR)(BLOCK_SIZE_2MB - 1U)) + 1U;
+	return (Entry & DESC_BLOCK_2MB_ADDR_MASK) +
+	       (Va & (BLOCK_SIZE_2MB - 1U) & ~(UINTPTR)(PAGE_SIZE_4KB - 1U)) +
+	       (Entry & ~(DESC_BLOCK_2MB_ADDR_MASK | DESC_TYPE_MASK)) +
+	       DESC_PAGE + DESC_VALID;
+}
+
+static void ModelBarrier(void)
+{
+	UINTPTR Block;
+	u64 Desc;
+	u32 Page;
+
+	for (Page = 0U; Page < WIN_PAGES; Page++) {
+		Desc = Translate(PAGE_VA(Page), &Block);
+		if (Desc == 0U) {
+			continue;
+		}
+		if ((TlbDesc[Page] != 0U) && (TlbDesc[Page] != Desc)) {
+			Violations++;
+		}
+		if (TlbDesc[Page] == 0U) {
+			TlbDesc[Page] = Desc;
+			TlbBlock[Page] = Block;
+		}
+	}
+}
+
+static void ModelTlbiAll(void)
+{
+	Tlbis++;
+	memset(TlbDesc, 0, sizeof(TlbDesc));
+	memset(TlbBlock, 0, sizeof(TlbBlock));
+}
+
+static void ModelTlbiVa(u64 Page)
+{
+	UINTPTR Va = (UINTPTR)(Page << 12U);
+	UINTPTR Block;
+	u32 Idx;
+
+	Tlbis++;
+	if ((Va < WIN_BASE) || (Va >= PAGE_VA(WIN_PAGES))) {
+		return;
+	}
+	Block = TlbBlock[(Va - WIN_BASE) / PAGE_SIZE_4KB];
+	for (Idx = 0U; Idx < WIN_PAGES; Idx++) {
+		if ((PAGE_VA(Idx) == Va) || ((Block != 0U) && (TlbBlock[Idx] == Block))) {
+			TlbDesc[Idx] = 0U;
+			TlbBlock[Idx] = 0U;
+		}
+	}
+}
+
+static void ExpectRange(UINTPTR Addr, u64 Size, u64 attrib)
+{
+	UINTPTR Va;
+
+	for (Va = Addr; Va < Addr + Size; Va += PAGE_SIZE_4KB) {
+		Expected[(Va - WIN_BASE) / PAGE_SIZE_4KB] =
+			((attrib & DESC_VALID) != 0U) ? (Va | attrib | DESC_PAGE) : 0U;
+	}
+}
+
+static void CheckState(const char *Phase)
+{
+	unsigned int Wrong = 0U, Stale = 0U;
+	UINTPTR Block;
+	u64 Desc;
+	u32 Page;
+	char Msg[96];
+
+	for (Page = 0U; Page < WIN_PAGES; Page++) {
+		Desc = Translate(PAGE_VA(Page), &Block);
+		if (Desc != Expected[Page]) {
+			Wrong++;
+		}
+		if ((TlbDesc[Page] != 0U) && (TlbDesc[Page] != Desc)) {
+			Stale++;
+		}
+	}
+	snprintf(Msg, sizeof(Msg), "%s: %u pages mapped wrong", Phase, Wrong);
+	CHECK(Wrong == 0U, Msg);
+	snprintf(Msg, sizeof(Msg), "%s: %u stale TLB entries", Phase, Stale);
+	CHECK(Stale == 0U, Msg);
+	snprintf(Msg, sizeof(Msg), "%s: %u break-before-make violations", Phase,
+		 Violations);
+	CHECK(Violations == 0U, Msg);
+	Violations = 0U;
+}
+
+static void Setup(void)
+{
+	u32 Idx;
+
+	memset(MmuModelL1, 0, sizeof(MmuModelL1));
+	memset(MmuModelL2, 0, sizeof(MmuModelL2));
+	for (Idx = 0U; Idx < WIN_SECTIONS; Idx++) {
+		MmuModelL2[WIN_BASE / BLOCK_SIZE_2MB + Idx] =
+			(INTPTR)((WIN_BASE + Idx * BLOCK_SIZE_2MB) | NORM_WB_CACHE);
+	}
+	ExpectRange(WIN_BASE, WIN_SECTIONS * BLOCK_SIZE_2MB, NORM_WB_CACHE);
+	/* Everything cached, as after running from the window */
+	ModelBarrier();
+	CheckState("setup");
+}
+
+static void TestParams(void)
+{
+	INTPTR Saved[2048];
+
+	memcpy(Saved, MmuModelL2, sizeof(Saved));
+	CHECK(Xil_SetTlbAttributesRange(WIN_BASE + 0x800U, PAGE_SIZE_4KB,
+					DEVICE_MEMORY) == XST_INVALID_PARAM,
+	      "misaligned address accepted");
+	CHECK(Xil_SetTlbAttributesRange(WIN_BASE, 0x1800U, DEVICE_MEMORY) ==
+	      XST_INVALID_PARAM, "partial page accepted");
+	CHECK(Xil_SetTlbAttributesRange((UINTPTR)0 - 2U * PAGE_SIZE_4KB,
+					4U * PAGE_SIZE_4KB, DEVICE_MEMORY) ==
+	      XST_INVALID_PARAM, "wrapping range accepted");
+	CHECK(Xil_SetTlbAttributesRange((UINTPTR)0 - BLOCK_SIZE_1GB,
+					BLOCK_SIZE_1GB, DEVICE_MEMORY) ==
+	      XST_INVALID_PARAM, "range ending at 2^64 accepted");
+	CHECK(Xil_SetTlbAttributesRange(WIN_BASE, 0U, DEVICE_MEMORY) ==
+	      XST_SUCCESS, "empty range rejected");
+	CHECK(memcmp(Saved, MmuModelL2, sizeof(Saved)) == 0,
+	      "rejected range changed the tables");
+	CheckState("rejected ranges");
+}
+
+static void TestSplitAndRemap(void)
+{
+	unsigned int Before;
+	INTPTR Entry;
+
+	/* A block is split into a table built before it is linked */
+	CHECK(Xil_SetTlbAttributesRange(WIN_BASE + 0x1000U, 0x3000U,
+					STRONG_ORDERED) == XST_SUCCESS, "split");
+	ExpectRange(WIN_BASE + 0x1000U, 0x3000U, STRONG_ORDERED);
+	Entry = MmuModelL2[WIN_BASE / BLOCK_SIZE_2MB];
+	CHECK(((u64)Entry & DESC_TYPE_MASK) == DESC_TYPE_TABLE,
+	      "section not split");
+	CHECK(((u64)Entry & DESC_ADDR_MASK) == (u64)(UINTPTR)MmuL3Tables[0],
+	      "table not from the pool");
+	CHECK(RangeFlushes == 1U, "range not flushed once");
+	CheckState("split");
+
+	/* Pages already remapped change again, through an invalid entry */
+	CHECK(Xil_SetTlbAttributesRange(WIN_BASE + 0x2000U, 0x4000U,
+					DEVICE_MEMORY) == XST_SUCCESS, "remap");
+	ExpectRange(WIN_BASE + 0x2000U, 0x4000U, DEVICE_MEMORY);
+	CheckState("remap pages");
+
+	/* Unchanged pages need no sequence */
+	Before = Tlbis;
+	CHECK(Xil_SetTlbAttributesRange(WIN_BASE + 0x2000U, 0x2000U,
+					DEVICE_MEMORY) == XST_SUCCESS, "same");
+	CHECK(Tlbis - Before == 2U, "same attributes broke pages");
+	CheckState("same attributes");
+
+	/* Unmapping pages leaves fault entries and flushes the whole cache */
+	CHECK(Xil_SetTlbAttributesRange(WIN_BASE + 0x3000U, 0x1000U,
+					RESERVED) == XST_SUCCESS, "unmap");
+	ExpectRange(WIN_BASE + 0x3000U, 0x1000U, RESERVED);
+	CHECK(FullFlushes == 1U, "unmap not fully flushed");
+	CheckState("unmap page");
+}
+
+static void TestSectionsAndPool(void)
+{
+	INTPTR Entry;
+
+	/* A range over a section boundary splits the second section */
+	CHECK(Xil_SetTlbAttributesRange(WIN_BASE + BLOCK_SIZE_2MB - 0x1000U,
+					0x2000U, NORM_NONCACHE) == XST_SUCCESS,
+	      "cross section");
+	ExpectRange(WIN_BASE + BLOCK_SIZE_2MB - 0x1000U, 0x2000U, NORM_NONCACHE);
+	CheckState("cross section");
+
+	/* Both tables are in use: a third split fails */
+	CHECK(Xil_SetTlbAttributesRange(WIN_BASE + 2U * BLOCK_SIZE_2MB,
+					0x1000U, NORM_NONCACHE) == XST_FAILURE,
+	      "pool exhaustion not reported");
+	CheckState("pool exhausted");
+
+	/* A whole section over a table merges it back and frees the table */
+	CHECK(Xil_SetTlbAttributesRange(WIN_BASE, BLOCK_SIZE_2MB,
+					NORM_WB_CACHE) == XST_SUCCESS, "merge");
+	ExpectRange(WIN_BASE, BLOCK_SIZE_2MB, NORM_WB_CACHE);
+	Entry = MmuModelL2[WIN_BASE / BLOCK_SIZE_2MB];
+	CHECK(((u64)Entry & DESC_TYPE_MASK) != DESC_TYPE_TABLE, "not merged");
+	CheckState("merge");
+
+	CHECK(Xil_SetTlbAttributesRange(WIN_BASE + 2U * BLOCK_SIZE_2MB,
+					0x1000U, NORM_NONCACHE) == XST_SUCCESS,
+	      "freed table not reused");
+	ExpectRange(WIN_BASE + 2U * BLOCK_SIZE_2MB, 0x1000U, NORM_NONCACHE);
+	CheckState("reuse");
+}
+
+static void TestBatch(void)
+{
+	unsigned int Flushes = RangeFlushes + FullFlushes;
+
+	Xil_MmuBatchStart();
+	CHECK(Xil_SetTlbAttributesRange(WIN_BASE + 2U * BLOCK_SIZE_2MB + 0x1000U,
+					0x1000U, DEVICE_MEMORY) == XST_SUCCESS,
+	      "batch 1");
+	CHECK(Xil_SetTlbAttributesRange(WIN_BASE + 2U * BLOCK_SIZE_2MB,
+					0x1000U, DEVICE_MEMORY) == XST_SUCCESS,
+	      "batch 2");
+	CHECK(RangeFlushes + FullFlushes == Flushes, "flushed inside batch");
+	Xil_MmuBatchCommit();
+	ExpectRange(WIN_BASE + 2U * BLOCK_SIZE_2MB, 0x2000U, DEVICE_MEMORY);
+	CHECK(RangeFlushes + FullFlushes == Flushes + 1U, "batch not flushed once");
+	CheckState("batch");
+}
+
+int main(void)
+{
+	Setup();
+	TestParams();
+	TestSplitAndRemap();
+	TestSectionsAndPool();
+	TestBatch();
+
+	printf("%s (%u failures)\n", Failures ? "FAILED" : "PASSED", Failures);
+	return Failures ? 1 : 0;
+}
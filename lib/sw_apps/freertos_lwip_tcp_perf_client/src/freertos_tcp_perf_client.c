@@ -32,6 +32,11 @@
 static char send_buf[TCP_SEND_BUFSIZE];
 static struct perf_stats client;
 
+/* Latency histogram records the time spent in lwip_send() in us, the
+ * socket API hides when the data is acknowledged
+ */
+static struct perf_bench bench = { "tcp_client", "send_us" };
+
 /* Report interval time in ms */
 #define REPORT_INTERVAL_TIME (INTERIM_REPORT_INTERVAL * 1000)
 /* End time in ms */
@@ -141,12 +146,16 @@ static void tcp_conn_report(u64_t diff, enum report_type report_type)
 
 	if (report_type == INTER_REPORT)
 		client.i_report.last_report_time += duration;
+
+	perf_bench_report(&bench, (report_type == INTER_REPORT) ? "interim" :
+			(report_type == TCP_ABORTED_REMOTE) ? "aborted" : "final");
 }
 
 int tcp_send_perf_traffic(int sock)
 {
 	int bytes_send;
 	u8_t apiflags = MSG_MORE;
+	u64_t send_us;
 
 	client.start_time = sys_now();
 	client.client_id++;
@@ -156,6 +165,7 @@ int tcp_send_perf_traffic(int sock)
 	client.total_bytes = 0;
 
 	print_tcp_txperf_header(sock);
+	perf_bench_start(&bench, client.client_id);
 
 #if (defined (__aarch64__) && defined (XLWIP_CONFIG_INCLUDE_GEM))
 	 /* For ZynqMP A53 GEM, TCP traffic stopped after few seconds with
@@ -164,8 +174,10 @@ int tcp_send_perf_traffic(int sock)
 #endif
 
 	while (1) {
-		if ((bytes_send = lwip_send(sock, send_buf, sizeof(send_buf),
-						apiflags)) < 0) {
+		send_us = perf_bench_time_us();
+		bytes_send = lwip_send(sock, send_buf, sizeof(send_buf),
+				apiflags);
+		if (bytes_send < 0) {
 			xil_printf("TCP Client: Either connection aborted"
 					" from remote or Error on tcp_write\r\n");
 			u64_t now = sys_now();
@@ -174,6 +186,8 @@ int tcp_send_perf_traffic(int sock)
 			break;
 		}
 
+		perf_hist_record(&bench.lat, perf_bench_time_us() - send_us);
+		perf_bench_add(&bench, bytes_send, 1);
 		client.total_bytes += bytes_send;
 
 		if (END_TIME || REPORT_INTERVAL_TIME) {
@@ -38,6 +38,7 @@
 #include "lwip/sys.h"
 #include "xil_printf.h"
 #include <sleep.h>
+#include "perf_bench.h"
 
 /* used as indices into kLabel[] */
 enum {
@@ -31,6 +31,9 @@
 extern struct netif server_netif;
 static struct perf_stats server;
 
+/* Latency histogram records the gap between received reads in us */
+static struct perf_bench bench = { "tcp_server", "gap_us" };
+
 /* Interval time in seconds */
 #define REPORT_INTERVAL_TIME (INTERIM_REPORT_INTERVAL * 1000)
 
@@ -135,6 +138,9 @@ static void tcp_conn_report(u64_t diff, enum report_type report_type)
 
 	if (report_type == INTER_REPORT)
 		server.i_report.last_report_time += duration;
+
+	perf_bench_report(&bench, (report_type == INTER_REPORT) ? "interim" :
+			(report_type == TCP_ABORTED_REMOTE) ? "aborted" : "final");
 }
 
 /* thread spawned for each connection */
@@ -143,6 +149,7 @@ void tcp_recv_perf_traffic(void *p)
 	char recv_buf[RECV_BUF_SIZE];
 	int read_bytes;
 	int sock = *((int *)p);
+	u64_t now_us, last_rx_us = 0;
 
 	server.start_time = sys_now();
 	server.client_id++;
@@ -152,6 +159,7 @@ void tcp_recv_perf_traffic(void *p)
 	server.total_bytes = 0;
 
 	print_tcp_conn_stats(sock);
+	perf_bench_start(&bench, server.client_id);
 
 	while (1) {
 		/* read a max of RECV_BUF_SIZE bytes from socket */
@@ -172,6 +180,13 @@ void tcp_recv_perf_traffic(void *p)
 			break;
 		}
 
+		/* Record read gap for the benchmark report */
+		now_us = perf_bench_time_us();
+		if (last_rx_us)
+			perf_hist_record(&bench.lat, now_us - last_rx_us);
+		last_rx_us = now_us;
+		perf_bench_add(&bench, read_bytes, 1);
+
 		if (REPORT_INTERVAL_TIME) {
 			u64_t now = sys_now();
 			server.i_report.total_bytes += read_bytes;
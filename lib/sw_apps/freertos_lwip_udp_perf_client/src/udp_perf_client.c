@@ -35,6 +35,11 @@ static struct perf_stats client;
 static char send_buf[UDP_SEND_BUFSIZE];
 static struct sockaddr_in addr;
 static int sock[NUM_OF_PARALLEL_CLIENTS];
+
+/* Latency histogram records the time spent in lwip_sendto() in us, lost
+ * counts failed sends
+ */
+static struct perf_bench bench = { "udp_client", "send_us" };
 #define FINISH	1
 /* Report interval time in ms */
 #define REPORT_INTERVAL_TIME (INTERIM_REPORT_INTERVAL * 1000)
@@ -126,6 +131,9 @@ static void udp_conn_report(u64_t diff,
 	else
 		xil_printf("[%3d] sent %llu datagrams\n\r",
 				client.client_id, client.cnt_datagrams);
+
+	perf_bench_report(&bench,
+			(report_type == INTER_REPORT) ? "interim" : "final");
 }
 
 
@@ -145,6 +153,8 @@ static void reset_stats(void)
 	client.i_report.start_time = 0;
 	client.i_report.total_bytes = 0;
 	client.i_report.last_report_time = 0;
+
+	perf_bench_start(&bench, client.client_id);
 }
 
 static int udp_packet_send(u8_t finished)
@@ -153,6 +163,7 @@ static int udp_packet_send(u8_t finished)
 	int i, count, *payload;
 	u8_t retries = MAX_SEND_RETRY;
 	socklen_t len = sizeof(addr);
+	u64_t send_us;
 
 	payload = (int*) (send_buf);
 	if (finished == FINISH)
@@ -164,15 +175,20 @@ static int udp_packet_send(u8_t finished)
 
 	for (i = 0; i < NUM_OF_PARALLEL_CLIENTS; i++) {
 		while (retries) {
+			send_us = perf_bench_time_us();
 			count = lwip_sendto(sock[i], send_buf, sizeof(send_buf), 0,
 					(struct sockaddr *)&addr, len);
+			perf_hist_record(&bench.lat,
+					perf_bench_time_us() - send_us);
 			if (count <= 0) {
+				bench.lost++;
 				retries--;
 				usleep(ERROR_SLEEP);
 			} else {
 				client.total_bytes += count;
 				client.cnt_datagrams++;
 				client.i_report.total_bytes += count;
+				perf_bench_add(&bench, count, 1);
 				break;
 			}
 		}
@@ -40,6 +40,7 @@
 #include <sleep.h>
 #include "xil_printf.h"
 #include "xlwipconfig.h"
+#include "perf_bench.h"
 
 /* used as indices into kLabel[] */
 enum {
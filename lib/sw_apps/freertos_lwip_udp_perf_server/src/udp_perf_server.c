@@ -32,6 +32,10 @@
 
 extern struct netif server_netif;
 static struct perf_stats server;
+
+/* Latency histogram records the gap between datagrams in us */
+static struct perf_bench bench = { "udp_server", "gap_us" };
+static u64_t last_rx_us;
 /* Report interval in ms */
 #define REPORT_INTERVAL_TIME (INTERIM_REPORT_INTERVAL * 1000)
 
@@ -136,6 +140,9 @@ static void udp_conn_report(u64_t diff,
 				server.client_id, time,
 				cnt_out_of_order_datagrams);
 	}
+
+	perf_bench_report(&bench,
+			(report_type == INTER_REPORT) ? "interim" : "final");
 }
 
 
@@ -157,6 +164,9 @@ static void reset_stats(void)
 	server.i_report.cnt_datagrams = 0;
 	server.i_report.cnt_dropped_datagrams = 0;
 	server.i_report.last_report_time = 0;
+
+	perf_bench_start(&bench, server.client_id);
+	last_rx_us = 0;
 }
 
 /** Receive data on a udp session */
@@ -169,6 +179,7 @@ static void udp_recv_perf_traffic(int sock)
 	char recv_buf[UDP_RECV_BUFSIZE];
 	struct sockaddr_in from;
 	socklen_t fromlen = sizeof(from);
+	u64_t now_us;
 
 	while (1) {
 		if((count = lwip_recvfrom(sock, recv_buf, UDP_RECV_BUFSIZE, 0,
@@ -212,6 +223,7 @@ static void udp_recv_perf_traffic(int sock)
 		}
 
 		/* Update dropped datagrams statistics */
+		drop_datagrams = 0;
 		if (server.expected_datagram_id != recv_id) {
 			if (server.expected_datagram_id < recv_id) {
 				drop_datagrams =
@@ -231,6 +243,14 @@ static void udp_recv_perf_traffic(int sock)
 		/* Record total bytes for final report */
 		server.total_bytes += count;
 
+		/* Record datagram gap and loss for the benchmark report */
+		now_us = perf_bench_time_us();
+		if (last_rx_us)
+			perf_hist_record(&bench.lat, now_us - last_rx_us);
+		last_rx_us = now_us;
+		bench.lost += drop_datagrams;
+		perf_bench_add(&bench, count, 1);
+
 		if (REPORT_INTERVAL_TIME) {
 			u64_t now = sys_now();
 
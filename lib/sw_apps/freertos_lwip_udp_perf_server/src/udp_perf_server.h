@@ -38,6 +38,7 @@
 #include "lwip/sys.h"
 #include "errno.h"
 #include "xil_printf.h"
+#include "perf_bench.h"
 
 
 /* used as indices into kLabel[] */
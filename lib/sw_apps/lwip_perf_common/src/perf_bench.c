@@ -0,0 +1,329 @@
+/*
+ * Copyright (C) 2017 - 2019 Xilinx, Inc.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ * 3. The name of the author may not be used to endorse or promote products
+ *    derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR ``AS IS'' AND ANY EXPRESS OR IMPLIED
+ * WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT
+ * SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT
+ * OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING
+ * IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY
+ * OF SUCH DAMAGE.
+ *
+ */
+
+/* Benchmark core shared by the lwIP perf applications: latency
+ * histograms, CPU accounting and CSV/JSON reports. All the perf
+ * applications copy it from lwip_perf_common at generation time. The
+ * bare-metal (RAW API) applications account idle main loop iterations,
+ * the FreeRTOS (socket API) ones the time spent in the idle task.
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include "perf_bench.h"
+#ifndef __MICROBLAZE__
+#include "xtime_l.h"
+#endif
+#ifdef OS_IS_FREERTOS
+#include "FreeRTOS.h"
+#include "task.h"
+#include "lwip/sys.h"
+#endif
+
+#ifdef OS_IS_FREERTOS
+/* A longer gap between two idle hook calls means another task or an
+ * interrupt ran in between.
+ */
+#define PERF_BENCH_IDLE_GAP_US	5
+
+/* Idle task accounting, updated by the idle hook */
+static u64_t idle_last_us;
+static u64_t cpu_idle_us;
+#else
+/* Idle loop accounting, updated once per main loop iteration */
+static u64_t cpu_last_us;
+static u64_t cpu_idle_us;
+static u64_t cpu_total_us;
+static u32_t cpu_work;
+#endif
+
+#if PERF_BENCH_OUTPUT == PERF_BENCH_OUTPUT_CSV
+static u8_t csv_header_done;
+#endif
+
+u64_t perf_bench_time_us(void)
+{
+#if defined(__MICROBLAZE__) && defined(OS_IS_FREERTOS)
+	return (u64_t)sys_now() * 1000;
+#elif defined(__MICROBLAZE__)
+	return get_time_ms() * 1000;
+#elif defined(ARMR5)
+	XTime tCur = 0;
+	static XTime tlast = 0, tHigh = 0;
+	u64_t time;
+
+	XTime_GetTime(&tCur);
+	if (tCur < tlast)
+		tHigh++;
+	tlast = tCur;
+	time = (((u64_t) tHigh) << 32U) | (u64_t)tCur;
+	return (time / (COUNTS_PER_SECOND / 1000000));
+#else
+	XTime tCur = 0;
+
+	XTime_GetTime(&tCur);
+	return (tCur / (COUNTS_PER_SECOND / 1000000));
+#endif
+}
+
+static u32_t perf_hist_index(u32_t value)
+{
+	u32_t msb;
+
+	if (value < PERF_HIST_SUB_COUNT)
+		return value;
+
+	msb = 31 - __builtin_clz(value);
+	return ((msb - PERF_HIST_SUB_BITS + 1) << PERF_HIST_SUB_BITS) +
+		((value >> (msb - PERF_HIST_SUB_BITS)) - PERF_HIST_SUB_COUNT);
+}
+
+/* Highest value that lands in a bucket */
+static u32_t perf_hist_bucket_max(u32_t index)
+{
+	u32_t shift;
+	u32_t mant;
+
+	if (index < 2 * PERF_HIST_SUB_COUNT)
+		return index;
+
+	shift = (index >> PERF_HIST_SUB_BITS) - 1;
+	mant = (index & (PERF_HIST_SUB_COUNT - 1)) + PERF_HIST_SUB_COUNT;
+	return (u32_t)((((u64_t)mant + 1) << shift) - 1);
+}
+
+void perf_hist_reset(struct perf_hist *hist)
+{
+	memset(hist, 0, sizeof(*hist));
+	hist->min = 0xFFFFFFFF;
+}
+
+void perf_hist_record(struct perf_hist *hist, u32_t value)
+{
+	hist->bucket[perf_hist_index(value)]++;
+	hist->count++;
+	hist->sum += value;
+	if (value < hist->min)
+		hist->min = value;
+	if (value > hist->max)
+		hist->max = value;
+}
+
+/** Value below which permille/1000 of the samples fall */
+u32_t perf_hist_percentile(const struct perf_hist *hist, u32_t permille)
+{
+	u64_t rank;
+	u64_t seen = 0;
+	u32_t i;
+
+	if (hist->count == 0)
+		return 0;
+
+	rank = ((u64_t)hist->count * permille + 999) / 1000;
+	if (rank == 0)
+		rank = 1;
+
+	for (i = 0; i < PERF_HIST_BUCKETS; i++) {
+		seen += hist->bucket[i];
+		if (seen >= rank)
+			break;
+	}
+
+	if (i == PERF_HIST_BUCKETS || perf_hist_bucket_max(i) > hist->max)
+		return hist->max;
+	return perf_hist_bucket_max(i);
+}
+
+static u32_t perf_bench_lwip_drops(void)
+{
+	u32_t drops = 0;
+
+#if LWIP_STATS
+#if LINK_STATS
+	drops += lwip_stats.link.drop;
+#endif
+#if IP_STATS
+	drops += lwip_stats.ip.drop;
+#endif
+#if TCP_STATS
+	drops += lwip_stats.tcp.drop;
+#endif
+#if UDP_STATS
+	drops += lwip_stats.udp.drop;
+#endif
+#endif /* LWIP_STATS */
+	return drops;
+}
+
+static u32_t perf_bench_lwip_rexmit(void)
+{
+#if MIB2_STATS
+	return lwip_stats.mib2.tcpretranssegs;
+#else
+	return 0;
+#endif
+}
+
+#ifdef OS_IS_FREERTOS
+/** Called by the kernel on every idle task iteration, requires
+ * use_idle_hook in the FreeRTOS BSP settings
+ */
+void vApplicationIdleHook(void)
+{
+	u64_t now = perf_bench_time_us();
+	u64_t delta = now - idle_last_us;
+
+	taskENTER_CRITICAL();
+	if (idle_last_us && delta <= PERF_BENCH_IDLE_GAP_US)
+		cpu_idle_us += delta;
+	taskEXIT_CRITICAL();
+	idle_last_us = now;
+}
+
+static u64_t perf_bench_idle_us(void)
+{
+	u64_t idle;
+
+	taskENTER_CRITICAL();
+	idle = cpu_idle_us;
+	taskEXIT_CRITICAL();
+	return idle;
+}
+
+static u64_t perf_bench_total_us(void)
+{
+	return perf_bench_time_us();
+}
+#else
+static u64_t perf_bench_idle_us(void)
+{
+	return cpu_idle_us;
+}
+
+static u64_t perf_bench_total_us(void)
+{
+	return cpu_total_us;
+}
+#endif
+
+void perf_bench_start(struct perf_bench *bench, u8_t id)
+{
+	bench->id = id;
+	bench->start_us = perf_bench_time_us();
+	bench->bytes = 0;
+	bench->packets = 0;
+	bench->lost = 0;
+	bench->drops_base = perf_bench_lwip_drops();
+	bench->rexmit_base = perf_bench_lwip_rexmit();
+	bench->idle_base_us = perf_bench_idle_us();
+	bench->total_base_us = perf_bench_total_us();
+	perf_hist_reset(&bench->lat);
+}
+
+void perf_bench_add(struct perf_bench *bench, u32_t bytes, u32_t packets)
+{
+	bench->bytes += bytes;
+	bench->packets += packets;
+#ifndef OS_IS_FREERTOS
+	cpu_work++;
+#endif
+}
+
+#ifndef OS_IS_FREERTOS
+/** Account the main loop iteration that just ended. An iteration that
+ * received nothing and moved no benchmark data counts as idle.
+ */
+void perf_bench_cpu_account(u32_t busy)
+{
+	u64_t now = perf_bench_time_us();
+	u64_t delta;
+
+	if (cpu_last_us) {
+		delta = now - cpu_last_us;
+		cpu_total_us += delta;
+		if (!busy && !cpu_work)
+			cpu_idle_us += delta;
+	}
+	cpu_work = 0;
+	cpu_last_us = now;
+}
+#endif
+
+void perf_bench_report(struct perf_bench *bench, const char *phase)
+{
+#if PERF_BENCH_OUTPUT != PERF_BENCH_OUTPUT_NONE
+	char line[384];
+	struct perf_hist *lat = &bench->lat;
+	u64_t elapsed = perf_bench_time_us() - bench->start_us;
+	u64_t total = perf_bench_total_us() - bench->total_base_us;
+	u64_t idle = perf_bench_idle_us() - bench->idle_base_us;
+	/* CPU utilization in tenths of a percent, printed as fixed point */
+	u32_t cpu = 0;
+
+	if (idle > total)
+		idle = total;
+	if (total)
+		cpu = 1000 - (u32_t)((idle * 1000 + total / 2) / total);
+
+#if PERF_BENCH_OUTPUT == PERF_BENCH_OUTPUT_CSV
+	if (!csv_header_done) {
+		xil_printf("PERF,app,id,phase,elapsed_us,bytes,packets,lost,"
+			"drops,rexmit,cpu_pct,metric,count,min,p50,p90,p99,"
+			"p999,max\n\r");
+		csv_header_done = 1;
+	}
+	sprintf(line, "PERF,%s,%u,%s,%llu,%llu,%llu,%llu,%lu,%lu,%lu.%lu,"
+		"%s,%lu,%lu,%lu,%lu,%lu,%lu,%lu",
+#else
+	sprintf(line, "{\"app\":\"%s\",\"id\":%u,\"phase\":\"%s\","
+		"\"elapsed_us\":%llu,\"bytes\":%llu,\"packets\":%llu,"
+		"\"lost\":%llu,\"drops\":%lu,\"rexmit\":%lu,\"cpu_pct\":%lu.%lu,"
+		"\"metric\":\"%s\",\"count\":%lu,\"min\":%lu,\"p50\":%lu,"
+		"\"p90\":%lu,\"p99\":%lu,\"p999\":%lu,\"max\":%lu}",
+#endif
+		bench->name, bench->id, phase,
+		(unsigned long long)elapsed,
+		(unsigned long long)bench->bytes,
+		(unsigned long long)bench->packets,
+		(unsigned long long)bench->lost,
+		(unsigned long)(perf_bench_lwip_drops() - bench->drops_base),
+		(unsigned long)(perf_bench_lwip_rexmit() - bench->rexmit_base),
+		(unsigned long)(cpu / 10), (unsigned long)(cpu % 10),
+		bench->lat_name, (unsigned long)lat->count,
+		(unsigned long)(lat->count ? lat->min : 0),
+		(unsigned long)perf_hist_percentile(lat, 500),
+		(unsigned long)perf_hist_percentile(lat, 900),
+		(unsigned long)perf_hist_percentile(lat, 990),
+		(unsigned long)perf_hist_percentile(lat, 999),
+		(unsigned long)lat->max);
+	xil_printf("%s\n\r", line);
+#else
+	LWIP_UNUSED_ARG(bench);
+	LWIP_UNUSED_ARG(phase);
+#endif
+}
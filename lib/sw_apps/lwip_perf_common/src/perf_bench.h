@@ -0,0 +1,94 @@
+/*
+ * Copyright (C) 2017 - 2019 Xilinx, Inc.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ * 3. The name of the author may not be used to endorse or promote products
+ *    derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR ``AS IS'' AND ANY EXPRESS OR IMPLIED
+ * WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT
+ * SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT
+ * OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING
+ * IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY
+ * OF SUCH DAMAGE.
+ *
+ */
+
+#ifndef __PERF_BENCH_H_
+#define __PERF_BENCH_H_
+
+#include "lwipopts.h"
+#include "lwip/arch.h"
+#include "lwip/stats.h"
+#include "xil_printf.h"
+#ifndef OS_IS_FREERTOS
+#include "platform.h"
+#endif
+
+/* Machine readable report format, printed next to the iperf style lines */
+#define PERF_BENCH_OUTPUT_NONE	0
+#define PERF_BENCH_OUTPUT_CSV	1
+#define PERF_BENCH_OUTPUT_JSON	2
+
+#ifndef PERF_BENCH_OUTPUT
+#define PERF_BENCH_OUTPUT PERF_BENCH_OUTPUT_CSV
+#endif
+
+/* Histogram buckets: exact below 16, then 16 linear buckets per power
+ * of two, so every recorded value is known to within 1/16 of itself.
+ */
+#define PERF_HIST_SUB_BITS	4
+#define PERF_HIST_SUB_COUNT	(1 << PERF_HIST_SUB_BITS)
+#define PERF_HIST_BUCKETS	((32 - PERF_HIST_SUB_BITS + 1) * \
+				PERF_HIST_SUB_COUNT)
+
+struct perf_hist {
+	u32_t count;
+	u32_t min;
+	u32_t max;
+	u64_t sum;
+	u32_t bucket[PERF_HIST_BUCKETS];
+};
+
+struct perf_bench {
+	/* application and histogram names used in the reports */
+	const char *name;
+	const char *lat_name;
+	u8_t id;
+	u64_t start_us;
+	u64_t bytes;
+	u64_t packets;
+	/* loss seen by the application, e.g. UDP datagram id gaps */
+	u64_t lost;
+	/* lwIP and idle time counters sampled at start */
+	u32_t drops_base;
+	u32_t rexmit_base;
+	u64_t idle_base_us;
+	u64_t total_base_us;
+	struct perf_hist lat;
+};
+
+u64_t perf_bench_time_us(void);
+void perf_hist_reset(struct perf_hist *hist);
+void perf_hist_record(struct perf_hist *hist, u32_t value);
+u32_t perf_hist_percentile(const struct perf_hist *hist, u32_t permille);
+void perf_bench_start(struct perf_bench *bench, u8_t id);
+void perf_bench_add(struct perf_bench *bench, u32_t bytes, u32_t packets);
+#ifndef OS_IS_FREERTOS
+void perf_bench_cpu_account(u32_t busy);
+#endif
+void perf_bench_report(struct perf_bench *bench, const char *phase);
+
+#endif /* __PERF_BENCH_H_ */
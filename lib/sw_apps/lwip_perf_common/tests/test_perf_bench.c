@@ -0,0 +1,393 @@
+/*
+ * Copyright (C) 2020 Xilinx, Inc.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ * 3. The name of the author may not be used to endorse or promote products
+ *    derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR ``AS IS'' AND ANY EXPRESS OR IMPLIED
+ * WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT
+ * SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT
+ * OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING
+ * IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY
+ * OF SUCH DAMAGE.
+ *
+ */
+
+/* Host test of the benchmark core shared by the lwIP perf applications.
+ *
+ * The histogram buckets are checked to hold every value to within 1/16
+ * of itself, and the percentiles of a log-uniform sample against the
+ * exact ones. A fake timer then drives the CPU accounting, of the main
+ * loop for the RAW API applications or of the idle hook for the FreeRTOS
+ * ones, and the report lines are captured from xil_printf and parsed,
+ * including the fixed point cpu_pct field.
+ *
+ * Build and run on the host, once per flavour (add -DOS_IS_FREERTOS for
+ * the FreeRTOS one and -DPERF_BENCH_OUTPUT=2 for the JSON report):
+ *   LWIP=../../../../ThirdParty/sw_services/lwip211/src
+ *   cc -Wall -O2 -I. -I$LWIP/lwip-2.1.1/src/include \
+ *      -I$LWIP/contrib/ports/xilinx/include -I../../lwip_tcp_perf_server/src \
+ *      -I../../../bsp/standalone/src/common \
+ *      -I../../../bsp/standalone/src/arm/ARMv8/64bit \
+ *      -I../../../../ThirdParty/bsp/freertos10_xilinx/src/Source/include \
+ *      test_perf_bench.c -o test_perf_bench
+ *   ./test_perf_bench
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdarg.h>
+#include <string.h>
+
+/* Fake timer and console in place of the BSP ones */
+#define XTIME_H
+#define XIL_PRINTF_H
+#define COUNTS_PER_SECOND	100000000ULL
+typedef unsigned long long XTime;
+
+static unsigned long long fake_us;
+static char console[4096];
+static size_t console_len;
+
+static void XTime_GetTime(XTime *Xtime)
+{
+	*Xtime = fake_us * (COUNTS_PER_SECOND / 1000000);
+}
+
+static void xil_printf(const char *fmt, ...)
+{
+	va_list ap;
+
+	va_start(ap, fmt);
+	console_len += vsnprintf(console + console_len,
+				 sizeof(console) - console_len, fmt, ap);
+	va_end(ap);
+}
+
+#ifdef OS_IS_FREERTOS
+#define INC_FREERTOS_H
+#define INC_TASK_H
+static int critical_nesting;
+static unsigned int critical_count;
+#define taskENTER_CRITICAL()	do { critical_nesting++; critical_count++; } while (0)
+#define taskEXIT_CRITICAL()	do { critical_nesting--; } while (0)
+#endif
+
+#include "../src/perf_bench.c"
+
+struct stats_ lwip_stats;
+
+#define CHECK(cond, msg) \
+	do { \
+		if (!(cond)) { \
+			printf("FAIL: %s (line %d)\n", msg, __LINE__); \
+			failures++; \
+		} \
+	} while (0)
+
+static unsigned int failures;
+static unsigned int lcg = 12345;
+
+static unsigned int rnd(void)
+{
+	lcg = lcg * 1103515245U + 12345U;
+	return lcg >> 8;
+}
+
+static void check_index(u32_t value)
+{
+	u32_t index = perf_hist_index(value);
+	u32_t top;
+
+	if (index >= PERF_HIST_BUCKETS) {
+		CHECK(0, "bucket index out of range");
+		return;
+	}
+	top = perf_hist_bucket_max(index);
+	if (top < value || top - value > value / 16 ||
+	    (index > 0 && perf_hist_bucket_max(index - 1) >= value)) {
+		printf("value %u: bucket %u up to %u\n", value, index, top);
+		CHECK(0, "value not within 1/16 of its bucket");
+	}
+}
+
+static void test_hist_index(void)
+{
+	u32_t v;
+	unsigned int i;
+
+	for (v = 0; v < (1U << 20); v++)
+		check_index(v);
+	for (i = 0; i < 32; i++) {
+		check_index(1U << i);
+		check_index((1U << i) - 1);
+		check_index((1U << i) + 1);
+	}
+	check_index(0xFFFFFFFF);
+	for (i = 0; i < 1000000; i++)
+		check_index((rnd() << 8) ^ rnd());
+}
+
+static int cmp_u32(const void *a, const void *b)
+{
+	u32_t x = *(const u32_t *)a, y = *(const u32_t *)b;
+
+	return x < y ? -1 : x > y;
+}
+
+#define NUM_SAMPLES	10007
+
+static void test_percentile(void)
+{
+	static const u32_t permille[] = { 1, 100, 500, 900, 990, 999, 1000 };
+	static u32_t samples[NUM_SAMPLES];
+	static struct perf_hist hist;
+	u32_t exact, got;
+	unsigned int i;
+	u64_t rank;
+
+	perf_hist_reset(&hist);
+	CHECK(perf_hist_percentile(&hist, 500) == 0, "empty histogram");
+
+	/* Log-uniform latencies from 1 us to about 16 s */
+	for (i = 0; i < NUM_SAMPLES; i++) {
+		samples[i] = 1 + (rnd() & ((1U << (rnd() % 24)) - 1));
+		perf_hist_record(&hist, samples[i]);
+	}
+	qsort(samples, NUM_SAMPLES, sizeof(samples[0]), cmp_u32);
+	CHECK(hist.count == NUM_SAMPLES, "sample count");
+	CHECK(hist.min == samples[0], "minimum");
+	CHECK(hist.max == samples[NUM_SAMPLES - 1], "maximum");
+
+	for (i = 0; i < sizeof(permille) / sizeof(permille[0]); i++) {
+		rank = ((u64_t)NUM_SAMPLES * permille[i] + 999) / 1000;
+		exact = samples[rank - 1];
+		got = perf_hist_percentile(&hist, permille[i]);
+		if (got < exact || got - exact > exact / 16 || got > hist.max) {
+			printf("p%u: %u, exact %u\n", permille[i], got, exact);
+			CHECK(0, "percentile not within 1/16");
+		}
+	}
+	CHECK(perf_hist_percentile(&hist, 1000) == hist.max, "p100 is the max");
+
+	/* Small values are exact, and the rank is rounded up */
+	perf_hist_reset(&hist);
+	for (i = 1; i <= 10; i++)
+		perf_hist_record(&hist, i);
+	CHECK(perf_hist_percentile(&hist, 150) == 2, "p15 of 1..10");
+	CHECK(perf_hist_percentile(&hist, 500) == 5, "p50 of 1..10");
+	CHECK(perf_hist_percentile(&hist, 999) == 10, "p99.9 of 1..10");
+}
+
+/* Value of a report field, from either the CSV or the JSON line */
+static const char *field(const char *line, const char *name, char *buf)
+{
+	static const char *const csv[] = { "PERF", "app", "id", "phase",
+		"elapsed_us", "bytes", "packets", "lost", "drops", "rexmit",
+		"cpu_pct", "metric", "count", "min", "p50", "p90", "p99", "p999",
+		"max" };
+	const char *p = line;
+	size_t len;
+	unsigned int i;
+
+#if PERF_BENCH_OUTPUT == PERF_BENCH_OUTPUT_CSV
+	for (i = 0; strcmp(csv[i], name); i++) {
+		p = strchr(p, ',');
+		if (!p)
+			return "";
+		p++;
+	}
+	len = strcspn(p, ",\n\r");
+#else
+	char key[32];
+
+	(void)csv;
+	(void)i;
+	snprintf(key, sizeof(key), "\"%s\":", name);
+	p = strstr(line, key);
+	if (!p)
+		return "";
+	p += strlen(key);
+	if (*p == '"')
+		p++;
+	len = strcspn(p, "\",}");
+#endif
+	memcpy(buf, p, len);
+	buf[len] = '\0';
+	return buf;
+}
+
+/* The last report line printed */
+static const char *last_line(void)
+{
+	const char *p = console + console_len;
+
+	if (p > console)
+		p -= 2;
+	while (p > console && p[-1] != '\r')
+		p--;
+	return p;
+}
+
+static struct perf_bench bench = { .name = "udp_server", .lat_name = "gap_us" };
+
+#ifndef OS_IS_FREERTOS
+/* Main loop iterations of 10 us, a third of them busy */
+static void run_loop(unsigned int iterations)
+{
+	unsigned int i;
+
+	for (i = 0; i < iterations; i++) {
+		fake_us += 10;
+		if (i % 6 == 0)
+			perf_bench_cpu_account(1);
+		else if (i % 6 == 3) {
+			perf_bench_add(&bench, 1000, 1);
+			perf_bench_cpu_account(0);
+		} else
+			perf_bench_cpu_account(0);
+	}
+}
+#else
+/* Idle task running for idle_us, then other tasks for busy_us */
+static void run_idle(unsigned int idle_us, unsigned int busy_us)
+{
+	unsigned int t;
+
+	vApplicationIdleHook();
+	for (t = 0; t < idle_us; t += 2) {
+		fake_us += 2;
+		vApplicationIdleHook();
+	}
+	fake_us += busy_us;
+}
+#endif
+
+static void test_report(void)
+{
+	char buf[64];
+	const char *line;
+	unsigned int i;
+
+	fake_us = 1000000;
+#ifndef OS_IS_FREERTOS
+	perf_bench_cpu_account(0);
+	run_loop(60);
+#else
+	run_idle(100, 50);
+#endif
+	/* Counters running before the start are not reported */
+	lwip_stats.udp.drop = 7;
+	lwip_stats.mib2.tcpretranssegs = 9;
+	perf_bench_start(&bench, 3);
+
+#ifndef OS_IS_FREERTOS
+	run_loop(600);
+	perf_bench_add(&bench, 500, 1);
+#else
+	for (i = 0; i < 4; i++) {
+		run_idle(300, 150);
+		perf_bench_add(&bench, 1125, 1);
+	}
+#endif
+	lwip_stats.udp.drop += 3;
+	lwip_stats.link.drop += 2;
+	lwip_stats.mib2.tcpretranssegs += 4;
+	bench.lost = 5;
+	for (i = 1; i <= 100; i++)
+		perf_hist_record(&bench.lat, i * 10);
+
+	perf_bench_report(&bench, "final");
+	line = last_line();
+#if PERF_BENCH_OUTPUT == PERF_BENCH_OUTPUT_CSV
+	CHECK(strncmp(console, "PERF,app,id,phase,", 18) == 0, "CSV header");
+#endif
+	CHECK(!strcmp(field(line, "app", buf), "udp_server"), "app");
+	CHECK(!strcmp(field(line, "id", buf), "3"), "id");
+	CHECK(!strcmp(field(line, "phase", buf), "final"), "phase");
+#ifndef OS_IS_FREERTOS
+	CHECK(!strcmp(field(line, "elapsed_us", buf), "6000"), "elapsed_us");
+	CHECK(!strcmp(field(line, "bytes", buf), "100500"), "bytes");
+	CHECK(!strcmp(field(line, "packets", buf), "101"), "packets");
+#else
+	CHECK(!strcmp(field(line, "elapsed_us", buf), "1800"), "elapsed_us");
+	CHECK(!strcmp(field(line, "bytes", buf), "4500"), "bytes");
+	CHECK(!strcmp(field(line, "packets", buf), "4"), "packets");
+#endif
+	CHECK(!strcmp(field(line, "lost", buf), "5"), "lost");
+	CHECK(!strcmp(field(line, "drops", buf), "5"), "drops");
+	CHECK(!strcmp(field(line, "rexmit", buf), "4"), "rexmit");
+	/* One in three iterations or a third of the time busy */
+	CHECK(!strcmp(field(line, "cpu_pct", buf), "33.3"), "cpu_pct");
+	CHECK(!strcmp(field(line, "metric", buf), "gap_us"), "metric");
+	CHECK(!strcmp(field(line, "count", buf), "100"), "count");
+	CHECK(!strcmp(field(line, "min", buf), "10"), "min");
+	/* Bucket upper bounds of 500 and 900 */
+	CHECK(!strcmp(field(line, "p50", buf), "511"), "p50");
+	CHECK(!strcmp(field(line, "p90", buf), "927"), "p90");
+	CHECK(!strcmp(field(line, "max", buf), "1000"), "max");
+
+	/* A fully busy and a fully idle period */
+	perf_bench_start(&bench, 4);
+#ifndef OS_IS_FREERTOS
+	for (i = 0; i < 50; i++) {
+		fake_us += 7;
+		perf_bench_cpu_account(1);
+	}
+#else
+	fake_us += 700;
+#endif
+	perf_bench_report(&bench, "busy");
+	CHECK(!strcmp(field(last_line(), "cpu_pct", buf), "100.0"),
+	      "fully busy");
+	perf_bench_start(&bench, 5);
+#ifndef OS_IS_FREERTOS
+	for (i = 0; i < 50; i++) {
+		fake_us += 7;
+		perf_bench_cpu_account(0);
+	}
+#else
+	run_idle(700, 0);
+#endif
+	perf_bench_report(&bench, "idle");
+	CHECK(!strcmp(field(last_line(), "cpu_pct", buf), "0.0"),
+	      "fully idle");
+
+	/* Nothing elapsed at all */
+	perf_bench_start(&bench, 6);
+	perf_bench_report(&bench, "empty");
+	CHECK(!strcmp(field(last_line(), "cpu_pct", buf), "0.0"),
+	      "empty period");
+
+#if PERF_BENCH_OUTPUT == PERF_BENCH_OUTPUT_CSV
+	CHECK(strstr(console + 1, "PERF,app,") == NULL, "CSV header repeated");
+#endif
+#ifdef OS_IS_FREERTOS
+	CHECK(critical_count > 0 && critical_nesting == 0,
+	      "idle accounting not in critical sections");
+#endif
+}
+
+int main(void)
+{
+	test_hist_index();
+	test_percentile();
+	test_report();
+
+	printf("%s", console);
+	printf("%s (%u failures)\n", failures ? "FAILED" : "PASSED", failures);
+	return failures ? 1 : 0;
+}
@@ -1,4 +1,6 @@
 set use_softeth_on_zynq 0
+# perf_bench.c/.h are shared by the lwIP perf applications
+set perf_common_dir [file join [file dirname [file normalize [info script]]] .. .. lwip_perf_common src]
 proc swapp_get_name {} {
     return "lwIP TCP Perf Client";
 }
@@ -262,6 +264,16 @@ proc generate_timer_config { fp } {
 # the correct source files
 proc swapp_generate {} {
     global use_softeth_on_zynq
+    global perf_common_dir
+
+    foreach entry {perf_bench.c perf_bench.h} {
+        set src [file join $perf_common_dir $entry]
+        if { ![file exists $src] } {
+            error "$src required by the lwIP perf applications is missing."
+        }
+        file copy -force $src "."
+    }
+
     # cleanup this file for writing
     set fid [open "platform_config.h" "w+"];
     puts $fid "#ifndef __PLATFORM_CONFIG_H_";
@@ -34,6 +34,18 @@ static struct tcp_pcb *c_pcb;
 static char send_buf[TCP_SEND_BUFSIZE];
 static struct perf_stats client;
 
+/* Latency histogram records the time from tcp_write() of a send buffer
+ * until its last byte is acknowledged, in us
+ */
+#define ACK_TRACK_ENTRIES 64
+static struct perf_bench bench = { "tcp_client", "ack_us" };
+static struct {
+	u32_t end;
+	u64_t stamp_us;
+} ack_track[ACK_TRACK_ENTRIES];
+static u32_t ack_head, ack_tail;
+static u32_t tx_offset, acked_offset;
+
 void print_app_header()
 {
 #if LWIP_IPV6==1
@@ -131,6 +143,37 @@ static void tcp_conn_report(u64_t diff,
 
 	if (report_type == INTER_REPORT)
 		client.i_report.last_report_time += duration;
+
+	perf_bench_report(&bench, (report_type == INTER_REPORT) ? "interim" :
+			(report_type == TCP_ABORTED_REMOTE) ? "aborted" : "final");
+}
+
+/** Remember when a send buffer was queued, skipped if the ring is full */
+static void ack_track_push(void)
+{
+	tx_offset += TCP_SEND_BUFSIZE;
+	if (ack_tail - ack_head < ACK_TRACK_ENTRIES) {
+		ack_track[ack_tail % ACK_TRACK_ENTRIES].end = tx_offset;
+		ack_track[ack_tail % ACK_TRACK_ENTRIES].stamp_us =
+			perf_bench_time_us();
+		ack_tail++;
+	}
+}
+
+/** Record the latency of every send buffer covered by newly acked bytes */
+static void ack_track_pop(u16_t len)
+{
+	u64_t now_us = perf_bench_time_us();
+
+	acked_offset += len;
+	while (ack_head != ack_tail) {
+		u32_t i = ack_head % ACK_TRACK_ENTRIES;
+
+		if ((s32_t)(ack_track[i].end - acked_offset) > 0)
+			break;
+		perf_hist_record(&bench.lat, now_us - ack_track[i].stamp_us);
+		ack_head++;
+	}
 }
 
 /** Close a tcp session */
@@ -194,6 +237,8 @@ static err_t tcp_send_perf_traffic(void)
 		}
 		client.total_bytes += TCP_SEND_BUFSIZE;
 		client.i_report.total_bytes += TCP_SEND_BUFSIZE;
+		ack_track_push();
+		perf_bench_add(&bench, TCP_SEND_BUFSIZE, 1);
 	}
 
 	if (client.end_time || client.i_report.report_interval_time) {
@@ -232,6 +277,7 @@ static err_t tcp_send_perf_traffic(void)
 /** TCP sent callback, try to send more data */
 static err_t tcp_client_sent(void *arg, struct tcp_pcb *tpcb, u16_t len)
 {
+	ack_track_pop(len);
 	return tcp_send_perf_traffic();
 }
 
@@ -257,6 +303,10 @@ static err_t tcp_client_connected(void *arg, struct tcp_pcb *tpcb, err_t err)
 	client.i_report.start_time = 0;
 	client.i_report.total_bytes = 0;
 
+	perf_bench_start(&bench, client.client_id);
+	ack_head = ack_tail = 0;
+	tx_offset = acked_offset = 0;
+
 	print_tcp_conn_stats();
 
 	/* set callback values & functions */
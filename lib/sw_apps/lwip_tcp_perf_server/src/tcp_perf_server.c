@@ -33,6 +33,9 @@
 extern struct netif server_netif;
 static struct tcp_pcb *c_pcb;
 static struct perf_stats server;
+/* Latency histogram records the gap between received segments in us */
+static struct perf_bench bench = { "tcp_server", "gap_us" };
+static u64_t last_rx_us;
 
 void print_app_header(void)
 {
@@ -131,6 +134,9 @@ static void tcp_conn_report(u64_t diff,
 
 	if (report_type == INTER_REPORT)
 		server.i_report.last_report_time += duration;
+
+	perf_bench_report(&bench, (report_type == INTER_REPORT) ? "interim" :
+			(report_type == TCP_ABORTED_REMOTE) ? "aborted" : "final");
 }
 
 /** Close a tcp session */
@@ -166,6 +172,8 @@ static void tcp_server_err(void *arg, err_t err)
 static err_t tcp_recv_perf_traffic(void *arg, struct tcp_pcb *tpcb,
 		struct pbuf *p, err_t err)
 {
+	u64_t now_us;
+
 	if (p == NULL) {
 		u64_t now = get_time_ms();
 		u64_t diff_ms = now - server.start_time;
@@ -178,6 +186,13 @@ static err_t tcp_recv_perf_traffic(void *arg, struct tcp_pcb *tpcb,
 	/* Record total bytes for final report */
 	server.total_bytes += p->tot_len;
 
+	/* Record segment gap for the benchmark report */
+	now_us = perf_bench_time_us();
+	if (last_rx_us)
+		perf_hist_record(&bench.lat, now_us - last_rx_us);
+	last_rx_us = now_us;
+	perf_bench_add(&bench, p->tot_len, pbuf_clen(p));
+
 	if (server.i_report.report_interval_time) {
 		u64_t now = get_time_ms();
 		/* Record total bytes for interim report */
@@ -225,6 +240,9 @@ static err_t tcp_server_accept(void *arg, struct tcp_pcb *newpcb, err_t err)
 	server.i_report.start_time = 0;
 	server.i_report.total_bytes = 0;
 
+	perf_bench_start(&bench, server.client_id);
+	last_rx_us = 0;
+
 	print_tcp_conn_stats();
 
 	/* setup callbacks for tcp rx connection */
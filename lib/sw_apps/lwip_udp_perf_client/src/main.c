@@ -31,6 +31,7 @@
 #include "netif/xadapter.h"
 #include "platform.h"
 #include "platform_config.h"
+#include "perf_bench.h"
 #include "lwipopts.h"
 #include "xil_printf.h"
 #include "sleep.h"
@@ -193,7 +194,7 @@ int main(void)
 			tcp_slowtmr();
 			TcpSlowTmrFlag = 0;
 		}
-		xemacif_input(netif);
+		perf_bench_cpu_account(xemacif_input(netif));
 		transfer_data();
 	}
 
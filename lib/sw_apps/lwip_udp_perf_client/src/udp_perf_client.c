@@ -34,6 +34,10 @@ extern struct netif server_netif;
 static struct udp_pcb *pcb[NUM_OF_PARALLEL_CLIENTS];
 static struct perf_stats client;
 static char send_buf[UDP_SEND_BUFSIZE];
+/* Latency histogram records the time spent in udp_send() in us, lost
+ * counts failed sends and pbuf allocations
+ */
+static struct perf_bench bench = { "udp_client", "send_us" };
 #define FINISH	1
 /* Report interval time in ms */
 #define REPORT_INTERVAL_TIME (INTERIM_REPORT_INTERVAL * 1000)
@@ -124,6 +128,9 @@ static void udp_conn_report(u64_t diff,
 	else
 		xil_printf("[%3d] sent %llu datagrams\n\r",
 				client.client_id, client.cnt_datagrams);
+
+	perf_bench_report(&bench,
+			(report_type == INTER_REPORT) ? "interim" : "final");
 }
 
 
@@ -141,6 +148,8 @@ static void reset_stats(void)
 	client.i_report.start_time = 0;
 	client.i_report.total_bytes = 0;
 	client.i_report.last_report_time = 0;
+
+	perf_bench_start(&bench, client.client_id);
 }
 
 static void udp_packet_send(u8_t finished)
@@ -151,11 +160,13 @@ static void udp_packet_send(u8_t finished)
 	u8_t retries = MAX_SEND_RETRY;
 	struct pbuf *packet;
 	err_t err;
+	u64_t send_us;
 
 	for (i = 0; i < NUM_OF_PARALLEL_CLIENTS; i++) {
 
 		packet = pbuf_alloc(PBUF_TRANSPORT, UDP_SEND_BUFSIZE, PBUF_POOL);
 		if (!packet) {
+			bench.lost++;
 			xil_printf("error allocating pbuf to send\r\n");
 			return;
 		} else {
@@ -170,8 +181,12 @@ static void udp_packet_send(u8_t finished)
 		payload[0] = htonl(packet_id);
 
 		while (retries) {
+			send_us = perf_bench_time_us();
 			err = udp_send(pcb[i], packet);
+			perf_hist_record(&bench.lat,
+					perf_bench_time_us() - send_us);
 			if (err != ERR_OK) {
+				bench.lost++;
 				xil_printf("Error on udp_send: %d\r\n", err);
 				retries--;
 				usleep(100);
@@ -179,6 +194,7 @@ static void udp_packet_send(u8_t finished)
 				client.total_bytes += UDP_SEND_BUFSIZE;
 				client.cnt_datagrams++;
 				client.i_report.total_bytes += UDP_SEND_BUFSIZE;
+				perf_bench_add(&bench, UDP_SEND_BUFSIZE, 1);
 				break;
 			}
 		}
@@ -37,6 +37,7 @@
 #include "lwip/inet.h"
 #include "xil_printf.h"
 #include "platform.h"
+#include "perf_bench.h"
 #include <sleep.h>
 
 /* used as indices into kLabel[] */
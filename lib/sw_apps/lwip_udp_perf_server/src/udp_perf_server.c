@@ -33,6 +33,9 @@
 extern struct netif server_netif;
 static struct udp_pcb *pcb;
 static struct perf_stats server;
+/* Latency histogram records the gap between datagrams in us */
+static struct perf_bench bench = { "udp_server", "gap_us" };
+static u64_t last_rx_us;
 /* Report interval in ms */
 #define REPORT_INTERVAL_TIME (INTERIM_REPORT_INTERVAL * 1000)
 
@@ -135,6 +138,9 @@ static void udp_conn_report(u64_t diff,
 				server.client_id, time,
 				cnt_out_of_order_datagrams);
 	}
+
+	perf_bench_report(&bench,
+			(report_type == INTER_REPORT) ? "interim" : "final");
 }
 
 
@@ -156,6 +162,9 @@ static void reset_stats(void)
 	server.i_report.cnt_datagrams = 0;
 	server.i_report.cnt_dropped_datagrams = 0;
 	server.i_report.last_report_time = 0;
+
+	perf_bench_start(&bench, server.client_id);
+	last_rx_us = 0;
 }
 
 /** Receive data on a udp session */
@@ -165,6 +174,7 @@ static void udp_recv_perf_traffic(void *arg, struct udp_pcb *tpcb,
 	static u8_t first = 1;
 	u32_t drop_datagrams = 0;
 	s32_t recv_id;
+	u64_t now_us;
 
 	/* first, check if the datagram is received in order */
 #ifdef __MICROBLAZE__
@@ -230,6 +240,14 @@ static void udp_recv_perf_traffic(void *arg, struct udp_pcb *tpcb,
 	/* Record total bytes for final report */
 	server.total_bytes += p->tot_len;
 
+	/* Record datagram gap and loss for the benchmark report */
+	now_us = perf_bench_time_us();
+	if (last_rx_us)
+		perf_hist_record(&bench.lat, now_us - last_rx_us);
+	last_rx_us = now_us;
+	bench.lost += drop_datagrams;
+	perf_bench_add(&bench, p->tot_len, 1);
+
 	if (REPORT_INTERVAL_TIME) {
 		u64_t now = get_time_ms();
 
@@ -274,6 +274,15 @@ extern "C" {
 
 #define XMT_MAX_WR_VREF				0x32U
 
+/* Memtest Engine Configuration */
+#define XMT_MEMTEST_MAX_SEGMENTS		2U
+#define XMT_MEMTEST_PATTERN_WORDS		64U
+#define XMT_MEMTEST_MAX_ERR_LOG			10U
+
+#define XMT_MEMTEST_GEN_ADDR			0U
+#define XMT_MEMTEST_GEN_TABLE			1U
+#define XMT_MEMTEST_GEN_RANDOM			2U
+
 /**************************** Type Definitions *******************************/
 
 /***************** Macros (Inline Functions) Definitions *********************/
@@ -360,6 +369,31 @@ typedef struct {
 	u32 DdrType;
 } XMt_CfgData;
 
+/* Memtest Pattern Generator, prepared once per test mode */
+typedef struct {
+	u32 Type;
+	s64 RandVal;
+	u64 Table[XMT_MEMTEST_PATTERN_WORDS] __attribute__ ((aligned(64)));
+} XMt_MemtestGen;
+
+/* Memtest Error Log Entry */
+typedef struct {
+	u64 Addr;
+	u64 Data;
+	u64 RefVal;
+} XMt_MemtestErr;
+
+/* Memtest Segment, a contiguous address range of the test */
+typedef struct {
+	u64 Addr;
+	u64 Index;
+	u64 Words;
+	u32 ErrCnt;
+	u32 LaneErrCnt[8];
+	u32 NumErrLog;
+	XMt_MemtestErr ErrLog[XMT_MEMTEST_MAX_ERR_LOG];
+} XMt_MemtestSeg;
+
 /************************** Function Prototypes ******************************/
 
 void XMt_SelectRank(s32 Rank);
@@ -397,6 +431,13 @@ void XMt_ResetWrVref(XMt_CfgData *XMtPtr);
 void XMt_Print2DEyeResults(XMt_CfgData *XMtPtr, u32 VRef);
 u32 XMt_GetVRefAutoMin(XMt_CfgData *XMtPtr);
 u32 XMt_GetVRefAutoMax(XMt_CfgData *XMtPtr);
+void XMt_MemtestInitGen(XMt_MemtestGen *Gen, s32 ModeVal, const u64 *Pattern,
+			s64 RandVal);
+u64 XMt_MemtestRefVal(const XMt_MemtestGen *Gen, u64 Addr, u64 Index);
+void XMt_MemtestFill(const XMt_MemtestGen *Gen, u64 *Buf,
+		     const XMt_MemtestSeg *Seg);
+u32 XMt_MemtestCheck(const XMt_MemtestGen *Gen, const u64 *Buf,
+		     u32 Lanes, XMt_MemtestSeg *Seg);
 
 #ifdef __cplusplus
 }
@@ -309,44 +309,14 @@ static double XMt_CalcTime(XTime tCur)
 	return tPerfS;
 }
 
-/*****************************************************************************/
-/**
- * This function creates a reference value which can be used to write to the
- * address or can be used to compare the data read from the address.
- *
- * @param Addr is the Address for which the RefVal is to be created
- * @param Index is the number indicating the byte number
- * @param ModeVal is the Mode number for the test
- * @param Pattern is the Test Pattern to be written
- *
- * @return Reference Value
- *
- * @note none
- *****************************************************************************/
-static u64 XMt_GetRefVal(u64 Addr, u64 Index, s32 ModeVal, u64 *Pattern, s64 RandVal)
-{
-	u64 RefVal;
-	u64 Mod128;
-
-	if (ModeVal == 0U) {
-		RefVal = ((((Addr + 4) << 32) | Addr) & U64_MASK);
-	} else if (ModeVal <= 8U) {
-		RefVal = (u64)Pattern[(Index % 32) / 8];
-	} else if (ModeVal <= 10U) {
-		Mod128 = (Index >> 2) & 0x07f;
-		RefVal = (u64)Pattern[Mod128] & U64_MASK;
-	} else {
-		/* Create a Random Value */
-		RefVal = XMT_RANDOM_VALUE(RandVal * Index) & U64_MASK;
-	}
-
-	return RefVal;
-}
-
 /*****************************************************************************/
 /**
  * This function does memory Read/Write test
  *
+ * The tested range is split at the end of the lower DDR region into at most
+ * two segments, each written and checked by the memtest engine. The results
+ * of the segments are merged in address order afterwards.
+ *
  * @param XMtPtr is the pointer to the Memtest Data Structure
  * @param StartVal is the starting Address
  * @param SizeVal is the Size (MegaBytes) of the memory to be Tested
@@ -360,18 +330,21 @@ static u64 XMt_GetRefVal(u64 Addr, u64 Index, s32 ModeVal, u64 *Pattern, s64 Ran
 static void XMt_Memtest(XMt_CfgData *XMtPtr, u32 StartVal, u32 SizeVal,
 			s32 ModeVal, u64 *Pattern)
 {
-	u64 Index;
+	static XMt_MemtestGen Gen;
+	static XMt_MemtestSeg Seg[XMT_MEMTEST_MAX_SEGMENTS];
 	u64 Start;
 	u64 Size;
 	u64 Addr;
-	u64 RefVal;
-	u64 Data;
-	u64 UpperDdrOffset;
+	u64 SegSize;
 	s32 MemErr;
 	s32 LocalErrCnt[8];
+	u32 NumSegs;
+	u32 SegIdx;
+	u32 LogIdx;
 	u8 Cnt;
 	XTime tCur1;
 	float TestTime;
+	XMt_MemtestErr *Err;
 	s64 RandVal = rand();
 
 	MemErr = 0U;
@@ -382,22 +355,35 @@ static void XMt_Memtest(XMt_CfgData *XMtPtr, u32 StartVal, u32 SizeVal,
 
 	memset(LocalErrCnt, 0U, 8*(sizeof(s32)));
 
-	/* Get the Starting Time value */
-	XTime_GetTime(&tCur1);
+	XMt_MemtestInitGen(&Gen, ModeVal, Pattern, RandVal);
 
-	UpperDdrOffset = 0U;
+	/* Split the range at the end of DDR_0 */
 	Addr = XMT_DDR_BASEADDR + Start;
-	for (Index = 0U; Index < Size; Index += 8U) {
-		if (Addr < (XMT_DDR_0_HIGHADDR + 1U) - 8U) {
-			Addr = Start + Index;
-		} else {
-			Addr = XMT_DDR_1_BASEADDR + UpperDdrOffset;
-			UpperDdrOffset = UpperDdrOffset + 8;
-		}
+	SegSize = Size;
+#if (defined(XPAR_PSU_DDR_0_S_AXI_BASEADDR))
+	if ((Addr < (XMT_DDR_0_HIGHADDR + 1U)) &&
+	    ((Addr + Size) > (XMT_DDR_0_HIGHADDR + 1U))) {
+		SegSize = XMT_DDR_0_HIGHADDR + 1U - Addr;
+	}
+#endif
+	memset(Seg, 0, sizeof(Seg));
+	Seg[0].Addr = Addr;
+	Seg[0].Index = 0U;
+	Seg[0].Words = SegSize >> 3;
+	NumSegs = 1U;
+	if (SegSize < Size) {
+		Seg[1].Addr = XMT_DDR_1_BASEADDR;
+		Seg[1].Index = SegSize;
+		Seg[1].Words = (Size - SegSize) >> 3;
+		NumSegs = 2U;
+	}
 
-		/* Create a value to be written to the memory */
-		RefVal = XMt_GetRefVal(Addr, Index, ModeVal, Pattern, RandVal);
-		Xil_Out64(Addr, RefVal);
+	/* Get the Starting Time value */
+	XTime_GetTime(&tCur1);
+
+	for (SegIdx = 0U; SegIdx < NumSegs; SegIdx++) {
+		XMt_MemtestFill(&Gen, (u64 *)(UINTPTR)Seg[SegIdx].Addr,
+				&Seg[SegIdx]);
 	}
 
 	if (XMtPtr->DCacheEnable != 0U) {
@@ -413,44 +399,35 @@ static void XMt_Memtest(XMt_CfgData *XMtPtr, u32 StartVal, u32 SizeVal,
 #endif
 	}
 
-	UpperDdrOffset = 0U;
-	Addr = XMT_DDR_BASEADDR + Start;
-	for (Index = 0U; Index < Size; Index += 8U) {
-		if (Addr < (XMT_DDR_0_HIGHADDR + 1U) - 8U) {
-			Addr = Start + Index;
-		} else {
-			Addr = XMT_DDR_1_BASEADDR + UpperDdrOffset;
-			UpperDdrOffset = UpperDdrOffset + 8;
+	for (SegIdx = 0U; SegIdx < NumSegs; SegIdx++) {
+		(void)XMt_MemtestCheck(&Gen,
+				       (const u64 *)(UINTPTR)Seg[SegIdx].Addr,
+				       XMtPtr->DdrConfigLanes, &Seg[SegIdx]);
+	}
+
+	/* Get the Ending Time value and calculate the total time*/
+	TestTime = XMt_CalcTime(tCur1);
+
+	/* Merge the Segment results in address order */
+	for (SegIdx = 0U; SegIdx < NumSegs; SegIdx++) {
+		for (Cnt = 0U; Cnt < XMtPtr->DdrConfigLanes; Cnt++) {
+			LocalErrCnt[Cnt] += Seg[SegIdx].LaneErrCnt[Cnt];
 		}
 
-		/* Create a value to be compared with read value from memory */
-		RefVal = XMt_GetRefVal(Addr, Index, ModeVal, Pattern, RandVal);
-		Data = Xil_In64(Addr);
-
-		/* Compare the data got from the memory */
-		if (Data != RefVal) {
-			/* Increment the Error Address count */
-			MemErr++;
-			for (Cnt = 0U; Cnt < XMtPtr->DdrConfigLanes; Cnt++) {
-				if ((((Data ^ RefVal) >>
-						(Cnt * 8)) & 0xff) != 0U) {
-					/* Update per Lane Error count */
-					LocalErrCnt[Cnt]++;
-				}
-			}
-			/* Print the Verbose Information */
-			if ((Verbose == 1U) && (MemErr <= 10)) {
+		/* Print the Verbose Information */
+		for (LogIdx = 0U; LogIdx < Seg[SegIdx].NumErrLog; LogIdx++) {
+			if ((Verbose == 1U) && (((u32)MemErr + LogIdx) < 10U)) {
+				Err = &Seg[SegIdx].ErrLog[LogIdx];
 				xil_printf("Memtest_0 ERROR: "
 				"Addr=0x%X rd/RefVal/xor ="
 				"0x%016llx 0x%016llx 0x%016llx \r\n",
-				Addr, Data, RefVal, Data ^ RefVal);
+				Err->Addr, Err->Data, Err->RefVal,
+				Err->Data ^ Err->RefVal);
 			}
 		}
+		MemErr += Seg[SegIdx].ErrCnt;
 	}
 
-	/* Get the Ending Time value and calculate the total time*/
-	TestTime = XMt_CalcTime(tCur1);
-
 	if (XMtPtr->DdrConfigLanes == XMT_DDR_CONFIG_4_LANE) {
 		/* Print the Memory Test Report */
 		xil_printf("\rMT0(%2d)  | %6d | %4d, %4d, %4d, %4d  | %d.%06d\r\n",
@@ -0,0 +1,399 @@
+/******************************************************************************
+* Copyright (c) 2018 - 2020 Xilinx, Inc.  All rights reserved.
+* SPDX-License-Identifier: MIT
+ ******************************************************************************/
+
+
+/*****************************************************************************/
+/**
+ *
+ * @file xmt_memtest.c
+ *
+ * This file contains the pattern generators and checkers used by the DRAM
+ * Memory Tests. The reference value of every mode is prepared once per test
+ * so that the write and compare loops run without any per word modulo or
+ * branch on the mode. Data is moved and compared 8 words at a time, using
+ * NEON registers when the compiler targets them.
+ *
+ * These functions only work on the buffer pointers handed to them and do not
+ * touch any hardware register, so the same code can be built and checked on
+ * a host against a plain memory buffer.
+ *
+ * @note
+ *
+ ******************************************************************************/
+
+/***************************** Include Files *********************************/
+
+#include <string.h>
+#include "xmt_common.h"
+#ifdef __ARM_NEON
+#include <arm_neon.h>
+#endif
+
+/************************** Constant Definitions *****************************/
+
+#define XMT_MEMTEST_BLOCK_WORDS		8U
+#define XMT_MEMTEST_TABLE_MASK		(XMT_MEMTEST_PATTERN_WORDS - 1U)
+#define XMT_MEMTEST_MAX_MODE_TABLE	10
+
+/**************************** Type Definitions *******************************/
+
+/***************** Macros (Inline Functions) Definitions *********************/
+
+/************************** Function Prototypes ******************************/
+
+/************************** Variable Definitions *****************************/
+
+/*****************************************************************************/
+/**
+ * This function prepares the pattern generator for a test mode. Modes 1 to 8
+ * repeat a 4 word pattern and modes 9 and 10 use every other entry of a 128
+ * word pattern, so both are expanded into one 64 word table indexed by the
+ * word number.
+ *
+ * @param Gen is the pointer to the Pattern Generator to be prepared
+ * @param ModeVal is the Mode number for the test
+ * @param Pattern is the Test Pattern to be written
+ * @param RandVal is the seed used by the random modes
+ *
+ * @return none
+ *
+ * @note none
+ *****************************************************************************/
+void XMt_MemtestInitGen(XMt_MemtestGen *Gen, s32 ModeVal, const u64 *Pattern,
+			s64 RandVal)
+{
+	u32 Index;
+
+	Gen->RandVal = RandVal;
+
+	if (ModeVal == 0) {
+		Gen->Type = XMT_MEMTEST_GEN_ADDR;
+	} else if (ModeVal <= XMT_MEMTEST_MAX_MODE_TABLE) {
+		Gen->Type = XMT_MEMTEST_GEN_TABLE;
+		for (Index = 0U; Index < XMT_MEMTEST_PATTERN_WORDS; Index++) {
+			if (ModeVal <= 8) {
+				Gen->Table[Index] = Pattern[Index & 0x3U];
+			} else {
+				Gen->Table[Index] = Pattern[(Index << 1) & 0x7FU];
+			}
+		}
+	} else {
+		Gen->Type = XMT_MEMTEST_GEN_RANDOM;
+	}
+}
+
+/*****************************************************************************/
+/**
+ * This function creates the reference value of a single word. It is the
+ * scalar definition of the patterns which the block generators below follow.
+ *
+ * @param Gen is the pointer to the Pattern Generator
+ * @param Addr is the Address for which the RefVal is to be created
+ * @param Index is the byte offset of the word from the start of the test
+ *
+ * @return Reference Value
+ *
+ * @note none
+ *****************************************************************************/
+u64 XMt_MemtestRefVal(const XMt_MemtestGen *Gen, u64 Addr, u64 Index)
+{
+	u64 RefVal;
+	u64 Seed;
+
+	if (Gen->Type == XMT_MEMTEST_GEN_ADDR) {
+		RefVal = (((Addr + 4U) << 32) | Addr) & U64_MASK;
+	} else if (Gen->Type == XMT_MEMTEST_GEN_TABLE) {
+		RefVal = Gen->Table[(Index >> 3) & XMT_MEMTEST_TABLE_MASK];
+	} else {
+		Seed = (u64)Gen->RandVal * Index;
+		RefVal = XMT_RANDOM_VALUE(Seed) & U64_MASK;
+	}
+
+	return RefVal;
+}
+
+/*****************************************************************************/
+/**
+ * This function creates the reference values of a block of 8 words. For the
+ * table modes the block is read straight out of the rotated table.
+ *
+ * @param Gen is the pointer to the Pattern Generator
+ * @param Rot is the table rotated to the first word of the range
+ * @param Addr is the Address of the first word of the block
+ * @param Index is the byte offset of the first word of the block
+ * @param Word is the word offset of the block in the range
+ * @param Exp is the scratch block for the computed values
+ *
+ * @return Pointer to the 8 reference values
+ *
+ * @note none
+ *****************************************************************************/
+static const u64 *XMt_MemtestExpBlock(const XMt_MemtestGen *Gen,
+				      const u64 *Rot, u64 Addr, u64 Index,
+				      u64 Word, u64 *Exp)
+{
+	u64 Step;
+	u64 Seed;
+	u32 Cnt;
+
+	if (Gen->Type == XMT_MEMTEST_GEN_TABLE) {
+		return &Rot[Word & XMT_MEMTEST_TABLE_MASK];
+	}
+
+	if (Gen->Type == XMT_MEMTEST_GEN_ADDR) {
+		for (Cnt = 0U; Cnt < XMT_MEMTEST_BLOCK_WORDS; Cnt++) {
+			Exp[Cnt] = ((Addr + 4U) << 32) | Addr;
+			Addr += 8U;
+		}
+	} else {
+		Seed = (u64)Gen->RandVal * Index;
+		Step = (u64)Gen->RandVal * 8U;
+		for (Cnt = 0U; Cnt < XMT_MEMTEST_BLOCK_WORDS; Cnt++) {
+			Exp[Cnt] = XMT_RANDOM_VALUE(Seed);
+			Seed += Step;
+		}
+	}
+
+	return Exp;
+}
+
+/*****************************************************************************/
+/**
+ * This function rotates the pattern table so that entry 0 belongs to the
+ * first word of a range.
+ *
+ * @param Gen is the pointer to the Pattern Generator
+ * @param Index is the byte offset of the first word of the range
+ * @param Rot is the destination table
+ *
+ * @return none
+ *
+ * @note none
+ *****************************************************************************/
+static void XMt_MemtestRotate(const XMt_MemtestGen *Gen, u64 Index, u64 *Rot)
+{
+	u32 Cnt;
+	u32 First = (u32)((Index >> 3) & XMT_MEMTEST_TABLE_MASK);
+
+	for (Cnt = 0U; Cnt < XMT_MEMTEST_PATTERN_WORDS; Cnt++) {
+		Rot[Cnt] = Gen->Table[(First + Cnt) & XMT_MEMTEST_TABLE_MASK];
+	}
+}
+
+/*****************************************************************************/
+/**
+ * This function writes a block of 8 words.
+ *
+ * @param Dst is the destination in memory under test
+ * @param Src is the block of reference values
+ *
+ * @return none
+ *
+ * @note none
+ *****************************************************************************/
+static INLINE void XMt_MemtestStoreBlock(u64 *Dst, const u64 *Src)
+{
+#ifdef __ARM_NEON
+	vst1q_u64(&Dst[0], vld1q_u64(&Src[0]));
+	vst1q_u64(&Dst[2], vld1q_u64(&Src[2]));
+	vst1q_u64(&Dst[4], vld1q_u64(&Src[4]));
+	vst1q_u64(&Dst[6], vld1q_u64(&Src[6]));
+#else
+	volatile u64 *Ptr = Dst;
+	u32 Cnt;
+
+	for (Cnt = 0U; Cnt < XMT_MEMTEST_BLOCK_WORDS; Cnt++) {
+		Ptr[Cnt] = Src[Cnt];
+	}
+#endif
+}
+
+/*****************************************************************************/
+/**
+ * This function reads a block of 8 words once, keeps a copy of it and
+ * compares it with the reference values, folding all the differences into
+ * one word. A failing block is accounted from the copy, so the reported data
+ * is the one that failed the comparison even if the memory returns another
+ * value when read again.
+ *
+ * @param Src is the block in memory under test
+ * @param Exp is the block of reference values
+ * @param Data is the copy of the block read from memory
+ *
+ * @return 0 if the whole block matches, non zero otherwise
+ *
+ * @note none
+ *****************************************************************************/
+static INLINE u64 XMt_MemtestReadBlock(const u64 *Src, const u64 *Exp,
+				       u64 *Data)
+{
+#ifdef __ARM_NEON
+	uint64x2_t Val;
+	uint64x2_t Diff;
+
+	Val = vld1q_u64(&Src[0]);
+	vst1q_u64(&Data[0], Val);
+	Diff = veorq_u64(Val, vld1q_u64(&Exp[0]));
+	Val = vld1q_u64(&Src[2]);
+	vst1q_u64(&Data[2], Val);
+	Diff = vorrq_u64(Diff, veorq_u64(Val, vld1q_u64(&Exp[2])));
+	Val = vld1q_u64(&Src[4]);
+	vst1q_u64(&Data[4], Val);
+	Diff = vorrq_u64(Diff, veorq_u64(Val, vld1q_u64(&Exp[4])));
+	Val = vld1q_u64(&Src[6]);
+	vst1q_u64(&Data[6], Val);
+	Diff = vorrq_u64(Diff, veorq_u64(Val, vld1q_u64(&Exp[6])));
+
+	return vgetq_lane_u64(Diff, 0) | vgetq_lane_u64(Diff, 1);
+#else
+	const volatile u64 *Ptr = Src;
+	u64 Diff = 0U;
+	u32 Cnt;
+
+	for (Cnt = 0U; Cnt < XMT_MEMTEST_BLOCK_WORDS; Cnt++) {
+		Data[Cnt] = Ptr[Cnt];
+		Diff |= Data[Cnt] ^ Exp[Cnt];
+	}
+
+	return Diff;
+#endif
+}
+
+/*****************************************************************************/
+/**
+ * This function accounts a mismatching word in the segment results.
+ *
+ * @param Seg is the pointer to the Segment being checked
+ * @param Lanes is the number of byte lanes of the DRAM bus
+ * @param Addr is the Address of the word
+ * @param Data is the value read from memory
+ * @param RefVal is the expected value
+ *
+ * @return none
+ *
+ * @note none
+ *****************************************************************************/
+static void XMt_MemtestRecordErr(XMt_MemtestSeg *Seg, u32 Lanes,
+				 u64 Addr, u64 Data, u64 RefVal)
+{
+	u64 Diff = Data ^ RefVal;
+	u32 Cnt;
+
+	Seg->ErrCnt++;
+	for (Cnt = 0U; Cnt < Lanes; Cnt++) {
+		if (((Diff >> (Cnt * 8U)) & 0xFFU) != 0U) {
+			Seg->LaneErrCnt[Cnt]++;
+		}
+	}
+
+	if (Seg->NumErrLog < XMT_MEMTEST_MAX_ERR_LOG) {
+		Seg->ErrLog[Seg->NumErrLog].Addr = Addr;
+		Seg->ErrLog[Seg->NumErrLog].Data = Data;
+		Seg->ErrLog[Seg->NumErrLog].RefVal = RefVal;
+		Seg->NumErrLog++;
+	}
+}
+
+/*****************************************************************************/
+/**
+ * This function writes the test pattern to the range of a segment.
+ *
+ * @param Gen is the pointer to the Pattern Generator
+ * @param Buf is the pointer through which the range is accessed
+ * @param Seg is the pointer to the Segment to be written
+ *
+ * @return none
+ *
+ * @note none
+ *****************************************************************************/
+void XMt_MemtestFill(const XMt_MemtestGen *Gen, u64 *Buf,
+		     const XMt_MemtestSeg *Seg)
+{
+	u64 Rot[XMT_MEMTEST_PATTERN_WORDS] __attribute__ ((aligned(64)));
+	u64 Exp[XMT_MEMTEST_BLOCK_WORDS];
+	const u64 *RefPtr;
+	u64 Word;
+	u64 Words = Seg->Words;
+
+	if (Gen->Type == XMT_MEMTEST_GEN_TABLE) {
+		XMt_MemtestRotate(Gen, Seg->Index, Rot);
+	}
+
+	for (Word = 0U; (Word + XMT_MEMTEST_BLOCK_WORDS) <= Words;
+	     Word += XMT_MEMTEST_BLOCK_WORDS) {
+		RefPtr = XMt_MemtestExpBlock(Gen, Rot, Seg->Addr + (Word << 3),
+					     Seg->Index + (Word << 3), Word, Exp);
+		XMt_MemtestStoreBlock(&Buf[Word], RefPtr);
+	}
+
+	for (; Word < Words; Word++) {
+		((volatile u64 *)Buf)[Word] = XMt_MemtestRefVal(Gen,
+				Seg->Addr + (Word << 3), Seg->Index + (Word << 3));
+	}
+}
+
+/*****************************************************************************/
+/**
+ * This function reads back the range of a segment and compares it with the
+ * test pattern. Every word is read once, and the error counters and log of
+ * the segment are updated with the value read for every word that does not
+ * match.
+ *
+ * @param Gen is the pointer to the Pattern Generator
+ * @param Buf is the pointer through which the range is accessed
+ * @param Lanes is the number of byte lanes of the DRAM bus
+ * @param Seg is the pointer to the Segment to be checked
+ *
+ * @return Number of mismatching words found in the segment
+ *
+ * @note none
+ *****************************************************************************/
+u32 XMt_MemtestCheck(const XMt_MemtestGen *Gen, const u64 *Buf,
+		     u32 Lanes, XMt_MemtestSeg *Seg)
+{
+	u64 Rot[XMT_MEMTEST_PATTERN_WORDS] __attribute__ ((aligned(64)));
+	u64 Exp[XMT_MEMTEST_BLOCK_WORDS];
+	u64 Blk[XMT_MEMTEST_BLOCK_WORDS] __attribute__ ((aligned(16)));
+	const u64 *RefPtr;
+	u64 Word;
+	u64 Data;
+	u64 RefVal;
+	u64 Words = Seg->Words;
+	u32 Cnt;
+
+	if (Gen->Type == XMT_MEMTEST_GEN_TABLE) {
+		XMt_MemtestRotate(Gen, Seg->Index, Rot);
+	}
+
+	for (Word = 0U; (Word + XMT_MEMTEST_BLOCK_WORDS) <= Words;
+	     Word += XMT_MEMTEST_BLOCK_WORDS) {
+		RefPtr = XMt_MemtestExpBlock(Gen, Rot, Seg->Addr + (Word << 3),
+					     Seg->Index + (Word << 3), Word, Exp);
+		if (XMt_MemtestReadBlock(&Buf[Word], RefPtr, Blk) == 0U) {
+			continue;
+		}
+
+		/* Only a failing block is walked word by word, from its copy */
+		for (Cnt = 0U; Cnt < XMT_MEMTEST_BLOCK_WORDS; Cnt++) {
+			if (Blk[Cnt] != RefPtr[Cnt]) {
+				XMt_MemtestRecordErr(Seg, Lanes,
+					Seg->Addr + ((Word + Cnt) << 3),
+					Blk[Cnt], RefPtr[Cnt]);
+			}
+		}
+	}
+
+	for (; Word < Words; Word++) {
+		RefVal = XMt_MemtestRefVal(Gen, Seg->Addr + (Word << 3),
+					   Seg->Index + (Word << 3));
+		Data = ((const volatile u64 *)Buf)[Word];
+		if (Data != RefVal) {
+			XMt_MemtestRecordErr(Seg, Lanes,
+					     Seg->Addr + (Word << 3), Data, RefVal);
+		}
+	}
+
+	return Seg->ErrCnt;
+}
@@ -0,0 +1,334 @@
+/******************************************************************************
+* Copyright (C) 2020 Xilinx, Inc.  All rights reserved.
+* SPDX-License-Identifier: MIT
+******************************************************************************/
+
+/*
+ * Host test of the memtest pattern generators and checkers in xmt_memtest.c.
+ *
+ * Every mode is written to a host buffer for ranges starting at different
+ * addresses and byte offsets, with lengths which are not a whole number of
+ * blocks, and each word is compared with XMt_GetRefVal of the original
+ * per word test loop. Corrupted words are then checked for the error count,
+ * the per lane counts of 64 and 32 bit buses and the error log.
+ *
+ * On x86-64 Linux the page holding a failing word is also made to return a
+ * different value on every read: the page is mapped without access, and
+ * each access is single stepped so that the word changes once it has been
+ * read. The checker must read the word once and log the failing value.
+ *
+ * Build and run on the host:
+ *   cc -Wall -O2 -I../src -I../../../bsp/standalone/src/common \
+ *      -I../../../bsp/standalone/src/arm/common \
+ *      -I../../../bsp/standalone/src/arm/ARMv8/64bit \
+ *      test_xmt_memtest.c -o test_xmt_memtest
+ *   ./test_xmt_memtest
+ */
+
+#define _GNU_SOURCE
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#if defined(__x86_64__) && defined(__linux__)
+#define FLAKY_MEMORY_MODEL
+#include <signal.h>
+#include <ucontext.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#endif
+
+#undef __linux__
+#include "xil_types.h"
+
+/* BSP headers which the engine does not use */
+#define XIL_PRINTF_H
+#define XIL_CACHE_H
+#define XIL_EXCEPTION_H
+#define XPSEUDO_ASM_H
+#define XDEBUG
+#define XTIME_H
+#define XIL_IO_H
+#define INLINE inline
+static u32 Xil_In32(UINTPTR Addr) { (void)Addr; return 0U; }
+
+#include "../src/xmt_memtest.c"
+
+#define MAX_WORDS	1029U
+#define NUM_MODES	13
+
+#define CHECK(cond, msg) \
+	do { \
+		if (!(cond)) { \
+			printf("FAIL: %s (line %d)\n", msg, __LINE__); \
+			Failures++; \
+		} \
+	} while (0)
+
+static unsigned int Failures;
+
+static u64 Buf[MAX_WORDS] __attribute__ ((aligned(64)));
+static u64 Pattern[128];
+
+/* Reference value of the per word test loop the engine replaced */
+static u64 XMt_GetRefVal(u64 Addr, u64 Index, s32 ModeVal, u64 *Pattern,
+			 s64 RandVal)
+{
+	u64 RefVal;
+	u64 Mod128;
+
+	if (ModeVal == 0U) {
+		RefVal = ((((Addr + 4) << 32) | Addr) & U64_MASK);
+	} else if (ModeVal <= 8U) {
+		RefVal = (u64)Pattern[(Index % 32) / 8];
+	} else if (ModeVal <= 10U) {
+		Mod128 = (Index >> 2) & 0x07f;
+		RefVal = (u64)Pattern[Mod128] & U64_MASK;
+	} else {
+		RefVal = XMT_RANDOM_VALUE(RandVal * Index) & U64_MASK;
+	}
+
+	return RefVal;
+}
+
+static void InitSeg(XMt_MemtestSeg *Seg, u64 Addr, u64 Index, u64 Words)
+{
+	memset(Seg, 0, sizeof(*Seg));
+	Seg->Addr = Addr;
+	Seg->Index = Index;
+	Seg->Words = Words;
+}
+
+static void TestPatterns(void)
+{
+	static const u64 Ranges[][3] = {
+		/* Addr, Index, Words */
+		{ 0x100000U, 0U, MAX_WORDS },
+		{ 0x7FFFFFF8U, 0x7FFFFFF8U, 7U },
+		{ 0x800000000U, 0x7FF00148U, 203U },
+		{ 0x800001000U, 0x18U, 64U },
+	};
+	XMt_MemtestGen Gen;
+	XMt_MemtestSeg Seg;
+	s64 RandVal = 0x2545F491;
+	unsigned int Wrong;
+	u32 Range;
+	u64 Word;
+	s32 Mode;
+	char Msg[64];
+
+	for (Mode = 0; Mode < NUM_MODES; Mode++) {
+		XMt_MemtestInitGen(&Gen, Mode, Pattern, RandVal);
+		for (Range = 0U; Range < sizeof(Ranges) / sizeof(Ranges[0]);
+		     Range++) {
+			InitSeg(&Seg, Ranges[Range][0], Ranges[Range][1],
+				Ranges[Range][2]);
+			memset(Buf, 0xA5, sizeof(Buf));
+			XMt_MemtestFill(&Gen, Buf, &Seg);
+
+			Wrong = 0U;
+			for (Word = 0U; Word < Seg.Words; Word++) {
+				if (Buf[Word] != XMt_GetRefVal(Seg.Addr + (Word << 3),
+						Seg.Index + (Word << 3), Mode,
+						Pattern, RandVal)) {
+					Wrong++;
+				}
+				if (XMt_MemtestRefVal(&Gen, Seg.Addr + (Word << 3),
+						      Seg.Index + (Word << 3)) !=
+				    Buf[Word]) {
+					Wrong++;
+				}
+			}
+			CHECK(Word == MAX_WORDS || Buf[Word] == 0xA5A5A5A5A5A5A5A5U,
+			      "written past the range");
+			snprintf(Msg, sizeof(Msg), "mode %d range %u: %u words wrong",
+				 Mode, Range, Wrong);
+			CHECK(Wrong == 0U, Msg);
+
+			snprintf(Msg, sizeof(Msg), "mode %d range %u: false errors",
+				 Mode, Range);
+			CHECK(XMt_MemtestCheck(&Gen, Buf, 8U, &Seg) == 0U, Msg);
+		}
+	}
+}
+
+static void TestErrors(void)
+{
+	/* Word and flipped bits: block words, one tail word */
+	static const u64 Flips[][2] = {
+		{ 0U, 0x1U },
+		{ 9U, 0x0000FF0000000000U },
+		{ 15U, 0x8000000000000001U },
+		{ 64U, 0x0100010001000100U },
+		{ 1028U, 0x00000000FF000000U },
+	};
+	XMt_MemtestGen Gen;
+	XMt_MemtestSeg Seg;
+	static const u32 LaneCnt[8] = { 2U, 1U, 0U, 2U, 0U, 2U, 0U, 2U };
+	u32 Lane;
+	u32 Idx;
+	u64 Orig;
+
+	XMt_MemtestInitGen(&Gen, 11, Pattern, 77);
+	InitSeg(&Seg, 0x2000000U, 0U, MAX_WORDS);
+	XMt_MemtestFill(&Gen, Buf, &Seg);
+	for (Idx = 0U; Idx < 5U; Idx++) {
+		Buf[Flips[Idx][0]] ^= Flips[Idx][1];
+	}
+
+	CHECK(XMt_MemtestCheck(&Gen, Buf, 8U, &Seg) == 5U, "error count");
+	CHECK(Seg.NumErrLog == 5U, "error log length");
+	for (Idx = 0U; Idx < 5U; Idx++) {
+		Orig = Buf[Flips[Idx][0]] ^ Flips[Idx][1];
+		CHECK(Seg.ErrLog[Idx].Addr == 0x2000000U + (Flips[Idx][0] << 3),
+		      "logged address");
+		CHECK(Seg.ErrLog[Idx].Data == Buf[Flips[Idx][0]], "logged data");
+		CHECK(Seg.ErrLog[Idx].RefVal == Orig, "logged reference");
+	}
+	/* Word 64 hits lanes 1, 3, 5 and 7, the others one or two lanes */
+	for (Lane = 0U; Lane < 8U; Lane++) {
+		CHECK(Seg.LaneErrCnt[Lane] == LaneCnt[Lane], "lane count");
+	}
+
+	/* A 32-bit bus only counts the lower lanes */
+	InitSeg(&Seg, 0x2000000U, 0U, MAX_WORDS);
+	CHECK(XMt_MemtestCheck(&Gen, Buf, 4U, &Seg) == 5U, "32-bit count");
+	CHECK(Seg.LaneErrCnt[0] == 2U && Seg.LaneErrCnt[1] == 1U &&
+	      Seg.LaneErrCnt[3] == 2U && Seg.LaneErrCnt[5] == 0U &&
+	      Seg.LaneErrCnt[7] == 0U, "32-bit lane counts");
+
+	/* The log is capped, the counters are not */
+	XMt_MemtestFill(&Gen, Buf, &Seg);
+	for (Idx = 0U; Idx < 40U; Idx++) {
+		Buf[Idx * 25U] ^= 0x10U;
+	}
+	InitSeg(&Seg, 0x2000000U, 0U, MAX_WORDS);
+	CHECK(XMt_MemtestCheck(&Gen, Buf, 8U, &Seg) == 40U, "count past log");
+	CHECK(Seg.NumErrLog == XMT_MEMTEST_MAX_ERR_LOG, "log not capped");
+	CHECK(Seg.ErrLog[9].Addr == 0x2000000U + (9U * 25U * 8U),
+	      "log not in address order");
+}
+
+#ifdef FLAKY_MEMORY_MODEL
+static u64 *FlakyPage;
+static volatile u64 *FlakyWord;
+static unsigned int FlakyReads;
+static int FlakyHit;
+static u64 FlakyFirst;
+static long PageSize;
+
+/* An access to the page: let that instruction run alone */
+static void FlakyFault(int Sig, siginfo_t *Info, void *Ctx)
+{
+	ucontext_t *Uc = Ctx;
+
+	(void)Sig;
+	if (((u8 *)Info->si_addr < (u8 *)FlakyPage) ||
+	    ((u8 *)Info->si_addr >= (u8 *)FlakyPage + PageSize)) {
+		abort();
+	}
+	mprotect(FlakyPage, PageSize, PROT_READ | PROT_WRITE);
+	FlakyHit = (Info->si_addr == (void *)FlakyWord);
+	if (FlakyHit != 0) {
+		if (FlakyReads == 0U) {
+			FlakyFirst = *FlakyWord;
+		}
+		FlakyReads++;
+	}
+	Uc->uc_mcontext.gregs[REG_EFL] |= 0x100;
+}
+
+/* The access is done: the word decays and the page is closed again */
+static void FlakyStep(int Sig, siginfo_t *Info, void *Ctx)
+{
+	ucontext_t *Uc = Ctx;
+
+	(void)Sig;
+	(void)Info;
+	if (FlakyHit != 0) {
+		*FlakyWord ^= 0x0000000000010000U << FlakyReads;
+	}
+	mprotect(FlakyPage, PageSize, PROT_NONE);
+	Uc->uc_mcontext.gregs[REG_EFL] &= ~0x100;
+}
+
+static void TestSingleRead(void)
+{
+	struct sigaction Sa;
+	XMt_MemtestGen Gen;
+	XMt_MemtestSeg Seg;
+	u64 Words;
+	u32 Lane;
+
+	PageSize = sysconf(_SC_PAGESIZE);
+	Words = (u64)PageSize / 8U;
+	FlakyPage = mmap(NULL, PageSize, PROT_READ | PROT_WRITE,
+			 MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+	CHECK(FlakyPage != MAP_FAILED, "mmap");
+	if (FlakyPage == MAP_FAILED) {
+		return;
+	}
+
+	memset(&Sa, 0, sizeof(Sa));
+	Sa.sa_flags = SA_SIGINFO;
+	Sa.sa_sigaction = FlakyFault;
+	sigaction(SIGSEGV, &Sa, NULL);
+	Sa.sa_sigaction = FlakyStep;
+	sigaction(SIGTRAP, &Sa, NULL);
+
+	XMt_MemtestInitGen(&Gen, 3, Pattern, 0);
+	/* One word in a block, one in the tail */
+	InitSeg(&Seg, 0x3000000U, 0U, Words - 3U);
+	XMt_MemtestFill(&Gen, FlakyPage, &Seg);
+
+	FlakyWord = &FlakyPage[21];
+	*FlakyWord ^= 0xFFU;
+	FlakyReads = 0U;
+	mprotect(FlakyPage, PageSize, PROT_NONE);
+	CHECK(XMt_MemtestCheck(&Gen, FlakyPage, 8U, &Seg) == 1U,
+	      "block: error count");
+	mprotect(FlakyPage, PageSize, PROT_READ | PROT_WRITE);
+	CHECK(FlakyReads == 1U, "block: failing word read more than once");
+	CHECK(Seg.ErrLog[0].Data == FlakyFirst, "block: logged data re-read");
+	CHECK(Seg.LaneErrCnt[0] == 1U, "block: lanes from re-read data");
+	for (Lane = 1U; Lane < 8U; Lane++) {
+		CHECK(Seg.LaneErrCnt[Lane] == 0U, "block: lanes from re-read data");
+	}
+
+	XMt_MemtestFill(&Gen, FlakyPage, &Seg);
+	FlakyWord = &FlakyPage[Words - 4U];
+	*FlakyWord ^= 0xFF00U;
+	FlakyReads = 0U;
+	InitSeg(&Seg, 0x3000000U, 0U, Words - 3U);
+	mprotect(FlakyPage, PageSize, PROT_NONE);
+	CHECK(XMt_MemtestCheck(&Gen, FlakyPage, 8U, &Seg) == 1U,
+	      "tail: error count");
+	mprotect(FlakyPage, PageSize, PROT_READ | PROT_WRITE);
+	CHECK(FlakyReads == 1U, "tail: failing word read more than once");
+	CHECK(Seg.ErrLog[0].Data == FlakyFirst, "tail: logged data re-read");
+
+	signal(SIGSEGV, SIG_DFL);
+	signal(SIGTRAP, SIG_DFL);
+	munmap(FlakyPage, PageSize);
+}
+#endif
+
+int main(void)
+{
+	u32 Idx;
+
+	srand(1);
+	for (Idx = 0U; Idx < 128U; Idx++) {
+		Pattern[Idx] = ((u64)rand() << 33) ^ ((u64)rand() << 11) ^ rand();
+	}
+
+	TestPatterns();
+	TestErrors();
+#ifdef FLAKY_MEMORY_MODEL
+	TestSingleRead();
+#else
+	printf("flaky memory model not supported here, skipped\n");
+#endif
+
+	printf("%s (%u failures)\n", Failures ? "FAILED" : "PASSED", Failures);
+	return Failures ? 1 : 0;
+}
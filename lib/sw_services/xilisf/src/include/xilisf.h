@@ -798,6 +798,10 @@ typedef enum {
 					  *  page write
 					  */
 #endif /* (XPAR_XISF_FLASH_FAMILY == STM) */
+#if defined(XPAR_XISF_INTERFACE_PSQSPI) || \
+	defined(XPAR_XISF_INTERFACE_QSPIPSU)
+	XISF_MULTI_PAGE_WRITE,		/**< Write across multiple Pages */
+#endif
 } XIsf_WriteOperation;
 
 /**
@@ -2775,6 +2775,11 @@ static int SpaMicWinFlashInitialize(XIsf *InstancePtr, u8 *BufferPtr)
 						InstancePtr->SpiInstPtr,
 						XQSPIPSU_SELECT_FLASH_CS_UPPER,
 						XQSPIPSU_SELECT_FLASH_BUS_LOWER);
+				/*
+				 * The mode is set for the lower Flash only,
+				 * the upper one has to enter it as well
+				 */
+				InstancePtr->FourByteAddrMode = FALSE;
 				Status = XIsf_MicronFlashEnter4BAddMode(InstancePtr);
 			}
 		}
@@ -53,9 +53,37 @@
 
 /************************** Constant Definitions *****************************/
 #define SIXTEENMB	0x1000000	/**< Sixteen MB */
+#define XISF_NO_BANK	0xFFFFFFFFU	/**< No bank selected yet */
+
+#ifdef XPAR_XISF_INTERFACE_QSPIPSU
+/*
+ * Controller status poll: the bits set in the bus mask are ignored, the
+ * others must match the data value. Same values as the QSPIPSU poll example.
+ */
+#define XISF_POLL_SR_DATA	0x00U	/**< Status register, WIP clear */
+#define XISF_POLL_SR_MASK	0xFEU
+#define XISF_POLL_FSR_DATA	0x80U	/**< Flag status register, ready */
+#define XISF_POLL_FSR_MASK	0x7FU
+#define XISF_POLL_TIMEOUT	0xFFFFFFFFU	/**< Longest poll timeout */
+#endif
 
 /**************************** Type Definitions *******************************/
 
+#if defined(XPAR_XISF_INTERFACE_PSQSPI) || \
+	defined(XPAR_XISF_INTERFACE_QSPIPSU)
+/**
+ * The Pages of a multi Page write that go to one Flash device
+ */
+typedef struct {
+	u32 Address;		/**< Address of the next Page */
+	u8 *BufferPtr;		/**< Data of the next Page */
+	u32 ByteCount;		/**< Bytes not sent yet */
+	u32 PageAddress;	/**< Address of the Page being programmed */
+	u32 Bank;		/**< 16 MB region of the last bank select */
+	u8 Busy;		/**< A Page is being programmed */
+} XIsf_PageStream;
+#endif
+
 /***************** Macros (Inline Functions) Definitions *********************/
 
 /************************** Function Prototypes ******************************/
@@ -72,6 +100,24 @@ extern int SendBankSelect(XIsf *InstancePtr, u32 BankSel);
 static int WriteData(XIsf *InstancePtr, u8 Command, u32 Address,
 			u8 *BufferPtr, u32 ByteCount);
 #ifndef XPAR_XISF_INTERFACE_OSPIPSV
+#ifndef XPAR_XISF_INTERFACE_QSPIPSU
+static void StagePageData(XIsf *InstancePtr, const u8 *BufferPtr,
+			u32 ByteCount);
+#endif
+static int StartPageProgram(XIsf *InstancePtr, u8 Command, u32 Address,
+			u8 *BufferPtr, u32 ByteCount, u8 DataStaged,
+			u32 *BankPtr);
+#endif
+#if defined(XPAR_XISF_INTERFACE_PSQSPI) || \
+	defined(XPAR_XISF_INTERFACE_QSPIPSU)
+static int WaitForProgramDone(XIsf *InstancePtr);
+#ifdef XPAR_XISF_INTERFACE_QSPIPSU
+static int AutoPollProgramDone(XIsf *InstancePtr);
+#endif
+static int MultiPageWrite(XIsf *InstancePtr, u8 Command, u32 Address,
+			u8 *BufferPtr, u32 ByteCount);
+#endif
+#ifndef XPAR_XISF_INTERFACE_OSPIPSV
 static int AutoPageWrite(XIsf *InstancePtr, u32 Address);
 static int BufferWrite(XIsf *InstancePtr, u8 BufferNum, const u8 *WritePtr,
 			u32 ByteOffset, u32 NumBytes);
@@ -102,6 +148,7 @@ static int WriteVCR(XIsf *InstancePtr, u8 Command, u32 Address,
  *			Serial Flash.
  *			The different operations are
  *			- XISF_WRITE: Normal Write
+ *			- XISF_MULTI_PAGE_WRITE: Multiple Page Write
  *			- XISF_DUAL_IP_PAGE_WRITE: Dual Input Fast
  *			  Program
  *			- XISF_DUAL_IP_EXT_PAGE_WRITE: Dual Input
@@ -143,6 +190,20 @@ static int WriteVCR(XIsf *InstancePtr, u8 Command, u32 Address,
  *			This operation is supported for Atmel, Intel, STM,
  *			Winbond and Spansion Serial Flash.
  *
+ *			- Multiple Page Write (XISF_MULTI_PAGE_WRITE):
+ *			The OpParamPtr must be of type struct
+ *			XIsf_WriteParam, as for XISF_WRITE, but
+ *			OpParamPtr->NumBytes is not limited to one Page.
+ *			The data is programmed one Page at a time and the
+ *			write enable is sent by the library before each
+ *			Page. Each Page is polled to completion before the
+ *			next program command is sent, by the controller for
+ *			the QSPIPSU interface in interrupt mode. For the
+ *			PSQSPI interface the bank is selected only when the
+ *			write enters another 16 MB.
+ *			This operation is only supported for the PSQSPI
+ *			and QSPIPSU interfaces.
+ *
  *			- Auto Page Write (XISF_AUTO_PAGE_WRITE):
  *			The OpParamPtr must be of 32 bit unsigned integer
  *			variable.
@@ -250,8 +311,13 @@ int XIsf_Write(XIsf *InstancePtr, XIsf_WriteOperation Operation,
 
 	switch (Operation) {
 	case XISF_WRITE:
+#if defined(XPAR_XISF_INTERFACE_PSQSPI) || \
+	defined(XPAR_XISF_INTERFACE_QSPIPSU)
+	case XISF_MULTI_PAGE_WRITE:
+#endif
 		WriteParamPtr = (XIsf_WriteParam *)(void *) OpParamPtr;
 		Xil_AssertNonvoid(WriteParamPtr != NULL);
+		Command = XISF_CMD_PAGEPROG_WRITE;
 #if ((XPAR_XISF_FLASH_FAMILY == SPANSION) && \
 	(!defined(XPAR_XISF_INTERFACE_PSQSPI)))
 		if ((InstancePtr->FourByteAddrMode == TRUE) &&
@@ -271,23 +337,24 @@ int XIsf_Write(XIsf *InstancePtr, XIsf_WriteOperation Operation,
 					 XISF_MANUFACTURER_ID_MICRON) {
 				Command = XISF_CMD_PAGEPROG_WRITE;
 			}
-			Status = WriteData(InstancePtr,
-				Command,
-				WriteParamPtr->Address,
-				WriteParamPtr->WritePtr,
-				WriteParamPtr->NumBytes);
-		} else {
+		}
 #endif
-			Command = XISF_CMD_PAGEPROG_WRITE;
-			Status = WriteData(InstancePtr,
+#if defined(XPAR_XISF_INTERFACE_PSQSPI) || \
+	defined(XPAR_XISF_INTERFACE_QSPIPSU)
+		if (Operation == XISF_MULTI_PAGE_WRITE) {
+			Status = MultiPageWrite(InstancePtr,
 				Command,
 				WriteParamPtr->Address,
 				WriteParamPtr->WritePtr,
 				WriteParamPtr->NumBytes);
-#if ((XPAR_XISF_FLASH_FAMILY == SPANSION) && \
-	(!defined(XPAR_XISF_INTERFACE_PSQSPI)))
+			break;
 		}
 #endif
+		Status = WriteData(InstancePtr,
+			Command,
+			WriteParamPtr->Address,
+			WriteParamPtr->WritePtr,
+			WriteParamPtr->NumBytes);
 		break;
 #ifdef XPAR_XISF_INTERFACE_OSPIPSV
 	case XISF_WRITE_VOLATILE_CONFIG_REG:
@@ -451,56 +518,228 @@ int XIsf_Write(XIsf *InstancePtr, XIsf_WriteOperation Operation,
 static int WriteData(XIsf *InstancePtr, u8 Command, u32 Address,
 			u8 *BufferPtr, u32 ByteCount)
 {
+	int Status = (int)(XST_FAILURE);
+#ifdef XPAR_XISF_INTERFACE_OSPIPSV
+	u32 Bytestowrite;
+	u8 FlashStatus[2] __attribute__ ((aligned(4))) = {0};
+	u8 *NULLPtr = NULL;
+
+	if (BufferPtr == NULL)
+		return (int)XST_FAILURE;
+
+	if (InstancePtr->SpiInstPtr->OpMode == XOSPIPSV_DAC_MODE) {
+		Status = XIsf_WriteEnable(InstancePtr, XISF_WRITE_ENABLE);
+		if (Status != (int)XST_SUCCESS)
+			return (int)XST_FAILURE;
+
+		FlashMsg.Opcode = Command;
+		FlashMsg.Addrvalid = 1;
+		FlashMsg.TxBfrPtr = BufferPtr;
+		FlashMsg.RxBfrPtr = NULL;
+		FlashMsg.ByteCount = ByteCount;
+		FlashMsg.Flags = XOSPIPSV_MSG_FLAG_TX;
+		FlashMsg.Addrsize = 4;
+		FlashMsg.Addr = Address;
+		FlashMsg.Proto = XIsf_Get_ProtoType(InstancePtr, 0);
+		FlashMsg.Dummy = 0;
+		if (InstancePtr->SpiInstPtr->SdrDdrMode == XOSPIPSV_EDGE_MODE_DDR_PHY) {
+			FlashMsg.Proto = XOSPIPSV_WRITE_8_8_8;
+		}
+		FlashMsg.IsDDROpCode = 0;
+
+		InstancePtr->SpiInstPtr->Msg = &FlashMsg;
+		Status = XIsf_Transfer(InstancePtr, NULLPtr, NULLPtr, FlashMsg.ByteCount);
+		if (Status != (int)XST_SUCCESS)
+			return (int)XST_FAILURE;
+
+		while (1) {
+			FlashMsg.Opcode = READ_FLAG_STATUS_CMD;
+			FlashMsg.Addrsize = 0;
+			FlashMsg.Addrvalid = 0;
+			FlashMsg.TxBfrPtr = NULL;
+			FlashMsg.RxBfrPtr = FlashStatus;
+			FlashMsg.ByteCount = 1;
+			FlashMsg.Flags = XOSPIPSV_MSG_FLAG_RX;
+			FlashMsg.Dummy = 0;
+			FlashMsg.IsDDROpCode = 0;
+			FlashMsg.Proto = 0;
+			if (InstancePtr->SpiInstPtr->SdrDdrMode == XOSPIPSV_EDGE_MODE_DDR_PHY) {
+				FlashMsg.Proto = XOSPIPSV_READ_8_0_8;
+				FlashMsg.ByteCount = 2;
+				FlashMsg.Dummy = 8;
+			}
+			InstancePtr->SpiInstPtr->Msg = &FlashMsg;
+			Status = XIsf_Transfer(InstancePtr, NULLPtr, NULLPtr, FlashMsg.ByteCount);
+			if (Status != (int)XST_SUCCESS)
+				return (int)XST_FAILURE;
+
+			if ((FlashStatus[0] & 0x80) != 0)
+				break;
+		}
+	} else {
+		while (ByteCount != 0) {
+			/*
+			 * Enable write before transfer
+			 */
+			Status = XIsf_WriteEnable(InstancePtr, XISF_WRITE_ENABLE);
+			if (Status != (int)XST_SUCCESS)
+				return (int)XST_FAILURE;
+
+			if(ByteCount <= 8) {
+				Bytestowrite = ByteCount;
+				ByteCount = 0;
+			} else {
+				Bytestowrite = 8;
+				ByteCount -= 8;
+			}
+
+			FlashMsg.Opcode = Command;
+			FlashMsg.Addrvalid = 1;
+			FlashMsg.TxBfrPtr = BufferPtr;
+			FlashMsg.RxBfrPtr = NULL;
+			FlashMsg.ByteCount = Bytestowrite;
+			FlashMsg.Flags = XOSPIPSV_MSG_FLAG_TX;
+			FlashMsg.Proto = XIsf_Get_ProtoType(InstancePtr, 0);
+			FlashMsg.Dummy = 0;
+			FlashMsg.Addrsize = 4;
+			FlashMsg.IsDDROpCode = 0;
+			FlashMsg.Addr = Address;
+			if (InstancePtr->SpiInstPtr->SdrDdrMode == XOSPIPSV_EDGE_MODE_DDR_PHY) {
+				FlashMsg.Proto = XOSPIPSV_WRITE_8_8_8;
+			}
+			InstancePtr->SpiInstPtr->Msg = &FlashMsg;
+			Status = XIsf_Transfer(InstancePtr, NULLPtr, NULLPtr, FlashMsg.ByteCount);
+			if (Status != (int)XST_SUCCESS)
+				return (int)XST_FAILURE;
+
+			BufferPtr += 8;
+			Address += 8;
+
+			while (1) {
+				FlashMsg.Opcode = READ_FLAG_STATUS_CMD;
+				FlashMsg.Addrsize = 0;
+				FlashMsg.Addrvalid = 0;
+				FlashMsg.TxBfrPtr = NULL;
+				FlashMsg.RxBfrPtr = FlashStatus;
+				FlashMsg.ByteCount = 1;
+				FlashMsg.Flags = XOSPIPSV_MSG_FLAG_RX;
+				FlashMsg.Dummy = 0;
+				FlashMsg.IsDDROpCode = 0;
+				FlashMsg.Proto = 0;
+				if (InstancePtr->SpiInstPtr->SdrDdrMode == XOSPIPSV_EDGE_MODE_DDR_PHY) {
+					FlashMsg.Proto = XOSPIPSV_READ_8_0_8;
+					FlashMsg.ByteCount = 2;
+					FlashMsg.Dummy = 8;
+				}
+				InstancePtr->SpiInstPtr->Msg = &FlashMsg;
+				Status = XIsf_Transfer(InstancePtr, NULLPtr, NULLPtr, FlashMsg.ByteCount);
+				if (Status != (int)XST_SUCCESS)
+					return (int)XST_FAILURE;
+
+				if ((FlashStatus[0] & 0x80) != 0)
+					break;
+			}
+		}
+	}
+#else
+	Status = StartPageProgram(InstancePtr, Command, Address, BufferPtr,
+				ByteCount, FALSE, NULL);
 #if defined(XPAR_XISF_INTERFACE_PSQSPI) || \
-	defined(XPAR_XISF_INTERFACE_AXISPI)
-	u8 Mode;
-	u32 Index;
-	u32 BankSel;
+	defined(XPAR_XISF_INTERFACE_QSPIPSU)
+	if (Status != (int)XST_SUCCESS)
+		return (int)XST_FAILURE;
+
+	Status = WaitForProgramDone(InstancePtr);
 #endif
-#ifndef XPAR_XISF_INTERFACE_OSPIPSV
-	u32 RealAddr;
 #endif
-#if	defined(XPAR_XISF_INTERFACE_PSSPI)
+
+	return Status;
+}
+
+#ifndef XPAR_XISF_INTERFACE_OSPIPSV
+#ifndef XPAR_XISF_INTERFACE_QSPIPSU
+/*****************************************************************************/
+/**
+ *
+ * This function copies the data of one Page to the write buffer, behind the
+ * room reserved for the command and address bytes.
+ *
+ * @param	InstancePtr is a pointer to the XIsf instance.
+ * @param	BufferPtr is a pointer to the data to be written to Serial
+ *		Flash.
+ * @param	ByteCount is the number of bytes to be copied.
+ *
+ * @return	None.
+ *
+ ******************************************************************************/
+static void StagePageData(XIsf *InstancePtr, const u8 *BufferPtr,
+			u32 ByteCount)
+{
 	u32 Index;
+	u32 Offset = XISF_CMD_SEND_EXTRA_BYTES;
+
+#if ((XPAR_XISF_FLASH_FAMILY == SPANSION) && \
+	(!defined(XPAR_XISF_INTERFACE_PSQSPI)))
+	if (InstancePtr->FourByteAddrMode == TRUE)
+		Offset = XISF_CMD_SEND_EXTRA_BYTES_4BYTE_MODE;
 #endif
-	int Status = (int)(XST_FAILURE);
-#if ((!defined(XPAR_XISF_INTERFACE_QSPIPSU)) && \
-		(!defined(XPAR_XISF_INTERFACE_OSPIPSV)) && \
-		(!defined(XPAR_XISF_INTERFACE_PSSPI)))
-	u8 FlagStatus[2] = {0};
-#endif
-#ifdef XPAR_XISF_INTERFACE_OSPIPSV
-	u32 Bytestowrite;
+
+	for (Index = 0U; Index < ByteCount; Index++)
+		InstancePtr->WriteBufPtr[Offset + Index] = BufferPtr[Index];
+}
 #endif
-#if	(!defined(XPAR_XISF_INTERFACE_PSSPI))
-	u8 FlashStatus[2] __attribute__ ((aligned(4))) = {0};
+
+/*****************************************************************************/
+/**
+ *
+ * This function sends the program command, the address and the data to the
+ * Serial Flash. It returns once the data has been shifted out and does not
+ * wait for the Flash to complete the internal program cycle.
+ *
+ * @param	InstancePtr is a pointer to the XIsf instance.
+ * @param	Command is the program command to be used.
+ * @param	Address is the address in the Serial Flash memory, where the
+ *		data is to be written.
+ * @param	BufferPtr is a pointer to the data to be written to Serial
+ *		Flash.
+ * @param	ByteCount is the number of bytes to be written.
+ * @param	DataStaged is TRUE if the data has already been copied to the
+ *		write buffer by StagePageData(). It is ignored for the QSPIPSU
+ *		interface, which sends the data straight from BufferPtr.
+ * @param	BankPtr is NULL to always select the bank, as XISF_WRITE
+ *		does. Otherwise it holds the 16 MB region of the last bank
+ *		select, or XISF_NO_BANK, and the bank select is skipped if
+ *		Address is in the same region. Only used for the PSQSPI
+ *		interface.
+ *
+ * @return	XST_SUCCESS if successful else XST_FAILURE.
+ *
+ * @note	A minimum of one byte and a maximum of one Page can be
+ *		written using this function.
+ *
+ ******************************************************************************/
+static int StartPageProgram(XIsf *InstancePtr, u8 Command, u32 Address,
+			u8 *BufferPtr, u32 ByteCount, u8 DataStaged,
+			u32 *BankPtr)
+{
+#ifdef XPAR_XISF_INTERFACE_PSQSPI
+	u8 Mode;
+	u32 BankSel;
+	u32 Region;
 #endif
+	u32 RealAddr;
+	int Status = (int)(XST_FAILURE);
 	u8 *NULLPtr = NULL;
-	u8 *LocalBufPtr = BufferPtr;
 #ifdef	XPAR_XISF_INTERFACE_QSPIPSU
-	u8 ReadStatusCmd, FSRFlag;
 	u32 CmdByteCount;
 #endif
-#if defined(XPAR_XISF_INTERFACE_PSQSPI) || \
-	defined(XPAR_XISF_INTERFACE_QSPIPSU)
-	u32 FlashMake = InstancePtr->ManufacturerID;
-#endif
-#if ((!defined(XPAR_XISF_INTERFACE_QSPIPSU)) && \
-		(!defined(XPAR_XISF_INTERFACE_OSPIPSV)) && \
-		(!defined(XPAR_XISF_INTERFACE_PSSPI)))
-	u8 ReadStatusCmdBuf[] = { READ_STATUS_CMD, 0 };
-	u8 ReadFlagSRCmd[] = {READ_FLAG_STATUS_CMD, 0};
-#endif
 
-#ifndef XPAR_XISF_INTERFACE_OSPIPSV
 	if ((ByteCount <= 0) || (ByteCount > InstancePtr->BytesPerPage))
 		return (int)XST_FAILURE;
-#endif
 
-	if (LocalBufPtr == NULL)
+	if (BufferPtr == NULL)
 		return (int)XST_FAILURE;
 
-#ifndef XPAR_XISF_INTERFACE_OSPIPSV
 	/*
 	 * Translate address based on type of connection
 	 * If stacked assert the slave select based on address
@@ -512,7 +751,14 @@ static int WriteData(XIsf *InstancePtr, u8 Command, u32 Address,
 	 * 0x18 is the DeviceIDMemSize for different make of
 	 * flashes of size 16MB
 	 */
-	if (InstancePtr->DeviceIDMemSize > 0x18) {
+	/*
+	 * Every 16 MB of the address space is one bank of one Flash, in all
+	 * connection modes. The Extended Address Register keeps the bank, so
+	 * it need not be written again within the same 16 MB.
+	 */
+	Region = Address / SIXTEENMB;
+	if ((InstancePtr->DeviceIDMemSize > 0x18) &&
+		((BankPtr == NULL) || (*BankPtr != Region))) {
 
 		/*
 		 * Get the Transfer Mode
@@ -532,13 +778,18 @@ static int WriteData(XIsf *InstancePtr, u8 Command, u32 Address,
 		/*
 		 * Select bank
 		 */
-		(void)SendBankSelect(InstancePtr, BankSel);
+		Status = SendBankSelect(InstancePtr, BankSel);
+		if (BankPtr != NULL)
+			*BankPtr = (Status == (int)XST_SUCCESS) ?
+					Region : XISF_NO_BANK;
 
 		/*
 		 * Restoring the transfer mode back
 		 */
 		XIsf_SetTransferMode(InstancePtr, Mode);
 	}
+#else
+	(void)BankPtr;
 #endif
 #if ((XPAR_XISF_FLASH_FAMILY == SPANSION) && \
 	(!defined(XPAR_XISF_INTERFACE_PSQSPI)))
@@ -551,15 +802,7 @@ static int WriteData(XIsf *InstancePtr, u8 Command, u32 Address,
 		InstancePtr->WriteBufPtr[BYTE4] =
 				(u8) (RealAddr >> XISF_ADDR_SHIFT8);
 		InstancePtr->WriteBufPtr[BYTE5] = (u8) (RealAddr);
-#ifndef XPAR_XISF_INTERFACE_QSPIPSU
-		for (Index = 5U;
-				Index < (ByteCount +
-				XISF_CMD_SEND_EXTRA_BYTES_4BYTE_MODE);
-				Index++) {
-			InstancePtr->WriteBufPtr[Index] = *LocalBufPtr;
-			LocalBufPtr += 1;
-		}
-#else
+#ifdef XPAR_XISF_INTERFACE_QSPIPSU
 		CmdByteCount = 5;
 #endif
 	} else {
@@ -570,14 +813,7 @@ static int WriteData(XIsf *InstancePtr, u8 Command, u32 Address,
 		InstancePtr->WriteBufPtr[BYTE3] =
 				(u8) (RealAddr >> XISF_ADDR_SHIFT8);
 		InstancePtr->WriteBufPtr[BYTE4] = (u8) (RealAddr);
-#ifndef XPAR_XISF_INTERFACE_QSPIPSU
-		for (Index = 4U;
-				Index < (ByteCount + XISF_CMD_SEND_EXTRA_BYTES);
-				Index++) {
-			InstancePtr->WriteBufPtr[Index] = *LocalBufPtr;
-			LocalBufPtr += 1;
-		}
-#else
+#ifdef XPAR_XISF_INTERFACE_QSPIPSU
 		CmdByteCount = 4;
 #endif
 
@@ -586,6 +822,13 @@ static int WriteData(XIsf *InstancePtr, u8 Command, u32 Address,
 	}
 #endif
 
+#ifndef XPAR_XISF_INTERFACE_QSPIPSU
+	if (DataStaged == FALSE)
+		StagePageData(InstancePtr, BufferPtr, ByteCount);
+#else
+	(void)DataStaged;
+#endif
+
 #if defined(XPAR_XISF_INTERFACE_PSQSPI) || \
 	defined(XPAR_XISF_INTERFACE_QSPIPSU)
 	/*
@@ -601,7 +844,7 @@ static int WriteData(XIsf *InstancePtr, u8 Command, u32 Address,
 	FlashMsg[0].BusWidth = XQSPIPSU_SELECT_MODE_SPI;
 	FlashMsg[0].Flags = XQSPIPSU_MSG_FLAG_TX;
 
-	FlashMsg[1].TxBfrPtr = LocalBufPtr;
+	FlashMsg[1].TxBfrPtr = BufferPtr;
 	FlashMsg[1].RxBfrPtr = NULL;
 	FlashMsg[1].ByteCount = ByteCount;
 	FlashMsg[1].BusWidth = XQSPIPSU_SELECT_MODE_SPI;
@@ -628,8 +871,40 @@ static int WriteData(XIsf *InstancePtr, u8 Command, u32 Address,
 	if (Status != (int)XST_SUCCESS)
 		return (int)XST_FAILURE;
 
+	return Status;
+}
+#endif
+
 #if defined(XPAR_XISF_INTERFACE_PSQSPI) || \
 	defined(XPAR_XISF_INTERFACE_QSPIPSU)
+/*****************************************************************************/
+/**
+ *
+ * This function waits for the Serial Flash to complete a program cycle by
+ * polling the status register, or the flag status register for multi-die
+ * Micron devices.
+ *
+ * @param	InstancePtr is a pointer to the XIsf instance.
+ *
+ * @return	XST_SUCCESS if successful else XST_FAILURE.
+ *
+ * @note	In stacked mode the status is read from the Flash selected by
+ *		the last program command.
+ *
+ ******************************************************************************/
+static int WaitForProgramDone(XIsf *InstancePtr)
+{
+	int Status = (int)(XST_FAILURE);
+	u8 FlashStatus[2] __attribute__ ((aligned(4))) = {0};
+	u32 FlashMake = InstancePtr->ManufacturerID;
+#ifdef	XPAR_XISF_INTERFACE_QSPIPSU
+	u8 *NULLPtr = NULL;
+	u8 ReadStatusCmd, FSRFlag;
+#else
+	u8 FlagStatus[2] = {0};
+	u8 ReadStatusCmdBuf[] = { READ_STATUS_CMD, 0 };
+	u8 ReadFlagSRCmd[] = {READ_FLAG_STATUS_CMD, 0};
+#endif
 
 	if ((InstancePtr->NumDie > (u8)1) &&
 		(FlashMake == (u32)XISF_MANUFACTURER_ID_MICRON)) {
@@ -723,126 +998,232 @@ static int WriteData(XIsf *InstancePtr, u8 Command, u32 Address,
 			return (int)XST_FAILURE;
 	}
 #endif
-#endif
-#else
-	if (InstancePtr->SpiInstPtr->OpMode == XOSPIPSV_DAC_MODE) {
-		Status = XIsf_WriteEnable(InstancePtr, XISF_WRITE_ENABLE);
-		if (Status != (int)XST_SUCCESS)
-			return (int)XST_FAILURE;
 
-		FlashMsg.Opcode = Command;
-		FlashMsg.Addrvalid = 1;
-		FlashMsg.TxBfrPtr = BufferPtr;
-		FlashMsg.RxBfrPtr = NULL;
-		FlashMsg.ByteCount = ByteCount;
-		FlashMsg.Flags = XOSPIPSV_MSG_FLAG_TX;
-		FlashMsg.Addrsize = 4;
-		FlashMsg.Addr = Address;
-		FlashMsg.Proto = XIsf_Get_ProtoType(InstancePtr, 0);
-		FlashMsg.Dummy = 0;
-		if (InstancePtr->SpiInstPtr->SdrDdrMode == XOSPIPSV_EDGE_MODE_DDR_PHY) {
-			FlashMsg.Proto = XOSPIPSV_WRITE_8_8_8;
-		}
-		FlashMsg.IsDDROpCode = 0;
+	return Status;
+}
 
-		InstancePtr->SpiInstPtr->Msg = &FlashMsg;
-		Status = XIsf_Transfer(InstancePtr, NULLPtr, NULLPtr, FlashMsg.ByteCount);
-		if (Status != (int)XST_SUCCESS)
-			return (int)XST_FAILURE;
+#ifdef XPAR_XISF_INTERFACE_QSPIPSU
+/*****************************************************************************/
+/**
+ *
+ * This function waits for the Serial Flash to complete a program cycle with
+ * the status poll of the controller. The controller reads the status
+ * register, or the flag status register for multi-die Micron devices, until
+ * the Flash is ready and then raises a single interrupt, so no status read
+ * transfer is issued by software.
+ *
+ * @param	InstancePtr is a pointer to the XIsf instance.
+ *
+ * @return	XST_SUCCESS if successful else XST_FAILURE, also if the
+ *		controller reports a poll timeout.
+ *
+ * @note	The controller polls in interrupt mode only. In stacked mode
+ *		the status is read from the Flash selected by the last program
+ *		command.
+ *
+ ******************************************************************************/
+static int AutoPollProgramDone(XIsf *InstancePtr)
+{
+	int Status = (int)(XST_FAILURE);
+	u8 FlashStatus[2] __attribute__ ((aligned(4))) = {0};
+	u8 *NULLPtr = NULL;
 
-		while (1) {
-			FlashMsg.Opcode = READ_FLAG_STATUS_CMD;
-			FlashMsg.Addrsize = 0;
-			FlashMsg.Addrvalid = 0;
-			FlashMsg.TxBfrPtr = NULL;
-			FlashMsg.RxBfrPtr = FlashStatus;
-			FlashMsg.ByteCount = 1;
-			FlashMsg.Flags = XOSPIPSV_MSG_FLAG_RX;
-			FlashMsg.Dummy = 0;
-			FlashMsg.IsDDROpCode = 0;
-			FlashMsg.Proto = 0;
-			if (InstancePtr->SpiInstPtr->SdrDdrMode == XOSPIPSV_EDGE_MODE_DDR_PHY) {
-				FlashMsg.Proto = XOSPIPSV_READ_8_0_8;
-				FlashMsg.ByteCount = 2;
-				FlashMsg.Dummy = 8;
-			}
-			InstancePtr->SpiInstPtr->Msg = &FlashMsg;
-			Status = XIsf_Transfer(InstancePtr, NULLPtr, NULLPtr, FlashMsg.ByteCount);
-			if (Status != (int)XST_SUCCESS)
-				return (int)XST_FAILURE;
+	FlashMsg[0].TxBfrPtr = NULL;
+	FlashMsg[0].RxBfrPtr = FlashStatus;
+	FlashMsg[0].ByteCount = 2;
+	FlashMsg[0].BusWidth = XQSPIPSU_SELECT_MODE_SPI;
+	FlashMsg[0].Flags = XQSPIPSU_MSG_FLAG_POLL;
+	FlashMsg[0].PollTimeout = XISF_POLL_TIMEOUT;
 
-			if ((FlashStatus[0] & 0x80) != 0)
-				break;
-		}
+	if ((InstancePtr->NumDie > (u8)1) &&
+		(InstancePtr->ManufacturerID ==
+				(u32)XISF_MANUFACTURER_ID_MICRON)) {
+		FlashMsg[0].PollStatusCmd = READ_FLAG_STATUS_CMD;
+		FlashMsg[0].PollData = XISF_POLL_FSR_DATA;
+		FlashMsg[0].PollBusMask = XISF_POLL_FSR_MASK;
 	} else {
-		while (ByteCount != 0) {
-			/*
-			 * Enable write before transfer
-			 */
-			Status = XIsf_WriteEnable(InstancePtr, XISF_WRITE_ENABLE);
-			if (Status != (int)XST_SUCCESS)
-				return (int)XST_FAILURE;
+		FlashMsg[0].PollStatusCmd = READ_STATUS_CMD;
+		FlashMsg[0].PollData = XISF_POLL_SR_DATA;
+		FlashMsg[0].PollBusMask = XISF_POLL_SR_MASK;
+	}
 
-			if(ByteCount <= 8) {
-				Bytestowrite = ByteCount;
-				ByteCount = 0;
-			} else {
-				Bytestowrite = 8;
-				ByteCount -= 8;
-			}
+	if (InstancePtr->SpiInstPtr->Config.ConnectionMode ==
+			XISF_QSPIPS_CONNECTION_MODE_PARALLEL)
+		FlashMsg[0].Flags |= XQSPIPSU_MSG_FLAG_STRIPE;
 
-			FlashMsg.Opcode = Command;
-			FlashMsg.Addrvalid = 1;
-			FlashMsg.TxBfrPtr = BufferPtr;
-			FlashMsg.RxBfrPtr = NULL;
-			FlashMsg.ByteCount = Bytestowrite;
-			FlashMsg.Flags = XOSPIPSV_MSG_FLAG_TX;
-			FlashMsg.Proto = XIsf_Get_ProtoType(InstancePtr, 0);
-			FlashMsg.Dummy = 0;
-			FlashMsg.Addrsize = 4;
-			FlashMsg.IsDDROpCode = 0;
-			FlashMsg.Addr = Address;
-			if (InstancePtr->SpiInstPtr->SdrDdrMode == XOSPIPSV_EDGE_MODE_DDR_PHY) {
-				FlashMsg.Proto = XOSPIPSV_WRITE_8_8_8;
-			}
-			InstancePtr->SpiInstPtr->Msg = &FlashMsg;
-			Status = XIsf_Transfer(InstancePtr, NULLPtr, NULLPtr, FlashMsg.ByteCount);
-			if (Status != (int)XST_SUCCESS)
-				return (int)XST_FAILURE;
+	InstancePtr->SpiInstPtr->Msg = FlashMsg;
+	Status = XIsf_Transfer(InstancePtr, NULLPtr, NULLPtr, 1);
+	if (Status != (int)XST_SUCCESS)
+		return (int)XST_FAILURE;
 
-			BufferPtr += 8;
-			Address += 8;
+	if (XIsf_StatusEventInfo != (u32)XST_SPI_POLL_DONE)
+		return (int)XST_FAILURE;
 
-			while (1) {
-				FlashMsg.Opcode = READ_FLAG_STATUS_CMD;
-				FlashMsg.Addrsize = 0;
-				FlashMsg.Addrvalid = 0;
-				FlashMsg.TxBfrPtr = NULL;
-				FlashMsg.RxBfrPtr = FlashStatus;
-				FlashMsg.ByteCount = 1;
-				FlashMsg.Flags = XOSPIPSV_MSG_FLAG_RX;
-				FlashMsg.Dummy = 0;
-				FlashMsg.IsDDROpCode = 0;
-				FlashMsg.Proto = 0;
-				if (InstancePtr->SpiInstPtr->SdrDdrMode == XOSPIPSV_EDGE_MODE_DDR_PHY) {
-					FlashMsg.Proto = XOSPIPSV_READ_8_0_8;
-					FlashMsg.ByteCount = 2;
-					FlashMsg.Dummy = 8;
+	/*
+	 * Report the write to the application as a completed transfer, as
+	 * for the polled status reads
+	 */
+	XIsf_StatusEventInfo = (u32)XST_SPI_TRANSFER_DONE;
+
+	return (int)XST_SUCCESS;
+}
+#endif
+
+/*****************************************************************************/
+/**
+ *
+ * This function writes a buffer of any length to the Serial Flash, one Page
+ * program command at a time.
+ *
+ * The data is split at Page boundaries, so that no program command crosses
+ * a Page, a die, a bank or, in stacked mode, a Flash device. A Flash device
+ * programs one Page at a time, so within one device the time saved is the
+ * work done per Page outside of the program cycle:
+ *
+ * - For the PSQSPI interface the data of the next Page is copied to the
+ *   write buffer while the Flash programs the current one, and the bank is
+ *   selected only when the write enters another 16 MB, instead of writing
+ *   the Extended Address Register before every Page.
+ * - For the QSPIPSU interface in interrupt mode the controller polls the
+ *   status of the Flash and interrupts once it is ready, instead of one
+ *   status read transfer per poll. In polled mode the status is read by
+ *   software, as the driver polls only in interrupt mode.
+ *
+ * In stacked mode the two Flash devices program independently. A write
+ * crossing from the lower into the upper device is split into one stream of
+ * Pages per device, and the next Page of one device is sent while the other
+ * device programs its Page, so both are busy at the same time.
+ *
+ * @param	InstancePtr is a pointer to the XIsf instance.
+ * @param	Command is the program command to be used.
+ * @param	Address is the start address in the Serial Flash memory,
+ *		where the data is to be written.
+ * @param	BufferPtr is a pointer to the data to be written to Serial
+ *		Flash.
+ * @param	ByteCount is the number of bytes to be written.
+ *
+ * @return	XST_SUCCESS if successful else XST_FAILURE.
+ *
+ * @note	The Flash area must have been erased before calling this
+ *		function.
+ *
+ ******************************************************************************/
+static int MultiPageWrite(XIsf *InstancePtr, u8 Command, u32 Address,
+			u8 *BufferPtr, u32 ByteCount)
+{
+	int Status = (int)(XST_FAILURE);
+	XIsf_PageStream Stream[2];
+	XIsf_PageStream *StreamPtr;
+	u32 NumStreams = 1U;
+	u32 DeviceSize;
+	u32 LowerBytes;
+	u32 PageBytes;
+	u32 Index;
+	u8 DataStaged;
+	u8 Pending;
+
+	if ((ByteCount == 0U) || (BufferPtr == NULL))
+		return (int)XST_FAILURE;
+
+	Stream[0].Address = Address;
+	Stream[0].BufferPtr = BufferPtr;
+	Stream[0].ByteCount = ByteCount;
+	Stream[0].Bank = XISF_NO_BANK;
+	Stream[0].Busy = FALSE;
+
+	if (InstancePtr->SpiInstPtr->Config.ConnectionMode ==
+			XISF_QSPIPS_CONNECTION_MODE_STACKED) {
+		/*
+		 * The sectors of both Flash devices are counted in stacked
+		 * mode
+		 */
+		DeviceSize = (InstancePtr->SectorSize *
+				InstancePtr->NumSectors) / 2U;
+		if ((Address < DeviceSize) &&
+			(ByteCount > (DeviceSize - Address))) {
+			LowerBytes = DeviceSize - Address;
+			Stream[0].ByteCount = LowerBytes;
+			Stream[1].Address = DeviceSize;
+			Stream[1].BufferPtr = BufferPtr + LowerBytes;
+			Stream[1].ByteCount = ByteCount - LowerBytes;
+			Stream[1].Bank = XISF_NO_BANK;
+			Stream[1].Busy = FALSE;
+			NumStreams = 2U;
+		}
+	}
+
+	do {
+		Pending = FALSE;
+		for (Index = 0U; Index < NumStreams; Index++) {
+			StreamPtr = &Stream[Index];
+			PageBytes = InstancePtr->BytesPerPage -
+				(StreamPtr->Address %
+				 InstancePtr->BytesPerPage);
+			if (PageBytes > StreamPtr->ByteCount)
+				PageBytes = StreamPtr->ByteCount;
+			DataStaged = FALSE;
+
+			if (StreamPtr->Busy == TRUE) {
+				/*
+				 * Copy the next Page of this device to the
+				 * write buffer while it is programming the
+				 * current one. XIsf_Transfer() returns only
+				 * when the program command has been shifted
+				 * out, in interrupt mode as well, so the write
+				 * buffer is free.
+				 */
+#ifndef XPAR_XISF_INTERFACE_QSPIPSU
+				if (PageBytes != 0U) {
+					StagePageData(InstancePtr,
+						StreamPtr->BufferPtr,
+						PageBytes);
+					DataStaged = TRUE;
 				}
-				InstancePtr->SpiInstPtr->Msg = &FlashMsg;
-				Status = XIsf_Transfer(InstancePtr, NULLPtr, NULLPtr, FlashMsg.ByteCount);
+#endif
+				/*
+				 * Select the device of this stream for the
+				 * status reads
+				 */
+				if (NumStreams > 1U)
+					(void)GetRealAddr(
+						InstancePtr->SpiInstPtr,
+						StreamPtr->PageAddress);
+#ifdef XPAR_XISF_INTERFACE_QSPIPSU
+				if (XIsf_GetTransferMode(InstancePtr) ==
+						XISF_INTERRUPT_MODE)
+					Status = AutoPollProgramDone(
+							InstancePtr);
+				else
+#endif
+					Status = WaitForProgramDone(
+							InstancePtr);
 				if (Status != (int)XST_SUCCESS)
 					return (int)XST_FAILURE;
+				StreamPtr->Busy = FALSE;
+			}
 
-				if ((FlashStatus[0] & 0x80) != 0)
-					break;
+			if (PageBytes != 0U) {
+				Status = StartPageProgram(InstancePtr, Command,
+						StreamPtr->Address,
+						StreamPtr->BufferPtr,
+						PageBytes, DataStaged,
+						&StreamPtr->Bank);
+				if (Status != (int)XST_SUCCESS)
+					return (int)XST_FAILURE;
+
+				StreamPtr->PageAddress = StreamPtr->Address;
+				StreamPtr->Address += PageBytes;
+				StreamPtr->BufferPtr += PageBytes;
+				StreamPtr->ByteCount -= PageBytes;
+				StreamPtr->Busy = TRUE;
+				Pending = TRUE;
 			}
 		}
-	}
-#endif
+	} while (Pending == TRUE);
 
 	return Status;
 }
+#endif
 
 #ifdef XPAR_XISF_INTERFACE_OSPIPSV
 /*****************************************************************************/
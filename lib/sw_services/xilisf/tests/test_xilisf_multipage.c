@@ -0,0 +1,631 @@
+/******************************************************************************
+* Copyright (C) 2020 Xilinx, Inc.  All rights reserved.
+* SPDX-License-Identifier: MIT
+******************************************************************************/
+
+/*****************************************************************************/
+/**
+*
+* @file test_xilisf_multipage.c
+*
+* Host test of the XISF_MULTI_PAGE_WRITE operation. The library is built for
+* the PS QSPI interface against a simulated SPI-NOR: a two die Micron 512 Mbit
+* part with write enable latch, Extended Address Register, program busy time,
+* Page wrap and the flag status read required after a program on multi die
+* parts. Protocol errors are counted instead of being silently accepted. The
+* simulation keeps a clock that advances by the SPI transfer time of every
+* command, and by the interrupt handling in interrupt mode, so that the
+* throughput of multi Page and Page by Page writes can be compared.
+*
+* Single and stacked connections are tested in polled and interrupt mode.
+* The multi Page write must select the bank only once per 16 MB, and be
+* faster than Page by Page writes by at least the bank selects it skips.
+*
+* Build and run on the host:
+*   cc -Wall -O2 -I. -I../src -I../src/include \
+*      -I../../../../XilinxProcessorIPLib/drivers/qspips/src \
+*      -I../../../bsp/standalone/src/common \
+*      test_xilisf_multipage.c -o test_xilisf_multipage
+*   ./test_xilisf_multipage
+*
+******************************************************************************/
+
+/***************************** Include Files *********************************/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+/* Build the standalone (non Linux) flavour of the library */
+#undef __linux__
+#include "xil_types.h"
+
+/* Register accesses go to the model below */
+#define XIL_IO_H
+#define INLINE inline
+static u32 Xil_In32(UINTPTR Addr);
+static void Xil_Out32(UINTPTR Addr, u32 Value);
+
+#define XIL_PRINTF_H
+#define xil_printf printf
+
+#include "xilisf.c"
+#include "xilisf_write.c"
+
+/************************** Simulated SPI-NOR ********************************/
+
+#define QSPI_BASE		0xE000D000U
+#define NUM_DEVICES		2U
+#define DEVICE_SIZE		0x4000000U	/* 512 Mbit */
+#define PAGE_SIZE		256U
+#define BANK_SIZE		0x1000000U
+#define NUM_PAGES		(DEVICE_SIZE / PAGE_SIZE)
+
+#define JEDEC_MANUFACTURER	0x20U		/* Micron */
+#define JEDEC_TYPE		0xBAU
+#define JEDEC_CAPACITY		0x20U		/* 512 Mbit */
+
+/*
+ * Timing: 50 MHz single line SPI clock, 1 us of command overhead per
+ * transfer, 2 us more for the interrupt of a transfer in interrupt mode and
+ * the typical Page program time of the N25Q family.
+ */
+#define BYTE_NS			160U
+#define XFER_OVERHEAD_NS	1000U
+#define XFER_IRQ_NS		2000U
+#define TPP_NS			500000U
+
+#define SR_WIP			0x01U
+#define SR_WEL			0x02U
+#define FSR_READY		0x80U
+
+typedef struct {
+	u8 *Page[NUM_PAGES];	/* NULL while erased */
+	u8 Wel;
+	u8 Ear;
+	u8 FsrPending;		/* Program done, flag status not read yet */
+	u64 BusyUntil;
+} SimDevice;
+
+static struct {
+	SimDevice Dev[NUM_DEVICES];
+	u32 LqspiCr;
+	u64 Now;		/* Simulated time in ns */
+	u32 Transfers;
+	u32 Programs;
+	u32 ProgrammedBytes;
+	u32 BankSelects;
+
+	/* Protocol errors */
+	u32 BusyViolations;	/* Command other than a status read while
+				 * busy */
+	u32 WelViolations;	/* Program or EAR write without write
+				 * enable */
+	u32 PageWraps;		/* Program running past the end of a Page */
+	u32 FsrSkipped;		/* Program before the flag status read */
+	u32 Unknown;		/* Unknown or malformed command */
+
+	XQspiPs_StatusHandler Handler;
+	void *HandlerRef;
+} Sim;
+
+static u32 Xil_In32(UINTPTR Addr)
+{
+	if (Addr == (QSPI_BASE + XQSPIPS_LQSPI_CR_OFFSET))
+		return Sim.LqspiCr;
+	return 0U;
+}
+
+static void Xil_Out32(UINTPTR Addr, u32 Value)
+{
+	if (Addr == (QSPI_BASE + XQSPIPS_LQSPI_CR_OFFSET))
+		Sim.LqspiCr = Value;
+}
+
+static void SimReset(void)
+{
+	u32 Dev;
+	u32 Page;
+
+	for (Dev = 0U; Dev < NUM_DEVICES; Dev++) {
+		for (Page = 0U; Page < NUM_PAGES; Page++)
+			free(Sim.Dev[Dev].Page[Page]);
+	}
+	memset(&Sim, 0, sizeof(Sim));
+}
+
+static u8 SimByte(u32 Dev, u32 Addr)
+{
+	const u8 *Page = Sim.Dev[Dev].Page[Addr / PAGE_SIZE];
+
+	return (Page == NULL) ? 0xFFU : Page[Addr % PAGE_SIZE];
+}
+
+static void SimProgram(SimDevice *DevPtr, const u8 *Cmd, u32 Count)
+{
+	u32 Addr;
+	u32 Len = Count - 4U;
+	u32 Index;
+	u8 *Page;
+
+	if (DevPtr->Wel == 0U) {
+		Sim.WelViolations++;
+		return;
+	}
+	if (DevPtr->FsrPending != 0U)
+		Sim.FsrSkipped++;
+
+	Addr = ((u32)DevPtr->Ear << 24) | ((u32)Cmd[1] << 16) |
+		((u32)Cmd[2] << 8) | Cmd[3];
+	if ((Count < 5U) || (Addr >= DEVICE_SIZE)) {
+		Sim.Unknown++;
+		return;
+	}
+	if (((Addr % PAGE_SIZE) + Len) > PAGE_SIZE)
+		Sim.PageWraps++;
+
+	Page = DevPtr->Page[Addr / PAGE_SIZE];
+	if (Page == NULL) {
+		Page = malloc(PAGE_SIZE);
+		memset(Page, 0xFF, PAGE_SIZE);
+		DevPtr->Page[Addr / PAGE_SIZE] = Page;
+	}
+
+	/* Programming only clears bits, the address wraps within the Page */
+	for (Index = 0U; Index < Len; Index++)
+		Page[(Addr + Index) % PAGE_SIZE] &= Cmd[4U + Index];
+
+	Sim.Programs++;
+	Sim.ProgrammedBytes += Len;
+	DevPtr->Wel = 0U;
+	DevPtr->FsrPending = 1U;
+	DevPtr->BusyUntil = Sim.Now + TPP_NS;
+}
+
+static void SimTransfer(XQspiPs *QspiPtr, const u8 *Send, u8 *Recv,
+			u32 Count)
+{
+	SimDevice *DevPtr;
+	u32 Dev = 0U;
+	int Busy;
+
+	if ((QspiPtr->Config.ConnectionMode ==
+			XQSPIPS_CONNECTION_MODE_STACKED) &&
+		((Sim.LqspiCr & XQSPIPS_LQSPI_CR_U_PAGE_MASK) != 0U))
+		Dev = 1U;
+	DevPtr = &Sim.Dev[Dev];
+
+	Sim.Transfers++;
+	Sim.Now += XFER_OVERHEAD_NS + ((u64)Count * BYTE_NS);
+	Busy = (Sim.Now < DevPtr->BusyUntil);
+
+	if (Recv != NULL)
+		memset(Recv, 0, Count);
+
+	if (Busy && (Send[0] != READ_STATUS_CMD) &&
+			(Send[0] != READ_FLAG_STATUS_CMD)) {
+		Sim.BusyViolations++;
+		return;
+	}
+
+	switch (Send[0]) {
+	case READ_ID:
+		if ((Recv != NULL) && (Count >= 4U)) {
+			Recv[1] = JEDEC_MANUFACTURER;
+			Recv[2] = JEDEC_TYPE;
+			Recv[3] = JEDEC_CAPACITY;
+		}
+		break;
+	case WRITE_ENABLE_CMD:
+		DevPtr->Wel = 1U;
+		break;
+	case XISF_CMD_DISABLE_WRITE:
+		DevPtr->Wel = 0U;
+		break;
+	case READ_STATUS_CMD:
+		if ((Recv != NULL) && (Count >= 2U))
+			Recv[1] = (Busy ? SR_WIP : 0U) |
+					(DevPtr->Wel ? SR_WEL : 0U);
+		break;
+	case READ_FLAG_STATUS_CMD:
+		if ((Recv != NULL) && (Count >= 2U))
+			Recv[1] = Busy ? 0U : FSR_READY;
+		if (!Busy)
+			DevPtr->FsrPending = 0U;
+		break;
+	case 0xC5U:	/* Write Extended Address Register */
+		if (DevPtr->Wel == 0U) {
+			Sim.WelViolations++;
+			break;
+		}
+		DevPtr->Ear = Send[1];
+		DevPtr->Wel = 0U;
+		Sim.BankSelects++;
+		break;
+	case XISF_CMD_PAGEPROG_WRITE:
+		SimProgram(DevPtr, Send, Count);
+		break;
+	default:
+		Sim.Unknown++;
+		break;
+	}
+}
+
+/************************** QSPI Driver Stubs ********************************/
+
+s32 XQspiPs_PolledTransfer(XQspiPs *InstancePtr, u8 *SendBufPtr,
+			    u8 *RecvBufPtr, u32 ByteCount)
+{
+	SimTransfer(InstancePtr, SendBufPtr, RecvBufPtr, ByteCount);
+	return XST_SUCCESS;
+}
+
+/* Completes at once and calls the status handler like the interrupt would */
+s32 XQspiPs_Transfer(XQspiPs *InstancePtr, u8 *SendBufPtr, u8 *RecvBufPtr,
+		      u32 ByteCount)
+{
+	SimTransfer(InstancePtr, SendBufPtr, RecvBufPtr, ByteCount);
+	Sim.Now += XFER_IRQ_NS;
+	if (Sim.Handler != NULL)
+		Sim.Handler(Sim.HandlerRef, XST_SPI_TRANSFER_DONE, ByteCount);
+	return XST_SUCCESS;
+}
+
+int XQspiPs_SetSlaveSelect(XQspiPs *InstancePtr)
+{
+	(void)InstancePtr;
+	return XST_SUCCESS;
+}
+
+s32 XQspiPs_SetOptions(XQspiPs *InstancePtr, u32 Options)
+{
+	(void)InstancePtr;
+	(void)Options;
+	return XST_SUCCESS;
+}
+
+s32 XQspiPs_SetClkPrescaler(XQspiPs *InstancePtr, u8 Prescaler)
+{
+	(void)InstancePtr;
+	(void)Prescaler;
+	return XST_SUCCESS;
+}
+
+void XQspiPs_SetStatusHandler(XQspiPs *InstancePtr, void *CallBackRef,
+				XQspiPs_StatusHandler FuncPtr)
+{
+	(void)InstancePtr;
+	Sim.HandlerRef = CallBackRef;
+	Sim.Handler = FuncPtr;
+}
+
+u32 Xil_AssertStatus;
+s32 Xil_AssertWait;
+
+void Xil_Assert(const char8 *File, s32 Line)
+{
+	printf("ASSERT %s:%d\n", File, (int)Line);
+}
+
+/************************** Test Helpers *************************************/
+
+static u32 Failures;
+
+#define CHECK(Cond, Msg) \
+	do { \
+		if (!(Cond)) { \
+			printf("FAIL line %d: %s\n", __LINE__, Msg); \
+			Failures++; \
+		} \
+	} while (0)
+
+#define MAX_WRITE	0x40000U
+
+static XIsf Isf;
+static XQspiPs Qspi;
+static u8 IsfWriteBuf[PAGE_SIZE + XISF_CMD_SEND_EXTRA_BYTES_4BYTE_MODE];
+static u8 Data[MAX_WRITE];
+static u32 AppEvents;
+
+static void AppHandler(void *CallBackRef, u32 StatusEvent,
+			unsigned int ByteCount)
+{
+	(void)CallBackRef;
+	(void)StatusEvent;
+	(void)ByteCount;
+	AppEvents++;
+}
+
+static int FlashInit(u8 ConnectionMode, u8 TransferMode)
+{
+	int Status;
+
+	SimReset();
+	memset(&Isf, 0, sizeof(Isf));
+	memset(&Qspi, 0, sizeof(Qspi));
+	Qspi.Config.BaseAddress = QSPI_BASE;
+	Qspi.Config.ConnectionMode = ConnectionMode;
+	Qspi.IsReady = XIL_COMPONENT_IS_READY;
+
+	Status = XIsf_Initialize(&Isf, &Qspi, 0, IsfWriteBuf);
+	if (Status != XST_SUCCESS)
+		return Status;
+
+	XIsf_SetStatusHandler(&Isf, &Qspi, AppHandler);
+	XIsf_SetTransferMode(&Isf, TransferMode);
+	return XST_SUCCESS;
+}
+
+static u32 ProtocolErrors(void)
+{
+	return Sim.BusyViolations + Sim.WelViolations + Sim.PageWraps +
+		Sim.FsrSkipped + Sim.Unknown;
+}
+
+static void FillData(u32 Seed, u32 Len)
+{
+	u32 Index;
+
+	for (Index = 0U; Index < Len; Index++) {
+		Seed = (Seed * 1103515245U) + 12345U;
+		Data[Index] = (u8)(Seed >> 16);
+	}
+}
+
+static int Matches(u32 Address, u32 Len)
+{
+	u32 Index;
+	u32 Addr;
+	u32 Dev;
+
+	for (Index = 0U; Index < Len; Index++) {
+		Addr = Address + Index;
+		Dev = Addr / DEVICE_SIZE;
+		if (SimByte(Dev, Addr % DEVICE_SIZE) != Data[Index])
+			return 0;
+	}
+	return 1;
+}
+
+static u32 PagesSpanned(u32 Address, u32 Len)
+{
+	return ((Address + Len - 1U) / PAGE_SIZE) - (Address / PAGE_SIZE) + 1U;
+}
+
+/* 16 MB banks of all Flash devices touched by a write */
+static u32 BanksSpanned(u32 Address, u32 Len)
+{
+	return ((Address + Len - 1U) / BANK_SIZE) - (Address / BANK_SIZE) + 1U;
+}
+
+/************************** Tests ********************************************/
+
+typedef struct {
+	u32 Address;
+	u32 Len;
+} Range;
+
+/* Disjoint ranges crossing Pages, banks, dies and devices */
+static const Range Ranges[] = {
+	{ 0x00000010U, 1U },		/* Single byte */
+	{ 0x00000080U, 0x200U },	/* Unaligned, three Pages */
+	{ 0x00001000U, 0x10000U },	/* Aligned, 256 Pages */
+	{ 0x00FFFFF0U, 0x40U },		/* Across the 16 MB bank */
+	{ 0x01FFFF80U, 0x180U },	/* Across the dies */
+	{ 0x03FFFE00U, 0x180U },	/* Up to the last Page */
+	{ 0x03FFFFC0U, 0x90U },		/* Across the devices, stacked only */
+	{ 0x06123457U, 0x301U },	/* Upper device, stacked only */
+};
+
+static void TestRanges(u8 ConnectionMode, u8 TransferMode, const char *Name)
+{
+	XIsf_WriteParam Param;
+	u32 NumRanges = sizeof(Ranges) / sizeof(Ranges[0]);
+	u32 Pages = 0U;
+	u32 Bytes = 0U;
+	u32 Index;
+	int Status;
+
+	if (ConnectionMode != XQSPIPS_CONNECTION_MODE_STACKED)
+		NumRanges -= 2U;
+
+	Status = FlashInit(ConnectionMode, TransferMode);
+	CHECK(Status == XST_SUCCESS, "initialize failed");
+	CHECK(Isf.BytesPerPage == PAGE_SIZE, "wrong Page size");
+	CHECK(Isf.NumDie == 2U, "not detected as a two die part");
+
+	for (Index = 0U; Index < NumRanges; Index++) {
+		FillData(Index + 1U, Ranges[Index].Len);
+		Param.Address = Ranges[Index].Address;
+		Param.WritePtr = Data;
+		Param.NumBytes = Ranges[Index].Len;
+
+		Sim.Programs = 0U;
+		Sim.BankSelects = 0U;
+		AppEvents = 0U;
+		Status = XIsf_Write(&Isf, XISF_MULTI_PAGE_WRITE, &Param);
+		CHECK(Status == XST_SUCCESS, "multi Page write failed");
+		CHECK(Matches(Ranges[Index].Address, Ranges[Index].Len),
+			"Flash contents differ");
+		CHECK(Sim.Programs == PagesSpanned(Ranges[Index].Address,
+					Ranges[Index].Len),
+			"not one program command per Page");
+		CHECK(Sim.BankSelects == BanksSpanned(Ranges[Index].Address,
+					Ranges[Index].Len),
+			"not one bank select per 16 MB");
+		if (TransferMode == XISF_INTERRUPT_MODE)
+			CHECK(AppEvents != 0U, "status handler not called");
+		Pages += Sim.Programs;
+		Bytes += Ranges[Index].Len;
+	}
+
+	CHECK(Sim.ProgrammedBytes == Bytes, "bytes programmed outside ranges");
+	CHECK(ProtocolErrors() == 0U, "SPI-NOR protocol error");
+	printf("%-24s %u ranges, %u Pages, protocol errors %u\n", Name,
+		NumRanges, Pages, ProtocolErrors());
+}
+
+static void TestInvalid(void)
+{
+	XIsf_WriteParam Param;
+
+	(void)FlashInit(XQSPIPS_CONNECTION_MODE_SINGLE, XISF_POLLING_MODE);
+	Param.Address = 0U;
+	Param.WritePtr = Data;
+	Param.NumBytes = 0U;
+	CHECK(XIsf_Write(&Isf, XISF_MULTI_PAGE_WRITE, &Param) == XST_FAILURE,
+		"empty write accepted");
+	Param.NumBytes = 16U;
+	Param.WritePtr = NULL;
+	CHECK(XIsf_Write(&Isf, XISF_MULTI_PAGE_WRITE, &Param) == XST_FAILURE,
+		"NULL buffer accepted");
+	CHECK(Sim.Programs == 0U, "program sent for an invalid write");
+}
+
+typedef struct {
+	u64 SimNs;
+	u32 Transfers;
+	u32 BankSelects;
+	double HostSec;
+} Run;
+
+static Run TimedWrite(int MultiPage, u8 ConnectionMode, u8 TransferMode,
+			u32 Address, u32 Len)
+{
+	XIsf_WriteParam Param;
+	struct timespec T0;
+	struct timespec T1;
+	Run Result;
+	u32 Offset;
+	int Status = XST_SUCCESS;
+
+	(void)FlashInit(ConnectionMode, TransferMode);
+	FillData(Len, Len);
+	Sim.Now = 0U;
+	Sim.Transfers = 0U;
+
+	clock_gettime(CLOCK_MONOTONIC, &T0);
+	if (MultiPage) {
+		Param.Address = Address;
+		Param.WritePtr = Data;
+		Param.NumBytes = Len;
+		Status = XIsf_Write(&Isf, XISF_MULTI_PAGE_WRITE, &Param);
+	} else {
+		for (Offset = 0U; (Offset < Len) && (Status == XST_SUCCESS);
+				Offset += PAGE_SIZE) {
+			Param.Address = Address + Offset;
+			Param.WritePtr = &Data[Offset];
+			Param.NumBytes = PAGE_SIZE;
+			Status = XIsf_Write(&Isf, XISF_WRITE, &Param);
+		}
+	}
+	clock_gettime(CLOCK_MONOTONIC, &T1);
+
+	CHECK(Status == XST_SUCCESS, "timed write failed");
+	CHECK(Matches(Address, Len), "timed write contents differ");
+	CHECK(ProtocolErrors() == 0U, "SPI-NOR protocol error");
+
+	Result.SimNs = Sim.Now;
+	Result.Transfers = Sim.Transfers;
+	Result.BankSelects = Sim.BankSelects;
+	Result.HostSec = (double)(T1.tv_sec - T0.tv_sec) +
+			((double)(T1.tv_nsec - T0.tv_nsec) * 1e-9);
+	return Result;
+}
+
+static double KBps(u64 SimNs)
+{
+	return (double)MAX_WRITE / 1024.0 / ((double)SimNs * 1e-9);
+}
+
+static void PrintRun(const char *Name, const Run *Result)
+{
+	printf("  %-22s %7.1f KB/s simulated, %u transfers, "
+		"%u bank selects, %.3f s host\n", Name, KBps(Result->SimNs),
+		Result->Transfers, Result->BankSelects, Result->HostSec);
+}
+
+/* 256 KB within one 16 MB bank of one device */
+static void TestThroughput(u8 TransferMode, const char *Name)
+{
+	Run PageByPage = TimedWrite(0, XQSPIPS_CONNECTION_MODE_SINGLE,
+				TransferMode, 0x00FE0000U, MAX_WRITE);
+	Run MultiPage = TimedWrite(1, XQSPIPS_CONNECTION_MODE_SINGLE,
+				TransferMode, 0x00FE0000U, MAX_WRITE);
+	/*
+	 * Write enable and Extended Address Register write, always sent in
+	 * polled mode
+	 */
+	u64 BankSelectNs = (2U * XFER_OVERHEAD_NS) + (3U * BYTE_NS);
+	u64 SavedNs;
+
+	printf("single, %s:\n", Name);
+	PrintRun("XISF_WRITE per Page", &PageByPage);
+	PrintRun("XISF_MULTI_PAGE_WRITE", &MultiPage);
+
+	CHECK(PageByPage.BankSelects == (MAX_WRITE / PAGE_SIZE),
+		"Page by Page write did not select the bank per Page");
+	CHECK(MultiPage.BankSelects == BanksSpanned(0x00FE0000U, MAX_WRITE),
+		"multi Page write selected the bank more than once per 16 MB");
+	CHECK(MultiPage.SimNs < PageByPage.SimNs,
+		"multi Page write not faster than Page by Page");
+
+	/*
+	 * One Page is programmed at a time, so the time saved is the bank
+	 * selects skipped, less the status reads that happen to be needed in
+	 * addition when the Page is programmed earlier.
+	 */
+	SavedNs = (u64)(PageByPage.BankSelects - MultiPage.BankSelects) *
+			BankSelectNs;
+	CHECK((PageByPage.SimNs - MultiPage.SimNs) >= ((SavedNs * 9U) / 10U),
+		"multi Page write saves less than the skipped bank selects");
+	CHECK(MultiPage.SimNs >= (u64)(MAX_WRITE / PAGE_SIZE) * TPP_NS,
+		"faster than the Flash can program");
+}
+
+/* 256 KB across the two devices of a stacked connection, half in each */
+static void TestStackedThroughput(u8 TransferMode, const char *Name)
+{
+	u32 Address = DEVICE_SIZE - (MAX_WRITE / 2U);
+	Run PageByPage = TimedWrite(0, XQSPIPS_CONNECTION_MODE_STACKED,
+				TransferMode, Address, MAX_WRITE);
+	Run MultiPage = TimedWrite(1, XQSPIPS_CONNECTION_MODE_STACKED,
+				TransferMode, Address, MAX_WRITE);
+
+	printf("stacked, %s:\n", Name);
+	PrintRun("XISF_WRITE per Page", &PageByPage);
+	PrintRun("XISF_MULTI_PAGE_WRITE", &MultiPage);
+
+	/*
+	 * Both devices program at the same time, so the write takes little
+	 * more than the program time of the Pages of one device
+	 */
+	CHECK((MultiPage.SimNs * 10U) < (PageByPage.SimNs * 6U),
+		"stacked devices not programmed at the same time");
+	CHECK(MultiPage.SimNs >= (u64)(MAX_WRITE / PAGE_SIZE / 2U) * TPP_NS,
+		"faster than the Flash can program");
+}
+
+/************************** Main *********************************************/
+
+int main(void)
+{
+	TestRanges(XQSPIPS_CONNECTION_MODE_SINGLE, XISF_POLLING_MODE,
+		"single, polled");
+	TestRanges(XQSPIPS_CONNECTION_MODE_SINGLE, XISF_INTERRUPT_MODE,
+		"single, interrupt");
+	TestRanges(XQSPIPS_CONNECTION_MODE_STACKED, XISF_POLLING_MODE,
+		"stacked, polled");
+	TestRanges(XQSPIPS_CONNECTION_MODE_STACKED, XISF_INTERRUPT_MODE,
+		"stacked, interrupt");
+	TestInvalid();
+	TestThroughput(XISF_POLLING_MODE, "polled");
+	TestThroughput(XISF_INTERRUPT_MODE, "interrupt");
+	TestStackedThroughput(XISF_POLLING_MODE, "polled");
+	TestStackedThroughput(XISF_INTERRUPT_MODE, "interrupt");
+	SimReset();
+
+	printf("%s (%u failures)\n", Failures ? "FAILED" : "PASSED", Failures);
+	return (Failures ? 1 : 0);
+}
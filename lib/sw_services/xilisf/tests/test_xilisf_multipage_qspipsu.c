@@ -0,0 +1,688 @@
+/******************************************************************************
+* Copyright (C) 2020 Xilinx, Inc.  All rights reserved.
+* SPDX-License-Identifier: MIT
+******************************************************************************/
+
+/*****************************************************************************/
+/**
+*
+* @file test_xilisf_multipage_qspipsu.c
+*
+* Host test of the XISF_MULTI_PAGE_WRITE operation on the ZynqMP QSPI
+* controller. The library is built for the QSPIPSU interface against a
+* simulated two die Micron MT25QU512 in 4 byte address mode, behind a model
+* of the driver that executes the messages of a transfer, including the
+* status poll of the controller (XQSPIPSU_MSG_FLAG_POLL). The controller
+* polls only in interrupt mode, a poll in polled mode is counted as an
+* error. Protocol errors are counted instead of being silently accepted.
+*
+* The simulation keeps a clock that advances by the SPI transfer time of
+* every message, by the interrupt handling in interrupt mode, and by the
+* status reads of the controller while it polls. In interrupt mode the multi
+* Page write must use the controller poll, issue no status read transfers
+* and be faster than Page by Page writes, which poll by software. Across the
+* two devices of a stacked connection it must program both at the same
+* time.
+*
+* Build and run on the host:
+*   cc -Wall -O2 -I. -I../src -I../src/include \
+*      -I../../../../XilinxProcessorIPLib/drivers/qspipsu/src \
+*      -I../../../bsp/standalone/src/common \
+*      -I../../../bsp/standalone/src/arm/ARMv8/64bit \
+*      test_xilisf_multipage_qspipsu.c -o test_xilisf_multipage_qspipsu
+*   ./test_xilisf_multipage_qspipsu
+*
+******************************************************************************/
+
+/***************************** Include Files *********************************/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/* Build the standalone (non Linux) flavour of the library for QSPIPSU */
+#undef __linux__
+#define XISF_TEST_QSPIPSU
+#include "xil_types.h"
+
+/* The driver is modelled at the message level, without register accesses */
+#define XIL_IO_H
+#define INLINE inline
+static u32 Xil_In32(UINTPTR Addr);
+static void Xil_Out32(UINTPTR Addr, u32 Value);
+
+#define XIL_PRINTF_H
+#define xil_printf printf
+
+#include "xilisf.c"
+#include "xilisf_write.c"
+
+/************************** Simulated SPI-NOR ********************************/
+
+#define NUM_DEVICES		2U
+#define DEVICE_SIZE		0x4000000U	/* 512 Mbit */
+#define PAGE_SIZE		256U
+#define NUM_PAGES		(DEVICE_SIZE / PAGE_SIZE)
+
+#define JEDEC_MANUFACTURER	0x20U		/* Micron */
+#define JEDEC_TYPE		0xBBU		/* 1.8 V */
+#define JEDEC_CAPACITY		0x20U		/* 512 Mbit */
+
+#define CMD_ENTER_4BYTE		0xB7U
+
+/*
+ * Timing: 100 MHz single line SPI clock, 1 us of driver overhead per
+ * transfer, 2 us more for the interrupts of a transfer in interrupt mode and
+ * the typical Page program time of the MT25Q family. The controller poll
+ * reads one status byte per byte time and does not time out before 10 ms.
+ */
+#define BYTE_NS			80U
+#define XFER_OVERHEAD_NS	1000U
+#define XFER_IRQ_NS		2000U
+#define TPP_NS			120000U
+#define POLL_LIMIT_NS		10000000U
+
+#define SR_WIP			0x01U
+#define SR_WEL			0x02U
+#define FSR_READY		0x80U
+
+typedef struct {
+	u8 *Page[NUM_PAGES];	/* NULL while erased */
+	u8 Wel;
+	u8 Addr4;		/* 4 byte address mode */
+	u8 FsrPending;		/* Program done, flag status not read yet */
+	u8 Stuck;		/* Never completes a program */
+	u64 BusyUntil;
+} SimDevice;
+
+static struct {
+	SimDevice Dev[NUM_DEVICES];
+	u32 Cs;			/* Selected device */
+	u64 Now;		/* Simulated time in ns */
+	u32 Transfers;		/* Transfers started by software */
+	u32 StatusReads;	/* Status read transfers */
+	u32 PollTransfers;	/* Status polls by the controller */
+	u32 Programs;
+	u32 ProgrammedBytes;
+
+	/* Protocol errors */
+	u32 BusyViolations;	/* Command other than a status read while
+				 * busy */
+	u32 WelViolations;	/* Program without write enable */
+	u32 PageWraps;		/* Program running past the end of a Page */
+	u32 FsrSkipped;		/* Program before the flag status read */
+	u32 PolledPoll;		/* Controller poll in polled mode */
+	u32 Unknown;		/* Unknown or malformed command */
+
+	XQspiPsu_StatusHandler Handler;
+	void *HandlerRef;
+} Sim;
+
+static void SimReset(void)
+{
+	u32 Dev;
+	u32 Page;
+
+	for (Dev = 0U; Dev < NUM_DEVICES; Dev++) {
+		for (Page = 0U; Page < NUM_PAGES; Page++)
+			free(Sim.Dev[Dev].Page[Page]);
+	}
+	memset(&Sim, 0, sizeof(Sim));
+}
+
+static u8 SimByte(u32 Dev, u32 Addr)
+{
+	const u8 *Page = Sim.Dev[Dev].Page[Addr / PAGE_SIZE];
+
+	return (Page == NULL) ? 0xFFU : Page[Addr % PAGE_SIZE];
+}
+
+static int SimBusy(const SimDevice *DevPtr)
+{
+	return Sim.Now < DevPtr->BusyUntil;
+}
+
+static u8 SimStatus(SimDevice *DevPtr, u8 Cmd)
+{
+	int Busy = SimBusy(DevPtr);
+
+	if (Cmd == READ_FLAG_STATUS_CMD) {
+		if (!Busy)
+			DevPtr->FsrPending = 0U;
+		return Busy ? 0U : FSR_READY;
+	}
+	return (Busy ? SR_WIP : 0U) | (DevPtr->Wel ? SR_WEL : 0U);
+}
+
+static void SimProgram(SimDevice *DevPtr, const XQspiPsu_Msg *Msg,
+			u32 NumMsg)
+{
+	const u8 *Cmd = Msg[0].TxBfrPtr;
+	u32 AddrBytes = (DevPtr->Addr4 != 0U) ? 4U : 3U;
+	u32 Addr = 0U;
+	u32 Len;
+	u32 Index;
+	u8 *Page;
+
+	if ((NumMsg != 2U) || (Msg[0].ByteCount != (1U + AddrBytes)) ||
+		((Msg[1].Flags & XQSPIPSU_MSG_FLAG_TX) == 0U)) {
+		Sim.Unknown++;
+		return;
+	}
+	if (DevPtr->Wel == 0U) {
+		Sim.WelViolations++;
+		return;
+	}
+	if (DevPtr->FsrPending != 0U)
+		Sim.FsrSkipped++;
+
+	for (Index = 1U; Index <= AddrBytes; Index++)
+		Addr = (Addr << 8) | Cmd[Index];
+	Len = Msg[1].ByteCount;
+	if (Addr >= DEVICE_SIZE) {
+		Sim.Unknown++;
+		return;
+	}
+	if (((Addr % PAGE_SIZE) + Len) > PAGE_SIZE)
+		Sim.PageWraps++;
+
+	Page = DevPtr->Page[Addr / PAGE_SIZE];
+	if (Page == NULL) {
+		Page = malloc(PAGE_SIZE);
+		memset(Page, 0xFF, PAGE_SIZE);
+		DevPtr->Page[Addr / PAGE_SIZE] = Page;
+	}
+
+	/* Programming only clears bits, the address wraps within the Page */
+	for (Index = 0U; Index < Len; Index++)
+		Page[(Addr + Index) % PAGE_SIZE] &= Msg[1].TxBfrPtr[Index];
+
+	Sim.Programs++;
+	Sim.ProgrammedBytes += Len;
+	DevPtr->Wel = 0U;
+	DevPtr->FsrPending = 1U;
+	DevPtr->BusyUntil = (DevPtr->Stuck != 0U) ? ~(u64)0U :
+				(Sim.Now + TPP_NS);
+}
+
+/* Status poll of the controller, returns the event of its interrupt */
+static u32 SimControllerPoll(const XQspiPsu_Msg *Msg)
+{
+	SimDevice *DevPtr = &Sim.Dev[Sim.Cs];
+	u8 Care = (u8)~Msg->PollBusMask;
+	u64 Start;
+	u8 Status;
+
+	Sim.Transfers++;
+	Sim.PollTransfers++;
+	Sim.Now += XFER_OVERHEAD_NS + BYTE_NS;
+	Start = Sim.Now;
+	do {
+		Sim.Now += BYTE_NS;
+		Status = SimStatus(DevPtr, Msg->PollStatusCmd);
+		if ((Sim.Now - Start) > POLL_LIMIT_NS) {
+			Sim.Now += XFER_IRQ_NS;
+			return XST_FLASH_TIMEOUT_ERROR;
+		}
+	} while ((Status & Care) != (Msg->PollData & Care));
+
+	if (Msg->RxBfrPtr != NULL)
+		Msg->RxBfrPtr[0] = Status;
+	Sim.Now += XFER_IRQ_NS;
+	return XST_SPI_POLL_DONE;
+}
+
+static void SimTransfer(const XQspiPsu_Msg *Msg, u32 NumMsg, int Irq)
+{
+	SimDevice *DevPtr = &Sim.Dev[Sim.Cs];
+	u32 Bytes = 0U;
+	u32 Index;
+	u8 Cmd;
+	u8 Status;
+
+	for (Index = 0U; Index < NumMsg; Index++)
+		Bytes += Msg[Index].ByteCount;
+	Sim.Transfers++;
+	Sim.Now += XFER_OVERHEAD_NS + ((u64)Bytes * BYTE_NS);
+
+	if (((Msg[0].Flags & XQSPIPSU_MSG_FLAG_TX) == 0U) ||
+			(Msg[0].TxBfrPtr == NULL)) {
+		Sim.Unknown++;
+		goto Done;
+	}
+	Cmd = Msg[0].TxBfrPtr[0];
+	if (SimBusy(DevPtr) && (Cmd != READ_STATUS_CMD) &&
+			(Cmd != READ_FLAG_STATUS_CMD)) {
+		Sim.BusyViolations++;
+		goto Done;
+	}
+
+	switch (Cmd) {
+	case READ_ID:
+		if ((NumMsg == 2U) && (Msg[1].ByteCount >= 3U)) {
+			Msg[1].RxBfrPtr[0] = JEDEC_MANUFACTURER;
+			Msg[1].RxBfrPtr[1] = JEDEC_TYPE;
+			Msg[1].RxBfrPtr[2] = JEDEC_CAPACITY;
+		}
+		break;
+	case WRITE_ENABLE_CMD:
+		DevPtr->Wel = 1U;
+		break;
+	case XISF_CMD_DISABLE_WRITE:
+		DevPtr->Wel = 0U;
+		break;
+	case CMD_ENTER_4BYTE:
+		if (DevPtr->Wel == 0U)
+			Sim.WelViolations++;
+		DevPtr->Addr4 = 1U;
+		DevPtr->Wel = 0U;
+		break;
+	case READ_STATUS_CMD:
+	case READ_FLAG_STATUS_CMD:
+		Sim.StatusReads++;
+		Status = SimStatus(DevPtr, Cmd);
+		if (NumMsg == 2U) {
+			for (Index = 0U; Index < Msg[1].ByteCount; Index++)
+				Msg[1].RxBfrPtr[Index] = Status;
+		}
+		break;
+	case XISF_CMD_PAGEPROG_WRITE:
+		SimProgram(DevPtr, Msg, NumMsg);
+		break;
+	default:
+		Sim.Unknown++;
+		break;
+	}
+
+Done:
+	if (Irq)
+		Sim.Now += XFER_IRQ_NS;
+}
+
+/************************** QSPIPSU Driver Stubs *****************************/
+
+/* No register is accessed, the transfers are modelled as a whole */
+static u32 Xil_In32(UINTPTR Addr)
+{
+	(void)Addr;
+	return 0U;
+}
+
+static void Xil_Out32(UINTPTR Addr, u32 Value)
+{
+	(void)Addr;
+	(void)Value;
+}
+
+s32 XQspiPsu_PolledTransfer(XQspiPsu *InstancePtr, XQspiPsu_Msg *Msg,
+				u32 NumMsg)
+{
+	(void)InstancePtr;
+	if ((Msg[0].Flags & XQSPIPSU_MSG_FLAG_POLL) != 0U) {
+		Sim.PolledPoll++;
+		return XST_FAILURE;
+	}
+	SimTransfer(Msg, NumMsg, 0);
+	return XST_SUCCESS;
+}
+
+/* Completes at once and calls the status handler like the interrupt would */
+s32 XQspiPsu_InterruptTransfer(XQspiPsu *InstancePtr, XQspiPsu_Msg *Msg,
+				u32 NumMsg)
+{
+	u32 Event = XST_SPI_TRANSFER_DONE;
+
+	(void)InstancePtr;
+	if ((Msg[0].Flags & XQSPIPSU_MSG_FLAG_POLL) != 0U)
+		Event = SimControllerPoll(&Msg[0]);
+	else
+		SimTransfer(Msg, NumMsg, 1);
+	if (Sim.Handler != NULL)
+		Sim.Handler(Sim.HandlerRef, Event, 0U);
+	return XST_SUCCESS;
+}
+
+void XQspiPsu_SelectFlash(XQspiPsu *InstancePtr, u8 FlashCS, u8 FlashBus)
+{
+	(void)InstancePtr;
+	(void)FlashBus;
+	Sim.Cs = (FlashCS == XQSPIPSU_SELECT_FLASH_CS_UPPER) ? 1U : 0U;
+}
+
+s32 XQspiPsu_SetOptions(XQspiPsu *InstancePtr, u32 Options)
+{
+	(void)InstancePtr;
+	(void)Options;
+	return XST_SUCCESS;
+}
+
+s32 XQspiPsu_SetClkPrescaler(const XQspiPsu *InstancePtr, u8 Prescaler)
+{
+	(void)InstancePtr;
+	(void)Prescaler;
+	return XST_SUCCESS;
+}
+
+void XQspiPsu_SetStatusHandler(XQspiPsu *InstancePtr, void *CallBackRef,
+				XQspiPsu_StatusHandler FuncPtr)
+{
+	(void)InstancePtr;
+	Sim.HandlerRef = CallBackRef;
+	Sim.Handler = FuncPtr;
+}
+
+u32 Xil_AssertStatus;
+s32 Xil_AssertWait;
+
+void Xil_Assert(const char8 *File, s32 Line)
+{
+	printf("ASSERT %s:%d\n", File, (int)Line);
+}
+
+/************************** Test Helpers *************************************/
+
+static u32 Failures;
+
+#define CHECK(Cond, Msg) \
+	do { \
+		if (!(Cond)) { \
+			printf("FAIL line %d: %s\n", __LINE__, Msg); \
+			Failures++; \
+		} \
+	} while (0)
+
+#define MAX_WRITE	0x40000U
+
+static XIsf Isf;
+static XQspiPsu Qspi;
+static u8 IsfWriteBuf[PAGE_SIZE + XISF_CMD_SEND_EXTRA_BYTES_4BYTE_MODE];
+static u8 Data[MAX_WRITE];
+static u32 AppEvents;
+static u32 AppErrors;
+
+static void AppHandler(void *CallBackRef, u32 StatusEvent,
+			unsigned int ByteCount)
+{
+	(void)CallBackRef;
+	(void)ByteCount;
+	AppEvents++;
+	if (StatusEvent != XST_SPI_TRANSFER_DONE)
+		AppErrors++;
+}
+
+static int FlashInit(u8 ConnectionMode, u8 TransferMode)
+{
+	int Status;
+
+	SimReset();
+	memset(&Isf, 0, sizeof(Isf));
+	memset(&Qspi, 0, sizeof(Qspi));
+	Qspi.Config.ConnectionMode = ConnectionMode;
+	Qspi.IsReady = XIL_COMPONENT_IS_READY;
+
+	Status = XIsf_Initialize(&Isf, &Qspi, 0, IsfWriteBuf);
+	if (Status != XST_SUCCESS)
+		return Status;
+
+	XIsf_SetStatusHandler(&Isf, &Qspi, AppHandler);
+	XIsf_SetTransferMode(&Isf, TransferMode);
+	return XST_SUCCESS;
+}
+
+static u32 ProtocolErrors(void)
+{
+	return Sim.BusyViolations + Sim.WelViolations + Sim.PageWraps +
+		Sim.FsrSkipped + Sim.PolledPoll + Sim.Unknown;
+}
+
+static void FillData(u32 Seed, u32 Len)
+{
+	u32 Index;
+
+	for (Index = 0U; Index < Len; Index++) {
+		Seed = (Seed * 1103515245U) + 12345U;
+		Data[Index] = (u8)(Seed >> 16);
+	}
+}
+
+static int Matches(u32 Address, u32 Len)
+{
+	u32 Index;
+	u32 Addr;
+	u32 Dev;
+
+	for (Index = 0U; Index < Len; Index++) {
+		Addr = Address + Index;
+		Dev = Addr / DEVICE_SIZE;
+		if (SimByte(Dev, Addr % DEVICE_SIZE) != Data[Index])
+			return 0;
+	}
+	return 1;
+}
+
+/*
+ * The write must not return before it has read each Flash ready after its
+ * last Page, which also reads the flag status register
+ */
+static int FlashIdle(void)
+{
+	u32 Dev;
+
+	for (Dev = 0U; Dev < NUM_DEVICES; Dev++) {
+		if (SimBusy(&Sim.Dev[Dev]) || (Sim.Dev[Dev].FsrPending != 0U))
+			return 0;
+	}
+	return 1;
+}
+
+static u32 PagesSpanned(u32 Address, u32 Len)
+{
+	return ((Address + Len - 1U) / PAGE_SIZE) - (Address / PAGE_SIZE) + 1U;
+}
+
+/************************** Tests ********************************************/
+
+typedef struct {
+	u32 Address;
+	u32 Len;
+} Range;
+
+/* Disjoint ranges crossing Pages, dies and devices */
+static const Range Ranges[] = {
+	{ 0x00000010U, 1U },		/* Single byte */
+	{ 0x00000080U, 0x200U },	/* Unaligned, three Pages */
+	{ 0x00001000U, 0x10000U },	/* Aligned, 256 Pages */
+	{ 0x00FFFFF0U, 0x40U },		/* Across 16 MB */
+	{ 0x01FFFF80U, 0x180U },	/* Across the dies */
+	{ 0x03FFFE00U, 0x180U },	/* Up to the last Page */
+	{ 0x03FFFF80U, 0x1090U },	/* Across the devices, stacked only */
+	{ 0x06123457U, 0x301U },	/* Upper device, stacked only */
+};
+
+static void TestRanges(u8 ConnectionMode, u8 TransferMode, const char *Name)
+{
+	XIsf_WriteParam Param;
+	u32 NumRanges = sizeof(Ranges) / sizeof(Ranges[0]);
+	u32 Pages = 0U;
+	u32 Bytes = 0U;
+	u32 Index;
+	int Status;
+
+	if (ConnectionMode != XQSPIPSU_CONNECTION_MODE_STACKED)
+		NumRanges -= 2U;
+
+	Status = FlashInit(ConnectionMode, TransferMode);
+	CHECK(Status == XST_SUCCESS, "initialize failed");
+	CHECK(Isf.BytesPerPage == PAGE_SIZE, "wrong Page size");
+	CHECK(Isf.NumDie == 2U, "not detected as a two die part");
+	CHECK(Sim.Dev[0].Addr4 != 0U, "not in 4 byte address mode");
+	CHECK((ConnectionMode != XQSPIPSU_CONNECTION_MODE_STACKED) ||
+		(Sim.Dev[1].Addr4 != 0U),
+		"upper Flash not in 4 byte address mode");
+
+	for (Index = 0U; Index < NumRanges; Index++) {
+		FillData(Index + 1U, Ranges[Index].Len);
+		Param.Address = Ranges[Index].Address;
+		Param.WritePtr = Data;
+		Param.NumBytes = Ranges[Index].Len;
+
+		Sim.Programs = 0U;
+		Sim.StatusReads = 0U;
+		Sim.PollTransfers = 0U;
+		AppEvents = 0U;
+		AppErrors = 0U;
+		Status = XIsf_Write(&Isf, XISF_MULTI_PAGE_WRITE, &Param);
+		CHECK(Status == XST_SUCCESS, "multi Page write failed");
+		CHECK(FlashIdle(), "write returned before the Flash was ready");
+		CHECK(Matches(Ranges[Index].Address, Ranges[Index].Len),
+			"Flash contents differ");
+		CHECK(Sim.Programs == PagesSpanned(Ranges[Index].Address,
+					Ranges[Index].Len),
+			"not one program command per Page");
+		if (TransferMode == XISF_INTERRUPT_MODE) {
+			CHECK(Sim.StatusReads == 0U,
+				"status read by software in interrupt mode");
+			CHECK(Sim.PollTransfers == Sim.Programs,
+				"not one controller poll per Page");
+			CHECK((AppEvents != 0U) && (AppErrors == 0U),
+				"status handler not called with transfer done");
+		} else {
+			CHECK(Sim.PollTransfers == 0U,
+				"controller poll in polled mode");
+		}
+		Pages += Sim.Programs;
+		Bytes += Ranges[Index].Len;
+	}
+
+	CHECK(Sim.ProgrammedBytes == Bytes, "bytes programmed outside ranges");
+	CHECK(ProtocolErrors() == 0U, "SPI-NOR protocol error");
+	printf("%-24s %u ranges, %u Pages, protocol errors %u\n", Name,
+		NumRanges, Pages, ProtocolErrors());
+}
+
+/* A Flash that never gets ready must fail the write on the poll timeout */
+static void TestPollTimeout(void)
+{
+	XIsf_WriteParam Param;
+
+	(void)FlashInit(XQSPIPSU_CONNECTION_MODE_SINGLE, XISF_INTERRUPT_MODE);
+	Sim.Dev[0].Stuck = 1U;
+	FillData(1U, 3U * PAGE_SIZE);
+	Param.Address = 0U;
+	Param.WritePtr = Data;
+	Param.NumBytes = 3U * PAGE_SIZE;
+	CHECK(XIsf_Write(&Isf, XISF_MULTI_PAGE_WRITE, &Param) == XST_FAILURE,
+		"write succeeded on a poll timeout");
+	CHECK(Sim.Programs == 1U, "next Page sent after a poll timeout");
+}
+
+typedef struct {
+	u64 SimNs;
+	u32 Transfers;
+	u32 StatusReads;
+} Run;
+
+static Run TimedWrite(int MultiPage, u8 ConnectionMode, u32 Address,
+			u32 Len)
+{
+	XIsf_WriteParam Param;
+	Run Result;
+	u32 Offset;
+	int Status = XST_SUCCESS;
+
+	(void)FlashInit(ConnectionMode, XISF_INTERRUPT_MODE);
+	FillData(Len, Len);
+	Sim.Now = 0U;
+	Sim.Transfers = 0U;
+	Sim.StatusReads = 0U;
+
+	if (MultiPage) {
+		Param.Address = Address;
+		Param.WritePtr = Data;
+		Param.NumBytes = Len;
+		Status = XIsf_Write(&Isf, XISF_MULTI_PAGE_WRITE, &Param);
+	} else {
+		for (Offset = 0U; (Offset < Len) && (Status == XST_SUCCESS);
+				Offset += PAGE_SIZE) {
+			Param.Address = Address + Offset;
+			Param.WritePtr = &Data[Offset];
+			Param.NumBytes = PAGE_SIZE;
+			Status = XIsf_Write(&Isf, XISF_WRITE, &Param);
+		}
+	}
+
+	CHECK(Status == XST_SUCCESS, "timed write failed");
+	CHECK(FlashIdle(), "timed write returned before the Flash was ready");
+	CHECK(Matches(Address, Len), "timed write contents differ");
+	CHECK(ProtocolErrors() == 0U, "SPI-NOR protocol error");
+
+	Result.SimNs = Sim.Now;
+	Result.Transfers = Sim.Transfers;
+	Result.StatusReads = Sim.StatusReads;
+	return Result;
+}
+
+static double KBps(u64 SimNs)
+{
+	return (double)MAX_WRITE / 1024.0 / ((double)SimNs * 1e-9);
+}
+
+static void PrintRun(const char *Name, const Run *Result)
+{
+	printf("  %-22s %7.1f KB/s simulated, %u transfers, "
+		"%u status reads\n", Name, KBps(Result->SimNs),
+		Result->Transfers, Result->StatusReads);
+}
+
+static void TestThroughput(u8 ConnectionMode, u32 Address, const char *Name)
+{
+	Run PageByPage = TimedWrite(0, ConnectionMode, Address, MAX_WRITE);
+	Run MultiPage = TimedWrite(1, ConnectionMode, Address, MAX_WRITE);
+	u32 Pages = MAX_WRITE / PAGE_SIZE;
+
+	printf("%s, interrupt:\n", Name);
+	PrintRun("XISF_WRITE per Page", &PageByPage);
+	PrintRun("XISF_MULTI_PAGE_WRITE", &MultiPage);
+
+	/* Write enable, program and controller poll per Page */
+	CHECK(MultiPage.StatusReads == 0U, "status read by software");
+	CHECK(MultiPage.Transfers == (3U * Pages),
+		"not three transfers per Page");
+	CHECK(MultiPage.SimNs < PageByPage.SimNs,
+		"multi Page write not faster than Page by Page");
+
+	if (ConnectionMode == XQSPIPSU_CONNECTION_MODE_STACKED) {
+		/*
+		 * Both devices program at the same time, so the write takes
+		 * little more than the program time of the Pages of one
+		 * device
+		 */
+		CHECK((MultiPage.SimNs * 10U) < (PageByPage.SimNs * 6U),
+			"stacked devices not programmed at the same time");
+		Pages /= 2U;
+	}
+	CHECK(MultiPage.SimNs >= (u64)Pages * TPP_NS,
+		"faster than the Flash can program");
+}
+
+/************************** Main *********************************************/
+
+int main(void)
+{
+	TestRanges(XQSPIPSU_CONNECTION_MODE_SINGLE, XISF_POLLING_MODE,
+		"single, polled");
+	TestRanges(XQSPIPSU_CONNECTION_MODE_SINGLE, XISF_INTERRUPT_MODE,
+		"single, interrupt");
+	TestRanges(XQSPIPSU_CONNECTION_MODE_STACKED, XISF_POLLING_MODE,
+		"stacked, polled");
+	TestRanges(XQSPIPSU_CONNECTION_MODE_STACKED, XISF_INTERRUPT_MODE,
+		"stacked, interrupt");
+	TestPollTimeout();
+	TestThroughput(XQSPIPSU_CONNECTION_MODE_SINGLE, 0x00FE0000U, "single");
+	TestThroughput(XQSPIPSU_CONNECTION_MODE_STACKED,
+		DEVICE_SIZE - (MAX_WRITE / 2U), "stacked");
+	SimReset();
+
+	printf("%s (%u failures)\n", Failures ? "FAILED" : "PASSED", Failures);
+	return (Failures ? 1 : 0);
+}
@@ -0,0 +1,21 @@
+/******************************************************************************
+* Copyright (C) 2020 Xilinx, Inc.  All rights reserved.
+* SPDX-License-Identifier: MIT
+******************************************************************************/
+
+/*
+ * Library parameters used by the host tests: Micron/Spansion family Flash on
+ * the Zynq PS QSPI controller, or on the ZynqMP QSPI controller if the test
+ * defines XISF_TEST_QSPIPSU
+ */
+#ifndef XPARAMETERS_H
+#define XPARAMETERS_H
+
+#define XPAR_XISF_FLASH_FAMILY		5
+#ifdef XISF_TEST_QSPIPSU
+#define XPAR_XISF_INTERFACE_QSPIPSU	1
+#else
+#define XPAR_XISF_INTERFACE_PSQSPI	1
+#endif
+
+#endif
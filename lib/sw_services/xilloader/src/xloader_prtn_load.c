@@ -71,6 +71,10 @@
 #include "xplmi_err.h"
 
 /************************** Constant Definitions *****************************/
+/* PMC RAM buffers of non secure CDO chunks, as used by the CFI keyhole */
+#define XLOADER_CDO_STAGING_BUFS	(2U)
+#define XLOADER_CDO_STAGING_STRIDE	(XPLMI_PMCRAM_CHUNK_MEMORY_1 - \
+	XPLMI_PMCRAM_CHUNK_MEMORY)
 
 /**************************** Type Definitions *******************************/
 
@@ -556,6 +560,7 @@ static int XLoader_ProcessCdo(const XilPdi* PdiPtr, XLoader_DeviceCopy* DeviceCo
 	u32 PdiVer;
 	u32 ChunkAddr = XPLMI_PMCRAM_CHUNK_MEMORY;
 	u32 ChunkAddrTemp;
+	XLoader_StagingRing Ring;
 	u8 LastChunk = (u8)FALSE;
 	u8 IsNextChunkCopyStarted = (u8)FALSE;
 
@@ -594,17 +599,14 @@ static int XLoader_ProcessCdo(const XilPdi* PdiPtr, XLoader_DeviceCopy* DeviceCo
 	}
 
 	/*
-	 * Double buffering for secure cases is possible only
-	 * when available PRAM Size >= ChunkLen * 2
+	 * Non secure chunks alternate between the two PMC RAM buffers that
+	 * the CFI keyhole expects. Secure chunks go through the staging
+	 * buffers of the secure chunk pipeline.
 	 */
-	if ((SecureParams->IsDoubleBuffering == (u8)TRUE) &&
-		((ChunkLen * 2U) > XLOADER_CHUNK_SIZE)) {
-		/*
-		 * Blocking DMA will be used in case
-		 * DoubleBuffering is FALSE.
-		 */
-		SecureParams->IsDoubleBuffering = (u8)FALSE;
-	}
+	XLoader_StagingInit(&Ring, XPLMI_PMCRAM_CHUNK_MEMORY,
+		XLOADER_CDO_STAGING_BUFS * XLOADER_CDO_STAGING_STRIDE,
+		XLOADER_CDO_STAGING_STRIDE, XLOADER_CDO_STAGING_BUFS);
+	XLoader_SecureStagingInit(SecureParams, ChunkLen);
 
 	while (DeviceCopy->Len > 0U) {
 		/* Update the len for last chunk */
@@ -651,12 +653,7 @@ static int XLoader_ProcessCdo(const XilPdi* PdiPtr, XLoader_DeviceCopy* DeviceCo
 			if ((DeviceCopy->IsDoubleBuffering == (u8)TRUE)
 			    && (LastChunk != (u8)TRUE)) {
 				/* Update the next chunk address to other part */
-				if (ChunkAddr == XPLMI_PMCRAM_CHUNK_MEMORY) {
-					ChunkAddr = XPLMI_PMCRAM_CHUNK_MEMORY_1;
-				}
-				else {
-					ChunkAddr = XPLMI_PMCRAM_CHUNK_MEMORY;
-				}
+				ChunkAddr = XLoader_StagingNext(&Ring);
 
 				/* Update the len for last chunk */
 				if (DeviceCopy->Len <= ChunkLen) {
@@ -682,9 +679,6 @@ static int XLoader_ProcessCdo(const XilPdi* PdiPtr, XLoader_DeviceCopy* DeviceCo
 				goto END;
 			}
 
-			if (SecureParams->IsDoubleBuffering == (u8)TRUE) {
-				SecureParams->ChunkAddr = SecureParams->NextChunkAddr;
-			}
 			Cdo.BufPtr = (u32 *)SecureParams->SecureData;
 			Cdo.BufLen = SecureParams->SecureDataLen / XIH_PRTN_WORD_LEN;
 			DeviceCopy->SrcAddr += SecureParams->ProcessedLen;
@@ -707,12 +701,7 @@ static int XLoader_ProcessCdo(const XilPdi* PdiPtr, XLoader_DeviceCopy* DeviceCo
 				 */
 				ChunkAddrTemp = (ChunkAddr + Cdo.Cmd.KeyHoleParams.ExtraWords);
 				ChunkLenTemp = (ChunkLen - Cdo.Cmd.KeyHoleParams.ExtraWords);
-				if (ChunkAddr == XPLMI_PMCRAM_CHUNK_MEMORY) {
-					ChunkAddr = XPLMI_PMCRAM_CHUNK_MEMORY_1;
-				}
-				else {
-					ChunkAddr = XPLMI_PMCRAM_CHUNK_MEMORY;
-				}
+				ChunkAddr = XLoader_StagingNext(&Ring);
 				Status = XPlmi_DmaXfr(ChunkAddrTemp, ChunkAddr,
 						(ChunkLenTemp / XPLMI_WORD_LEN), XPLMI_PMCDMA_0);
 				if (Status != XST_SUCCESS) {
@@ -735,7 +724,8 @@ static int XLoader_ProcessCdo(const XilPdi* PdiPtr, XLoader_DeviceCopy* DeviceCo
 			}
 			else {
 				IsNextChunkCopyStarted = (u8)FALSE;
-				SecureParams->IsNextChunkCopyStarted = (u8)FALSE;
+				/* Chunks copied ahead are stale now */
+				XLoader_SecureStagingDrain(SecureParams);
 			}
 			Cdo.Cmd.KeyHoleParams.ExtraWords = 0x0U;
 		}
@@ -749,6 +739,8 @@ static int XLoader_ProcessCdo(const XilPdi* PdiPtr, XLoader_DeviceCopy* DeviceCo
 	Status = XST_SUCCESS;
 
 END:
+	/* Do not leave secure chunk copies running on failure */
+	XLoader_SecureStagingDrain(SecureParams);
 	return Status;
 }
 
@@ -146,8 +146,18 @@ static INLINE u32 XLoader_GetAuthPubAlgo(const u32 *AuthHdrPtr)
 
 /************************** Function Prototypes ******************************/
 
+static u32 XLoader_ChunkHashStart(XLoader_SecureParams *SecurePtr,
+	XSecure_Sha3 *Sha3InstPtr, XPmcDma *PmcDmaPtr, u32 Chunk);
 static u32 XLoader_VerifyHashNUpdateNext(XLoader_SecureParams *SecurePtr,
-	u32 Size, u8 Last);
+	u8 *Data, u32 Size, u8 Last, u8 *BlkHash);
+static u32 XLoader_StagingCopyStart(void *Ctx, u32 Chunk, u32 BufAddr,
+	u8 *Pending);
+static u32 XLoader_StagingCopyWait(void *Ctx, u32 Chunk, u32 BufAddr);
+static u32 XLoader_StagingHashStart(void *Ctx, u32 Chunk, u32 BufAddr,
+	u8 *Pending);
+static u32 XLoader_StagingHashWait(void *Ctx, u32 Chunk, u32 BufAddr);
+static void XLoader_StagingHashCancel(void *Ctx, u32 Chunk, u32 BufAddr);
+static u32 XLoader_StagingDecrypt(void *Ctx, u32 Chunk, u32 BufAddr);
 static u32 XLoader_SpkAuthentication(const XLoader_SecureParams *SecurePtr);
 static u32 XLoader_DataAuth(XLoader_SecureParams *SecurePtr, u8 *Hash,
 	u8 *Signature);
@@ -189,6 +199,15 @@ static int XLoader_CheckAuthJtagIntStatus(void *Arg);
 
 /************************** Variable Definitions *****************************/
 static XLoader_AuthCertificate AuthCert;
+static XSecure_Sha3 StagingSha3Instance;
+static const XLoader_StagingOps StagingOps = {
+	XLoader_StagingCopyStart,
+	XLoader_StagingCopyWait,
+	XLoader_StagingHashStart,
+	XLoader_StagingHashWait,
+	XLoader_StagingHashCancel,
+	XLoader_StagingDecrypt,
+};
 
 /************************** Function Definitions *****************************/
 
@@ -413,18 +432,8 @@ u32 XLoader_SecureCopy(XLoader_SecureParams *SecurePtr, u64 DestAddr, u32 Size)
 		ChunkLen = XLOADER_CHUNK_SIZE;
 	}
 
-	/*
-	 * Double buffering is possible only
-	 * when available PRAM Size >= ChunkLen * 2
-	 */
-	if ((SecurePtr->IsDoubleBuffering == (u8)TRUE) &&
-		((ChunkLen * 2U) > XLOADER_CHUNK_SIZE)) {
-		/*
-		 * Blocking DMA will be used in case
-		 * DoubleBuffering is FALSE.
-		 */
-		SecurePtr->IsDoubleBuffering = (u8)FALSE;
-	}
+	/* Chunks are copied ahead in the free staging buffers */
+	XLoader_SecureStagingInit(SecurePtr, ChunkLen);
 
 	while (Len > 0U) {
 		/* Update the length for last chunk */
@@ -445,10 +454,6 @@ u32 XLoader_SecureCopy(XLoader_SecureParams *SecurePtr, u64 DestAddr, u32 Size)
 		/* Update variables for next chunk */
 		LoadAddr = LoadAddr + SecurePtr->SecureDataLen;
 		Len = Len - SecurePtr->ProcessedLen;
-
-		if (SecurePtr->IsDoubleBuffering == (u8)TRUE) {
-			SecurePtr->ChunkAddr = SecurePtr->NextChunkAddr;
-		}
 	}
 
 END:
@@ -488,7 +493,6 @@ int XLoader_ProcessSecurePrtn(XLoader_SecureParams *SecurePtr, u64 DestAddr,
 	int ClrStatus = XST_FAILURE;
 	u32 TotalSize = BlockSize;
 	u64 SrcAddr;
-	u64 OutAddr;
 
 	XPlmi_Printf(DEBUG_DETAILED,
 			"Processing Block %d \n\r", SecurePtr->BlockNum);
@@ -543,82 +547,36 @@ int XLoader_ProcessSecurePrtn(XLoader_SecureParams *SecurePtr, u64 DestAddr,
 		}
 	}
 
-	if (SecurePtr->IsNextChunkCopyStarted == (u8)TRUE) {
-		SecurePtr->IsNextChunkCopyStarted = (u8)FALSE;
-			/* Wait for copy to get completed */
-		Status = SecurePtr->PdiPtr->DeviceCopy(SrcAddr,
-					SecurePtr->ChunkAddr,
-					TotalSize,
-					XPLMI_DEVICE_COPY_STATE_WAIT_DONE);
+	/*
+	 * Start copying from this block unless it is already being copied.
+	 * The number of chunks is known once the last one is copied.
+	 */
+	if ((SecurePtr->Pipe.Copied == SecurePtr->Pipe.Done) &&
+		(SecurePtr->Pipe.CopyPending == (u8)FALSE)) {
+		SecurePtr->CopySrcAddr = SrcAddr;
+		SecurePtr->CopyRemainingLen = SecurePtr->RemainingDataLen;
+		SecurePtr->CopyLen = TotalSize;
+		SecurePtr->CopyBlockLen = BlockSize;
+		SecurePtr->CopyLast = Last;
+		SecurePtr->Pipe.NumChunks = XLOADER_STAGING_MAX_CHUNKS;
 	}
 	else {
-			/* Copy the data to PRAM buffer */
-		Status = SecurePtr->PdiPtr->DeviceCopy(SrcAddr,
-					SecurePtr->ChunkAddr,
-					TotalSize,
-					XPLMI_DEVICE_COPY_STATE_BLK);
-	}
-	if (Status != XLOADER_SUCCESS) {
-		Status = XPlmi_UpdateStatus(
-				XLOADER_ERR_DATA_COPY_FAIL, Status);
-		goto END;
-	}
-
-	if ((SecurePtr->IsDoubleBuffering == (u8)TRUE) &&
-				(Last != (u8)TRUE)) {
-		Status = XLoader_StartNextChunkCopy(SecurePtr,
-					(SecurePtr->RemainingDataLen - TotalSize),
-					SrcAddr + TotalSize, BlockSize);
-		if (Status != XST_SUCCESS) {
+		if (SecurePtr->StagingLen[SecurePtr->Pipe.Done %
+			SecurePtr->Pipe.Ring.Bufs] != TotalSize) {
+			/* The block copied ahead is not the one to be processed */
+			Status = XPlmi_UpdateStatus(XLOADER_ERR_DATA_COPY_FAIL, 0);
 			goto END;
 		}
 	}
 
-	if ((SecurePtr->IsAuthenticated == (u8)TRUE) ||
-				(SecurePtr->IsAuthenticatedTmp == (u8)TRUE) ||
-				(SecurePtr->IsCheckSumEnabled == (u8)TRUE)) {
-		/* Verify hash */
-		XSECURE_TEMPORAL_CHECK(END, Status,
-					XLoader_VerifyHashNUpdateNext,
-					SecurePtr, TotalSize, Last);
-		if ((SecurePtr->IsEncrypted != (u8)TRUE) &&
-			(SecurePtr->IsCdo != (u8)TRUE)) {
-				/* Copy to destination address */
-			Status = XPlmi_DmaXfr((u64)SecurePtr->SecureData,
-							(u64)DestAddr,
-							SecurePtr->SecureDataLen / XIH_PRTN_WORD_LEN,
-							XPLMI_PMCDMA_0);
-			if (Status != XST_SUCCESS) {
-				Status = XPlmi_UpdateStatus(
-						XLOADER_ERR_DMA_TRANSFER, Status);
-				goto END;
-			}
-		}
-	}
-
-	/* If encryption is enabled */
-	if (SecurePtr->IsEncrypted == (u8)TRUE) {
-		if ((SecurePtr->IsAuthenticated != (u8)TRUE) ||
-			(SecurePtr->IsAuthenticatedTmp != (u8)TRUE)) {
-			SecurePtr->SecureData = SecurePtr->ChunkAddr;
-			SecurePtr->SecureDataLen = TotalSize;
-		}
-
-		if (SecurePtr->IsCdo != (u8)TRUE) {
-			OutAddr = DestAddr;
-		}
-		else {
-			OutAddr = SecurePtr->SecureData;
-		}
-		Status = XLoader_AesDecryption(SecurePtr,
-					SecurePtr->SecureData,
-					OutAddr,
-					SecurePtr->SecureDataLen);
-		if (Status != XLOADER_SUCCESS) {
-			Status = XPlmi_UpdateStatus(
-					XLOADER_ERR_PRTN_DECRYPT_FAIL, Status);
-			goto END;
-		}
+	/*
+	 * Copy, verify and decrypt the block. The following blocks are
+	 * copied and hashed meanwhile in the free staging buffers.
+	 */
+	SecurePtr->ChunkDestAddr = DestAddr;
+	Status = XLoader_StagingPipeNext(&SecurePtr->Pipe, &SecurePtr->ChunkAddr);
+	if (Status != XLOADER_SUCCESS) {
+		goto END;
 	}
 
 	SecurePtr->NextBlkAddr = SrcAddr + TotalSize;
@@ -628,7 +586,9 @@ int XLoader_ProcessSecurePrtn(XLoader_SecureParams *SecurePtr, u64 DestAddr,
 END:
 	/* Clears whole intermediate buffers on failure */
 	if (Status != XLOADER_SUCCESS) {
-		ClrStatus = XPlmi_InitNVerifyMem(SecurePtr->ChunkAddr, TotalSize);
+		XLoader_SecureStagingDrain(SecurePtr);
+		ClrStatus = XPlmi_InitNVerifyMem(SecurePtr->Pipe.Ring.BaseAddr,
+			SecurePtr->Pipe.Ring.Bufs * SecurePtr->Pipe.Ring.Stride);
 		if (ClrStatus != XST_SUCCESS) {
 			Status = Status | XLOADER_SEC_BUF_CLEAR_ERR;
 		}
@@ -641,54 +601,383 @@ END:
 
 /*****************************************************************************/
 /**
-* @brief	This function starts next chunk copy when security is enabled.
+* @brief	This function lays out the staging buffers for the given chunk
+* length and prepares the chunk pipeline of the partition. As many buffers
+* are used as fit between XLOADER_SECURE_STAGING_ADDR and
+* XLOADER_SECURE_STAGING_END, up to XLOADER_SECURE_STAGING_BUFS. Chunks are
+* copied ahead only if the boot device supports it and two buffers fit.
+*
+* Copies from QSPI and OSPI use the controller DMA and leave PMC DMA1 free,
+* so the next chunk of an Elf partition is hashed on PMC DMA1 while the
+* current one is decrypted on PMC DMA0. The other boot devices copy with
+* PMC DMA1 and their chunks are hashed on PMC DMA0 as before.
 *
 * @param	SecurePtr is pointer to the XLoader_SecureParams instance.
-* @param	TotalLen is total length of the partition.
-* @param	NextBlkAddr is the address of the next chunk data to be copied.
-* @param 	ChunkLen is size of the data block to be copied.
+* @param	ChunkLen is the length of the data in one chunk.
 *
-* @return	XLOADER_SUCCESS on success
-* 		XLOADER_FAILURE on failure
+* @return	None
 *
 ******************************************************************************/
-u32 XLoader_StartNextChunkCopy(XLoader_SecureParams *SecurePtr, u32 TotalLen,
-				u32 NextBlkAddr, u32 ChunkLen)
+void XLoader_SecureStagingInit(XLoader_SecureParams *SecurePtr, u32 ChunkLen)
+{
+	XLoader_StagingPipe *Pipe = &SecurePtr->Pipe;
+	u32 MaxBufs = XLOADER_SECURE_STAGING_BUFS;
+	PdiSrc_t PdiSrc = SecurePtr->PdiPtr->PdiSrc;
+
+	if (SecurePtr->IsDoubleBuffering != (u8)TRUE) {
+		/* Blocking DMA is used, so one buffer is enough */
+		MaxBufs = 1U;
+	}
+	XLoader_StagingInit(&Pipe->Ring, XLOADER_SECURE_STAGING_ADDR,
+		XLOADER_SECURE_STAGING_END - XLOADER_SECURE_STAGING_ADDR,
+		ChunkLen + XLOADER_SECURE_STAGING_MARGIN, MaxBufs);
+	XLoader_StagingPipeInit(Pipe, &StagingOps, SecurePtr, 0U);
+	SecurePtr->ChunkAddr = XLoader_StagingAddr(&Pipe->Ring, 0U);
+
+	if (Pipe->Ring.Bufs < 2U) {
+		/*
+		 * Blocking DMA will be used in case
+		 * DoubleBuffering is FALSE.
+		 */
+		SecurePtr->IsDoubleBuffering = (u8)FALSE;
+		goto END;
+	}
+
+	Pipe->DecryptDma = XPLMI_PMCDMA_0;
+	Pipe->HashDma = XPLMI_PMCDMA_0;
+	if ((PdiSrc == XLOADER_PDI_SRC_QSPI24) ||
+		(PdiSrc == XLOADER_PDI_SRC_QSPI32) ||
+		(PdiSrc == XLOADER_PDI_SRC_OSPI)) {
+		Pipe->CopyDma = 0U;
+	}
+	else {
+		Pipe->CopyDma = XPLMI_PMCDMA_1;
+	}
+
+	/*
+	 * CDO commands are read from the chunk until the next one is loaded.
+	 * Verifying the next chunk moves SecureData, so CDOs are not hashed
+	 * ahead.
+	 */
+	if ((Pipe->CopyDma == 0U) && (SecurePtr->IsCdo != (u8)TRUE)) {
+		Pipe->HashDma = XPLMI_PMCDMA_1;
+		Pipe->HashAhead = (u8)TRUE;
+	}
+
+END:
+	return;
+}
+
+/*****************************************************************************/
+/**
+* @brief	This function stops the copies and hashes started ahead, for
+* example when a CDO command reads the rest of the partition itself. The next
+* block is then copied again from XLoader_SecureParams NextBlkAddr.
+*
+* @param	SecurePtr is pointer to the XLoader_SecureParams instance.
+*
+* @return	None
+*
+******************************************************************************/
+void XLoader_SecureStagingDrain(XLoader_SecureParams *SecurePtr)
+{
+	XLoader_StagingPipeDrain(&SecurePtr->Pipe);
+}
+
+/*****************************************************************************/
+/**
+* @brief	This function starts the copy of the next chunk of the partition
+* into its staging buffer and moves the copy position to the chunk after it.
+*
+* @param	Ctx is pointer to the XLoader_SecureParams instance.
+* @param	Chunk is the chunk to be copied.
+* @param	BufAddr is the staging buffer of the chunk.
+* @param	Pending is set to TRUE if the copy continues in the background.
+*
+* @return	XLOADER_SUCCESS on success and error code on failure
+*
+******************************************************************************/
+static u32 XLoader_StagingCopyStart(void *Ctx, u32 Chunk, u32 BufAddr,
+	u8 *Pending)
 {
 	u32 Status = XLOADER_FAILURE;
-	u32 CopyLen = ChunkLen;
+	XLoader_SecureParams *SecurePtr = (XLoader_SecureParams *)Ctx;
+	u32 Len = SecurePtr->CopyLen;
+	u32 Flags = XPLMI_DEVICE_COPY_STATE_BLK;
 
-	if (SecurePtr->ChunkAddr == XPLMI_PMCRAM_CHUNK_MEMORY) {
-		SecurePtr->NextChunkAddr = XPLMI_PMCRAM_CHUNK_MEMORY_1;
+	if ((Len == 0U) || (Len > SecurePtr->Pipe.Ring.Stride)) {
+		Status = XPlmi_UpdateStatus(XLOADER_ERR_DATA_COPY_FAIL, 0);
+		goto END;
+	}
+
+	if (SecurePtr->IsDoubleBuffering == (u8)TRUE) {
+		Flags = XPLMI_DEVICE_COPY_STATE_INITIATE;
+		*Pending = (u8)TRUE;
+	}
+	Status = SecurePtr->PdiPtr->DeviceCopy(SecurePtr->CopySrcAddr, BufAddr,
+			Len, Flags);
+	if (Status != XLOADER_SUCCESS) {
+		*Pending = (u8)FALSE;
+		Status = XPlmi_UpdateStatus(XLOADER_ERR_DATA_COPY_FAIL, Status);
+		goto END;
+	}
+
+	SecurePtr->StagingLen[Chunk % SecurePtr->Pipe.Ring.Bufs] = Len;
+	if (SecurePtr->CopyLast == (u8)TRUE) {
+		SecurePtr->Pipe.NumChunks = Chunk + 1U;
+	}
+
+	/* Length of the chunk after this one */
+	SecurePtr->CopySrcAddr += Len;
+	if (Len < SecurePtr->CopyRemainingLen) {
+		SecurePtr->CopyRemainingLen -= Len;
 	}
 	else {
-		SecurePtr->NextChunkAddr = XPLMI_PMCRAM_CHUNK_MEMORY;
+		SecurePtr->CopyRemainingLen = 0U;
 	}
-	if (TotalLen <= ChunkLen) {
-		CopyLen = TotalLen;
+	if (SecurePtr->CopyRemainingLen <= SecurePtr->CopyBlockLen) {
+		SecurePtr->CopyLen = SecurePtr->CopyRemainingLen;
+		SecurePtr->CopyLast = (u8)TRUE;
 	}
 	else {
+		SecurePtr->CopyLen = SecurePtr->CopyBlockLen;
 		if ((SecurePtr->IsAuthenticated == (u8)TRUE) ||
 			(SecurePtr->IsCheckSumEnabled == (u8)TRUE)) {
-			CopyLen = CopyLen + XLOADER_SHA3_LEN;
+			SecurePtr->CopyLen += XLOADER_SHA3_LEN;
 		}
 	}
 
-	SecurePtr->IsNextChunkCopyStarted = (u8)TRUE;
+END:
+	return Status;
+}
+
+/*****************************************************************************/
+/**
+* @brief	This function waits for the copy of a chunk started in the
+* background.
+*
+* @param	Ctx is pointer to the XLoader_SecureParams instance.
+* @param	Chunk is the chunk being copied.
+* @param	BufAddr is the staging buffer of the chunk.
+*
+* @return	XLOADER_SUCCESS on success and error code on failure
+*
+******************************************************************************/
+static u32 XLoader_StagingCopyWait(void *Ctx, u32 Chunk, u32 BufAddr)
+{
+	u32 Status = XLOADER_FAILURE;
+	XLoader_SecureParams *SecurePtr = (XLoader_SecureParams *)Ctx;
 
-	/* Initiate the data copy */
-	Status = SecurePtr->PdiPtr->DeviceCopy(NextBlkAddr,
-			SecurePtr->NextChunkAddr,
-			CopyLen,
-			XPLMI_DEVICE_COPY_STATE_INITIATE);
+	Status = SecurePtr->PdiPtr->DeviceCopy(SecurePtr->CopySrcAddr, BufAddr,
+			SecurePtr->StagingLen[Chunk % SecurePtr->Pipe.Ring.Bufs],
+			XPLMI_DEVICE_COPY_STATE_WAIT_DONE);
 	if (Status != XLOADER_SUCCESS) {
-		Status = XPlmi_UpdateStatus(
-			XLOADER_ERR_DATA_COPY_FAIL, Status);
+		Status = XPlmi_UpdateStatus(XLOADER_ERR_DATA_COPY_FAIL, Status);
 	}
 
 	return Status;
 }
 
+/*****************************************************************************/
+/**
+* @brief	This function starts the hash of a chunk. It is computed in the
+* background on PMC DMA1 if the pipeline hashes ahead, else it is computed
+* and verified at once on PMC DMA0. The first chunk of an authenticated
+* partition is always verified at once since its hash includes the
+* authentication certificate and is checked with the signature.
+*
+* @param	Ctx is pointer to the XLoader_SecureParams instance.
+* @param	Chunk is the chunk to be hashed.
+* @param	BufAddr is the staging buffer of the chunk.
+* @param	Pending is set to TRUE if the hash continues in the background.
+*
+* @return	XLOADER_SUCCESS on success and error code on failure
+*
+******************************************************************************/
+static u32 XLoader_StagingHashStart(void *Ctx, u32 Chunk, u32 BufAddr,
+	u8 *Pending)
+{
+	volatile u32 Status = XLOADER_FAILURE;
+	XLoader_SecureParams *SecurePtr = (XLoader_SecureParams *)Ctx;
+	u32 Size = SecurePtr->StagingLen[Chunk % SecurePtr->Pipe.Ring.Bufs];
+	u8 Last = (u8)(Chunk == (SecurePtr->Pipe.NumChunks - 1U));
+	XPmcDma *PmcDmaPtr = SecurePtr->PmcDmaInstPtr;
+	XSecure_Sha3Hash BlkHash = {0U};
+
+	if ((SecurePtr->IsAuthenticated != (u8)TRUE) &&
+		(SecurePtr->IsAuthenticatedTmp != (u8)TRUE) &&
+		(SecurePtr->IsCheckSumEnabled != (u8)TRUE)) {
+		/* Nothing to verify */
+		Status = XLOADER_SUCCESS;
+		goto END;
+	}
+
+	if ((SecurePtr->Pipe.HashAhead == (u8)TRUE) && (Chunk != 0U)) {
+		PmcDmaPtr = XPlmi_GetDmaInstance((u32)PMCDMA_1_DEVICE_ID);
+	}
+	Status = XLoader_ChunkHashStart(SecurePtr, &StagingSha3Instance,
+			PmcDmaPtr, Chunk);
+	if (Status != XLOADER_SUCCESS) {
+		goto END;
+	}
+
+	if ((SecurePtr->Pipe.HashAhead == (u8)TRUE) && (Chunk != 0U)) {
+		Status = (u32)XSecure_Sha3UpdateNonBlk(&StagingSha3Instance,
+				(UINTPTR)BufAddr, Size);
+		if (Status != XLOADER_SUCCESS) {
+			Status = XPlmi_UpdateStatus(XLOADER_ERR_PRTN_HASH_CALC_FAIL,
+				Status);
+			goto END;
+		}
+		*Pending = (u8)TRUE;
+		goto END;
+	}
+
+	Status = XSecure_Sha3Update(&StagingSha3Instance, (UINTPTR)BufAddr, Size);
+	if (Status != XLOADER_SUCCESS) {
+		Status = XPlmi_UpdateStatus(XLOADER_ERR_PRTN_HASH_CALC_FAIL, Status);
+		goto END;
+	}
+	Status = XSecure_Sha3Finish(&StagingSha3Instance, &BlkHash);
+	if (Status != XLOADER_SUCCESS) {
+		Status = XPlmi_UpdateStatus(XLOADER_ERR_PRTN_HASH_CALC_FAIL, Status);
+		goto END;
+	}
+
+	XSECURE_TEMPORAL_CHECK(END, Status, XLoader_VerifyHashNUpdateNext,
+		SecurePtr, (u8 *)BufAddr, Size, Last, BlkHash.Hash);
+
+END:
+	return Status;
+}
+
+/*****************************************************************************/
+/**
+* @brief	This function waits for the hash of a chunk started in the
+* background and verifies it.
+*
+* @param	Ctx is pointer to the XLoader_SecureParams instance.
+* @param	Chunk is the chunk being hashed.
+* @param	BufAddr is the staging buffer of the chunk.
+*
+* @return	XLOADER_SUCCESS on success and error code on failure
+*
+******************************************************************************/
+static u32 XLoader_StagingHashWait(void *Ctx, u32 Chunk, u32 BufAddr)
+{
+	volatile u32 Status = XLOADER_FAILURE;
+	XLoader_SecureParams *SecurePtr = (XLoader_SecureParams *)Ctx;
+	u32 Size = SecurePtr->StagingLen[Chunk % SecurePtr->Pipe.Ring.Bufs];
+	u8 Last = (u8)(Chunk == (SecurePtr->Pipe.NumChunks - 1U));
+	XSecure_Sha3Hash BlkHash = {0U};
+
+	Status = (u32)XSecure_Sha3WaitForUpdate(&StagingSha3Instance);
+	if (Status != XLOADER_SUCCESS) {
+		Status = XPlmi_UpdateStatus(XLOADER_ERR_PRTN_HASH_CALC_FAIL, Status);
+		goto END;
+	}
+	Status = XSecure_Sha3Finish(&StagingSha3Instance, &BlkHash);
+	if (Status != XLOADER_SUCCESS) {
+		Status = XPlmi_UpdateStatus(XLOADER_ERR_PRTN_HASH_CALC_FAIL, Status);
+		goto END;
+	}
+
+	XSECURE_TEMPORAL_CHECK(END, Status, XLoader_VerifyHashNUpdateNext,
+		SecurePtr, (u8 *)BufAddr, Size, Last, BlkHash.Hash);
+
+END:
+	return Status;
+}
+
+/*****************************************************************************/
+/**
+* @brief	This function waits for a background hash without verifying it.
+*
+* @param	Ctx is pointer to the XLoader_SecureParams instance.
+* @param	Chunk is the chunk being hashed.
+* @param	BufAddr is the staging buffer of the chunk.
+*
+* @return	None
+*
+******************************************************************************/
+static void XLoader_StagingHashCancel(void *Ctx, u32 Chunk, u32 BufAddr)
+{
+	(void)Ctx;
+	(void)Chunk;
+	(void)BufAddr;
+
+	(void)XSecure_Sha3WaitForUpdate(&StagingSha3Instance);
+}
+
+/*****************************************************************************/
+/**
+* @brief	This function loads a verified chunk. Encrypted chunks are
+* decrypted to the load address, or in place for CDOs, and authenticated
+* chunks are copied to the load address.
+*
+* @param	Ctx is pointer to the XLoader_SecureParams instance.
+* @param	Chunk is the chunk to be loaded.
+* @param	BufAddr is the staging buffer of the chunk.
+*
+* @return	XLOADER_SUCCESS on success and error code on failure
+*
+******************************************************************************/
+static u32 XLoader_StagingDecrypt(void *Ctx, u32 Chunk, u32 BufAddr)
+{
+	u32 Status = XLOADER_FAILURE;
+	XLoader_SecureParams *SecurePtr = (XLoader_SecureParams *)Ctx;
+	u64 OutAddr;
+
+	SecurePtr->ChunkAddr = BufAddr;
+	if (((SecurePtr->IsAuthenticated == (u8)TRUE) ||
+		(SecurePtr->IsAuthenticatedTmp == (u8)TRUE) ||
+		(SecurePtr->IsCheckSumEnabled == (u8)TRUE)) &&
+		(SecurePtr->IsEncrypted != (u8)TRUE) &&
+		(SecurePtr->IsCdo != (u8)TRUE)) {
+		/* Copy to destination address */
+		Status = XPlmi_DmaXfr((u64)SecurePtr->SecureData,
+				SecurePtr->ChunkDestAddr,
+				SecurePtr->SecureDataLen / XIH_PRTN_WORD_LEN,
+				XPLMI_PMCDMA_0);
+		if (Status != XST_SUCCESS) {
+			Status = XPlmi_UpdateStatus(
+					XLOADER_ERR_DMA_TRANSFER, Status);
+			goto END;
+		}
+	}
+
+	/* If encryption is enabled */
+	if (SecurePtr->IsEncrypted == (u8)TRUE) {
+		if ((SecurePtr->IsAuthenticated != (u8)TRUE) ||
+			(SecurePtr->IsAuthenticatedTmp != (u8)TRUE)) {
+			SecurePtr->SecureData = BufAddr;
+			SecurePtr->SecureDataLen =
+				SecurePtr->StagingLen[Chunk % SecurePtr->Pipe.Ring.Bufs];
+		}
+
+		if (SecurePtr->IsCdo != (u8)TRUE) {
+			OutAddr = SecurePtr->ChunkDestAddr;
+		}
+		else {
+			OutAddr = SecurePtr->SecureData;
+		}
+		Status = XLoader_AesDecryption(SecurePtr,
+					SecurePtr->SecureData,
+					OutAddr,
+					SecurePtr->SecureDataLen);
+		if (Status != XLOADER_SUCCESS) {
+			Status = XPlmi_UpdateStatus(
+					XLOADER_ERR_PRTN_DECRYPT_FAIL, Status);
+			goto END;
+		}
+	}
+
+	Status = XLOADER_SUCCESS;
+
+END:
+	return Status;
+}
+
 /*****************************************************************************/
 /**
 * @brief	This function checks if authentication/encryption is compulsory.
@@ -1182,43 +1471,36 @@ void XLoader_UpdateKekSrc(XilPdi *PdiPtr)
 
 /*****************************************************************************/
 /**
-* @brief	This function calculates hash and compares with expected hash.
-* If authentication is enabled, hash is calculated on AC + Data for first block,
-* encrypts the ECDSA/RSA signature and compares it with the expected hash.
-* For checksum and authentication(after first block), hash is calculated on block
-* of data and compared with the expected hash.
+* @brief	This function starts the hash of a chunk. If authentication is
+* enabled, hash of the first chunk is calculated on AC + Data.
 *
 * @param	SecurePtr is pointer to the XLoader_SecureParams instance.
-* @param	Size is size of the data block to be processed
-*		which includes padding lengths and hash.
-* @param	Last notifies if the block to be processed is last or not.
+* @param	Sha3InstPtr is pointer to the SHA3 instance to be used.
+* @param	PmcDmaPtr is pointer to the PMC DMA feeding the SHA3 engine.
+* @param	Chunk is the number of the chunk in the partition.
 *
 * @return	XLOADER_SUCCESS on success and error code on failure
 *
 ******************************************************************************/
-static u32 XLoader_VerifyHashNUpdateNext(XLoader_SecureParams *SecurePtr,
-	u32 Size, u8 Last)
+static u32 XLoader_ChunkHashStart(XLoader_SecureParams *SecurePtr,
+	XSecure_Sha3 *Sha3InstPtr, XPmcDma *PmcDmaPtr, u32 Chunk)
 {
-	volatile u32 Status = XLOADER_FAILURE;
-	volatile u32 StatusTmp = XLOADER_FAILURE;
-	XSecure_Sha3 Sha3Instance;
-	u8 *Data = (u8 *)SecurePtr->ChunkAddr;
-	XSecure_Sha3Hash BlkHash = {0U};
-	u8 *ExpHash = (u8 *)SecurePtr->Sha3Hash;
+	u32 Status = XLOADER_FAILURE;
 	XLoader_AuthCertificate *AcPtr=
 		(XLoader_AuthCertificate *)SecurePtr->AcPtr;
-	if (SecurePtr->PmcDmaInstPtr == NULL) {
+
+	if (PmcDmaPtr == NULL) {
 		goto END;
 	}
 
-	Status = XSecure_Sha3Initialize(&Sha3Instance, SecurePtr->PmcDmaInstPtr);
+	Status = XSecure_Sha3Initialize(Sha3InstPtr, PmcDmaPtr);
 	if (Status != XLOADER_SUCCESS) {
 		Status = XPlmi_UpdateStatus(XLOADER_ERR_PRTN_HASH_CALC_FAIL,
 				Status);
 		goto END;
 	}
 
-	Status = XSecure_Sha3Start(&Sha3Instance);
+	Status = XSecure_Sha3Start(Sha3InstPtr);
 	if (Status != XLOADER_SUCCESS) {
 		Status = XPlmi_UpdateStatus(XLOADER_ERR_PRTN_HASH_CALC_FAIL,
 			Status);
@@ -1226,9 +1508,8 @@ static u32 XLoader_VerifyHashNUpdateNext(XLoader_SecureParams *SecurePtr,
 	}
 
 	/* Hash should be calculated on AC + first chunk */
-	if ((SecurePtr->IsAuthenticated == (u8)TRUE) &&
-		(SecurePtr->BlockNum == 0x00U)) {
-		Status = XSecure_Sha3Update(&Sha3Instance, (UINTPTR)AcPtr,
+	if ((SecurePtr->IsAuthenticated == (u8)TRUE) && (Chunk == 0x00U)) {
+		Status = XSecure_Sha3Update(Sha3InstPtr, (UINTPTR)AcPtr,
 			XLOADER_AUTH_CERT_MIN_SIZE - XLOADER_PARTITION_SIG_SIZE);
 		if (Status != XLOADER_SUCCESS) {
 			Status = XPlmi_UpdateStatus(XLOADER_ERR_PRTN_HASH_CALC_FAIL, Status);
@@ -1236,24 +1517,40 @@ static u32 XLoader_VerifyHashNUpdateNext(XLoader_SecureParams *SecurePtr,
 		}
 	}
 
-	Status = XSecure_Sha3Update(&Sha3Instance, (UINTPTR)Data, Size);
-	if (Status != XLOADER_SUCCESS) {
-		Status = XPlmi_UpdateStatus(XLOADER_ERR_PRTN_HASH_CALC_FAIL, Status);
-		goto END;
-	}
+END:
+	return Status;
+}
 
-	Status = XSecure_Sha3Finish(&Sha3Instance, &BlkHash);
-	if (Status != XLOADER_SUCCESS) {
-		Status = XPlmi_UpdateStatus(XLOADER_ERR_PRTN_HASH_CALC_FAIL, Status);
-		goto END;
-	}
+/*****************************************************************************/
+/**
+* @brief	This function compares the hash of a chunk with expected hash.
+* If authentication is enabled, the hash of AC + Data of the first block is
+* verified with the ECDSA/RSA signature. For checksum and authentication(after
+* first block), the hash of the block is compared with the expected hash.
+*
+* @param	SecurePtr is pointer to the XLoader_SecureParams instance.
+* @param	Data is pointer to the chunk.
+* @param	Size is size of the data block to be processed
+*		which includes padding lengths and hash.
+* @param	Last notifies if the block to be processed is last or not.
+* @param	BlkHash is the calculated hash of the chunk.
+*
+* @return	XLOADER_SUCCESS on success and error code on failure
+*
+******************************************************************************/
+static u32 XLoader_VerifyHashNUpdateNext(XLoader_SecureParams *SecurePtr,
+	u8 *Data, u32 Size, u8 Last, u8 *BlkHash)
+{
+	volatile u32 Status = XLOADER_FAILURE;
+	volatile u32 StatusTmp = XLOADER_FAILURE;
+	u8 *ExpHash = (u8 *)SecurePtr->Sha3Hash;
 
 	/* Verify the hash */
 	if (((SecurePtr->IsAuthenticated == (u8)TRUE) ||
 		(SecurePtr->IsAuthenticatedTmp == (u8)TRUE)) &&
 		(SecurePtr->BlockNum == 0x00U)) {
 		XSECURE_TEMPORAL_IMPL(Status, StatusTmp, XLoader_DataAuth, SecurePtr,
-			BlkHash.Hash, (u8 *)SecurePtr->AcPtr->ImgSignature);
+			BlkHash, (u8 *)SecurePtr->AcPtr->ImgSignature);
 		if ((Status != XLOADER_SUCCESS) ||
 			(StatusTmp != XLOADER_SUCCESS)) {
 			Status |= StatusTmp;
@@ -1263,10 +1560,10 @@ static u32 XLoader_VerifyHashNUpdateNext(XLoader_SecureParams *SecurePtr,
 		}
 	}
 	else {
-		Status = Xil_MemCmp(ExpHash, BlkHash.Hash, XLOADER_SHA3_LEN);
+		Status = Xil_MemCmp(ExpHash, BlkHash, XLOADER_SHA3_LEN);
 		if (Status != XLOADER_SUCCESS) {
 			XPlmi_Printf(DEBUG_INFO,"Hash mismatch error\n\r");
-			XPlmi_PrintArray(DEBUG_INFO, (UINTPTR)BlkHash.Hash,
+			XPlmi_PrintArray(DEBUG_INFO, (UINTPTR)BlkHash,
 				XLOADER_SHA3_LEN / XIH_PRTN_WORD_LEN, "Calculated Hash");
 			XPlmi_PrintArray(DEBUG_INFO, (UINTPTR)ExpHash,
 				XLOADER_SHA3_LEN / XIH_PRTN_WORD_LEN, "Expected Hash");
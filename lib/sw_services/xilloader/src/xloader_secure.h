@@ -70,6 +70,7 @@ extern "C" {
 #include "xplmi_util.h"
 #include "xpuf.h"
 #include "xil_util.h"
+#include "xloader_staging.h"
 
 /***************** Macros (Inline Functions) Definitions *********************/
 
@@ -132,6 +133,34 @@ extern "C" {
 #define XLOADER_SECURE_GCM_TAG_SIZE		(16U) /**< GCM Tag Size in Bytes */
 #define XLOADER_SECURE_HDR_TOTAL_SIZE	\
 					(XLOADER_SECURE_HDR_SIZE + XLOADER_SECURE_GCM_TAG_SIZE)
+
+/*
+ * Staging buffers of the chunk pipeline. While one chunk is decrypted the
+ * following chunks are copied and hashed in the other buffers, so the
+ * overlap grows with XLOADER_SECURE_STAGING_BUFS. The buffers are one chunk
+ * plus XLOADER_SECURE_STAGING_MARGIN apart for the next block hash and secure
+ * header. By default they are in PMC RAM below the PLM runtime configuration
+ * area, which holds two secure chunks; more buffers need
+ * XLOADER_SECURE_STAGING_ADDR to point to a region reserved for them, for
+ * example in OCM.
+ */
+#ifndef XLOADER_SECURE_STAGING_BUFS
+#define XLOADER_SECURE_STAGING_BUFS		(2U)
+#endif
+#ifndef XLOADER_SECURE_STAGING_ADDR
+#define XLOADER_SECURE_STAGING_ADDR		XPLMI_PMCRAM_CHUNK_MEMORY
+#endif
+#define XLOADER_SECURE_STAGING_MARGIN		(0x100U)
+#define XLOADER_SECURE_STAGING_END		(XLOADER_SECURE_STAGING_ADDR + \
+	(XLOADER_SECURE_STAGING_BUFS * \
+	(XLOADER_SECURE_CHUNK_SIZE + XLOADER_SECURE_STAGING_MARGIN)))
+#if (XLOADER_SECURE_STAGING_BUFS == 0U)
+#error XLOADER_SECURE_STAGING_BUFS must be at least 1
+#endif
+#if ((XLOADER_SECURE_STAGING_ADDR == XPLMI_PMCRAM_CHUNK_MEMORY) && \
+	(XLOADER_SECURE_STAGING_END > XPLMI_RTCFG_BASEADDR))
+#error Secure staging buffers overlap the PLM runtime configuration area
+#endif
 #define XLOADER_SECURE_METAHDR_RD_IMG_PRTN_HDRS (0x0U)
 #define XLOADER_SECURE_METAHDR_RD_IMG_HDRS      (0x1U)
 #define XLOADER_SECURE_METAHDR_RD_PRTN_HDRS     (0x2U)
@@ -305,7 +334,6 @@ typedef struct {
 typedef struct {
 	volatile u8 SecureEn;
 	volatile u8 SecureEnTmp;
-	u8 IsNextChunkCopyStarted;
 	u8 IsCheckSumEnabled;
 	u8 IsEncrypted;
 	u8 IsEncryptedTmp;
@@ -318,7 +346,14 @@ typedef struct {
 	u8 IsCdo; /**< CDO or Elf */
 	u64 NextBlkAddr;
 	u32 ChunkAddr;
-	u32 NextChunkAddr;
+	XLoader_StagingPipe Pipe; /**< Chunk pipeline of the partition */
+	u64 CopySrcAddr; /**< Source of the next chunk to be copied */
+	u32 CopyRemainingLen; /**< Data left to be copied */
+	u32 CopyLen; /**< Length of the next chunk to be copied */
+	u32 CopyBlockLen; /**< Data length of a chunk without hash */
+	u8 CopyLast; /**< Next chunk to be copied is the last one */
+	u32 StagingLen[XLOADER_SECURE_STAGING_BUFS]; /**< Chunk lengths */
+	u64 ChunkDestAddr; /**< Load address of the chunk being decrypted */
 	/* Verified data is at */
 	u32 SecureData;
 	u32 SecureDataLen;
@@ -459,8 +494,8 @@ int XLoader_ReadAndVerifySecureHdrs(XLoader_SecureParams *SecurePtr,
 	XilPdi_MetaHdr *MetaHdr);
 int XLoader_SecureValidations(const XLoader_SecureParams *SecurePtr);
 void XLoader_UpdateKekSrc(XilPdi *PdiPtr);
-u32 XLoader_StartNextChunkCopy(XLoader_SecureParams *SecurePtr, u32 TotalLen,
-	u32 NextBlkAddr, u32 ChunkLen);
+void XLoader_SecureStagingInit(XLoader_SecureParams *SecurePtr, u32 ChunkLen);
+void XLoader_SecureStagingDrain(XLoader_SecureParams *SecurePtr);
 int XLoader_AddAuthJtagToScheduler(void);
 void XLoader_SecureClear(void);
 
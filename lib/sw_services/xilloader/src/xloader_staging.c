@@ -0,0 +1,416 @@
+/******************************************************************************
+* Copyright (c) 2020 Xilinx, Inc.  All rights reserved.
+* SPDX-License-Identifier: MIT
+******************************************************************************/
+
+/*****************************************************************************/
+/**
+*
+* @file xloader_staging.c
+*
+* This file contains the staging buffer ring and the chunk pipeline used to
+* load partitions through PMC RAM.
+*
+* Chunk N is always staged in ring buffer N modulo the number of buffers, so
+* a chunk is copied ahead only when the chunk that used its buffer before has
+* been released. At most one copy and one hash are in the background at a
+* time, and only when the PMC DMAs they use are not used by the other stages
+* at the same time. Chunks are hashed and decrypted in order and a chunk is
+* decrypted only after its hash was verified. The buffer of a chunk is not
+* reused before the next XLoader_StagingPipeNext call, so the caller may read
+* the chunk in between, as CDO processing does.
+*
+* @note
+*
+******************************************************************************/
+
+/***************************** Include Files *********************************/
+#include "xstatus.h"
+#include "xloader_staging.h"
+
+/************************** Constant Definitions *****************************/
+
+/**************************** Type Definitions *******************************/
+
+/***************** Macros (Inline Functions) Definitions *********************/
+
+/************************** Function Prototypes ******************************/
+static u32 XLoader_StagingCopyStart(XLoader_StagingPipe *Pipe, u32 Limit);
+static u32 XLoader_StagingCopyWait(XLoader_StagingPipe *Pipe);
+static u32 XLoader_StagingHashStart(XLoader_StagingPipe *Pipe);
+static u32 XLoader_StagingHashWait(XLoader_StagingPipe *Pipe);
+
+/************************** Variable Definitions *****************************/
+
+/*****************************************************************************/
+/**
+* @brief	This function lays out the ring buffers in a memory region.
+*
+* @param	Ring is pointer to the ring
+* @param	BaseAddr is the start of the region
+* @param	RegionLen is the length of the region in bytes
+* @param	Stride is the distance between buffers
+* @param	MaxBufs is the largest number of buffers to use
+*
+* @return	None
+*
+******************************************************************************/
+void XLoader_StagingInit(XLoader_StagingRing *Ring, u32 BaseAddr,
+	u32 RegionLen, u32 Stride, u32 MaxBufs)
+{
+	u32 Bufs = RegionLen / Stride;
+
+	if (Bufs > MaxBufs) {
+		Bufs = MaxBufs;
+	}
+	if (Bufs == 0U) {
+		Bufs = 1U;
+	}
+
+	Ring->BaseAddr = BaseAddr;
+	Ring->Stride = Stride;
+	Ring->Bufs = Bufs;
+	Ring->Idx = 0U;
+}
+
+/*****************************************************************************/
+/**
+* @brief	This function returns the buffer that stages the given chunk.
+*
+* @param	Ring is pointer to the ring
+* @param	Chunk is the chunk number
+*
+* @return	Address of the buffer
+*
+******************************************************************************/
+u32 XLoader_StagingAddr(const XLoader_StagingRing *Ring, u32 Chunk)
+{
+	return Ring->BaseAddr + ((Chunk % Ring->Bufs) * Ring->Stride);
+}
+
+/*****************************************************************************/
+/**
+* @brief	This function returns the buffer after the one handed out last,
+* for callers that move through the ring one buffer at a time.
+*
+* @param	Ring is pointer to the ring
+*
+* @return	Address of the buffer
+*
+******************************************************************************/
+u32 XLoader_StagingNext(XLoader_StagingRing *Ring)
+{
+	Ring->Idx++;
+	if (Ring->Idx >= Ring->Bufs) {
+		Ring->Idx = 0U;
+	}
+
+	return XLoader_StagingAddr(Ring, Ring->Idx);
+}
+
+/*****************************************************************************/
+/**
+* @brief	This function prepares the pipeline for a new partition. The ring
+* must already be laid out. Background work is disabled until the caller sets
+* the DMA masks and HashAhead.
+*
+* @param	Pipe is pointer to the pipeline
+* @param	Ops is pointer to the stage functions
+* @param	Ctx is passed to the stage functions
+* @param	NumChunks is the number of chunks in the partition
+*
+* @return	None
+*
+******************************************************************************/
+void XLoader_StagingPipeInit(XLoader_StagingPipe *Pipe,
+	const XLoader_StagingOps *Ops, void *Ctx, u32 NumChunks)
+{
+	Pipe->Ops = Ops;
+	Pipe->Ctx = Ctx;
+	Pipe->CopyDma = 0U;
+	Pipe->HashDma = 0U;
+	Pipe->DecryptDma = 0U;
+	Pipe->NumChunks = NumChunks;
+	Pipe->Copied = 0U;
+	Pipe->Hashed = 0U;
+	Pipe->Done = 0U;
+	Pipe->CopyPending = (u8)FALSE;
+	Pipe->HashPending = (u8)FALSE;
+	Pipe->HashAhead = (u8)FALSE;
+}
+
+/*****************************************************************************/
+/**
+* @brief	This function copies, verifies and decrypts the next chunk of the
+* partition. While it waits for one stage it starts the stages of the
+* following chunks that have a free buffer and a free DMA.
+*
+* @param	Pipe is pointer to the pipeline
+* @param	BufAddr is where the address of the chunk buffer is returned
+*
+* @return	XST_SUCCESS on success and error code of the failing stage
+*		on failure
+*
+******************************************************************************/
+u32 XLoader_StagingPipeNext(XLoader_StagingPipe *Pipe, u32 *BufAddr)
+{
+	u32 Status = XST_FAILURE;
+	u32 Chunk = Pipe->Done;
+	/* Buffers of the chunks before this one are free */
+	u32 Limit = Chunk + Pipe->Ring.Bufs;
+
+	if (Chunk >= Pipe->NumChunks) {
+		goto END;
+	}
+
+	/* Copy the chunk unless it was copied ahead */
+	if (Pipe->Copied == Chunk) {
+		Status = XLoader_StagingCopyStart(Pipe, Limit);
+		if (Status != XST_SUCCESS) {
+			goto END;
+		}
+		Status = XLoader_StagingCopyWait(Pipe);
+		if (Status != XST_SUCCESS) {
+			goto END;
+		}
+		if (Pipe->Copied == Chunk) {
+			Status = XST_FAILURE;
+			goto END;
+		}
+	}
+
+	/* Verify the chunk, copying the next one meanwhile */
+	if (Pipe->Hashed == Chunk) {
+		if ((Pipe->HashPending == (u8)FALSE) &&
+			((Pipe->CopyDma & Pipe->HashDma) != 0U)) {
+			Status = XLoader_StagingCopyWait(Pipe);
+		}
+		else {
+			Status = XLoader_StagingCopyStart(Pipe, Limit);
+		}
+		if (Status != XST_SUCCESS) {
+			goto END;
+		}
+		Status = XLoader_StagingHashStart(Pipe);
+		if (Status != XST_SUCCESS) {
+			goto END;
+		}
+		Status = XLoader_StagingHashWait(Pipe);
+		if (Status != XST_SUCCESS) {
+			goto END;
+		}
+		if (Pipe->Hashed == Chunk) {
+			Status = XST_FAILURE;
+			goto END;
+		}
+	}
+
+	/* Keep the copy going during decryption */
+	Status = XLoader_StagingCopyStart(Pipe, Limit);
+	if (Status != XST_SUCCESS) {
+		goto END;
+	}
+
+	/*
+	 * Hash the next chunk during decryption. Wait for its copy if the
+	 * buffer after it is free, so that copy, hash and decryption all run.
+	 */
+	if ((Pipe->HashAhead == (u8)TRUE) &&
+		((Pipe->HashDma & Pipe->DecryptDma) == 0U)) {
+		if ((Pipe->CopyPending == (u8)TRUE) &&
+			(Pipe->Copied == (Chunk + 1U)) &&
+			((Chunk + 2U) < Limit)) {
+			Status = XLoader_StagingCopyWait(Pipe);
+			if (Status != XST_SUCCESS) {
+				goto END;
+			}
+			Status = XLoader_StagingCopyStart(Pipe, Limit);
+			if (Status != XST_SUCCESS) {
+				goto END;
+			}
+		}
+		Status = XLoader_StagingHashStart(Pipe);
+		if (Status != XST_SUCCESS) {
+			goto END;
+		}
+	}
+
+	if ((Pipe->CopyDma & Pipe->DecryptDma) != 0U) {
+		Status = XLoader_StagingCopyWait(Pipe);
+		if (Status != XST_SUCCESS) {
+			goto END;
+		}
+	}
+
+	*BufAddr = XLoader_StagingAddr(&Pipe->Ring, Chunk);
+	Status = Pipe->Ops->Decrypt(Pipe->Ctx, Chunk, *BufAddr);
+	if (Status != XST_SUCCESS) {
+		goto END;
+	}
+	Pipe->Done++;
+
+END:
+	return Status;
+}
+
+/*****************************************************************************/
+/**
+* @brief	This function waits for the work left in the background and drops
+* the chunks that were copied or hashed ahead, so that they are processed
+* again from their source by the next XLoader_StagingPipeNext call.
+*
+* @param	Pipe is pointer to the pipeline
+*
+* @return	None
+*
+******************************************************************************/
+void XLoader_StagingPipeDrain(XLoader_StagingPipe *Pipe)
+{
+	if (Pipe->CopyPending == (u8)TRUE) {
+		(void)Pipe->Ops->CopyWait(Pipe->Ctx, Pipe->Copied,
+			XLoader_StagingAddr(&Pipe->Ring, Pipe->Copied));
+		Pipe->CopyPending = (u8)FALSE;
+	}
+	if (Pipe->HashPending == (u8)TRUE) {
+		Pipe->Ops->HashCancel(Pipe->Ctx, Pipe->Hashed,
+			XLoader_StagingAddr(&Pipe->Ring, Pipe->Hashed));
+		Pipe->HashPending = (u8)FALSE;
+	}
+	Pipe->Copied = Pipe->Done;
+	Pipe->Hashed = Pipe->Done;
+}
+
+/*****************************************************************************/
+/**
+* @brief	This function starts the copy of the next chunk that is not copied
+* yet, if its buffer is free and no other copy or conflicting hash runs.
+*
+* @param	Pipe is pointer to the pipeline
+* @param	Limit is the first chunk whose buffer is still in use
+*
+* @return	XST_SUCCESS on success and error code on failure
+*
+******************************************************************************/
+static u32 XLoader_StagingCopyStart(XLoader_StagingPipe *Pipe, u32 Limit)
+{
+	u32 Status = XST_SUCCESS;
+	u8 Pending = (u8)FALSE;
+
+	if ((Pipe->CopyPending == (u8)TRUE) ||
+		(Pipe->Copied >= Pipe->NumChunks) ||
+		(Pipe->Copied >= Limit)) {
+		goto END;
+	}
+	if ((Pipe->HashPending == (u8)TRUE) &&
+		((Pipe->CopyDma & Pipe->HashDma) != 0U)) {
+		goto END;
+	}
+
+	Status = Pipe->Ops->CopyStart(Pipe->Ctx, Pipe->Copied,
+		XLoader_StagingAddr(&Pipe->Ring, Pipe->Copied), &Pending);
+	if (Status != XST_SUCCESS) {
+		goto END;
+	}
+	if (Pending == (u8)TRUE) {
+		Pipe->CopyPending = (u8)TRUE;
+	}
+	else {
+		Pipe->Copied++;
+	}
+
+END:
+	return Status;
+}
+
+/*****************************************************************************/
+/**
+* @brief	This function waits for the copy in the background, if any.
+*
+* @param	Pipe is pointer to the pipeline
+*
+* @return	XST_SUCCESS on success and error code on failure
+*
+******************************************************************************/
+static u32 XLoader_StagingCopyWait(XLoader_StagingPipe *Pipe)
+{
+	u32 Status = XST_SUCCESS;
+
+	if (Pipe->CopyPending == (u8)TRUE) {
+		Pipe->CopyPending = (u8)FALSE;
+		Status = Pipe->Ops->CopyWait(Pipe->Ctx, Pipe->Copied,
+			XLoader_StagingAddr(&Pipe->Ring, Pipe->Copied));
+		if (Status == XST_SUCCESS) {
+			Pipe->Copied++;
+		}
+	}
+
+	return Status;
+}
+
+/*****************************************************************************/
+/**
+* @brief	This function starts the hash of the next chunk that is not
+* verified yet, if it is copied and no conflicting copy runs.
+*
+* @param	Pipe is pointer to the pipeline
+*
+* @return	XST_SUCCESS on success and error code on failure
+*
+******************************************************************************/
+static u32 XLoader_StagingHashStart(XLoader_StagingPipe *Pipe)
+{
+	u32 Status = XST_SUCCESS;
+	u8 Pending = (u8)FALSE;
+
+	if ((Pipe->HashPending == (u8)TRUE) ||
+		(Pipe->Hashed >= Pipe->Copied)) {
+		goto END;
+	}
+	if ((Pipe->CopyPending == (u8)TRUE) &&
+		((Pipe->CopyDma & Pipe->HashDma) != 0U)) {
+		goto END;
+	}
+
+	if (Pipe->Ops->HashStart != NULL) {
+		Status = Pipe->Ops->HashStart(Pipe->Ctx, Pipe->Hashed,
+			XLoader_StagingAddr(&Pipe->Ring, Pipe->Hashed), &Pending);
+		if (Status != XST_SUCCESS) {
+			goto END;
+		}
+	}
+	if (Pending == (u8)TRUE) {
+		Pipe->HashPending = (u8)TRUE;
+	}
+	else {
+		Pipe->Hashed++;
+	}
+
+END:
+	return Status;
+}
+
+/*****************************************************************************/
+/**
+* @brief	This function waits for the hash in the background, if any, and
+* verifies the chunk.
+*
+* @param	Pipe is pointer to the pipeline
+*
+* @return	XST_SUCCESS on success and error code on failure
+*
+******************************************************************************/
+static u32 XLoader_StagingHashWait(XLoader_StagingPipe *Pipe)
+{
+	u32 Status = XST_SUCCESS;
+
+	if (Pipe->HashPending == (u8)TRUE) {
+		Pipe->HashPending = (u8)FALSE;
+		Status = Pipe->Ops->HashWait(Pipe->Ctx, Pipe->Hashed,
+			XLoader_StagingAddr(&Pipe->Ring, Pipe->Hashed));
+		if (Status == XST_SUCCESS) {
+			Pipe->Hashed++;
+		}
+	}
+
+	return Status;
+}
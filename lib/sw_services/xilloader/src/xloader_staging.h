@@ -0,0 +1,101 @@
+/******************************************************************************
+* Copyright (c) 2020 Xilinx, Inc.  All rights reserved.
+* SPDX-License-Identifier: MIT
+******************************************************************************/
+
+/*****************************************************************************/
+/**
+*
+* @file xloader_staging.h
+*
+* This is the header file which contains the staging buffer ring and the
+* chunk pipeline declarations for the xilloader.
+*
+* The ring hands out buffers of a fixed stride from one memory region. The
+* pipeline moves every chunk of a partition through the copy, hash and
+* decrypt stages in order, using as many ring buffers as are free so that
+* the stages of neighbouring chunks overlap. The stages themselves are
+* provided by the caller as XLoader_StagingOps, so the scheduling does not
+* depend on the boot device or the crypto drivers.
+*
+* @note
+*
+******************************************************************************/
+
+#ifndef XLOADER_STAGING_H
+#define XLOADER_STAGING_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/***************************** Include Files *********************************/
+#include "xil_types.h"
+
+/************************** Constant Definitions *****************************/
+/* Number of chunks to use until the last chunk of the partition is copied */
+#define XLOADER_STAGING_MAX_CHUNKS	(0xFFFFFFFFU)
+
+/**************************** Type Definitions *******************************/
+typedef struct {
+	u32 BaseAddr;	/**< Address of the first buffer */
+	u32 Stride;	/**< Distance between buffers */
+	u32 Bufs;	/**< Number of buffers */
+	u32 Idx;	/**< Buffer handed out last by XLoader_StagingNext */
+} XLoader_StagingRing;
+
+/**
+ * Stages of the chunk pipeline. Each function gets the chunk number and the
+ * ring buffer holding the chunk and returns XST_SUCCESS or an error code.
+ * CopyStart and HashStart set *Pending to TRUE if the work continues in the
+ * background, in which case CopyWait or HashWait completes it. HashWait and
+ * a HashStart that completes at once must verify the chunk; Decrypt is only
+ * called for verified chunks. HashCancel waits for a background hash
+ * without checking it. Hash functions may be NULL if chunks are not hashed.
+ */
+typedef struct {
+	u32 (*CopyStart)(void *Ctx, u32 Chunk, u32 BufAddr, u8 *Pending);
+	u32 (*CopyWait)(void *Ctx, u32 Chunk, u32 BufAddr);
+	u32 (*HashStart)(void *Ctx, u32 Chunk, u32 BufAddr, u8 *Pending);
+	u32 (*HashWait)(void *Ctx, u32 Chunk, u32 BufAddr);
+	void (*HashCancel)(void *Ctx, u32 Chunk, u32 BufAddr);
+	u32 (*Decrypt)(void *Ctx, u32 Chunk, u32 BufAddr);
+} XLoader_StagingOps;
+
+typedef struct {
+	XLoader_StagingRing Ring;
+	const XLoader_StagingOps *Ops;
+	void *Ctx;		/**< Passed to the stage functions */
+	u32 CopyDma;	/**< PMC DMAs used by a copy in the background */
+	u32 HashDma;	/**< PMC DMAs used by a hash in the background */
+	u32 DecryptDma;	/**< PMC DMAs used by decryption */
+	u32 NumChunks;	/**< Chunks in the partition */
+	u32 Copied;	/**< Chunks copied to the ring */
+	u32 Hashed;	/**< Chunks verified */
+	u32 Done;	/**< Chunks decrypted */
+	u8 CopyPending;	/**< Copy of chunk Copied is in the background */
+	u8 HashPending;	/**< Hash of chunk Hashed is in the background */
+	u8 HashAhead;	/**< Hash the next chunk while this one is decrypted;
+			  *  HashStart must then run in the background for
+			  *  every chunk but the first */
+} XLoader_StagingPipe;
+
+/***************** Macros (Inline Functions) Definitions *********************/
+
+/************************** Function Prototypes ******************************/
+void XLoader_StagingInit(XLoader_StagingRing *Ring, u32 BaseAddr,
+	u32 RegionLen, u32 Stride, u32 MaxBufs);
+u32 XLoader_StagingAddr(const XLoader_StagingRing *Ring, u32 Chunk);
+u32 XLoader_StagingNext(XLoader_StagingRing *Ring);
+void XLoader_StagingPipeInit(XLoader_StagingPipe *Pipe,
+	const XLoader_StagingOps *Ops, void *Ctx, u32 NumChunks);
+u32 XLoader_StagingPipeNext(XLoader_StagingPipe *Pipe, u32 *BufAddr);
+void XLoader_StagingPipeDrain(XLoader_StagingPipe *Pipe);
+
+/************************** Variable Definitions *****************************/
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* XLOADER_STAGING_H */
@@ -71,6 +71,15 @@ extern "C" {
  * Prints to memory are still enabled as defined by PLM DEBUG macros
  */
 //#define PLM_PRINT_NO_UART
+/**
+ * The below define defers formatting and UART output of XPlmi_Printf prints
+ * to the idle loop, so verbose prints do not add formatting and UART time to
+ * boot. Prints keep the time stamp of the XPlmi_Printf call. They reach the
+ * debug log when formatted, which can be after bytes written directly with
+ * xil_printf. Prints overwritten in the debug log before they are sent are
+ * lost on UART. Disable the define to print synchronously.
+ */
+#define PLM_PRINT_DEFERRED
 
 //#define PLM_PRINT
 #define PLM_DEBUG
@@ -42,6 +42,7 @@
 #include "xplmi_hw.h"
 #include "xplmi_status.h"
 #include "xparameters.h"
+#include "mb_interface.h"
 
 /* PLM specific outbyte function */
 void outbyte(char8 c);
@@ -55,9 +56,44 @@ void outbyte(char8 c);
 #define XPLMI_SPP_INPUT_CLK_FREQ	(25000000U)
 #define XPLMI_UART_BAUD_RATE		(115200U)
 
+/* Slots in the deferred print queue */
+#define XPLMI_DEFER_PRINT_QUEUE_LEN	(256U)
+
+/*
+ * Deferred print record, in UINTPTR slots
+ *	0U - Header, 0 marks the end of the queue if the next record did not fit
+ *		[31:24] Set for the arguments which are strings
+ *		[20]	Print the time stamp
+ *		[19:16]	Number of arguments
+ *		[15:0]	Record length in slots
+ *	1U - Format string
+ *	2U - Timer value at the print, low word
+ *	3U - Timer value at the print, high word
+ *	4U - Arguments, string arguments hold the number of bytes stored
+ *	...  Bytes of the string arguments, each one starting at a new slot
+ */
+#define XPLMI_DEFER_PRINT_HDR_LEN	(4U)
+#define XPLMI_DEFER_PRINT_LEN_MASK	(0xFFFFU)
+#define XPLMI_DEFER_PRINT_NUM_ARGS_SHIFT	(16U)
+#define XPLMI_DEFER_PRINT_NUM_ARGS_MASK	(0xFU)
+#define XPLMI_DEFER_PRINT_TIMESTAMP	(0x100000U)
+#define XPLMI_DEFER_PRINT_STR_SHIFT	(24U)
+
 /************************** Function Prototypes ******************************/
 
 /************************** Variable Definitions *****************************/
+#ifdef PLM_PRINT_DEFERRED
+#ifdef STDOUT_BASEADDRESS
+/* Number of bytes in debug log buffer yet to be sent to UART */
+static u32 UartPendingLen = 0U;
+#endif
+
+/* Prints queued by XPlmi_PrintfDeferred, see the record layout above */
+static UINTPTR DeferPrintQueue[XPLMI_DEFER_PRINT_QUEUE_LEN];
+static u32 DeferPrintHead = 0U;	/* Slot of the next record */
+static u32 DeferPrintTail = 0U;	/* Slot of the oldest record */
+static u8 DeferPrintBusy = (u8)FALSE;	/* Oldest record is being formatted */
+#endif
 
 /*****************************************************************************/
 /**
@@ -134,7 +170,11 @@ END:
 
 /*****************************************************************************/
 /**
- * @brief	This function prints and logs the terminal prints to debug log buffer
+ * @brief	This function prints and logs the terminal prints to debug log buffer.
+ * With PLM_PRINT_DEFERRED, the character is only logged and is sent to UART
+ * later by XPlmi_DrainDeferredPrints. Interrupts are masked while the log
+ * and the count of bytes to send are updated, as prints from interrupt
+ * handlers also call outbyte.
  *
  * @param	c is the character to be printed and logged
  *
@@ -143,9 +183,21 @@ END:
  *****************************************************************************/
 void outbyte(char8 c)
 {
+#ifdef PLM_PRINT_DEFERRED
+	UINTPTR Msr = mfmsr();
+
+	microblaze_disable_interrupts();
+#endif
+
 #ifdef STDOUT_BASEADDRESS
 	if(((LpdInitialized) & UART_INITIALIZED) == UART_INITIALIZED) {
+#ifdef PLM_PRINT_DEFERRED
+		if (UartPendingLen < DebugLog.LogBuffer.Len) {
+			++UartPendingLen;
+		}
+#else
 		XUartPsv_SendByte(STDOUT_BASEADDRESS, (u8)c);
+#endif
 	}
 #endif
 
@@ -157,4 +209,415 @@ void outbyte(char8 c)
 
 	XPlmi_OutByte64(DebugLog.LogBuffer.CurrentAddr, c);
 	++DebugLog.LogBuffer.CurrentAddr;
+
+#ifdef PLM_PRINT_DEFERRED
+	mtmsr(Msr);
+#endif
+}
+
+#ifdef PLM_PRINT_DEFERRED
+/*****************************************************************************/
+/**
+ * @brief	This function reserves slots for a record in the deferred print
+ * queue. It must be called with interrupts masked.
+ *
+ * @param	Len is the record length in slots
+ *
+ * @return	First slot of the record, or XPLMI_DEFER_PRINT_QUEUE_LEN if the
+ *		queue has no room for it
+ *
+ *****************************************************************************/
+static u32 XPlmi_DeferPrintAlloc(u32 Len)
+{
+	u32 Idx = XPLMI_DEFER_PRINT_QUEUE_LEN;
+	u32 Head = DeferPrintHead;
+
+	if (Head == DeferPrintTail) {
+		/* Queue is empty, start over at the first slot */
+		Head = 0U;
+		DeferPrintTail = 0U;
+	}
+
+	/* One slot is left free so that a full queue differs from an empty one */
+	if (Head >= DeferPrintTail) {
+		if (((Head + Len) < XPLMI_DEFER_PRINT_QUEUE_LEN) ||
+			(((Head + Len) == XPLMI_DEFER_PRINT_QUEUE_LEN) &&
+			(DeferPrintTail != 0U))) {
+			Idx = Head;
+		} else if (Len < DeferPrintTail) {
+			DeferPrintQueue[Head] = 0U;
+			Idx = 0U;
+		} else {
+			/* No room */
+		}
+	} else if ((Head + Len) < DeferPrintTail) {
+		Idx = Head;
+	} else {
+		/* No room */
+	}
+
+	if (Idx != XPLMI_DEFER_PRINT_QUEUE_LEN) {
+		Head = Idx + Len;
+		if (Head == XPLMI_DEFER_PRINT_QUEUE_LEN) {
+			Head = 0U;
+		}
+		DeferPrintHead = Head;
+	}
+
+	return Idx;
+}
+
+/*****************************************************************************/
+/**
+ * @brief	This function formats the oldest record of the deferred print
+ * queue, which logs it and counts its bytes for UART through outbyte, and
+ * removes it from the queue. Only one caller formats at a time, so a call
+ * from an interrupt handler returns FALSE while the task level formats.
+ *
+ * @param	None
+ *
+ * @return	TRUE if a record was formatted, FALSE otherwise
+ *
+ *****************************************************************************/
+static u8 XPlmi_FormatDeferredPrint(void)
+{
+	u8 Formatted = (u8)FALSE;
+	UINTPTR Arg[XPLMI_DEFER_PRINT_MAX_ARGS] = {0U};
+	const UINTPTR *Rec;
+	UINTPTR Hdr = 0U;
+	UINTPTR Msr;
+	u32 Tail = 0U;
+	u32 NumArgs;
+	u32 StrIdx;
+	u32 Index;
+	u64 Time;
+	XPlmi_PerfTime PerfTime = {0U};
+
+	Msr = mfmsr();
+	microblaze_disable_interrupts();
+	if ((DeferPrintBusy == (u8)FALSE) &&
+		(DeferPrintHead != DeferPrintTail)) {
+		if (DeferPrintQueue[DeferPrintTail] == 0U) {
+			DeferPrintTail = 0U;
+		}
+		Tail = DeferPrintTail;
+		Hdr = DeferPrintQueue[Tail];
+		DeferPrintBusy = (u8)TRUE;
+	}
+	mtmsr(Msr);
+
+	if (Hdr == 0U) {
+		goto END;
+	}
+
+	/* Record stays in the queue until it is formatted */
+	Rec = &DeferPrintQueue[Tail];
+	NumArgs = (u32)(Hdr >> XPLMI_DEFER_PRINT_NUM_ARGS_SHIFT) &
+		XPLMI_DEFER_PRINT_NUM_ARGS_MASK;
+	StrIdx = XPLMI_DEFER_PRINT_HDR_LEN + NumArgs;
+	for (Index = 0U; Index < NumArgs; ++Index) {
+		if ((Hdr & ((UINTPTR)1U << (XPLMI_DEFER_PRINT_STR_SHIFT + Index)))
+			!= 0U) {
+			Arg[Index] = (UINTPTR)&Rec[StrIdx];
+			StrIdx += (u32)((Rec[XPLMI_DEFER_PRINT_HDR_LEN + Index] +
+				sizeof(UINTPTR) - 1U) / sizeof(UINTPTR));
+		} else {
+			Arg[Index] = Rec[XPLMI_DEFER_PRINT_HDR_LEN + Index];
+		}
+	}
+
+	if ((Hdr & XPLMI_DEFER_PRINT_TIMESTAMP) != 0U) {
+		Time = ((u64)Rec[3U] << 32U) | (u64)Rec[2U];
+		XPlmi_GetPerfTime((XPLMI_PIT1_CYCLE_VALUE << 32U) |
+			XPLMI_PIT2_CYCLE_VALUE, Time, &PerfTime);
+		xil_printf("[%u.%06u]", (u32)PerfTime.TPerfMs,
+			(u32)PerfTime.TPerfMsFrac);
+	}
+	/* xil_printf reads the arguments it needs and ignores the rest */
+	xil_printf((const char8 *)Rec[1U], Arg[0U], Arg[1U], Arg[2U], Arg[3U],
+		Arg[4U], Arg[5U], Arg[6U], Arg[7U]);
+
+	Msr = mfmsr();
+	microblaze_disable_interrupts();
+	Tail += (u32)(Hdr & XPLMI_DEFER_PRINT_LEN_MASK);
+	if (Tail == XPLMI_DEFER_PRINT_QUEUE_LEN) {
+		Tail = 0U;
+	}
+	DeferPrintTail = Tail;
+	DeferPrintBusy = (u8)FALSE;
+	mtmsr(Msr);
+	Formatted = (u8)TRUE;
+
+END:
+	return Formatted;
+}
+
+/*****************************************************************************/
+/**
+ * @brief	This function takes the oldest debug log byte not yet sent to
+ * UART. Bytes which are already overwritten in the debug log buffer are
+ * skipped.
+ *
+ * @param	Data is filled with the byte
+ *
+ * @return	Number of bytes pending before the call
+ *
+ *****************************************************************************/
+static u32 XPlmi_NextUartByte(u8 *Data)
+{
+	u32 Pending = 0U;
+#ifdef STDOUT_BASEADDRESS
+	u32 Offset;
+	u32 Avail;
+	UINTPTR Msr;
+
+	Msr = mfmsr();
+	microblaze_disable_interrupts();
+	Offset = (u32)(DebugLog.LogBuffer.CurrentAddr -
+		DebugLog.LogBuffer.StartAddr);
+	/* Log buffer may have been reconfigured since bytes were logged */
+	if (DebugLog.LogBuffer.IsBufferFull == (u8)TRUE) {
+		Avail = DebugLog.LogBuffer.Len;
+	} else {
+		Avail = Offset;
+	}
+	if (UartPendingLen > Avail) {
+		UartPendingLen = Avail;
+	}
+	Pending = UartPendingLen;
+	if (Pending > 0U) {
+		Offset = (Offset + DebugLog.LogBuffer.Len - Pending) %
+			DebugLog.LogBuffer.Len;
+		*Data = (u8)XPlmi_InByte64(DebugLog.LogBuffer.StartAddr + Offset);
+		--UartPendingLen;
+	}
+	mtmsr(Msr);
+#else
+	(void)Data;
+#endif
+
+	return Pending;
+}
+#endif
+
+/*****************************************************************************/
+/**
+ * @brief	This function queues a print when PLM_PRINT_DEFERRED is enabled,
+ * so that it is formatted later by XPlmi_DrainDeferredPrints. Only the
+ * timer is read and the arguments are copied, reading them as xil_printf
+ * does: one word per conversion and a string for %s. Strings are copied up
+ * to XPLMI_DEFER_PRINT_MAX_STR bytes, as the caller may reuse its buffer.
+ * The format string must stay valid, which holds for string literals.
+ *
+ * @param	TimeStamp is TRUE to print the time stamp before the print
+ * @param	Ctrl is the xil_printf format string
+ *
+ * @return	XST_SUCCESS if the print is queued, XST_FAILURE if it has more
+ *		than XPLMI_DEFER_PRINT_MAX_ARGS arguments, the queue is full or
+ *		prints are not deferred. The caller then prints it at once.
+ *
+ *****************************************************************************/
+int XPlmi_PrintfDeferred(u8 TimeStamp, const char8 *Ctrl, ...)
+{
+	int Status = XST_FAILURE;
+#ifdef PLM_PRINT_DEFERRED
+	va_list Args;
+	UINTPTR Arg[XPLMI_DEFER_PRINT_MAX_ARGS];
+	u32 StrLen[XPLMI_DEFER_PRINT_MAX_ARGS];
+	UINTPTR Hdr = 0U;
+	const char8 *Fmt = Ctrl;
+	const char8 *Str;
+	char8 *Dest;
+	u32 NumArgs = 0U;
+	u32 Len = XPLMI_DEFER_PRINT_HDR_LEN;
+	u32 Idx;
+	u32 Index;
+	u32 Offset;
+	u64 Time = 0U;
+	UINTPTR Msr;
+
+	if (TimeStamp == (u8)TRUE) {
+		Time = XPlmi_GetTimerValue();
+		Hdr = XPLMI_DEFER_PRINT_TIMESTAMP;
+	}
+
+	va_start(Args, Ctrl);
+	while ((*Fmt != (char8)0) && (NumArgs <= XPLMI_DEFER_PRINT_MAX_ARGS)) {
+		if (*Fmt != '%') {
+			++Fmt;
+			continue;
+		}
+		/* Skip flags, width and length as xil_printf does */
+		++Fmt;
+		while ((*Fmt == '-') || (*Fmt == '.') || (*Fmt == 'l') ||
+			((*Fmt >= '0') && (*Fmt <= '9'))) {
+			++Fmt;
+		}
+		switch (*Fmt) {
+			case 'u':
+			case 'i':
+			case 'd':
+			case 'p':
+			case 'x':
+			case 'X':
+			case 'c':
+				if (NumArgs < XPLMI_DEFER_PRINT_MAX_ARGS) {
+					Arg[NumArgs] = (UINTPTR)va_arg(Args, u32);
+				}
+				++NumArgs;
+				break;
+			case 's':
+				if (NumArgs < XPLMI_DEFER_PRINT_MAX_ARGS) {
+					Str = va_arg(Args, const char8 *);
+					Arg[NumArgs] = (UINTPTR)Str;
+					StrLen[NumArgs] = 1U;
+					while ((Str != NULL) &&
+						(StrLen[NumArgs] < XPLMI_DEFER_PRINT_MAX_STR) &&
+						(Str[StrLen[NumArgs] - 1U] != (char8)0)) {
+						++StrLen[NumArgs];
+					}
+					Hdr |= (UINTPTR)1U << (XPLMI_DEFER_PRINT_STR_SHIFT +
+						NumArgs);
+					Len += (u32)((StrLen[NumArgs] + sizeof(UINTPTR) - 1U) /
+						sizeof(UINTPTR));
+				}
+				++NumArgs;
+				break;
+			default:
+				/* %% and the end of the format take no argument */
+				break;
+		}
+		if (*Fmt != (char8)0) {
+			++Fmt;
+		}
+	}
+	va_end(Args);
+
+	if (NumArgs > XPLMI_DEFER_PRINT_MAX_ARGS) {
+		goto END;
+	}
+	Len += NumArgs;
+	Hdr |= (UINTPTR)Len | ((UINTPTR)NumArgs << XPLMI_DEFER_PRINT_NUM_ARGS_SHIFT);
+
+	/* Prints from interrupt handlers use the same queue */
+	Msr = mfmsr();
+	microblaze_disable_interrupts();
+	Idx = XPlmi_DeferPrintAlloc(Len);
+	if (Idx != XPLMI_DEFER_PRINT_QUEUE_LEN) {
+		DeferPrintQueue[Idx + 1U] = (UINTPTR)Ctrl;
+		DeferPrintQueue[Idx + 2U] = (UINTPTR)(u32)(Time & 0xFFFFFFFFU);
+		DeferPrintQueue[Idx + 3U] = (UINTPTR)(u32)(Time >> 32U);
+		Offset = Idx + XPLMI_DEFER_PRINT_HDR_LEN + NumArgs;
+		for (Index = 0U; Index < NumArgs; ++Index) {
+			if ((Hdr & ((UINTPTR)1U << (XPLMI_DEFER_PRINT_STR_SHIFT + Index)))
+				== 0U) {
+				DeferPrintQueue[Idx + XPLMI_DEFER_PRINT_HDR_LEN + Index] =
+					Arg[Index];
+				continue;
+			}
+			/* Copy the string, cut to the stored length */
+			Str = (const char8 *)Arg[Index];
+			Dest = (char8 *)&DeferPrintQueue[Offset];
+			for (Len = 0U; Len < (StrLen[Index] - 1U); ++Len) {
+				Dest[Len] = Str[Len];
+			}
+			Dest[Len] = (char8)0;
+			DeferPrintQueue[Idx + XPLMI_DEFER_PRINT_HDR_LEN + Index] =
+				StrLen[Index];
+			Offset += (u32)((StrLen[Index] + sizeof(UINTPTR) - 1U) /
+				sizeof(UINTPTR));
+		}
+		/* Header last, the record is complete once it is set */
+		DeferPrintQueue[Idx] = Hdr;
+		Status = XST_SUCCESS;
+	}
+	mtmsr(Msr);
+
+END:
+#else
+	(void)TimeStamp;
+	(void)Ctrl;
+#endif
+	return Status;
+}
+
+/*****************************************************************************/
+/**
+ * @brief	This function formats all prints queued by XPlmi_PrintfDeferred
+ * into the debug log, without waiting for UART. It is used before the debug
+ * log is read out.
+ *
+ * @param	None
+ *
+ * @return	None
+ *
+ *****************************************************************************/
+void XPlmi_FormatDeferredPrints(void)
+{
+#ifdef PLM_PRINT_DEFERRED
+	while (XPlmi_FormatDeferredPrint() == (u8)TRUE) {
+		/* Formatting logs the bytes */
+	}
+#endif
+}
+
+/*****************************************************************************/
+/**
+ * @brief	This function formats the prints queued by XPlmi_PrintfDeferred
+ * and sends up to MaxBytes of the debug log bytes not yet sent to UART when
+ * PLM_PRINT_DEFERRED is enabled. A queued print is formatted once the bytes
+ * of the previous one are sent, and only one per call unless MaxBytes is
+ * XPLMI_PRINT_DRAIN_ALL. The task dispatch loop calls it with
+ * XPLMI_PRINT_DRAIN_IDLE_BYTES before going to sleep and checks the task
+ * queues again between calls. The error manager calls it with
+ * XPLMI_PRINT_DRAIN_ALL only when an error occurs before the boot PDI is
+ * loaded, just before the PLM hangs or resets. Errors after that return to
+ * the dispatch loop, which drains the prints when idle.
+ *
+ * @param	MaxBytes is the maximum number of bytes to send
+ *
+ * @return	Number of bytes still to be sent plus the number of queue slots
+ *		still to be formatted, 0 if nothing is pending
+ *
+ *****************************************************************************/
+u32 XPlmi_DrainDeferredPrints(u32 MaxBytes)
+{
+	u32 Pending = 0U;
+#ifdef PLM_PRINT_DEFERRED
+	u32 Count = 0U;
+	u8 Formatted = (u8)FALSE;
+	u8 Data = 0U;
+	UINTPTR Msr;
+
+	while (Count < MaxBytes) {
+		if (XPlmi_NextUartByte(&Data) != 0U) {
+#ifdef STDOUT_BASEADDRESS
+			XUartPsv_SendByte(STDOUT_BASEADDRESS, Data);
+#endif
+			++Count;
+			continue;
+		}
+		if ((Formatted == (u8)TRUE) &&
+			(MaxBytes != XPLMI_PRINT_DRAIN_ALL)) {
+			break;
+		}
+		Formatted = XPlmi_FormatDeferredPrint();
+		if (Formatted == (u8)FALSE) {
+			break;
+		}
+	}
+
+	Msr = mfmsr();
+	microblaze_disable_interrupts();
+#ifdef STDOUT_BASEADDRESS
+	Pending = UartPendingLen;
+#endif
+	Pending += (DeferPrintHead + XPLMI_DEFER_PRINT_QUEUE_LEN -
+		DeferPrintTail) % XPLMI_DEFER_PRINT_QUEUE_LEN;
+	mtmsr(Msr);
+#else
+	(void)MaxBytes;
+#endif
+
+	return Pending;
 }
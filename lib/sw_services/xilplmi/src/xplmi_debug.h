@@ -89,11 +89,44 @@ extern "C" {
 #endif
 #endif
 
+/* Bytes sent to UART per idle pass with PLM_PRINT_DEFERRED, ~1.4ms at 115200 */
+#define XPLMI_PRINT_DRAIN_IDLE_BYTES	(16U)
+#define XPLMI_PRINT_DRAIN_ALL		(0xFFFFFFFFU)
+
+/* Format arguments stored per deferred print, xil_printf is called with these */
+#define XPLMI_DEFER_PRINT_MAX_ARGS	(8U)
+/* Bytes stored per string argument of a deferred print, including the NUL */
+#define XPLMI_DEFER_PRINT_MAX_STR	(64U)
+
 /************************** Function Prototypes ******************************/
 /* Functions defined in xplmi_debug.c */
 int XPlmi_InitUart(void);
+int XPlmi_PrintfDeferred(u8 TimeStamp, const char8 *Ctrl, ...);
+void XPlmi_FormatDeferredPrints(void);
+u32 XPlmi_DrainDeferredPrints(u32 MaxBytes);
 
 /************************** Variable Definitions *****************************/
+#ifdef PLM_PRINT_DEFERRED
+/*
+ * The print is queued and formatted by XPlmi_DrainDeferredPrints. It is
+ * formatted at once if it does not fit in the queue.
+ */
+#define XPlmi_Printf(DebugType, ...) \
+	if(((DebugType) & (DebugLog.LogLevel)) != (u8)FALSE) { \
+		if (XPlmi_PrintfDeferred((u8)TRUE, __VA_ARGS__) != XST_SUCCESS) { \
+			XPlmi_PrintPlmTimeStamp(); \
+			xil_printf (__VA_ARGS__); \
+		} \
+	}
+
+/* Prints without TimeStamp */
+#define XPlmi_Printf_WoTimeStamp(DebugType, ...) \
+	if(((DebugType) & (DebugLog.LogLevel)) != (u8)FALSE) { \
+		if (XPlmi_PrintfDeferred((u8)FALSE, __VA_ARGS__) != XST_SUCCESS) { \
+			xil_printf (__VA_ARGS__); \
+		} \
+	}
+#else
 #define XPlmi_Printf(DebugType, ...) \
 	if(((DebugType) & (DebugLog.LogLevel)) != (u8)FALSE) { \
 		XPlmi_PrintPlmTimeStamp(); \
@@ -105,6 +138,7 @@ int XPlmi_InitUart(void);
 	if(((DebugType) & (DebugLog.LogLevel)) != (u8)FALSE) { \
 		xil_printf (__VA_ARGS__); \
 	}
+#endif
 
 #ifdef __cplusplus
 }
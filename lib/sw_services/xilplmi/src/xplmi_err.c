@@ -92,6 +92,7 @@ void XPlmi_ErrMgr(int ErrStatus)
 	 */
 	if (XPlmi_IsLoadBootPdiDone() == FALSE) {
 		XPlmi_DumpRegisters();
+		(void)XPlmi_DrainDeferredPrints(XPLMI_PRINT_DRAIN_ALL);
 		/*
 		 * If boot mode is jtag, donot reset. This is to keep
 		 * the system state intact for further debug.
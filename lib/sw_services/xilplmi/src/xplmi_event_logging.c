@@ -44,6 +44,8 @@
 #include "xplmi.h"
 
 /************************** Constant Definitions *****************************/
+/* Length of the trace log sync record in words */
+#define XPLMI_TRACE_LOG_SYNC_LEN	(XPLMI_TRACE_LOG_HDR_LEN + 4U)
 
 /**************************** Type Definitions *******************************/
 
@@ -72,6 +74,10 @@ static XPlmi_CircularBuffer TraceLog = {
 	.IsBufferFull = (u8)FALSE,
 };
 
+/* Timer value and sequence number of the last trace record */
+static u64 TraceLogLastTime;
+static u8 TraceLogSeq;
+
 
 /*****************************************************************************/
 /**
@@ -172,6 +178,8 @@ END:
  *			@Arg1 - High Address
  *			@Arg2 - Low Address
  *		7 - Retrieve Trace Log buffer information
+ *			Response also carries the trace log format and the
+ *			time stamp tick frequency
  *
  * @param	Pointer to the command structure
 
@@ -216,10 +224,12 @@ int XPlmi_EventLogging(XPlmi_Cmd * Cmd)
 			}
 			break;
 		case XPLMI_LOGGING_CMD_RETRIEVE_LOG_DATA:
+			XPlmi_FormatDeferredPrints();
 			Status = XPlmi_RetrieveBufferData(&DebugLog.LogBuffer,
 				((u64)Arg1 << 32U) | Arg2);
 			break;
 		case XPLMI_LOGGING_CMD_RETRIEVE_LOG_BUFFER_INFO:
+			XPlmi_FormatDeferredPrints();
 			Cmd->Response[1U] = (u32)(DebugLog.LogBuffer.StartAddr >> 32U);
 			Cmd->Response[2U] = (u32)(DebugLog.LogBuffer.StartAddr & 0xFFFFFFFFU);
 			Cmd->Response[3U] = (u32)(DebugLog.LogBuffer.CurrentAddr -
@@ -257,6 +267,8 @@ int XPlmi_EventLogging(XPlmi_Cmd * Cmd)
 					TraceLog.StartAddr);
 			Cmd->Response[4U] = TraceLog.Len;
 			Cmd->Response[5U] = TraceLog.IsBufferFull;
+			Cmd->Response[6U] = XPLMI_TRACE_LOG_FORMAT;
+			Cmd->Response[7U] = XPlmi_GetPmcIroFreq();
 			Status = XST_SUCCESS;
 			break;
 		default:
@@ -274,37 +286,98 @@ int XPlmi_EventLogging(XPlmi_Cmd * Cmd)
  */
 /*****************************************************************************/
 /**
- * @brief	This function stores the trace events to the Trace Log buffer.
+ * @brief	This function fills in the record header and copies the record
+ * to the Trace Log buffer at the current address.
  *
- * @param	TraceData to be stored to buffer
+ * @param	TraceData is the record with event ID and timestamp delta filled
  * @param	Len is number of words in TraceData
  *
  * @return	None
  *
  *****************************************************************************/
-void XPlmi_StoreTraceLog(u32 *TraceData, u32 Len)
+static void XPlmi_WriteTraceRecord(const u32 *TraceData, u32 Len)
 {
 	u32 Index;
-	XPlmi_PerfTime PerfTime = {0U};
+	u64 Addr = TraceLog.CurrentAddr;
+
+	XPlmi_Out64(Addr, (TraceData[0U] & XPLMI_TRACE_LOG_ID_MASK) |
+		((Len & XPLMI_TRACE_LOG_LEN_MASK) << XPLMI_TRACE_LOG_LEN_SHIFT) |
+		((u32)TraceLogSeq << XPLMI_TRACE_LOG_SEQ_SHIFT));
+	for (Index = 1U; Index < Len; Index++) {
+		Addr += XPLMI_WORD_LEN;
+		XPlmi_Out64(Addr, TraceData[Index]);
+	}
+	TraceLog.CurrentAddr = Addr + XPLMI_WORD_LEN;
+	++TraceLogSeq;
+}
 
-	/* Get time stamp of PLM */
-	XPlmi_MeasurePerfTime((XPLMI_PIT1_CYCLE_VALUE << 32U) |
-		XPLMI_PIT2_CYCLE_VALUE, &PerfTime);
+/*****************************************************************************/
+/**
+ * @brief	This function stores the trace events to the Trace Log buffer.
+ * The time stamp is taken with a single timer read and stored as the raw
+ * tick delta to the previous record, so no time conversion is done while
+ * logging. Records that do not fit in the rest of the buffer restart at
+ * the buffer start address behind a sync record carrying absolute time.
+ * A record that cannot fit in the whole buffer is dropped.
+ *
+ * @param	TraceData to be stored to buffer, word 0 carries the event ID
+ * @param	Len is number of words in TraceData
+ *
+ * @return	None
+ *
+ *****************************************************************************/
+void XPlmi_StoreTraceLog(u32 *TraceData, u32 Len)
+{
+	u64 CurTime = XPlmi_GetTimerValue();
+	u64 EndAddr = TraceLog.StartAddr + TraceLog.Len;
+	u64 Delta = TraceLogLastTime - CurTime;
+	u64 Elapsed;
+	u32 SyncData[XPLMI_TRACE_LOG_SYNC_LEN];
+	u32 RecLen = Len;
 
-	TraceData[0U] = TraceData[0U] | (Len << XPLMI_TRACE_LOG_LEN_SHIFT);
-	TraceData[1U] = (u32)PerfTime.TPerfMs;
-	TraceData[2U] = (u32)PerfTime.TPerfMsFrac;
+	if ((Len < XPLMI_TRACE_LOG_HDR_LEN) || (Len > XPLMI_TRACE_LOG_LEN_MASK)) {
+		goto END;
+	}
 
-	for (Index = 0U; Index < Len; Index++) {
-		if (TraceLog.CurrentAddr >=
-				(TraceLog.StartAddr + TraceLog.Len)) {
-			TraceLog.CurrentAddr = TraceLog.StartAddr;
-			TraceLog.IsBufferFull = (u8)TRUE;
+	/*
+	 * A sync record is needed at the buffer start and whenever the
+	 * delta to the previous record does not fit in one word
+	 */
+	if ((TraceLog.CurrentAddr == TraceLog.StartAddr) ||
+		(Delta > 0xFFFFFFFFU)) {
+		RecLen += XPLMI_TRACE_LOG_SYNC_LEN;
+	}
+	if ((TraceLog.CurrentAddr + ((u64)RecLen * XPLMI_WORD_LEN)) > EndAddr) {
+		TraceLog.CurrentAddr = TraceLog.StartAddr;
+		TraceLog.IsBufferFull = (u8)TRUE;
+		RecLen = Len + XPLMI_TRACE_LOG_SYNC_LEN;
+		/* Drop the record if the buffer cannot hold it at all */
+		if ((TraceLog.StartAddr + ((u64)RecLen * XPLMI_WORD_LEN)) >
+			EndAddr) {
+			goto END;
 		}
+	}
 
-		XPlmi_Out64(TraceLog.CurrentAddr, TraceData[Index]);
-		TraceLog.CurrentAddr += XPLMI_WORD_LEN;
+	if (RecLen != Len) {
+		/* PIT timers count down from the cycle value */
+		Elapsed = ((XPLMI_PIT1_CYCLE_VALUE << 32U) |
+			XPLMI_PIT2_CYCLE_VALUE) - CurTime;
+		SyncData[0U] = XPLMI_TRACE_LOG_SYNC;
+		SyncData[1U] = 0U;
+		SyncData[2U] = XPLMI_TRACE_LOG_FORMAT;
+		SyncData[3U] = (u32)(Elapsed & 0xFFFFFFFFU);
+		SyncData[4U] = (u32)(Elapsed >> 32U);
+		SyncData[5U] = XPlmi_GetPmcIroFreq();
+		XPlmi_WriteTraceRecord(SyncData, XPLMI_TRACE_LOG_SYNC_LEN);
+		Delta = 0U;
 	}
+
+	TraceData[1U] = (u32)Delta;
+	XPlmi_WriteTraceRecord(TraceData, Len);
+	TraceLogLastTime = CurTime;
+
+END:
+	return;
 }
 
 /**
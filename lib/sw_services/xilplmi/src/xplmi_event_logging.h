@@ -72,20 +72,51 @@ void XPlmi_StoreTraceLog(u32 *TraceData, u32 Len);
 #define XPLMI_LOGGING_CMD_RETRIEVE_TRACE_DATA	(0x6U)
 #define XPLMI_LOGGING_CMD_RETRIEVE_TRACE_BUFFER_INFO	(0x7U)
 
-/* Trace log buffer length shift */
+/* Trace log record header fields */
+#define XPLMI_TRACE_LOG_ID_MASK		(0xFFFFU)
 #define XPLMI_TRACE_LOG_LEN_SHIFT		(16U)
+#define XPLMI_TRACE_LOG_LEN_MASK		(0xFFU)
+#define XPLMI_TRACE_LOG_SEQ_SHIFT		(24U)
+#define XPLMI_TRACE_LOG_SEQ_MASK		(0xFFU)
+
+/* Number of header words in every trace record */
+#define XPLMI_TRACE_LOG_HDR_LEN		(2U)
+
+/* Trace log format, carried by sync records and the buffer information */
+#define XPLMI_TRACE_LOG_MAGIC		(0x54524300U)	/* "TRC" */
+#define XPLMI_TRACE_LOG_MAGIC_MASK		(0xFFFFFF00U)
+#define XPLMI_TRACE_LOG_VERSION		(0x2U)
+#define XPLMI_TRACE_LOG_FORMAT		(XPLMI_TRACE_LOG_MAGIC | \
+						XPLMI_TRACE_LOG_VERSION)
 
 /* Trace event IDs */
+#define XPLMI_TRACE_LOG_SYNC			(0x0U)
 #define XPLMI_TRACE_LOG_LOAD_IMAGE		(0x1U)
 
 /*
  * Trace log functions
  * TraceBuffer structure
  * 		0U - Header
- * 		1U - Time stamp in ms
- * 		2U - Time stamp fraction
- * 		3U - Payload
+ * 			[31:24] Sequence number, increments by one per record
+ * 			[23:16] Record length in words including header
+ * 			[15:0]  Trace event ID
+ * 		1U - PIT ticks elapsed since the previous record
+ * 		2U - Payload
  * 		...
+ *
+ * A record never straddles the end of the buffer. The first record at
+ * the buffer start address, either after configuration or after the
+ * buffer wraps, is an XPLMI_TRACE_LOG_SYNC record with the payload
+ * 		2U - XPLMI_TRACE_LOG_FORMAT, magic and layout version
+ * 		3U - PIT ticks elapsed since PLM start, low word
+ * 		4U - PIT ticks elapsed since PLM start, high word
+ * 		5U - PIT tick frequency in Hz
+ * Deltas of the records that follow accumulate on top of it. Sequence
+ * numbers of consecutive records differ by one, so a reader can find
+ * where the valid records end. Version 1, without sequence numbers and
+ * sync records, stored the time stamp as milliseconds and fraction in
+ * words 1U and 2U. The retrieve trace buffer information command returns
+ * the format and the tick frequency in response words 6U and 7U.
  */
 /*****************************************************************************/
 /**
@@ -98,7 +129,7 @@ void XPlmi_StoreTraceLog(u32 *TraceData, u32 Len);
  ******************************************************************************/
 static inline void XPlmi_TraceLog2(u32 Header)
 {
-        u32 TraceBuffer[] = {Header, 0U, 0U};
+        u32 TraceBuffer[] = {Header, 0U};
         XPlmi_StoreTraceLog(TraceBuffer, XPLMI_ARRAY_SIZE(TraceBuffer));
 }
 
@@ -114,7 +145,7 @@ static inline void XPlmi_TraceLog2(u32 Header)
  *****************************************************************************/
 static inline void XPlmi_TraceLog3(u32 Header, u32 Arg1)
 {
-	u32 TraceBuffer[] = {Header, 0U, 0U, Arg1};
+	u32 TraceBuffer[] = {Header, 0U, Arg1};
 	XPlmi_StoreTraceLog(TraceBuffer, XPLMI_ARRAY_SIZE(TraceBuffer));
 }
 
@@ -131,7 +162,7 @@ static inline void XPlmi_TraceLog3(u32 Header, u32 Arg1)
  *****************************************************************************/
 static inline void XPlmi_TraceLog4(u32 Header, u32 Arg1, u32 Arg2)
 {
-	u32 TraceBuffer[] = {Header, 0U, 0U, Arg1, Arg2};
+	u32 TraceBuffer[] = {Header, 0U, Arg1, Arg2};
 	XPlmi_StoreTraceLog(TraceBuffer, XPLMI_ARRAY_SIZE(TraceBuffer));
 }
 
@@ -149,7 +180,7 @@ static inline void XPlmi_TraceLog4(u32 Header, u32 Arg1, u32 Arg2)
  *****************************************************************************/
 static inline void XPlmi_TraceLog5(u32 Header, u32 Arg1, u32 Arg2, u32 Arg3)
 {
-	u32 TraceBuffer[] = {Header, 0U, 0U, Arg1, Arg2, Arg3};
+	u32 TraceBuffer[] = {Header, 0U, Arg1, Arg2, Arg3};
 	XPlmi_StoreTraceLog(TraceBuffer, XPLMI_ARRAY_SIZE(TraceBuffer));
 }
 
@@ -169,7 +169,8 @@ static inline void XPlmi_PpuWakeUpDis(void)
 
 /*
  * PMC RAM Memory usage:
- * 0xF2000000U to 0xF2010100U - Used by XilLoader to process CDO
+ * 0xF2000000U to 0xF2010200U - Used by XilLoader to process CDO and to stage
+ *                              secure chunks
  * 0xF2014000U to 0xF2014FFFU - Used for PLM Runtime Configuration Registers
  * 0xF2019000U to 0xF201D000U - Used by XilPlmi to store PLM prints
  * 0xF201D000U to 0xF201E000U - Used by XilPlmi to store PLM Trace Events
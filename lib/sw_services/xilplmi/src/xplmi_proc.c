@@ -165,6 +165,21 @@ void XPlmi_GetPerfTime(u64 TCur, u64 TStart, XPlmi_PerfTime *PerfTime)
 	PerfTime->TPerfMsFrac = PerfNs % (u64)XPLMI_MEGA;
 }
 
+/*****************************************************************************/
+/**
+ * @brief	This function returns the PMC IRO frequency which clocks the PIT
+ * timers. It is used to convert raw timer ticks into time.
+ *
+ * @param	None
+ *
+ * @return	PMC IRO frequency in Hz
+ *
+ *****************************************************************************/
+u32 XPlmi_GetPmcIroFreq(void)
+{
+	return PmcIroFreq;
+}
+
 /*****************************************************************************/
 /**
  * @brief	This function measures the total time taken between two points for
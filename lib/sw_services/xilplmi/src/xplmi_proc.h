@@ -126,6 +126,7 @@ int XPlmi_RegisterHandler(u32 IntrId, GicIntHandler_t Handler, void *Data);
 void XPlmi_PrintRomTime(void);
 void XPlmi_PrintPlmTimeStamp(void);
 void XPlmi_GetPerfTime(u64 TCur, u64 TStart, XPlmi_PerfTime *PerfTime);
+u32 XPlmi_GetPmcIroFreq(void);
 
 /* Handler Table Structure */
 struct HandlerTable {
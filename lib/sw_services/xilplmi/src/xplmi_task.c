@@ -230,6 +230,13 @@ void XPlmi_TaskDispatchLoop(void)
 		/*
 		 * Goto sleep when all queues are empty
 		 */
+		/*
+		 * Format and send deferred prints in small chunks so that new
+		 * tasks are picked up without waiting for the whole backlog
+		 */
+		if (XPlmi_DrainDeferredPrints(XPLMI_PRINT_DRAIN_IDLE_BYTES) != 0U) {
+			continue;
+		}
 		XPlmi_Printf(DEBUG_DETAILED,
 			"No pending tasks..Going to sleep\n\r");
 		mb_sleep();
@@ -0,0 +1,20 @@
+/******************************************************************************
+* Copyright (C) 2020 Xilinx, Inc.  All rights reserved.
+* SPDX-License-Identifier: MIT
+******************************************************************************/
+
+/* MicroBlaze interrupt control of the host tests, provided by the model */
+#ifndef _MICROBLAZE_INTERFACE_H_
+#define _MICROBLAZE_INTERFACE_H_
+
+#include "xil_types.h"
+
+UINTPTR SimMsr(void);
+void SimMtmsr(UINTPTR Msr);
+void SimDisableIrq(void);
+
+#define mfmsr()				SimMsr()
+#define mtmsr(Msr)			SimMtmsr(Msr)
+#define microblaze_disable_interrupts()	SimDisableIrq()
+
+#endif
@@ -0,0 +1,965 @@
+/******************************************************************************
+* Copyright (C) 2020 Xilinx, Inc.  All rights reserved.
+* SPDX-License-Identifier: MIT
+******************************************************************************/
+
+/*****************************************************************************/
+/**
+*
+* @file test_xplmi_logging.c
+*
+* Host test of the PLM trace log, its host decoder and the deferred prints.
+*
+* The trace tests log events with XPlmi_TraceLog3() at known PIT tick
+* counts, read the buffer out with the retrieve trace buffer command and
+* decode it with the decoder of tools/xplmi_trace_decode.c. The decoded
+* events must carry the logged IDs, arguments and times, including after
+* the buffer wraps, when the time between two events does not fit in a
+* delta word, and when a record in the middle is corrupted. The buffer
+* information command must return the format word and the tick frequency,
+* and a version 1 buffer must be rejected. The text and Chrome trace JSON
+* output of the decoder are checked as well.
+*
+* The print tests run XPlmi_Printf() with PLM_PRINT_DEFERRED, the default
+* in xplmi_config.h, against a model of the debug log buffer and the PS
+* UART. Characters sent to the UART are timed at 115200 baud. A boot
+* sequence of prints must not format or send anything when printed, and
+* the idle drain must then format one print and send at most
+* XPLMI_PRINT_DRAIN_IDLE_BYTES per call. The resulting log and UART output
+* must match the prints formatted at once with the time stamps of the
+* calls, although the string arguments are overwritten after each call.
+* Prints that do not fit in the queue or have too many arguments must be
+* printed at once, and no print may be lost. Interrupts are modelled: an
+* interrupt handler that prints runs whenever interrupts are enabled while
+* the drain formats or sends, and every write to the debug log and to the
+* UART byte count must happen with interrupts masked.
+*
+* Build and run on the host:
+*   cc -Wall -O2 -I. -I../src -I../../../bsp/standalone/src/common \
+*      -I../../../bsp/standalone/src/arm/cortexa9 \
+*      test_xplmi_logging.c -o test_xplmi_logging
+*   ./test_xplmi_logging
+*
+******************************************************************************/
+
+/***************************** Include Files *********************************/
+
+#include <stdio.h>
+#include <stdarg.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "xil_types.h"
+#include "xstatus.h"
+#include "xparameters.h"
+
+/************************** Stubs ********************************************/
+
+/* Headers of the PLM that need the hardware are replaced by the model */
+#define XIL_IO_H
+#define XIL_PRINTF_H
+void xil_printf(const char8 *Format, ...);
+
+#define XPLMI_H
+#define UART_INITIALIZED	((u8)(1U << 0U))
+u8 LpdInitialized;
+
+#define XPLMI_HW_H
+#define XPLMI_PMCRAM_BASEADDR		0xF2000000U
+#define XPLMI_DEBUG_LOG_BUFFER_ADDR	0U
+#define XPLMI_DEBUG_LOG_BUFFER_LEN	0U
+#define XPLMI_TRACE_LOG_BUFFER_ADDR	0U
+#define XPLMI_TRACE_LOG_BUFFER_LEN	0U
+static void SimOut64(u64 Addr, u32 Data);
+static void SimOutByte64(u64 Addr, u8 Data);
+static u8 SimInByte64(u64 Addr);
+#define XPlmi_Out64(Addr, Data)		SimOut64((Addr), (Data))
+#define XPlmi_OutByte64(Addr, Data)	SimOutByte64((Addr), (u8)(Data))
+#define XPlmi_InByte64(Addr)		SimInByte64(Addr)
+
+#define XPLMI_DMA_H
+#define XPLMI_PMCDMA_0		0x100U
+static int XPlmi_DmaXfr(u64 SrcAddr, u64 DestAddr, u32 Len, u32 Flags);
+
+#define XPLMI_PROC_H
+#define XPLMI_PIT1_CYCLE_VALUE		((u64)0xFFFFFFFDU + 1U)
+#define XPLMI_PIT2_CYCLE_VALUE		(0xFFFFFFFEU + 1U)
+typedef struct XPlmi_PerfTime {
+	u64 TPerfMs;
+	u64 TPerfMsFrac;
+} XPlmi_PerfTime;
+static u64 XPlmi_GetTimerValue(void);
+static void XPlmi_GetPerfTime(u64 TCur, u64 TStart, XPlmi_PerfTime *PerfTime);
+static void XPlmi_PrintPlmTimeStamp(void);
+static u32 XPlmi_GetPmcIroFreq(void);
+
+#include "../src/xplmi_event_logging.c"
+#include "../src/xplmi_debug.c"
+
+#define XPLMI_TRACE_DECODE_NO_MAIN
+#include "../tools/xplmi_trace_decode.c"
+
+/************************** Constant Definitions *****************************/
+
+#define SIM_FREQ		320000000U	/* PMC IRO */
+#define SIM_TRACE_WORDS		256U
+#define SIM_LOG_LEN		16384U
+#define SIM_UART_LEN		65536U
+#define SIM_UART_NS_PER_BYTE	86806U		/* 115200 baud, 8N1 */
+#define SIM_MAX_EVENTS		4096U
+#define SIM_MAX_LINES		512U
+#define SIM_LINE_LEN		160U
+#define SIM_MAX_IRQS		60U
+#define SIM_QUEUE_PRINTS	80U
+
+#define CHECK(Cond, Msg) do { \
+	if (!(Cond)) { \
+		printf("FAIL %s:%d: %s\n", __func__, __LINE__, (Msg)); \
+		++Failures; \
+	} \
+} while (0)
+
+/**************************** Type Definitions *******************************/
+
+typedef struct {
+	u32 Count;
+	u32 Id[SIM_MAX_EVENTS];
+	u32 Seq[SIM_MAX_EVENTS];
+	u64 Ticks[SIM_MAX_EVENTS];
+	u32 Arg[SIM_MAX_EVENTS];
+	u32 NumArgs[SIM_MAX_EVENTS];
+} EventLog;
+
+typedef struct {
+	u32 Count;
+	char Text[SIM_MAX_LINES][SIM_LINE_LEN];
+} LineLog;
+
+/************************** Variable Definitions *****************************/
+
+static u32 Failures;
+
+/* Model state */
+static u64 SimTicks;		/* PIT ticks since PLM start */
+static u32 SimIe = 1U;		/* Interrupts enabled */
+static u32 SimUnmaskedWrites;	/* Debug log writes with interrupts enabled */
+static u32 SimTrace[SIM_TRACE_WORDS];
+static u32 SimTraceOut[SIM_TRACE_WORDS];
+static u8 SimLog[SIM_LOG_LEN];
+static u8 SimUart[SIM_UART_LEN];
+static u32 SimUartLen;
+static u32 SimOutbytes;		/* Bytes logged through outbyte */
+static u32 SimFormats;		/* xil_printf calls */
+
+/* Interrupt handler, run when interrupts are enabled and one is pending */
+static u32 SimIrqPending;
+static u32 SimIrqCount;
+static u32 SimIrqEvery;		/* Raise an interrupt every N model steps */
+static u32 SimIrqStep;
+static int SimInIrq;
+static int SimIrqDrains;	/* Handler drains all prints */
+static u32 SimIrqBusy;		/* Handler drains during formatting */
+
+/* Format strings of the queue test, one per print */
+static char QueueFmt[SIM_QUEUE_PRINTS][16];
+
+/************************** Simulator ****************************************/
+
+static int SimIsLog(u64 Addr)
+{
+	return (Addr >= (UINTPTR)SimLog) &&
+		(Addr < ((UINTPTR)SimLog + SIM_LOG_LEN));
+}
+
+static void SimOut64(u64 Addr, u32 Data)
+{
+	memcpy((void *)(UINTPTR)Addr, &Data, sizeof(Data));
+}
+
+static void SimOutByte64(u64 Addr, u8 Data)
+{
+	if (SimIsLog(Addr) && (SimIe != 0U)) {
+		++SimUnmaskedWrites;
+	}
+	*(u8 *)(UINTPTR)Addr = Data;
+}
+
+static u8 SimInByte64(u64 Addr)
+{
+	return *(const u8 *)(UINTPTR)Addr;
+}
+
+static int XPlmi_DmaXfr(u64 SrcAddr, u64 DestAddr, u32 Len, u32 Flags)
+{
+	(void)Flags;
+	memmove((void *)(UINTPTR)DestAddr, (const void *)(UINTPTR)SrcAddr,
+		(size_t)Len * XPLMI_WORD_LEN);
+	return XST_SUCCESS;
+}
+
+/* PIT1:PIT2 count down from the cycle value */
+static u64 XPlmi_GetTimerValue(void)
+{
+	return ((XPLMI_PIT1_CYCLE_VALUE << 32U) | XPLMI_PIT2_CYCLE_VALUE) -
+		SimTicks;
+}
+
+static void XPlmi_GetPerfTime(u64 TCur, u64 TStart, XPlmi_PerfTime *PerfTime)
+{
+	u64 PerfNs = ((TCur - TStart) * 1000000000ULL) / SIM_FREQ;
+
+	PerfTime->TPerfMs = PerfNs / 1000000U;
+	PerfTime->TPerfMsFrac = PerfNs % 1000000U;
+}
+
+static void XPlmi_PrintPlmTimeStamp(void)
+{
+	XPlmi_PerfTime PerfTime;
+
+	XPlmi_GetPerfTime((XPLMI_PIT1_CYCLE_VALUE << 32U) |
+		XPLMI_PIT2_CYCLE_VALUE, XPlmi_GetTimerValue(), &PerfTime);
+	xil_printf("[%u.%06u]", (u32)PerfTime.TPerfMs,
+		(u32)PerfTime.TPerfMsFrac);
+}
+
+static u32 XPlmi_GetPmcIroFreq(void)
+{
+	return SIM_FREQ;
+}
+
+/* An interrupt handler that prints, as the PLM error and IPI handlers do */
+static void SimIrqHandler(void)
+{
+	SimIrqPending = 0U;
+	SimInIrq = 1;
+	SimIe = 0U;
+	++SimIrqCount;
+	XPlmi_Printf(DEBUG_GENERAL, "irq %u\n\r", SimIrqCount);
+	if (SimIrqDrains != 0) {
+		if (DeferPrintBusy == (u8)TRUE) {
+			++SimIrqBusy;
+		}
+		/* Error manager before the boot PDI is done */
+		(void)XPlmi_DrainDeferredPrints(XPLMI_PRINT_DRAIN_ALL);
+	}
+	SimIe = 1U;
+	SimInIrq = 0;
+}
+
+static void SimStep(void)
+{
+	if ((SimIrqEvery != 0U) && (SimInIrq == 0) &&
+		(SimIrqCount < SIM_MAX_IRQS) && (++SimIrqStep >= SimIrqEvery)) {
+		SimIrqStep = 0U;
+		SimIrqPending = 1U;
+	}
+	if ((SimIrqPending != 0U) && (SimIe != 0U) && (SimInIrq == 0)) {
+		SimIrqHandler();
+	}
+}
+
+UINTPTR SimMsr(void)
+{
+	return SimIe;
+}
+
+void SimMtmsr(UINTPTR Msr)
+{
+	SimIe = (u32)Msr;
+	SimStep();
+}
+
+void SimDisableIrq(void)
+{
+	SimIe = 0U;
+}
+
+void XUartPsv_SendByte(UINTPTR BaseAddr, u8 Data)
+{
+	(void)BaseAddr;
+	if (SimUartLen < SIM_UART_LEN) {
+		SimUart[SimUartLen] = Data;
+	}
+	++SimUartLen;
+	SimStep();
+}
+
+void xil_printf(const char8 *Format, ...)
+{
+	char Buf[512];
+	va_list Args;
+	int Len;
+	int Idx;
+
+	++SimFormats;
+	va_start(Args, Format);
+	Len = vsnprintf(Buf, sizeof(Buf), Format, Args);
+	va_end(Args);
+	for (Idx = 0; Idx < Len; ++Idx) {
+		outbyte(Buf[Idx]);
+		++SimOutbytes;
+		SimStep();
+	}
+}
+
+/************************** Test Helpers *************************************/
+
+static void SimReset(void)
+{
+	SimTicks = 1000U;
+	SimIe = 1U;
+	SimUnmaskedWrites = 0U;
+	SimUartLen = 0U;
+	SimOutbytes = 0U;
+	SimFormats = 0U;
+	SimIrqPending = 0U;
+	SimIrqCount = 0U;
+	SimIrqEvery = 0U;
+	SimIrqStep = 0U;
+	SimIrqDrains = 0;
+	SimIrqBusy = 0U;
+	memset(SimLog, 0, sizeof(SimLog));
+	memset(SimUart, 0, sizeof(SimUart));
+
+	LpdInitialized = UART_INITIALIZED;
+	DebugLog.LogLevel = (u8)XPlmiDbgCurrentTypes;
+	DebugLog.LogBuffer.StartAddr = (UINTPTR)SimLog;
+	DebugLog.LogBuffer.CurrentAddr = (UINTPTR)SimLog;
+	DebugLog.LogBuffer.Len = SIM_LOG_LEN;
+	DebugLog.LogBuffer.IsBufferFull = (u8)FALSE;
+	UartPendingLen = 0U;
+	DeferPrintHead = 0U;
+	DeferPrintTail = 0U;
+	DeferPrintBusy = (u8)FALSE;
+
+	memset(SimTrace, 0, sizeof(SimTrace));
+	TraceLog.StartAddr = (UINTPTR)SimTrace;
+	TraceLog.CurrentAddr = (UINTPTR)SimTrace;
+	TraceLog.Len = SIM_TRACE_WORDS * XPLMI_WORD_LEN;
+	TraceLog.IsBufferFull = (u8)FALSE;
+	TraceLogLastTime = 0U;
+	TraceLogSeq = 0U;
+}
+
+static void EventSink(void *Ctx, const TraceEvent *Event)
+{
+	EventLog *Log = (EventLog *)Ctx;
+
+	if ((Event->Id == TRACE_ID_SYNC) || (Log->Count >= SIM_MAX_EVENTS)) {
+		return;
+	}
+	Log->Id[Log->Count] = Event->Id;
+	Log->Seq[Log->Count] = Event->Seq;
+	Log->Ticks[Log->Count] = Event->Ticks;
+	Log->NumArgs[Log->Count] = Event->NumArgs;
+	Log->Arg[Log->Count] = (Event->NumArgs != 0U) ? Event->Args[0U] : 0U;
+	++Log->Count;
+}
+
+/* Reads the trace buffer out as the retrieve command does, oldest first */
+static u32 TraceRetrieve(XPlmi_Cmd *Cmd)
+{
+	u32 Payload[4U];
+	u64 Dest = (UINTPTR)SimTraceOut;
+
+	memset(SimTraceOut, 0, sizeof(SimTraceOut));
+	memset(Cmd, 0, sizeof(*Cmd));
+	Payload[0U] = XPLMI_LOGGING_CMD_RETRIEVE_TRACE_DATA;
+	Payload[1U] = (u32)(Dest >> 32U);
+	Payload[2U] = (u32)Dest;
+	Payload[3U] = 0U;
+	Cmd->Payload = Payload;
+	CHECK(XPlmi_EventLogging(Cmd) == XST_SUCCESS, "retrieve trace data");
+
+	memset(Cmd, 0, sizeof(*Cmd));
+	Payload[0U] = XPLMI_LOGGING_CMD_RETRIEVE_TRACE_BUFFER_INFO;
+	Cmd->Payload = Payload;
+	CHECK(XPlmi_EventLogging(Cmd) == XST_SUCCESS, "retrieve trace info");
+
+	return Cmd->Response[4U] / XPLMI_WORD_LEN;
+}
+
+/* Logs Count events Step ticks apart, event N has argument Base + N */
+static void TraceEvents(u32 Count, u64 Step, u32 Base)
+{
+	u32 Idx;
+
+	for (Idx = 0U; Idx < Count; ++Idx) {
+		SimTicks += Step;
+		XPlmi_TraceLog3(XPLMI_TRACE_LOG_LOAD_IMAGE, Base + Idx);
+	}
+}
+
+/*
+ * Checks that the decoded events are the last ones logged, contiguous, with
+ * the argument Base + N of event N logged at Start + (N + 1) * Step.
+ */
+static void CheckEvents(const EventLog *Log, u32 Logged, u64 Start, u64 Step,
+	u32 Base)
+{
+	u32 Idx;
+	u32 N;
+	u32 Bad = 0U;
+
+	CHECK(Log->Count <= Logged, "more events decoded than logged");
+	for (Idx = 0U; Idx < Log->Count; ++Idx) {
+		N = Logged - Log->Count + Idx;
+		if ((Log->Id[Idx] != XPLMI_TRACE_LOG_LOAD_IMAGE) ||
+			(Log->NumArgs[Idx] != 1U) ||
+			(Log->Arg[Idx] != (Base + N)) ||
+			(Log->Ticks[Idx] != (Start + ((u64)(N + 1U) * Step)))) {
+			++Bad;
+		}
+	}
+	CHECK(Bad == 0U, "decoded event differs from the logged one");
+}
+
+static const char *LogText(void)
+{
+	static char Text[SIM_LOG_LEN + 1U];
+	u32 Len = (u32)(DebugLog.LogBuffer.CurrentAddr -
+		DebugLog.LogBuffer.StartAddr);
+
+	memcpy(Text, SimLog, Len);
+	Text[Len] = '\0';
+	return Text;
+}
+
+static u32 CountOf(const char *Text, const char *Sub)
+{
+	u32 Count = 0U;
+	const char *Pos = Text;
+
+	while ((Pos = strstr(Pos, Sub)) != NULL) {
+		++Count;
+		Pos += strlen(Sub);
+	}
+	return Count;
+}
+
+/* Expected output of a print with time stamp at the current time */
+static void Expect(LineLog *Lines, const char *Format, ...)
+{
+	XPlmi_PerfTime PerfTime;
+	va_list Args;
+	int Len;
+
+	XPlmi_GetPerfTime((XPLMI_PIT1_CYCLE_VALUE << 32U) |
+		XPLMI_PIT2_CYCLE_VALUE, XPlmi_GetTimerValue(), &PerfTime);
+	Len = snprintf(Lines->Text[Lines->Count], SIM_LINE_LEN, "[%u.%06u]",
+		(u32)PerfTime.TPerfMs, (u32)PerfTime.TPerfMsFrac);
+	va_start(Args, Format);
+	vsnprintf(Lines->Text[Lines->Count] + Len, SIM_LINE_LEN - (u32)Len,
+		Format, Args);
+	va_end(Args);
+	++Lines->Count;
+}
+
+/* Drains with the idle budget until nothing is pending */
+static u32 DrainIdle(u32 *MaxBytes, u32 *MaxFormats)
+{
+	u32 Calls = 0U;
+	u32 Uart;
+	u32 Formats;
+	u32 Pending;
+
+	*MaxBytes = 0U;
+	*MaxFormats = 0U;
+	do {
+		Uart = SimUartLen;
+		Formats = SimFormats;
+		Pending = XPlmi_DrainDeferredPrints(XPLMI_PRINT_DRAIN_IDLE_BYTES);
+		if ((SimUartLen - Uart) > *MaxBytes) {
+			*MaxBytes = SimUartLen - Uart;
+		}
+		if ((SimFormats - Formats) > *MaxFormats) {
+			*MaxFormats = SimFormats - Formats;
+		}
+		++Calls;
+	} while ((Pending != 0U) && (Calls < 1000000U));
+
+	return Calls;
+}
+
+/************************** Tests ********************************************/
+
+static void TestTraceRoundTrip(void)
+{
+	XPlmi_Cmd Cmd;
+	EventLog Log;
+	TraceStats Stats;
+	u32 Words;
+	u64 Start;
+
+	SimReset();
+	Start = SimTicks;
+	TraceEvents(20U, 5000U, 0x1C000000U);
+	Words = TraceRetrieve(&Cmd);
+
+	CHECK(Cmd.Response[6U] == XPLMI_TRACE_LOG_FORMAT,
+		"buffer information carries the format");
+	CHECK(XPLMI_TRACE_LOG_FORMAT == TRACE_FORMAT,
+		"decoder and PLM agree on the format");
+	CHECK((Cmd.Response[6U] & XPLMI_TRACE_LOG_MAGIC_MASK) ==
+		XPLMI_TRACE_LOG_MAGIC, "format word carries the magic");
+	CHECK(Cmd.Response[7U] == SIM_FREQ,
+		"buffer information carries the tick frequency");
+
+	memset(&Log, 0, sizeof(Log));
+	CHECK(TraceDecode(SimTraceOut, Words, EventSink, &Log, &Stats) == 0,
+		"decode");
+	CHECK(Log.Count == 20U, "all events decoded");
+	CHECK(Stats.Syncs == 1U, "one sync record at the buffer start");
+	CheckEvents(&Log, 20U, Start, 5000U, 0x1C000000U);
+}
+
+static void TestTraceWrap(void)
+{
+	XPlmi_Cmd Cmd;
+	EventLog Log;
+	TraceStats Stats;
+	u32 Words;
+	u64 Start;
+
+	/*
+	 * A pass of 256 words holds the sync record and 83 3-word records,
+	 * so 1050 events are 12 passes and 54 events. Records of the previous
+	 * pass behind the last one have no time reference and are skipped.
+	 */
+	SimReset();
+	Start = SimTicks;
+	TraceEvents(1050U, 777U, 0x100U);
+	Words = TraceRetrieve(&Cmd);
+	CHECK(Cmd.Response[5U] == (u32)TRUE, "buffer wrapped");
+
+	memset(&Log, 0, sizeof(Log));
+	CHECK(TraceDecode(SimTraceOut, Words, EventSink, &Log, &Stats) == 0,
+		"decode");
+	CHECK(Log.Count == 54U, "events of the last pass decoded");
+	CheckEvents(&Log, 1050U, Start, 777U, 0x100U);
+	CHECK(Stats.Skipped == (Words - XPLMI_TRACE_LOG_SYNC_LEN - (54U * 3U)),
+		"only the previous pass is skipped");
+}
+
+static void TestTraceGap(void)
+{
+	XPlmi_Cmd Cmd;
+	EventLog Log;
+	TraceStats Stats;
+	u32 Words;
+	u64 Start;
+
+	/* Events 20 s apart need more than one delta word */
+	SimReset();
+	Start = SimTicks;
+	TraceEvents(5U, 20ULL * SIM_FREQ, 0x200U);
+	Words = TraceRetrieve(&Cmd);
+
+	memset(&Log, 0, sizeof(Log));
+	CHECK(TraceDecode(SimTraceOut, Words, EventSink, &Log, &Stats) == 0,
+		"decode");
+	CHECK(Log.Count == 5U, "all events decoded");
+	CHECK(Stats.Syncs == 5U, "sync record before every long gap");
+	CheckEvents(&Log, 5U, Start, 20ULL * SIM_FREQ, 0x200U);
+}
+
+static void TestTraceCorrupt(void)
+{
+	XPlmi_Cmd Cmd;
+	EventLog Log;
+	TraceStats Stats;
+	u32 Words;
+	u32 Old[] = {
+		/* Version 1: ID | length, time in ms and fraction, argument */
+		0x1U | (4U << 16U), 12U, 500000U, 0x1C000000U,
+		0x1U | (4U << 16U), 13U, 0U, 0x1C000001U,
+	};
+
+	SimReset();
+	memset(&Log, 0, sizeof(Log));
+	CHECK(TraceDecode(Old, XPLMI_ARRAY_SIZE(Old), EventSink, &Log,
+		&Stats) == -1, "version 1 buffer rejected");
+	CHECK(Log.Count == 0U, "nothing decoded from version 1");
+
+	/* A broken sequence number ends the records at that point */
+	TraceEvents(10U, 1000U, 0x300U);
+	Words = TraceRetrieve(&Cmd);
+	SimTraceOut[XPLMI_TRACE_LOG_SYNC_LEN + (5U * 3U)] ^=
+		(u32)0x80U << XPLMI_TRACE_LOG_SEQ_SHIFT;
+	memset(&Log, 0, sizeof(Log));
+	CHECK(TraceDecode(SimTraceOut, Words, EventSink, &Log, &Stats) == 0,
+		"decode");
+	CHECK(Log.Count == 5U, "records before the broken one decoded");
+}
+
+static void TestTraceOutput(void)
+{
+	XPlmi_Cmd Cmd;
+	TraceStats Stats;
+	char *Text = NULL;
+	size_t Len = 0U;
+	FILE *Out;
+	u32 Words;
+	u32 Depth = 0U;
+	u32 Idx;
+
+	/* 10000 ticks at 320 MHz are 31.25 us */
+	SimReset();
+	SimTicks = 0U;
+	TraceEvents(3U, 10000U, 0x1C000000U);
+	Words = TraceRetrieve(&Cmd);
+
+	Out = open_memstream(&Text, &Len);
+	CHECK(TraceWrite(SimTraceOut, Words, 0, Out, &Stats) == 0, "text");
+	fclose(Out);
+	CHECK(strstr(Text, "[0.031250] LoadImage    seq   1 0x1C000000\n") !=
+		NULL, "first text line");
+	CHECK(strstr(Text, "[0.093750] LoadImage    seq   3 0x1C000002\n") !=
+		NULL, "last text line");
+	CHECK(CountOf(Text, "\n") == 3U, "one line per event");
+	free(Text);
+
+	Text = NULL;
+	Out = open_memstream(&Text, &Len);
+	CHECK(TraceWrite(SimTraceOut, Words, 1, Out, &Stats) == 0, "json");
+	fclose(Out);
+	CHECK(strncmp(Text, "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[",
+		39U) == 0, "json header");
+	CHECK(strstr(Text, "{\"name\":\"LoadImage\",\"cat\":\"plm\",\"ph\":\"i\","
+		"\"s\":\"g\",\"ts\":31.250,\"pid\":1,\"tid\":1,"
+		"\"args\":{\"seq\":1,\"arg0\":\"0x1C000000\"}}") != NULL,
+		"json event");
+	CHECK(strstr(Text, "\"ts\":93.750") != NULL, "json time stamps");
+	CHECK(CountOf(Text, "\"ph\":\"i\"") == 3U, "one json event per event");
+	CHECK(CountOf(Text, "}},") == 2U, "json events separated");
+	for (Idx = 0U; Text[Idx] != '\0'; ++Idx) {
+		if ((Text[Idx] == '{') || (Text[Idx] == '[')) {
+			++Depth;
+		} else if ((Text[Idx] == '}') || (Text[Idx] == ']')) {
+			CHECK(Depth > 0U, "json brackets balanced");
+			--Depth;
+		}
+	}
+	CHECK(Depth == 0U, "json brackets closed");
+	free(Text);
+}
+
+/*
+ * Prints of a boot: each one has a string argument from a buffer which is
+ * overwritten right after the call, as for image names.
+ */
+static void BootPrints(LineLog *Lines, u32 Count, int Deferred)
+{
+	char Name[24];
+	u32 Idx;
+
+	for (Idx = 0U; Idx < Count; ++Idx) {
+		SimTicks += 123457U;
+		snprintf(Name, sizeof(Name), "partition_%u", Idx);
+		if (Lines != NULL) {
+			Expect(Lines, "Loading %s at 0x%08x, %u bytes\n\r", Name,
+				0x1000000U * Idx, 4096U * Idx);
+		}
+		if (Deferred != 0) {
+			XPlmi_Printf(DEBUG_GENERAL,
+				"Loading %s at 0x%08x, %u bytes\n\r", Name,
+				0x1000000U * Idx, 4096U * Idx);
+		} else {
+			/* XPlmi_Printf without PLM_PRINT_DEFERRED */
+			XPlmi_PrintPlmTimeStamp();
+			xil_printf("Loading %s at 0x%08x, %u bytes\n\r", Name,
+				0x1000000U * Idx, 4096U * Idx);
+			SimUartLen += UartPendingLen;
+			UartPendingLen = 0U;
+		}
+		memset(Name, 'x', sizeof(Name) - 1U);
+		Name[sizeof(Name) - 1U] = '\0';
+	}
+}
+
+static void TestDeferredBoot(void)
+{
+	LineLog Lines;
+	char Expected[SIM_LOG_LEN];
+	u32 SyncBytes;
+	u32 MaxBytes;
+	u32 MaxFormats;
+	u32 Calls;
+	u32 Idx;
+
+	/* Prints formatted and sent at once, as before */
+	SimReset();
+	BootPrints(NULL, 16U, 0);
+	SyncBytes = SimUartLen;
+
+	SimReset();
+	Lines.Count = 0U;
+	BootPrints(&Lines, 16U, 1);
+	printf("16 boot prints: %u bytes formatted and %u sent at once, "
+		"%u.%03u ms of UART, deferred: %u formatted, %u sent\n",
+		SyncBytes, SyncBytes,
+		(SyncBytes * SIM_UART_NS_PER_BYTE) / 1000000U,
+		((SyncBytes * SIM_UART_NS_PER_BYTE) / 1000U) % 1000U,
+		SimOutbytes, SimUartLen);
+	CHECK(SimFormats == 0U, "no print formatted during boot");
+	CHECK(SimUartLen == 0U, "no byte sent during boot");
+
+	Calls = DrainIdle(&MaxBytes, &MaxFormats);
+	CHECK(MaxBytes <= XPLMI_PRINT_DRAIN_IDLE_BYTES,
+		"idle pass sends at most the idle budget");
+	CHECK(MaxFormats <= 2U, "idle pass formats at most one print");
+	CHECK(Calls >= (SyncBytes / XPLMI_PRINT_DRAIN_IDLE_BYTES),
+		"drain spread over idle passes");
+
+	Expected[0U] = '\0';
+	for (Idx = 0U; Idx < Lines.Count; ++Idx) {
+		strcat(Expected, Lines.Text[Idx]);
+	}
+	CHECK(strcmp(LogText(), Expected) == 0,
+		"log matches the prints with their call time stamps");
+	CHECK((SimUartLen == strlen(Expected)) &&
+		(memcmp(SimUart, Expected, SimUartLen) == 0),
+		"UART output matches the log");
+	CHECK(SimUartLen == SyncBytes, "same bytes as printing at once");
+	CHECK(SimUnmaskedWrites == 0U, "log written with interrupts masked");
+}
+
+static void TestDeferredFull(void)
+{
+	char Line[SIM_LINE_LEN];
+	u32 Idx;
+	u32 AtOnce = 0U;
+	u32 Missing = 0U;
+	u32 Before;
+
+	SimReset();
+	for (Idx = 0U; Idx < 200U; ++Idx) {
+		Before = SimFormats;
+		XPlmi_Printf(DEBUG_GENERAL, "print %u of %s\n\r", Idx,
+			"a queue that fills up");
+		if (SimFormats != Before) {
+			++AtOnce;
+		}
+	}
+	CHECK(AtOnce > 0U, "prints beyond the queue are formatted at once");
+	CHECK(AtOnce < 200U, "queue holds prints");
+	CHECK(XPlmi_DrainDeferredPrints(XPLMI_PRINT_DRAIN_ALL) == 0U,
+		"nothing pending after draining all");
+	for (Idx = 0U; Idx < 200U; ++Idx) {
+		snprintf(Line, sizeof(Line), "print %u of a queue that fills up\n\r",
+			Idx);
+		if (CountOf(LogText(), Line) != 1U) {
+			++Missing;
+		}
+	}
+	CHECK(Missing == 0U, "every print logged once");
+	CHECK(SimUartLen == strlen(LogText()), "every byte sent");
+}
+
+static void TestDeferredQueue(void)
+{
+	char Line[SIM_LINE_LEN];
+	u32 Slots = XPLMI_DEFER_PRINT_QUEUE_LEN;
+	u32 Idx;
+	u32 Before;
+	u32 Missing = 0U;
+
+	/*
+	 * Prints without time stamp and arguments take 4 slots, one with an
+	 * argument 5. The last slot before the oldest print must stay free,
+	 * so a queue filled with 4-slot prints takes one less than fits.
+	 */
+	SimReset();
+	for (Idx = 0U; Idx < SIM_QUEUE_PRINTS; ++Idx) {
+		snprintf(QueueFmt[Idx], sizeof(QueueFmt[Idx]), "queue <%u>\n\r",
+			Idx);
+	}
+	for (Idx = 0U; Idx < (XPLMI_DEFER_PRINT_QUEUE_LEN / 4U); ++Idx) {
+		XPlmi_Printf_WoTimeStamp(DEBUG_GENERAL, QueueFmt[Idx]);
+	}
+	CHECK(SimFormats == 1U, "last print of a full queue formatted at once");
+	CHECK(XPlmi_DrainDeferredPrints(XPLMI_PRINT_DRAIN_ALL) == 0U,
+		"drained");
+	while (Idx > 0U) {
+		--Idx;
+		snprintf(Line, sizeof(Line), "<%u>", Idx);
+		if (CountOf(LogText(), Line) != 1U) {
+			++Missing;
+		}
+	}
+	CHECK(Missing == 0U, "every print of the full queue logged once");
+
+	/* A 5-slot print and 4-slot prints up to the end of the queue */
+	SimReset();
+	XPlmi_Printf_WoTimeStamp(DEBUG_GENERAL, "first %u\n\r", 0U);
+	Slots -= 5U;
+	for (Idx = 0U; Slots > 4U; ++Idx) {
+		XPlmi_Printf_WoTimeStamp(DEBUG_GENERAL, QueueFmt[Idx]);
+		Slots -= 4U;
+	}
+	CHECK(SimFormats == 0U, "queue filled");
+	CHECK(DeferPrintHead == (XPLMI_DEFER_PRINT_QUEUE_LEN - Slots),
+		"records packed");
+	XPlmi_Printf_WoTimeStamp(DEBUG_GENERAL, QueueFmt[Idx]);
+	++Idx;
+	CHECK(SimFormats == 1U, "print beyond a full queue formatted at once");
+
+	/* Freeing the first print does not make room for a 5-slot print */
+	CHECK(XPlmi_FormatDeferredPrint() == (u8)TRUE, "first formatted");
+	Before = SimFormats;
+	XPlmi_Printf_WoTimeStamp(DEBUG_GENERAL, "last %u\n\r", 1U);
+	CHECK(SimFormats == (Before + 1U),
+		"print that would reach the oldest one formatted at once");
+
+	/* Short prints: one per idle pass, once the bytes so far are sent */
+	UartPendingLen = 0U;
+	Before = SimFormats;
+	CHECK(XPlmi_DrainDeferredPrints(XPLMI_PRINT_DRAIN_IDLE_BYTES) != 0U,
+		"prints pending");
+	CHECK(SimFormats == (Before + 1U), "one short print per idle pass");
+	CHECK(XPlmi_DrainDeferredPrints(XPLMI_PRINT_DRAIN_ALL) == 0U,
+		"drained");
+
+	CHECK(CountOf(LogText(), "first 0\n\r") == 1U, "first print");
+	CHECK(CountOf(LogText(), "last 1\n\r") == 1U, "last print");
+	while (Idx > 0U) {
+		--Idx;
+		snprintf(Line, sizeof(Line), "<%u>", Idx);
+		if (CountOf(LogText(), Line) != 1U) {
+			++Missing;
+		}
+	}
+	CHECK(Missing == 0U, "every print logged once");
+}
+
+static void TestDeferredArgs(void)
+{
+	char Long[100];
+	char Line[SIM_LINE_LEN];
+	u32 Before;
+
+	SimReset();
+	memset(Long, 'L', sizeof(Long) - 1U);
+	Long[sizeof(Long) - 1U] = '\0';
+
+	/* More arguments than stored are printed at once */
+	XPlmi_Printf(DEBUG_GENERAL, "%u %u %u %u %u %u %u %u %u\n\r",
+		1U, 2U, 3U, 4U, 5U, 6U, 7U, 8U, 9U);
+	CHECK(strstr(LogText(), "1 2 3 4 5 6 7 8 9\n\r") != NULL,
+		"nine arguments printed at once");
+
+	Before = SimFormats;
+	XPlmi_Printf_WoTimeStamp(DEBUG_GENERAL, "%u %u %u %u|%%|%c|%-4d|%s|%s\n\r",
+		1U, 2U, 3U, 4U, 'z', -7, "", "end");
+	XPlmi_Printf_WoTimeStamp(DEBUG_GENERAL, "[%s]\n\r", Long);
+	CHECK(SimFormats == Before, "prints queued");
+	CHECK(XPlmi_DrainDeferredPrints(XPLMI_PRINT_DRAIN_ALL) == 0U,
+		"drained");
+	CHECK(strstr(LogText(), "1 2 3 4|%|z|-7  ||end\n\r") != NULL,
+		"%%, %c, width and strings");
+	snprintf(Line, sizeof(Line), "[%.*s]\n\r",
+		(int)XPLMI_DEFER_PRINT_MAX_STR - 1, Long);
+	CHECK(strstr(LogText(), Line) != NULL, "long string cut");
+
+	/* Prints below the log level are not queued */
+	Before = DeferPrintHead;
+	XPlmi_Printf(DEBUG_DETAILED, "not printed %u\n\r", 1U);
+	CHECK(DeferPrintHead == Before, "print below the log level dropped");
+}
+
+static void TestDeferredIrq(void)
+{
+	char Line[SIM_LINE_LEN];
+	u32 Idx;
+	u32 Missing = 0U;
+	u32 MaxBytes;
+	u32 MaxFormats;
+
+	SimReset();
+	BootPrints(NULL, 30U, 1);
+	/* Interrupts that print arrive while the drain formats and sends */
+	SimIrqEvery = 37U;
+	(void)DrainIdle(&MaxBytes, &MaxFormats);
+	SimIrqEvery = 0U;
+	(void)XPlmi_DrainDeferredPrints(XPLMI_PRINT_DRAIN_ALL);
+
+	CHECK(SimIrqCount > 10U, "interrupts ran during the drain");
+	for (Idx = 0U; Idx < 30U; ++Idx) {
+		snprintf(Line, sizeof(Line), "Loading partition_%u at 0x%08x, "
+			"%u bytes\n\r", Idx, 0x1000000U * Idx, 4096U * Idx);
+		if (CountOf(LogText(), Line) != 1U) {
+			++Missing;
+		}
+	}
+	for (Idx = 1U; Idx <= SimIrqCount; ++Idx) {
+		snprintf(Line, sizeof(Line), "]irq %u\n\r", Idx);
+		if (CountOf(LogText(), Line) != 1U) {
+			++Missing;
+		}
+	}
+	CHECK(Missing == 0U, "every print logged once and intact");
+	CHECK(SimUartLen == strlen(LogText()), "every byte sent");
+	CHECK(SimUnmaskedWrites == 0U, "log written with interrupts masked");
+
+	/* Handlers that drain all while the task level formats */
+	SimReset();
+	BootPrints(NULL, 20U, 1);
+	SimIrqEvery = 37U;
+	SimIrqDrains = 1;
+	(void)DrainIdle(&MaxBytes, &MaxFormats);
+	SimIrqEvery = 0U;
+	(void)XPlmi_DrainDeferredPrints(XPLMI_PRINT_DRAIN_ALL);
+
+	CHECK(SimIrqBusy > 0U, "interrupts drained during formatting");
+	for (Idx = 0U; Idx < 20U; ++Idx) {
+		snprintf(Line, sizeof(Line), "Loading partition_%u at 0x%08x, "
+			"%u bytes\n\r", Idx, 0x1000000U * Idx, 4096U * Idx);
+		if (CountOf(LogText(), Line) != 1U) {
+			++Missing;
+		}
+	}
+	CHECK(Missing == 0U, "every print logged once with draining handlers");
+	CHECK(SimUartLen == strlen(LogText()), "every byte sent");
+}
+
+static void TestDeferredRetrieve(void)
+{
+	XPlmi_Cmd Cmd;
+	u32 Payload[4U] = { XPLMI_LOGGING_CMD_RETRIEVE_LOG_BUFFER_INFO };
+
+	SimReset();
+	XPlmi_Printf(DEBUG_GENERAL, "queued %u\n\r", 42U);
+	CHECK(DebugLog.LogBuffer.CurrentAddr == DebugLog.LogBuffer.StartAddr,
+		"print not logged yet");
+
+	/* Reading the log out formats the queue first, UART follows later */
+	memset(&Cmd, 0, sizeof(Cmd));
+	Cmd.Payload = Payload;
+	CHECK(XPlmi_EventLogging(&Cmd) == XST_SUCCESS, "log buffer info");
+	CHECK(strstr(LogText(), "queued 42\n\r") != NULL, "print formatted");
+	CHECK(Cmd.Response[3U] == strlen(LogText()), "log length returned");
+	CHECK(SimUartLen == 0U, "nothing sent by the command");
+	CHECK(XPlmi_DrainDeferredPrints(XPLMI_PRINT_DRAIN_ALL) == 0U,
+		"drained");
+	CHECK(SimUartLen == strlen(LogText()), "sent by the drain");
+}
+
+/************************** Main *********************************************/
+
+int main(void)
+{
+	TestTraceRoundTrip();
+	TestTraceWrap();
+	TestTraceGap();
+	TestTraceCorrupt();
+	TestTraceOutput();
+	TestDeferredBoot();
+	TestDeferredFull();
+	TestDeferredQueue();
+	TestDeferredArgs();
+	TestDeferredIrq();
+	TestDeferredRetrieve();
+
+	printf("%s (%u failures)\n", Failures ? "FAILED" : "PASSED", Failures);
+	return Failures ? 1 : 0;
+}
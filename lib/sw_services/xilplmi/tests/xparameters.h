@@ -0,0 +1,16 @@
+/******************************************************************************
+* Copyright (C) 2020 Xilinx, Inc.  All rights reserved.
+* SPDX-License-Identifier: MIT
+******************************************************************************/
+
+/* Hardware parameters used by the host tests: a PS UART for stdout */
+#ifndef XPARAMETERS_H
+#define XPARAMETERS_H
+
+#define STDOUT_BASEADDRESS	0xFF000000U
+#define XPAR_XUARTPSV_NUM_INSTANCES	0U
+
+#define XPAR_RAM_INSTR_CNTLR_0_S_AXI_BASEADDR	0xF0200000U
+#define XPAR_RAM_DATA_CNTLR_0_S_AXI_HIGHADDR	0xF023FFFFU
+
+#endif
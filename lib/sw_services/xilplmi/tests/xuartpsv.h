@@ -0,0 +1,14 @@
+/******************************************************************************
+* Copyright (C) 2020 Xilinx, Inc.  All rights reserved.
+* SPDX-License-Identifier: MIT
+******************************************************************************/
+
+/* PS UART of the host tests, provided by the model */
+#ifndef XUARTPSV_H
+#define XUARTPSV_H
+
+#include "xil_types.h"
+
+void XUartPsv_SendByte(UINTPTR BaseAddr, u8 Data);
+
+#endif
@@ -0,0 +1,332 @@
+/******************************************************************************
+* Copyright (C) 2020 Xilinx, Inc.  All rights reserved.
+* SPDX-License-Identifier: MIT
+******************************************************************************/
+
+/*****************************************************************************/
+/**
+*
+* @file xplmi_trace_decode.c
+*
+* Host decoder of the PLM trace log. It reads the trace buffer as retrieved
+* with the retrieve trace buffer command (sub command 6 of the event logging
+* command), a file of little endian words with the oldest data first, and
+* prints one line per trace event or, with -j, the events as Chrome trace
+* JSON which chrome://tracing and Perfetto load.
+*
+* The record layout is described in xplmi_event_logging.h. Decoding starts
+* at the first sync record carrying the version 2 format word, which skips
+* the part of the previous buffer pass still in front of it when the buffer
+* has wrapped. Time stamps are the tick deltas added to the absolute ticks
+* of the last sync record, converted with the tick frequency it carries.
+* Decoding stops at a record whose length does not fit or whose sequence
+* number does not follow the previous one, and resumes at the next sync
+* record after it, if any.
+*
+* Build and run on the host:
+*   cc -Wall -O2 -I../../../bsp/standalone/src/common \
+*      -I../../../bsp/standalone/src/arm/cortexa9 \
+*      xplmi_trace_decode.c -o xplmi_trace_decode
+*   ./xplmi_trace_decode [-j] trace.bin
+*
+******************************************************************************/
+
+/***************************** Include Files *********************************/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "xil_types.h"
+
+/************************** Constant Definitions *****************************/
+
+/* Record layout, as in xplmi_event_logging.h */
+#define TRACE_ID_MASK		0xFFFFU
+#define TRACE_LEN_SHIFT		16U
+#define TRACE_LEN_MASK		0xFFU
+#define TRACE_SEQ_SHIFT		24U
+#define TRACE_SEQ_MASK		0xFFU
+#define TRACE_HDR_LEN		2U
+#define TRACE_FORMAT		0x54524302U	/* "TRC", version 2 */
+#define TRACE_ID_SYNC		0x0U
+#define TRACE_SYNC_LEN		(TRACE_HDR_LEN + 4U)
+
+/**************************** Type Definitions *******************************/
+
+typedef struct {
+	u32 Id;
+	u32 Seq;
+	u64 Ticks;		/* Since PLM start */
+	u32 Freq;		/* Ticks per second */
+	u32 NumArgs;
+	const u32 *Args;
+} TraceEvent;
+
+typedef void (*TraceSink)(void *Ctx, const TraceEvent *Event);
+
+typedef struct {
+	u32 Events;		/* Trace events, without sync records */
+	u32 Syncs;		/* Sync records */
+	u32 Skipped;		/* Words not decoded */
+} TraceStats;
+
+typedef struct {
+	FILE *Out;
+	u32 Count;
+} TraceOut;
+
+/************************** Variable Definitions *****************************/
+
+/* Names of the trace event IDs of xplmi_event_logging.h */
+static const char *const TraceNames[] = {
+	"Sync",
+	"LoadImage",
+};
+
+/************************** Decoder ******************************************/
+
+static const char *TraceName(u32 Id, char *Buf, size_t Len)
+{
+	if (Id < (sizeof(TraceNames) / sizeof(TraceNames[0]))) {
+		return TraceNames[Id];
+	}
+	snprintf(Buf, Len, "Event 0x%X", (unsigned)Id);
+	return Buf;
+}
+
+static int TraceIsSync(const u32 *Buf, u32 Words, u32 Idx)
+{
+	u32 Hdr = Buf[Idx];
+
+	return ((Idx + TRACE_SYNC_LEN) <= Words) &&
+		((Hdr & TRACE_ID_MASK) == TRACE_ID_SYNC) &&
+		(((Hdr >> TRACE_LEN_SHIFT) & TRACE_LEN_MASK) == TRACE_SYNC_LEN) &&
+		(Buf[Idx + 2U] == TRACE_FORMAT);
+}
+
+/*
+ * Decodes Words words of trace buffer and calls Sink for every record,
+ * sync records included. Returns -1 if the buffer holds no sync record of
+ * the supported format, 0 otherwise.
+ */
+static int TraceDecode(const u32 *Buf, u32 Words, TraceSink Sink, void *Ctx,
+	TraceStats *Stats)
+{
+	TraceEvent Event;
+	u32 Idx = 0U;
+	u32 Hdr;
+	u32 Len;
+	u32 Seq;
+	u32 PrevSeq = 0U;
+	u64 Ticks = 0U;
+	u32 Freq = 0U;
+	int Synced = 0;
+	int Found = 0;
+
+	memset(Stats, 0, sizeof(*Stats));
+	while (Idx < Words) {
+		if (Synced == 0) {
+			/* Look for the next sync record */
+			if (TraceIsSync(Buf, Words, Idx) == 0) {
+				++Stats->Skipped;
+				++Idx;
+				continue;
+			}
+			Synced = 1;
+			Found = 1;
+		} else {
+			Hdr = Buf[Idx];
+			Len = (Hdr >> TRACE_LEN_SHIFT) & TRACE_LEN_MASK;
+			Seq = (Hdr >> TRACE_SEQ_SHIFT) & TRACE_SEQ_MASK;
+			if ((Len < TRACE_HDR_LEN) || ((Idx + Len) > Words) ||
+				(Seq != ((PrevSeq + 1U) & TRACE_SEQ_MASK))) {
+				Synced = 0;
+				continue;
+			}
+		}
+
+		Hdr = Buf[Idx];
+		Len = (Hdr >> TRACE_LEN_SHIFT) & TRACE_LEN_MASK;
+		PrevSeq = (Hdr >> TRACE_SEQ_SHIFT) & TRACE_SEQ_MASK;
+		Ticks += Buf[Idx + 1U];
+		Event.Id = Hdr & TRACE_ID_MASK;
+		if (Event.Id == TRACE_ID_SYNC) {
+			if (TraceIsSync(Buf, Words, Idx) == 0) {
+				/* Sync record of another format */
+				Synced = 0;
+				continue;
+			}
+			Ticks = ((u64)Buf[Idx + 4U] << 32U) | Buf[Idx + 3U];
+			Freq = Buf[Idx + 5U];
+			++Stats->Syncs;
+		} else {
+			++Stats->Events;
+		}
+		Event.Seq = PrevSeq;
+		Event.Ticks = Ticks;
+		Event.Freq = Freq;
+		Event.NumArgs = Len - TRACE_HDR_LEN;
+		Event.Args = &Buf[Idx + TRACE_HDR_LEN];
+		Sink(Ctx, &Event);
+		Idx += Len;
+	}
+
+	return (Found != 0) ? 0 : -1;
+}
+
+/* Time of the event in ns, 0 if the frequency is unknown */
+static u64 TraceNs(const TraceEvent *Event)
+{
+	if (Event->Freq == 0U) {
+		return 0U;
+	}
+	return ((Event->Ticks / Event->Freq) * 1000000000U) +
+		(((Event->Ticks % Event->Freq) * 1000000000U) / Event->Freq);
+}
+
+/************************** Output *******************************************/
+
+/* One line per event: [ms.ns] Name Seq Args */
+static void TraceSinkText(void *Ctx, const TraceEvent *Event)
+{
+	TraceOut *Out = (TraceOut *)Ctx;
+	char Name[32];
+	u64 Ns = TraceNs(Event);
+	u32 Idx;
+
+	if (Event->Id == TRACE_ID_SYNC) {
+		return;
+	}
+	fprintf(Out->Out, "[%llu.%06llu] %-12s seq %3u",
+		(unsigned long long)(Ns / 1000000U),
+		(unsigned long long)(Ns % 1000000U),
+		TraceName(Event->Id, Name, sizeof(Name)), (unsigned)Event->Seq);
+	for (Idx = 0U; Idx < Event->NumArgs; ++Idx) {
+		fprintf(Out->Out, " 0x%08X", (unsigned)Event->Args[Idx]);
+	}
+	fputc('\n', Out->Out);
+	++Out->Count;
+}
+
+/* Instant events of the Chrome trace event format, time stamps in us */
+static void TraceSinkJson(void *Ctx, const TraceEvent *Event)
+{
+	TraceOut *Out = (TraceOut *)Ctx;
+	char Name[32];
+	u64 Ns = TraceNs(Event);
+	u32 Idx;
+
+	if (Event->Id == TRACE_ID_SYNC) {
+		return;
+	}
+	fprintf(Out->Out, "%s\n{\"name\":\"%s\",\"cat\":\"plm\",\"ph\":\"i\","
+		"\"s\":\"g\",\"ts\":%llu.%03llu,\"pid\":1,\"tid\":1,"
+		"\"args\":{\"seq\":%u",
+		(Out->Count != 0U) ? "," : "",
+		TraceName(Event->Id, Name, sizeof(Name)),
+		(unsigned long long)(Ns / 1000U),
+		(unsigned long long)(Ns % 1000U), (unsigned)Event->Seq);
+	for (Idx = 0U; Idx < Event->NumArgs; ++Idx) {
+		fprintf(Out->Out, ",\"arg%u\":\"0x%08X\"", (unsigned)Idx,
+			(unsigned)Event->Args[Idx]);
+	}
+	fputs("}}", Out->Out);
+	++Out->Count;
+}
+
+/*
+ * Writes the decoded buffer to Out as text or as Chrome trace JSON.
+ * Returns -1 if the buffer holds no sync record of the supported format.
+ */
+static int TraceWrite(const u32 *Buf, u32 Words, int Json, FILE *Out,
+	TraceStats *Stats)
+{
+	TraceOut Ctx = { Out, 0U };
+	int Status;
+
+	if (Json != 0) {
+		fputs("{\"displayTimeUnit\":\"ms\",\"traceEvents\":[", Out);
+		Status = TraceDecode(Buf, Words, TraceSinkJson, &Ctx, Stats);
+		fputs("\n]}\n", Out);
+	} else {
+		Status = TraceDecode(Buf, Words, TraceSinkText, &Ctx, Stats);
+	}
+
+	return Status;
+}
+
+/************************** Main *********************************************/
+
+#ifndef XPLMI_TRACE_DECODE_NO_MAIN
+int main(int argc, char **argv)
+{
+	TraceStats Stats;
+	FILE *In;
+	u8 *Bytes = NULL;
+	u32 *Buf;
+	size_t Len = 0U;
+	size_t Cap = 0U;
+	size_t Got;
+	u32 Words;
+	u32 Idx;
+	int Json = 0;
+	int Arg = 1;
+	int Status;
+
+	if ((argc > Arg) && (strcmp(argv[Arg], "-j") == 0)) {
+		Json = 1;
+		++Arg;
+	}
+	if (argc != (Arg + 1)) {
+		fprintf(stderr, "usage: %s [-j] trace.bin\n", argv[0]);
+		return 2;
+	}
+	In = fopen(argv[Arg], "rb");
+	if (In == NULL) {
+		perror(argv[Arg]);
+		return 2;
+	}
+	do {
+		if (Len == Cap) {
+			Cap = (Cap != 0U) ? (Cap * 2U) : 4096U;
+			Bytes = realloc(Bytes, Cap);
+			if (Bytes == NULL) {
+				fclose(In);
+				return 2;
+			}
+		}
+		Got = fread(Bytes + Len, 1U, Cap - Len, In);
+		Len += Got;
+	} while (Got != 0U);
+	fclose(In);
+
+	/* The PLM stores little endian words */
+	Words = (u32)(Len / 4U);
+	Buf = malloc(((size_t)Words + 1U) * sizeof(u32));
+	if (Buf == NULL) {
+		free(Bytes);
+		return 2;
+	}
+	for (Idx = 0U; Idx < Words; ++Idx) {
+		Buf[Idx] = (u32)Bytes[Idx * 4U] |
+			((u32)Bytes[(Idx * 4U) + 1U] << 8U) |
+			((u32)Bytes[(Idx * 4U) + 2U] << 16U) |
+			((u32)Bytes[(Idx * 4U) + 3U] << 24U);
+	}
+
+	Status = TraceWrite(Buf, Words, Json, stdout, &Stats);
+	if (Status != 0) {
+		fprintf(stderr, "%s: no version 2 trace sync record found\n",
+			argv[Arg]);
+	} else {
+		fprintf(stderr, "%u events, %u sync records, %u words skipped\n",
+			(unsigned)Stats.Events, (unsigned)Stats.Syncs,
+			(unsigned)Stats.Skipped);
+	}
+	free(Buf);
+	free(Bytes);
+
+	return (Status != 0) ? 1 : 0;
+}
+#endif
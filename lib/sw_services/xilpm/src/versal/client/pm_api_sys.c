@@ -13,6 +13,7 @@
 #include "pm_api_sys.h"
 #include "pm_callbacks.h"
 #include "pm_client.h"
+#include <xil_cache.h>
 
 /* Payload Packets */
 #define PACK_PAYLOAD(Payload, Arg0, Arg1, Arg2, Arg3, Arg4, Arg5)	\
@@ -2070,3 +2071,252 @@ XStatus XPm_FeatureCheck(const u32 FeatureId, u32 *Version)
 done:
 	return Status;
 }
+
+/****************************************************************************/
+/**
+ * @brief  This function initializes a PM batch on top of a caller provided
+ *	   array of batch operations. The array is passed to the PMC by
+ *	   address, so it must be located in an OCM or DDR memory region
+ *	   requested by the calling subsystem, else the batch is rejected
+ *	   with XPM_ERR_BATCH_ADDR.
+ *
+ *	   The array is flushed and invalidated from the data cache around
+ *	   each submit, so it must start on an XPM_BATCH_OPS_ALIGN boundary
+ *	   and its size (MaxOps * sizeof(XPm_BatchOp)) must be a multiple of
+ *	   XPM_BATCH_OPS_ALIGN. Otherwise the invalidate could discard dirty
+ *	   data sharing a cache line with the array.
+ *
+ * @param  Batch	Pointer to the batch to initialize
+ * @param  Ops		Array of batch operations backing the batch
+ * @param  MaxOps	Number of entries in Ops
+ *
+ * @return XST_SUCCESS if successful else XST_INVALID_PARAM, also when Ops
+ * does not meet the alignment and size requirement
+ *
+ ****************************************************************************/
+XStatus XPm_BatchInit(XPm_Batch *const Batch, XPm_BatchOp *const Ops,
+		      const u32 MaxOps)
+{
+	XStatus Status = (s32)XST_INVALID_PARAM;
+
+	if ((NULL == Batch) || (NULL == Ops) || (0U == MaxOps)) {
+		XPm_Err("Invalid arguments to %s\r\n", __func__);
+		goto done;
+	}
+
+	if ((0U != ((UINTPTR)Ops % XPM_BATCH_OPS_ALIGN)) ||
+	    (0U != ((MaxOps * (u32)sizeof(XPm_BatchOp)) % XPM_BATCH_OPS_ALIGN))) {
+		XPm_Err("PM batch buffer must be %u byte aligned and sized\r\n",
+			XPM_BATCH_OPS_ALIGN);
+		goto done;
+	}
+
+	Batch->Ops = Ops;
+	Batch->MaxOps = (MaxOps > XPM_BATCH_MAX_OPS) ?
+			XPM_BATCH_MAX_OPS : MaxOps;
+	Batch->NumOps = 0U;
+	Status = XST_SUCCESS;
+
+done:
+	return Status;
+}
+
+/****************************************************************************/
+/**
+ * @brief  This function appends one operation to a PM batch. The arguments
+ *	   are in the same order as for the corresponding single PM API.
+ *
+ * @param  Batch	Pointer to the batch
+ * @param  ApiId	PM API ID of the operation
+ * @param  Arg0		First argument
+ * @param  Arg1		Second argument
+ * @param  Arg2		Third argument
+ * @param  Arg3		Fourth argument
+ *
+ * @return XST_SUCCESS if successful else XST_FAILURE if the batch is full
+ *
+ ****************************************************************************/
+XStatus XPm_BatchAdd(XPm_Batch *const Batch, const u32 ApiId, const u32 Arg0,
+		     const u32 Arg1, const u32 Arg2, const u32 Arg3)
+{
+	XStatus Status = (s32)XST_FAILURE;
+	XPm_BatchOp *Op;
+
+	if ((NULL == Batch) || (Batch->NumOps >= Batch->MaxOps)) {
+		XPm_Err("PM batch full in %s\r\n", __func__);
+		goto done;
+	}
+
+	Op = &Batch->Ops[Batch->NumOps];
+	Op->ApiId = ApiId;
+	Op->Args[0] = Arg0;
+	Op->Args[1] = Arg1;
+	Op->Args[2] = Arg2;
+	Op->Args[3] = Arg3;
+	Op->Status = (u32)XST_FAILURE;
+	Batch->NumOps++;
+	Status = XST_SUCCESS;
+
+done:
+	return Status;
+}
+
+/****************************************************************************/
+/**
+ * @brief  Append a request device operation to a PM batch
+ *
+ * @param  Batch		Pointer to the batch
+ * @param  DeviceId		Device which needs to be requested
+ * @param  Capabilities	Device Capabilities, can be combined
+ * @param  QoS			Quality of Service (0-100) required
+ * @param  Ack			Requested acknowledge type
+ *
+ * @return XST_SUCCESS if successful else XST_FAILURE
+ *
+ ****************************************************************************/
+XStatus XPm_BatchRequestNode(XPm_Batch *const Batch, const u32 DeviceId,
+			     const u32 Capabilities, const u32 QoS,
+			     const u32 Ack)
+{
+	return XPm_BatchAdd(Batch, PM_REQUEST_NODE, DeviceId, Capabilities,
+			    QoS, Ack);
+}
+
+/****************************************************************************/
+/**
+ * @brief  Append a release device operation to a PM batch
+ *
+ * @param  Batch		Pointer to the batch
+ * @param  DeviceId		Device which needs to be released
+ *
+ * @return XST_SUCCESS if successful else XST_FAILURE
+ *
+ ****************************************************************************/
+XStatus XPm_BatchReleaseNode(XPm_Batch *const Batch, const u32 DeviceId)
+{
+	return XPm_BatchAdd(Batch, PM_RELEASE_NODE, DeviceId, 0U, 0U, 0U);
+}
+
+/****************************************************************************/
+/**
+ * @brief  Append a set requirement operation to a PM batch
+ *
+ * @param  Batch		Pointer to the batch
+ * @param  DeviceId		Device whose requirement needs to be set
+ * @param  Capabilities	Device Capabilities, can be combined
+ * @param  QoS			Quality of Service (0-100) required
+ * @param  Ack			Requested acknowledge type
+ *
+ * @return XST_SUCCESS if successful else XST_FAILURE
+ *
+ ****************************************************************************/
+XStatus XPm_BatchSetRequirement(XPm_Batch *const Batch, const u32 DeviceId,
+				const u32 Capabilities, const u32 QoS,
+				const u32 Ack)
+{
+	return XPm_BatchAdd(Batch, PM_SET_REQUIREMENT, DeviceId, Capabilities,
+			    QoS, Ack);
+}
+
+/****************************************************************************/
+/**
+ * @brief  Append a reset assert operation to a PM batch
+ *
+ * @param  Batch		Pointer to the batch
+ * @param  ResetId		Reset ID
+ * @param  Action		Reset action to be taken
+ *
+ * @return XST_SUCCESS if successful else XST_FAILURE
+ *
+ ****************************************************************************/
+XStatus XPm_BatchResetAssert(XPm_Batch *const Batch, const u32 ResetId,
+			     const u32 Action)
+{
+	return XPm_BatchAdd(Batch, PM_RESET_ASSERT, ResetId, Action, 0U, 0U);
+}
+
+/****************************************************************************/
+/**
+ * @brief  Append a clock enable or disable operation to a PM batch
+ *
+ * @param  Batch		Pointer to the batch
+ * @param  ClockId		Clock node ID
+ * @param  Enable		1 to enable the clock, 0 to disable it
+ *
+ * @return XST_SUCCESS if successful else XST_FAILURE
+ *
+ ****************************************************************************/
+XStatus XPm_BatchClockSetState(XPm_Batch *const Batch, const u32 ClockId,
+			       const u32 Enable)
+{
+	u32 ApiId = (0U != Enable) ? PM_CLOCK_ENABLE : PM_CLOCK_DISABLE;
+
+	return XPm_BatchAdd(Batch, ApiId, ClockId, 0U, 0U, 0U);
+}
+
+/****************************************************************************/
+/**
+ * @brief  This function sends all operations of a PM batch to the PMC with a
+ *	   single IPI request. The operations are executed in order and the
+ *	   status of each one is available in Batch->Ops[i].Status on return.
+ *	   The batch is emptied on return so that it can be reused.
+ *	   Batch->Ops must meet the XPM_BATCH_OPS_ALIGN alignment and size
+ *	   requirement checked by XPm_BatchInit; the cache maintenance covers
+ *	   whole cache lines of the array.
+ *
+ * @param  Batch		Pointer to the batch
+ * @param  Flags		XPM_BATCH_FLAG_STOP_ON_ERR to skip remaining
+ *				operations after the first failure
+ * @param  NumFailed		Number of failed operations (optional)
+ *
+ * @return XST_SUCCESS if all operations succeeded, else the status of the
+ * first failed operation, XST_INVALID_PARAM for a misaligned batch buffer
+ * or an error code
+ *
+ ****************************************************************************/
+XStatus XPm_BatchSubmit(XPm_Batch *const Batch, const u32 Flags,
+			u32 *const NumFailed)
+{
+	XStatus Status = (s32)XST_FAILURE;
+	u32 Payload[PAYLOAD_ARG_CNT];
+	u64 Address;
+	u32 Size;
+
+	if ((NULL == Batch) || (0U == Batch->NumOps)) {
+		XPm_Err("Empty PM batch passed to %s\r\n", __func__);
+		goto done;
+	}
+
+	if ((0U != ((UINTPTR)Batch->Ops % XPM_BATCH_OPS_ALIGN)) ||
+	    (Batch->NumOps > Batch->MaxOps)) {
+		XPm_Err("Invalid PM batch buffer passed to %s\r\n", __func__);
+		Status = (s32)XST_INVALID_PARAM;
+		goto done;
+	}
+
+	Address = (u64)(UINTPTR)Batch->Ops;
+	/* Whole cache lines, within the aligned and sized Ops buffer */
+	Size = Batch->NumOps * (u32)sizeof(XPm_BatchOp);
+	Size = (Size + XPM_BATCH_OPS_ALIGN - 1U) & ~(XPM_BATCH_OPS_ALIGN - 1U);
+
+	/* PMC reads the operations from memory and writes back the status */
+	Xil_DCacheFlushRange((UINTPTR)Batch->Ops, Size);
+
+	PACK_PAYLOAD4(Payload, PM_BATCH_CMD, (u32)Address,
+		      (u32)(Address >> 32U), Batch->NumOps, Flags);
+
+	/* Send request to the target module */
+	Status = XPm_IpiSend(PrimaryProc, Payload);
+	if (XST_SUCCESS != Status) {
+		goto done;
+	}
+
+	/* Return result from IPI return buffer */
+	Status = Xpm_IpiReadBuff32(PrimaryProc, NULL, NumFailed, NULL);
+
+	Xil_DCacheInvalidateRange((UINTPTR)Batch->Ops, Size);
+	Batch->NumOps = 0U;
+
+done:
+	return Status;
+}
@@ -85,6 +85,16 @@ typedef struct XPm_Ntfier {
 	struct XPm_Ntfier* next;
 } XPm_Notifier;
 
+/**
+ * XPm_Batch - PM batch built by the client and sent with XPm_BatchSubmit
+ */
+typedef struct XPm_BatchCtx {
+	XPm_BatchOp *Ops;	/**< Operations, located in PMC visible memory,
+				     XPM_BATCH_OPS_ALIGN aligned */
+	u32 MaxOps;		/**< Number of entries in Ops */
+	u32 NumOps;		/**< Number of queued operations */
+} XPm_Batch;
+
 /* Global data declarations */
 extern struct pm_init_suspend pm_susp;
 extern struct pm_acknowledge pm_ack;
@@ -158,6 +168,23 @@ int XPm_ClockGetRate(const u32 ClockId, u32 *const Rate);
 int XPm_MmioWrite(const u32 Address, const u32 Mask, const u32 Value);
 int XPm_MmioRead(const u32 Address, u32 *const Value);
 XStatus XPm_FeatureCheck(const u32 FeatureId, u32 *Version);
+XStatus XPm_BatchInit(XPm_Batch *const Batch, XPm_BatchOp *const Ops,
+		      const u32 MaxOps);
+XStatus XPm_BatchAdd(XPm_Batch *const Batch, const u32 ApiId, const u32 Arg0,
+		     const u32 Arg1, const u32 Arg2, const u32 Arg3);
+XStatus XPm_BatchRequestNode(XPm_Batch *const Batch, const u32 DeviceId,
+			     const u32 Capabilities, const u32 QoS,
+			     const u32 Ack);
+XStatus XPm_BatchReleaseNode(XPm_Batch *const Batch, const u32 DeviceId);
+XStatus XPm_BatchSetRequirement(XPm_Batch *const Batch, const u32 DeviceId,
+				const u32 Capabilities, const u32 QoS,
+				const u32 Ack);
+XStatus XPm_BatchResetAssert(XPm_Batch *const Batch, const u32 ResetId,
+			     const u32 Action);
+XStatus XPm_BatchClockSetState(XPm_Batch *const Batch, const u32 ClockId,
+			       const u32 Enable);
+XStatus XPm_BatchSubmit(XPm_Batch *const Batch, const u32 Flags,
+			u32 *const NumFailed);
 
 #ifdef __cplusplus
 }
@@ -393,6 +393,29 @@ enum XPmNotifyEvent {
 #define XPM_PROBE_COUNTER_TYPE_SRC		(5U)
 #define XPM_PROBE_COUNTER_TYPE_VAL		(6U)
 
+/* PM batch command */
+#define XPM_BATCH_MAX_OPS		(64U)
+#define XPM_BATCH_OP_ARGS		(4U)
+#define XPM_BATCH_OP_WORDS		(6U)
+#define XPM_BATCH_FLAG_STOP_ON_ERR	(0x1U)
+/*
+ * Alignment of the client batch buffer. The client flushes and invalidates
+ * the buffer around the request, so it must not share a cache line with any
+ * other data. 64 bytes covers the A72 and R5 data cache lines.
+ */
+#define XPM_BATCH_OPS_ALIGN		(64U)
+
+/**
+ * XPm_BatchOp - One operation of a PM batch command, as laid out in the
+ * shared memory buffer. ApiId and Args are written by the client, Status is
+ * written back by the server once the operation has been executed.
+ */
+typedef struct {
+	u32 ApiId;			/**< PM API ID of the operation */
+	u32 Args[XPM_BATCH_OP_ARGS];	/**< Arguments in IPI payload order */
+	u32 Status;			/**< Status of the operation */
+} XPm_BatchOp;
+
 /* PM API versions */
 #define XST_API_BASE_VERSION		(1U)
 
@@ -477,9 +500,10 @@ enum XPmNotifyEvent {
 #define PM_FEATURE_CHECK		63U
 #define PM_ISO_CONTROL			64U
 #define PM_ACTIVATE_SUBSYSTEM		65U
+#define PM_BATCH_CMD			66U
 
 #define PM_API_MIN      PM_GET_API_VERSION
-#define PM_API_MAX      PM_ACTIVATE_SUBSYSTEM
+#define PM_API_MAX      PM_BATCH_CMD
 
 #ifdef __cplusplus
 }
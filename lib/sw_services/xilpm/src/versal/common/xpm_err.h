@@ -135,6 +135,13 @@ extern "C" {
 /************************** (2100L) - (2109L) ****************************/
 #define XPM_INVALID_ISO_IDX                      (2100L) /* Invalid Isolation index passed */
 
+/************************** BATCH COMMAND ERRORS *************************/
+/************************** (2110L) - (2119L) ****************************/
+#define XPM_ERR_BATCH_OP                         (2110L) /* Operation not allowed in a batch */
+#define XPM_ERR_BATCH_SIZE                       (2111L) /* Invalid number of batch operations */
+#define XPM_ERR_BATCH_NOT_EXEC                   (2112L) /* Operation skipped after earlier failure */
+#define XPM_ERR_BATCH_ADDR                       (2113L) /* Batch buffer not owned by the requester */
+
 /************************** Variable Definitions *****************************/
 
 #ifdef __cplusplus
@@ -39,6 +39,10 @@
 #include "xpm_debug.h"
 #include "xpm_device.h"
 
+/* PMC address range, covers PPU RAM, PMC RAM and the PLM data */
+#define XPM_BATCH_PMC_ADDR_START	(0xF0000000U)
+#define XPM_BATCH_PMC_ADDR_END		(0xF8000000U)
+
 #define XPm_RegisterWakeUpHandler(GicId, SrcId, NodeId)	\
 	XPlmi_GicRegisterHandler(((GicId) << (8U)) | ((SrcId) << (16U)), \
 		XPm_DispatchWakeHandler, (void *)(NodeId))
@@ -169,6 +173,230 @@ done:
 	return Status;
 }
 
+/****************************************************************************/
+/**
+ * @brief  This function checks whether a PM API may be part of a batch
+ *	   command. Only operations which do not return data and do not
+ *	   suspend the caller are allowed.
+ *
+ * @param  ApiId	PM API ID of the batch operation
+ *
+ * @return XST_SUCCESS if the operation is allowed else XPM_ERR_BATCH_OP
+ *
+ * @note   None
+ *
+ ****************************************************************************/
+static XStatus XPm_BatchCheckOp(const u32 ApiId)
+{
+	XStatus Status = XPM_ERR_BATCH_OP;
+
+	switch (ApiId) {
+	case PM_REQUEST_NODE:
+	case PM_RELEASE_NODE:
+	case PM_SET_REQUIREMENT:
+	case PM_RESET_ASSERT:
+	case PM_CLOCK_ENABLE:
+	case PM_CLOCK_DISABLE:
+	case PM_CLOCK_SETDIVIDER:
+	case PM_CLOCK_SETPARENT:
+	case PM_PINCTRL_REQUEST:
+	case PM_PINCTRL_RELEASE:
+	case PM_PINCTRL_SET_FUNCTION:
+	case PM_PINCTRL_CONFIG_PARAM_SET:
+		Status = XST_SUCCESS;
+		break;
+	default:
+		Status = XPM_ERR_BATCH_OP;
+		break;
+	}
+
+	return Status;
+}
+
+/****************************************************************************/
+/**
+ * @brief  This function executes one operation of a batch command on behalf
+ *	   of an already resolved subsystem.
+ *
+ * @param  SubsystemId	Subsystem ID of the requester
+ * @param  IpiMask	IPI mask of the requester
+ * @param  ApiId	PM API ID of the operation
+ * @param  Args		Operation arguments in IPI payload order
+ *
+ * @return XST_SUCCESS if successful else XST_FAILURE or an error code
+ * or a reason code
+ *
+ * @note   None
+ *
+ ****************************************************************************/
+static XStatus XPm_BatchExecOp(const u32 SubsystemId, const u32 IpiMask,
+			       const u32 ApiId, const u32 *Args)
+{
+	XStatus Status = XST_FAILURE;
+
+	switch (ApiId) {
+	case PM_REQUEST_NODE:
+		Status = XPm_RequestDevice(SubsystemId, Args[0], Args[1],
+					   Args[2], Args[3]);
+		break;
+	case PM_RELEASE_NODE:
+		Status = XPm_ReleaseDevice(SubsystemId, Args[0]);
+		break;
+	case PM_SET_REQUIREMENT:
+		Status = XPm_SetRequirement(SubsystemId, Args[0], Args[1],
+					    Args[2], Args[3]);
+		break;
+	case PM_RESET_ASSERT:
+		Status = XPm_SetResetState(SubsystemId, IpiMask, Args[0],
+					   Args[1]);
+		break;
+	case PM_CLOCK_ENABLE:
+		Status = XPm_SetClockState(SubsystemId, Args[0], 1);
+		break;
+	case PM_CLOCK_DISABLE:
+		Status = XPm_SetClockState(SubsystemId, Args[0], 0);
+		break;
+	case PM_CLOCK_SETDIVIDER:
+		Status = XPm_SetClockDivider(SubsystemId, Args[0], Args[1]);
+		break;
+	case PM_CLOCK_SETPARENT:
+		Status = XPm_SetClockParent(SubsystemId, Args[0], Args[1]);
+		break;
+	case PM_PINCTRL_REQUEST:
+		Status = XPm_PinCtrlRequest(SubsystemId, Args[0]);
+		break;
+	case PM_PINCTRL_RELEASE:
+		Status = XPm_PinCtrlRelease(SubsystemId, Args[0]);
+		break;
+	case PM_PINCTRL_SET_FUNCTION:
+		Status = XPm_SetPinFunction(SubsystemId, Args[0], Args[1]);
+		break;
+	case PM_PINCTRL_CONFIG_PARAM_SET:
+		Status = XPm_SetPinParameter(SubsystemId, Args[0], Args[1],
+					     Args[2]);
+		break;
+	default:
+		Status = XPM_ERR_BATCH_OP;
+		break;
+	}
+
+	return Status;
+}
+
+/****************************************************************************/
+/**
+ * @brief  This function executes a vector of PM operations placed by the
+ *	   requester in a shared memory buffer. The requesting subsystem is
+ *	   resolved once for the whole batch, every operation is validated
+ *	   before any of them is executed and the operations are then run in
+ *	   order. The status of each operation is written back to its entry.
+ *
+ * @param  SubsystemId	Subsystem ID of the requester
+ * @param  IpiMask	IPI mask of the requester
+ * @param  AddrLow	Lower 32 bits of the batch buffer address
+ * @param  AddrHigh	Upper 32 bits of the batch buffer address
+ * @param  NumOps	Number of XPm_BatchOp entries in the buffer
+ * @param  Flags	XPM_BATCH_FLAG_STOP_ON_ERR to skip the remaining
+ *			operations after the first failure
+ * @param  Response	Number of executed and failed operations
+ *
+ * @return XST_SUCCESS if all operations succeeded, otherwise the status of
+ * the first failed operation
+ *
+ * @note   Each entry is XPM_BATCH_OP_WORDS words long. The buffer must be
+ *	   flushed by the requester before the command is issued. The whole
+ *	   buffer must lie inside one OCM or DDR memory region requested by
+ *	   the requesting subsystem, otherwise it is not accessed at all.
+ *
+ ****************************************************************************/
+static XStatus XPm_ProcessBatch(const u32 SubsystemId, const u32 IpiMask,
+				const u32 AddrLow, const u32 AddrHigh,
+				const u32 NumOps, const u32 Flags,
+				u32 *const Response)
+{
+	XStatus Status = XST_FAILURE;
+	XStatus OpStatus;
+	u64 BatchAddr = ((u64)AddrHigh << 32U) | (u64)AddrLow;
+	u64 BatchSize;
+	u64 OpAddr;
+	u32 Args[XPM_BATCH_OP_ARGS];
+	u32 ApiId;
+	u32 NumDone = 0U;
+	u32 NumFailed = 0U;
+	u32 i, j;
+
+	if ((0U == NumOps) || (NumOps > XPM_BATCH_MAX_OPS)) {
+		Status = XPM_ERR_BATCH_SIZE;
+		goto done;
+	}
+
+	/*
+	 * The buffer is read and written with PLM privileges, so it must not
+	 * wrap, must stay clear of the PMC address range and must belong to
+	 * the requesting subsystem.
+	 */
+	BatchSize = (u64)NumOps * XPM_BATCH_OP_WORDS * 4U;
+	if (((BatchAddr + BatchSize) < BatchAddr) ||
+	    (((BatchAddr + BatchSize) > (u64)XPM_BATCH_PMC_ADDR_START) &&
+	     (BatchAddr < (u64)XPM_BATCH_PMC_ADDR_END))) {
+		Status = XPM_ERR_BATCH_ADDR;
+		goto done;
+	}
+	if (XST_SUCCESS != XPmDevice_CheckMemRegnAccess(SubsystemId, BatchAddr,
+							BatchSize)) {
+		PmErr("Batch buffer 0x%x_%08x not owned by subsystem 0x%x\r\n",
+		      AddrHigh, AddrLow, SubsystemId);
+		Status = XPM_ERR_BATCH_ADDR;
+		goto done;
+	}
+
+	/* Reject the whole batch if any of the operations is not allowed */
+	for (i = 0U; i < NumOps; i++) {
+		OpAddr = BatchAddr + ((u64)i * XPM_BATCH_OP_WORDS * 4U);
+		ApiId = XPm_In64(OpAddr) & 0xFFU;
+		Status = XPm_BatchCheckOp(ApiId);
+		if (XST_SUCCESS != Status) {
+			PmErr("Batch op %d: API 0x%x not allowed\r\n", i, ApiId);
+			goto done;
+		}
+	}
+
+	Status = XST_SUCCESS;
+	for (i = 0U; i < NumOps; i++) {
+		OpAddr = BatchAddr + ((u64)i * XPM_BATCH_OP_WORDS * 4U);
+		if ((0U != NumFailed) &&
+		    (0U != (Flags & XPM_BATCH_FLAG_STOP_ON_ERR))) {
+			XPm_Out64(OpAddr + ((u64)(XPM_BATCH_OP_WORDS - 1U) * 4U),
+				    (u32)XPM_ERR_BATCH_NOT_EXEC);
+			continue;
+		}
+
+		ApiId = XPm_In64(OpAddr) & 0xFFU;
+		for (j = 0U; j < XPM_BATCH_OP_ARGS; j++) {
+			Args[j] = XPm_In64(OpAddr + ((u64)(j + 1U) * 4U));
+		}
+
+		OpStatus = XPm_BatchExecOp(SubsystemId, IpiMask, ApiId, Args);
+		XPm_Out64(OpAddr + ((u64)(XPM_BATCH_OP_WORDS - 1U) * 4U),
+			    (u32)OpStatus);
+		NumDone++;
+		if (XST_SUCCESS != OpStatus) {
+			PmErr("Batch op %d: error 0x%x for API 0x%x\r\n", i,
+			      OpStatus, ApiId);
+			if (0U == NumFailed) {
+				Status = OpStatus;
+			}
+			NumFailed++;
+		}
+	}
+
+	Response[0] = NumDone;
+	Response[1] = NumFailed;
+
+done:
+	return Status;
+}
+
 static int XPm_ProcessCmd(XPlmi_Cmd * Cmd)
 {
 	u32 ApiResponse[XPLMI_CMD_RESP_SIZE-1] = {0};
@@ -397,6 +625,11 @@ static int XPm_ProcessCmd(XPlmi_Cmd * Cmd)
 		Status = XPm_ActivateSubsystem(SubsystemId, Cmd->IpiMask,
 					       Pload[0]);
 		break;
+	case PM_BATCH_CMD:
+		Status = XPm_ProcessBatch(SubsystemId, Cmd->IpiMask, Pload[0],
+					  Pload[1], Pload[2], Pload[3],
+					  ApiResponse);
+		break;
 	default:
 		PmErr("CMD: INVALID PARAM\r\n");
 		Status = XST_INVALID_PARAM;
@@ -4199,6 +4432,7 @@ int XPm_FeatureCheck(const u32 ApiId, u32 *const Version)
 	case PM_SET_CURRENT_SUBSYSTEM:
 	case PM_INIT_NODE:
 	case PM_FEATURE_CHECK:
+	case PM_BATCH_CMD:
 		*Version = XST_API_BASE_VERSION;
 		Status = XST_SUCCESS;
 		break;
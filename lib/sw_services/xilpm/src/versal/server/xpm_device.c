@@ -2071,6 +2071,72 @@ done:
 	return Status;
 }
 
+/****************************************************************************/
+/**
+ * @brief  Check that an address range lies entirely inside one OCM or DDR
+ *	   memory region which is requested by the given subsystem.
+ *
+ * @param  SubsystemId	Subsystem ID
+ * @param  Address	Start address of the range
+ * @param  Size		Size of the range in bytes
+ *
+ * @return XST_SUCCESS if the range is owned by the subsystem
+ *         XPM_PM_NO_ACCESS otherwise
+ *
+ * @note   The range must be fully covered by a single memory region, ranges
+ *	   spanning two adjacent regions are rejected.
+ *
+ ****************************************************************************/
+XStatus XPmDevice_CheckMemRegnAccess(const u32 SubsystemId, const u64 Address,
+				     const u64 Size)
+{
+	XStatus Status = XPM_PM_NO_ACCESS;
+	const XPm_MemDevice *MemDevice;
+	XPm_Device **MemRegDevices;
+	u32 NumMemRegDevices;
+	u64 End = Address + Size;
+	u32 i, j;
+
+	if ((0U == Size) || (End < Address)) {
+		goto done;
+	}
+
+	for (i = 0U; i < 2U; i++) {
+		if (0U == i) {
+			MemRegDevices = PmOcmMemRegnDevices;
+			NumMemRegDevices = PmNumOcmMemRegnDevices;
+		} else {
+			MemRegDevices = PmDdrMemRegnDevices;
+			NumMemRegDevices = PmNumDdrMemRegnDevices;
+		}
+
+		for (j = 0U; j < (u32)MEM_REGN_DEV_NODE_MAX; j++) {
+			if (0U == NumMemRegDevices) {
+				break;
+			}
+			if (NULL == MemRegDevices[j]) {
+				continue;
+			}
+			NumMemRegDevices--;
+
+			MemDevice = (XPm_MemDevice *)MemRegDevices[j];
+			if ((Address < (u64)MemDevice->StartAddress) ||
+			    (End > (u64)MemDevice->EndAddress)) {
+				continue;
+			}
+
+			if (XST_SUCCESS == XPmDevice_IsRequested(
+					MemDevice->Device.Node.Id, SubsystemId)) {
+				Status = XST_SUCCESS;
+				goto done;
+			}
+		}
+	}
+
+done:
+	return Status;
+}
+
 int XPmDevice_GetWakeupLatency(const u32 DeviceId, u32 *Latency)
 {
 	int Status = XST_SUCCESS;
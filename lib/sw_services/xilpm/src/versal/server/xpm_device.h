@@ -171,6 +171,8 @@ XStatus XPmDevice_BringUp(XPm_Device *Device);
 u32 XPmDevice_GetUsageStatus(XPm_Subsystem *Subsystem, XPm_Device *Device);
 int XPmDevice_IsClockActive(XPm_Device *Device);
 int XPmDevice_IsRequested(const u32 DeviceId, const u32 SubsystemId);
+XStatus XPmDevice_CheckMemRegnAccess(const u32 SubsystemId, const u64 Address,
+				     const u64 Size);
 int XPmDevice_GetWakeupLatency(const u32 DeviceId, u32 *Latency);
 XStatus XPm_SetSysmonNode(u32 Id, u32 BaseAddress);
 u32 XPm_GetSysmonByIndex(const u32 SysmonIndex);
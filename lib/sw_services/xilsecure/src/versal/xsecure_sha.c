@@ -133,6 +133,7 @@ int XSecure_Sha3Initialize(XSecure_Sha3 *InstancePtr, XPmcDma* DmaPtr)
 	InstancePtr->Sha3Len = 0U;
 	InstancePtr->DmaPtr = DmaPtr;
 	InstancePtr->IsLastUpdate = FALSE;
+	InstancePtr->IsNonBlkPending = FALSE;
 
 	Status = XSecure_SssInitialize(&(InstancePtr->SssInstance));
 	if (Status != XST_SUCCESS) {
@@ -290,6 +291,11 @@ int XSecure_Sha3Update(XSecure_Sha3 *InstancePtr, const UINTPTR InDataAddr,
 		goto END;
 	}
 
+	if (InstancePtr->IsNonBlkPending == TRUE) {
+		Status = (int)XSECURE_SHA3_STATE_MISMATCH_ERROR;
+		goto END;
+	}
+
 	if (InstancePtr->Sha3State != XSECURE_SHA3_ENGINE_STARTED) {
 		Status = (int)XSECURE_SHA3_STATE_MISMATCH_ERROR;
 		goto END_RST;
@@ -331,6 +337,129 @@ END:
 	return Status;
 }
 
+/*****************************************************************************/
+/**
+ * @brief	This function starts the DMA transfer of the input data to the
+ *		SHA3 engine and returns without waiting for it to complete, so
+ *		that the caller can use the other PMC DMA meanwhile. Bytes beyond
+ *		the last complete SHA3 block are kept as partial data for
+ *		XSecure_Sha3Finish. XSecure_Sha3WaitForUpdate must be called
+ *		before the instance is used again.
+ *
+ * @param	InstancePtr	- Pointer to the XSecure_Sha3 instance
+ * @param	InDataAddr	- Word aligned starting address of the data which
+ *				  has to be updated to SHA engine
+ * @param	Size		- Size of the input data in bytes
+ *
+ * @return	- XST_SUCCESS - If the transfer is started
+ *		- XSECURE_SHA3_INVALID_PARAM - On invalid parameter
+ *		- XSECURE_SHA3_STATE_MISMATCH_ERROR - If the engine is not started,
+ *		  a transfer is in progress or partial data is pending
+ * 		- XST_FAILURE - If there is a failure in SSS configuration
+ *
+ * @note	This is meant for the first update after XSecure_Sha3Start, when
+ *		no partial data is pending.
+ *
+ ******************************************************************************/
+int XSecure_Sha3UpdateNonBlk(XSecure_Sha3 *InstancePtr,
+		const UINTPTR InDataAddr, const u32 Size)
+{
+	int Status = XST_FAILURE;
+	u32 DmableDataLen;
+	u32 RemainingDataLen;
+
+	/* Validate the input arguments */
+	if ((InstancePtr == NULL) ||
+		((InDataAddr & XPMCDMA_ADDR_LSB_MASK) != 0U) ||
+		(Size > XSECURE_PMC_DMA_MAX_TRANSFER)) {
+		Status = (int)XSECURE_SHA3_INVALID_PARAM;
+		goto END;
+	}
+
+	if ((InstancePtr->Sha3State != XSECURE_SHA3_ENGINE_STARTED) ||
+		(InstancePtr->IsNonBlkPending == TRUE) ||
+		(InstancePtr->IsLastUpdate == TRUE) ||
+		(InstancePtr->PartialLen != 0U)) {
+		Status = (int)XSECURE_SHA3_STATE_MISMATCH_ERROR;
+		goto END;
+	}
+
+	InstancePtr->Sha3Len += Size;
+	RemainingDataLen = Size % XSECURE_SHA3_BLOCK_LEN;
+	DmableDataLen = Size - RemainingDataLen;
+
+	/* The tail is padded and sent by XSecure_Sha3Finish */
+	if (RemainingDataLen > 0U) {
+		XSecure_MemCpy((void *)InstancePtr->PartialData,
+			(const void *)(InDataAddr + DmableDataLen),
+			RemainingDataLen);
+	}
+	InstancePtr->PartialLen = RemainingDataLen;
+
+	if (DmableDataLen == 0U) {
+		Status = XST_SUCCESS;
+		goto END;
+	}
+
+	Status = XSecure_SssSha(&(InstancePtr->SssInstance),
+				InstancePtr->DmaPtr->Config.DeviceId);
+	if (Status != XST_SUCCESS) {
+		goto END;
+	}
+	XPmcDma_Transfer(InstancePtr->DmaPtr, XPMCDMA_SRC_CHANNEL,
+		InDataAddr, DmableDataLen / XSECURE_WORD_SIZE, FALSE);
+	InstancePtr->IsNonBlkPending = TRUE;
+
+END:
+	return Status;
+}
+
+/*****************************************************************************/
+/**
+ * @brief	This function waits for the transfer started by
+ *		XSecure_Sha3UpdateNonBlk to complete
+ *
+ * @param	InstancePtr	- Pointer to the XSecure_Sha3 instance
+ *
+ * @return	- XST_SUCCESS - If the transfer completed or none was started
+ *		- XSECURE_SHA3_INVALID_PARAM - On invalid parameter
+ * 		- XST_FAILURE - If a timeout has occurred
+ *
+ ******************************************************************************/
+int XSecure_Sha3WaitForUpdate(XSecure_Sha3 *InstancePtr)
+{
+	int Status = XST_FAILURE;
+
+	/* Validate the input arguments */
+	if (InstancePtr == NULL) {
+		Status = (int)XSECURE_SHA3_INVALID_PARAM;
+		goto END;
+	}
+
+	if (InstancePtr->IsNonBlkPending != TRUE) {
+		Status = XST_SUCCESS;
+		goto END;
+	}
+	InstancePtr->IsNonBlkPending = FALSE;
+
+	Status = XPmcDma_WaitForDoneTimeout(InstancePtr->DmaPtr,
+						XPMCDMA_SRC_CHANNEL);
+	if (Status != XST_SUCCESS) {
+		/* Set SHA under reset on failure condition */
+		XSecure_SetReset(InstancePtr->BaseAddress,
+					XSECURE_SHA3_RESET_OFFSET);
+		InstancePtr->Sha3State = XSECURE_SHA3_INITIALIZED;
+		goto END;
+	}
+
+	/* Acknowledge the transfer has completed */
+	XPmcDma_IntrClear(InstancePtr->DmaPtr, XPMCDMA_SRC_CHANNEL,
+				XPMCDMA_IXR_DONE_MASK);
+
+END:
+	return Status;
+}
+
 /*****************************************************************************/
 /**
  * @brief	This function updates SHA3 engine with final data which includes
@@ -359,6 +488,11 @@ int XSecure_Sha3Finish(XSecure_Sha3 *InstancePtr, XSecure_Sha3Hash *Sha3Hash)
 		goto END;
 	}
 
+	if (InstancePtr->IsNonBlkPending == TRUE) {
+		Status = (int)XSECURE_SHA3_STATE_MISMATCH_ERROR;
+		goto END;
+	}
+
 	if (InstancePtr->Sha3State != XSECURE_SHA3_ENGINE_STARTED) {
 		Status = (int)XSECURE_SHA3_STATE_MISMATCH_ERROR;
 		goto END_RST;
@@ -110,6 +110,7 @@ typedef struct {
 	u32 Sha3Len; /**< SHA3 Input Length */
 	u32 PartialLen; /**< Partial Length */
 	u32 IsLastUpdate; /**< Last DMA block indication */
+	u32 IsNonBlkPending; /**< Non blocking update is in progress */
 	u8 PartialData[XSECURE_SHA3_BLOCK_LEN]; /**< Partial Data */
 	XSecure_Sss SssInstance; /**< SSS Instance */
 	XSecure_Sha3State Sha3State; /**< SHA engine state */
@@ -130,6 +131,11 @@ int XSecure_Sha3Update(XSecure_Sha3 *InstancePtr, const UINTPTR InDataAddr,
 		       const u32 Size);
 int XSecure_Sha3Finish(XSecure_Sha3 *InstancePtr, XSecure_Sha3Hash *Sha3Hash);
 
+/* Non blocking data transfer */
+int XSecure_Sha3UpdateNonBlk(XSecure_Sha3 *InstancePtr,
+		const UINTPTR InDataAddr, const u32 Size);
+int XSecure_Sha3WaitForUpdate(XSecure_Sha3 *InstancePtr);
+
 
 /* Complete SHA digest calculation */
 int XSecure_Sha3Digest(XSecure_Sha3 *InstancePtr, const UINTPTR InDataAddr,
@@ -152,6 +152,11 @@ extern "C" {
 
 #define REVERSE_POLYNOMIAL	(0x82F63B78U)
 				/**< Polynomial for calculating CRC */
+
+/**
+ * Row CRC function, see XilSKey_SetRowCrcHook
+ */
+typedef u32 (*XilSKey_RowCrcHook)(u32 PrevCRC, u32 Data, u32 Addr);
 /** @name CSU_DMA pause types
  * @{
  */
@@ -1086,6 +1091,9 @@ u32 XilSKey_Efuse_ConvertStringToHexBE(const char * Str, u8 * Buf, u32 Len);
 u32 XilSKey_Efuse_ValidateKey(const char *Key, u32 Len);
 u32 XilSKey_Timer_Intialise(void);
 u32 XilSKey_Efuse_ReverseHex(u32 Input);
+u32 XilSKey_RowCrcCalculation(u32 PrevCRC, u32 Data, u32 Addr);
+u32 XilSKey_RowCrcCalculation_Bitwise(u32 PrevCRC, u32 Data, u32 Addr);
+void XilSKey_SetRowCrcHook(XilSKey_RowCrcHook Hook);
 void XilSKey_StrCpyRange(const u8 *Src, u8 *Dst, u32 From, u32 To);
 #ifdef XSK_MICROBLAZE_PLATFORM
 void XilSKey_GetSlrNum(u32 MasterSlr, u32 ConfigOrderIndex, u32 *SlrNum);
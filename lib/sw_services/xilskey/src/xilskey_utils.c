@@ -69,6 +69,9 @@
 #include "xil_io.h"
 #include "xil_types.h"
 #include "xilskey_utils.h"
+#if defined (__aarch64__) && defined (__ARM_FEATURE_CRC32)
+#include <arm_acle.h>
+#endif
 /************************** Constant Definitions ****************************/
 
 /**************************** Type Definitions ******************************/
@@ -89,6 +92,162 @@ static XSysMonPsu XSysmonInst; /* Sysmon PSU instance */
 static u16 XSysmonDevId; /* Sysmon PSU device ID */
 #endif
 
+/*
+ * Slice-by-4 tables for the reflected CRC-32C polynomial REVERSE_POLYNOMIAL,
+ * table N gives the CRC of a byte followed by N zero bytes.
+ */
+static const u32 XilSKey_CrcTable[4U][256U] = {
+	{
+		0x00000000U, 0xF26B8303U, 0xE13B70F7U, 0x1350F3F4U, 0xC79A971FU, 0x35F1141CU, 0x26A1E7E8U, 0xD4CA64EBU,
+		0x8AD958CFU, 0x78B2DBCCU, 0x6BE22838U, 0x9989AB3BU, 0x4D43CFD0U, 0xBF284CD3U, 0xAC78BF27U, 0x5E133C24U,
+		0x105EC76FU, 0xE235446CU, 0xF165B798U, 0x030E349BU, 0xD7C45070U, 0x25AFD373U, 0x36FF2087U, 0xC494A384U,
+		0x9A879FA0U, 0x68EC1CA3U, 0x7BBCEF57U, 0x89D76C54U, 0x5D1D08BFU, 0xAF768BBCU, 0xBC267848U, 0x4E4DFB4BU,
+		0x20BD8EDEU, 0xD2D60DDDU, 0xC186FE29U, 0x33ED7D2AU, 0xE72719C1U, 0x154C9AC2U, 0x061C6936U, 0xF477EA35U,
+		0xAA64D611U, 0x580F5512U, 0x4B5FA6E6U, 0xB93425E5U, 0x6DFE410EU, 0x9F95C20DU, 0x8CC531F9U, 0x7EAEB2FAU,
+		0x30E349B1U, 0xC288CAB2U, 0xD1D83946U, 0x23B3BA45U, 0xF779DEAEU, 0x05125DADU, 0x1642AE59U, 0xE4292D5AU,
+		0xBA3A117EU, 0x4851927DU, 0x5B016189U, 0xA96AE28AU, 0x7DA08661U, 0x8FCB0562U, 0x9C9BF696U, 0x6EF07595U,
+		0x417B1DBCU, 0xB3109EBFU, 0xA0406D4BU, 0x522BEE48U, 0x86E18AA3U, 0x748A09A0U, 0x67DAFA54U, 0x95B17957U,
+		0xCBA24573U, 0x39C9C670U, 0x2A993584U, 0xD8F2B687U, 0x0C38D26CU, 0xFE53516FU, 0xED03A29BU, 0x1F682198U,
+		0x5125DAD3U, 0xA34E59D0U, 0xB01EAA24U, 0x42752927U, 0x96BF4DCCU, 0x64D4CECFU, 0x77843D3BU, 0x85EFBE38U,
+		0xDBFC821CU, 0x2997011FU, 0x3AC7F2EBU, 0xC8AC71E8U, 0x1C661503U, 0xEE0D9600U, 0xFD5D65F4U, 0x0F36E6F7U,
+		0x61C69362U, 0x93AD1061U, 0x80FDE395U, 0x72966096U, 0xA65C047DU, 0x5437877EU, 0x4767748AU, 0xB50CF789U,
+		0xEB1FCBADU, 0x197448AEU, 0x0A24BB5AU, 0xF84F3859U, 0x2C855CB2U, 0xDEEEDFB1U, 0xCDBE2C45U, 0x3FD5AF46U,
+		0x7198540DU, 0x83F3D70EU, 0x90A324FAU, 0x62C8A7F9U, 0xB602C312U, 0x44694011U, 0x5739B3E5U, 0xA55230E6U,
+		0xFB410CC2U, 0x092A8FC1U, 0x1A7A7C35U, 0xE811FF36U, 0x3CDB9BDDU, 0xCEB018DEU, 0xDDE0EB2AU, 0x2F8B6829U,
+		0x82F63B78U, 0x709DB87BU, 0x63CD4B8FU, 0x91A6C88CU, 0x456CAC67U, 0xB7072F64U, 0xA457DC90U, 0x563C5F93U,
+		0x082F63B7U, 0xFA44E0B4U, 0xE9141340U, 0x1B7F9043U, 0xCFB5F4A8U, 0x3DDE77ABU, 0x2E8E845FU, 0xDCE5075CU,
+		0x92A8FC17U, 0x60C37F14U, 0x73938CE0U, 0x81F80FE3U, 0x55326B08U, 0xA759E80BU, 0xB4091BFFU, 0x466298FCU,
+		0x1871A4D8U, 0xEA1A27DBU, 0xF94AD42FU, 0x0B21572CU, 0xDFEB33C7U, 0x2D80B0C4U, 0x3ED04330U, 0xCCBBC033U,
+		0xA24BB5A6U, 0x502036A5U, 0x4370C551U, 0xB11B4652U, 0x65D122B9U, 0x97BAA1BAU, 0x84EA524EU, 0x7681D14DU,
+		0x2892ED69U, 0xDAF96E6AU, 0xC9A99D9EU, 0x3BC21E9DU, 0xEF087A76U, 0x1D63F975U, 0x0E330A81U, 0xFC588982U,
+		0xB21572C9U, 0x407EF1CAU, 0x532E023EU, 0xA145813DU, 0x758FE5D6U, 0x87E466D5U, 0x94B49521U, 0x66DF1622U,
+		0x38CC2A06U, 0xCAA7A905U, 0xD9F75AF1U, 0x2B9CD9F2U, 0xFF56BD19U, 0x0D3D3E1AU, 0x1E6DCDEEU, 0xEC064EEDU,
+		0xC38D26C4U, 0x31E6A5C7U, 0x22B65633U, 0xD0DDD530U, 0x0417B1DBU, 0xF67C32D8U, 0xE52CC12CU, 0x1747422FU,
+		0x49547E0BU, 0xBB3FFD08U, 0xA86F0EFCU, 0x5A048DFFU, 0x8ECEE914U, 0x7CA56A17U, 0x6FF599E3U, 0x9D9E1AE0U,
+		0xD3D3E1ABU, 0x21B862A8U, 0x32E8915CU, 0xC083125FU, 0x144976B4U, 0xE622F5B7U, 0xF5720643U, 0x07198540U,
+		0x590AB964U, 0xAB613A67U, 0xB831C993U, 0x4A5A4A90U, 0x9E902E7BU, 0x6CFBAD78U, 0x7FAB5E8CU, 0x8DC0DD8FU,
+		0xE330A81AU, 0x115B2B19U, 0x020BD8EDU, 0xF0605BEEU, 0x24AA3F05U, 0xD6C1BC06U, 0xC5914FF2U, 0x37FACCF1U,
+		0x69E9F0D5U, 0x9B8273D6U, 0x88D28022U, 0x7AB90321U, 0xAE7367CAU, 0x5C18E4C9U, 0x4F48173DU, 0xBD23943EU,
+		0xF36E6F75U, 0x0105EC76U, 0x12551F82U, 0xE03E9C81U, 0x34F4F86AU, 0xC69F7B69U, 0xD5CF889DU, 0x27A40B9EU,
+		0x79B737BAU, 0x8BDCB4B9U, 0x988C474DU, 0x6AE7C44EU, 0xBE2DA0A5U, 0x4C4623A6U, 0x5F16D052U, 0xAD7D5351U
+	},
+	{
+		0x00000000U, 0x13A29877U, 0x274530EEU, 0x34E7A899U, 0x4E8A61DCU, 0x5D28F9ABU, 0x69CF5132U, 0x7A6DC945U,
+		0x9D14C3B8U, 0x8EB65BCFU, 0xBA51F356U, 0xA9F36B21U, 0xD39EA264U, 0xC03C3A13U, 0xF4DB928AU, 0xE7790AFDU,
+		0x3FC5F181U, 0x2C6769F6U, 0x1880C16FU, 0x0B225918U, 0x714F905DU, 0x62ED082AU, 0x560AA0B3U, 0x45A838C4U,
+		0xA2D13239U, 0xB173AA4EU, 0x859402D7U, 0x96369AA0U, 0xEC5B53E5U, 0xFFF9CB92U, 0xCB1E630BU, 0xD8BCFB7CU,
+		0x7F8BE302U, 0x6C297B75U, 0x58CED3ECU, 0x4B6C4B9BU, 0x310182DEU, 0x22A31AA9U, 0x1644B230U, 0x05E62A47U,
+		0xE29F20BAU, 0xF13DB8CDU, 0xC5DA1054U, 0xD6788823U, 0xAC154166U, 0xBFB7D911U, 0x8B507188U, 0x98F2E9FFU,
+		0x404E1283U, 0x53EC8AF4U, 0x670B226DU, 0x74A9BA1AU, 0x0EC4735FU, 0x1D66EB28U, 0x298143B1U, 0x3A23DBC6U,
+		0xDD5AD13BU, 0xCEF8494CU, 0xFA1FE1D5U, 0xE9BD79A2U, 0x93D0B0E7U, 0x80722890U, 0xB4958009U, 0xA737187EU,
+		0xFF17C604U, 0xECB55E73U, 0xD852F6EAU, 0xCBF06E9DU, 0xB19DA7D8U, 0xA23F3FAFU, 0x96D89736U, 0x857A0F41U,
+		0x620305BCU, 0x71A19DCBU, 0x45463552U, 0x56E4AD25U, 0x2C896460U, 0x3F2BFC17U, 0x0BCC548EU, 0x186ECCF9U,
+		0xC0D23785U, 0xD370AFF2U, 0xE797076BU, 0xF4359F1CU, 0x8E585659U, 0x9DFACE2EU, 0xA91D66B7U, 0xBABFFEC0U,
+		0x5DC6F43DU, 0x4E646C4AU, 0x7A83C4D3U, 0x69215CA4U, 0x134C95E1U, 0x00EE0D96U, 0x3409A50FU, 0x27AB3D78U,
+		0x809C2506U, 0x933EBD71U, 0xA7D915E8U, 0xB47B8D9FU, 0xCE1644DAU, 0xDDB4DCADU, 0xE9537434U, 0xFAF1EC43U,
+		0x1D88E6BEU, 0x0E2A7EC9U, 0x3ACDD650U, 0x296F4E27U, 0x53028762U, 0x40A01F15U, 0x7447B78CU, 0x67E52FFBU,
+		0xBF59D487U, 0xACFB4CF0U, 0x981CE469U, 0x8BBE7C1EU, 0xF1D3B55BU, 0xE2712D2CU, 0xD69685B5U, 0xC5341DC2U,
+		0x224D173FU, 0x31EF8F48U, 0x050827D1U, 0x16AABFA6U, 0x6CC776E3U, 0x7F65EE94U, 0x4B82460DU, 0x5820DE7AU,
+		0xFBC3FAF9U, 0xE861628EU, 0xDC86CA17U, 0xCF245260U, 0xB5499B25U, 0xA6EB0352U, 0x920CABCBU, 0x81AE33BCU,
+		0x66D73941U, 0x7575A136U, 0x419209AFU, 0x523091D8U, 0x285D589DU, 0x3BFFC0EAU, 0x0F186873U, 0x1CBAF004U,
+		0xC4060B78U, 0xD7A4930FU, 0xE3433B96U, 0xF0E1A3E1U, 0x8A8C6AA4U, 0x992EF2D3U, 0xADC95A4AU, 0xBE6BC23DU,
+		0x5912C8C0U, 0x4AB050B7U, 0x7E57F82EU, 0x6DF56059U, 0x1798A91CU, 0x043A316BU, 0x30DD99F2U, 0x237F0185U,
+		0x844819FBU, 0x97EA818CU, 0xA30D2915U, 0xB0AFB162U, 0xCAC27827U, 0xD960E050U, 0xED8748C9U, 0xFE25D0BEU,
+		0x195CDA43U, 0x0AFE4234U, 0x3E19EAADU, 0x2DBB72DAU, 0x57D6BB9FU, 0x447423E8U, 0x70938B71U, 0x63311306U,
+		0xBB8DE87AU, 0xA82F700DU, 0x9CC8D894U, 0x8F6A40E3U, 0xF50789A6U, 0xE6A511D1U, 0xD242B948U, 0xC1E0213FU,
+		0x26992BC2U, 0x353BB3B5U, 0x01DC1B2CU, 0x127E835BU, 0x68134A1EU, 0x7BB1D269U, 0x4F567AF0U, 0x5CF4E287U,
+		0x04D43CFDU, 0x1776A48AU, 0x23910C13U, 0x30339464U, 0x4A5E5D21U, 0x59FCC556U, 0x6D1B6DCFU, 0x7EB9F5B8U,
+		0x99C0FF45U, 0x8A626732U, 0xBE85CFABU, 0xAD2757DCU, 0xD74A9E99U, 0xC4E806EEU, 0xF00FAE77U, 0xE3AD3600U,
+		0x3B11CD7CU, 0x28B3550BU, 0x1C54FD92U, 0x0FF665E5U, 0x759BACA0U, 0x663934D7U, 0x52DE9C4EU, 0x417C0439U,
+		0xA6050EC4U, 0xB5A796B3U, 0x81403E2AU, 0x92E2A65DU, 0xE88F6F18U, 0xFB2DF76FU, 0xCFCA5FF6U, 0xDC68C781U,
+		0x7B5FDFFFU, 0x68FD4788U, 0x5C1AEF11U, 0x4FB87766U, 0x35D5BE23U, 0x26772654U, 0x12908ECDU, 0x013216BAU,
+		0xE64B1C47U, 0xF5E98430U, 0xC10E2CA9U, 0xD2ACB4DEU, 0xA8C17D9BU, 0xBB63E5ECU, 0x8F844D75U, 0x9C26D502U,
+		0x449A2E7EU, 0x5738B609U, 0x63DF1E90U, 0x707D86E7U, 0x0A104FA2U, 0x19B2D7D5U, 0x2D557F4CU, 0x3EF7E73BU,
+		0xD98EEDC6U, 0xCA2C75B1U, 0xFECBDD28U, 0xED69455FU, 0x97048C1AU, 0x84A6146DU, 0xB041BCF4U, 0xA3E32483U
+	},
+	{
+		0x00000000U, 0xA541927EU, 0x4F6F520DU, 0xEA2EC073U, 0x9EDEA41AU, 0x3B9F3664U, 0xD1B1F617U, 0x74F06469U,
+		0x38513EC5U, 0x9D10ACBBU, 0x773E6CC8U, 0xD27FFEB6U, 0xA68F9ADFU, 0x03CE08A1U, 0xE9E0C8D2U, 0x4CA15AACU,
+		0x70A27D8AU, 0xD5E3EFF4U, 0x3FCD2F87U, 0x9A8CBDF9U, 0xEE7CD990U, 0x4B3D4BEEU, 0xA1138B9DU, 0x045219E3U,
+		0x48F3434FU, 0xEDB2D131U, 0x079C1142U, 0xA2DD833CU, 0xD62DE755U, 0x736C752BU, 0x9942B558U, 0x3C032726U,
+		0xE144FB14U, 0x4405696AU, 0xAE2BA919U, 0x0B6A3B67U, 0x7F9A5F0EU, 0xDADBCD70U, 0x30F50D03U, 0x95B49F7DU,
+		0xD915C5D1U, 0x7C5457AFU, 0x967A97DCU, 0x333B05A2U, 0x47CB61CBU, 0xE28AF3B5U, 0x08A433C6U, 0xADE5A1B8U,
+		0x91E6869EU, 0x34A714E0U, 0xDE89D493U, 0x7BC846EDU, 0x0F382284U, 0xAA79B0FAU, 0x40577089U, 0xE516E2F7U,
+		0xA9B7B85BU, 0x0CF62A25U, 0xE6D8EA56U, 0x43997828U, 0x37691C41U, 0x92288E3FU, 0x78064E4CU, 0xDD47DC32U,
+		0xC76580D9U, 0x622412A7U, 0x880AD2D4U, 0x2D4B40AAU, 0x59BB24C3U, 0xFCFAB6BDU, 0x16D476CEU, 0xB395E4B0U,
+		0xFF34BE1CU, 0x5A752C62U, 0xB05BEC11U, 0x151A7E6FU, 0x61EA1A06U, 0xC4AB8878U, 0x2E85480BU, 0x8BC4DA75U,
+		0xB7C7FD53U, 0x12866F2DU, 0xF8A8AF5EU, 0x5DE93D20U, 0x29195949U, 0x8C58CB37U, 0x66760B44U, 0xC337993AU,
+		0x8F96C396U, 0x2AD751E8U, 0xC0F9919BU, 0x65B803E5U, 0x1148678CU, 0xB409F5F2U, 0x5E273581U, 0xFB66A7FFU,
+		0x26217BCDU, 0x8360E9B3U, 0x694E29C0U, 0xCC0FBBBEU, 0xB8FFDFD7U, 0x1DBE4DA9U, 0xF7908DDAU, 0x52D11FA4U,
+		0x1E704508U, 0xBB31D776U, 0x511F1705U, 0xF45E857BU, 0x80AEE112U, 0x25EF736CU, 0xCFC1B31FU, 0x6A802161U,
+		0x56830647U, 0xF3C29439U, 0x19EC544AU, 0xBCADC634U, 0xC85DA25DU, 0x6D1C3023U, 0x8732F050U, 0x2273622EU,
+		0x6ED23882U, 0xCB93AAFCU, 0x21BD6A8FU, 0x84FCF8F1U, 0xF00C9C98U, 0x554D0EE6U, 0xBF63CE95U, 0x1A225CEBU,
+		0x8B277743U, 0x2E66E53DU, 0xC448254EU, 0x6109B730U, 0x15F9D359U, 0xB0B84127U, 0x5A968154U, 0xFFD7132AU,
+		0xB3764986U, 0x1637DBF8U, 0xFC191B8BU, 0x595889F5U, 0x2DA8ED9CU, 0x88E97FE2U, 0x62C7BF91U, 0xC7862DEFU,
+		0xFB850AC9U, 0x5EC498B7U, 0xB4EA58C4U, 0x11ABCABAU, 0x655BAED3U, 0xC01A3CADU, 0x2A34FCDEU, 0x8F756EA0U,
+		0xC3D4340CU, 0x6695A672U, 0x8CBB6601U, 0x29FAF47FU, 0x5D0A9016U, 0xF84B0268U, 0x1265C21BU, 0xB7245065U,
+		0x6A638C57U, 0xCF221E29U, 0x250CDE5AU, 0x804D4C24U, 0xF4BD284DU, 0x51FCBA33U, 0xBBD27A40U, 0x1E93E83EU,
+		0x5232B292U, 0xF77320ECU, 0x1D5DE09FU, 0xB81C72E1U, 0xCCEC1688U, 0x69AD84F6U, 0x83834485U, 0x26C2D6FBU,
+		0x1AC1F1DDU, 0xBF8063A3U, 0x55AEA3D0U, 0xF0EF31AEU, 0x841F55C7U, 0x215EC7B9U, 0xCB7007CAU, 0x6E3195B4U,
+		0x2290CF18U, 0x87D15D66U, 0x6DFF9D15U, 0xC8BE0F6BU, 0xBC4E6B02U, 0x190FF97CU, 0xF321390FU, 0x5660AB71U,
+		0x4C42F79AU, 0xE90365E4U, 0x032DA597U, 0xA66C37E9U, 0xD29C5380U, 0x77DDC1FEU, 0x9DF3018DU, 0x38B293F3U,
+		0x7413C95FU, 0xD1525B21U, 0x3B7C9B52U, 0x9E3D092CU, 0xEACD6D45U, 0x4F8CFF3BU, 0xA5A23F48U, 0x00E3AD36U,
+		0x3CE08A10U, 0x99A1186EU, 0x738FD81DU, 0xD6CE4A63U, 0xA23E2E0AU, 0x077FBC74U, 0xED517C07U, 0x4810EE79U,
+		0x04B1B4D5U, 0xA1F026ABU, 0x4BDEE6D8U, 0xEE9F74A6U, 0x9A6F10CFU, 0x3F2E82B1U, 0xD50042C2U, 0x7041D0BCU,
+		0xAD060C8EU, 0x08479EF0U, 0xE2695E83U, 0x4728CCFDU, 0x33D8A894U, 0x96993AEAU, 0x7CB7FA99U, 0xD9F668E7U,
+		0x9557324BU, 0x3016A035U, 0xDA386046U, 0x7F79F238U, 0x0B899651U, 0xAEC8042FU, 0x44E6C45CU, 0xE1A75622U,
+		0xDDA47104U, 0x78E5E37AU, 0x92CB2309U, 0x378AB177U, 0x437AD51EU, 0xE63B4760U, 0x0C158713U, 0xA954156DU,
+		0xE5F54FC1U, 0x40B4DDBFU, 0xAA9A1DCCU, 0x0FDB8FB2U, 0x7B2BEBDBU, 0xDE6A79A5U, 0x3444B9D6U, 0x91052BA8U
+	},
+	{
+		0x00000000U, 0xDD45AAB8U, 0xBF672381U, 0x62228939U, 0x7B2231F3U, 0xA6679B4BU, 0xC4451272U, 0x1900B8CAU,
+		0xF64463E6U, 0x2B01C95EU, 0x49234067U, 0x9466EADFU, 0x8D665215U, 0x5023F8ADU, 0x32017194U, 0xEF44DB2CU,
+		0xE964B13DU, 0x34211B85U, 0x560392BCU, 0x8B463804U, 0x924680CEU, 0x4F032A76U, 0x2D21A34FU, 0xF06409F7U,
+		0x1F20D2DBU, 0xC2657863U, 0xA047F15AU, 0x7D025BE2U, 0x6402E328U, 0xB9474990U, 0xDB65C0A9U, 0x06206A11U,
+		0xD725148BU, 0x0A60BE33U, 0x6842370AU, 0xB5079DB2U, 0xAC072578U, 0x71428FC0U, 0x136006F9U, 0xCE25AC41U,
+		0x2161776DU, 0xFC24DDD5U, 0x9E0654ECU, 0x4343FE54U, 0x5A43469EU, 0x8706EC26U, 0xE524651FU, 0x3861CFA7U,
+		0x3E41A5B6U, 0xE3040F0EU, 0x81268637U, 0x5C632C8FU, 0x45639445U, 0x98263EFDU, 0xFA04B7C4U, 0x27411D7CU,
+		0xC805C650U, 0x15406CE8U, 0x7762E5D1U, 0xAA274F69U, 0xB327F7A3U, 0x6E625D1BU, 0x0C40D422U, 0xD1057E9AU,
+		0xABA65FE7U, 0x76E3F55FU, 0x14C17C66U, 0xC984D6DEU, 0xD0846E14U, 0x0DC1C4ACU, 0x6FE34D95U, 0xB2A6E72DU,
+		0x5DE23C01U, 0x80A796B9U, 0xE2851F80U, 0x3FC0B538U, 0x26C00DF2U, 0xFB85A74AU, 0x99A72E73U, 0x44E284CBU,
+		0x42C2EEDAU, 0x9F874462U, 0xFDA5CD5BU, 0x20E067E3U, 0x39E0DF29U, 0xE4A57591U, 0x8687FCA8U, 0x5BC25610U,
+		0xB4868D3CU, 0x69C32784U, 0x0BE1AEBDU, 0xD6A40405U, 0xCFA4BCCFU, 0x12E11677U, 0x70C39F4EU, 0xAD8635F6U,
+		0x7C834B6CU, 0xA1C6E1D4U, 0xC3E468EDU, 0x1EA1C255U, 0x07A17A9FU, 0xDAE4D027U, 0xB8C6591EU, 0x6583F3A6U,
+		0x8AC7288AU, 0x57828232U, 0x35A00B0BU, 0xE8E5A1B3U, 0xF1E51979U, 0x2CA0B3C1U, 0x4E823AF8U, 0x93C79040U,
+		0x95E7FA51U, 0x48A250E9U, 0x2A80D9D0U, 0xF7C57368U, 0xEEC5CBA2U, 0x3380611AU, 0x51A2E823U, 0x8CE7429BU,
+		0x63A399B7U, 0xBEE6330FU, 0xDCC4BA36U, 0x0181108EU, 0x1881A844U, 0xC5C402FCU, 0xA7E68BC5U, 0x7AA3217DU,
+		0x52A0C93FU, 0x8FE56387U, 0xEDC7EABEU, 0x30824006U, 0x2982F8CCU, 0xF4C75274U, 0x96E5DB4DU, 0x4BA071F5U,
+		0xA4E4AAD9U, 0x79A10061U, 0x1B838958U, 0xC6C623E0U, 0xDFC69B2AU, 0x02833192U, 0x60A1B8ABU, 0xBDE41213U,
+		0xBBC47802U, 0x6681D2BAU, 0x04A35B83U, 0xD9E6F13BU, 0xC0E649F1U, 0x1DA3E349U, 0x7F816A70U, 0xA2C4C0C8U,
+		0x4D801BE4U, 0x90C5B15CU, 0xF2E73865U, 0x2FA292DDU, 0x36A22A17U, 0xEBE780AFU, 0x89C50996U, 0x5480A32EU,
+		0x8585DDB4U, 0x58C0770CU, 0x3AE2FE35U, 0xE7A7548DU, 0xFEA7EC47U, 0x23E246FFU, 0x41C0CFC6U, 0x9C85657EU,
+		0x73C1BE52U, 0xAE8414EAU, 0xCCA69DD3U, 0x11E3376BU, 0x08E38FA1U, 0xD5A62519U, 0xB784AC20U, 0x6AC10698U,
+		0x6CE16C89U, 0xB1A4C631U, 0xD3864F08U, 0x0EC3E5B0U, 0x17C35D7AU, 0xCA86F7C2U, 0xA8A47EFBU, 0x75E1D443U,
+		0x9AA50F6FU, 0x47E0A5D7U, 0x25C22CEEU, 0xF8878656U, 0xE1873E9CU, 0x3CC29424U, 0x5EE01D1DU, 0x83A5B7A5U,
+		0xF90696D8U, 0x24433C60U, 0x4661B559U, 0x9B241FE1U, 0x8224A72BU, 0x5F610D93U, 0x3D4384AAU, 0xE0062E12U,
+		0x0F42F53EU, 0xD2075F86U, 0xB025D6BFU, 0x6D607C07U, 0x7460C4CDU, 0xA9256E75U, 0xCB07E74CU, 0x16424DF4U,
+		0x106227E5U, 0xCD278D5DU, 0xAF050464U, 0x7240AEDCU, 0x6B401616U, 0xB605BCAEU, 0xD4273597U, 0x09629F2FU,
+		0xE6264403U, 0x3B63EEBBU, 0x59416782U, 0x8404CD3AU, 0x9D0475F0U, 0x4041DF48U, 0x22635671U, 0xFF26FCC9U,
+		0x2E238253U, 0xF36628EBU, 0x9144A1D2U, 0x4C010B6AU, 0x5501B3A0U, 0x88441918U, 0xEA669021U, 0x37233A99U,
+		0xD867E1B5U, 0x05224B0DU, 0x6700C234U, 0xBA45688CU, 0xA345D046U, 0x7E007AFEU, 0x1C22F3C7U, 0xC167597FU,
+		0xC747336EU, 0x1A0299D6U, 0x782010EFU, 0xA565BA57U, 0xBC65029DU, 0x6120A825U, 0x0302211CU, 0xDE478BA4U,
+		0x31035088U, 0xEC46FA30U, 0x8E647309U, 0x5321D9B1U, 0x4A21617BU, 0x9764CBC3U, 0xF54642FAU, 0x2803E842U
+	}
+};
+
+/*
+ * CRC of the 5 row address bits that follow each row's data.
+ */
+static const u32 XilSKey_CrcAddrTable[32U] = {
+	0x00000000U, 0x8AD958CFU, 0x105EC76FU, 0x9A879FA0U, 0x20BD8EDEU, 0xAA64D611U, 0x30E349B1U, 0xBA3A117EU,
+	0x417B1DBCU, 0xCBA24573U, 0x5125DAD3U, 0xDBFC821CU, 0x61C69362U, 0xEB1FCBADU, 0x7198540DU, 0xFB410CC2U,
+	0x82F63B78U, 0x082F63B7U, 0x92A8FC17U, 0x1871A4D8U, 0xA24BB5A6U, 0x2892ED69U, 0xB21572C9U, 0x38CC2A06U,
+	0xC38D26C4U, 0x49547E0BU, 0xD3D3E1ABU, 0x590AB964U, 0xE330A81AU, 0x69E9F0D5U, 0xF36E6F75U, 0x79B737BAU
+};
+
+/* Optional alternative row CRC implementation, e.g. a CRC accelerator */
+static XilSKey_RowCrcHook RowCrcHook = NULL;
+
 static u32 TimerTicksfor100ns; /**< Global static Variable to store ticks/100ns*/
 u32 TimerTicksfor1000ns; /**< Global Variable for 10 micro secs for microblaze */
 /************************** Function Prototypes *****************************/
@@ -1313,10 +1472,54 @@ END:
  *
  * @return	Crc of current row.
  *
- * @note	None.
+ * @note	The 32 data bits are processed a byte at a time with the
+ *		slice-by-4 tables, or with the ARMv8 CRC32C instruction when
+ *		the compiler targets it. A hook installed with
+ *		XilSKey_SetRowCrcHook takes precedence. The result is the same
+ *		as XilSKey_RowCrcCalculation_Bitwise.
  *
  ****************************************************************************/
 u32 XilSKey_RowCrcCalculation(u32 PrevCRC, u32 Data, u32 Addr)
+{
+	u32 Crc;
+
+	if (RowCrcHook != NULL) {
+		Crc = RowCrcHook(PrevCRC, Data, Addr);
+		goto END;
+	}
+
+#if defined (__aarch64__) && defined (__ARM_FEATURE_CRC32)
+	Crc = __crc32cw(PrevCRC, Data);
+#else
+	Crc = PrevCRC ^ Data;
+	Crc = XilSKey_CrcTable[3U][Crc & 0xFFU] ^
+		XilSKey_CrcTable[2U][(Crc >> 8U) & 0xFFU] ^
+		XilSKey_CrcTable[1U][(Crc >> 16U) & 0xFFU] ^
+		XilSKey_CrcTable[0U][Crc >> 24U];
+#endif
+
+	/* Only the 5 LSBs of the row number are part of the CRC */
+	Crc = (Crc >> 5U) ^ XilSKey_CrcAddrTable[(Crc ^ Addr) & 0x1FU];
+
+END:
+	return Crc;
+}
+
+/****************************************************************************/
+/**
+ * Calculates CRC value for each row of AES key one bit at a time. This is
+ * the reference implementation of XilSKey_RowCrcCalculation.
+ *
+ * @param	PrevCRC holds the prev row's CRC.
+ * @param	Data holds the present row's key.
+ * @param	Addr stores the current row number.
+ *
+ * @return	Crc of current row.
+ *
+ * @note	None.
+ *
+ ****************************************************************************/
+u32 XilSKey_RowCrcCalculation_Bitwise(u32 PrevCRC, u32 Data, u32 Addr)
 {
 	u32 Crc = PrevCRC;
 	u32 Value = Data;
@@ -1347,6 +1550,25 @@ u32 XilSKey_RowCrcCalculation(u32 PrevCRC, u32 Data, u32 Addr)
 
 }
 
+/****************************************************************************/
+/**
+ * Installs an alternative implementation of XilSKey_RowCrcCalculation, for
+ * example one that uses a CRC accelerator. It must return the same value as
+ * XilSKey_RowCrcCalculation_Bitwise.
+ *
+ * @param	Hook is the row CRC function, NULL restores the table
+ *		implementation.
+ *
+ * @return	None.
+ *
+ * @note	None.
+ *
+ ****************************************************************************/
+void XilSKey_SetRowCrcHook(XilSKey_RowCrcHook Hook)
+{
+	RowCrcHook = Hook;
+}
+
 /****************************************************************************/
 /**
  * This API reverse the value.
@@ -0,0 +1,379 @@
+/******************************************************************************
+* Copyright (C) 2020 Xilinx, Inc.  All rights reserved.
+* SPDX-License-Identifier: MIT
+******************************************************************************/
+
+/*****************************************************************************/
+/**
+*
+* @file test_xilskey_crc.c
+*
+* Host test of the table driven AES key row CRC. The library is built for the
+* ZynqMP PS eFuse and BBRAM (ARMR5), with the SYSMON driver calls stubbed.
+*
+* XilSKey_RowCrcCalculation is compared with the bit at a time reference
+* XilSKey_RowCrcCalculation_Bitwise on random and edge case rows, and
+* XilSkey_CrcCalculation_AesKey and XilSKey_CrcCalculation are compared on
+* random keys, given as bytes and as the equivalent hexadecimal string, with
+* a chain of reference row CRCs. The test also checks that a hook installed
+* with XilSKey_SetRowCrcHook is used and that NULL restores the tables, and
+* times both row CRCs.
+*
+* Build and run on the host:
+*   cc -Wall -O2 -DARMR5 -I. -I../src/include \
+*      -I../../../bsp/standalone/src/common \
+*      -I../../../bsp/standalone/src/arm/common \
+*      -I../../../bsp/standalone/src/arm/cortexr5 \
+*      -I../../../../XilinxProcessorIPLib/drivers/sysmonpsu/src \
+*      test_xilskey_crc.c -o test_xilskey_crc
+*   ./test_xilskey_crc
+*
+******************************************************************************/
+
+/***************************** Include Files *********************************/
+
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+
+/* Build the standalone (non Linux) flavour of the library */
+#undef __linux__
+#include "xil_types.h"
+#include "xparameters.h"
+#define INLINE inline
+
+/* No register is accessed by the CRC functions */
+#define XIL_IO_H
+static u32 Xil_In32(UINTPTR Addr)
+{
+	(void)Addr;
+	return 0U;
+}
+static void Xil_Out32(UINTPTR Addr, u32 Value)
+{
+	(void)Addr;
+	(void)Value;
+}
+
+#define XPSEUDO_ASM_H
+#define XIL_PRINTF_H
+#define xil_printf	printf
+
+#include "../src/xilskey_utils.c"
+
+/************************** Constant Definitions *****************************/
+
+#define NUM_ROWS	2000000U
+#define NUM_KEYS	20000U
+#define BENCH_ROWS	4000000U
+#define BENCH_RUNS	5U
+
+/************************** Variable Definitions *****************************/
+
+static u32 Failures;
+static u32 Seed = 0x2545F491U;
+static u32 HookCalls;
+
+#define CHECK(Cond, Msg) \
+	do { \
+		if (!(Cond)) { \
+			printf("FAIL: %s (line %d)\n", (Msg), __LINE__); \
+			Failures++; \
+		} \
+	} while (0)
+
+/********************************** Stubs ************************************/
+
+u32 Xil_AssertStatus;
+s32 Xil_AssertWait;
+
+void Xil_Assert(const char8 *File, s32 Line)
+{
+	printf("ASSERT %s:%d\n", File, Line);
+}
+
+XSysMonPsu_Config *XSysMonPsu_LookupConfig(u16 DeviceId)
+{
+	(void)DeviceId;
+	return NULL;
+}
+
+s32 XSysMonPsu_CfgInitialize(XSysMonPsu *InstancePtr,
+		XSysMonPsu_Config *ConfigPtr, u32 EffectiveAddr)
+{
+	(void)InstancePtr;
+	(void)ConfigPtr;
+	(void)EffectiveAddr;
+	return XST_FAILURE;
+}
+
+void XSysMonPsu_InitInstance(XSysMonPsu *InstancePtr,
+		XSysMonPsu_Config *ConfigPtr)
+{
+	(void)InstancePtr;
+	(void)ConfigPtr;
+}
+
+s32 XSysMonPsu_SelfTest(XSysMonPsu *InstancePtr)
+{
+	(void)InstancePtr;
+	return XST_FAILURE;
+}
+
+void XSysMonPsu_SetSequencerMode(XSysMonPsu *InstancePtr, u8 SequencerMode,
+		u32 SysmonBlk)
+{
+	(void)InstancePtr;
+	(void)SequencerMode;
+	(void)SysmonBlk;
+}
+
+u16 XSysMonPsu_GetAdcData(XSysMonPsu *InstancePtr, u8 Channel, u32 Block)
+{
+	(void)InstancePtr;
+	(void)Channel;
+	(void)Block;
+	return 0U;
+}
+
+/***************************** Test Helpers **********************************/
+
+static u32 Random(void)
+{
+	Seed ^= Seed << 13U;
+	Seed ^= Seed >> 17U;
+	Seed ^= Seed << 5U;
+	return Seed;
+}
+
+static double NowNs(void)
+{
+	struct timespec Ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &Ts);
+	return (double)Ts.tv_sec * 1e9 + (double)Ts.tv_nsec;
+}
+
+/*
+ * CRC of a 256 bit key stored least significant byte first, as programmed
+ * in the ZynqMP eFuse and BBRAM: word 7 first, in rows 8 down to 1.
+ */
+static u32 RefKeyCrc(const u8 *Key)
+{
+	u32 Crc = 0U;
+	u32 Index;
+	u32 Word;
+	const u8 *Ptr;
+
+	for (Index = 0U; Index < 8U; Index++) {
+		Ptr = &Key[(7U - Index) * 4U];
+		Word = (u32)Ptr[0U] | ((u32)Ptr[1U] << 8U) |
+			((u32)Ptr[2U] << 16U) | ((u32)Ptr[3U] << 24U);
+		Crc = XilSKey_RowCrcCalculation_Bitwise(Crc, Word, 8U - Index);
+	}
+
+	return Crc;
+}
+
+/* The same key as a hexadecimal string, most significant byte first */
+static void KeyToString(const u8 *Key, char *Str, u32 Upper)
+{
+	u32 Index;
+
+	for (Index = 0U; Index < 32U; Index++) {
+		(void)sprintf(&Str[Index * 2U], Upper ? "%02X" : "%02x",
+				Key[31U - Index]);
+	}
+}
+
+static u32 CountingHook(u32 PrevCRC, u32 Data, u32 Addr)
+{
+	HookCalls++;
+	return XilSKey_RowCrcCalculation_Bitwise(PrevCRC, Data, Addr);
+}
+
+static u32 ConstantHook(u32 PrevCRC, u32 Data, u32 Addr)
+{
+	(void)PrevCRC;
+	(void)Data;
+	(void)Addr;
+	return 0x12345678U;
+}
+
+/********************************** Tests ************************************/
+
+static void TestRows(void)
+{
+	static const u32 Edge[] = {
+		0x00000000U, 0xFFFFFFFFU, 0x00000001U, 0x80000000U,
+		0x000000FFU, 0xFF000000U, 0x82F63B78U, 0x5A5A5A5AU,
+	};
+	u32 Mismatches = 0U;
+	u32 Index;
+	u32 Prev;
+	u32 Data;
+	u32 Addr;
+	char Msg[64];
+
+	/* Every combination of edge values, for all 64 row numbers */
+	for (Index = 0U; Index < 8U * 8U * 64U; Index++) {
+		Prev = Edge[Index % 8U];
+		Data = Edge[(Index / 8U) % 8U];
+		Addr = Index / 64U;
+		if (XilSKey_RowCrcCalculation(Prev, Data, Addr) !=
+		    XilSKey_RowCrcCalculation_Bitwise(Prev, Data, Addr)) {
+			Mismatches++;
+		}
+	}
+	CHECK(Mismatches == 0U, "edge rows differ from the reference");
+
+	/* Random rows, including row numbers with bits above the 5 used */
+	for (Index = 0U; Index < NUM_ROWS; Index++) {
+		Prev = Random();
+		Data = Random();
+		Addr = ((Index & 1U) != 0U) ? (Random() & 0x1FU) : Random();
+		if (XilSKey_RowCrcCalculation(Prev, Data, Addr) !=
+		    XilSKey_RowCrcCalculation_Bitwise(Prev, Data, Addr)) {
+			Mismatches++;
+		}
+	}
+	(void)snprintf(Msg, sizeof(Msg), "%u of %u random rows differ",
+			Mismatches, NUM_ROWS);
+	CHECK(Mismatches == 0U, Msg);
+}
+
+static void TestKeys(void)
+{
+	u8 Key[32U];
+	char Str[65U];
+	char Long[66U];
+	u32 KeyMismatches = 0U;
+	u32 StrMismatches = 0U;
+	u32 Index;
+	u32 Byte;
+	u32 Ref;
+
+	for (Index = 0U; Index < NUM_KEYS; Index++) {
+		for (Byte = 0U; Byte < 32U; Byte++) {
+			/* Some keys with runs of zero and all ones bytes */
+			Key[Byte] = (u8)Random();
+			if ((Index % 4U) == 1U && (Byte % 3U) == 0U) {
+				Key[Byte] = 0x00U;
+			}
+			if ((Index % 4U) == 2U && (Byte % 5U) == 0U) {
+				Key[Byte] = 0xFFU;
+			}
+		}
+		Ref = RefKeyCrc(Key);
+		if (XilSkey_CrcCalculation_AesKey(Key) != Ref) {
+			KeyMismatches++;
+		}
+		KeyToString(Key, Str, Index & 1U);
+		if (XilSKey_CrcCalculation((const u8 *)Str) != Ref) {
+			StrMismatches++;
+		}
+	}
+	CHECK(KeyMismatches == 0U, "byte key CRC differs from the reference");
+	CHECK(StrMismatches == 0U, "string key CRC differs from the reference");
+
+	/* The all zero key, where only the row numbers feed the CRC */
+	(void)memset(Key, 0, sizeof(Key));
+	CHECK(XilSkey_CrcCalculation_AesKey(Key) == RefKeyCrc(Key) &&
+	      RefKeyCrc(Key) != 0U, "all zero key");
+
+	/* Strings longer than a key are rejected */
+	(void)memset(Long, 'a', sizeof(Long) - 1U);
+	Long[65U] = '\0';
+	CHECK(XilSKey_CrcCalculation((const u8 *)Long) ==
+	      (u32)XSK_EFUSEPL_ERROR_NOT_VALID_KEY_LENGTH,
+	      "key string longer than 64 characters accepted");
+
+	/* A character that is not hexadecimal is reported, not hashed */
+	Long[64U] = '\0';
+	Long[10U] = 'g';
+	CHECK(XilSKey_CrcCalculation((const u8 *)Long) ==
+	      (u32)XSK_EFUSEPS_ERROR_STRING_INVALID,
+	      "key string with a non hexadecimal character accepted");
+}
+
+static void TestHook(void)
+{
+	u8 Key[32U];
+	u32 Index;
+	u32 Ref;
+
+	for (Index = 0U; Index < 32U; Index++) {
+		Key[Index] = (u8)Random();
+	}
+	Ref = RefKeyCrc(Key);
+
+	HookCalls = 0U;
+	XilSKey_SetRowCrcHook(CountingHook);
+	CHECK(XilSkey_CrcCalculation_AesKey(Key) == Ref, "hook result");
+	CHECK(HookCalls == 8U, "hook not called for every row");
+
+	XilSKey_SetRowCrcHook(ConstantHook);
+	CHECK(XilSKey_RowCrcCalculation(0U, 0U, 0U) == 0x12345678U,
+	      "hook result not returned");
+
+	XilSKey_SetRowCrcHook(NULL);
+	HookCalls = 0U;
+	CHECK(XilSkey_CrcCalculation_AesKey(Key) == Ref,
+	      "tables not restored by a NULL hook");
+	CHECK(HookCalls == 0U, "hook called after removal");
+}
+
+typedef u32 (*RowCrcFn)(u32 PrevCRC, u32 Data, u32 Addr);
+
+static double BenchRows(RowCrcFn Fn, u32 *Sum)
+{
+	double Best = 0.0;
+	double Start;
+	double Ns;
+	u32 Run;
+	u32 Index;
+	u32 Crc;
+
+	for (Run = 0U; Run < BENCH_RUNS; Run++) {
+		Crc = 0U;
+		Start = NowNs();
+		for (Index = 0U; Index < BENCH_ROWS; Index++) {
+			Crc = Fn(Crc, Index * 0x9E3779B9U, Index);
+		}
+		Ns = (NowNs() - Start) / BENCH_ROWS;
+		if ((Run == 0U) || (Ns < Best)) {
+			Best = Ns;
+		}
+		*Sum ^= Crc;
+	}
+
+	return Best;
+}
+
+static void TestBench(void)
+{
+	u32 SumTable = 0U;
+	u32 SumBitwise = 0U;
+	double Table;
+	double Bitwise;
+
+	Bitwise = BenchRows(XilSKey_RowCrcCalculation_Bitwise, &SumBitwise);
+	Table = BenchRows(XilSKey_RowCrcCalculation, &SumTable);
+	CHECK(SumTable == SumBitwise, "benchmark CRCs differ");
+
+	printf("Row CRC: %.2f ns bitwise, %.2f ns tables (%.1fx)\n",
+		Bitwise, Table, Bitwise / Table);
+	/* 37 dependent bit steps against 4 table lookups and a 5 bit fold */
+	CHECK(Table * 2.0 < Bitwise, "table row CRC not faster");
+}
+
+int main(void)
+{
+	TestRows();
+	TestKeys();
+	TestHook();
+	TestBench();
+
+	printf("%s (%u failures)\n", Failures ? "FAILED" : "PASSED", Failures);
+	return Failures ? 1 : 0;
+}
@@ -0,0 +1,13 @@
+/******************************************************************************
+* Copyright (C) 2020 Xilinx, Inc.  All rights reserved.
+* SPDX-License-Identifier: MIT
+******************************************************************************/
+
+/* Hardware parameters of the host tests: a ZynqMP PS with one PS SYSMON */
+#ifndef XPARAMETERS_H
+#define XPARAMETERS_H
+
+#define XPAR_XSYSMONPSU_0_DEVICE_ID	0U
+#define XPAR_PSU_PSS_REF_CLK_FREQ_HZ	33333000U
+
+#endif